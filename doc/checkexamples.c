@@ -169,6 +169,46 @@ int example1(Dwarf_Die somedie,Dwarf_Error *error)
 }
 /*! @endcode */
 
+/*! @defgroup exampledecodeattrs Example of dwarf_die_decode_attrs
+    @brief Decoding every attribute with no allocation
+
+    A fixed array covers nearly all DIEs; the rare
+    DIE with more attributes is simply partially
+    decoded here.
+
+    @code
+*/
+int exampledecodeattrs(Dwarf_Die somedie,Dwarf_Error *error)
+{
+    Dwarf_Attr_Value values[32];
+    Dwarf_Unsigned   count = 0;
+    Dwarf_Unsigned   i = 0;
+    int res = 0;
+
+    res = dwarf_die_decode_attrs(somedie,values,32,
+        &count,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    if (count > 32) {
+        count = 32;
+    }
+    for (i = 0; i < count; ++i) {
+        Dwarf_Attr_Value *av = &values[i];
+        const char *attrname = 0;
+
+        dwarf_get_AT_name(av->av_attrnum,&attrname);
+        if (av->av_formclass == DW_FORM_CLASS_STRING) {
+            printf("%s: %s\n",attrname,av->av_string);
+        } else {
+            printf("%s: 0x%llx\n",attrname,
+                (unsigned long long)av->av_unsigned);
+        }
+    }
+    return DW_DLV_OK;
+}
+/*! @endcode */
+
 /*! @defgroup example2 Attaching a tied dbg
     @brief Attaching a tied dbg
 
@@ -980,6 +1020,126 @@ int example_locexprc(Dwarf_Debug dbg,Dwarf_Ptr expr_bytes,
 }
 /*! @endcode */
 
+/*! @defgroup example_exprprogram Example compiling an expression
+    @brief Compile a DW_AT_location expression once, evaluate often
+
+    The register and memory functions are the
+    caller's (a debugger reading a stopped process
+    for example).
+
+    @code
+*/
+static int
+example_read_reg(void *user_data, Dwarf_Unsigned regnum,
+    Dwarf_Unsigned *value_out)
+{
+    Dwarf_Unsigned *regs = (Dwarf_Unsigned *)user_data;
+
+    if (regnum >= 32) {
+        return DW_DLV_NO_ENTRY;
+    }
+    *value_out = regs[regnum];
+    return DW_DLV_OK;
+}
+
+int example_exprprogram(Dwarf_Die var_die,
+    Dwarf_Unsigned *regs, /* 32 saved registers */
+    Dwarf_Addr *address_out,
+    Dwarf_Error *error)
+{
+    Dwarf_Attribute attr = 0;
+    Dwarf_Unsigned exprlen = 0;
+    Dwarf_Ptr exprbytes = 0;
+    Dwarf_Expr_Program prog = 0;
+    Dwarf_Expr_Callbacks callbacks;
+    Dwarf_Expr_Result result;
+    int res = 0;
+
+    res = dwarf_attr(var_die,DW_AT_location,&attr,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    res = dwarf_formexprloc(attr,&exprlen,&exprbytes,error);
+    if (res != DW_DLV_OK) {
+        dwarf_dealloc_attribute(attr);
+        return res;
+    }
+    res = dwarf_expr_compile(var_die,exprbytes,exprlen,
+        &prog,error);
+    dwarf_dealloc_attribute(attr);
+    if (res != DW_DLV_OK) {
+        /*  DW_DLV_NO_ENTRY: use dwarf_get_loclist_c()
+            and interpret the operators directly. */
+        return res;
+    }
+    memset(&callbacks,0,sizeof(callbacks));
+    callbacks.ec_user_data = regs;
+    callbacks.ec_read_register = example_read_reg;
+    /*  Keep prog and evaluate it every time the
+        variable is read. */
+    res = dwarf_expr_evaluate(prog,&callbacks,FALSE,0,
+        &result,error);
+    if (res == DW_DLV_OK &&
+        result.er_kind == DW_EXPR_RESULT_memory) {
+        *address_out = result.er_value;
+    } else if (res == DW_DLV_OK) {
+        res = DW_DLV_NO_ENTRY;
+    }
+    dwarf_dealloc_expr_program(prog);
+    return res;
+}
+/*! @endcode */
+
+/*! @defgroup example_loclistcursor Example walking a loclist
+    @brief Walk a location list without allocating anything
+
+    Here we total the expression bytes of every entry
+    and separately find the expression in effect at pc.
+
+    @code
+*/
+int example_loclistcursor(Dwarf_Attribute someattr,
+    Dwarf_Addr pc,
+    Dwarf_Unsigned *bytes_total,
+    Dwarf_Ptr *expr_at_pc,
+    Dwarf_Unsigned *exprlen_at_pc,
+    Dwarf_Error *error)
+{
+    Dwarf_Loclist_Cursor cursor;
+    Dwarf_Addr lowpc = 0;
+    Dwarf_Addr highpc = 0;
+    int res = 0;
+
+    res = dwarf_loclist_cursor_init(someattr,&cursor,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    for (;;) {
+        Dwarf_Small    lle_value = 0;
+        Dwarf_Bool     unavailable = FALSE;
+        Dwarf_Ptr      exprbytes = 0;
+        Dwarf_Unsigned exprlen = 0;
+
+        res = dwarf_loclist_cursor_next(&cursor,&lle_value,
+            &lowpc,&highpc,&unavailable,
+            &exprbytes,&exprlen,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        if (res == DW_DLV_NO_ENTRY) {
+            break;
+        }
+        *bytes_total += exprlen;
+    }
+    /*  The pointer returned points into section
+        memory, so it can be handed straight to
+        dwarf_expr_compile(). */
+    res = dwarf_loclist_at_pc(someattr,pc,&lowpc,&highpc,
+        expr_at_pc,exprlen_at_pc,error);
+    return res;
+}
+/*! @endcode */
+
 /*! @defgroup examplea  Example of dwarf_get_loclist_c
     @brief Example using dwarf_get_loclist_c
 
@@ -866,9 +866,91 @@ The available options are
 "line_range",
 "linetable_version",
 "segment_selector_size",
+"segment_size",
+"parallel_transform",
+"str_tail_merge",
+"use_addrx",
+"optimize_line_program",
 and
-"segment_size".
-.DE
+"compress_debug_sections".
+.DE
+.P
+"parallel_transform=1" lets
+\f(CWdwarf_transform_to_disk_form_a()\fP
+generate .debug_line on a second thread while
+.debug_frame and .debug_info are generated on the
+calling thread.
+The output is byte-for-byte the same as without the option.
+Where libdwarfp was built without pthreads the
+option is accepted and ignored.
+.P
+"str_tail_merge=1" makes
+\f(CWdwarf_transform_to_disk_form_a()\fP
+store each .debug_str string that is a suffix
+of another .debug_str string (for example "int"
+and "unsigned int") inside the longer one,
+rewriting the DW_FORM_strp offsets
+and .debug_names entries to match.
+It has no effect on CUs already written with
+\f(CWdwarf_transform_cu_to_disk_form_a()\fP,
+whose offsets are already on disk.
+.P
+"use_addrx=1" makes every DW_FORM_addr attribute
+of a DWARF5 CU (such as DW_AT_low_pc added with
+\f(CWdwarf_add_AT_targ_address_c()\fP)
+refer by index to an entry in a .debug_addr
+table instead.
+Each distinct address (and relocation symbol) gets one
+entry per CU, so only the table needs relocations.
+The form used is the smallest of
+DW_FORM_addrx1 through DW_FORM_addrx4
+that holds the CU's largest index,
+and the CU DIE is given DW_AT_addr_base.
+For earlier DWARF versions the option is ignored.
+.P
+"optimize_line_program=1" makes
+each .debug_line line program use the
+line_base and line_range (within -32 through 1 and
+1 through 64) that give its rows the smallest encoding,
+replacing the values set by default or with the
+"line_base" and "line_range" options
+only where that is smaller.
+Each row is then written with whichever of a special opcode,
+DW_LNS_const_add_pc and a special opcode,
+DW_LNS_advance_pc or DW_LNS_fixed_advance_pc
+and a special opcode, or
+the standard opcodes is shortest.
+The rows read back are the same as without the option.
+.P
+"compress_debug_sections=1" (zlib) or
+"compress_debug_sections=2" (zstd) makes
+\f(CWdwarf_transform_to_disk_form_a()\fP
+return each DWARF section as one buffer holding an
+ELF compression header (Elf64_Chdr if the pointer size
+is 8, else Elf32_Chdr) followed by the compressed
+section bytes.
+The section creation callback is passed
+SHF_COMPRESSED in its flags argument so the caller
+can set sh_flags to match.
+A section that compression would not make smaller
+is returned uncompressed, as GNU as does;
+\f(CWdwarf_pro_get_section_compressed()\fP
+tells which sections those are, so the caller
+can clear SHF_COMPRESSED for them.
+Sections are compressed on several threads where
+libdwarfp was built with pthreads.
+Relocation records are unchanged and, as with
+GNU as --compress-debug-sections, their offsets
+refer to the uncompressed section contents;
+relocation sections are not compressed.
+The value is refused by
+\f(CWdwarf_producer_init()\fP
+with DW_DLE_PRO_COMPRESS_UNSUPPORTED
+if libdwarfp was built without zlib or zstd
+respectively.
+Per-CU streaming cannot be combined with it:
+\f(CWdwarf_transform_cu_to_disk_form_a()\fP
+then fails with DW_DLE_PRO_STREAM_ERROR.
 .P
 For example, to set the line-table generation
 default value of is_stmt to 0
@@ -917,18 +999,40 @@ The function
 \f(CWdwarf_pro_set_default_string_form()\fP 
 sets the 
 \f(CWDwarf_P_Debug\fP descriptor to favor one of
-the two allowed values:
+the allowed values:
 \f(CWDW_FORM_string\fP
-(the default)
-or
-\f(CWDW_FORM_strp\fP.
+(the default),
+\f(CWDW_FORM_strp\fP
+or, for DWARF5 output only,
+\f(CWDW_FORM_strx\fP.
 .P
 When
 \f(CWDW_FORM_strp\fP
+or
+\f(CWDW_FORM_strx\fP
 is selected very short names will still
 use form
 \f(CWDW_FORM_string\fP .
 .P
+With
+\f(CWDW_FORM_strx\fP
+the strings go in
+\f(CW.debug_str\fP
+as with
+\f(CWDW_FORM_strp\fP,
+but each CU refers to them by index into its own
+\f(CW.debug_str_offsets\fP
+table, which holds each distinct string of the CU once.
+Only the table needs relocations.
+When the CU is generated the attributes are given
+the smallest of
+\f(CWDW_FORM_strx1\fP
+through
+\f(CWDW_FORM_strx4\fP
+that holds the CU's largest index,
+and the CU DIE is given
+\f(CWDW_AT_str_offsets_base\fP.
+.P
 The function should be called immediately after a successful call
 to 
 \f(CWdwarf_producer_init()\fP.
@@ -1050,6 +1154,39 @@ though both do the same work and have the
 same meaning.
 
 
+.H 3 "dwarf_pro_set_section_sink()"
+.DS
+\f(CWint dwarf_pro_set_section_sink(
+        Dwarf_P_Debug dbg,
+        Dwarf_P_Section_Sink sink,
+        void *sink_data,
+        Dwarf_Error* error)\fP
+.DE
+Called before
+\f(CWdwarf_transform_to_disk_form_a() \fP
+it makes the transform write the generated
+bytes through \f(CWsink\fP as each internal buffer
+fills (see
+\f(CWdwarf_transform_cu_to_disk_form_a() \fP
+for the sink arguments) instead of keeping
+them for
+\f(CWdwarf_get_section_bytes_a() \fP.
+The transform then returns a section count of zero.
+Each call passes the bytes for one range of
+one section.
+Ranges do not come in offset order (a unit
+header is passed once its length is known),
+so the sink must place the bytes by
+offset, as \f(CWpwrite()\fP would.
+With \f(CWDW_DLC_SYMBOLIC_RELOCATIONS\fP
+the relocations of each section are passed
+last, with a null bytes pointer.
+If a sink call does not return
+\f(CWDW_DLV_OK\fP
+the transform fails with DW_DLE_PRO_STREAM_ERROR.
+Passing a null \f(CWsink\fP restores the default.
+.P
+
 .H 3 "dwarf_get_section_bytes_a()"
 
 .DS
@@ -1370,6 +1507,27 @@ and sets
 \f(CWerror\fP 
 through the pointer.
 
+.H 3 "dwarf_pro_get_string_stats_a()"
+.DS
+\f(CWint dwarf_pro_get_string_stats_a(
+    Dwarf_P_Debug dbg,
+    Dwarf_Unsigned * str_count,
+    Dwarf_Unsigned * str_total_length,
+    Dwarf_Unsigned * strp_count_debug_str,
+    Dwarf_Unsigned * strp_len_debug_str,
+    Dwarf_Unsigned * strp_reused_count,
+    Dwarf_Unsigned * strp_reused_len,
+    Dwarf_Unsigned * strp_tail_merged_count,
+    Dwarf_Unsigned * strp_tail_merged_len,
+    Dwarf_Error* error) \fP
+.DE
+Identical to
+\f(CWdwarf_pro_get_string_stats()\fP
+but also returns how many .debug_str strings
+"str_tail_merge=1" stored inside a longer string
+and how many bytes of .debug_str that saved.
+Both are zero if the option was not used.
+
 
 .H 3 "dwarf_producer_finish_a()"
 .DS
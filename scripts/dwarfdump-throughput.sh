@@ -0,0 +1,80 @@
+#!/bin/sh
+# Copyright (C) 2026 agent
+# This test script is in the public domain for use
+# by anyone for any purpose.
+
+# Measures how fast dwarfdump writes a dump into a pipe,
+# in MB of output per second, so a change to the
+# output path can be compared before and after.
+# Usage:
+#   dwarfdump-throughput.sh [-o "options"] [-n runs] object \
+#       dwarfdump [dwarfdump ...]
+# Each dwarfdump given (for example one built before a change
+# and one after) is run on the object n times (default 5)
+# with the options (default -a) and the best run is reported.
+# The output is read through cat so stdout is a pipe,
+# as it is when the output is piped into grep or less.
+
+opts="-a"
+runs=5
+while [ $# -gt 0 ]
+do
+  case $1 in
+  -o) opts="$2" ; shift ; shift ;;
+  -n) runs="$2" ; shift ; shift ;;
+  *) break ;;
+  esac
+done
+if [ $# -lt 2 ]
+then
+  echo "Usage: $0 [-o \"options\"] [-n runs] object dwarfdump ..."
+  exit 1
+fi
+obj=$1
+shift
+if [ ! -f $obj ]
+then
+  echo "The object $obj is not found"
+  exit 1
+fi
+
+# Nanoseconds since the epoch, GNU date and busybox date
+# support %N. Elsewhere fall back to whole seconds.
+now() {
+  t=`date +%s%N 2>/dev/null`
+  case $t in
+  *N) t=`date +%s`000000000 ;;
+  esac
+  echo $t
+}
+
+for dd in "$@"
+do
+  if [ ! -x $dd ]
+  then
+    echo "The dwarfdump $dd is not executable"
+    exit 1
+  fi
+  bytes=`$dd $opts $obj 2>/dev/null | wc -c`
+  best=0
+  i=0
+  while [ $i -lt $runs ]
+  do
+    start=`now`
+    $dd $opts $obj 2>/dev/null | cat >/dev/null
+    end=`now`
+    ns=`expr $end - $start`
+    if [ $best -eq 0 ] || [ $ns -lt $best ]
+    then
+      best=$ns
+    fi
+    i=`expr $i + 1`
+  done
+  echo "$dd $opts" | awk -v b=$bytes -v ns=$best '{
+    secs = ns / 1000000000.0
+    if (secs <= 0) { secs = 0.000001 }
+    printf("%-50s %10d bytes %8.3f s %8.1f MB/s\n",
+      $0, b, secs, b / secs / 1000000.0)
+  }'
+done
+exit 0
@@ -32,7 +32,7 @@
 #include <config.h>
 
 #include <stddef.h> /* NULL */
-#include <stdlib.h> /* free() malloc() */
+#include <stdlib.h> /* free() */
 #include <string.h> /* strdup() */
 
 /* Windows specific header files */
@@ -44,27 +44,9 @@
 #include "libdwarf.h"
 #include "dd_globals.h"
 #include "dd_addrmap.h"
-#include "dd_tsearchbal.h"
+#include "dd_offsetmap.h"
 #include "libdwarf_private.h" /* For malloc/calloc debug */
 
-static struct Addr_Map_Entry *
-addr_map_create_entry(Dwarf_Unsigned k,char *name)
-{
-    struct Addr_Map_Entry *mp =
-        (struct Addr_Map_Entry *)malloc(
-        sizeof(struct Addr_Map_Entry));
-    if (!mp) {
-        return 0;
-    }
-    mp->mp_key = k;
-    if (name) {
-        /* Might be zero if malloc fails. Ok. */
-        mp->mp_name = (char *)strdup(name);
-    } else {
-        mp->mp_name = 0;
-    }
-    return mp;
-}
 static void
 addr_map_free_func(void *mx)
 {
@@ -74,68 +56,31 @@ addr_map_free_func(void *mx)
     }
     free(m->mp_name);
     m->mp_name = 0;
-    free(m);
     return;
 }
 
-static int
-addr_map_compare_func(const void *l, const void *r)
-{
-    const struct Addr_Map_Entry *ml = l;
-    const struct Addr_Map_Entry *mr = r;
-    if (ml->mp_key < mr->mp_key) {
-        return -1;
-    }
-    if (ml->mp_key > mr->mp_key) {
-        return 1;
-    }
-    return 0;
-}
 struct Addr_Map_Entry *
-addr_map_insert( Dwarf_Unsigned addr,char *name,void **tree1)
+addr_map_insert( Dwarf_Unsigned addr,char *name,void **map)
 {
-    void *retval = 0;
     struct Addr_Map_Entry *re = 0;
-    struct Addr_Map_Entry *e;
-    e  = addr_map_create_entry(addr,name);
-    /*  tsearch records e's contents unless e
-        is already present . We must not free it till
-        destroy time if it got added to tree1.  */
-    retval = dwarf_tsearch(e,tree1, addr_map_compare_func);
-    if (retval) {
-        re = *(struct Addr_Map_Entry **)retval;
-        if (re != e) {
-            /* We returned an existing record, e not needed. */
-            addr_map_free_func(e);
-        } else {
-            /* Record e got added to tree1, do not free record e. */
-        }
+    Dwarf_Bool is_new = FALSE;
+
+    re = (struct Addr_Map_Entry *)offsetmap_insert(addr,
+        sizeof(struct Addr_Map_Entry),map,&is_new);
+    if (re && is_new && name) {
+        /* Might be zero if malloc fails. Ok. */
+        re->mp_name = (char *)strdup(name);
     }
     return re;
 }
 struct Addr_Map_Entry *
-addr_map_find(Dwarf_Unsigned addr,void **tree1)
+addr_map_find(Dwarf_Unsigned addr,void **map)
 {
-    void *retval = 0;
-    struct Addr_Map_Entry *re = 0;
-    struct Addr_Map_Entry *e = 0;
-
-    e = addr_map_create_entry(addr,NULL);
-    retval = dwarf_tfind(e,tree1, addr_map_compare_func);
-    if (retval) {
-        re = *(struct Addr_Map_Entry **)retval;
-    }
-    /*  The one we created here must be deleted, it is dead.
-        We look at the returned one instead. */
-    addr_map_free_func(e);
-    return re;
+    return (struct Addr_Map_Entry *)offsetmap_find(addr,*map);
 }
 
 void
 addr_map_destroy(void *map)
 {
-    /* tdestroy is not part of Posix, it is a GNU libc function. */
-    if (map) {
-        dwarf_tdestroy(map,addr_map_free_func);
-    }
+    offsetmap_destroy(map,addr_map_free_func);
 }
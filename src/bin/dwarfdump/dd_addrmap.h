@@ -32,8 +32,10 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/*  A map (see dd_offsetmap.h) from an address
+    to a name. */
 struct Addr_Map_Entry {
-    Dwarf_Unsigned mp_key;
+    Dwarf_Unsigned mp_key; /* Must be the first field */
     char * mp_name;
 };
 
@@ -28,6 +28,7 @@
 
 #include <stdio.h>  /* printf() */
 #include <stdlib.h> /* calloc() free() malloc() */
+#include <string.h> /* memset() */
 
 /* Windows specific header files */
 #if defined(_WIN32) && defined(HAVE_STDAFX_H)
@@ -42,6 +43,9 @@
 #include "dd_naming.h"
 #include "dd_attr_form.h"
 #include "dwarfdump-af-table.h"
+#ifndef SKIP_AF_CHECK
+#include "dd_workers.h"
+#endif /* SKIP_AF_CHECK */
 
 #if 0
 static void
@@ -350,6 +354,98 @@ record_attr_form_use(
     return;
 }
 
+#ifndef SKIP_AF_CHECK
+static FILE *worker_report_file;
+static int   worker_report_res;
+
+static void
+zero_3key_count(const void * vptr,
+    DW_VISIT x,
+    int level UNUSEDARG)
+{
+    if (x == dwarf_preorder || x == dwarf_leaf) {
+        Three_Key_Entry *m = *(Three_Key_Entry **)vptr;
+
+        m->count = 0;
+    }
+}
+
+static void
+write_3key_count(const void * vptr,
+    DW_VISIT x,
+    int level UNUSEDARG)
+{
+    if (x == dwarf_preorder || x == dwarf_leaf) {
+        Three_Key_Entry *m = *(Three_Key_Entry **)vptr;
+
+        if (!m->count || worker_report_res != DW_DLV_OK) {
+            return;
+        }
+        worker_report_res = dd_report_write(worker_report_file,
+            m,sizeof(*m));
+    }
+}
+
+void
+attr_form_worker_begin(void)
+{
+    dwarf_twalk(threekey_attr_form_base,zero_3key_count);
+}
+
+int
+attr_form_worker_write(FILE *f)
+{
+    Three_Key_Entry end;
+
+    worker_report_file = f;
+    worker_report_res = DW_DLV_OK;
+    dwarf_twalk(threekey_attr_form_base,write_3key_count);
+    worker_report_file = 0;
+    if (worker_report_res != DW_DLV_OK) {
+        return worker_report_res;
+    }
+    /*  No entry written has a zero count. */
+    memset(&end,0,sizeof(end));
+    return dd_report_write(f,&end,sizeof(end));
+}
+
+int
+attr_form_worker_merge(FILE *f)
+{
+    for (;;) {
+        Three_Key_Entry w;
+        Three_Key_Entry *e = 0;
+        Three_Key_Entry *re = 0;
+        void *ret = 0;
+        int res = 0;
+
+        res = dd_report_read(f,&w,sizeof(w));
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        if (!w.count) {
+            return DW_DLV_OK;
+        }
+        res = make_3key(w.key1,w.key2,w.key3,w.std_or_exten,
+            w.from_tables,w.count,&e);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        ret = dwarf_tsearch(e,&threekey_attr_form_base,
+            std_compare_3key_entry);
+        if (!ret) {
+            free_func_3key_entry(e);
+            return DW_DLV_ERROR;
+        }
+        re = *(Three_Key_Entry **)ret;
+        if (re != e) {
+            re->count += w.count;
+            free_func_3key_entry(e);
+        }
+    }
+}
+#endif /* SKIP_AF_CHECK */
+
 static Dwarf_Unsigned recordcount = 0;
 static Dwarf_Unsigned recordmax = 0;
 static Three_Key_Entry * tkarray = 0;
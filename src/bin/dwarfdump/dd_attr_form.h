@@ -71,6 +71,13 @@ void record_attr_form_use(Dwarf_Debug dbg,
 extern void * threekey_attr_form_base; /* for attr-form combos */
 void print_attr_form_usage(int poe);
 
+/*  --threads=<n>: a worker starts the counts from zero,
+    writes the entries it counted and this process
+    adds them to its own tree. */
+void attr_form_worker_begin(void);
+int  attr_form_worker_write(FILE *f);
+int  attr_form_worker_merge(FILE *f);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
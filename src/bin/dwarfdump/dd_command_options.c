@@ -52,6 +52,7 @@
 #include "dd_compiler_info.h"
 #include "dd_regex.h"
 #include "dd_safe_strcpy.h"
+#include "dd_json.h"
 #include "libdwarf_private.h" /* For malloc/calloc debug */
 
 static const char *remove_quotes_pair(const char *text);
@@ -352,6 +353,7 @@ static void arg_file_output(void);
 static void arg_file_tied(void);
 static void arg_file_use_no_libelf(void);
 
+static void arg_format(void);
 static void arg_format_attr_name(void);
 static void arg_format_dense(void);
 static void arg_format_ellipsis(void);
@@ -374,6 +376,8 @@ static void arg_format_groupnumber(void);
 static void arg_format_limit(void);
 static void arg_format_producer(void);
 static void arg_format_snc(void);
+static void arg_threads(void);
+static void arg_stats(void);
 
 static void arg_print_all(void);
 static void arg_print_abbrev(void);
@@ -403,6 +407,7 @@ static void arg_print_str_offsets(void);
 static void arg_print_strings(void);
 static void arg_print_types(void);
 static void arg_print_weaknames(void);
+static void arg_size_report(void);
 
 static void arg_reloc(void);
 static void arg_reloc_abbrev(void);
@@ -426,6 +431,7 @@ static void arg_search_regex(void);
 static void arg_search_regex_count(void);
 static void arg_search_count(void);
 static void arg_search_invalid(void);
+static void arg_search_index(void);
 
 static void arg_search_print_children(void);
 static void arg_search_print_parent(void);
@@ -513,6 +519,12 @@ static const char *usage_long_text[] = {
 "     --print-str-offsets Print the .debug_str_offsets section",
 "-y   --print-type        Print pubtypes section",
 "-w   --print-weakname    Print weakname section",
+"     --size-report       Instead of the sections print the",
+"                         debug section sizes and where the",
+"                         bytes of .debug_info and .debug_types",
+"                         go by unit, producer, tag, attribute",
+"                         and form, and the bytes of repeated",
+"                         type units.",
 " ",
 "-------------------------------------------------------------------",
 "Print Elf Relocation Data",
@@ -571,6 +583,11 @@ static const char *usage_long_text[] = {
 "-------------------------------------------------------------------",
 "Print Output Qualifiers",
 "-------------------------------------------------------------------",
+"     --format=json             Write one JSON object per line",
+"                               for each section, CU, DIE, line",
+"                               row, CIE, FDE, arange and name",
+"                               the other options select,",
+"                               instead of text.",
 "-M   --format-attr-name        Print the form name for each",
 "                               attribute",
 "-d   --format-dense            One line per entry (info section)",
@@ -603,6 +620,16 @@ static const char *usage_long_text[] = {
 "                               for some common DWARF extensions",
 "                               (by default extensions accepted",
 "                               as standard).",
+"     --threads=<n>             Print the CUs of .debug_info and",
+"                               .debug_types with <n> worker",
+"                               processes where fork() exists.",
+"                               The output is unchanged.",
+"     --stats                   After printing, report the wall",
+"                               and CPU time of each printing",
+"                               phase, the bytes libdwarf read,",
+"                               decompressed and relocated per",
+"                               section and its allocations",
+"                               per DW_DLA type.",
 " ",
 "-------------------------------------------------------------------",
 "Print Output Limiters",
@@ -665,6 +692,9 @@ static const char *usage_long_text[] = {
 "                             only one -S option allowed, any= and",
 "                             regex= only usable if the functions",
 "                             required are found at configure time",
+"     --search-index          With any= or match= look only at the",
+"                             DIEs named in .debug_names,",
+"                             .debug_pubnames or the like",
 " ",
 "-Wc  --search-print-children Print children tree",
 "                             (wide format) with -S",
@@ -751,6 +781,7 @@ OPT_FILE_TIED,         /* -x tied=<path>  --file-tied=<path>   */
 OPT_FILE_USE_NO_LIBELF,/* --file-use-no-libelf=<path>        */
 
 /* Print Output Qualifiers  */
+OPT_FORMAT,                   /*      --format=<text|json>     */
 OPT_FORMAT_ATTR_NAME,         /* -M   --format-attr-name       */
 OPT_FORMAT_DENSE,             /* -d   --format-dense           */
 OPT_FORMAT_ELLIPSIS,          /* -e   --format-ellipsis        */
@@ -805,6 +836,7 @@ OPT_PRINT_STRINGS,            /* -s   --print-strings     */
 OPT_PRINT_STR_OFFSETS,        /*      --print-str-offsets */
 OPT_PRINT_TYPE,               /* -y   --print-type        */
 OPT_PRINT_WEAKNAME,           /* -w   --print-weakname    */
+OPT_SIZE_REPORT,              /*      --size-report       */
 
 /* Print Relocations Info                                 */
 OPT_RELOC,                    /* -o   --reloc             */
@@ -834,6 +866,7 @@ OPT_SEARCH_PRINT_TREE,        /* -W  --search-print-tree  */
 OPT_SEARCH_REGEX,       /* -S regex=<text> --search-regex=<text> */
 OPT_SEARCH_REGEX_COUNT,
     /* -Svregex=<text> --search-regex-count<text>*/
+OPT_SEARCH_INDEX,       /* --search-index */
 
 /* Help & Version                                            */
 OPT_HELP,                     /* -h  --help                  */
@@ -848,6 +881,9 @@ OPT_TRACE,                    /* -# --trace=<num>            */
 
 OPT_ALLOC_TREE_OFF,           /* --suppress-de-alloc-tree */
 
+OPT_THREADS,                  /* --threads=<n> */
+OPT_STATS,                    /* --stats */
+
 OPT_END
 };
 
@@ -911,6 +947,7 @@ static struct dwoption longopts[] =  {
 {"file-use-no-libelf",   dwno_argument, 0, OPT_FILE_USE_NO_LIBELF  },
 
 /* Print Output Qualifiers. */
+{"format",              dwrequired_argument, 0, OPT_FORMAT },
 {"format-attr-name",         dwno_argument, 0,
     OPT_FORMAT_ATTR_NAME        },
 {"format-dense",             dwno_argument, 0,
@@ -980,6 +1017,7 @@ OPT_FORMAT_SUPPRESS_OFFSETS },
 {"print-str-offsets", dwno_argument, 0, OPT_PRINT_STR_OFFSETS},
 {"print-type",        dwno_argument, 0, OPT_PRINT_TYPE       },
 {"print-weakname",    dwno_argument, 0, OPT_PRINT_WEAKNAME   },
+{"size-report",       dwno_argument, 0, OPT_SIZE_REPORT      },
 
 /* Print Relocations Info. */
 {"reloc",          dwno_argument, 0, OPT_RELOC         },
@@ -1002,6 +1040,7 @@ OPT_FORMAT_SUPPRESS_OFFSETS },
 {"search-any",            dwrequired_argument, 0,OPT_SEARCH_ANY  },
 {"search-any-count",      dwrequired_argument, 0,
     OPT_SEARCH_ANY_COUNT     },
+{"search-index",          dwno_argument,  0,OPT_SEARCH_INDEX },
 {"search-match",          dwrequired_argument, 0,
     OPT_SEARCH_MATCH },
 {"search-match-count",    dwrequired_argument, 0,
@@ -1028,6 +1067,8 @@ OPT_FORMAT_SUPPRESS_OFFSETS },
 {"trace", dwrequired_argument, 0, OPT_TRACE},
 
 {"suppress-de-alloc-tree",dwno_argument,0,OPT_ALLOC_TREE_OFF},
+{"threads",       dwrequired_argument, 0, OPT_THREADS },
+{"stats",         dwno_argument, 0, OPT_STATS },
 {0,0,0,0}
 };
 
@@ -1389,6 +1430,21 @@ void arg_format_limit(void)
     }
 }
 
+/*  Option '--threads=' */
+void arg_threads(void)
+{
+    int threads = atoi(dwoptarg);
+    if (threads > 0) {
+        glflags.gf_threads = threads;
+    }
+}
+
+/*  Option '--stats' */
+void arg_stats(void)
+{
+    glflags.gf_stats = TRUE;
+}
+
 /*  Option '-i' */
 void arg_print_info(void)
 {
@@ -1803,6 +1859,18 @@ void arg_print_macinfo(void)
     suppress_check_dwarf();
 }
 
+/*  Option '--format=' */
+void arg_format(void)
+{
+    if (dwoptarg && !strcmp(dwoptarg,"json")) {
+        glflags.gf_json_output = TRUE;
+    } else if (dwoptarg && !strcmp(dwoptarg,"text")) {
+        glflags.gf_json_output = FALSE;
+    } else {
+        arg_usage_error = TRUE;
+    }
+}
+
 /*  Option '-M' */
 void arg_format_attr_name(void)
 {
@@ -2203,6 +2271,12 @@ void arg_search_count(void)
     glflags.gf_search_print_results = TRUE;
 }
 
+/*  Option '--search-index' */
+void arg_search_index(void)
+{
+    glflags.gf_search_use_index = TRUE;
+}
+
 /*  Option '-t' */
 void arg_t_multiple_selection(void)
 {
@@ -2298,6 +2372,12 @@ void arg_print_weaknames(void)
     suppress_check_dwarf();
 }
 
+/*  Option '--size-report' */
+void arg_size_report(void)
+{
+    glflags.gf_size_report = TRUE;
+}
+
 /*  Option '-W[...]' */
 void arg_W_multiple_selection(void)
 {
@@ -2651,6 +2731,7 @@ set_command_options(int argc, char *argv[])
         case OPT_FILE_USE_NO_LIBELF: arg_file_use_no_libelf(); break;
 
         /* Print Output Qualifiers. */
+        case OPT_FORMAT: arg_format(); break;
         case OPT_FORMAT_ATTR_NAME:
             arg_format_attr_name();        break;
         case OPT_FORMAT_DENSE:
@@ -2720,6 +2801,7 @@ set_command_options(int argc, char *argv[])
         case OPT_PRINT_STR_OFFSETS: arg_print_str_offsets(); break;
         case OPT_PRINT_TYPE:        arg_print_types();       break;
         case OPT_PRINT_WEAKNAME:    arg_print_weaknames();   break;
+        case OPT_SIZE_REPORT:       arg_size_report();       break;
 
         /* Print Relocations Info (only with libelf). */
         case OPT_RELOC:          arg_reloc();          break;
@@ -2755,6 +2837,7 @@ set_command_options(int argc, char *argv[])
         case OPT_SEARCH_REGEX:          arg_search_regex();break;
         case OPT_SEARCH_REGEX_COUNT:    arg_search_regex_count();
             break;
+        case OPT_SEARCH_INDEX:          arg_search_index(); break;
 
         /* Help & Version. */
         case OPT_HELP:          arg_help();          break;
@@ -2774,6 +2857,9 @@ set_command_options(int argc, char *argv[])
             dwarf_set_de_alloc_flag(FALSE);
             break;
 
+        case OPT_THREADS: arg_threads(); break;
+        case OPT_STATS: arg_stats(); break;
+
         default: arg_usage_error = TRUE; break;
         }
     }
@@ -2804,6 +2890,7 @@ static const char *simplestdargs[] ={
 "--suppress-de-alloc-tree",
 "--suppress-debuglink-crc",
 "--no-follow-debuglink",
+"--stats",
 0
 };
 
@@ -2827,6 +2914,12 @@ lacking_normal_args (int argct,char **args)
                 break;
             }
         }
+        /*  --threads=<n> and --format= change how,
+            not what, we print. */
+        if (!strncmp(curarg,"--threads=",10) ||
+            !strncmp(curarg,"--format=",9)) {
+            simple = TRUE;
+        }
         if (simple) {
             continue;
         }
@@ -2839,6 +2932,165 @@ lacking_normal_args (int argct,char **args)
     return TRUE;
 }
 
+/*  With --format=json the section options pick the
+    JSON records to write, then every text printing
+    flag is turned off so that only JSON is written. */
+static void
+select_json_records(void)
+{
+    unsigned records = JSON_RECORDS_SECTIONS;
+
+    if (glflags.gf_info_flag || glflags.gf_types_flag) {
+        records |= JSON_RECORDS_DIES;
+    }
+    if (glflags.gf_line_flag) {
+        records |= JSON_RECORDS_LINES;
+    }
+    if (glflags.gf_frame_flag) {
+        records |= JSON_RECORDS_FRAMES;
+    }
+    if (glflags.gf_eh_frame_flag) {
+        records |= JSON_RECORDS_EH_FRAMES;
+    }
+    if (glflags.gf_aranges_flag) {
+        records |= JSON_RECORDS_ARANGES;
+    }
+    if (glflags.gf_pubnames_flag || glflags.gf_debug_names_flag) {
+        records |= JSON_RECORDS_NAMES;
+    }
+    glflags.gf_json_records = records;
+
+    glflags.gf_abbrev_flag = FALSE;
+    glflags.gf_aranges_flag = FALSE;
+    glflags.gf_cu_name_flag = FALSE;
+    glflags.gf_debug_addr_flag = FALSE;
+    glflags.gf_debug_gnu_flag = FALSE;
+    glflags.gf_debug_names_flag = FALSE;
+    glflags.gf_debug_sup_flag = FALSE;
+    glflags.gf_eh_frame_flag = FALSE;
+    glflags.gf_frame_flag = FALSE;
+    glflags.gf_gdbindex_flag = FALSE;
+    glflags.gf_gnu_debuglink_flag = FALSE;
+    glflags.gf_header_flag = FALSE;
+    glflags.gf_info_flag = FALSE;
+    glflags.gf_line_flag = FALSE;
+    glflags.gf_loc_flag = FALSE;
+    glflags.gf_macinfo_flag = FALSE;
+    glflags.gf_macro_flag = FALSE;
+    glflags.gf_print_raw_loclists = FALSE;
+    glflags.gf_print_raw_rnglists = FALSE;
+    glflags.gf_print_str_offsets = FALSE;
+    glflags.gf_producer_children_flag = FALSE;
+    glflags.gf_pubnames_flag = FALSE;
+    glflags.gf_pubtypes_flag = FALSE;
+    glflags.gf_ranges_flag = FALSE;
+    glflags.gf_reloc_flag = FALSE;
+    glflags.gf_section_groups_flag = FALSE;
+    glflags.gf_static_func_flag = FALSE;
+    glflags.gf_static_var_flag = FALSE;
+    glflags.gf_string_flag = FALSE;
+    glflags.gf_types_flag = FALSE;
+    glflags.gf_weakname_flag = FALSE;
+}
+
+/*  Sections needed to read the CU DIEs, whether
+    to print lines or to name frame entries. */
+static const char *die_load_names[] = {
+    DW_SECTNAME_DEBUG_INFO,
+    DW_SECTNAME_DEBUG_INFO_DWO,
+    DW_SECTNAME_DEBUG_ABBREV,
+    DW_SECTNAME_DEBUG_ABBREV_DWO,
+    DW_SECTNAME_DEBUG_STR,
+    DW_SECTNAME_DEBUG_STR_DWO,
+    DW_SECTNAME_DEBUG_STR_OFFSETS,
+    DW_SECTNAME_DEBUG_STR_OFFSETS_DWO,
+    DW_SECTNAME_DEBUG_LINE_STR,
+    DW_SECTNAME_DEBUG_ADDR,
+    DW_SECTNAME_DEBUG_RANGES,
+    DW_SECTNAME_DEBUG_RNGLISTS,
+    DW_SECTNAME_DEBUG_RNGLISTS_DWO,
+    DW_SECTNAME_DEBUG_LOC,
+    DW_SECTNAME_DEBUG_LOCLISTS,
+    DW_SECTNAME_DEBUG_LOCLISTS_DWO,
+    DW_SECTNAME_DEBUG_TYPES,
+    DW_SECTNAME_DEBUG_SUP,
+    DW_SECTNAME_DEBUG_CU_INDEX,
+    DW_SECTNAME_DEBUG_TU_INDEX,
+    0
+};
+
+static void
+enable_die_load_sections(void)
+{
+    const char **cur = die_load_names;
+
+    for ( ; *cur; ++cur) {
+        enable_load_map_section(*cur);
+    }
+}
+
+/*  When only frames, strings or lines are printed
+    libdwarf is told to leave every other DWARF
+    section (and its relocations) unread.
+    Anything else keeps the default of reading
+    whatever is asked for, so this list of
+    options is deliberately short. */
+static void
+select_load_map(void)
+{
+    if (!glflags.gf_frame_flag && !glflags.gf_eh_frame_flag &&
+        !glflags.gf_string_flag && !glflags.gf_line_flag) {
+        return;
+    }
+    if (glflags.gf_abbrev_flag || glflags.gf_aranges_flag ||
+        glflags.gf_debug_names_flag || glflags.gf_gdbindex_flag ||
+        glflags.gf_gnu_debuglink_flag || glflags.gf_debug_gnu_flag ||
+        glflags.gf_debug_sup_flag || glflags.gf_info_flag ||
+        glflags.gf_loc_flag || glflags.gf_macinfo_flag ||
+        glflags.gf_macro_flag || glflags.gf_pubnames_flag ||
+        glflags.gf_debug_addr_flag || glflags.gf_ranges_flag ||
+        glflags.gf_reloc_flag || glflags.gf_static_func_flag ||
+        glflags.gf_static_var_flag || glflags.gf_pubtypes_flag ||
+        glflags.gf_types_flag || glflags.gf_weakname_flag ||
+        glflags.gf_header_flag ||
+        glflags.gf_producer_children_flag ||
+        glflags.gf_print_str_offsets ||
+        glflags.gf_print_raw_rnglists ||
+        glflags.gf_print_raw_loclists ||
+        glflags.gf_print_usage_tag_attr ||
+        glflags.gf_size_report || glflags.gf_search_is_on ||
+        glflags.gf_do_check_dwarf || glflags.gf_check_macros ||
+        glflags.gf_cu_name_flag || glflags.gf_json_output) {
+        return;
+    }
+    if (esb_string_len(glflags.config_file_tiedpath) > 0) {
+        return;
+    }
+    if (glflags.gf_frame_flag) {
+        enable_load_map_section(DW_SECTNAME_DEBUG_FRAME);
+    }
+    if (glflags.gf_eh_frame_flag) {
+        enable_load_map_section(DW_SECTNAME_EH_FRAME);
+    }
+    if (glflags.gf_string_flag) {
+        /*  libdwarf reads a .debug_str.dwo in place
+            of .debug_str. */
+        enable_load_map_section(DW_SECTNAME_DEBUG_STR);
+        enable_load_map_section(DW_SECTNAME_DEBUG_STR_DWO);
+    }
+    if (glflags.gf_line_flag) {
+        enable_die_load_sections();
+        enable_load_map_section(DW_SECTNAME_DEBUG_LINE);
+        enable_load_map_section(DW_SECTNAME_DEBUG_LINE_DWO);
+    }
+    if ((glflags.gf_frame_flag || glflags.gf_eh_frame_flag) &&
+        !glflags.gf_suppress_nested_name_search) {
+        /*  Frame entries are named from the
+            subprogram DIEs. */
+        enable_die_load_sections();
+    }
+}
+
 /* process arguments and return object filename */
 const char *
 process_args(int argc, char *argv[])
@@ -2874,12 +3126,14 @@ process_args(int argc, char *argv[])
         if (res == FOUND_ERROR) {
             if (!glflags.gf_do_print_dwarf &&
                 !glflags.gf_do_check_dwarf) {
-                printf("Frame not configured due to "
-                    "configure error(s).\n");
-                printf("(Since no print or check options provided "
+                fprintf(dd_json_notice_file(),
+                    "Frame not configured due to "
+                    "configure error(s).\n"
+                    "(Since no print or check options provided "
                     "dwarfdump may now silently exit)\n");
             } else {
-                printf("Frame not configured due to "
+                fprintf(dd_json_notice_file(),
+                    "Frame not configured due to "
                     "configure error(s), "
                     "using generic 100 registers.\n"
                     "Frame section access suppressed.\n");
@@ -2895,6 +3149,23 @@ process_args(int argc, char *argv[])
             /* FOUND_ABI_START nothing to do. */
         }
     }
+    if (glflags.gf_size_report) {
+        /*  Every DIE is read for the report
+            and only the report is printed. */
+        glflags.gf_info_flag = TRUE;
+        glflags.gf_types_flag = TRUE;
+        glflags.gf_do_print_dwarf = FALSE;
+    }
+    if (glflags.gf_json_output) {
+        if (glflags.gf_do_check_dwarf || glflags.gf_search_is_on) {
+            printf("%s --format=json does not apply to "
+                "checking (-k) or searching (-S).\n",
+                glflags.program_name);
+            arg_usage_error = TRUE;
+        } else if (!glflags.gf_size_report) {
+            select_json_records();
+        }
+    }
     if (arg_usage_error ) {
         printf("%s option error.\n",glflags.program_name);
         printf("To see the options list: %s -h\n",
@@ -2953,5 +3224,6 @@ process_args(int argc, char *argv[])
             (checking means checking-only). */
         glflags.verbose = 1;
     }
+    select_load_map();
     return do_uri_translation(argv[dwoptind],"file-to-process");
 }
@@ -45,6 +45,7 @@
 #include "dd_safe_strcpy.h"
 #include "dd_command_options.h"
 #include "dd_compiler_info.h"
+#include "dd_workers.h"
 #include "libdwarf_private.h" /* For malloc/calloc debug */
 
 /* Record compilers  whose CU names have been seen.
@@ -198,19 +199,12 @@ print_specific_checks_results(Compiler *pCompiler)
     table and is printed if the '-P' or '--print-producers'
     option is specified in the
     command line. */
-void
-add_cu_name_compiler_target(char *name)
+static void
+add_cu_name_to_compiler(Compiler *pCompiler, const char *name)
 {
     a_name_chain *cu_last = 0;
     a_name_chain *nc = 0;
-    Compiler *pCompiler = 0;
 
-    if (current_compiler < 1) {
-        printf("ERROR Current  compiler set to %d, cannot add "
-            "Compilation unit name.  Giving up.",current_compiler);
-        exit(EXIT_FAILURE);
-    }
-    pCompiler = &compilers_detected[current_compiler];
     cu_last = pCompiler->cu_last;
     /* Record current cu name */
     nc = (a_name_chain *)malloc(sizeof(a_name_chain));
@@ -231,6 +225,18 @@ add_cu_name_compiler_target(char *name)
     pCompiler->cu_last = nc;
 }
 
+void
+add_cu_name_compiler_target(char *name)
+{
+    if (current_compiler < 1) {
+        printf("ERROR Current  compiler set to %d, cannot add "
+            "Compilation unit name.  Giving up.",current_compiler);
+        exit(EXIT_FAILURE);
+    }
+    add_cu_name_to_compiler(&compilers_detected[current_compiler],
+        name);
+}
+
 /* Reset a compiler entry, so all fields are properly set */
 void
 reset_compiler_entry(Compiler *compiler)
@@ -317,6 +323,194 @@ update_compiler_target(const char *producer_name)
     }
 }
 
+/*  --threads=<n>: a worker keeps the compilers
+    detected so far (so the indexes stay valid) but
+    starts their results from zero, so what it writes
+    at the end is what it added.  The merge matches
+    compilers by name in the order the worker detected
+    them, which is the order a serial run detects them,
+    and leaves the current compiler as the worker did. */
+void
+compilers_worker_begin(void)
+{
+    int index = 0;
+
+    for (index = 0; index <= compilers_detected_count; ++index) {
+        Compiler *pCompiler = &compilers_detected[index];
+
+        pCompiler->verified = FALSE;
+        pCompiler->cu_list = 0;
+        pCompiler->cu_last = 0;
+        memset(pCompiler->results,0,sizeof(pCompiler->results));
+    }
+}
+
+int
+compilers_worker_write(FILE *f)
+{
+    int index = 0;
+    int res = 0;
+
+    res = dd_report_write(f,&compilers_detected_count,
+        sizeof(compilers_detected_count));
+    for (index = 0; res == DW_DLV_OK &&
+        index <= compilers_detected_count; ++index) {
+        Compiler *pCompiler = &compilers_detected[index];
+        a_name_chain *nc = 0;
+        unsigned cu_names = 0;
+
+        for (nc = pCompiler->cu_list; nc; nc = nc->next) {
+            ++cu_names;
+        }
+        res = dd_report_write_string(f,pCompiler->name);
+        if (res == DW_DLV_OK) {
+            res = dd_report_write(f,&pCompiler->verified,
+                sizeof(pCompiler->verified));
+        }
+        if (res == DW_DLV_OK) {
+            res = dd_report_write(f,pCompiler->results,
+                sizeof(pCompiler->results));
+        }
+        if (res == DW_DLV_OK) {
+            res = dd_report_write(f,&cu_names,sizeof(cu_names));
+        }
+        for (nc = pCompiler->cu_list; res == DW_DLV_OK && nc;
+            nc = nc->next) {
+            res = dd_report_write_string(f,nc->item);
+        }
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&compilers_targeted_count,
+            sizeof(compilers_targeted_count));
+    }
+    for (index = 1; res == DW_DLV_OK &&
+        index <= compilers_targeted_count; ++index) {
+        res = dd_report_write(f,&compilers_targeted[index].verified,
+            sizeof(compilers_targeted[index].verified));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&current_compiler,
+            sizeof(current_compiler));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&current_cu_is_checked_compiler,
+            sizeof(current_cu_is_checked_compiler));
+    }
+    return res;
+}
+
+/*  Returns the index of the compiler named, adding it
+    if there is room, or -1. */
+static int
+merge_compiler_index(const char *name)
+{
+    int index = 0;
+
+    for (index = 1; index <= compilers_detected_count; ++index) {
+        if (!strcmp(compilers_detected[index].name,name)) {
+            return index;
+        }
+    }
+    if ((compilers_detected_count + 1) >= COMPILER_TABLE_MAX) {
+        return -1;
+    }
+    index = ++compilers_detected_count;
+    reset_compiler_entry(&compilers_detected[index]);
+    compilers_detected[index].name = makename(name);
+    return index;
+}
+
+int
+compilers_worker_merge(FILE *f)
+{
+    int map[COMPILER_TABLE_MAX];
+    int detected = 0;
+    int count = 0;
+    int index = 0;
+    int worker_current = -1;
+    int res = 0;
+
+    res = dd_report_read(f,&detected,sizeof(detected));
+    if (res != DW_DLV_OK || detected < 0 ||
+        detected >= COMPILER_TABLE_MAX) {
+        return DW_DLV_ERROR;
+    }
+    for (index = 0; index <= detected; ++index) {
+        char *name = 0;
+        Dwarf_Bool verified = FALSE;
+        Dwarf_Check_Result results[LAST_CATEGORY];
+        unsigned cu_names = 0;
+        unsigned i = 0;
+        int c = 0;
+        Compiler *pCompiler = 0;
+
+        res = dd_report_read_string(f,&name);
+        if (res == DW_DLV_OK) {
+            res = dd_report_read(f,&verified,sizeof(verified));
+        }
+        if (res == DW_DLV_OK) {
+            res = dd_report_read(f,results,sizeof(results));
+        }
+        if (res == DW_DLV_OK) {
+            res = dd_report_read(f,&cu_names,sizeof(cu_names));
+        }
+        if (res != DW_DLV_OK || (index && !name)) {
+            free(name);
+            return DW_DLV_ERROR;
+        }
+        map[index] = index? merge_compiler_index(name) : 0;
+        free(name);
+        if (map[index] >= 0) {
+            pCompiler = &compilers_detected[map[index]];
+            if (verified) {
+                pCompiler->verified = TRUE;
+            }
+            for (c = 0; c < LAST_CATEGORY; ++c) {
+                pCompiler->results[c].checks += results[c].checks;
+                pCompiler->results[c].errors += results[c].errors;
+            }
+        }
+        for (i = 0; i < cu_names; ++i) {
+            char *cu_name = 0;
+
+            res = dd_report_read_string(f,&cu_name);
+            if (res != DW_DLV_OK || !cu_name) {
+                free(cu_name);
+                return DW_DLV_ERROR;
+            }
+            if (pCompiler) {
+                add_cu_name_to_compiler(pCompiler,cu_name);
+            }
+            free(cu_name);
+        }
+    }
+    res = dd_report_read(f,&count,sizeof(count));
+    for (index = 1; res == DW_DLV_OK && index <= count; ++index) {
+        Dwarf_Bool verified = FALSE;
+
+        res = dd_report_read(f,&verified,sizeof(verified));
+        if (verified && index <= compilers_targeted_count) {
+            compilers_targeted[index].verified = TRUE;
+        }
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&worker_current,
+            sizeof(worker_current));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&current_cu_is_checked_compiler,
+            sizeof(current_cu_is_checked_compiler));
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    current_compiler = worker_current;
+    if (worker_current > 0 && worker_current <= detected) {
+        current_compiler = map[worker_current];
+    }
+    return DW_DLV_OK;
+}
+
 void
 clean_up_compilers_detected(void)
 {
@@ -63,6 +63,12 @@ extern Dwarf_Bool checking_this_compiler(void);
 extern void reset_compiler_entry(Compiler *compiler);
 extern void print_checks_results(void);
 
+/*  --threads=<n>: start from zero in a worker,
+    write what it added, add that in here. */
+extern void compilers_worker_begin(void);
+extern int  compilers_worker_write(FILE *f);
+extern int  compilers_worker_merge(FILE *f);
+
 extern void DWARF_CHECK_COUNT(Dwarf_Check_Categories category,
     int inc);
 extern void DWARF_ERROR_COUNT(Dwarf_Check_Categories category,
@@ -55,6 +55,7 @@ Portions Copyright 2012 SN Systems Ltd. All rights reserved.
 #include "dd_sanitized.h"
 #include "dd_esb.h"
 #include "dd_safe_strcpy.h"
+#include "dd_json.h"
 
 /* The nesting level is arbitrary,  2 should suffice.
    But at least this prevents an infinite loop.
@@ -214,7 +215,8 @@ find_conf_file_and_read_config_inner(const char *named_file,
     if (!conf_stream) {
         ++errcount;
         if (!named_file || !strlen(named_file)) {
-            printf("dwarfdump found no dwarfdump.conf file "
+            fprintf(dd_json_notice_file(),
+                "dwarfdump found no dwarfdump.conf file "
                 "in any of the standard places\n"
                 "(precede all arguments "
                 "with option --show-dwarfdump-conf to see "
@@ -222,7 +224,8 @@ find_conf_file_and_read_config_inner(const char *named_file,
                 "If no print/check arguments also provided "
                 "dwarfdump may silently just stop.\n");
         } else {
-            printf("dwarfdump found no dwarfdump.conf "
+            fprintf(dd_json_notice_file(),
+                "dwarfdump found no dwarfdump.conf "
                 "file \"%s\"\n"
                 "If no print/check arguments also provided "
                 "dwarfdump may silently just stop.\n",
@@ -231,7 +234,8 @@ find_conf_file_and_read_config_inner(const char *named_file,
         return FOUND_ERROR;
     }
     if (glflags.gf_show_dwarfdump_conf) {
-        printf("dwarfdump using configuration "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump using configuration "
             "file \"%s\"\n", sanitized(name_used));
     }
     conf_internal->conf_name_used = name_used;
@@ -246,7 +250,8 @@ find_conf_file_and_read_config_inner(const char *named_file,
     if (res == FOUND_ERROR) {
         ++errcount;
         fclose(conf_stream);
-        printf("dwarfdump found no usable abi \"%s\" "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump found no usable abi \"%s\" "
             "in file \"%s\".\n",
             named_abi?named_abi:"<not looking for abi>",
             name_used);
@@ -257,7 +262,8 @@ find_conf_file_and_read_config_inner(const char *named_file,
     if (res != 0) {
         ++errcount;
         fclose(conf_stream);
-        printf("dwarfdump seek to %ld offset in %s failed!\n",
+        fprintf(dd_json_notice_file(),
+            "dwarfdump seek to %ld offset in %s failed!\n",
             offset, name_used);
         return FOUND_ERROR;
     }
@@ -313,7 +319,8 @@ find_a_file(const char *named_file,
     if (lname && (strlen(lname) > 0)) {
         /*  Name given, just assume it is fully correct,
             try no other. */
-        printf("dwarfdump looking for"
+        fprintf(dd_json_notice_file(),
+            "dwarfdump looking for"
             " configuration as \"%s\"\n", lname);
         fin = fopen(lname, type);
         if (fin) {
@@ -349,7 +356,8 @@ find_a_file(const char *named_file,
                 lname="<Impossible file name string>";
             }
             if (glflags.gf_show_dwarfdump_conf) {
-                printf("dwarfdump looking for"
+                fprintf(dd_json_notice_file(),
+                    "dwarfdump looking for"
                     " configuration as: \"%s\"\n", lname);
             }
             fin = fopen(lname, type);
@@ -386,7 +394,8 @@ find_a_file(const char *named_file,
             if (!lname || !strlen(lname)) {
                 lname="<Impossible name  string>";
             }
-            printf("dwarfdump looking for"
+            fprintf(dd_json_notice_file(),
+                "dwarfdump looking for"
                 " configuration as: \"%s\"\n", lname);
         }
         fin = fopen(lname, type);
@@ -444,7 +453,8 @@ ensure_has_no_more_tokens(char *cp,
 
     get_token(cp, &tok);
     if (tok.tk_len > 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "extra characters after command operands, found "
             "\"%s\" in %s line %lu\n", tok.tk_data, fname, lineno);
         ++errcount;
@@ -486,7 +496,8 @@ find_abi_start(FILE * stream, const char *abi_name,
                     matching historical behavior. */
                 glflags.gf_expr_ops_joined = TRUE;
             } else {
-                printf("ERROR: option command %s is not understood"
+                fprintf(dd_json_notice_file(),
+                    "ERROR: option command %s is not understood"
                     " giving up\n",tok.tk_data);
                 ++errcount;
                 return FOUND_ERROR;
@@ -549,7 +560,8 @@ get_token(char *cp, struct token_s *outtok)
         char *src = build_string(tlen, lcp);
         if (!src) {
             if (!outofmem) {
-                printf("Dwarfdump out of memory reading "
+                fprintf(dd_json_notice_file(),
+                    "Dwarfdump out of memory reading "
                     "dwarfdump.conf and will likely not work.\n");
             }
             outofmem = TRUE;
@@ -618,14 +630,16 @@ parseoption(char *cp, const char *fname,unsigned long lineno,
     cp = skipwhite(cp);
     get_token(cp, &tok);
     if (!tok.tk_data) {
-        printf("ERROR: empty option: command is ignored");
+        fprintf(dd_json_notice_file(),
+            "ERROR: empty option: command is ignored");
         return FALSE;
     }
     ensure_has_no_more_tokens(cp + tok.tk_len, fname, lineno);
     if (!strcmp(tok.tk_data,"--format-expr-ops-joined")) {
         glflags.gf_expr_ops_joined = TRUE;
     } else {
-        printf("ERROR: option command %s is not understood"
+        fprintf(dd_json_notice_file(),
+            "ERROR: option command %s is not understood"
             " and is ignored",tok.tk_data);
         return FALSE;
     }
@@ -648,7 +662,8 @@ parsebeginabi(char *cp, const char *fname, const char *abiname,
     get_token(cp, &tok);
     if (tok.tk_len != abinamelen ||
         strncmp(cp, abiname, abinamelen)) {
-        printf("dwarfdump internal error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump internal error: "
             "mismatch \"%s\" with \"%s\"   \"%s\" line %lu\n",
             cp, tok.tk_data, fname, lineno);
         ++errcount;
@@ -679,7 +694,8 @@ add_to_reg_table(struct dwconf_s *conf,
             conf->cf_named_regs_table_size * sizeof(char *);
         newregs = realloc(conf->cf_regs, newtabsize);
         if (!newregs) {
-            printf("dwarfdump: unable to malloc table %lu bytes. "
+            fprintf(dd_json_notice_file(),
+                "dwarfdump: unable to malloc table %lu bytes. "
                 " %s line %lu\n", newtabsize, fname, lineno);
             exit(EXIT_FAILURE);
         }
@@ -706,7 +722,8 @@ make_a_number(char *cmd, const char *filename, unsigned long
 
     val = strtoul(tok->tk_data, &endnum, 0);
     if (val == 0 && endnum == (tok->tk_data)) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing register number (\"%s\" "
             "not valid)  %s line %lu\n",
             cmd, tok->tk_data, filename, lineno);
@@ -714,7 +731,8 @@ make_a_number(char *cmd, const char *filename, unsigned long
         return FALSE;
     }
     if (endnum != (tok->tk_data + tok->tk_len)) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s Missing register number (\"%s\" "
             "not valid)  %s line %lu\n",
             cmd, tok->tk_data, filename, lineno);
@@ -744,7 +762,8 @@ parsereg(char *cp, const char *fname, unsigned long lineno,
     cp = get_token(cp, &tokreg);
     cp = get_token(cp, &regnum);
     if (tokreg.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "reg: missing register name  %s line %lu",
             fname, lineno);
         ++errcount;
@@ -752,7 +771,8 @@ parsereg(char *cp, const char *fname, unsigned long lineno,
 
     }
     if (regnum.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "reg: missing register number  %s line %lu",
             fname, lineno);
         ++errcount;
@@ -793,7 +813,8 @@ parseframe_interface(char *cp,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (tok.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing interface number %s line %lu",
             comtab->name, fname, lineno);
         ++errcount;
@@ -807,7 +828,8 @@ parseframe_interface(char *cp,
         return FALSE;
     }
     if (val != 2 && val != 3) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s only interface numbers 2 or 3 are allowed, "
             " not %lu. %s line %lu",
             comtab->name, val, fname, lineno);
@@ -837,7 +859,8 @@ parsecfa_reg(char *cp, const char *fname, unsigned long lineno,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (tok.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing cfa_reg number %s line %lu",
             comtab->name, fname, lineno);
         ++errcount;
@@ -872,7 +895,8 @@ parseinitial_reg_value(char *cp, const char *fname,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (tok.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing initial reg value %s line %lu",
             comtab->name, fname, lineno);
         ++errcount;
@@ -905,7 +929,8 @@ parsesame_val_reg(char *cp, const char *fname,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (tok.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing same_reg value %s line %lu",
             comtab->name, fname, lineno);
         ++errcount;
@@ -938,7 +963,8 @@ parseundefined_val_reg(char *cp, const char *fname,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (tok.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing undefined_reg value %s line %lu",
             comtab->name, fname, lineno);
         ++errcount;
@@ -973,7 +999,8 @@ parsereg_table_size(char *cp, const char *fname, unsigned long lineno,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (tok.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing reg table size value %s line %lu",
             comtab->name, fname, lineno);
         ++errcount;
@@ -1007,7 +1034,8 @@ parseaddress_size(char *cp, const char *fname, unsigned long lineno,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (tok.tk_len == 0) {
-        printf("dwarfdump.conf error: "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf error: "
             "%s missing address size value %s line %lu",
             comtab->name, fname, lineno);
         ++errcount;
@@ -1040,7 +1068,8 @@ parseendabi(char *cp, const char *fname,
     cp = cp + clen + 1;
     cp = get_token(cp, &tok);
     if (strcmp(abiname, tok.tk_data) != 0) {
-        printf("%s error: "
+        fprintf(dd_json_notice_file(),
+            "%s error: "
             "mismatch abi name %s (here) vs. "
             "%s (beginabi:)  %s line %lu\n",
             comtab->name, tok.tk_data, abiname, fname, lineno);
@@ -1097,7 +1126,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
 
     if (nest_level > MAX_NEST_LEVEL) {
         ++errcount;
-        printf("dwarfdump.conf: includeabi nest "
+        fprintf(dd_json_notice_file(),
+            "dwarfdump.conf: includeabi nest "
             "too deep in %s at line %lu\n",
             fname, lineno);
         return FALSE;
@@ -1115,7 +1145,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
         line = fgets(buf, sizeof(buf), stream);
         if (!line) {
             ++errcount;
-            printf("dwarfdump: end of file or error"
+            fprintf(dd_json_notice_file(),
+                "dwarfdump: end of file or error"
                 " before endabi: in %s, line %lu\n",
                 fname, lineno);
             return FALSE;
@@ -1141,7 +1172,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
         case LT_BEGINABI:
             if (conf_internal->beginabi_lineno > 0) {
                 ++errcount;
-                printf("dwarfdump: Encountered beginabi: "
+                fprintf(dd_json_notice_file(),
+                    "dwarfdump: Encountered beginabi: "
                     "when not expected. "
                     "%s line %lu previous beginabi line %lu\n",
                     fname,
@@ -1161,7 +1193,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
             if (!inourabi) break;
             if (conf_internal->frame_interface_lineno > 0) {
                 ++errcount;
-                printf("dwarfdump: Encountered duplicate "
+                fprintf(dd_json_notice_file(),
+                    "dwarfdump: Encountered duplicate "
                     "frame_interface: "
                     "%s line %lu previous frame_interface: "
                     "line %lu\n",
@@ -1175,7 +1208,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
         case LT_CFA_REG:
             if (!inourabi) break;
             if (conf_internal->cfa_reg_lineno > 0) {
-                printf("dwarfdump: Encountered duplicate cfa_reg: "
+                fprintf(dd_json_notice_file(),
+                    "dwarfdump: Encountered duplicate cfa_reg: "
                     "%s line %lu previous cfa_reg line %lu\n",
                     fname, lineno, conf_internal->cfa_reg_lineno);
                 ++errcount;
@@ -1234,7 +1268,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
         case LT_REG_TABLE_SIZE:
             if (!inourabi) break;
             if (conf_internal->reg_table_size_lineno > 0) {
-                printf("dwarfdump: duplicate reg_table_size: "
+                fprintf(dd_json_notice_file(),
+                    "dwarfdump: duplicate reg_table_size: "
                     "%s line %lu previous reg_table_size: line %lu\n",
                     fname, lineno,
                     conf_internal->reg_table_size_lineno);
@@ -1249,7 +1284,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
             parseendabi(line, fname, abiname, lineno, comtabp);
             if (conf_internal->regcount >
                 localconf->cf_table_entry_count) {
-                printf("dwarfdump: more registers named than "
+                fprintf(dd_json_notice_file(),
+                    "dwarfdump: more registers named than "
                     " in  %s  ( %lu named vs  %s %lu)"
                     "  %s line %lu\n",
                     abiname, (unsigned long) conf_internal->regcount,
@@ -1263,7 +1299,8 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
         case LT_ADDRESS_SIZE:
             if (!inourabi) break;
             if (conf_internal->address_size_lineno > 0) {
-                printf("dwarfdump: duplicate address_size: "
+                fprintf(dd_json_notice_file(),
+                    "dwarfdump: duplicate address_size: "
                     "%s line %lu previous address_size:"
                     " line %lu\n",
                     fname, lineno,
@@ -1299,14 +1336,16 @@ parse_abi(FILE * stream, const char *fname, const char *abiname,
             }
             break;
         default:
-            printf("dwarfdump internal error,"
+            fprintf(dd_json_notice_file(),
+                "dwarfdump internal error,"
                 " impossible line type %d  %s %lu \n",
                 (int) comtype, fname, lineno);
             exit(EXIT_FAILURE);
         }
     }
     ++errcount;
-    printf("End of file, no endabi: found. %s, line %lu\n",
+    fprintf(dd_json_notice_file(),
+        "End of file, no endabi: found. %s, line %lu\n",
         fname, lineno);
     return FALSE;
 }
@@ -296,6 +296,13 @@ esb_appendn(struct esb_s *data,
     esb_appendn_internal(data, in_string, len);
 }
 
+void
+esb_append_bytes(struct esb_s *data,
+    const char * in_bytes, size_t len)
+{
+    esb_appendn_internal(data, in_bytes, len);
+}
+
 /*  The length is gotten from the in_string itself, this
     is the usual way to add string data.. */
 void
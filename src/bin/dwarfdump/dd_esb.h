@@ -88,6 +88,10 @@ void esb_append(struct esb_s *data, const char * in_string);
 /* The 'len' is believed. Do not pass in strings < len bytes long. */
 void esb_appendn(struct esb_s *data,
     const char * in_string, size_t len);
+/*  Appends exactly len bytes, which need not be followed
+    by a NUL, without the strlen() esb_appendn() does. */
+void esb_append_bytes(struct esb_s *data,
+    const char * in_bytes, size_t len);
 
 /* Always returns an empty string or a non-empty string. Never 0. */
 char * esb_get_string(struct esb_s *data);
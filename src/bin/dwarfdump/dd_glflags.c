@@ -206,6 +206,7 @@ init_global_flags(void)
     /* -S option: strings for 'any' and 'match' */
     glflags.gf_search_is_on         = FALSE;
     glflags.gf_search_print_results = FALSE;
+    glflags.gf_search_use_index     = FALSE;
     glflags.gf_cu_name_flag         = FALSE;
     glflags.gf_show_global_offsets  = FALSE;
     glflags.gf_display_offsets      = TRUE;
@@ -288,6 +289,11 @@ init_global_flags(void)
         the -f or -F output to 2 FDEs and 2 CIEs.
     */
     glflags.break_after_n_units = INT_MAX;
+    glflags.gf_threads = 1;
+    glflags.gf_json_output = FALSE;
+    glflags.gf_json_records = 0;
+    glflags.gf_size_report = FALSE;
+    glflags.gf_stats = FALSE;
 
     glflags.section_high_offsets_global =
         &_section_high_offsets_global;
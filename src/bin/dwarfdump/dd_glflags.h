@@ -251,6 +251,9 @@ struct glflags_s {
     Dwarf_Bool gf_search_is_on;
 
     Dwarf_Bool gf_search_print_results;
+    /*  --search-index: search the name tables, not
+        every DIE, for any= and match=. */
+    Dwarf_Bool gf_search_use_index;
     Dwarf_Bool gf_cu_name_flag;
     Dwarf_Bool gf_show_global_offsets;
     Dwarf_Bool gf_display_offsets;
@@ -333,6 +336,28 @@ struct glflags_s {
     */
     int break_after_n_units;
 
+    /*  --threads=<n>: the number of worker processes
+        printing CUs of .debug_info and .debug_types.
+        1 (the default) means everything is done
+        in this process. See dd_workers.c */
+    int gf_threads;
+
+    /*  --format=json: the section options choose which
+        JSON_RECORDS_* print_json() writes, and all text
+        printing is then turned off. See print_json.c */
+    Dwarf_Bool gf_json_output;
+    unsigned   gf_json_records;
+
+    /*  --size-report: attribute the bytes of .debug_info
+        and .debug_types to units, producers, tags,
+        attributes and forms. See dd_size_report.c */
+    Dwarf_Bool gf_size_report;
+
+    /*  --stats: time the printing phases and report
+        what libdwarf read and allocated.
+        See dd_stats.c */
+    Dwarf_Bool gf_stats;
+
     struct section_high_offsets_s *section_high_offsets_global;
 
     /*  pRangesInfo records the DW_AT_high_pc and DW_AT_low_pc
@@ -451,6 +476,15 @@ Dwarf_Bool cu_data_is_set(void);
 #define         DEBUG_GNU_PUBNAMES 24
 #define         DEBUG_GNU_PUBTYPES 25
 
+/*  What --format=json writes, see gf_json_records. */
+#define JSON_RECORDS_SECTIONS  0x01
+#define JSON_RECORDS_DIES      0x02
+#define JSON_RECORDS_LINES     0x04
+#define JSON_RECORDS_FRAMES    0x08
+#define JSON_RECORDS_EH_FRAMES 0x10
+#define JSON_RECORDS_ARANGES   0x20
+#define JSON_RECORDS_NAMES     0x40
+
 /*  Print the information only if unique errors
     is set and it is first time */
 #define PRINTING_UNIQUE (!glflags.gf_found_error_message)
@@ -28,6 +28,9 @@ Portions Copyright 2012-2018 SN Systems Ltd. All rights reserved.
 
 #ifndef globals_INCLUDED
 #define globals_INCLUDED
+
+#include <stdio.h> /* FILE */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -145,6 +148,7 @@ extern int print_types(Dwarf_Debug dbg,enum type_type_e type_type,
     Dwarf_Error *);
 extern int print_weaknames(Dwarf_Debug dbg, Dwarf_Error *);
 extern int print_debug_names(Dwarf_Debug dbg,Dwarf_Error *);
+extern void print_json(Dwarf_Debug dbg);
 int print_debug_sup(Dwarf_Debug dbg, Dwarf_Error *error);
 extern int print_debug_addr(Dwarf_Debug dbg, Dwarf_Error *error);
 int print_all_abbrevs_for_cu(Dwarf_Debug dbg,
@@ -255,11 +259,19 @@ int print_macros_5style_this_cu(Dwarf_Debug dbg, Dwarf_Die cu_die,
 
 /* Detailed attributes encoding space */
 int print_attributes_encoding(Dwarf_Debug dbg,Dwarf_Error *);
+/*  --threads=<n>: start from zero in a worker,
+    write what it added, add that in here. */
+void attributes_encoding_worker_begin(void);
+int  attributes_encoding_worker_write(FILE *f);
+int  attributes_encoding_worker_merge(FILE *f);
 
 /* Detailed tag and attributes usage */
 int print_tag_attributes_usage(void);
 void record_tag_usage(int tag);
 void reset_usage_rate_tag_trees(void);
+void tag_usage_worker_begin(void);
+int  tag_usage_worker_write(FILE *f);
+int  tag_usage_worker_merge(FILE *f);
 
 int  print_section_groups_data(Dwarf_Debug dbg,Dwarf_Error *);
 void update_section_flags_per_groups(Dwarf_Debug dbg);
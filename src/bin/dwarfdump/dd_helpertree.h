@@ -27,12 +27,13 @@
 #ifndef HELPERTREE_H
 #define HELPERTREE_H
 
-/*  This is a tsearch tree  interface we may use in various ways
+/*  This is an offset map (see dd_offsetmap.h)
+    interface we may use in various ways
     where each different sort of use is a different
     Helpertree_Base_s instance. */
 
 /*  We create Helpertree_Base_s so we can use type-checked calls,
-    not showing the tsearch void* outside of helpertree.c. */
+    not showing the map void* outside of helpertree.c. */
 struct Helpertree_Base_s {
     void * hb_base;
 };
@@ -44,7 +45,8 @@ extern struct Helpertree_Base_s helpertree_offsets_base_types;
 
 struct Helpertree_Map_Entry_s {
     /*  Key is offset. It will be a section-global offset so
-        applicable across an entire executable/object section. */
+        applicable across an entire executable/object section.
+        The map requires it be the first field. */
     Dwarf_Unsigned hm_key;
 
     /*  val is something defined differently in different uses.
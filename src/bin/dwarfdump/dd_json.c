@@ -0,0 +1,274 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <config.h>
+
+#include <stdio.h> /* FILE stderr stdout */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "dd_globals.h"
+#include "dd_esb.h"
+#include "dd_output.h"
+#include "dd_json.h"
+
+static const char hexdigits[] = "0123456789abcdef";
+
+/*  The comma, if one is needed, then "key": */
+static void
+json_key(struct esb_s *r, const char *key)
+{
+    size_t len = esb_string_len(r);
+
+    if (len) {
+        char last = esb_get_string(r)[len-1];
+
+        if (last != '{' && last != '[') {
+            esb_append_bytes(r,",",1);
+        }
+    }
+    if (key) {
+        esb_append_bytes(r,"\"",1);
+        esb_append(r,key);
+        esb_append_bytes(r,"\":",2);
+    }
+}
+
+/*  Returns the length of the valid UTF-8 sequence
+    starting at p, or 0 if there is none. */
+static unsigned
+utf8_length(const unsigned char *p)
+{
+    unsigned c = p[0];
+    unsigned n = 0;
+    unsigned i = 0;
+
+    if (c >= 0xc2 && c <= 0xdf) {
+        n = 2;
+    } else if (c >= 0xe0 && c <= 0xef) {
+        n = 3;
+        if ((c == 0xe0 && p[1] < 0xa0) ||
+            (c == 0xed && p[1] > 0x9f)) {
+            /* Overlong, or a surrogate. */
+            return 0;
+        }
+    } else if (c >= 0xf0 && c <= 0xf4) {
+        n = 4;
+        if ((c == 0xf0 && p[1] < 0x90) ||
+            (c == 0xf4 && p[1] > 0x8f)) {
+            return 0;
+        }
+    } else {
+        return 0;
+    }
+    /*  A NUL stops this too, it is not a continuation. */
+    for (i = 1; i < n; ++i) {
+        if ((p[i] & 0xc0) != 0x80) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+void
+dd_json_append_escaped(struct esb_s *r, const char *s)
+{
+    const unsigned char *p = (const unsigned char *)s;
+    const unsigned char *run = p;
+
+    for (;;) {
+        unsigned c = *p;
+        char esc[7];
+
+        if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+            ++p;
+            continue;
+        }
+        if (c >= 0x80) {
+            unsigned n = utf8_length(p);
+
+            if (n) {
+                p += n;
+                continue;
+            }
+        }
+        if (p > run) {
+            esb_append_bytes(r,(const char *)run,(size_t)(p - run));
+        }
+        if (!c) {
+            return;
+        }
+        esc[0] = '\\';
+        switch (c) {
+        case '"':  esc[1] = '"';  esb_append_bytes(r,esc,2); break;
+        case '\\': esc[1] = '\\'; esb_append_bytes(r,esc,2); break;
+        case '\n': esc[1] = 'n';  esb_append_bytes(r,esc,2); break;
+        case '\r': esc[1] = 'r';  esb_append_bytes(r,esc,2); break;
+        case '\t': esc[1] = 't';  esb_append_bytes(r,esc,2); break;
+        default:
+            esc[1] = 'u';
+            esc[2] = '0';
+            esc[3] = '0';
+            esc[4] = hexdigits[(c >> 4) & 0xf];
+            esc[5] = hexdigits[c & 0xf];
+            esb_append_bytes(r,esc,6);
+            break;
+        }
+        ++p;
+        run = p;
+    }
+}
+
+void
+dd_json_begin(struct esb_s *r, const char *type)
+{
+    esb_empty_string(r);
+    esb_append_bytes(r,"{\"type\":\"",9);
+    esb_append(r,type);
+    esb_append_bytes(r,"\"",1);
+}
+
+void
+dd_json_end(struct esb_s *r)
+{
+    esb_append_bytes(r,"}\n",2);
+    dd_output_esb(r);
+    esb_empty_string(r);
+}
+
+void
+dd_json_string(struct esb_s *r, const char *key,
+    const char *value)
+{
+    json_key(r,key);
+    esb_append_bytes(r,"\"",1);
+    dd_json_append_escaped(r,value?value:"");
+    esb_append_bytes(r,"\"",1);
+}
+
+static void
+append_decimal(struct esb_s *r, Dwarf_Unsigned value)
+{
+    char buf[24];
+    char *p = buf + sizeof(buf);
+
+    do {
+        *--p = (char)('0' + value%10);
+        value /= 10;
+    } while (value);
+    esb_append_bytes(r,p,(size_t)(buf + sizeof(buf) - p));
+}
+
+void
+dd_json_unsigned(struct esb_s *r, const char *key,
+    Dwarf_Unsigned value)
+{
+    json_key(r,key);
+    append_decimal(r,value);
+}
+
+void
+dd_json_signed(struct esb_s *r, const char *key,
+    Dwarf_Signed value)
+{
+    Dwarf_Unsigned u = (Dwarf_Unsigned)value;
+
+    json_key(r,key);
+    if (value < 0) {
+        esb_append_bytes(r,"-",1);
+        /*  The magnitude, also right for the most negative. */
+        u = (Dwarf_Unsigned)0 - u;
+    }
+    append_decimal(r,u);
+}
+
+void
+dd_json_bool(struct esb_s *r, const char *key,
+    Dwarf_Bool value)
+{
+    json_key(r,key);
+    if (value) {
+        esb_append_bytes(r,"true",4);
+    } else {
+        esb_append_bytes(r,"false",5);
+    }
+}
+
+void
+dd_json_bytes(struct esb_s *r, const char *key,
+    const unsigned char *bytes, Dwarf_Unsigned len)
+{
+    Dwarf_Unsigned i = 0;
+
+    json_key(r,key);
+    esb_append_bytes(r,"\"",1);
+    for (i = 0; i < len; ++i) {
+        char hx[2];
+
+        hx[0] = hexdigits[(bytes[i] >> 4) & 0xf];
+        hx[1] = hexdigits[bytes[i] & 0xf];
+        esb_append_bytes(r,hx,2);
+    }
+    esb_append_bytes(r,"\"",1);
+}
+
+void
+dd_json_object_begin(struct esb_s *r, const char *key)
+{
+    json_key(r,key);
+    esb_append_bytes(r,"{",1);
+}
+
+void
+dd_json_object_end(struct esb_s *r)
+{
+    esb_append_bytes(r,"}",1);
+}
+
+void
+dd_json_array_begin(struct esb_s *r, const char *key)
+{
+    json_key(r,key);
+    esb_append_bytes(r,"[",1);
+}
+
+void
+dd_json_array_end(struct esb_s *r)
+{
+    esb_append_bytes(r,"]",1);
+}
+
+FILE *
+dd_json_notice_file(void)
+{
+    return glflags.gf_json_output?stderr:stdout;
+}
@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef DD_JSON_H
+#define DD_JSON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*  A small JSON writer for --format=json.
+    A record is built in an esb, starting with
+    dd_json_begin(), which writes {"type":"<type>",
+    and written to stdout as one line by dd_json_end().
+    Keys are written as given (they are constants here),
+    string values are escaped as they are appended, so
+    nothing is copied but into the record itself.
+    Members and array elements get their commas from
+    what the record ends with so far.
+    Numbers are written in decimal, of any size. */
+void dd_json_begin(struct esb_s *r, const char *type);
+void dd_json_end(struct esb_s *r);
+
+/*  A NULL key means an array element. */
+void dd_json_string(struct esb_s *r, const char *key,
+    const char *value);
+void dd_json_unsigned(struct esb_s *r, const char *key,
+    Dwarf_Unsigned value);
+void dd_json_signed(struct esb_s *r, const char *key,
+    Dwarf_Signed value);
+void dd_json_bool(struct esb_s *r, const char *key,
+    Dwarf_Bool value);
+/*  As a string of hex digits, two per byte. */
+void dd_json_bytes(struct esb_s *r, const char *key,
+    const unsigned char *bytes, Dwarf_Unsigned len);
+
+void dd_json_object_begin(struct esb_s *r, const char *key);
+void dd_json_object_end(struct esb_s *r);
+void dd_json_array_begin(struct esb_s *r, const char *key);
+void dd_json_array_end(struct esb_s *r);
+
+/*  Appends s as the contents of a JSON string (no quotes).
+    Valid UTF-8 is kept, other bytes above 0x7f
+    are written as \u00XX. */
+void dd_json_append_escaped(struct esb_s *r, const char *s);
+
+/*  Where to write a notice that is not a JSON record:
+    stderr with --format=json, so that every line of
+    stdout is a record, otherwise stdout. */
+FILE *dd_json_notice_file(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* DD_JSON_H */
@@ -56,18 +56,17 @@
 #include "libdwarf.h"
 #include "libdwarf_private.h"
 #include "dd_globals.h"
-#include "dd_tsearchbal.h"
+#include "dd_offsetmap.h"
 #include "dd_macrocheck.h"
 #include "dd_esb.h"
+#ifndef TESTING
+#include "dd_workers.h"
+#endif /* TESTING */
 
-/*  WARNING: the tree walk functions will, if presented **tree
-    when *tree is wanted, simply find nothing. No error,
-    just bad results. So when a walk produces nothing
-    suspect a code mistake here.
-    The basic problem is void* is a terrible way to
-    pass in a pointer. But it's how tsearch was defined
-    long ago.
-*/
+/*  macro_check_tree and macinfo_check_tree are offset
+    maps (see dd_offsetmap.h), not tsearch trees, as
+    each is consulted for every macro unit and import.
+    They keep the old names. */
 
 Dwarf_Unsigned macro_import_stack[MACRO_IMPORT_STACK_DEPTH +1];
 unsigned macro_import_stack_next_to_use;
@@ -87,7 +86,6 @@ static struct Macrocheck_Map_Entry_s * macrocheck_map_insert(
     Dwarf_Unsigned linenum,
     unsigned src_file_num,
     void **map);
-static void macrocheck_map_destroy(void *map);
 static Dwarf_Unsigned macro_count_recs(void **base);
 
 #ifdef TESTING
@@ -95,104 +93,35 @@ int failcount = 0;
 struct glflags_s glflags;
 #endif /* TESTING */
 
-static struct Macrocheck_Map_Entry_s *
-macrocheck_map_create_entry(Dwarf_Unsigned offset,
-    unsigned add_primary, unsigned add_secondary)
-{
-    struct Macrocheck_Map_Entry_s *mp =
-        (struct Macrocheck_Map_Entry_s *)
-        calloc(1,sizeof(struct Macrocheck_Map_Entry_s));
-    if (!mp) {
-        return 0;
-    }
-    mp->mp_key = offset;
-    mp->mp_len = 0;
-    mp->mp_printed = 0;
-    mp->mp_refcount_primary = add_primary;
-    mp->mp_refcount_secondary = add_secondary;
-    return mp;
-}
-static void
-macrocheck_map_free_func(void *mx)
-{
-    struct Macrocheck_Map_Entry_s *m = mx;
-    free(m);
-}
-
-static int
-macrocheck_map_compare_func(const void *l, const void *r)
-{
-    const struct Macrocheck_Map_Entry_s *ml = l;
-    const struct Macrocheck_Map_Entry_s *mr = r;
-    if (ml->mp_key < mr->mp_key) {
-        return -1;
-    }
-    if (ml->mp_key > mr->mp_key) {
-        return 1;
-    }
-    return 0;
-}
-
 static struct Macrocheck_Map_Entry_s *
 macrocheck_map_insert(Dwarf_Unsigned offset,
     unsigned add_prim,unsigned add_sec,
     Dwarf_Unsigned line_num,
     unsigned src_file_num,
-    void **tree1)
-{
-    void *retval = 0;
-    struct Macrocheck_Map_Entry_s *re = 0;
-    struct Macrocheck_Map_Entry_s *e;
-
-    e  = macrocheck_map_create_entry(offset,add_prim,add_sec);
-    /*  tsearch records e's contents unless e
-        is already present . We must not free it till
-        destroy time if it got added to tree1.  */
-    retval = dwarf_tsearch(e,tree1, macrocheck_map_compare_func);
-    if (retval) {
-        re = *(struct Macrocheck_Map_Entry_s **)retval;
-        if (re != e) {
-            /*  We returned an existing record, e not needed.
-                Increment refcounts. Lets update line, filenum
-                to latest. So later reports show latest...?  */
-            re->mp_import_linenum = line_num;
-            re->mp_import_from_filenum = src_file_num;
-            re->mp_refcount_primary += add_prim;
-            re->mp_refcount_secondary += add_sec;
-            macrocheck_map_free_func(e);
-        } else {
-            /* New record */
-            e->mp_import_linenum = line_num;
-            e->mp_import_from_filenum = src_file_num;
-            /* Record e got added to tree1, do not free record e. */
-        }
-    }
-    return NULL;
-}
-
-struct Macrocheck_Map_Entry_s *
-macrocheck_map_find(Dwarf_Unsigned offset,void **tree1)
+    void **map)
 {
-    void *retval = 0;
     struct Macrocheck_Map_Entry_s *re = 0;
-    struct Macrocheck_Map_Entry_s *e = 0;
 
-    e = macrocheck_map_create_entry(offset,0,0);
-    retval = dwarf_tfind(e,tree1, macrocheck_map_compare_func);
-    if (retval) {
-        re = *(struct Macrocheck_Map_Entry_s **)retval;
-    }
-    /*  The one we created here must be deleted, it is dead.
-        We look at the returned one instead. */
-    macrocheck_map_free_func(e);
+    re = (struct Macrocheck_Map_Entry_s *)offsetmap_insert(offset,
+        sizeof(struct Macrocheck_Map_Entry_s),map,0);
+    if (!re) {
+        return NULL;
+    }
+    /*  New or existing record. Increment refcounts.
+        Lets update line, filenum
+        to latest. So later reports show latest...?  */
+    re->mp_import_linenum = line_num;
+    re->mp_import_from_filenum = src_file_num;
+    re->mp_refcount_primary += add_prim;
+    re->mp_refcount_secondary += add_sec;
     return re;
 }
 
-static void
-macrocheck_map_destroy(void *map)
+struct Macrocheck_Map_Entry_s *
+macrocheck_map_find(Dwarf_Unsigned offset,void **map)
 {
-    /* tdestroy is not part of Posix. */
-    dwarf_tdestroy(map,macrocheck_map_free_func);
+    return (struct Macrocheck_Map_Entry_s *)offsetmap_find(offset,
+        *map);
 }
 
 void
@@ -234,38 +163,20 @@ add_macro_area_len(void **base, Dwarf_Unsigned offset,
     }
 }
 
-static Dwarf_Unsigned reccount = 0;
-
-static void
-macro_walk_count_recs(const void *nodep UNUSEDARG,
-    const DW_VISIT which,
-    const int depth UNUSEDARG)
-{
-    if (which == dwarf_postorder || which == dwarf_endorder) {
-        return;
-    }
-    reccount += 1;
-}
 static Dwarf_Unsigned
 macro_count_recs(void **base)
 {
-    reccount = 0;
-    dwarf_twalk(*base,macro_walk_count_recs);
-    return reccount;
+    return offsetmap_count(*base);
 }
 
 static Dwarf_Unsigned lowestoff = 0xffffff;
 static Dwarf_Bool lowestfound = FALSE;
 static void
-macro_walk_find_lowest(const void *nodep,const DW_VISIT  which,
-    const int  depth UNUSEDARG)
+macro_walk_find_lowest(void *rec,void *data UNUSEDARG)
 {
     struct Macrocheck_Map_Entry_s * re =
-        *(struct Macrocheck_Map_Entry_s**)nodep;
+        (struct Macrocheck_Map_Entry_s*)rec;
 
-    if (which == dwarf_postorder || which == dwarf_endorder) {
-        return;
-    }
     if (!re->mp_printed) {
         if (!lowestfound) {
             lowestoff = re->mp_key;
@@ -283,9 +194,9 @@ get_next_unprinted_macro_offset(void **tree, Dwarf_Unsigned * off)
     lowestfound = FALSE;
     lowestoff = 0xffffffff;
 
-    /*  This walks the tree to find one entry.
-        Which could get slow if the tree has lots of entries. */
-    dwarf_twalk(*tree,macro_walk_find_lowest);
+    /*  This walks the map to find one entry.
+        Which could get slow if the map has lots of entries. */
+    offsetmap_walk(*tree,macro_walk_find_lowest,0);
     if (!lowestfound) {
         return DW_DLV_NO_ENTRY;
     }
@@ -307,15 +218,11 @@ mark_macro_offset_printed(void **base, Dwarf_Unsigned offset)
 static struct Macrocheck_Map_Entry_s **mac_as_array = 0;
 static unsigned mac_as_array_next = 0;
 static void
-macro_walk_to_array(const void *nodep,const DW_VISIT  which,
-    const int  depth UNUSEDARG)
+macro_walk_to_array(void *rec,void *data UNUSEDARG)
 {
     struct Macrocheck_Map_Entry_s * re =
-        *(struct Macrocheck_Map_Entry_s**)nodep;
+        (struct Macrocheck_Map_Entry_s*)rec;
 
-    if (which == dwarf_postorder || which == dwarf_endorder) {
-        return;
-    }
     mac_as_array[mac_as_array_next] = re;
     mac_as_array_next++;
 }
@@ -407,7 +314,7 @@ print_macrocheck_statistics(const char *name,void **tsbase,
         /*  Return OK so dwarfdump.c won't look for Dwarf_Error */
         return DW_DLV_OK;
     }
-    dwarf_twalk(*tsbase,macro_walk_to_array);
+    offsetmap_walk(*tsbase,macro_walk_to_array,0);
     printf("  Macro unit count %s: %" DW_PR_DUu "\n",name,count);
     qsort(mac_as_array,
         count,sizeof(struct Macrocheck_Map_Entry_s *),
@@ -545,7 +452,7 @@ clear_macrocheck_statistics(void **tsbase)
     if (!*tsbase) {
         return;
     }
-    macrocheck_map_destroy(*tsbase);
+    offsetmap_destroy(*tsbase,0);
     *tsbase = 0;
 }
 
@@ -622,3 +529,133 @@ macro_import_stack_cleanout(void)
 {
     macro_import_stack_next_to_use = 0;
 }
+
+#ifndef TESTING
+/*  --threads=<n>: a worker starts with empty macro check
+    trees and writes the entries it made for this process
+    to add to its own trees. */
+static FILE *worker_report_file;
+static int   worker_report_res;
+
+static void
+macro_walk_write(void *rec,void *data UNUSEDARG)
+{
+    struct Macrocheck_Map_Entry_s * re =
+        (struct Macrocheck_Map_Entry_s*)rec;
+
+    if (worker_report_res != DW_DLV_OK) {
+        return;
+    }
+    worker_report_res = dd_report_write(worker_report_file,
+        re,sizeof(*re));
+}
+
+static int
+write_macrocheck_tree(FILE *f, void **base)
+{
+    Dwarf_Unsigned count = macro_count_recs(base);
+    int res = 0;
+
+    res = dd_report_write(f,&count,sizeof(count));
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    worker_report_file = f;
+    worker_report_res = DW_DLV_OK;
+    offsetmap_walk(*base,macro_walk_write,0);
+    worker_report_file = 0;
+    return worker_report_res;
+}
+
+static int
+merge_macrocheck_tree(FILE *f, void **base)
+{
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned i = 0;
+    int res = 0;
+
+    res = dd_report_read(f,&count,sizeof(count));
+    for ( ; res == DW_DLV_OK && i < count; ++i) {
+        struct Macrocheck_Map_Entry_s w;
+        struct Macrocheck_Map_Entry_s *re = 0;
+
+        res = dd_report_read(f,&w,sizeof(w));
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        re = macrocheck_map_insert(w.mp_key,0,0,
+            w.mp_import_linenum,w.mp_import_from_filenum,base);
+        if (!re) {
+            res = DW_DLV_ERROR;
+            break;
+        }
+        re->mp_refcount_primary += w.mp_refcount_primary;
+        re->mp_refcount_secondary += w.mp_refcount_secondary;
+        if (w.mp_len) {
+            re->mp_len = w.mp_len;
+        }
+        if (w.mp_printed) {
+            re->mp_printed = TRUE;
+        }
+    }
+    return res;
+}
+
+void
+macrocheck_worker_begin(void)
+{
+    /*  The entries belong to this process's trees,
+        which the worker leaves as they are. */
+    macro_check_tree = 0;
+    macinfo_check_tree = 0;
+}
+
+int
+macrocheck_worker_write(FILE *f)
+{
+    int res = write_macrocheck_tree(f,&macro_check_tree);
+
+    if (res == DW_DLV_OK) {
+        res = write_macrocheck_tree(f,&macinfo_check_tree);
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&macfile_stack_max_seen,
+            sizeof(macfile_stack_max_seen));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&macro_import_stack_max_seen,
+            sizeof(macro_import_stack_max_seen));
+    }
+    return res;
+}
+
+/*  The nest depths are maxima over all CUs, so the
+    deepest any worker saw is the one reported. */
+int
+macrocheck_worker_merge(FILE *f)
+{
+    unsigned filemax = 0;
+    unsigned importmax = 0;
+    int res = merge_macrocheck_tree(f,&macro_check_tree);
+
+    if (res == DW_DLV_OK) {
+        res = merge_macrocheck_tree(f,&macinfo_check_tree);
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&filemax,sizeof(filemax));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&importmax,sizeof(importmax));
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    if (filemax > macfile_stack_max_seen) {
+        macfile_stack_max_seen = filemax;
+    }
+    if (importmax > macro_import_stack_max_seen) {
+        macro_import_stack_max_seen = importmax;
+    }
+    return res;
+}
+#endif /* TESTING */
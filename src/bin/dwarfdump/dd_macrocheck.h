@@ -27,13 +27,18 @@ Copyright 2015-2016 David Anderson. All rights reserved.
 #ifndef MACROCHECK_H
 #define MACROCHECK_H
 
-/* tsearch trees used in macro checking. */
+#include <stdio.h> /* FILE */
+
+/*  Maps used in macro checking. The first two
+    are offset maps (see dd_offsetmap.h)
+    of Macrocheck_Map_Entry_s, macdefundeftree
+    is a tsearch tree of macdef_entry. */
 extern void * macro_check_tree; /* DWARF5 macros. */
 extern void * macinfo_check_tree; /* DWARF2,3,4 macros */
 extern void * macdefundeftree; /* DWARF5 style macros */
 
 struct Macrocheck_Map_Entry_s {
-    Dwarf_Unsigned mp_key; /* Key is offset */
+    Dwarf_Unsigned mp_key; /* Key is offset. Must be first. */
     Dwarf_Unsigned mp_len; /* len in bytes off this macro set */
 
     /*  We count number of uses. More than 1 primary is an error.
@@ -120,6 +125,13 @@ int print_macrocheck_statistics(const char *name,void **basep,
     Dwarf_Unsigned section_size,Dwarf_Error *err);
 void clear_macrocheck_statistics(void **basep);
 
+/*  --threads=<n>: a worker starts with empty trees,
+    writes what it added and this process adds that
+    to its trees. */
+void macrocheck_worker_begin(void);
+int  macrocheck_worker_write(FILE *f);
+int  macrocheck_worker_merge(FILE *f);
+
 macfile_entry * macfile_from_array_index( unsigned index);
 
 #endif /* MACROCHECK_H */
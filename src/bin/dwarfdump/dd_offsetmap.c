@@ -0,0 +1,291 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  See dd_offsetmap.h.
+    The slots hold the key beside the record pointer
+    so probing and growing the table never touch
+    the records. The table is kept at most half
+    full and grows by doubling, so probe sequences
+    stay short. */
+
+#include <config.h>
+
+#include <stdlib.h> /* calloc() free() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "dd_offsetmap.h"
+#include "libdwarf_private.h" /* For malloc/calloc debug */
+
+#define TRUE 1
+#define FALSE 0
+
+#define OFFSETMAP_INITIAL_SLOTS   64
+#define OFFSETMAP_INITIAL_RECS    64
+#define OFFSETMAP_MAX_CHUNK_RECS  8192
+
+struct offsetmap_slot_s {
+    Dwarf_Unsigned os_key;
+    void          *os_rec; /* Zero means the slot is empty */
+};
+
+/*  Records are allocated from these, oc_count
+    records following the header. */
+struct offsetmap_chunk_s {
+    struct offsetmap_chunk_s *oc_next;
+    Dwarf_Unsigned            oc_used;
+    Dwarf_Unsigned            oc_count;
+};
+/*  Keeps the records aligned for any member they have. */
+#define OFFSETMAP_CHUNK_HDR \
+    (((sizeof(struct offsetmap_chunk_s) + 15)/16)*16)
+
+struct offsetmap_s {
+    unsigned                  om_recsize;
+    Dwarf_Unsigned            om_count;
+    /*  Always a power of two. */
+    Dwarf_Unsigned            om_slotcount;
+    struct offsetmap_slot_s  *om_slots;
+    struct offsetmap_chunk_s *om_first_chunk;
+    struct offsetmap_chunk_s *om_last_chunk;
+};
+
+static Dwarf_Unsigned
+offsetmap_hash(Dwarf_Unsigned key)
+{
+    /*  Offsets and addresses are often multiples of
+        a power of two, so mix the high bits down. */
+    Dwarf_Unsigned h = key * 0x9e3779b97f4a7c15ULL;
+
+    return h ^ (h >> 29);
+}
+
+static struct offsetmap_slot_s *
+offsetmap_probe(struct offsetmap_slot_s *slots,
+    Dwarf_Unsigned slotcount,
+    Dwarf_Unsigned key)
+{
+    Dwarf_Unsigned mask = slotcount -1;
+    Dwarf_Unsigned i = offsetmap_hash(key) & mask;
+
+    /*  Never more than half full, so this ends. */
+    for (;;) {
+        struct offsetmap_slot_s *s = slots + i;
+
+        if (!s->os_rec || s->os_key == key) {
+            return s;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+static int
+offsetmap_grow(struct offsetmap_s *m)
+{
+    Dwarf_Unsigned newcount = m->om_slotcount?
+        m->om_slotcount*2:OFFSETMAP_INITIAL_SLOTS;
+    struct offsetmap_slot_s *newslots = 0;
+    Dwarf_Unsigned i = 0;
+
+    newslots = (struct offsetmap_slot_s *)calloc(newcount,
+        sizeof(struct offsetmap_slot_s));
+    if (!newslots) {
+        return DW_DLV_ERROR;
+    }
+    for (i = 0; i < m->om_slotcount; ++i) {
+        struct offsetmap_slot_s *s = m->om_slots + i;
+
+        if (s->os_rec) {
+            *offsetmap_probe(newslots,newcount,s->os_key) = *s;
+        }
+    }
+    free(m->om_slots);
+    m->om_slots = newslots;
+    m->om_slotcount = newcount;
+    return DW_DLV_OK;
+}
+
+static void *
+offsetmap_new_record(struct offsetmap_s *m)
+{
+    struct offsetmap_chunk_s *c = m->om_last_chunk;
+    char *rec = 0;
+
+    if (!c || c->oc_used >= c->oc_count) {
+        Dwarf_Unsigned count = c?
+            c->oc_count*2:OFFSETMAP_INITIAL_RECS;
+
+        if (count > OFFSETMAP_MAX_CHUNK_RECS) {
+            count = OFFSETMAP_MAX_CHUNK_RECS;
+        }
+        c = (struct offsetmap_chunk_s *)calloc(1,
+            OFFSETMAP_CHUNK_HDR + count*m->om_recsize);
+        if (!c) {
+            return NULL;
+        }
+        c->oc_count = count;
+        if (m->om_last_chunk) {
+            m->om_last_chunk->oc_next = c;
+        } else {
+            m->om_first_chunk = c;
+        }
+        m->om_last_chunk = c;
+    }
+    rec = (char *)c + OFFSETMAP_CHUNK_HDR +
+        c->oc_used*m->om_recsize;
+    c->oc_used++;
+    return rec;
+}
+
+void *
+offsetmap_insert(Dwarf_Unsigned key,
+    unsigned recsize, void **map, Dwarf_Bool *is_new)
+{
+    struct offsetmap_s *m = (struct offsetmap_s *)*map;
+    struct offsetmap_slot_s *s = 0;
+    void *rec = 0;
+
+    if (is_new) {
+        *is_new = FALSE;
+    }
+    if (!m) {
+        if (recsize < sizeof(Dwarf_Unsigned)) {
+            return NULL;
+        }
+        m = (struct offsetmap_s *)calloc(1,
+            sizeof(struct offsetmap_s));
+        if (!m) {
+            return NULL;
+        }
+        m->om_recsize = recsize;
+        *map = m;
+    }
+    if (m->om_slotcount) {
+        s = offsetmap_probe(m->om_slots,m->om_slotcount,key);
+        if (s->os_rec) {
+            return s->os_rec;
+        }
+    }
+    if ((m->om_count+1)*2 > m->om_slotcount) {
+        if (offsetmap_grow(m) != DW_DLV_OK) {
+            return NULL;
+        }
+        s = offsetmap_probe(m->om_slots,m->om_slotcount,key);
+    }
+    rec = offsetmap_new_record(m);
+    if (!rec) {
+        return NULL;
+    }
+    *(Dwarf_Unsigned *)rec = key;
+    s->os_key = key;
+    s->os_rec = rec;
+    m->om_count++;
+    if (is_new) {
+        *is_new = TRUE;
+    }
+    return rec;
+}
+
+void *
+offsetmap_find(Dwarf_Unsigned key, void *map)
+{
+    struct offsetmap_s *m = (struct offsetmap_s *)map;
+
+    if (!m || !m->om_count) {
+        return NULL;
+    }
+    return offsetmap_probe(m->om_slots,m->om_slotcount,
+        key)->os_rec;
+}
+
+Dwarf_Unsigned
+offsetmap_count(void *map)
+{
+    struct offsetmap_s *m = (struct offsetmap_s *)map;
+
+    if (!m) {
+        return 0;
+    }
+    return m->om_count;
+}
+
+void
+offsetmap_walk(void *map,
+    void (*func)(void *rec, void *data), void *data)
+{
+    struct offsetmap_s *m = (struct offsetmap_s *)map;
+    struct offsetmap_chunk_s *c = 0;
+
+    if (!m) {
+        return;
+    }
+    for (c = m->om_first_chunk; c; c = c->oc_next) {
+        Dwarf_Unsigned i = 0;
+        char *rec = (char *)c + OFFSETMAP_CHUNK_HDR;
+
+        for ( ; i < c->oc_used; ++i, rec += m->om_recsize) {
+            func(rec,data);
+        }
+    }
+}
+
+static void
+offsetmap_free_rec(void *rec, void *data)
+{
+    void (*freefunc)(void *) = *(void (**)(void *))data;
+
+    freefunc(rec);
+}
+
+void
+offsetmap_destroy(void *map,
+    void (*freefunc)(void *rec))
+{
+    struct offsetmap_s *m = (struct offsetmap_s *)map;
+    struct offsetmap_chunk_s *c = 0;
+
+    if (!m) {
+        return;
+    }
+    if (freefunc) {
+        offsetmap_walk(m,offsetmap_free_rec,&freefunc);
+    }
+    c = m->om_first_chunk;
+    while (c) {
+        struct offsetmap_chunk_s *next = c->oc_next;
+
+        free(c);
+        c = next;
+    }
+    free(m->om_slots);
+    free(m);
+}
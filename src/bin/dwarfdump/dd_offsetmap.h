@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef DD_OFFSETMAP_H
+#define DD_OFFSETMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*  A map from a Dwarf_Unsigned key (a section offset
+    or an address) to a fixed-size record, for the
+    maps dwarfdump consults for every DIE or macro
+    operation. It is an open-addressing hash table
+    whose records are carved from large chunks, so
+    adding an entry is not a malloc and finding one
+    is not a walk down a tree.
+
+    Each record must begin with its Dwarf_Unsigned key.
+    Records are zeroed when created and do not move,
+    so a returned pointer stays good until the
+    map is destroyed.
+
+    The map itself is passed as a void*
+    (a void** where it may be created), just as the
+    tsearch trees it replaces were, and a map pointer
+    of zero is an empty map.  */
+
+/*  Returns the record for key, creating it
+    (with the map itself if *map is zero)
+    when not present. *is_new (if is_new non-null)
+    is set TRUE when the record was created.
+    Returns NULL only if out of memory. */
+void * offsetmap_insert(Dwarf_Unsigned key,
+    unsigned recsize, void **map, Dwarf_Bool *is_new);
+
+/*  Returns the record for key or NULL. */
+void * offsetmap_find(Dwarf_Unsigned key, void *map);
+
+/*  The number of records in the map. */
+Dwarf_Unsigned offsetmap_count(void *map);
+
+/*  Calls func for every record, in the order the
+    records were created. */
+void offsetmap_walk(void *map,
+    void (*func)(void *rec, void *data), void *data);
+
+/*  Frees the map and all its records. If freefunc
+    is non-null it is called first for each record
+    so the record can free what it points to. */
+void offsetmap_destroy(void *map,
+    void (*freefunc)(void *rec));
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* DD_OFFSETMAP_H */
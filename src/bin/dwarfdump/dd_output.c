@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <config.h>
+
+#include <stdio.h>  /* fputs() fwrite() putchar() setvbuf() */
+
+#ifdef _WIN32
+#include <io.h> /* _isatty() _fileno() */
+#elif defined HAVE_UNISTD_H
+#include <unistd.h> /* isatty() */
+#endif /* _WIN32 */
+
+#include "dd_esb.h"
+#include "dd_output.h"
+
+/*  Large enough that a dump of a big object is written
+    in few system calls, small enough not to matter
+    in the process size. */
+#define DD_OUTPUT_BUFSIZE (1024*1024)
+
+/*  Static, not malloc()ed, as stdio may use it
+    right up to the final flush in exit(). */
+static char dd_output_buffer[DD_OUTPUT_BUFSIZE];
+
+static int
+stdout_is_terminal(void)
+{
+#ifdef _WIN32
+    return _isatty(_fileno(stdout));
+#elif defined HAVE_UNISTD_H
+    return isatty(fileno(stdout));
+#else
+    return 0;
+#endif /* _WIN32 */
+}
+
+void
+dd_output_setup(void)
+{
+    if (stdout_is_terminal()) {
+        /*  Leave it line buffered so a person
+            watching sees each line as it is done. */
+        return;
+    }
+    setvbuf(stdout,dd_output_buffer,_IOFBF,
+        sizeof(dd_output_buffer));
+}
+
+void
+dd_output_string(const char *s)
+{
+    fputs(s,stdout);
+}
+
+void
+dd_output_char(int c)
+{
+    putchar(c);
+}
+
+/*  Same as printf("%*s",count," ") for count > 0. */
+void
+dd_output_spaces(int count)
+{
+    static const char spaces[] =
+        "                                "
+        "                                ";
+    const int chunk = (int)sizeof(spaces) -1;
+
+    while (count > chunk) {
+        fwrite(spaces,1,chunk,stdout);
+        count -= chunk;
+    }
+    if (count > 0) {
+        fwrite(spaces,1,(size_t)count,stdout);
+    }
+}
+
+void
+dd_output_esb(struct esb_s *data)
+{
+    size_t len = esb_string_len(data);
+
+    if (len) {
+        fwrite(esb_get_string(data),1,len,stdout);
+    }
+}
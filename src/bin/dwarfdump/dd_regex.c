@@ -127,6 +127,7 @@
 #include <config.h>
 
 #include <stdio.h> /* printf() */
+#include <string.h> /* memset() strstr() */
 
 #include "dd_regex.h"
 #include "dd_safe_strcpy.h"
@@ -139,6 +140,17 @@
     Except when using ^ or $ in the regex
     we find any matching substring.
     David Anderson.  2 September 2021.
+
+    dd_re_exec() is called on every attribute
+    string of every DIE, so dd_re_comp() also turns the
+    nfa into tables for a bit-parallel (shift-and)
+    matcher, which looks at each input character once
+    whatever the pattern, and notes the longest literal
+    a match must contain so strstr() can reject most
+    strings before any matching is done.
+    It finds the same matches as dd_pmatch(), which
+    is still used for patterns of more than
+    BP_MAXPOS elements.
 */
 
 #ifndef DW_DLV_OK
@@ -187,6 +199,21 @@ static CHAR nfa[MAXNFA];     /* automaton..       */
 static int  sta = NOP;       /* status of lastpat */
 
 static CHAR bittab[BITBLK];  /* bit table for CCL */
+
+/*  The bit-parallel form of nfa. Element i of the
+    pattern (a CHR, ANY or CCL, perhaps with a closure)
+    is bit i. */
+typedef unsigned long long re_bits;
+#define BP_MAXPOS 63
+static int     bp_usable;
+static int     bp_bol;
+static int     bp_eol;
+static re_bits bp_accept[256]; /* Elements each char matches */
+static re_bits bp_closures;    /* Elements in a closure */
+static re_bits bp_endskip;     /* A final closure */
+static re_bits bp_final;       /* Past the last element */
+static char    bp_literal[BP_MAXPOS+1];
+static int     bp_literal_only;
 /* pre-set bits...   */
 static CHAR bitarr[] = {1,2,4,8,16,32,64,128};
 
@@ -201,6 +228,8 @@ chset(CHAR c)
     bittab[(CHAR) ((c) & BLKIND) >> 3] |= bitarr[(c) & BITIND];
 }
 
+#define isinset(x,y)     ((x)[((y)&BLKIND)>>3] & bitarr[(y)&BITIND])
+
 #define badpat    (*nfa = END)
 #define store(x)  *mp++ = (x)
 
@@ -215,6 +244,128 @@ resetbittab(void)
         nfa[j] = 0;
     }
     sta = NOP;
+    bp_usable = 0;
+}
+
+/*  Builds the bp_ tables from nfa, leaving bp_usable
+    0 if the pattern has too many elements.
+    The one difference from plain shift-and is
+    the closure rule dd_pmatch() has (see 'code by
+    davea' there): a closure matching nothing
+    only lets the match go on when the next character
+    is one the closure could have taken, or at the
+    end of the string when the closure ends
+    the pattern. */
+static void
+bp_compile(void)
+{
+    CHAR *ap = nfa;
+    int n = 0;
+    int b = 0;
+    int lit = 0;      /* length of the literal run at n */
+    int litstart = 0;
+    int best = 0;     /* longest literal run so far */
+    int bestat = 0;
+    int only = 1;
+    re_bits bit = 0;
+
+    bp_usable = 0;
+    bp_bol = 0;
+    bp_eol = 0;
+    bp_closures = 0;
+    bp_endskip = 0;
+    memset(bp_accept,0,sizeof(bp_accept));
+    if (*ap == BOL) {
+        bp_bol = 1;
+        ap++;
+    }
+    while (*ap != END) {
+        int op = *ap++;
+        int closure = 0;
+
+        if (op == EOL) {
+            bp_eol = 1;
+            break;
+        }
+        if (op == CLO) {
+            closure = 1;
+            op = *ap++;
+        }
+        if (n >= BP_MAXPOS) {
+            return;
+        }
+        bit = (re_bits)1 << n;
+        switch(op) {
+        case CHR:
+            bp_accept[*ap] |= bit;
+            if (closure) {
+                lit = 0;
+            } else {
+                if (!lit) {
+                    litstart = n;
+                }
+                ++lit;
+                if (lit > best) {
+                    best = lit;
+                    bestat = litstart;
+                }
+            }
+            ap++;
+            break;
+        case ANY:
+            for (b = 1; b < 256; ++b) {
+                bp_accept[b] |= bit;
+            }
+            lit = 0;
+            break;
+        case CCL:
+            for (b = 1; b < 256; ++b) {
+                if (isinset(ap,b)) {
+                    bp_accept[b] |= bit;
+                }
+            }
+            ap += BITBLK;
+            lit = 0;
+            break;
+        default:
+            return;
+        }
+        if (closure) {
+            bp_closures |= bit;
+            only = 0;
+            ap++; /* the END closing the closure */
+        } else if (op != CHR) {
+            only = 0;
+        }
+        ++n;
+    }
+    if (n && (bp_closures & bit) && !bp_eol) {
+        bp_endskip = bit;
+    }
+    bp_final = (re_bits)1 << n;
+    /*  Recover the literal from the nfa: each of
+        its elements is CHR c. */
+    {
+        int i = 0;
+
+        ap = nfa + (bp_bol? 1:0);
+        for (i = 0; i < bestat+best; ++i) {
+            CHAR *elem = (*ap == CLO)? ap+1 : ap;
+
+            if (i >= bestat) {
+                bp_literal[i-bestat] = (char)elem[1];
+            }
+            switch(*elem) {
+            case CHR: elem += 2; break;
+            case ANY: elem += 1; break;
+            default:  elem += 1 + BITBLK; break;
+            }
+            ap = (*ap == CLO)? elem+1 : elem;
+        }
+        bp_literal[best] = 0;
+    }
+    bp_literal_only = only && !bp_bol && !bp_eol && best == n;
+    bp_usable = 1;
 }
 
 int
@@ -344,7 +495,10 @@ dd_re_comp(const char *pat)
             break;
 
         case '\\':              /* tags, backrefs .. */
-            ++p;
+            if (*(p+1)) {
+                /*  A trailing \ matches itself. */
+                ++p;
+            }
             store(CHR);
             store(*p);
             break;
@@ -357,6 +511,7 @@ dd_re_comp(const char *pat)
     }
     store(END);
     sta = OKP;
+    bp_compile();
 #ifdef DEBUG
     symbolic("Final nfa");
 #endif /* DEBUG */
@@ -385,6 +540,69 @@ static int dd_pmatch(const char *, CHAR *,char **str_out,
     return DW_DLV_OK, DW_DLV_NO_ENTRY or DW_DLV_ERROR
 */
 
+/*  f has bit i when the match so far can go on with
+    element i (bit n, bp_final, is a match), l when
+    it is within closure i having taken at least one
+    character. */
+static int
+bp_exec(const char *s)
+{
+    const CHAR *t = (const CHAR *)s;
+    re_bits f = 0;
+    re_bits l = 0;
+    re_bits a = 0;
+    unsigned q = 0;
+
+    if (bp_literal[0]) {
+        const char *found = strstr(s,bp_literal);
+
+        if (!found) {
+            return DW_DLV_NO_ENTRY;
+        }
+        if (bp_literal_only) {
+            return DW_DLV_OK;
+        }
+    }
+    for (q = 0; ; ++q) {
+        CHAR c = t[q];
+
+        /*  dd_re_exec() tries matches starting
+            at each character, or at the NUL of an
+            empty string. */
+        if (!q || (c && !bp_bol)) {
+            f |= 1;
+        }
+        f |= l << 1;
+        if (c) {
+            re_bits skip = f & bp_closures & bp_accept[c];
+
+            while (skip) {
+                re_bits nf = f | (skip << 1);
+
+                if (nf == f) {
+                    break;
+                }
+                f = nf;
+                skip = f & bp_closures & bp_accept[c];
+            }
+        } else {
+            f |= (f & bp_endskip) << 1;
+        }
+        if ((f & bp_final) && (c == 0 || !bp_eol)) {
+            return DW_DLV_OK;
+        }
+        if (!c) {
+            return DW_DLV_NO_ENTRY;
+        }
+        a = bp_accept[c];
+        l = (f | l) & bp_closures & a;
+        f = (f & ~bp_closures & a) << 1;
+        if (!f && !l && bp_bol) {
+            return DW_DLV_NO_ENTRY;
+        }
+    }
+}
+
 int
 dd_re_exec(char *lp)
 {
@@ -395,7 +613,9 @@ dd_re_exec(char *lp)
     int level = 0;
 
     bol = lp;
-
+    if (bp_usable && sta == OKP) {
+        return bp_exec(lp);
+    }
     switch(*ap) {
     case BOL:            /* anchored: match from BOL only */
         res = dd_pmatch(lp,ap,&ep,level);
@@ -536,7 +756,6 @@ naming(CHAR c)
 #define iswordc(x)     chrtyp[inascii(x)]
 #define inascii(x)    (0177&(x))
 #endif
-#define isinset(x,y)     ((x)[((y)&BLKIND)>>3] & bitarr[(y)&BITIND])
 
 /* skip values for CLO XXX to skip past the closure */
 
@@ -568,8 +787,10 @@ dd_pmatch(const char *lp, CHAR *ap,char **end_ptr,
             }
             break;
         case CCL:
+            /*  A negated class has the NUL bit set,
+                but must not match the end of the string. */
             c = *lp++;
-            if (!isinset(ap,c)) {
+            if (!c || !isinset(ap,c)) {
                 return DW_DLV_NO_ENTRY;
             }
 
@@ -0,0 +1,447 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  --search-index support.
+    A -S search formats every attribute of every DIE
+    to compare it with the text. When the object has
+    name tables the names are compared instead and only
+    the CUs with a matching name are read, printing just
+    the DIEs the tables point to.
+    Unlike the full walk this finds only what the tables
+    list (typically named global and static entities),
+    not attribute names, local names or other values,
+    hence it is only done when asked for. */
+
+#include <config.h>
+
+#include <stdlib.h> /* calloc() free() */
+#include <string.h> /* strcmp() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h"
+#include "dd_globals.h"
+#include "dd_helpertree.h"
+#include "dd_search_index.h"
+
+/*  The value kept for each CU DIE offset in
+    search_index_cus. A CU not there is not covered
+    by the tables and is searched the usual way. */
+#define SEARCH_INDEX_CU_COVERED 1 /* No name matches */
+#define SEARCH_INDEX_CU_DIES    2 /* Print the DIEs listed */
+#define SEARCH_INDEX_CU_WHOLE   3 /* Search all of the CU */
+
+static Dwarf_Bool search_index_active;
+static Dwarf_Bool search_index_failed;
+static int search_index_current_cu;
+static struct Helpertree_Base_s search_index_cus;
+static struct Helpertree_Base_s search_index_dies;
+
+static Dwarf_Bool
+search_index_name_matches(const char *name)
+{
+    if (!name || !name[0]) {
+        return FALSE;
+    }
+    if (glflags.search_match_text &&
+        !strcmp(name,glflags.search_match_text)) {
+        return TRUE;
+    }
+    if (glflags.search_any_text &&
+        is_strstrnocase(name,glflags.search_any_text)) {
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*  Records the CU (raising its value to cuval)
+    and, with SEARCH_INDEX_CU_DIES, the DIE. */
+static void
+search_index_add(Dwarf_Off cu_die_offset, Dwarf_Off die_offset,
+    int cuval)
+{
+    struct Helpertree_Map_Entry_s *e = 0;
+
+    e = helpertree_find(cu_die_offset,&search_index_cus);
+    if (!e || e->hm_val < cuval) {
+        if (!helpertree_add_entry(cu_die_offset,cuval,
+            &search_index_cus)) {
+            search_index_failed = TRUE;
+        }
+    }
+    if (cuval == SEARCH_INDEX_CU_DIES && die_offset) {
+        if (!helpertree_add_entry(die_offset,0,
+            &search_index_dies)) {
+            search_index_failed = TRUE;
+        }
+    }
+}
+
+/*  A name with die_offset 0 is the entry libdwarf
+    makes for a CU with no names at all. */
+static void
+search_index_add_name(const char *name, Dwarf_Off die_offset,
+    Dwarf_Off cu_die_offset)
+{
+    if (die_offset && search_index_name_matches(name)) {
+        search_index_add(cu_die_offset,die_offset,
+            SEARCH_INDEX_CU_DIES);
+    } else {
+        search_index_add(cu_die_offset,0,
+            SEARCH_INDEX_CU_COVERED);
+    }
+}
+
+/*  .debug_names or .debug_pubnames, and .debug_pubtypes. */
+static int
+search_index_globals(Dwarf_Debug dbg, Dwarf_Bool *found,
+    Dwarf_Error *err)
+{
+    Dwarf_Global *globals = 0;
+    Dwarf_Signed  count = 0;
+    Dwarf_Type   *types = 0;
+    Dwarf_Signed  tcount = 0;
+    Dwarf_Signed  i = 0;
+    int res = 0;
+
+    /*  So a CU with no names is known to be covered. */
+    dwarf_return_empty_pubnames(dbg,1);
+    res = dwarf_get_globals(dbg,&globals,&count,err);
+    dwarf_return_empty_pubnames(dbg,0);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
+    if (res == DW_DLV_OK) {
+        for (i = 0; i < count; ++i) {
+            char *name = 0;
+            Dwarf_Off die_offset = 0;
+            Dwarf_Off cu_die_offset = 0;
+
+            res = dwarf_global_name_offsets(globals[i],&name,
+                &die_offset,&cu_die_offset,err);
+            if (res != DW_DLV_OK) {
+                dwarf_globals_dealloc(dbg,globals,count);
+                return DW_DLV_ERROR;
+            }
+            search_index_add_name(name,die_offset,cu_die_offset);
+        }
+        dwarf_globals_dealloc(dbg,globals,count);
+        if (count) {
+            *found = TRUE;
+        }
+    }
+    res = dwarf_get_pubtypes(dbg,&types,&tcount,err);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
+    if (res == DW_DLV_OK) {
+        for (i = 0; i < tcount; ++i) {
+            char *name = 0;
+            Dwarf_Off die_offset = 0;
+            Dwarf_Off cu_die_offset = 0;
+
+            res = dwarf_pubtype_name_offsets(types[i],&name,
+                &die_offset,&cu_die_offset,err);
+            if (res != DW_DLV_OK) {
+                dwarf_pubtypes_dealloc(dbg,types,tcount);
+                return DW_DLV_ERROR;
+            }
+            search_index_add_name(name,die_offset,cu_die_offset);
+        }
+        dwarf_pubtypes_dealloc(dbg,types,tcount);
+        if (tcount) {
+            *found = TRUE;
+        }
+    }
+    return DW_DLV_OK;
+}
+
+/*  .debug_gnu_pubnames or .debug_gnu_pubtypes.
+    Entry offsets are from the CU header, as
+    in .debug_pubnames. */
+static int
+search_index_gnu(Dwarf_Debug dbg, Dwarf_Bool for_pubnames,
+    Dwarf_Bool *found, Dwarf_Error *err)
+{
+    Dwarf_Gnu_Index_Head head = 0;
+    Dwarf_Unsigned block_count = 0;
+    Dwarf_Unsigned b = 0;
+    int res = 0;
+
+    res = dwarf_get_gnu_index_head(dbg,for_pubnames,
+        &head,&block_count,err);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    for (b = 0; b < block_count; ++b) {
+        Dwarf_Unsigned block_length = 0;
+        Dwarf_Half     version = 0;
+        Dwarf_Unsigned cu_header_offset = 0;
+        Dwarf_Unsigned cu_size = 0;
+        Dwarf_Unsigned entry_count = 0;
+        Dwarf_Off      cu_die_offset = 0;
+        Dwarf_Unsigned e = 0;
+
+        res = dwarf_get_gnu_index_block(head,b,&block_length,
+            &version,&cu_header_offset,&cu_size,
+            &entry_count,err);
+        if (res == DW_DLV_OK) {
+            res = dwarf_get_cu_die_offset_given_cu_header_offset_b(
+                dbg,cu_header_offset,TRUE,&cu_die_offset,err);
+        }
+        if (res != DW_DLV_OK) {
+            dwarf_gnu_index_dealloc(head);
+            return DW_DLV_ERROR;
+        }
+        search_index_add(cu_die_offset,0,SEARCH_INDEX_CU_COVERED);
+        for (e = 0; e < entry_count; ++e) {
+            Dwarf_Unsigned offset_in_cu = 0;
+            const char *name = 0;
+            unsigned char flag = 0;
+            unsigned char staticorglobal = 0;
+            unsigned char typeofentry = 0;
+
+            res = dwarf_get_gnu_index_block_entry(head,b,e,
+                &offset_in_cu,&name,&flag,&staticorglobal,
+                &typeofentry,err);
+            if (res != DW_DLV_OK) {
+                dwarf_gnu_index_dealloc(head);
+                return DW_DLV_ERROR;
+            }
+            if (offset_in_cu &&
+                search_index_name_matches(name)) {
+                search_index_add(cu_die_offset,
+                    cu_header_offset+offset_in_cu,
+                    SEARCH_INDEX_CU_DIES);
+            }
+        }
+    }
+    dwarf_gnu_index_dealloc(head);
+    if (block_count) {
+        *found = TRUE;
+    }
+    return DW_DLV_OK;
+}
+
+/*  .gdb_index names only CUs, so a CU with a
+    matching name is searched in full. */
+static int
+search_index_gdb(Dwarf_Debug dbg, Dwarf_Bool *found,
+    Dwarf_Error *err)
+{
+    Dwarf_Gdbindex gdbindex = 0;
+    Dwarf_Unsigned version = 0;
+    Dwarf_Unsigned cu_list_offset = 0;
+    Dwarf_Unsigned types_cu_list_offset = 0;
+    Dwarf_Unsigned address_area_offset = 0;
+    Dwarf_Unsigned symbol_table_offset = 0;
+    Dwarf_Unsigned constant_pool_offset = 0;
+    Dwarf_Unsigned section_size = 0;
+    const char    *section_name = 0;
+    Dwarf_Unsigned cu_count = 0;
+    Dwarf_Unsigned symbol_count = 0;
+    Dwarf_Off     *cu_die_offsets = 0;
+    Dwarf_Unsigned i = 0;
+    int res = 0;
+
+    res = dwarf_gdbindex_header(dbg,&gdbindex,&version,
+        &cu_list_offset,&types_cu_list_offset,
+        &address_area_offset,&symbol_table_offset,
+        &constant_pool_offset,&section_size,&section_name,err);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    res = dwarf_gdbindex_culist_array(gdbindex,&cu_count,err);
+    if (res == DW_DLV_OK) {
+        res = dwarf_gdbindex_symboltable_array(gdbindex,
+            &symbol_count,err);
+    }
+    if (res == DW_DLV_OK && cu_count) {
+        cu_die_offsets = (Dwarf_Off *)calloc(cu_count,
+            sizeof(Dwarf_Off));
+        if (!cu_die_offsets) {
+            res = DW_DLV_NO_ENTRY;
+        }
+    }
+    for (i = 0; res == DW_DLV_OK && i < cu_count; ++i) {
+        Dwarf_Unsigned cu_header_offset = 0;
+        Dwarf_Unsigned cu_length = 0;
+
+        res = dwarf_gdbindex_culist_entry(gdbindex,i,
+            &cu_header_offset,&cu_length,err);
+        if (res == DW_DLV_OK) {
+            res = dwarf_get_cu_die_offset_given_cu_header_offset_b(
+                dbg,cu_header_offset,TRUE,&cu_die_offsets[i],err);
+        }
+        if (res == DW_DLV_OK) {
+            search_index_add(cu_die_offsets[i],0,
+                SEARCH_INDEX_CU_COVERED);
+        }
+    }
+    for (i = 0; res == DW_DLV_OK && i < symbol_count; ++i) {
+        Dwarf_Unsigned name_offset = 0;
+        Dwarf_Unsigned cuvec_offset = 0;
+        Dwarf_Unsigned cuvec_len = 0;
+        Dwarf_Unsigned j = 0;
+        const char *name = 0;
+
+        res = dwarf_gdbindex_symboltable_entry(gdbindex,i,
+            &name_offset,&cuvec_offset,err);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        if (!name_offset && !cuvec_offset) {
+            /* An empty hash table slot. */
+            continue;
+        }
+        res = dwarf_gdbindex_string_by_offset(gdbindex,
+            name_offset,&name,err);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        if (!search_index_name_matches(name)) {
+            continue;
+        }
+        res = dwarf_gdbindex_cuvector_length(gdbindex,
+            cuvec_offset,&cuvec_len,err);
+        for (j = 0; res == DW_DLV_OK && j < cuvec_len; ++j) {
+            Dwarf_Unsigned attributes = 0;
+            Dwarf_Unsigned cu_index = 0;
+            Dwarf_Unsigned symbol_kind = 0;
+            Dwarf_Unsigned is_static = 0;
+
+            res = dwarf_gdbindex_cuvector_inner_attributes(
+                gdbindex,cuvec_offset,j,&attributes,err);
+            if (res == DW_DLV_OK) {
+                res = dwarf_gdbindex_cuvector_instance_expand_value(
+                    gdbindex,attributes,&cu_index,&symbol_kind,
+                    &is_static,err);
+            }
+            /*  Larger indexes are type units. */
+            if (res == DW_DLV_OK && cu_index < cu_count) {
+                search_index_add(cu_die_offsets[cu_index],0,
+                    SEARCH_INDEX_CU_WHOLE);
+            }
+        }
+    }
+    free(cu_die_offsets);
+    dwarf_dealloc_gdbindex(gdbindex);
+    if (res == DW_DLV_OK && cu_count) {
+        *found = TRUE;
+    }
+    return res;
+}
+
+int
+dd_search_index_setup(Dwarf_Debug dbg)
+{
+    Dwarf_Debug tied = 0;
+    Dwarf_Bool found = FALSE;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    if (!glflags.gf_search_use_index ||
+        !glflags.gf_search_is_on ||
+        glflags.search_regex_text) {
+        return DW_DLV_NO_ENTRY;
+    }
+    /*  Whatever else prints or checks a CU needs it all. */
+    if (glflags.gf_info_flag || glflags.gf_types_flag ||
+        glflags.gf_cu_name_flag || glflags.gf_line_flag ||
+        glflags.gf_macro_flag || glflags.gf_macinfo_flag ||
+        glflags.gf_do_check_dwarf ||
+        glflags.gf_producer_children_flag) {
+        return DW_DLV_NO_ENTRY;
+    }
+    res = dwarf_get_tied_dbg(dbg,&tied,&err);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,err);
+        return DW_DLV_NO_ENTRY;
+    }
+    if (res == DW_DLV_OK && tied) {
+        return DW_DLV_NO_ENTRY;
+    }
+    search_index_failed = FALSE;
+    res = search_index_globals(dbg,&found,&err);
+    if (res == DW_DLV_OK && !found) {
+        res = search_index_gnu(dbg,TRUE,&found,&err);
+        if (res != DW_DLV_ERROR) {
+            res = search_index_gnu(dbg,FALSE,&found,&err);
+        }
+    }
+    if (res != DW_DLV_ERROR && !found) {
+        res = search_index_gdb(dbg,&found,&err);
+    }
+    if (res == DW_DLV_ERROR) {
+        /*  The full walk reports whatever is wrong. */
+        dwarf_dealloc_error(dbg,err);
+        found = FALSE;
+    }
+    if (!found || search_index_failed) {
+        dd_search_index_destroy();
+        return DW_DLV_NO_ENTRY;
+    }
+    search_index_active = TRUE;
+    return DW_DLV_OK;
+}
+
+Dwarf_Bool
+dd_search_index_skips_cu(Dwarf_Off cu_die_goffset)
+{
+    struct Helpertree_Map_Entry_s *e = 0;
+
+    if (!search_index_active) {
+        return FALSE;
+    }
+    e = helpertree_find(cu_die_goffset,&search_index_cus);
+    search_index_current_cu = e? e->hm_val:SEARCH_INDEX_CU_WHOLE;
+    return search_index_current_cu == SEARCH_INDEX_CU_COVERED;
+}
+
+Dwarf_Bool
+dd_search_index_skips_die(Dwarf_Off die_goffset)
+{
+    if (!search_index_active ||
+        search_index_current_cu != SEARCH_INDEX_CU_DIES) {
+        return FALSE;
+    }
+    return !helpertree_find(die_goffset,&search_index_dies);
+}
+
+void
+dd_search_index_destroy(void)
+{
+    helpertree_clear_statistics(&search_index_cus);
+    helpertree_clear_statistics(&search_index_dies);
+    search_index_active = FALSE;
+    search_index_current_cu = 0;
+}
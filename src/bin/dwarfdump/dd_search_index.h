@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef DD_SEARCH_INDEX_H
+#define DD_SEARCH_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*  --search-index: -S any= and -S match= look up the
+    accelerator tables (.debug_names or .debug_pubnames
+    with .debug_pubtypes, else .debug_gnu_pubnames with
+    .debug_gnu_pubtypes, else .gdb_index) and print only
+    the .debug_info DIEs (or, for .gdb_index, the CUs)
+    whose names match.
+    Builds the candidate sets. Returns DW_DLV_NO_ENTRY
+    (and the search is done the usual way) when not
+    asked for, when other output needs every DIE, for
+    regex= or when there is no usable table. */
+int dd_search_index_setup(Dwarf_Debug dbg);
+
+/*  TRUE if the CU with this CU DIE global offset
+    need not be read: the tables cover it and none
+    of its names match. */
+Dwarf_Bool dd_search_index_skips_cu(Dwarf_Off cu_die_goffset);
+
+/*  TRUE if the DIE (not a CU DIE) in the CU last
+    passed to dd_search_index_skips_cu() can be left
+    unprinted as no matching name refers to it. */
+Dwarf_Bool dd_search_index_skips_die(Dwarf_Off die_goffset);
+
+void dd_search_index_destroy(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* DD_SEARCH_INDEX_H */
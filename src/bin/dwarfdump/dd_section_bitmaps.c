@@ -27,6 +27,7 @@ Copyright (C) 2017-2018 David Anderson. All Rights Reserved.
 
 #include <config.h>
 
+#include <stdlib.h> /* free() realloc() */
 #include <string.h> /* strcmp() */
 
 #include "dwarf.h"
@@ -178,3 +179,62 @@ enable_reloc_map_entry(unsigned index)
         reloc_map[index] = TRUE;
     }
 }
+
+/*  The DWARF sections this run reads. Empty means
+    every section, which is the default. See
+    dwarf_set_section_filter() in libdwarf.
+    If the names cannot all be kept every section
+    is read: a map missing a section would leave
+    out what some printer needs. */
+static const char **load_map_names;
+static unsigned load_map_count;
+static unsigned load_map_alloc;
+static Dwarf_Bool load_map_incomplete;
+
+void
+enable_load_map_section(const char *name)
+{
+    unsigned i = 0;
+
+    for ( ; i < load_map_count; ++i) {
+        if (!strcmp(name,load_map_names[i])) {
+            return;
+        }
+    }
+    if (load_map_count+1 >= load_map_alloc) {
+        unsigned newalloc = load_map_alloc? load_map_alloc*2 : 32;
+        const char **newnames = (const char **)realloc(
+            (void *)load_map_names,newalloc*sizeof(const char *));
+
+        if (!newnames) {
+            load_map_incomplete = TRUE;
+            return;
+        }
+        load_map_names = newnames;
+        load_map_alloc = newalloc;
+    }
+    load_map_names[load_map_count] = name;
+    ++load_map_count;
+    load_map_names[load_map_count] = 0;
+}
+
+/*  Returns 0 if no load map was set, meaning
+    every section is to be read. */
+const char **
+load_map_section_names(void)
+{
+    if (!load_map_count || load_map_incomplete) {
+        return 0;
+    }
+    return load_map_names;
+}
+
+void
+load_map_destructor(void)
+{
+    free((void *)load_map_names);
+    load_map_names = 0;
+    load_map_count = 0;
+    load_map_alloc = 0;
+    load_map_incomplete = FALSE;
+}
@@ -102,6 +102,8 @@ extern struct section_map_s  map_sectnames[] ;
 #define DW_SECTNAME_GDB_INDEX       ".gdb_index"
 #define DW_SECTNAME_EH_FRAME        ".eh_frame"
 #define DW_SECTNAME_DEBUG_SUP       ".debug_sup"
+#define DW_SECTNAME_DEBUG_LINE_STR  ".debug_line_str"
+#define DW_SECTNAME_DEBUG_ADDR      ".debug_addr"
 #define DW_SECTNAME_DEBUG_MACINFO   ".debug_macinfo"
 #define DW_SECTNAME_DEBUG_MACRO     ".debug_macro"
 #define DW_SECTNAME_DEBUG_MACRO_DWO ".debug_macro.dwo"
@@ -186,4 +188,8 @@ void enable_reloc_map_entry(unsigned index);
 Dwarf_Bool reloc_map_enabled(unsigned index);
 void set_all_reloc_sections_on(void);
 
+void enable_load_map_section(const char *name);
+const char **load_map_section_names(void);
+void load_map_destructor(void);
+
 #endif /* SECTION_BITMAPS_H_INCLUDED*/
@@ -0,0 +1,911 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  --size-report.
+    Every byte of a unit is one of: the unit header,
+    a DIE (its abbreviation code and its attribute
+    values, as dwarf_die_decode_attrs() measures them)
+    or what is left, the null entries ending sibling
+    chains and any padding.
+    DIE bytes are added to the DIE's tag and each
+    attribute's bytes to its attribute and its form,
+    so the tag, attribute and form tables each add up
+    to the DIE bytes (less the abbreviation codes for
+    the last two).
+    The tag, attribute and form counts are arrays
+    indexed by the DW_TAG, DW_AT or DW_FORM number,
+    allocated only for --size-report. */
+
+#include <config.h>
+
+#include <stdio.h>  /* FILE printf() */
+#include <stdlib.h> /* calloc() free() qsort() realloc() */
+#include <string.h> /* memcmp() memset() strcmp() strdup() strstr() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h"
+#include "dd_globals.h"
+#include "dd_naming.h"
+#include "dd_esb.h"
+#include "dd_json.h"
+#include "dd_workers.h"
+#include "dd_size_report.h"
+
+struct size_count_s {
+    Dwarf_Unsigned sc_count;
+    Dwarf_Unsigned sc_bytes;
+};
+
+/*  DW_TAG_hi_user and DW_AT_hi_user are the largest
+    values libdwarf accepts. Forms stop below 0x2000
+    (the DW_FORM_GNU_* forms), anything beyond is
+    counted as form 0. */
+#define SIZE_TAG_COUNT  (DW_TAG_hi_user+1)
+#define SIZE_ATTR_COUNT (DW_AT_hi_user+1)
+#define SIZE_FORM_COUNT 0x2000
+
+struct size_unit_s {
+    Dwarf_Bool     su_is_info;
+    Dwarf_Bool     su_has_signature;
+    Dwarf_Sig8     su_signature;
+    Dwarf_Off      su_offset;    /* of the unit header */
+    Dwarf_Unsigned su_bytes;     /* the whole unit */
+    Dwarf_Unsigned su_header_bytes;
+    Dwarf_Unsigned su_die_bytes;
+    Dwarf_Unsigned su_die_count;
+    char          *su_name;      /* malloc()ed */
+    char          *su_producer;  /* malloc()ed */
+};
+
+static struct size_count_s *size_tags;
+static struct size_count_s *size_attrs;
+static struct size_count_s *size_forms;
+static Dwarf_Unsigned size_undecoded_dies;
+static struct size_unit_s *size_units;
+static Dwarf_Unsigned size_unit_count;
+static Dwarf_Unsigned size_unit_alloc;
+/*  The unit size_report_die() adds to, if any. */
+static struct size_unit_s *size_current_unit;
+
+/*  Nearly every DIE has fewer attributes than this. */
+#define SIZE_VALUES_START 64
+static Dwarf_Attr_Value *size_values;
+static Dwarf_Unsigned size_values_len;
+
+static int
+size_tables_setup(void)
+{
+    if (size_tags) {
+        return DW_DLV_OK;
+    }
+    size_tags = (struct size_count_s *)calloc(SIZE_TAG_COUNT,
+        sizeof(struct size_count_s));
+    size_attrs = (struct size_count_s *)calloc(SIZE_ATTR_COUNT,
+        sizeof(struct size_count_s));
+    size_forms = (struct size_count_s *)calloc(SIZE_FORM_COUNT,
+        sizeof(struct size_count_s));
+    size_values = (Dwarf_Attr_Value *)calloc(SIZE_VALUES_START,
+        sizeof(Dwarf_Attr_Value));
+    if (!size_tags || !size_attrs || !size_forms || !size_values) {
+        size_report_destructor();
+        printf("ERROR: --size-report is unable to allocate "
+            "its tables\n");
+        glflags.gf_count_major_errors++;
+        glflags.gf_size_report = FALSE;
+        return DW_DLV_ERROR;
+    }
+    size_values_len = SIZE_VALUES_START;
+    return DW_DLV_OK;
+}
+
+static void
+free_units(void)
+{
+    Dwarf_Unsigned i = 0;
+
+    for (i = 0; i < size_unit_count; ++i) {
+        free(size_units[i].su_name);
+        free(size_units[i].su_producer);
+    }
+    free(size_units);
+    size_units = 0;
+    size_unit_count = 0;
+    size_unit_alloc = 0;
+    size_current_unit = 0;
+}
+
+void
+size_report_destructor(void)
+{
+    free(size_tags);
+    size_tags = 0;
+    free(size_attrs);
+    size_attrs = 0;
+    free(size_forms);
+    size_forms = 0;
+    free(size_values);
+    size_values = 0;
+    size_values_len = 0;
+    size_undecoded_dies = 0;
+    free_units();
+}
+
+/*  Returns a new zeroed unit at the end of size_units,
+    or NULL if out of memory. */
+static struct size_unit_s *
+new_unit(void)
+{
+    struct size_unit_s *u = 0;
+
+    if (size_unit_count >= size_unit_alloc) {
+        Dwarf_Unsigned n = size_unit_alloc? size_unit_alloc*2: 64;
+        struct size_unit_s *newp = 0;
+
+        newp = (struct size_unit_s *)realloc(size_units,
+            n*sizeof(struct size_unit_s));
+        if (!newp) {
+            return 0;
+        }
+        size_units = newp;
+        size_unit_alloc = n;
+    }
+    u = size_units + size_unit_count;
+    ++size_unit_count;
+    memset(u,0,sizeof(*u));
+    return u;
+}
+
+/*  The unit strings are NULL only if strdup() failed. */
+static const char *
+unit_text(const char *s)
+{
+    return s? s : "<unknown>";
+}
+
+/*  A type unit has no DW_AT_name, so it is
+    named by its signature. */
+static char *
+unit_string(Dwarf_Debug dbg, Dwarf_Die cu_die, Dwarf_Half attrnum,
+    struct size_unit_s *u)
+{
+    char *s = 0;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    res = dwarf_die_text(cu_die,attrnum,&s,&err);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,err);
+    }
+    if (res == DW_DLV_OK && s) {
+        return strdup(s);
+    }
+    if (attrnum == DW_AT_name && u->su_has_signature) {
+        struct esb_s m;
+        char *name = 0;
+        unsigned i = 0;
+
+        esb_constructor(&m);
+        esb_append(&m,"<type unit 0x");
+        for (i = 0; i < sizeof(u->su_signature.signature); ++i) {
+            esb_append_printf_u(&m,"%02x",
+                (unsigned char)u->su_signature.signature[i]);
+        }
+        esb_append(&m,">");
+        name = strdup(esb_get_string(&m));
+        esb_destructor(&m);
+        return name;
+    }
+    return strdup("<unknown>");
+}
+
+void
+size_report_unit(Dwarf_Debug dbg, Dwarf_Bool is_info,
+    Dwarf_Die cu_die,
+    Dwarf_Unsigned cu_header_length,
+    Dwarf_Half length_size,
+    Dwarf_Half extension_size,
+    Dwarf_Unsigned next_cu_offset,
+    Dwarf_Sig8 *signature)
+{
+    struct size_unit_s *u = 0;
+    Dwarf_Off cu_die_goffset = 0;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    size_current_unit = 0;
+    if (size_tables_setup() != DW_DLV_OK) {
+        return;
+    }
+    u = new_unit();
+    if (!u) {
+        return;
+    }
+    u->su_is_info = is_info;
+    u->su_bytes = cu_header_length + length_size + extension_size;
+    u->su_offset = next_cu_offset > u->su_bytes?
+        next_cu_offset - u->su_bytes : 0;
+    res = dwarf_dieoffset(cu_die,&cu_die_goffset,&err);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,err);
+    }
+    if (res == DW_DLV_OK && cu_die_goffset > u->su_offset) {
+        u->su_header_bytes = cu_die_goffset - u->su_offset;
+    }
+    if (signature) {
+        Dwarf_Sig8 zero;
+
+        memset(&zero,0,sizeof(zero));
+        if (memcmp(signature,&zero,sizeof(zero))) {
+            u->su_has_signature = TRUE;
+            u->su_signature = *signature;
+        }
+    }
+    u->su_name = unit_string(dbg,cu_die,DW_AT_name,u);
+    u->su_producer = unit_string(dbg,cu_die,DW_AT_producer,u);
+    size_current_unit = u;
+}
+
+static Dwarf_Unsigned
+uleb_length(Dwarf_Unsigned v)
+{
+    Dwarf_Unsigned len = 1;
+
+    for ( ; v >= 0x80; v >>= 7) {
+        ++len;
+    }
+    return len;
+}
+
+void
+size_report_die(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    Dwarf_Half tag = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned bytes = 0;
+    Dwarf_Unsigned i = 0;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    if (!size_tags) {
+        return;
+    }
+    res = dwarf_tag(die,&tag,&err);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,err);
+        err = 0;
+    }
+    bytes = uleb_length((Dwarf_Unsigned)dwarf_die_abbrev_code(die));
+    res = dwarf_die_decode_attrs(die,size_values,size_values_len,
+        &count,&err);
+    if (res == DW_DLV_OK && count > size_values_len) {
+        Dwarf_Attr_Value *newp = 0;
+
+        newp = (Dwarf_Attr_Value *)realloc(size_values,
+            count*sizeof(Dwarf_Attr_Value));
+        if (newp) {
+            size_values = newp;
+            size_values_len = count;
+            res = dwarf_die_decode_attrs(die,size_values,
+                size_values_len,&count,&err);
+        } else {
+            count = size_values_len;
+            ++size_undecoded_dies;
+        }
+    }
+    if (res == DW_DLV_ERROR) {
+        /*  Corrupt values. Printing or checking
+            reports them, here the DIE is just counted. */
+        dwarf_dealloc_error(dbg,err);
+        count = 0;
+        ++size_undecoded_dies;
+    } else if (res == DW_DLV_NO_ENTRY) {
+        count = 0;
+    }
+    for (i = 0; i < count; ++i) {
+        Dwarf_Attr_Value *av = size_values+i;
+        unsigned form = av->av_form < SIZE_FORM_COUNT?
+            av->av_form : 0;
+
+        if (av->av_attrnum < SIZE_ATTR_COUNT) {
+            size_attrs[av->av_attrnum].sc_count++;
+            size_attrs[av->av_attrnum].sc_bytes += av->av_size;
+        }
+        size_forms[form].sc_count++;
+        size_forms[form].sc_bytes += av->av_size;
+        bytes += av->av_size;
+    }
+    size_tags[tag].sc_count++;
+    size_tags[tag].sc_bytes += bytes;
+    if (size_current_unit) {
+        size_current_unit->su_die_count++;
+        size_current_unit->su_die_bytes += bytes;
+    }
+}
+
+/*  One line of a sorted table. */
+struct size_row_s {
+    const char    *sr_name;
+    Dwarf_Unsigned sr_value;
+    Dwarf_Unsigned sr_count;
+    Dwarf_Unsigned sr_bytes;
+};
+
+/*  Largest first, then by name so the order
+    is the same from run to run. */
+static int
+compare_rows(const void *l, const void *r)
+{
+    const struct size_row_s *lr = (const struct size_row_s *)l;
+    const struct size_row_s *rr = (const struct size_row_s *)r;
+
+    if (lr->sr_bytes != rr->sr_bytes) {
+        return lr->sr_bytes > rr->sr_bytes? -1 : 1;
+    }
+    if (lr->sr_value != rr->sr_value) {
+        return lr->sr_value < rr->sr_value? -1 : 1;
+    }
+    return strcmp(lr->sr_name,rr->sr_name);
+}
+
+static double
+size_percent(Dwarf_Unsigned part, Dwarf_Unsigned whole)
+{
+    if (!whole) {
+        return 0.0;
+    }
+    return ((double)part * 100.0) / (double)whole;
+}
+
+static struct esb_s size_json;
+
+/*  Prints (or writes as JSON records of the given type)
+    rows sorted by size. The rows are sorted in place. */
+static void
+print_rows(const char *title, const char *json_type,
+    const char *json_name_key,
+    struct size_row_s *rows, Dwarf_Unsigned count,
+    Dwarf_Unsigned whole)
+{
+    Dwarf_Unsigned i = 0;
+
+    qsort(rows,(size_t)count,sizeof(struct size_row_s),compare_rows);
+    if (glflags.gf_json_output) {
+        for (i = 0; i < count; ++i) {
+            dd_json_begin(&size_json,json_type);
+            dd_json_string(&size_json,json_name_key,rows[i].sr_name);
+            dd_json_unsigned(&size_json,"count",rows[i].sr_count);
+            dd_json_unsigned(&size_json,"bytes",rows[i].sr_bytes);
+            dd_json_end(&size_json);
+        }
+        return;
+    }
+    printf("\n*** %s ***\n",title);
+    printf("%14s %6s %10s  %s\n","bytes","%","count","name");
+    for (i = 0; i < count; ++i) {
+        printf("%14" DW_PR_DUu " %5.1f%% %10" DW_PR_DUu "  %s\n",
+            rows[i].sr_bytes,
+            size_percent(rows[i].sr_bytes,whole),
+            rows[i].sr_count,
+            rows[i].sr_name);
+    }
+}
+
+/*  Rows for the nonzero entries of a count table. */
+static void
+print_table(const char *title, const char *json_type,
+    struct size_count_s *table, unsigned table_count,
+    const char *(*namer)(unsigned int,int),
+    Dwarf_Unsigned whole)
+{
+    struct size_row_s *rows = 0;
+    Dwarf_Unsigned count = 0;
+    unsigned i = 0;
+
+    rows = (struct size_row_s *)calloc(table_count,
+        sizeof(struct size_row_s));
+    if (!rows) {
+        printf("ERROR: --size-report is unable to allocate "
+            "the %s table\n",json_type);
+        glflags.gf_count_major_errors++;
+        return;
+    }
+    for (i = 0; i < table_count; ++i) {
+        if (!table[i].sc_count) {
+            continue;
+        }
+        rows[count].sr_name = namer(i,FALSE);
+        rows[count].sr_count = table[i].sc_count;
+        rows[count].sr_bytes = table[i].sc_bytes;
+        ++count;
+    }
+    print_rows(title,json_type,"name",rows,count,whole);
+    free(rows);
+}
+
+static Dwarf_Bool
+is_debug_section(const char *name)
+{
+    return strstr(name,"debug") || !strcmp(name,".gdb_index");
+}
+
+static void
+print_section_sizes(Dwarf_Debug dbg)
+{
+    int count = dwarf_get_section_count(dbg);
+    struct size_row_s *rows = 0;
+    Dwarf_Unsigned rowcount = 0;
+    Dwarf_Unsigned total = 0;
+    int i = 0;
+
+    if (count <= 0) {
+        return;
+    }
+    rows = (struct size_row_s *)calloc((size_t)count,
+        sizeof(struct size_row_s));
+    if (!rows) {
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        const char *name = 0;
+        Dwarf_Addr addr = 0;
+        Dwarf_Unsigned size = 0;
+        Dwarf_Error err = 0;
+        int res = 0;
+
+        res = dwarf_get_section_info_by_index(dbg,i,
+            &name,&addr,&size,&err);
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,err);
+            continue;
+        }
+        if (res == DW_DLV_NO_ENTRY || !name ||
+            !is_debug_section(name)) {
+            continue;
+        }
+        rows[rowcount].sr_name = name;
+        rows[rowcount].sr_count = 1;
+        rows[rowcount].sr_bytes = size;
+        total += size;
+        ++rowcount;
+    }
+    print_rows("SIZE BY SECTION","size_section","name",
+        rows,rowcount,total);
+    free(rows);
+}
+
+static int
+compare_unit_producers(const void *l, const void *r)
+{
+    const struct size_unit_s *lu = *(const struct size_unit_s **)l;
+    const struct size_unit_s *ru = *(const struct size_unit_s **)r;
+
+    return strcmp(unit_text(lu->su_producer),
+        unit_text(ru->su_producer));
+}
+
+static void
+print_producer_sizes(Dwarf_Unsigned whole)
+{
+    struct size_unit_s **byprod = 0;
+    struct size_row_s *rows = 0;
+    Dwarf_Unsigned rowcount = 0;
+    Dwarf_Unsigned i = 0;
+
+    byprod = (struct size_unit_s **)calloc((size_t)size_unit_count,
+        sizeof(struct size_unit_s *));
+    rows = (struct size_row_s *)calloc((size_t)size_unit_count,
+        sizeof(struct size_row_s));
+    if (!byprod || !rows) {
+        free(byprod);
+        free(rows);
+        return;
+    }
+    for (i = 0; i < size_unit_count; ++i) {
+        byprod[i] = size_units+i;
+    }
+    qsort(byprod,(size_t)size_unit_count,sizeof(byprod[0]),
+        compare_unit_producers);
+    for (i = 0; i < size_unit_count; ++i) {
+        const char *producer = unit_text(byprod[i]->su_producer);
+
+        if (!rowcount || strcmp(rows[rowcount-1].sr_name,producer)) {
+            rows[rowcount].sr_name = producer;
+            ++rowcount;
+        }
+        rows[rowcount-1].sr_count++;
+        rows[rowcount-1].sr_bytes += byprod[i]->su_bytes;
+    }
+    print_rows("SIZE BY PRODUCER","size_producer","producer",
+        rows,rowcount,whole);
+    free(byprod);
+    free(rows);
+}
+
+static int
+compare_units(const void *l, const void *r)
+{
+    const struct size_unit_s *lu = *(const struct size_unit_s **)l;
+    const struct size_unit_s *ru = *(const struct size_unit_s **)r;
+
+    if (lu->su_bytes != ru->su_bytes) {
+        return lu->su_bytes > ru->su_bytes? -1 : 1;
+    }
+    if (lu->su_is_info != ru->su_is_info) {
+        return lu->su_is_info? -1 : 1;
+    }
+    if (lu->su_offset != ru->su_offset) {
+        return lu->su_offset < ru->su_offset? -1 : 1;
+    }
+    return 0;
+}
+
+static void
+print_unit_sizes(struct size_unit_s **units, Dwarf_Unsigned whole)
+{
+    Dwarf_Unsigned i = 0;
+
+    qsort(units,(size_t)size_unit_count,sizeof(units[0]),
+        compare_units);
+    if (!glflags.gf_json_output) {
+        printf("\n*** SIZE BY UNIT ***\n");
+        printf("%14s %6s %10s %10s %10s  %s\n","bytes","%",
+            "header","DIEs","DIE bytes","section offset name");
+    }
+    for (i = 0; i < size_unit_count; ++i) {
+        struct size_unit_s *u = units[i];
+        const char *secname = u->su_is_info?
+            ".debug_info":".debug_types";
+
+        if (glflags.gf_json_output) {
+            dd_json_begin(&size_json,"size_unit");
+            dd_json_string(&size_json,"section",secname);
+            dd_json_unsigned(&size_json,"offset",u->su_offset);
+            dd_json_string(&size_json,"name",unit_text(u->su_name));
+            dd_json_string(&size_json,"producer",
+                unit_text(u->su_producer));
+            if (u->su_has_signature) {
+                dd_json_bytes(&size_json,"signature",
+                    (const unsigned char *)u->su_signature.signature,
+                    sizeof(u->su_signature.signature));
+            }
+            dd_json_unsigned(&size_json,"bytes",u->su_bytes);
+            dd_json_unsigned(&size_json,"header_bytes",
+                u->su_header_bytes);
+            dd_json_unsigned(&size_json,"die_count",u->su_die_count);
+            dd_json_unsigned(&size_json,"die_bytes",u->su_die_bytes);
+            dd_json_end(&size_json);
+            continue;
+        }
+        printf("%14" DW_PR_DUu " %5.1f%% %10" DW_PR_DUu
+            " %10" DW_PR_DUu " %10" DW_PR_DUu "  %s 0x%"
+            DW_PR_XZEROS DW_PR_DUx " %s\n",
+            u->su_bytes,size_percent(u->su_bytes,whole),
+            u->su_header_bytes,u->su_die_count,u->su_die_bytes,
+            secname,u->su_offset,unit_text(u->su_name));
+    }
+}
+
+static int
+compare_unit_signatures(const void *l, const void *r)
+{
+    const struct size_unit_s *lu = *(const struct size_unit_s **)l;
+    const struct size_unit_s *ru = *(const struct size_unit_s **)r;
+
+    if (lu->su_has_signature != ru->su_has_signature) {
+        return lu->su_has_signature? -1 : 1;
+    }
+    return memcmp(&lu->su_signature,&ru->su_signature,
+        sizeof(lu->su_signature));
+}
+
+/*  A type unit whose signature an earlier type unit
+    has is a duplicate: a linker (or dwp) that combined
+    them would keep just one. */
+static void
+print_type_unit_duplicates(struct size_unit_s **units)
+{
+    Dwarf_Unsigned type_units = 0;
+    Dwarf_Unsigned signatures = 0;
+    Dwarf_Unsigned dup_units = 0;
+    Dwarf_Unsigned dup_bytes = 0;
+    Dwarf_Unsigned i = 0;
+
+    qsort(units,(size_t)size_unit_count,sizeof(units[0]),
+        compare_unit_signatures);
+    for (i = 0; i < size_unit_count &&
+        units[i]->su_has_signature; ++i) {
+        ++type_units;
+        if (i && !memcmp(&units[i]->su_signature,
+            &units[i-1]->su_signature,
+            sizeof(units[i]->su_signature))) {
+            ++dup_units;
+            dup_bytes += units[i]->su_bytes;
+        } else {
+            ++signatures;
+        }
+    }
+    if (glflags.gf_json_output) {
+        dd_json_begin(&size_json,"size_type_units");
+        dd_json_unsigned(&size_json,"type_units",type_units);
+        dd_json_unsigned(&size_json,"signatures",signatures);
+        dd_json_unsigned(&size_json,"duplicate_units",dup_units);
+        dd_json_unsigned(&size_json,"duplicate_bytes",dup_bytes);
+        dd_json_end(&size_json);
+        return;
+    }
+    printf("\n*** TYPE UNIT DUPLICATION ***\n");
+    printf("Type units                : %10" DW_PR_DUu "\n",
+        type_units);
+    printf("Distinct signatures       : %10" DW_PR_DUu "\n",
+        signatures);
+    printf("Duplicate type units      : %10" DW_PR_DUu "\n",
+        dup_units);
+    printf("Duplicate type unit bytes : %10" DW_PR_DUu "\n",
+        dup_bytes);
+}
+
+void
+print_size_report(Dwarf_Debug dbg)
+{
+    struct size_unit_s **units = 0;
+    Dwarf_Unsigned unit_bytes = 0;
+    Dwarf_Unsigned header_bytes = 0;
+    Dwarf_Unsigned die_bytes = 0;
+    Dwarf_Unsigned die_count = 0;
+    Dwarf_Unsigned other_bytes = 0;
+    Dwarf_Unsigned i = 0;
+
+    if (size_tables_setup() != DW_DLV_OK) {
+        return;
+    }
+    for (i = 0; i < size_unit_count; ++i) {
+        struct size_unit_s *u = size_units+i;
+        Dwarf_Unsigned used = u->su_header_bytes + u->su_die_bytes;
+
+        unit_bytes += u->su_bytes;
+        header_bytes += u->su_header_bytes;
+        die_bytes += u->su_die_bytes;
+        die_count += u->su_die_count;
+        if (u->su_bytes > used) {
+            other_bytes += u->su_bytes - used;
+        }
+    }
+    esb_constructor(&size_json);
+    if (glflags.gf_json_output) {
+        dd_json_begin(&size_json,"size_summary");
+        dd_json_unsigned(&size_json,"units",size_unit_count);
+        dd_json_unsigned(&size_json,"unit_bytes",unit_bytes);
+        dd_json_unsigned(&size_json,"header_bytes",header_bytes);
+        dd_json_unsigned(&size_json,"die_count",die_count);
+        dd_json_unsigned(&size_json,"die_bytes",die_bytes);
+        dd_json_unsigned(&size_json,"null_and_padding_bytes",
+            other_bytes);
+        dd_json_unsigned(&size_json,"undecoded_dies",
+            size_undecoded_dies);
+        dd_json_end(&size_json);
+    } else {
+        printf("\n*** SIZE REPORT ***\n");
+        printf("Units                     : %10" DW_PR_DUu "\n",
+            size_unit_count);
+        printf("Unit bytes                : %10" DW_PR_DUu "\n",
+            unit_bytes);
+        printf("  Unit headers            : %10" DW_PR_DUu "\n",
+            header_bytes);
+        printf("  DIEs                    : %10" DW_PR_DUu
+            " in %" DW_PR_DUu " DIEs\n",die_bytes,die_count);
+        printf("  Null entries and padding: %10" DW_PR_DUu "\n",
+            other_bytes);
+        if (size_undecoded_dies) {
+            printf("DIEs with corrupt attributes (counted "
+                "without them): %" DW_PR_DUu "\n",
+                size_undecoded_dies);
+        }
+    }
+    print_section_sizes(dbg);
+    print_producer_sizes(unit_bytes);
+    units = (struct size_unit_s **)calloc((size_t)size_unit_count+1,
+        sizeof(struct size_unit_s *));
+    if (units) {
+        for (i = 0; i < size_unit_count; ++i) {
+            units[i] = size_units+i;
+        }
+        print_unit_sizes(units,unit_bytes);
+        print_type_unit_duplicates(units);
+        free(units);
+    }
+    print_table("SIZE BY TAG","size_tag",size_tags,SIZE_TAG_COUNT,
+        get_TAG_name,die_bytes);
+    print_table("SIZE BY ATTRIBUTE","size_attribute",size_attrs,
+        SIZE_ATTR_COUNT,get_AT_name,die_bytes);
+    print_table("SIZE BY FORM","size_form",size_forms,
+        SIZE_FORM_COUNT,get_FORM_name,die_bytes);
+    esb_destructor(&size_json);
+}
+
+void
+size_report_worker_begin(void)
+{
+    if (size_tags) {
+        memset(size_tags,0,SIZE_TAG_COUNT*
+            sizeof(struct size_count_s));
+        memset(size_attrs,0,SIZE_ATTR_COUNT*
+            sizeof(struct size_count_s));
+        memset(size_forms,0,SIZE_FORM_COUNT*
+            sizeof(struct size_count_s));
+    }
+    size_undecoded_dies = 0;
+    free_units();
+}
+
+/*  The nonzero entries as index and count,
+    ending with an index past the table. */
+static int
+write_table(FILE *f, struct size_count_s *table, unsigned count)
+{
+    unsigned i = 0;
+    int res = DW_DLV_OK;
+
+    for (i = 0; res == DW_DLV_OK && i < count; ++i) {
+        if (!table[i].sc_count) {
+            continue;
+        }
+        res = dd_report_write(f,&i,sizeof(i));
+        if (res == DW_DLV_OK) {
+            res = dd_report_write(f,&table[i],sizeof(table[i]));
+        }
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&count,sizeof(count));
+    }
+    return res;
+}
+
+static int
+merge_table(FILE *f, struct size_count_s *table, unsigned count)
+{
+    for (;;) {
+        unsigned i = 0;
+        struct size_count_s c;
+        int res = 0;
+
+        res = dd_report_read(f,&i,sizeof(i));
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        if (i >= count) {
+            return DW_DLV_OK;
+        }
+        res = dd_report_read(f,&c,sizeof(c));
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        table[i].sc_count += c.sc_count;
+        table[i].sc_bytes += c.sc_bytes;
+    }
+}
+
+int
+size_report_worker_write(FILE *f)
+{
+    Dwarf_Unsigned i = 0;
+    Dwarf_Bool have_tables = size_tags != 0;
+    int res = 0;
+
+    res = dd_report_write(f,&have_tables,sizeof(have_tables));
+    if (res != DW_DLV_OK || !have_tables) {
+        return res;
+    }
+    res = write_table(f,size_tags,SIZE_TAG_COUNT);
+    if (res == DW_DLV_OK) {
+        res = write_table(f,size_attrs,SIZE_ATTR_COUNT);
+    }
+    if (res == DW_DLV_OK) {
+        res = write_table(f,size_forms,SIZE_FORM_COUNT);
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&size_undecoded_dies,
+            sizeof(size_undecoded_dies));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&size_unit_count,
+            sizeof(size_unit_count));
+    }
+    for (i = 0; res == DW_DLV_OK && i < size_unit_count; ++i) {
+        struct size_unit_s *u = size_units+i;
+
+        res = dd_report_write(f,u,sizeof(*u));
+        if (res == DW_DLV_OK) {
+            res = dd_report_write_string(f,u->su_name);
+        }
+        if (res == DW_DLV_OK) {
+            res = dd_report_write_string(f,u->su_producer);
+        }
+    }
+    return res;
+}
+
+int
+size_report_worker_merge(FILE *f)
+{
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned undecoded = 0;
+    Dwarf_Unsigned i = 0;
+    Dwarf_Bool have_tables = FALSE;
+    int res = 0;
+
+    res = dd_report_read(f,&have_tables,sizeof(have_tables));
+    if (res != DW_DLV_OK || !have_tables) {
+        return res;
+    }
+    res = size_tables_setup();
+    if (res == DW_DLV_OK) {
+        res = merge_table(f,size_tags,SIZE_TAG_COUNT);
+    }
+    if (res == DW_DLV_OK) {
+        res = merge_table(f,size_attrs,SIZE_ATTR_COUNT);
+    }
+    if (res == DW_DLV_OK) {
+        res = merge_table(f,size_forms,SIZE_FORM_COUNT);
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&undecoded,sizeof(undecoded));
+        size_undecoded_dies += undecoded;
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&count,sizeof(count));
+    }
+    for (i = 0; res == DW_DLV_OK && i < count; ++i) {
+        struct size_unit_s w;
+        struct size_unit_s *u = 0;
+
+        res = dd_report_read(f,&w,sizeof(w));
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        u = new_unit();
+        if (!u) {
+            res = DW_DLV_ERROR;
+            break;
+        }
+        *u = w;
+        u->su_name = 0;
+        u->su_producer = 0;
+        res = dd_report_read_string(f,&u->su_name);
+        if (res == DW_DLV_OK) {
+            res = dd_report_read_string(f,&u->su_producer);
+        }
+    }
+    /*  What the last unit was is not carried over. */
+    size_current_unit = 0;
+    return res;
+}
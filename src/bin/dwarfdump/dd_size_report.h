@@ -0,0 +1,72 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef DD_SIZE_REPORT_H
+#define DD_SIZE_REPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*  --size-report: where the bytes of .debug_info and
+    .debug_types go, by section, unit, producer, tag,
+    attribute and form, and how much of it is type
+    units repeated with the same signature.
+    The CU loop of print_die.c calls size_report_unit()
+    for each unit it reads and the DIE walk calls
+    size_report_die() for each DIE, so the numbers come
+    from the one pass over the DIEs whether or not
+    anything else is printed. */
+void size_report_unit(Dwarf_Debug dbg, Dwarf_Bool is_info,
+    Dwarf_Die cu_die,
+    Dwarf_Unsigned cu_header_length,
+    Dwarf_Half length_size,
+    Dwarf_Half extension_size,
+    Dwarf_Unsigned next_cu_offset,
+    Dwarf_Sig8 *signature);
+void size_report_die(Dwarf_Debug dbg, Dwarf_Die die);
+
+/*  Prints the totals (as JSON records with --format=json)
+    sorted by size. */
+void print_size_report(Dwarf_Debug dbg);
+void size_report_destructor(void);
+
+/*  --threads=<n>: a worker starts the totals from zero,
+    writes what it counted and this process
+    adds that to its own totals. */
+void size_report_worker_begin(void);
+int  size_report_worker_write(FILE *f);
+int  size_report_worker_merge(FILE *f);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* DD_SIZE_REPORT_H */
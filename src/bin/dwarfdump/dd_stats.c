@@ -0,0 +1,554 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  --stats.
+    Phase times are in microseconds: wall time from
+    gettimeofday() where there is one and CPU time
+    from clock(), which counts this process only
+    (workers report theirs, see stats_worker_write()).
+    The section and allocation counts are kept by
+    libdwarf in the Dwarf_Debug; what forked workers
+    added is kept here and added in when printing. */
+
+#include <config.h>
+
+#include <stdio.h>  /* FILE printf() */
+#include <string.h> /* memcpy() memset() */
+#include <time.h>   /* clock() time() */
+
+#if defined(HAVE_UNISTD_H) && !defined(_WIN32)
+#include <sys/time.h> /* gettimeofday() */
+#define DD_HAVE_GETTIMEOFDAY 1
+#endif /* HAVE_UNISTD_H && !_WIN32 */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h"
+#include "dd_globals.h"
+#include "dd_esb.h"
+#include "dd_json.h"
+#include "dd_sanitized.h"
+#include "dd_workers.h"
+#include "dd_stats.h"
+
+static const char *stats_phase_names[STATS_PHASE_COUNT] = {
+    "open",
+    "check setup",
+    "print_section_groups_data",
+    "print_json",
+    "print_infos",
+    "print_line_numbers_this_cu",
+    "print_macros",
+    "print_gdb_index",
+    "print_pubnames",
+    "print_debug_addr",
+    "print_abbrevs",
+    "print_strings",
+    "print_aranges",
+    "print_ranges",
+    "print_raw_all_loclists",
+    "print_raw_all_rnglists",
+    "print_frames",
+    "print_static_funcs",
+    "print_static_vars",
+    "print_types",
+    "print_weaknames",
+    "print_debug_names",
+    "print_size_report",
+    "print_str_offsets_section",
+    "print_debug_gnu",
+    "print_debug_sup",
+};
+
+struct stats_phase_s {
+    Dwarf_Unsigned sp_calls;
+    Dwarf_Unsigned sp_wall;
+    Dwarf_Unsigned sp_cpu;
+};
+static struct stats_phase_s stats_phases[STATS_PHASE_COUNT];
+
+/*  While a phase runs: when it began and how many
+    begins it is inside (a phase may be entered again
+    from within itself, only the outermost counts). */
+static Dwarf_Unsigned stats_wall_start[STATS_PHASE_COUNT];
+static Dwarf_Unsigned stats_cpu_start[STATS_PHASE_COUNT];
+static unsigned       stats_running[STATS_PHASE_COUNT];
+
+/*  Enough for the DW_DLA types and for the DWARF
+    sections libdwarf keeps (DWARF_MAX_DEBUG_SECTIONS). */
+#define STATS_ALLOC_TYPES 128
+#define STATS_SECTIONS    128
+
+struct stats_alloc_s {
+    Dwarf_Unsigned sa_count;
+    Dwarf_Unsigned sa_bytes;
+    Dwarf_Unsigned sa_freed;
+};
+struct stats_section_s {
+    Dwarf_Unsigned ss_read;
+    Dwarf_Unsigned ss_decompressed;
+    Dwarf_Unsigned ss_reloc;
+};
+
+/*  What merged workers added. */
+static struct stats_alloc_s   stats_alloc_added[STATS_ALLOC_TYPES];
+static struct stats_section_s stats_section_added[STATS_SECTIONS];
+
+/*  In a worker: the counts when it began. */
+static struct stats_alloc_s   stats_alloc_base[STATS_ALLOC_TYPES];
+static struct stats_section_s stats_section_base[STATS_SECTIONS];
+static Dwarf_Unsigned         stats_worker_cpu_start;
+
+static const struct stats_dla_name_s {
+    unsigned    dn_type;
+    const char *dn_name;
+} stats_dla_names[] = {
+    {DW_DLA_STRING,          "DW_DLA_STRING"},
+    {DW_DLA_LOC,             "DW_DLA_LOC"},
+    {DW_DLA_LOCDESC,         "DW_DLA_LOCDESC"},
+    {DW_DLA_BLOCK,           "DW_DLA_BLOCK"},
+    {DW_DLA_DIE,             "DW_DLA_DIE"},
+    {DW_DLA_LINE,            "DW_DLA_LINE"},
+    {DW_DLA_ATTR,            "DW_DLA_ATTR"},
+    {DW_DLA_GLOBAL,          "DW_DLA_GLOBAL"},
+    {DW_DLA_ERROR,           "DW_DLA_ERROR"},
+    {DW_DLA_LIST,            "DW_DLA_LIST"},
+    {DW_DLA_ARANGE,          "DW_DLA_ARANGE"},
+    {DW_DLA_ABBREV,          "DW_DLA_ABBREV"},
+    {DW_DLA_FRAME_INSTR_HEAD,"DW_DLA_FRAME_INSTR_HEAD"},
+    {DW_DLA_CIE,             "DW_DLA_CIE"},
+    {DW_DLA_FDE,             "DW_DLA_FDE"},
+    {DW_DLA_LOC_BLOCK,       "DW_DLA_LOC_BLOCK"},
+    {DW_DLA_FUNC,            "DW_DLA_FUNC"},
+    {DW_DLA_TYPENAME,        "DW_DLA_TYPENAME"},
+    {DW_DLA_VAR,             "DW_DLA_VAR"},
+    {DW_DLA_WEAK,            "DW_DLA_WEAK"},
+    {DW_DLA_ADDR,            "DW_DLA_ADDR"},
+    {DW_DLA_RANGES,          "DW_DLA_RANGES"},
+    /*  Types internal to libdwarf, numbered as in
+        its dwarf_base_types.h. */
+    {0x1e,                   "DW_DLA_ABBREV_LIST"},
+    {0x1f,                   "DW_DLA_CHAIN"},
+    {0x20,                   "DW_DLA_CU_CONTEXT"},
+    {0x21,                   "DW_DLA_FRAME"},
+    {0x22,                   "DW_DLA_GLOBAL_CONTEXT"},
+    {0x23,                   "DW_DLA_FILE_ENTRY"},
+    {0x24,                   "DW_DLA_LINE_CONTEXT"},
+    {0x25,                   "DW_DLA_LOC_CHAIN"},
+    {0x26,                   "DW_DLA_HASH_TABLE"},
+    {0x27,                   "DW_DLA_FUNC_CONTEXT"},
+    {0x28,                   "DW_DLA_TYPENAME_CONTEXT"},
+    {0x29,                   "DW_DLA_VAR_CONTEXT"},
+    {0x2a,                   "DW_DLA_WEAK_CONTEXT"},
+    {0x2b,                   "DW_DLA_PUBTYPES_CONTEXT"},
+    {0x2c,                   "DW_DLA_HASH_TABLE_ENTRY"},
+    {0x2d,                   "DW_DLA_FISSION_PERCU"},
+    {0x3d,                   "DW_DLA_CHAIN_2"},
+    {DW_DLA_GNU_INDEX_HEAD,  "DW_DLA_GNU_INDEX_HEAD"},
+    {DW_DLA_RNGLISTS_HEAD,   "DW_DLA_RNGLISTS_HEAD"},
+    {DW_DLA_GDBINDEX,        "DW_DLA_GDBINDEX"},
+    {DW_DLA_XU_INDEX,        "DW_DLA_XU_INDEX"},
+    {DW_DLA_LOC_BLOCK_C,     "DW_DLA_LOC_BLOCK_C"},
+    {DW_DLA_LOCDESC_C,       "DW_DLA_LOCDESC_C"},
+    {DW_DLA_LOC_HEAD_C,      "DW_DLA_LOC_HEAD_C"},
+    {DW_DLA_MACRO_CONTEXT,   "DW_DLA_MACRO_CONTEXT"},
+    {DW_DLA_DSC_HEAD,        "DW_DLA_DSC_HEAD"},
+    {DW_DLA_DNAMES_HEAD,     "DW_DLA_DNAMES_HEAD"},
+    {DW_DLA_STR_OFFSETS,     "DW_DLA_STR_OFFSETS"},
+    {DW_DLA_DEBUG_ADDR,      "DW_DLA_DEBUG_ADDR"},
+    {DW_DLA_EXPR_PROGRAM,    "DW_DLA_EXPR_PROGRAM"},
+    {0,0}
+};
+
+static Dwarf_Unsigned
+cpu_usec(void)
+{
+    clock_t c = clock();
+
+    if (c == (clock_t)-1) {
+        return 0;
+    }
+    return (Dwarf_Unsigned)((double)c*1000000.0/CLOCKS_PER_SEC);
+}
+
+static Dwarf_Unsigned
+wall_usec(void)
+{
+#ifdef DD_HAVE_GETTIMEOFDAY
+    struct timeval tv;
+
+    if (gettimeofday(&tv,0)) {
+        return 0;
+    }
+    return (Dwarf_Unsigned)tv.tv_sec*1000000 +
+        (Dwarf_Unsigned)tv.tv_usec;
+#else /* !DD_HAVE_GETTIMEOFDAY */
+    return (Dwarf_Unsigned)time(0)*1000000;
+#endif /* DD_HAVE_GETTIMEOFDAY */
+}
+
+void
+stats_phase_begin(enum stats_phase_e phase)
+{
+    if (!glflags.gf_stats || phase >= STATS_PHASE_COUNT) {
+        return;
+    }
+    if (stats_running[phase]++) {
+        return;
+    }
+    stats_wall_start[phase] = wall_usec();
+    stats_cpu_start[phase] = cpu_usec();
+}
+
+void
+stats_phase_end(enum stats_phase_e phase)
+{
+    struct stats_phase_s *p = 0;
+    Dwarf_Unsigned wall = 0;
+    Dwarf_Unsigned cpu = 0;
+
+    if (!glflags.gf_stats || phase >= STATS_PHASE_COUNT ||
+        !stats_running[phase]) {
+        return;
+    }
+    if (--stats_running[phase]) {
+        return;
+    }
+    wall = wall_usec();
+    cpu = cpu_usec();
+    p = &stats_phases[phase];
+    p->sp_calls++;
+    if (wall > stats_wall_start[phase]) {
+        p->sp_wall += wall - stats_wall_start[phase];
+    }
+    if (cpu > stats_cpu_start[phase]) {
+        p->sp_cpu += cpu - stats_cpu_start[phase];
+    }
+}
+
+static const char *
+dla_name(unsigned type)
+{
+    const struct stats_dla_name_s *n = stats_dla_names;
+
+    for ( ; n->dn_name; ++n) {
+        if (n->dn_type == type) {
+            return n->dn_name;
+        }
+    }
+    return 0;
+}
+
+/*  libdwarf's counts now, less what a worker began
+    with (base, if not NULL), plus what merged
+    workers added (added, if not NULL). */
+static void
+take_lib_counts(Dwarf_Debug dbg,
+    struct stats_alloc_s *alloc,
+    struct stats_section_s *sections,
+    struct stats_alloc_s *base_alloc,
+    struct stats_section_s *base_sections)
+{
+    unsigned i = 0;
+
+    memset(alloc,0,STATS_ALLOC_TYPES*sizeof(*alloc));
+    memset(sections,0,STATS_SECTIONS*sizeof(*sections));
+    for (i = 1; i < STATS_ALLOC_TYPES; ++i) {
+        struct stats_alloc_s *a = &alloc[i];
+
+        if (dwarf_get_alloc_stats(dbg,i,&a->sa_count,
+            &a->sa_bytes,&a->sa_freed) != DW_DLV_OK) {
+            break;
+        }
+        if (base_alloc) {
+            a->sa_count -= base_alloc[i].sa_count;
+            a->sa_bytes -= base_alloc[i].sa_bytes;
+            a->sa_freed -= base_alloc[i].sa_freed;
+        }
+    }
+    for (i = 0; i < STATS_SECTIONS; ++i) {
+        struct stats_section_s *s = &sections[i];
+
+        if (dwarf_get_section_load_stats(dbg,i,0,&s->ss_read,
+            &s->ss_decompressed,&s->ss_reloc) != DW_DLV_OK) {
+            break;
+        }
+        if (base_sections) {
+            s->ss_read -= base_sections[i].ss_read;
+            s->ss_decompressed -= base_sections[i].ss_decompressed;
+            s->ss_reloc -= base_sections[i].ss_reloc;
+        }
+    }
+}
+
+static void
+print_phases(struct esb_s *json)
+{
+    unsigned i = 0;
+
+    if (!glflags.gf_json_output) {
+        printf("\n*** STATISTICS ***\n");
+        printf("%-28s %8s %14s %14s\n","phase","calls",
+            "wall(s)","cpu(s)");
+    }
+    for (i = 0; i < STATS_PHASE_COUNT; ++i) {
+        struct stats_phase_s *p = &stats_phases[i];
+
+        if (!p->sp_calls) {
+            continue;
+        }
+        if (glflags.gf_json_output) {
+            dd_json_begin(json,"stats_phase");
+            dd_json_string(json,"phase",stats_phase_names[i]);
+            dd_json_unsigned(json,"calls",p->sp_calls);
+            dd_json_unsigned(json,"wall_usec",p->sp_wall);
+            dd_json_unsigned(json,"cpu_usec",p->sp_cpu);
+            dd_json_end(json);
+            continue;
+        }
+        printf("%-28s %8" DW_PR_DUu " %14.6f %14.6f\n",
+            stats_phase_names[i],p->sp_calls,
+            (double)p->sp_wall/1000000.0,
+            (double)p->sp_cpu/1000000.0);
+    }
+}
+
+static void
+print_section_loads(Dwarf_Debug dbg, struct esb_s *json,
+    struct stats_section_s *sections)
+{
+    unsigned i = 0;
+    Dwarf_Unsigned total_read = 0;
+
+    if (!glflags.gf_json_output) {
+        printf("\n%-28s %14s %14s %14s\n","section",
+            "bytes read","decompressed","reloc bytes");
+    }
+    for (i = 0; i < STATS_SECTIONS; ++i) {
+        struct stats_section_s *s = &sections[i];
+        const char *name = 0;
+
+        if (dwarf_get_section_load_stats(dbg,i,&name,
+            0,0,0) != DW_DLV_OK) {
+            break;
+        }
+        s->ss_read += stats_section_added[i].ss_read;
+        s->ss_decompressed += stats_section_added[i].ss_decompressed;
+        s->ss_reloc += stats_section_added[i].ss_reloc;
+        if (!s->ss_read) {
+            continue;
+        }
+        total_read += s->ss_read;
+        if (glflags.gf_json_output) {
+            dd_json_begin(json,"stats_section");
+            dd_json_string(json,"section",name);
+            dd_json_unsigned(json,"bytes_read",s->ss_read);
+            dd_json_unsigned(json,"bytes_decompressed",
+                s->ss_decompressed);
+            dd_json_unsigned(json,"reloc_bytes",s->ss_reloc);
+            dd_json_end(json);
+            continue;
+        }
+        printf("%-28s %14" DW_PR_DUu " %14" DW_PR_DUu
+            " %14" DW_PR_DUu "\n",
+            sanitized(name),s->ss_read,s->ss_decompressed,
+            s->ss_reloc);
+    }
+    if (!glflags.gf_json_output) {
+        printf("%-28s %14" DW_PR_DUu "\n","total",total_read);
+    }
+}
+
+static void
+print_allocations(struct esb_s *json,
+    struct stats_alloc_s *alloc)
+{
+    unsigned i = 0;
+    struct stats_alloc_s total;
+    struct esb_s namebuf;
+
+    memset(&total,0,sizeof(total));
+    esb_constructor(&namebuf);
+    if (!glflags.gf_json_output) {
+        printf("\n%-28s %14s %14s %14s\n","allocation type",
+            "count","bytes","freed");
+    }
+    for (i = 1; i < STATS_ALLOC_TYPES; ++i) {
+        struct stats_alloc_s *a = &alloc[i];
+        const char *name = 0;
+
+        a->sa_count += stats_alloc_added[i].sa_count;
+        a->sa_bytes += stats_alloc_added[i].sa_bytes;
+        a->sa_freed += stats_alloc_added[i].sa_freed;
+        if (!a->sa_count) {
+            continue;
+        }
+        total.sa_count += a->sa_count;
+        total.sa_bytes += a->sa_bytes;
+        total.sa_freed += a->sa_freed;
+        name = dla_name(i);
+        if (!name) {
+            /*  A type newer than this table. */
+            esb_empty_string(&namebuf);
+            esb_append_printf_u(&namebuf,"DW_DLA 0x%" DW_PR_DUx,i);
+            name = esb_get_string(&namebuf);
+        }
+        if (glflags.gf_json_output) {
+            dd_json_begin(json,"stats_alloc");
+            dd_json_string(json,"type",name);
+            dd_json_unsigned(json,"count",a->sa_count);
+            dd_json_unsigned(json,"bytes",a->sa_bytes);
+            dd_json_unsigned(json,"freed",a->sa_freed);
+            dd_json_end(json);
+            continue;
+        }
+        printf("%-28s %14" DW_PR_DUu " %14" DW_PR_DUu
+            " %14" DW_PR_DUu "\n",
+            name,a->sa_count,a->sa_bytes,a->sa_freed);
+    }
+    if (!glflags.gf_json_output) {
+        printf("%-28s %14" DW_PR_DUu " %14" DW_PR_DUu
+            " %14" DW_PR_DUu "\n","total",
+            total.sa_count,total.sa_bytes,total.sa_freed);
+    }
+    esb_destructor(&namebuf);
+}
+
+void
+print_stats(Dwarf_Debug dbg)
+{
+    struct esb_s json;
+    struct stats_alloc_s   alloc[STATS_ALLOC_TYPES];
+    struct stats_section_s sections[STATS_SECTIONS];
+
+    if (!glflags.gf_stats) {
+        return;
+    }
+    esb_constructor(&json);
+    take_lib_counts(dbg,alloc,sections,0,0);
+    print_phases(&json);
+    print_section_loads(dbg,&json,sections);
+    print_allocations(&json,alloc);
+    esb_destructor(&json);
+}
+
+void
+stats_worker_begin(Dwarf_Debug dbg)
+{
+    struct stats_alloc_s   alloc[STATS_ALLOC_TYPES];
+    struct stats_section_s sections[STATS_SECTIONS];
+
+    if (!glflags.gf_stats) {
+        return;
+    }
+    memset(stats_phases,0,sizeof(stats_phases));
+    take_lib_counts(dbg,alloc,sections,0,0);
+    memcpy(stats_alloc_base,alloc,sizeof(stats_alloc_base));
+    memcpy(stats_section_base,sections,sizeof(stats_section_base));
+    stats_worker_cpu_start = cpu_usec();
+}
+
+int
+stats_worker_write(Dwarf_Debug dbg, FILE *f)
+{
+    struct stats_alloc_s   alloc[STATS_ALLOC_TYPES];
+    struct stats_section_s sections[STATS_SECTIONS];
+    Dwarf_Unsigned cpu = 0;
+    int res = 0;
+
+    if (!glflags.gf_stats) {
+        return DW_DLV_OK;
+    }
+    cpu = cpu_usec() - stats_worker_cpu_start;
+    take_lib_counts(dbg,alloc,sections,
+        stats_alloc_base,stats_section_base);
+    res = dd_report_write(f,stats_phases,sizeof(stats_phases));
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&cpu,sizeof(cpu));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,alloc,sizeof(alloc));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,sections,sizeof(sections));
+    }
+    return res;
+}
+
+int
+stats_worker_merge(FILE *f)
+{
+    struct stats_phase_s   phases[STATS_PHASE_COUNT];
+    struct stats_alloc_s   alloc[STATS_ALLOC_TYPES];
+    struct stats_section_s sections[STATS_SECTIONS];
+    Dwarf_Unsigned cpu = 0;
+    unsigned i = 0;
+    int res = 0;
+
+    if (!glflags.gf_stats) {
+        return DW_DLV_OK;
+    }
+    res = dd_report_read(f,phases,sizeof(phases));
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&cpu,sizeof(cpu));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,alloc,sizeof(alloc));
+    }
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,sections,sizeof(sections));
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    for (i = 0; i < STATS_PHASE_COUNT; ++i) {
+        stats_phases[i].sp_calls += phases[i].sp_calls;
+        stats_phases[i].sp_wall += phases[i].sp_wall;
+        stats_phases[i].sp_cpu += phases[i].sp_cpu;
+        if (stats_running[i]) {
+            /*  The worker ran inside this phase. */
+            stats_phases[i].sp_cpu += cpu;
+        }
+    }
+    for (i = 0; i < STATS_ALLOC_TYPES; ++i) {
+        stats_alloc_added[i].sa_count += alloc[i].sa_count;
+        stats_alloc_added[i].sa_bytes += alloc[i].sa_bytes;
+        stats_alloc_added[i].sa_freed += alloc[i].sa_freed;
+    }
+    for (i = 0; i < STATS_SECTIONS; ++i) {
+        stats_section_added[i].ss_read += sections[i].ss_read;
+        stats_section_added[i].ss_decompressed +=
+            sections[i].ss_decompressed;
+        stats_section_added[i].ss_reloc += sections[i].ss_reloc;
+    }
+    return DW_DLV_OK;
+}
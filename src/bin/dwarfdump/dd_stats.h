@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef DD_STATS_H
+#define DD_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*  --stats: wall and CPU time by printing phase,
+    and what libdwarf read and allocated for the run
+    (see dwarf_get_section_load_stats() and
+    dwarf_get_alloc_stats()).
+    A phase may run inside another (lines and macros
+    are printed from print_infos) so the times do
+    not add up to the whole. */
+enum stats_phase_e {
+    STATS_OPEN = 0,
+    STATS_CHECK_SETUP,
+    STATS_SECTION_GROUPS,
+    STATS_JSON,
+    STATS_INFOS,
+    STATS_LINES,
+    STATS_MACROS,
+    STATS_GDB_INDEX,
+    STATS_PUBNAMES,
+    STATS_DEBUG_ADDR,
+    STATS_ABBREVS,
+    STATS_STRINGS,
+    STATS_ARANGES,
+    STATS_RANGES,
+    STATS_RAW_LOCLISTS,
+    STATS_RAW_RNGLISTS,
+    STATS_FRAMES,
+    STATS_STATIC_FUNCS,
+    STATS_STATIC_VARS,
+    STATS_TYPES,
+    STATS_WEAKNAMES,
+    STATS_DEBUG_NAMES,
+    STATS_SIZE_REPORT,
+    STATS_STR_OFFSETS,
+    STATS_DEBUG_GNU,
+    STATS_DEBUG_SUP,
+    STATS_PHASE_COUNT
+};
+
+/*  Both do nothing unless --stats was given. */
+void stats_phase_begin(enum stats_phase_e phase);
+void stats_phase_end(enum stats_phase_e phase);
+
+/*  Prints the phases, then the section loads and
+    allocations of dbg (as JSON records with
+    --format=json). Call before dwarf_finish(). */
+void print_stats(Dwarf_Debug dbg);
+
+/*  --threads=<n>: a worker starts its phase and
+    libdwarf counts from zero, writes what it added
+    and this process adds that to its own totals.
+    The worker's CPU time is also added to the
+    phases still running here. */
+void stats_worker_begin(Dwarf_Debug dbg);
+int  stats_worker_write(Dwarf_Debug dbg, FILE *f);
+int  stats_worker_merge(FILE *f);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* DD_STATS_H */
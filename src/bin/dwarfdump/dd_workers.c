@@ -0,0 +1,692 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  --threads=<n> support.
+    dwarfdump keeps a great deal of state in globals
+    and a Dwarf_Debug is not thread safe, so the workers
+    are processes: each fork()ed worker has its own
+    copy of every global and of the Dwarf_Debug, writes
+    its output to an unlinked temporary file and a report
+    of what it added to the totals printed at the end
+    (counters, check results per compiler, usage
+    statistics, --size-report totals, libdwarf harmless
+    errors) to another.
+    The last worker runs in this process after the others
+    are merged, so whatever the last CU leaves behind for
+    later sections is just what a serial run leaves.
+    Without fork() (Windows) the workers simply run
+    in turn here. */
+
+#include <config.h>
+
+#include <stdio.h>  /* fflush() fread() fwrite() tmpfile() */
+#include <stdlib.h> /* calloc() free() malloc() */
+#include <string.h> /* memcpy() memset() strlen() */
+
+#if defined(HAVE_UNISTD_H) && !defined(_WIN32)
+#define DD_HAVE_WORKERS 1
+#include <sys/types.h> /* pid_t */
+#include <sys/wait.h>  /* waitpid() */
+#include <signal.h>    /* kill() SIGKILL */
+#include <unistd.h>    /* dup2() fork() */
+#endif /* HAVE_UNISTD_H && !_WIN32 */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h"
+#include "dd_globals.h"
+#include "dd_compiler_info.h"
+#include "dd_attr_form.h"
+#include "dd_macrocheck.h"
+#include "dd_size_report.h"
+#include "dd_stats.h"
+#include "dd_workers.h"
+
+/*  What a worker sends back first: its return code and
+    how much it added to each counter. */
+struct dd_worker_report_s {
+    int           wr_res;
+    unsigned long wr_major_errors;
+    unsigned long wr_macronotes;
+    int           wr_search_occurrences;
+    int           wr_check_error;
+};
+
+static void
+take_counts(struct dd_worker_report_s *r)
+{
+    r->wr_major_errors = glflags.gf_count_major_errors;
+    r->wr_macronotes = glflags.gf_count_macronotes;
+    r->wr_search_occurrences = glflags.search_occurrences;
+    r->wr_check_error = glflags.check_error;
+}
+
+/*  What one CU leaves in glflags for the next:
+    the names and addresses error reports show. */
+struct dd_cu_context_s {
+    char       cc_PU_name[COMPILE_UNIT_NAME_LEN];
+    char       cc_CU_name[COMPILE_UNIT_NAME_LEN];
+    char       cc_CU_producer[COMPILE_UNIT_NAME_LEN];
+    Dwarf_Bool cc_seen_PU;
+    Dwarf_Bool cc_seen_CU;
+    Dwarf_Bool cc_need_CU_name;
+    Dwarf_Bool cc_need_CU_base_address;
+    Dwarf_Bool cc_need_CU_high_address;
+    Dwarf_Bool cc_need_PU_valid_code;
+    Dwarf_Bool cc_in_valid_code;
+    Dwarf_Bool cc_seen_PU_base_address;
+    Dwarf_Bool cc_seen_PU_high_address;
+    Dwarf_Addr cc_PU_base_address;
+    Dwarf_Addr cc_PU_high_address;
+    Dwarf_Off  cc_DIE_offset;
+    Dwarf_Off  cc_DIE_overall_offset;
+    Dwarf_Off  cc_DIE_CU_offset;
+    Dwarf_Off  cc_DIE_CU_overall_offset;
+    Dwarf_Addr cc_CU_base_address;
+    Dwarf_Addr cc_CU_low_address;
+    Dwarf_Addr cc_CU_high_address;
+};
+
+#ifdef DD_HAVE_WORKERS
+static void
+take_cu_context(struct dd_cu_context_s *c)
+{
+    memcpy(c->cc_PU_name,glflags.PU_name,sizeof(c->cc_PU_name));
+    memcpy(c->cc_CU_name,glflags.CU_name,sizeof(c->cc_CU_name));
+    memcpy(c->cc_CU_producer,glflags.CU_producer,
+        sizeof(c->cc_CU_producer));
+    c->cc_seen_PU = glflags.seen_PU;
+    c->cc_seen_CU = glflags.seen_CU;
+    c->cc_need_CU_name = glflags.need_CU_name;
+    c->cc_need_CU_base_address = glflags.need_CU_base_address;
+    c->cc_need_CU_high_address = glflags.need_CU_high_address;
+    c->cc_need_PU_valid_code = glflags.need_PU_valid_code;
+    c->cc_in_valid_code = glflags.in_valid_code;
+    c->cc_seen_PU_base_address = glflags.seen_PU_base_address;
+    c->cc_seen_PU_high_address = glflags.seen_PU_high_address;
+    c->cc_PU_base_address = glflags.PU_base_address;
+    c->cc_PU_high_address = glflags.PU_high_address;
+    c->cc_DIE_offset = glflags.DIE_offset;
+    c->cc_DIE_overall_offset = glflags.DIE_overall_offset;
+    c->cc_DIE_CU_offset = glflags.DIE_CU_offset;
+    c->cc_DIE_CU_overall_offset = glflags.DIE_CU_overall_offset;
+    c->cc_CU_base_address = glflags.CU_base_address;
+    c->cc_CU_low_address = glflags.CU_low_address;
+    c->cc_CU_high_address = glflags.CU_high_address;
+}
+
+static void
+put_cu_context(struct dd_cu_context_s *c)
+{
+    memcpy(glflags.PU_name,c->cc_PU_name,sizeof(c->cc_PU_name));
+    memcpy(glflags.CU_name,c->cc_CU_name,sizeof(c->cc_CU_name));
+    memcpy(glflags.CU_producer,c->cc_CU_producer,
+        sizeof(c->cc_CU_producer));
+    glflags.seen_PU = c->cc_seen_PU;
+    glflags.seen_CU = c->cc_seen_CU;
+    glflags.need_CU_name = c->cc_need_CU_name;
+    glflags.need_CU_base_address = c->cc_need_CU_base_address;
+    glflags.need_CU_high_address = c->cc_need_CU_high_address;
+    glflags.need_PU_valid_code = c->cc_need_PU_valid_code;
+    glflags.in_valid_code = c->cc_in_valid_code;
+    glflags.seen_PU_base_address = c->cc_seen_PU_base_address;
+    glflags.seen_PU_high_address = c->cc_seen_PU_high_address;
+    glflags.PU_base_address = c->cc_PU_base_address;
+    glflags.PU_high_address = c->cc_PU_high_address;
+    glflags.DIE_offset = c->cc_DIE_offset;
+    glflags.DIE_overall_offset = c->cc_DIE_overall_offset;
+    glflags.DIE_CU_offset = c->cc_DIE_CU_offset;
+    glflags.DIE_CU_overall_offset = c->cc_DIE_CU_overall_offset;
+    glflags.CU_base_address = c->cc_CU_base_address;
+    glflags.CU_low_address = c->cc_CU_low_address;
+    glflags.CU_high_address = c->cc_CU_high_address;
+}
+#endif /* DD_HAVE_WORKERS */
+
+int
+dd_report_write(FILE *f, const void *p, size_t len)
+{
+    if (len && fwrite(p,1,len,f) != len) {
+        return DW_DLV_ERROR;
+    }
+    return DW_DLV_OK;
+}
+
+int
+dd_report_read(FILE *f, void *p, size_t len)
+{
+    if (len && fread(p,1,len,f) != len) {
+        return DW_DLV_ERROR;
+    }
+    return DW_DLV_OK;
+}
+
+int
+dd_report_write_string(FILE *f, const char *s)
+{
+    size_t len = s? strlen(s)+1 : 0;
+    int res = 0;
+
+    res = dd_report_write(f,&len,sizeof(len));
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    return dd_report_write(f,s,len);
+}
+
+int
+dd_report_read_string(FILE *f, char **s_out)
+{
+    size_t len = 0;
+    char  *s = 0;
+    int    res = 0;
+
+    res = dd_report_read(f,&len,sizeof(len));
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    if (!len) {
+        *s_out = 0;
+        return DW_DLV_OK;
+    }
+    s = (char *)malloc(len);
+    if (!s) {
+        return DW_DLV_ERROR;
+    }
+    res = dd_report_read(f,s,len);
+    if (res != DW_DLV_OK || s[len-1]) {
+        free(s);
+        return DW_DLV_ERROR;
+    }
+    *s_out = s;
+    return DW_DLV_OK;
+}
+
+/*  libdwarf keeps the latest harmless errors (and a count
+    of all of them) in the Dwarf_Debug.
+    Reading the list empties it, so a worker takes
+    what was there before it started and puts that back,
+    followed by its own, when it is done. */
+struct dd_harmless_s {
+    unsigned  hl_total; /* All the harmless errors seen */
+    unsigned  hl_count; /* The latest ones, kept in hl_msgs */
+    char    **hl_msgs;
+};
+
+static void
+free_harmless(struct dd_harmless_s *h)
+{
+    unsigned i = 0;
+
+    for (i = 0; i < h->hl_count; ++i) {
+        free(h->hl_msgs[i]);
+    }
+    free(h->hl_msgs);
+    memset(h,0,sizeof(*h));
+}
+
+static void
+take_harmless(Dwarf_Debug dbg, struct dd_harmless_s *h)
+{
+    unsigned size = dwarf_set_harmless_error_list_size(dbg,0);
+    const char **buf = 0;
+    unsigned i = 0;
+    int res = 0;
+
+    memset(h,0,sizeof(*h));
+    buf = (const char **)calloc(size+1,sizeof(char *));
+    h->hl_msgs = (char **)calloc(size+1,sizeof(char *));
+    if (!buf || !h->hl_msgs) {
+        /*  Keep just the count. */
+        free(buf);
+        free(h->hl_msgs);
+        h->hl_msgs = 0;
+        dwarf_get_harmless_error_list(dbg,0,0,&h->hl_total);
+        return;
+    }
+    res = dwarf_get_harmless_error_list(dbg,size+1,buf,
+        &h->hl_total);
+    if (res == DW_DLV_OK) {
+        for (i = 0; buf[i]; ++i) {
+            size_t len = strlen(buf[i])+1;
+            char  *m = (char *)malloc(len);
+
+            if (!m) {
+                break;
+            }
+            memcpy(m,buf[i],len);
+            h->hl_msgs[h->hl_count++] = m;
+        }
+    }
+    free(buf);
+}
+
+/*  Inserting placeholders for errors whose message was
+    already dropped keeps the total right; they are
+    dropped again as the messages follow. */
+static void
+put_harmless(Dwarf_Debug dbg, struct dd_harmless_s *h)
+{
+    char     empty[1];
+    unsigned i = 0;
+
+    empty[0] = 0;
+    for (i = h->hl_count; i < h->hl_total; ++i) {
+        dwarf_insert_harmless_error(dbg,empty);
+    }
+    for (i = 0; i < h->hl_count; ++i) {
+        dwarf_insert_harmless_error(dbg,h->hl_msgs[i]);
+    }
+}
+
+void
+dd_worker_range_begins(Dwarf_Debug dbg)
+{
+    dwarf_get_harmless_error_list(dbg,0,0,0);
+}
+
+/*  Runs a worker in this process. */
+static int
+run_here(Dwarf_Debug dbg, unsigned worker,
+    dd_worker_func func, void *arg, Dwarf_Error *err)
+{
+    struct dd_harmless_s before;
+    struct dd_harmless_s during;
+    int res = 0;
+
+    take_harmless(dbg,&before);
+    res = func(arg,worker,err);
+    take_harmless(dbg,&during);
+    put_harmless(dbg,&before);
+    put_harmless(dbg,&during);
+    free_harmless(&before);
+    free_harmless(&during);
+    return res;
+}
+
+#ifdef DD_HAVE_WORKERS
+/*  In the worker: start every total from zero so what
+    it has at the end is what it added. */
+static void
+begin_report(Dwarf_Debug dbg)
+{
+    dwarf_get_harmless_error_list(dbg,0,0,0);
+    compilers_worker_begin();
+    tag_usage_worker_begin();
+    attributes_encoding_worker_begin();
+    attr_form_worker_begin();
+    macrocheck_worker_begin();
+    size_report_worker_begin();
+    stats_worker_begin(dbg);
+}
+
+static int
+write_report(Dwarf_Debug dbg, FILE *f)
+{
+    struct dd_cu_context_s c;
+    struct dd_harmless_s h;
+    unsigned i = 0;
+    int res = 0;
+
+    take_cu_context(&c);
+    res = dd_report_write(f,&c,sizeof(c));
+    if (res == DW_DLV_OK) {
+        res = compilers_worker_write(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = tag_usage_worker_write(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = attributes_encoding_worker_write(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = attr_form_worker_write(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = macrocheck_worker_write(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = size_report_worker_write(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = stats_worker_write(dbg,f);
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    take_harmless(dbg,&h);
+    res = dd_report_write(f,&h.hl_total,sizeof(h.hl_total));
+    if (res == DW_DLV_OK) {
+        res = dd_report_write(f,&h.hl_count,sizeof(h.hl_count));
+    }
+    for (i = 0; res == DW_DLV_OK && i < h.hl_count; ++i) {
+        res = dd_report_write_string(f,h.hl_msgs[i]);
+    }
+    free_harmless(&h);
+    return res;
+}
+
+static int
+merge_report(Dwarf_Debug dbg, FILE *f)
+{
+    struct dd_cu_context_s c;
+    struct dd_harmless_s h;
+    unsigned count = 0;
+    int res = 0;
+
+    res = dd_report_read(f,&c,sizeof(c));
+    if (res == DW_DLV_OK) {
+        put_cu_context(&c);
+        res = compilers_worker_merge(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = tag_usage_worker_merge(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = attributes_encoding_worker_merge(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = attr_form_worker_merge(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = macrocheck_worker_merge(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = size_report_worker_merge(f);
+    }
+    if (res == DW_DLV_OK) {
+        res = stats_worker_merge(f);
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    memset(&h,0,sizeof(h));
+    res = dd_report_read(f,&h.hl_total,sizeof(h.hl_total));
+    if (res == DW_DLV_OK) {
+        res = dd_report_read(f,&count,sizeof(count));
+    }
+    if (res == DW_DLV_OK && count) {
+        h.hl_msgs = (char **)calloc(count,sizeof(char *));
+        if (!h.hl_msgs) {
+            res = DW_DLV_ERROR;
+        }
+    }
+    for ( ; res == DW_DLV_OK && h.hl_count < count;
+        ++h.hl_count) {
+        res = dd_report_read_string(f,&h.hl_msgs[h.hl_count]);
+    }
+    if (res == DW_DLV_OK) {
+        put_harmless(dbg,&h);
+    }
+    free_harmless(&h);
+    return res;
+}
+
+struct dd_worker_s {
+    pid_t  w_pid;      /* 0 if not started */
+    FILE  *w_out;      /* the worker's stdout */
+    FILE  *w_report;   /* what it adds to the totals */
+};
+
+static void
+close_worker(struct dd_worker_s *w)
+{
+    if (w->w_pid > 0) {
+        int status = 0;
+
+        kill(w->w_pid,SIGKILL);
+        waitpid(w->w_pid,&status,0);
+    }
+    w->w_pid = 0;
+    if (w->w_out) {
+        fclose(w->w_out);
+        w->w_out = 0;
+    }
+    if (w->w_report) {
+        fclose(w->w_report);
+        w->w_report = 0;
+    }
+}
+
+/*  Does not return in the child. */
+static void
+run_child(Dwarf_Debug dbg, struct dd_worker_s *w,
+    unsigned worker, dd_worker_func func,
+    dd_worker_func warmup, void *arg)
+{
+    struct dd_worker_report_s before;
+    struct dd_worker_report_s after;
+    Dwarf_Error err = 0;
+
+    if (warmup && worker) {
+        FILE *discard = fopen("/dev/null","w");
+
+        if (!discard || dup2(fileno(discard),fileno(stdout)) < 0) {
+            _exit(1);
+        }
+        if (warmup(arg,worker,&err) == DW_DLV_ERROR ||
+            fflush(stdout)) {
+            _exit(1);
+        }
+    }
+    if (dup2(fileno(w->w_out),fileno(stdout)) < 0) {
+        _exit(1);
+    }
+    take_counts(&before);
+    begin_report(dbg);
+    after.wr_res = func(arg,worker,&err);
+    if (fflush(stdout)) {
+        _exit(1);
+    }
+    take_counts(&after);
+    after.wr_major_errors -= before.wr_major_errors;
+    after.wr_macronotes -= before.wr_macronotes;
+    after.wr_search_occurrences -= before.wr_search_occurrences;
+    after.wr_check_error -= before.wr_check_error;
+    if (dd_report_write(w->w_report,&after,sizeof(after)) !=
+        DW_DLV_OK) {
+        _exit(1);
+    }
+    if (after.wr_res != DW_DLV_ERROR &&
+        write_report(dbg,w->w_report) != DW_DLV_OK) {
+        _exit(1);
+    }
+    if (fflush(w->w_report)) {
+        _exit(1);
+    }
+    _exit(0);
+}
+
+static void
+start_worker(Dwarf_Debug dbg, struct dd_worker_s *w,
+    unsigned worker, dd_worker_func func,
+    dd_worker_func warmup, void *arg)
+{
+    w->w_out = tmpfile();
+    w->w_report = tmpfile();
+    if (!w->w_out || !w->w_report) {
+        close_worker(w);
+        return;
+    }
+    w->w_pid = fork();
+    if (w->w_pid == 0) {
+        run_child(dbg,w,worker,func,warmup,arg);
+    }
+    if (w->w_pid < 0) {
+        w->w_pid = 0;
+        close_worker(w);
+    }
+}
+
+/*  Waits for a worker and, if it succeeded, copies
+    its output and merges its report.
+    Returns FALSE if the worker must be rerun here. */
+static Dwarf_Bool
+finish_worker(Dwarf_Debug dbg, struct dd_worker_s *w,
+    int *res_out)
+{
+    struct dd_worker_report_s r;
+    int    status = 0;
+    char   buf[16384];
+    size_t n = 0;
+
+    if (!w->w_pid) {
+        return FALSE;
+    }
+    if (waitpid(w->w_pid,&status,0) != w->w_pid) {
+        status = 1;
+    }
+    w->w_pid = 0;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) ||
+        fseek(w->w_report,0L,SEEK_SET) ||
+        dd_report_read(w->w_report,&r,sizeof(r)) != DW_DLV_OK ||
+        r.wr_res == DW_DLV_ERROR ||
+        fseek(w->w_out,0L,SEEK_SET)) {
+        close_worker(w);
+        return FALSE;
+    }
+    while ((n = fread(buf,1,sizeof(buf),w->w_out)) > 0) {
+        fwrite(buf,1,n,stdout);
+    }
+    glflags.gf_count_major_errors += r.wr_major_errors;
+    glflags.gf_count_macronotes += r.wr_macronotes;
+    glflags.search_occurrences += r.wr_search_occurrences;
+    glflags.check_error += r.wr_check_error;
+    if (merge_report(dbg,w->w_report) != DW_DLV_OK) {
+        printf("ERROR: could not read back the totals "
+            "from a --threads worker, "
+            "the summaries may be short\n");
+        glflags.gf_count_major_errors++;
+    }
+    *res_out = r.wr_res;
+    close_worker(w);
+    return TRUE;
+}
+#endif /* DD_HAVE_WORKERS */
+
+FILE *
+dd_probe_in_worker(dd_probe_func func, void *arg)
+{
+#ifdef DD_HAVE_WORKERS
+    FILE *out = 0;
+    pid_t pid = 0;
+    int status = 0;
+
+    out = tmpfile();
+    if (!out) {
+        return NULL;
+    }
+    pid = fork();
+    if (pid == 0) {
+        int res = func(arg,out);
+
+        if (res != DW_DLV_OK || fflush(out)) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    if (pid < 0 || waitpid(pid,&status,0) != pid ||
+        !WIFEXITED(status) || WEXITSTATUS(status) ||
+        fseek(out,0L,SEEK_SET)) {
+        fclose(out);
+        return NULL;
+    }
+    return out;
+#else
+    (void)func;
+    (void)arg;
+    return NULL;
+#endif /* DD_HAVE_WORKERS */
+}
+
+Dwarf_Bool
+dd_workers_available(void)
+{
+#ifdef DD_HAVE_WORKERS
+    return TRUE;
+#else
+    return FALSE;
+#endif /* DD_HAVE_WORKERS */
+}
+
+int
+dd_run_workers(Dwarf_Debug dbg, unsigned nworkers,
+    dd_worker_func func, dd_worker_func warmup,
+    void *arg, Dwarf_Error *err)
+{
+    int res = DW_DLV_NO_ENTRY;
+    unsigned i = 0;
+    unsigned last = nworkers? nworkers-1 : 0;
+#ifdef DD_HAVE_WORKERS
+    struct dd_worker_s *workers = 0;
+
+    if (last) {
+        workers = (struct dd_worker_s *)calloc(last,
+            sizeof(struct dd_worker_s));
+    }
+    if (workers) {
+        /*  Anything still buffered would be
+            written once by each worker too. */
+        fflush(stdout);
+        for (i = 0; i < last; ++i) {
+            start_worker(dbg,&workers[i],i,func,warmup,arg);
+        }
+        for (i = 0; i < last; ++i) {
+            if (finish_worker(dbg,&workers[i],&res)) {
+                continue;
+            }
+            res = run_here(dbg,i,func,arg,err);
+            if (res == DW_DLV_ERROR) {
+                break;
+            }
+        }
+        for ( ; i < last; ++i) {
+            close_worker(&workers[i]);
+        }
+        free(workers);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        return run_here(dbg,last,func,arg,err);
+    }
+#endif /* DD_HAVE_WORKERS */
+    /*  Run in turn, each worker finds what the one
+        before left behind. */
+    (void)warmup;
+    for (i = 0; i < nworkers; ++i) {
+        res = run_here(dbg,i,func,arg,err);
+        if (res == DW_DLV_ERROR) {
+            break;
+        }
+    }
+    return res;
+}
@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef DD_WORKERS_H
+#define DD_WORKERS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*  Prints the share of some output numbered worker
+    (0 to nworkers-1). Returns DW_DLV_OK, DW_DLV_NO_ENTRY
+    or DW_DLV_ERROR as the serial code would. */
+typedef int (*dd_worker_func)(void *arg, unsigned worker,
+    Dwarf_Error *err);
+
+/*  Runs func for each worker, all but the last in
+    forked processes where possible, and copies their
+    output to stdout in worker order, so the output is as
+    if the workers ran one after another in this process.
+    What the workers add to the counters in glflags, the
+    check results per compiler, the usage statistics
+    and libdwarf's harmless errors is merged into this
+    process, in worker order, before the last worker
+    runs here.
+    A worker that fails (or cannot be started)
+    is rerun here so errors are reported exactly
+    as a serial run reports them.
+    Returns the result of the last worker run, stopping
+    at the first DW_DLV_ERROR.
+    Every forked worker but the first runs warmup
+    (if not NULL) beforehand with its output and
+    additions discarded, so the state its share begins
+    with is (nearly always) what the worker before
+    leaves behind. The last worker instead takes the
+    CU names and addresses kept in glflags from the
+    worker before it. */
+int dd_run_workers(Dwarf_Debug dbg, unsigned nworkers,
+    dd_worker_func func, dd_worker_func warmup,
+    void *arg, Dwarf_Error *err);
+
+/*  A worker calls this on reaching its first CU:
+    the harmless errors libdwarf finds in the CU
+    headers it skipped belong to an earlier worker. */
+void dd_worker_range_begins(Dwarf_Debug dbg);
+
+/*  For the modules whose totals are merged: what one
+    writes in a worker it reads back, in the same order,
+    in the process merging the worker.
+    Each returns DW_DLV_OK or DW_DLV_ERROR.
+    dd_report_read_string() returns a malloc()ed string
+    (or NULL if a NULL was written). */
+int dd_report_write(FILE *f, const void *p, size_t len);
+int dd_report_read(FILE *f, void *p, size_t len);
+int dd_report_write_string(FILE *f, const char *s);
+int dd_report_read_string(FILE *f, char **s_out);
+
+/*  Runs func in a forked process, giving it an
+    unlinked temporary file to write what it finds to,
+    so nothing func does (such as moving libdwarf's
+    CU iteration) changes this process.
+    Returns that file rewound, or NULL if func did not
+    return DW_DLV_OK or there is no fork(). */
+typedef int (*dd_probe_func)(void *arg, FILE *out);
+FILE *dd_probe_in_worker(dd_probe_func func, void *arg);
+
+/*  TRUE if dd_run_workers() can use more than one
+    process in this build. */
+Dwarf_Bool dd_workers_available(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* DD_WORKERS_H */
@@ -82,6 +82,11 @@ Portions Copyright 2012 SN Systems Ltd. All rights reserved.
 #include "dd_compiler_info.h"
 #include "dd_safe_strcpy.h"
 #include "dd_minimal.h"
+#include "dd_output.h"
+#include "dd_size_report.h"
+#include "dd_section_bitmaps.h"
+#include "dd_stats.h"
+#include "dd_json.h"
 
 #ifndef O_RDONLY
 /*  This is for a Windows environment */
@@ -172,6 +177,8 @@ global_destructors(void)
     free_all_dwconf(glflags.config_file_data);
     sanitized_string_destructor();
     ranges_esb_string_destructor();
+    dwarf_set_section_filter(0);
+    load_map_destructor();
     close_a_file(global_basefd);
     close_a_file(global_tiedfd);
 #ifdef _WIN32
@@ -214,7 +221,8 @@ check_for_major_errors(void)
     long int ect = glflags.gf_count_major_errors;
     const char *w = "was";
     const char *e = "error";
-    if (!ect) {
+    if (!ect || glflags.gf_json_output) {
+        /*  With --format=json each has its error record. */
         return;
     }
     if (ect > 1) {
@@ -311,6 +319,9 @@ main(int argc, char *argv[])
     /* path_source will be DW_PATHSOURCE_basic  */
     unsigned char   path_source = DW_PATHSOURCE_unspecified;
 
+    /*  Before anything at all is written to stdout. */
+    dd_output_setup();
+
 #ifdef _WIN32
     /*  Open the null device used during formatting printing */
     if (!esb_open_null_device()) {
@@ -373,6 +384,7 @@ main(int argc, char *argv[])
             global_destructors();
             exit(EXIT_FAILURE);
         }
+        dd_output_setup();
         /* Record version and arguments in the output file */
         print_version_details(argv[0]);
         print_args(argc,argv);
@@ -386,6 +398,9 @@ main(int argc, char *argv[])
         wcmd.check_verbose_mode = glflags.gf_check_verbose_mode;
         dwarf_record_cmdline_options(wcmd);
     }
+    /*  Restrict the DWARF sections read to those
+        the options need. See select_load_map(). */
+    dwarf_set_section_filter(load_map_section_names());
 
     /* ======= BEGIN FINDING NAMES AND OPENING FDs ===== */
     /*  The 200+2 etc is more than suffices for the expansion that a
@@ -606,7 +621,7 @@ static void
 printf_callback_for_libdwarf(void *userdata UNUSEDARG,
     const char *data)
 {
-    printf("%s",sanitized(data));
+    dd_output_string(sanitized(data));
 }
 
 int
@@ -844,6 +859,7 @@ process_one_file(
         but in a dwp or separate-split-dwarf object then
         0 DW_GROUPNUMBER_ANY will find the .dwo data
         automatically. */
+    stats_phase_begin(STATS_OPEN);
     {
         /*  This will go for the real main file, whether
             an underlying dSYM or via debuglink or
@@ -864,6 +880,7 @@ process_one_file(
             &path_source,
             &onef_err);
     }
+    stats_phase_end(STATS_OPEN);
     if (dres == DW_DLV_NO_ENTRY) {
         if (glflags.group_number > 0) {
             printf("No DWARF information present in %s "
@@ -882,24 +899,31 @@ process_one_file(
         return DW_DLV_NO_ENTRY;
     }
     if (path_source == DW_PATHSOURCE_dsym) {
-        printf("Filename by dSYM is %s\n",
+        fprintf(dd_json_notice_file(),
+            "Filename by dSYM is %s\n",
             sanitized(temp_path_buf));
     } else if (path_source == DW_PATHSOURCE_debuglink) {
-        printf("Filename by debuglink is %s\n",
+        fprintf(dd_json_notice_file(),
+            "Filename by debuglink is %s\n",
             sanitized(temp_path_buf));
-        glflags.gf_gnu_debuglink_flag = TRUE;
+        /*  --format=json has no debuglink record. */
+        if (!glflags.gf_json_output) {
+            glflags.gf_gnu_debuglink_flag = TRUE;
+        }
     } else { /* Nothing to print yet. */ }
     if (tied_file_name && strlen(tied_file_name)) {
         {
             /*  The tied file we define as group 1, BASE.
                 Cannot follow debuglink or dSYM,
                 is a tied file */
+            stats_phase_begin(STATS_OPEN);
             dres = dwarf_init_path(tied_file_name,
                 0,0,  /* ignore dSYM & debuglink */
                 DW_GROUPNUMBER_BASE,
                 0,0,
                 &dbgtied,
                 &onef_err);
+            stats_phase_end(STATS_OPEN);
             /* path_source = DW_PATHSOURCE_basic; */
         }
         if (dres == DW_DLV_NO_ENTRY) {
@@ -958,6 +982,7 @@ process_one_file(
         Dwarf_Debug dbg_with_code = dbg;
         int res = 0;
 
+        stats_phase_begin(STATS_CHECK_SETUP);
         if (dbgtied) {
             /*  Assuming tied is exectuable main is dwo/dwp */
             dbg_with_code = dbgtied;
@@ -981,12 +1006,15 @@ process_one_file(
         /*  Build section information
             linkonce is an SNR thing, we*/
         build_linkonce_info(dbg);
+        stats_phase_end(STATS_CHECK_SETUP);
     }
     if (glflags.gf_section_groups_flag) {
         int res = 0;
         Dwarf_Error err = 0;
 
+        stats_phase_begin(STATS_SECTION_GROUPS);
         res = print_section_groups_data(dbg,&err);
+        stats_phase_end(STATS_SECTION_GROUPS);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing section groups had a problem.",
@@ -999,6 +1027,13 @@ process_one_file(
             want to print. */
         update_section_flags_per_groups(dbg);
     }
+    if (glflags.gf_json_records) {
+        /*  --format=json turned off every text
+            printing flag tested below. */
+        stats_phase_begin(STATS_JSON);
+        print_json(dbg);
+        stats_phase_end(STATS_JSON);
+    }
     reset_overall_CU_error_data();
     if (glflags.gf_info_flag || glflags.gf_line_flag ||
         glflags.gf_types_flag ||
@@ -1010,7 +1045,9 @@ process_one_file(
         int res = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_INFOS);
         res = print_infos(dbg,TRUE,&err);
+        stats_phase_end(STATS_INFOS);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing .debug_info had a problem.",
@@ -1018,7 +1055,9 @@ process_one_file(
             DROP_ERROR_INSTANCE(dbg,res,err);
         }
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_INFOS);
         res = print_infos(dbg,FALSE,&err);
+        stats_phase_end(STATS_INFOS);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing .debug_types had a problem.",
@@ -1061,6 +1100,7 @@ process_one_file(
         reset_overall_CU_error_data();
         /*  By definition if gdb_index is present
             then "cu" and "tu" will not be. And vice versa.  */
+        stats_phase_begin(STATS_GDB_INDEX);
         res = print_gdb_index(dbg,&err);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
@@ -1075,6 +1115,7 @@ process_one_file(
                 ,res,err);
         }
         res = print_debugfission_index(dbg,"tu",&err);
+        stats_phase_end(STATS_GDB_INDEX);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the debugfission tu section "
@@ -1087,7 +1128,9 @@ process_one_file(
         Dwarf_Error err = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_PUBNAMES);
         res = print_pubnames(dbg,&err);
+        stats_phase_end(STATS_PUBNAMES);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing pubnames data had a problem ",res,err);
@@ -1099,7 +1142,9 @@ process_one_file(
         int res = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_DEBUG_ADDR);
         res = print_debug_addr(dbg,&err);
+        stats_phase_end(STATS_DEBUG_ADDR);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the .debug_addr section"
@@ -1112,7 +1157,9 @@ process_one_file(
         int res = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_ABBREVS);
         res = print_abbrevs(dbg,&err);
+        stats_phase_end(STATS_ABBREVS);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the .debug_abbrev section"
@@ -1125,7 +1172,9 @@ process_one_file(
         int res = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_STRINGS);
         res = print_strings(dbg,&err);
+        stats_phase_end(STATS_STRINGS);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the .debug_str section"
@@ -1138,7 +1187,9 @@ process_one_file(
         int res = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_ARANGES);
         res = print_aranges(dbg,&err);
+        stats_phase_end(STATS_ARANGES);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the aranges section"
@@ -1151,7 +1202,9 @@ process_one_file(
         Dwarf_Error err = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_RANGES);
         res = print_ranges(dbg,&err);
+        stats_phase_end(STATS_RANGES);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the ranges section"
@@ -1164,7 +1217,9 @@ process_one_file(
         Dwarf_Error err = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_RAW_LOCLISTS);
         res = print_raw_all_loclists(dbg,&err);
+        stats_phase_end(STATS_RAW_LOCLISTS);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the raw .debug_loclists section"
@@ -1177,7 +1232,9 @@ process_one_file(
         Dwarf_Error err = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_RAW_RNGLISTS);
         res = print_raw_all_rnglists(dbg,&err);
+        stats_phase_end(STATS_RAW_RNGLISTS);
         if (res == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing the raw .debug_rnglists section"
@@ -1198,12 +1255,14 @@ process_one_file(
         reset_overall_CU_error_data();
         if (glflags.gf_frame_flag) {
             want_eh = 0;
+            stats_phase_begin(STATS_FRAMES);
             sres = print_frames(dbg,want_eh,
                 l_config_file_data,
                 &cu_die_for_print_frames,
                 &map_lowpc_to_name,
                 &lowpcSet,
                 &err);
+            stats_phase_end(STATS_FRAMES);
             if (sres == DW_DLV_ERROR) {
                 print_error_and_continue(dbg,
                     "printing standard frame data had a problem.",
@@ -1213,12 +1272,14 @@ process_one_file(
         }
         if (glflags.gf_eh_frame_flag) {
             want_eh = 1;
+            stats_phase_begin(STATS_FRAMES);
             sres = print_frames(dbg, want_eh,
                 l_config_file_data,
                 &cu_die_for_print_frames,
                 &map_lowpc_to_name,
                 &lowpcSet,
                 &err);
+            stats_phase_end(STATS_FRAMES);
             if (sres == DW_DLV_ERROR) {
                 print_error_and_continue(dbg,
                     "printing eh frame data had a problem.",sres,
@@ -1237,7 +1298,9 @@ process_one_file(
         Dwarf_Error err = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_STATIC_FUNCS);
         sres = print_static_funcs(dbg,&err);
+        stats_phase_end(STATS_STATIC_FUNCS);
         if (sres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing SGI static funcs had a problem.",sres,err);
@@ -1249,7 +1312,9 @@ process_one_file(
         Dwarf_Error err = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_STATIC_VARS);
         sres = print_static_vars(dbg,&err);
+        stats_phase_end(STATS_STATIC_VARS);
         if (sres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing SGI static vars had a problem.",sres,err);
@@ -1265,14 +1330,18 @@ process_one_file(
         int tres = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_TYPES);
         tres = print_types(dbg, DWARF_PUBTYPES,&err);
+        stats_phase_end(STATS_TYPES);
         if (tres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing pubtypes had a problem.",tres,err);
             DROP_ERROR_INSTANCE(dbg,tres,err);
         }
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_TYPES);
         tres = print_types(dbg, SGI_TYPENAME,&err);
+        stats_phase_end(STATS_TYPES);
         if (tres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing SGI typenames had a problem.",tres,err);
@@ -1284,7 +1353,9 @@ process_one_file(
         int res3 = 0;
 
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_WEAKNAMES);
         res3 = print_weaknames(dbg, &err);
+        stats_phase_end(STATS_WEAKNAMES);
         if (res3 == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "printing weaknames had a problem.",res3,err);
@@ -1299,7 +1370,9 @@ process_one_file(
         int nres = 0;
         Dwarf_Error err = 0;
         reset_overall_CU_error_data();
+        stats_phase_begin(STATS_DEBUG_NAMES);
         nres = print_debug_names(dbg,&err);
+        stats_phase_end(STATS_DEBUG_NAMES);
         if (nres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "print .debug_names section failed", nres, err);
@@ -1355,12 +1428,21 @@ process_one_file(
         }
     }
 
+    /*  Print where the DIE bytes went  --size-report */
+    if (glflags.gf_size_report) {
+        stats_phase_begin(STATS_SIZE_REPORT);
+        print_size_report(dbg);
+        stats_phase_end(STATS_SIZE_REPORT);
+    }
+
     if (glflags.gf_print_str_offsets) {
         /*  print the .debug_str_offsets section, if any. */
         int lres = 0;
         Dwarf_Error err = 0;
 
+        stats_phase_begin(STATS_STR_OFFSETS);
         lres = print_str_offsets_section(dbg,&err);
+        stats_phase_end(STATS_STR_OFFSETS);
         if (lres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "print .debug_str_offsets failed", lres, err);
@@ -1386,7 +1468,9 @@ process_one_file(
         int lres = 0;
         Dwarf_Error err = 0;
 
+        stats_phase_begin(STATS_DEBUG_GNU);
         lres = print_debug_gnu(dbg,&err);
+        stats_phase_end(STATS_DEBUG_GNU);
         if (lres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "print .debug_gnu* section failed", lres, err);
@@ -1398,7 +1482,9 @@ process_one_file(
         int lres = 0;
         Dwarf_Error err = 0;
 
+        stats_phase_begin(STATS_DEBUG_SUP);
         lres = print_debug_sup(dbg,&err);
+        stats_phase_end(STATS_DEBUG_SUP);
         if (lres == DW_DLV_ERROR) {
             print_error_and_continue(dbg,
                 "print .debug_sup* section failed", lres, err);
@@ -1423,6 +1509,9 @@ process_one_file(
         glflags.gf_count_major_errors++;
     }
 
+    /*  --stats, while libdwarf still has its counts. */
+    print_stats(dbg);
+
     /*  Could finish dbg first. Either order ok. */
     if (dbgtied) {
         dres = dwarf_finish(dbgtied);
@@ -1441,8 +1530,11 @@ process_one_file(
         DROP_ERROR_INSTANCE(dbg,dres,onef_err);
         dbg = 0;
     }
-    printf("\n");
+    if (!glflags.gf_json_output) {
+        printf("\n");
+    }
     destroy_attr_form_trees();
+    size_report_destructor();
     destruct_abbrev_array();
     esb_close_null_device();
     release_range_array_info();
@@ -34,7 +34,8 @@ Portions Copyright 2007-2021 David Anderson. All rights reserved.
 
 #include <config.h>
 
-#include <stdlib.h> /* calloc() free() */
+#include <limits.h> /* INT_MAX */
+#include <stdlib.h> /* calloc() free() realloc() */
 #include <string.h> /* memcmp() memset() strchr() strcmp()
     strlen() strncmp() */
 
@@ -58,6 +59,11 @@ Portions Copyright 2007-2021 David Anderson. All rights reserved.
 #include "dd_attr_form.h"
 #include "dd_regex.h"
 #include "dd_safe_strcpy.h"
+#include "dd_workers.h"
+#include "dd_search_index.h"
+#include "dd_size_report.h"
+#include "dd_stats.h"
+#include "dd_output.h"
 
 #define VSFBUFSZ 200
 #define IMPLICIT_VALUE_PRINT_MAX 12
@@ -104,6 +110,7 @@ static int print_die_and_children_internal(Dwarf_Debug dbg,
     Dwarf_Error *);
 static int print_one_die_section(Dwarf_Debug dbg,
     Dwarf_Bool is_info,
+    int first_cu, int end_cu,
     Dwarf_Error *pod_err);
 static int handle_rnglists(Dwarf_Attribute attrib,
     Dwarf_Half theform,
@@ -240,7 +247,7 @@ print_indent_prefix(int prespaces,int indent,int postspaces)
 {
     if (indent < glflags.gf_max_space_indent) {
         int len = prespaces+postspaces+ 2*indent;
-        printf("%*s",len," ");
+        dd_output_spaces(len);
         return;
     }
     if (prespaces) {
@@ -600,6 +607,18 @@ print_as_info_or_by_cuname(void)
         || glflags.gf_cu_name_flag);
 }
 
+/*  --size-report alone needs nothing from
+    print_one_die(), which would format every
+    attribute value only to throw it away. */
+static Dwarf_Bool
+size_report_only(void)
+{
+    return glflags.gf_size_report &&
+        !glflags.gf_do_print_dwarf &&
+        !glflags.gf_do_check_dwarf &&
+        !glflags.gf_search_is_on;
+}
+
 #if 0
 /*  Only used for debugging. */
 static void
@@ -639,13 +658,210 @@ form_refers_local_info(Dwarf_Half form)
     return TRUE;
 }
 
+/*  For --threads=<n>: the CUs are split into runs of
+    about equal size in bytes, worker i printing the CUs
+    numbered cw_first_cu[i] up to cw_first_cu[i+1]. */
+struct cu_workers_s {
+    Dwarf_Debug cw_dbg;
+    Dwarf_Bool  cw_is_info;
+    unsigned    cw_count;
+    int        *cw_first_cu; /* cw_count+1 entries */
+};
+
+static int
+print_cu_worker(void *arg, unsigned worker, Dwarf_Error *err)
+{
+    struct cu_workers_s *cw = (struct cu_workers_s *)arg;
+    int end_cu = INT_MAX;
+
+    /*  The last worker also prints the -H 'Break at'. */
+    if (worker+1 < cw->cw_count) {
+        end_cu = cw->cw_first_cu[worker+1];
+    }
+    return print_one_die_section(cw->cw_dbg,cw->cw_is_info,
+        cw->cw_first_cu[worker],end_cu,err);
+}
+
+/*  Prints the CU before a worker's share, with
+    the output thrown away, for what it leaves in
+    glflags (such as the CU name errors show when the
+    next CU has none). */
+static int
+warm_up_cu_worker(void *arg, unsigned worker, Dwarf_Error *err)
+{
+    struct cu_workers_s *cw = (struct cu_workers_s *)arg;
+    int first_cu = cw->cw_first_cu[worker];
+
+    return print_one_die_section(cw->cw_dbg,cw->cw_is_info,
+        first_cu-1,first_cu,err);
+}
+
+/*  Splitting by CU only gives the serial output when
+    what one CU prints does not depend on earlier CUs
+    or what it adds to the totals printed at the end
+    can be merged (see dd_workers.c).
+    The macro printing tracks the macro units already
+    printed, -kG prints only the first of each error
+    and with a tied file the ranges seen are kept
+    across CUs, so those stay serial. */
+static Dwarf_Bool
+cu_workers_usable(Dwarf_Debug dbg)
+{
+    Dwarf_Debug tied = 0;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    if (glflags.gf_threads < 2 || !dd_workers_available()) {
+        return FALSE;
+    }
+    if (glflags.gf_macro_flag ||
+        glflags.gf_macinfo_flag ||
+        (glflags.gf_check_macros && !glflags.gf_do_check_dwarf) ||
+        glflags.gf_print_unique_errors) {
+        return FALSE;
+    }
+    res = dwarf_get_tied_dbg(dbg,&tied,&err);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,err);
+        return FALSE;
+    }
+    if (res == DW_DLV_OK && tied) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*  Writes where each CU ends. Reaching DW_DLV_NO_ENTRY
+    would leave libdwarf ready to start from the first
+    CU again but an error would not, hence this is run
+    in a separate process. */
+static int
+write_cu_ends(void *arg, FILE *out)
+{
+    struct cu_workers_s *cw = (struct cu_workers_s *)arg;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    for (;;) {
+        Dwarf_Unsigned next_cu_offset = 0;
+
+        res = dwarf_next_cu_header_d(cw->cw_dbg,cw->cw_is_info,
+            0,0,0,0,0,0,0,0,&next_cu_offset,0,&err);
+        if (res == DW_DLV_NO_ENTRY) {
+            return DW_DLV_OK;
+        }
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        if (fwrite(&next_cu_offset,sizeof(next_cu_offset),1,
+            out) != 1) {
+            return DW_DLV_ERROR;
+        }
+    }
+}
+
+static int
+print_die_section_in_workers(Dwarf_Debug dbg,Dwarf_Bool is_info,
+    Dwarf_Error *pi_err)
+{
+    struct cu_workers_s cw;
+    FILE *ends = 0;
+    Dwarf_Unsigned *cu_end = 0;
+    Dwarf_Unsigned  cu_alloc = 0;
+    Dwarf_Unsigned  per_worker = 0;
+    unsigned children = 0;
+    int   cu_count = 0;
+    int   cu_limit = 0;
+    int   res = 0;
+    unsigned i = 0;
+
+    cw.cw_dbg = dbg;
+    cw.cw_is_info = is_info;
+    cw.cw_count = 0;
+    cw.cw_first_cu = 0;
+    ends = dd_probe_in_worker(write_cu_ends,&cw);
+    if (!ends) {
+        /*  Let the serial code report any error. */
+        return print_one_die_section(dbg,is_info,0,INT_MAX,pi_err);
+    }
+    for (;;) {
+        Dwarf_Unsigned end = 0;
+
+        if (fread(&end,sizeof(end),1,ends) != 1) {
+            break;
+        }
+        if ((Dwarf_Unsigned)cu_count >= cu_alloc) {
+            Dwarf_Unsigned *newp = 0;
+
+            cu_alloc = cu_alloc? cu_alloc*2 : 64;
+            newp = (Dwarf_Unsigned *)realloc(cu_end,
+                cu_alloc*sizeof(Dwarf_Unsigned));
+            if (!newp) {
+                cu_count = 0;
+                break;
+            }
+            cu_end = newp;
+        }
+        cu_end[cu_count++] = end;
+    }
+    fclose(ends);
+    cu_limit = cu_count;
+    if (cu_limit > glflags.break_after_n_units) {
+        cu_limit = glflags.break_after_n_units;
+    }
+    /*  The workers split all but the last CU by size.
+        The last CU (with any -H 'Break at') is left to a
+        final worker run here after the others are merged,
+        so the state it leaves is that of a serial run. */
+    if (cu_limit > 1) {
+        children = (unsigned)glflags.gf_threads;
+        if (children > (unsigned)(cu_limit-1)) {
+            children = (unsigned)(cu_limit-1);
+        }
+        cw.cw_count = children+1;
+        cw.cw_first_cu = (int *)calloc(cw.cw_count+1,sizeof(int));
+    }
+    if (!cw.cw_first_cu) {
+        free(cu_end);
+        return print_one_die_section(dbg,is_info,0,INT_MAX,pi_err);
+    }
+    per_worker = cu_end[cu_limit-2]/children;
+    for (i = 1; i < children; ++i) {
+        /*  Each worker gets at least one CU. */
+        int cu = cw.cw_first_cu[i-1] + 1;
+        int most = cu_limit - 1 - (int)(children - i);
+
+        while (cu < most && cu_end[cu-1] < per_worker*i) {
+            ++cu;
+        }
+        cw.cw_first_cu[i] = cu;
+    }
+    cw.cw_first_cu[children] = cu_limit-1;
+    cw.cw_first_cu[cw.cw_count] = cu_limit;
+    free(cu_end);
+    res = dd_run_workers(dbg,cw.cw_count,print_cu_worker,
+        warm_up_cu_worker,&cw,pi_err);
+    free(cw.cw_first_cu);
+    return res;
+}
+
 /* process each compilation unit in .debug_info */
 int
 print_infos(Dwarf_Debug dbg,Dwarf_Bool is_info,
     Dwarf_Error *pi_err)
 {
     int nres = 0;
-    nres = print_one_die_section(dbg,is_info,pi_err);
+
+    if (is_info) {
+        /*  Ignore errors, the full walk reports them. */
+        dd_search_index_setup(dbg);
+    }
+    if (cu_workers_usable(dbg)) {
+        nres = print_die_section_in_workers(dbg,is_info,pi_err);
+    } else {
+        nres = print_one_die_section(dbg,is_info,0,INT_MAX,pi_err);
+    }
+    dd_search_index_destroy();
     return nres;
 }
 
@@ -919,9 +1135,11 @@ print_macinfo_for_cu(
             mres,*err);
         return mres;
     } else {
+        stats_phase_begin(STATS_MACROS);
         mres = print_macinfo_by_offset(dbg,
             cu_die2,
             offset,err);
+        stats_phase_end(STATS_MACROS);
         if (mres==DW_DLV_ERROR) {
             struct esb_s m;
 
@@ -981,8 +1199,11 @@ print_cu_hdr_abbrev_data(Dwarf_Debug dbg,
 }
 
 /*   */
+/*  Prints the CUs numbered first_cu up to end_cu
+    (all of them with 0 and INT_MAX). */
 static int
 print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
+    int first_cu, int end_cu,
     Dwarf_Error *pod_err)
 {
     Dwarf_Unsigned cu_header_length = 0;
@@ -1040,7 +1261,7 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
             &signature, &typeoffset,
             &next_cu_offset,
             &cu_type, pod_err);
-        if (!loop_count) {
+        if (!loop_count && !first_cu) {
             /*  So compress flags show, we waited till
                 section loaded to do this. */
             print_die_secname(dbg,is_info);
@@ -1056,6 +1277,26 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
                 " or DIE, corrupt DWARF", nres, *pod_err);
             return nres;
         }
+        if (cu_count >= end_cu) {
+            /*  Run to the end so the next caller
+                starts at the first CU. */
+            while (nres == DW_DLV_OK) {
+                nres = dwarf_next_cu_header_d(dbg,is_info,
+                    0,0,0,0,0,0,0,0,0,0,pod_err);
+            }
+            if (nres == DW_DLV_ERROR) {
+                DROP_ERROR_INSTANCE(dbg,nres,*pod_err);
+            }
+            return DW_DLV_OK;
+        }
+        if (cu_count < first_cu) {
+            ++cu_count;
+            continue;
+        }
+        if (first_cu && loop_count == (unsigned)first_cu) {
+            /*  Only now is this worker's share begun. */
+            dd_worker_range_begins(dbg);
+        }
         if (cu_count >= glflags.break_after_n_units) {
             const char *m = "CUs";
             if (cu_count == 1) {
@@ -1102,6 +1343,14 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
                 continue;
             }
         }
+        if (is_info &&
+            dd_search_index_skips_cu(dieprint_cu_goffset)) {
+            /*  --search-index: no name here matches. */
+            dwarf_dealloc_die(cu_die);
+            cu_die = 0;
+            ++cu_count;
+            continue;
+        }
         {
         /*  Get producer name for this CU and
             update compiler list */
@@ -1148,6 +1397,11 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
             cu_die = 0;
             continue;
         }
+        if (glflags.gf_size_report) {
+            size_report_unit(dbg,is_info,cu_die,cu_header_length,
+                length_size,extension_size,next_cu_offset,
+                &signature);
+        }
         fission_data_result = dwarf_get_debugfission_for_die(
             cu_die,
             &fission_data,pod_err);
@@ -1322,9 +1576,11 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
                     int plnres = 0;
 
                     int oldsection = glflags.current_section_id;
+                    stats_phase_begin(STATS_LINES);
                     plnres = print_line_numbers_this_cu(dbg,
                         cu_die2,
                         srcfiles,srcfiles_cnt,pod_err);
+                    stats_phase_end(STATS_LINES);
                     if (plnres == DW_DLV_ERROR) {
                         print_error_and_continue(dbg,
                             "ERROR: Printing line numbers for "
@@ -1348,12 +1604,14 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
                         in the macro header. */
 
                     macro_import_stack_cleanout();
+                    stats_phase_begin(STATS_MACROS);
                     mres = print_macros_5style_this_cu(dbg, cu_die2,
                         srcfiles,srcfiles_cnt,
                         glflags.gf_do_print_dwarf,
                         TRUE /* descend_into_imports */,
                         in_import_list,
                         import_offset,pod_err);
+                    stats_phase_end(STATS_MACROS);
                     if (mres == DW_DLV_ERROR) {
                         print_error_and_continue(dbg,
                             "ERROR: Printing DWARF5 macros "
@@ -1378,6 +1636,7 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
                                 break;
                             }
                             macro_import_stack_cleanout();
+                            stats_phase_begin(STATS_MACROS);
                             mres = print_macros_5style_this_cu(dbg,
                                 cu_die2,
                                 srcfiles,srcfiles_cnt,
@@ -1386,6 +1645,7 @@ print_one_die_section(Dwarf_Debug dbg,Dwarf_Bool is_info,
                                 in_import_list,
                                 import_offset,
                                 pod_err);
+                            stats_phase_end(STATS_MACROS);
                             if (mres == DW_DLV_ERROR) {
                                 struct esb_s m;
 
@@ -1624,8 +1884,18 @@ print_die_and_children_internal(Dwarf_Debug dbg,
             glflags.gf_check_verbose_mode) {
             glflags.gf_record_dwarf_error = FALSE;
         }
-        /* Here do pre-descent processing of the die. */
-        {
+        if (glflags.gf_size_report) {
+            size_report_die(dbg,in_die);
+        }
+        /*  Here do pre-descent processing of the die,
+            unless --search-index shows no name
+            matching refers to it or nothing but
+            --size-report is wanted. */
+        if (!size_report_only() &&
+            (!die_stack_indent_level ||
+            print_as_info_or_by_cuname() ||
+            !dd_search_index_skips_die(
+            glflags.DIE_overall_offset))) {
             Dwarf_Bool an_attribute_match_local = FALSE;
             Dwarf_Bool ignore_die_stack = FALSE;
             int pdres = 0;
@@ -2065,7 +2335,8 @@ print_one_die(Dwarf_Debug dbg, Dwarf_Die die,
             die_indent_level, (Dwarf_Unsigned)offset,
             (Dwarf_Unsigned)overall_offset);
         print_indent_prefix(0,die_indent_level,2);
-        printf("%s\n",tagname);
+        dd_output_string(tagname);
+        dd_output_char('\n');
     }
     /* Print the die */
     if (PRINTING_DIES && print_else_name_match) {
@@ -2085,7 +2356,8 @@ print_one_die(Dwarf_Debug dbg, Dwarf_Die die,
         if (!glflags.gf_display_offsets) {
             /* Print using indentation */
             print_indent_prefix(0,die_indent_level,2);
-            printf("%s\n",tagname);
+            dd_output_string(tagname);
+            dd_output_char('\n');
         } else {
             if (glflags.dense) {
                 if (glflags.gf_show_global_offsets) {
@@ -2166,7 +2438,7 @@ print_one_die(Dwarf_Debug dbg, Dwarf_Die die,
 
                 /* Print using indentation */
                 print_indent_prefix(0,die_indent_level, 2);
-                printf("%s",tagname);
+                dd_output_string(tagname);
                 if (glflags.verbose) {
                     Dwarf_Off agoff = 0;
                     Dwarf_Unsigned acount = 0;
@@ -5181,19 +5453,24 @@ print_attribute(Dwarf_Debug dbg, Dwarf_Die die,
                 printf(" %s<%s>", atname, sanitized(v));
                 if (append_extra_string) {
                     v = esb_get_string(&esb_extra);
-                    printf("%s", sanitized(v));
+                    dd_output_string(sanitized(v));
                 }
             } else {
                 char *v = 0;
-                printf("%-28s", atname);
-                if (strlen(atname) >= 28) {
-                    printf(" ");
+                size_t atlen = strlen(atname);
+
+                dd_output_string(atname);
+                if (atlen >= 28) {
+                    dd_output_char(' ');
+                } else {
+                    dd_output_spaces((int)(28 - atlen));
                 }
                 v = esb_get_string(&valname);
-                printf("%s\n", sanitized(v));
+                dd_output_string(sanitized(v));
+                dd_output_char('\n');
                 if (append_extra_string) {
                     v = esb_get_string(&esb_extra);
-                    printf("%s", sanitized(v));
+                    dd_output_string(sanitized(v));
                 }
             }
         }
@@ -6668,6 +6945,80 @@ static int attributes_encoding_factor[DW_FORM_data16 + 1];
 static a_attr_encoding *attributes_encoding_table = NULL;
 static Dwarf_Bool attributes_encoding_do_init = TRUE;
 
+static void
+init_attributes_encoding(void)
+{
+    /* Create table on first call */
+    attributes_encoding_table = (a_attr_encoding *)calloc(
+        DW_AT_lo_user,
+        sizeof(a_attr_encoding));
+    /* We use only 5 slots in the table, for quick access */
+    /* index 0x0b */
+    attributes_encoding_factor[DW_FORM_data1]=1; /* index 0x0b */
+    attributes_encoding_factor[DW_FORM_data2]=2; /* index 0x05 */
+    attributes_encoding_factor[DW_FORM_data4]=4; /* index 0x06 */
+    attributes_encoding_factor[DW_FORM_data8]=8; /* index 0x07 */
+
+    /* index 0x1e */
+    attributes_encoding_factor[DW_FORM_data16] = 16;
+    attributes_encoding_do_init = FALSE;
+}
+
+/*  --threads=<n>: a worker starts the table from zero
+    and writes it (if it has one) for this process
+    to add to its own. */
+void
+attributes_encoding_worker_begin(void)
+{
+    if (attributes_encoding_table) {
+        memset(attributes_encoding_table,0,
+            DW_AT_lo_user*sizeof(a_attr_encoding));
+    }
+}
+
+int
+attributes_encoding_worker_write(FILE *f)
+{
+    Dwarf_Bool have_table = attributes_encoding_table? TRUE:FALSE;
+    int res = 0;
+
+    res = dd_report_write(f,&have_table,sizeof(have_table));
+    if (res != DW_DLV_OK || !have_table) {
+        return res;
+    }
+    return dd_report_write(f,attributes_encoding_table,
+        DW_AT_lo_user*sizeof(a_attr_encoding));
+}
+
+int
+attributes_encoding_worker_merge(FILE *f)
+{
+    Dwarf_Bool have_table = FALSE;
+    a_attr_encoding added;
+    int index = 0;
+    int res = 0;
+
+    res = dd_report_read(f,&have_table,sizeof(have_table));
+    if (res != DW_DLV_OK || !have_table) {
+        return res;
+    }
+    if (attributes_encoding_do_init) {
+        init_attributes_encoding();
+    }
+    for (index = 0; index < DW_AT_lo_user; ++index) {
+        res = dd_report_read(f,&added,sizeof(added));
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        if (attributes_encoding_table) {
+            attributes_encoding_table[index].entries += added.entries;
+            attributes_encoding_table[index].formx += added.formx;
+            attributes_encoding_table[index].leb128 += added.leb128;
+        }
+    }
+    return DW_DLV_OK;
+}
+
 /*  Check the potential amount of space wasted by
     attributes values that can
     be represented as an unsigned LEB128.
@@ -6681,20 +7032,7 @@ check_attributes_encoding(Dwarf_Half attr,Dwarf_Half theform,
 {
 
     if (attributes_encoding_do_init) {
-        /* Create table on first call */
-        attributes_encoding_table = (a_attr_encoding *)calloc(
-            DW_AT_lo_user,
-            sizeof(a_attr_encoding));
-        /* We use only 5 slots in the table, for quick access */
-        /* index 0x0b */
-        attributes_encoding_factor[DW_FORM_data1]=1; /* index 0x0b */
-        attributes_encoding_factor[DW_FORM_data2]=2; /* index 0x05 */
-        attributes_encoding_factor[DW_FORM_data4]=4; /* index 0x06 */
-        attributes_encoding_factor[DW_FORM_data8]=8; /* index 0x07 */
-
-        /* index 0x1e */
-        attributes_encoding_factor[DW_FORM_data16] = 16;
-        attributes_encoding_do_init = FALSE;
+        init_attributes_encoding();
     }
 
     /* Regardless of the encoding form, count the checks. */
@@ -0,0 +1,881 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  --format=json.
+    Writes JSON Lines: one JSON object per line, each with
+    a "type" member, in the order the data is read.
+    Each record is written as soon as it is built (see
+    dd_json.c), so no more than one DIE or one line
+    table row is ever held, whatever the size of a CU.
+    Record types:
+        section  every object file section
+        cu       a unit header in .debug_info or .debug_types
+        die      a DIE, its tag and its attributes
+        line     a row of the line table of a CU
+        cie, fde .debug_frame (-f) or .eh_frame (-F),
+                 an fde has its CFA rules by address
+        arange   .debug_aranges
+        name     .debug_pubnames or .debug_names
+        error    something could not be read, the
+                 records of that kind stop there.
+    These are written by walking the sections here
+    with libdwarf, not by the text printers, which
+    mix printing with checking throughout. */
+
+#include <config.h>
+
+#include <string.h> /* memset() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h"
+#include "dd_globals.h"
+#include "dd_naming.h"
+#include "dd_esb.h"
+#include "dd_json.h"
+
+/*  The record being built, reused for every record. */
+static struct esb_s json_record;
+
+/*  What every record about a unit repeats. */
+struct json_cu_s {
+    const char *jc_section;
+    Dwarf_Bool  jc_is_info;
+    Dwarf_Off   jc_offset;
+    Dwarf_Half  jc_version;
+    Dwarf_Half  jc_offset_size;
+};
+
+static void
+json_error(Dwarf_Debug dbg, const char *section,
+    const char *msg, Dwarf_Error err)
+{
+    dd_json_begin(&json_record,"error");
+    dd_json_string(&json_record,"section",section);
+    dd_json_string(&json_record,"message",msg);
+    if (err) {
+        dd_json_string(&json_record,"error",dwarf_errmsg(err));
+        dwarf_dealloc_error(dbg,err);
+    }
+    dd_json_end(&json_record);
+    glflags.gf_count_major_errors++;
+}
+
+static void
+json_sections(Dwarf_Debug dbg)
+{
+    int count = dwarf_get_section_count(dbg);
+    int i = 0;
+
+    for (i = 0; i < count; ++i) {
+        const char *name = 0;
+        Dwarf_Addr addr = 0;
+        Dwarf_Unsigned size = 0;
+        Dwarf_Error err = 0;
+        int res = 0;
+
+        res = dwarf_get_section_info_by_index(dbg,i,
+            &name,&addr,&size,&err);
+        if (res == DW_DLV_ERROR) {
+            json_error(dbg,"","dwarf_get_section_info_by_index"
+                " failed",err);
+            return;
+        }
+        if (res == DW_DLV_NO_ENTRY || !name || !name[0]) {
+            continue;
+        }
+        dd_json_begin(&json_record,"section");
+        dd_json_unsigned(&json_record,"index",(Dwarf_Unsigned)i);
+        dd_json_string(&json_record,"name",name);
+        dd_json_unsigned(&json_record,"address",addr);
+        dd_json_unsigned(&json_record,"size",size);
+        dd_json_end(&json_record);
+    }
+}
+
+/*  Adds "value" (or "error") for one attribute.
+    References are section-global offsets,
+    blocks, expressions and signatures hex bytes. */
+static void
+json_attribute_value(Dwarf_Debug dbg, Dwarf_Attribute attr,
+    Dwarf_Half form)
+{
+    struct esb_s *r = &json_record;
+    Dwarf_Error err = 0;
+    int res = DW_DLV_OK;
+
+    switch (form) {
+    case DW_FORM_flag:
+    case DW_FORM_flag_present: {
+        Dwarf_Bool flag = 0;
+
+        res = dwarf_formflag(attr,&flag,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_bool(r,"value",flag);
+        }
+        break;
+    }
+    case DW_FORM_sdata:
+    case DW_FORM_implicit_const: {
+        Dwarf_Signed sval = 0;
+
+        res = dwarf_formsdata(attr,&sval,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_signed(r,"value",sval);
+        }
+        break;
+    }
+    case DW_FORM_data16: {
+        Dwarf_Form_Data16 d16;
+
+        res = dwarf_formdata16(attr,&d16,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_bytes(r,"value",d16.fd_data,
+                sizeof(d16.fd_data));
+        }
+        break;
+    }
+    case DW_FORM_ref_sig8: {
+        Dwarf_Sig8 sig;
+
+        res = dwarf_formsig8(attr,&sig,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_bytes(r,"value",
+                (const unsigned char *)sig.signature,
+                sizeof(sig.signature));
+        }
+        break;
+    }
+    case DW_FORM_string:
+    case DW_FORM_strp:
+    case DW_FORM_line_strp:
+    case DW_FORM_strp_sup:
+    case DW_FORM_GNU_strp_alt:
+    case DW_FORM_strx:
+    case DW_FORM_strx1:
+    case DW_FORM_strx2:
+    case DW_FORM_strx3:
+    case DW_FORM_strx4:
+    case DW_FORM_GNU_str_index: {
+        char *str = 0;
+
+        res = dwarf_formstring(attr,&str,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_string(r,"value",str);
+        }
+        break;
+    }
+    case DW_FORM_addr:
+    case DW_FORM_addrx:
+    case DW_FORM_addrx1:
+    case DW_FORM_addrx2:
+    case DW_FORM_addrx3:
+    case DW_FORM_addrx4:
+    case DW_FORM_GNU_addr_index: {
+        Dwarf_Addr addr = 0;
+
+        res = dwarf_formaddr(attr,&addr,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_unsigned(r,"value",addr);
+        }
+        break;
+    }
+    case DW_FORM_ref1:
+    case DW_FORM_ref2:
+    case DW_FORM_ref4:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_udata:
+    case DW_FORM_ref_addr:
+    case DW_FORM_ref_sup4:
+    case DW_FORM_ref_sup8:
+    case DW_FORM_GNU_ref_alt:
+    case DW_FORM_sec_offset: {
+        Dwarf_Off off = 0;
+        Dwarf_Bool is_info = TRUE;
+
+        res = dwarf_global_formref_b(attr,&off,&is_info,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_unsigned(r,"value",off);
+        }
+        break;
+    }
+    case DW_FORM_exprloc: {
+        Dwarf_Unsigned len = 0;
+        Dwarf_Ptr bytes = 0;
+
+        res = dwarf_formexprloc(attr,&len,&bytes,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_bytes(r,"value",
+                (const unsigned char *)bytes,len);
+        }
+        break;
+    }
+    case DW_FORM_block:
+    case DW_FORM_block1:
+    case DW_FORM_block2:
+    case DW_FORM_block4: {
+        Dwarf_Block *block = 0;
+
+        res = dwarf_formblock(attr,&block,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_bytes(r,"value",
+                (const unsigned char *)block->bl_data,
+                block->bl_len);
+            dwarf_dealloc(dbg,block,DW_DLA_BLOCK);
+        }
+        break;
+    }
+    default: {
+        /*  data1-8, udata and the list and
+            range indexes. */
+        Dwarf_Unsigned uval = 0;
+
+        res = dwarf_formudata(attr,&uval,&err);
+        if (res == DW_DLV_OK) {
+            dd_json_unsigned(r,"value",uval);
+        }
+        break;
+    }
+    }
+    if (res == DW_DLV_ERROR) {
+        dd_json_string(r,"error",dwarf_errmsg(err));
+        dwarf_dealloc_error(dbg,err);
+    }
+}
+
+static int
+json_one_die(Dwarf_Debug dbg, Dwarf_Die die,
+    struct json_cu_s *cu, int level, Dwarf_Error *err)
+{
+    struct esb_s *r = &json_record;
+    Dwarf_Half tag = 0;
+    Dwarf_Off goff = 0;
+    Dwarf_Off loff = 0;
+    Dwarf_Attribute *atlist = 0;
+    Dwarf_Signed atcount = 0;
+    Dwarf_Signed i = 0;
+    int res = 0;
+
+    res = dwarf_tag(die,&tag,err);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    res = dwarf_die_offsets(die,&goff,&loff,err);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    res = dwarf_attrlist(die,&atlist,&atcount,err);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
+    dd_json_begin(r,"die");
+    dd_json_string(r,"section",cu->jc_section);
+    dd_json_unsigned(r,"cu",cu->jc_offset);
+    dd_json_unsigned(r,"offset",goff);
+    dd_json_unsigned(r,"level",(Dwarf_Unsigned)level);
+    dd_json_string(r,"tag",get_TAG_name(tag,FALSE));
+    dd_json_array_begin(r,"attributes");
+    for (i = 0; i < atcount; ++i) {
+        Dwarf_Attribute attr = atlist[i];
+        Dwarf_Half attrnum = 0;
+        Dwarf_Half form = 0;
+        Dwarf_Error aerr = 0;
+
+        dd_json_object_begin(r,0);
+        if (dwarf_whatattr(attr,&attrnum,&aerr) == DW_DLV_OK &&
+            dwarf_whatform(attr,&form,&aerr) == DW_DLV_OK) {
+            dd_json_string(r,"name",get_AT_name(attrnum,FALSE));
+            dd_json_string(r,"form",get_FORM_name(form,FALSE));
+            json_attribute_value(dbg,attr,form);
+        } else if (aerr) {
+            dd_json_string(r,"error",dwarf_errmsg(aerr));
+            dwarf_dealloc_error(dbg,aerr);
+        }
+        dd_json_object_end(r);
+        dwarf_dealloc_attribute(attr);
+    }
+    dd_json_array_end(r);
+    dd_json_end(r);
+    if (atlist) {
+        dwarf_dealloc(dbg,atlist,DW_DLA_LIST);
+    }
+    return DW_DLV_OK;
+}
+
+/*  Writes in_die, its children and its siblings
+    (and theirs). The caller owns in_die. */
+static int
+json_die_and_siblings(Dwarf_Debug dbg, Dwarf_Die in_die,
+    struct json_cu_s *cu, int level, Dwarf_Error *err)
+{
+    Dwarf_Die die = in_die;
+    int res = DW_DLV_OK;
+
+    while (die) {
+        Dwarf_Die child = 0;
+        Dwarf_Die sibling = 0;
+
+        res = json_one_die(dbg,die,cu,level,err);
+        if (res == DW_DLV_OK) {
+            res = dwarf_child(die,&child,err);
+            if (res == DW_DLV_OK) {
+                res = json_die_and_siblings(dbg,child,cu,
+                    level+1,err);
+                dwarf_dealloc_die(child);
+            }
+        }
+        if (res != DW_DLV_ERROR) {
+            res = dwarf_siblingof_b(dbg,die,cu->jc_is_info,
+                &sibling,err);
+        }
+        if (die != in_die) {
+            dwarf_dealloc_die(die);
+        }
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        die = sibling;
+    }
+    return DW_DLV_OK;
+}
+
+static int
+json_lines(Dwarf_Debug dbg, Dwarf_Die cu_die,
+    struct json_cu_s *cu, Dwarf_Error *err)
+{
+    struct esb_s *r = &json_record;
+    Dwarf_Unsigned version = 0;
+    Dwarf_Small table_count = 0;
+    Dwarf_Line_Context context = 0;
+    Dwarf_Line *linebuf = 0;
+    Dwarf_Signed linecount = 0;
+    Dwarf_Line *actuals = 0;
+    Dwarf_Signed actualscount = 0;
+    Dwarf_Signed i = 0;
+    Dwarf_Unsigned lastfileno = 0;
+    char *filename = 0;
+    int res = 0;
+
+    res = dwarf_srclines_b(cu_die,&version,&table_count,
+        &context,err);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    if (table_count == 1) {
+        res = dwarf_srclines_from_linecontext(context,
+            &linebuf,&linecount,err);
+    } else if (table_count == 2) {
+        /*  Two-level tables, the logicals have
+            the source positions. */
+        res = dwarf_srclines_two_level_from_linecontext(context,
+            &linebuf,&linecount,&actuals,&actualscount,err);
+    }
+    if (res != DW_DLV_OK) {
+        dwarf_srclines_dealloc_b(context);
+        return res;
+    }
+    for (i = 0; i < linecount; ++i) {
+        Dwarf_Line line = linebuf[i];
+        Dwarf_Addr addr = 0;
+        Dwarf_Unsigned lineno = 0;
+        Dwarf_Unsigned column = 0;
+        Dwarf_Unsigned fileno = 0;
+        Dwarf_Bool is_stmt = FALSE;
+        Dwarf_Bool basic_block = FALSE;
+        Dwarf_Bool end_sequence = FALSE;
+        Dwarf_Bool prologue_end = FALSE;
+        Dwarf_Bool epilogue_begin = FALSE;
+        Dwarf_Unsigned isa = 0;
+        Dwarf_Unsigned discriminator = 0;
+
+        res = dwarf_lineaddr(line,&addr,err);
+        if (res == DW_DLV_OK) {
+            res = dwarf_lineno(line,&lineno,err);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_lineoff_b(line,&column,err);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_line_srcfileno(line,&fileno,err);
+        }
+        if (res == DW_DLV_OK && (!filename || fileno != lastfileno)) {
+            /*  Rows mostly repeat the file of
+                the row before. */
+            if (filename) {
+                dwarf_dealloc(dbg,filename,DW_DLA_STRING);
+                filename = 0;
+            }
+            res = dwarf_linesrc(line,&filename,err);
+            lastfileno = fileno;
+            if (res == DW_DLV_NO_ENTRY) {
+                res = DW_DLV_OK;
+            }
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_linebeginstatement(line,&is_stmt,err);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_lineblock(line,&basic_block,err);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_lineendsequence(line,&end_sequence,err);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_prologue_end_etc(line,&prologue_end,
+                &epilogue_begin,&isa,&discriminator,err);
+        }
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        dd_json_begin(r,"line");
+        dd_json_unsigned(r,"cu",cu->jc_offset);
+        dd_json_unsigned(r,"address",addr);
+        dd_json_string(r,"file",filename);
+        dd_json_unsigned(r,"line",lineno);
+        dd_json_unsigned(r,"column",column);
+        dd_json_bool(r,"is_stmt",is_stmt);
+        dd_json_bool(r,"basic_block",basic_block);
+        dd_json_bool(r,"end_sequence",end_sequence);
+        dd_json_bool(r,"prologue_end",prologue_end);
+        dd_json_bool(r,"epilogue_begin",epilogue_begin);
+        dd_json_unsigned(r,"isa",isa);
+        dd_json_unsigned(r,"discriminator",discriminator);
+        dd_json_end(r);
+    }
+    if (filename) {
+        dwarf_dealloc(dbg,filename,DW_DLA_STRING);
+    }
+    dwarf_srclines_dealloc_b(context);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
+    return DW_DLV_OK;
+}
+
+static void
+json_cu_header(struct json_cu_s *cu,
+    Dwarf_Unsigned length, Dwarf_Half address_size,
+    Dwarf_Off abbrev_offset, Dwarf_Half unit_type,
+    Dwarf_Sig8 *signature)
+{
+    struct esb_s *r = &json_record;
+    const char *utname = 0;
+
+    dd_json_begin(r,"cu");
+    dd_json_string(r,"section",cu->jc_section);
+    dd_json_unsigned(r,"offset",cu->jc_offset);
+    dd_json_unsigned(r,"length",length);
+    dd_json_unsigned(r,"version",cu->jc_version);
+    if (dwarf_get_UT_name(unit_type,&utname) == DW_DLV_OK) {
+        dd_json_string(r,"unit_type",utname);
+    }
+    dd_json_unsigned(r,"address_size",address_size);
+    dd_json_unsigned(r,"offset_size",cu->jc_offset_size);
+    dd_json_unsigned(r,"abbrev_offset",abbrev_offset);
+    if (unit_type == DW_UT_type || unit_type == DW_UT_split_type ||
+        !cu->jc_is_info) {
+        dd_json_bytes(r,"signature",
+            (const unsigned char *)signature->signature,
+            sizeof(signature->signature));
+    }
+    dd_json_end(r);
+}
+
+/*  The cu, die and line records of one section. */
+static void
+json_units(Dwarf_Debug dbg, Dwarf_Bool is_info)
+{
+    const char *section = is_info? ".debug_info":".debug_types";
+    int units = 0;
+
+    for (;;) {
+        struct json_cu_s cu;
+        Dwarf_Unsigned length = 0;
+        Dwarf_Half version = 0;
+        Dwarf_Off abbrev_offset = 0;
+        Dwarf_Half address_size = 0;
+        Dwarf_Half offset_size = 0;
+        Dwarf_Half extension_size = 0;
+        Dwarf_Sig8 signature;
+        Dwarf_Unsigned typeoffset = 0;
+        Dwarf_Unsigned next_offset = 0;
+        Dwarf_Half unit_type = 0;
+        Dwarf_Die cu_die = 0;
+        Dwarf_Off goff = 0;
+        Dwarf_Off loff = 0;
+        Dwarf_Error err = 0;
+        int res = 0;
+
+        memset(&signature,0,sizeof(signature));
+        res = dwarf_next_cu_header_d(dbg,is_info,&length,
+            &version,&abbrev_offset,&address_size,
+            &offset_size,&extension_size,&signature,
+            &typeoffset,&next_offset,&unit_type,&err);
+        if (res == DW_DLV_NO_ENTRY) {
+            return;
+        }
+        if (res == DW_DLV_ERROR) {
+            json_error(dbg,section,"dwarf_next_cu_header_d"
+                " failed",err);
+            return;
+        }
+        res = dwarf_siblingof_b(dbg,0,is_info,&cu_die,&err);
+        if (res == DW_DLV_OK) {
+            res = dwarf_die_offsets(cu_die,&goff,&loff,&err);
+        }
+        if (res != DW_DLV_OK) {
+            if (cu_die) {
+                dwarf_dealloc_die(cu_die);
+            }
+            json_error(dbg,section,"cannot read the CU DIE",err);
+            return;
+        }
+        cu.jc_section = section;
+        cu.jc_is_info = is_info;
+        cu.jc_offset = goff - loff;
+        cu.jc_version = version;
+        cu.jc_offset_size = offset_size;
+        if (glflags.gf_json_records & JSON_RECORDS_DIES) {
+            json_cu_header(&cu,length,address_size,
+                abbrev_offset,unit_type,&signature);
+            res = json_die_and_siblings(dbg,cu_die,&cu,0,&err);
+            if (res == DW_DLV_ERROR) {
+                json_error(dbg,section,"cannot read a DIE",err);
+                err = 0;
+            }
+        }
+        if (is_info &&
+            (glflags.gf_json_records & JSON_RECORDS_LINES)) {
+            res = json_lines(dbg,cu_die,&cu,&err);
+            if (res == DW_DLV_ERROR) {
+                json_error(dbg,".debug_line",
+                    "cannot read the line table",err);
+                err = 0;
+            }
+        }
+        dwarf_dealloc_die(cu_die);
+        ++units;
+        if (units >= glflags.break_after_n_units) {
+            return;
+        }
+    }
+}
+
+/*  The CFA rule of each row, as
+    {"pc":..,"register":..,"offset":..} or
+    {"pc":..,"expression":"hex"}. */
+static int
+json_fde_rows(Dwarf_Fde fde, Dwarf_Addr low_pc,
+    Dwarf_Unsigned func_length, Dwarf_Error *err)
+{
+    struct esb_s *r = &json_record;
+    Dwarf_Addr pc = low_pc;
+    Dwarf_Addr end = low_pc + func_length;
+
+    dd_json_array_begin(r,"cfa");
+    while (pc < end) {
+        Dwarf_Small value_type = 0;
+        Dwarf_Unsigned offset_relevant = 0;
+        Dwarf_Unsigned reg = 0;
+        Dwarf_Unsigned offset = 0;
+        Dwarf_Block block;
+        Dwarf_Addr row_pc = 0;
+        Dwarf_Bool has_more_rows = FALSE;
+        Dwarf_Addr subsequent_pc = 0;
+        int res = 0;
+
+        memset(&block,0,sizeof(block));
+        res = dwarf_get_fde_info_for_cfa_reg3_b(fde,pc,
+            &value_type,&offset_relevant,&reg,&offset,&block,
+            &row_pc,&has_more_rows,&subsequent_pc,err);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        if (res == DW_DLV_NO_ENTRY) {
+            break;
+        }
+        dd_json_object_begin(r,0);
+        dd_json_unsigned(r,"pc",row_pc);
+        if (value_type == DW_EXPR_OFFSET ||
+            value_type == DW_EXPR_VAL_OFFSET) {
+            dd_json_unsigned(r,"register",reg);
+            if (offset_relevant) {
+                dd_json_signed(r,"offset",(Dwarf_Signed)offset);
+            }
+        } else {
+            dd_json_bytes(r,"expression",
+                (const unsigned char *)block.bl_data,
+                block.bl_len);
+        }
+        dd_json_object_end(r);
+        if (!has_more_rows || subsequent_pc <= pc) {
+            break;
+        }
+        pc = subsequent_pc;
+    }
+    dd_json_array_end(r);
+    return DW_DLV_OK;
+}
+
+static void
+json_frames(Dwarf_Debug dbg, Dwarf_Bool want_eh)
+{
+    struct esb_s *r = &json_record;
+    const char *section = want_eh? ".eh_frame":".debug_frame";
+    Dwarf_Cie *cie_data = 0;
+    Dwarf_Signed cie_count = 0;
+    Dwarf_Fde *fde_data = 0;
+    Dwarf_Signed fde_count = 0;
+    Dwarf_Signed i = 0;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    if (want_eh) {
+        res = dwarf_get_fde_list_eh(dbg,&cie_data,&cie_count,
+            &fde_data,&fde_count,&err);
+    } else {
+        res = dwarf_get_fde_list(dbg,&cie_data,&cie_count,
+            &fde_data,&fde_count,&err);
+    }
+    if (res == DW_DLV_NO_ENTRY) {
+        return;
+    }
+    if (res == DW_DLV_ERROR) {
+        json_error(dbg,section,"cannot read the CIEs and FDEs",err);
+        return;
+    }
+    for (i = 0; i < cie_count &&
+        i < glflags.break_after_n_units; ++i) {
+        Dwarf_Unsigned bytes_in_cie = 0;
+        Dwarf_Small version = 0;
+        char *augmenter = 0;
+        Dwarf_Unsigned code_align = 0;
+        Dwarf_Signed data_align = 0;
+        Dwarf_Half return_reg = 0;
+        Dwarf_Small *instrs = 0;
+        Dwarf_Unsigned instrs_len = 0;
+        Dwarf_Half offset_size = 0;
+        Dwarf_Off cie_off = 0;
+
+        res = dwarf_get_cie_info_b(cie_data[i],&bytes_in_cie,
+            &version,&augmenter,&code_align,&data_align,
+            &return_reg,&instrs,&instrs_len,&offset_size,&err);
+        if (res == DW_DLV_OK) {
+            res = dwarf_cie_section_offset(dbg,cie_data[i],
+                &cie_off,&err);
+        }
+        if (res != DW_DLV_OK) {
+            json_error(dbg,section,"cannot read a CIE",err);
+            break;
+        }
+        dd_json_begin(r,"cie");
+        dd_json_string(r,"section",section);
+        dd_json_unsigned(r,"index",(Dwarf_Unsigned)i);
+        dd_json_unsigned(r,"offset",cie_off);
+        dd_json_unsigned(r,"length",bytes_in_cie);
+        dd_json_unsigned(r,"version",version);
+        dd_json_string(r,"augmentation",augmenter);
+        dd_json_unsigned(r,"code_alignment_factor",code_align);
+        dd_json_signed(r,"data_alignment_factor",data_align);
+        dd_json_unsigned(r,"return_address_register",return_reg);
+        dd_json_bytes(r,"initial_instructions",instrs,instrs_len);
+        dd_json_end(r);
+    }
+    for (i = 0; i < fde_count &&
+        i < glflags.break_after_n_units; ++i) {
+        Dwarf_Addr low_pc = 0;
+        Dwarf_Unsigned func_length = 0;
+        Dwarf_Small *fde_bytes = 0;
+        Dwarf_Unsigned fde_byte_length = 0;
+        Dwarf_Off cie_offset = 0;
+        Dwarf_Signed cie_index = 0;
+        Dwarf_Off fde_offset = 0;
+
+        res = dwarf_get_fde_range(fde_data[i],&low_pc,
+            &func_length,&fde_bytes,&fde_byte_length,
+            &cie_offset,&cie_index,&fde_offset,&err);
+        if (res != DW_DLV_OK) {
+            json_error(dbg,section,"cannot read an FDE",err);
+            break;
+        }
+        dd_json_begin(r,"fde");
+        dd_json_string(r,"section",section);
+        dd_json_unsigned(r,"index",(Dwarf_Unsigned)i);
+        dd_json_unsigned(r,"offset",fde_offset);
+        dd_json_unsigned(r,"length",fde_byte_length);
+        dd_json_unsigned(r,"cie_offset",cie_offset);
+        dd_json_signed(r,"cie_index",cie_index);
+        dd_json_unsigned(r,"low_pc",low_pc);
+        dd_json_unsigned(r,"func_length",func_length);
+        res = json_fde_rows(fde_data[i],low_pc,func_length,&err);
+        if (res == DW_DLV_ERROR) {
+            /*  Finish this record, the rows are cut short. */
+            dd_json_array_end(r);
+            dd_json_string(r,"error",dwarf_errmsg(err));
+            dwarf_dealloc_error(dbg,err);
+            err = 0;
+        }
+        dd_json_end(r);
+    }
+    dwarf_dealloc_fde_cie_list(dbg,cie_data,cie_count,
+        fde_data,fde_count);
+}
+
+static void
+json_aranges(Dwarf_Debug dbg)
+{
+    struct esb_s *r = &json_record;
+    Dwarf_Arange *aranges = 0;
+    Dwarf_Signed count = 0;
+    Dwarf_Signed i = 0;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    res = dwarf_get_aranges(dbg,&aranges,&count,&err);
+    if (res == DW_DLV_NO_ENTRY) {
+        return;
+    }
+    if (res == DW_DLV_ERROR) {
+        json_error(dbg,".debug_aranges","cannot read aranges",err);
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        Dwarf_Unsigned segment = 0;
+        Dwarf_Unsigned segment_entry_size = 0;
+        Dwarf_Addr start = 0;
+        Dwarf_Unsigned length = 0;
+        Dwarf_Off cu_die_offset = 0;
+        Dwarf_Off cu_offset = 0;
+
+        res = dwarf_get_arange_info_b(aranges[i],&segment,
+            &segment_entry_size,&start,&length,
+            &cu_die_offset,&err);
+        if (res == DW_DLV_OK) {
+            res = dwarf_get_arange_cu_header_offset(aranges[i],
+                &cu_offset,&err);
+        }
+        if (res == DW_DLV_ERROR) {
+            json_error(dbg,".debug_aranges",
+                "cannot read an arange",err);
+            break;
+        }
+        dd_json_begin(r,"arange");
+        dd_json_unsigned(r,"address",start);
+        dd_json_unsigned(r,"length",length);
+        dd_json_unsigned(r,"cu",cu_offset);
+        dd_json_unsigned(r,"cu_die",cu_die_offset);
+        if (segment_entry_size) {
+            dd_json_unsigned(r,"segment",segment);
+        }
+        dd_json_end(r);
+    }
+    for (i = 0; i < count; ++i) {
+        dwarf_dealloc(dbg,aranges[i],DW_DLA_ARANGE);
+    }
+    dwarf_dealloc(dbg,aranges,DW_DLA_LIST);
+}
+
+static void
+json_names(Dwarf_Debug dbg)
+{
+    struct esb_s *r = &json_record;
+    Dwarf_Global *globals = 0;
+    Dwarf_Signed count = 0;
+    Dwarf_Signed i = 0;
+    Dwarf_Error err = 0;
+    int res = 0;
+
+    res = dwarf_get_globals(dbg,&globals,&count,&err);
+    if (res == DW_DLV_NO_ENTRY) {
+        return;
+    }
+    if (res == DW_DLV_ERROR) {
+        json_error(dbg,".debug_pubnames","cannot read the names",
+            err);
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        char *name = 0;
+        Dwarf_Off die_offset = 0;
+        Dwarf_Off cu_die_offset = 0;
+        Dwarf_Half tag = 0;
+
+        res = dwarf_global_name_offsets(globals[i],&name,
+            &die_offset,&cu_die_offset,&err);
+        if (res == DW_DLV_ERROR) {
+            json_error(dbg,".debug_pubnames",
+                "cannot read a name",err);
+            break;
+        }
+        dd_json_begin(r,"name");
+        dd_json_string(r,"name",name);
+        dd_json_unsigned(r,"die",die_offset);
+        dd_json_unsigned(r,"cu_die",cu_die_offset);
+        /*  .debug_names says what the DIE is. */
+        tag = dwarf_global_tag_number(globals[i]);
+        if (tag) {
+            dd_json_string(r,"tag",get_TAG_name(tag,FALSE));
+        }
+        dd_json_end(r);
+    }
+    dwarf_globals_dealloc(dbg,globals,count);
+}
+
+void
+print_json(Dwarf_Debug dbg)
+{
+    unsigned records = glflags.gf_json_records;
+
+    esb_constructor(&json_record);
+    if (records & JSON_RECORDS_SECTIONS) {
+        json_sections(dbg);
+    }
+    if (records & (JSON_RECORDS_DIES|JSON_RECORDS_LINES)) {
+        json_units(dbg,TRUE);
+    }
+    if (records & JSON_RECORDS_DIES) {
+        json_units(dbg,FALSE);
+    }
+    if (records & JSON_RECORDS_ARANGES) {
+        json_aranges(dbg);
+    }
+    if (records & JSON_RECORDS_NAMES) {
+        json_names(dbg);
+    }
+    if (records & JSON_RECORDS_FRAMES) {
+        json_frames(dbg,FALSE);
+    }
+    if (records & JSON_RECORDS_EH_FRAMES) {
+        json_frames(dbg,TRUE);
+    }
+    esb_destructor(&json_record);
+}
@@ -42,6 +42,7 @@ Portions Copyright 2015-2015 Google, Inc. All Rights Reserved
 #include "dd_esb_using_functions.h"
 #include "dd_sanitized.h"
 #include "dd_uri.h"
+#include "dd_output.h"
 
 #include "print_sections.h"
 
@@ -449,7 +450,7 @@ process_line_table(Dwarf_Debug dbg,
                 &newstatement, lt_err);
             if (nsres == DW_DLV_OK) {
                 if (newstatement && glflags.gf_do_print_dwarf) {
-                    printf(" %s","NS");
+                    dd_output_string(" NS");
                 }
             } else if (nsres == DW_DLV_ERROR) {
                 struct esb_s m;
@@ -474,7 +475,7 @@ process_line_table(Dwarf_Debug dbg,
                 &new_basic_block, lt_err);
             if (nsres == DW_DLV_OK) {
                 if (new_basic_block && glflags.gf_do_print_dwarf) {
-                    printf(" %s","BB");
+                    dd_output_string(" BB");
                 }
             } else if (nsres == DW_DLV_ERROR) {
                 struct esb_s m;
@@ -497,7 +498,7 @@ process_line_table(Dwarf_Debug dbg,
             if (nsres == DW_DLV_OK) {
                 if (lineendsequence &&
                     glflags.gf_do_print_dwarf) {
-                    printf(" %s", "ET");
+                    dd_output_string(" ET");
                 }
             } else if (nsres == DW_DLV_ERROR) {
                 struct esb_s m;
@@ -542,10 +543,10 @@ process_line_table(Dwarf_Debug dbg,
                 return disres;
             }
             if (prologue_end && !is_actuals_table) {
-                printf(" PE");
+                dd_output_string(" PE");
             }
             if (epilogue_begin && !is_actuals_table) {
-                printf(" EB");
+                dd_output_string(" EB");
             }
             if (isa && !is_logicals_table) {
                 printf(" IS=0x%" DW_PR_DUx, isa);
@@ -621,7 +622,7 @@ process_line_table(Dwarf_Debug dbg,
                     &urs);
                 esb_append(&urs,"\"");
                 if (glflags.gf_do_print_dwarf) {
-                    printf("%s",esb_get_string(&urs));
+                    dd_output_esb(&urs);
                 }
                 esb_destructor(&urs);
                 esb_empty_string(&lastsrc);
@@ -633,7 +634,7 @@ process_line_table(Dwarf_Debug dbg,
             }
         }
         if (glflags.gf_do_print_dwarf) {
-            printf("\n");
+            dd_output_char('\n');
         }
         dwarf_dealloc(dbg,lsrc_filename, DW_DLA_STRING);
         lsrc_filename = 0;
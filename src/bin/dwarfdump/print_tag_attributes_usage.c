@@ -47,6 +47,7 @@ Portions Copyright 2007-2021 David Anderson. All rights reserved.
 #include "dd_helpertree.h"
 #include "dd_tag_common.h"
 #include "dd_attr_form.h"
+#include "dd_workers.h"
 
 static int pd_dwarf_names_print_on_error = 1;
 
@@ -344,3 +345,91 @@ reset_usage_rate_tag_trees(void)
         rate_tag_tree[i].found = 0;
     }
 }
+
+/*  --threads=<n>: a worker starts the usage counts from
+    zero and writes what it counted, in table order,
+    for this process to add to its own. */
+enum usage_walk_e {
+    usage_zero,
+    usage_write,
+    usage_merge
+};
+
+#ifdef HAVE_USAGE_TAG_ATTR
+static int
+walk_one_count(enum usage_walk_e what, FILE *f,
+    unsigned int *count)
+{
+    unsigned int c = 0;
+
+    switch (what) {
+    case usage_zero:
+        *count = 0;
+        return DW_DLV_OK;
+    case usage_write:
+        return dd_report_write(f,count,sizeof(*count));
+    default: break;
+    }
+    if (dd_report_read(f,&c,sizeof(c)) != DW_DLV_OK) {
+        return DW_DLV_ERROR;
+    }
+    *count += c;
+    return DW_DLV_OK;
+}
+#endif /* HAVE_USAGE_TAG_ATTR */
+
+static int
+walk_usage_counts(enum usage_walk_e what, FILE *f)
+{
+#ifdef HAVE_USAGE_TAG_ATTR
+    unsigned i = 0;
+    int res = DW_DLV_OK;
+
+    for (i = 0; res == DW_DLV_OK && i < DW_TAG_last; ++i) {
+        res = walk_one_count(what,f,&tag_usage[i]);
+    }
+    for (i = 0; res == DW_DLV_OK &&
+        i < sizeof(usage_tag_tree)/sizeof(usage_tag_tree[0]);
+        ++i) {
+        Usage_Tag_Tree *usage_ptr = usage_tag_tree[i];
+
+        for ( ; res == DW_DLV_OK && usage_ptr && usage_ptr->tag;
+            ++usage_ptr) {
+            res = walk_one_count(what,f,&usage_ptr->count);
+        }
+    }
+    for (i = 0; res == DW_DLV_OK &&
+        i < sizeof(usage_tag_attr)/sizeof(usage_tag_attr[0]);
+        ++i) {
+        Usage_Tag_Attr *usage_ptr = usage_tag_attr[i];
+
+        for ( ; res == DW_DLV_OK && usage_ptr && usage_ptr->attr;
+            ++usage_ptr) {
+            res = walk_one_count(what,f,&usage_ptr->count);
+        }
+    }
+    return res;
+#else
+    (void)what;
+    (void)f;
+    return DW_DLV_OK;
+#endif /* HAVE_USAGE_TAG_ATTR */
+}
+
+void
+tag_usage_worker_begin(void)
+{
+    walk_usage_counts(usage_zero,0);
+}
+
+int
+tag_usage_worker_write(FILE *f)
+{
+    return walk_usage_counts(usage_write,f);
+}
+
+int
+tag_usage_worker_merge(FILE *f)
+{
+    return walk_usage_counts(usage_merge,f);
+}
@@ -621,6 +621,8 @@ main(int argc, char **argv)
             DW_DLC_ELF_OFFSET_SIZE_32;
         unsigned machine = EM_386; /* from elf.h */
         int output_v4_test = 0;
+        bool use_addrx = false;
+        std::string extras_with_addrx;
 
         unsigned global_elfclass = 0;
 
@@ -640,6 +642,8 @@ main(int argc, char **argv)
             {"show-reloc-details",dwno_argument,0,'r'},
             {"high-pc-as-const",dwno_argument,0,'h'},
             {"add-skip-branch-ops",dwno_argument,0,1007},
+            {"default-form-strx",dwno_argument,0,1008},
+            {"use-addrx",dwno_argument,0,1009},
             {0,0,0,0},
         };
         // -p is pointer size
@@ -698,6 +702,16 @@ main(int argc, char **argv)
                 //{"add-skip-branch-ops",dwno_argument,0,1007},
                 cmdoptions.addskipbranch = true;
                 break;
+            case 1008:
+                //{"default-form-strx",dwno_argument,0,1008},
+                // DWARF5 only.
+                cmdoptions.defaultInfoStringForm = DW_FORM_strx;
+                break;
+            case 1009:
+                //{"use-addrx",dwno_argument,0,1009},
+                // DWARF5 only.
+                use_addrx = true;
+                break;
             case 'c':
                 // At present we can only create a single
                 // cu in the output of the libdwarf producer.
@@ -789,6 +803,12 @@ main(int argc, char **argv)
             machine = EM_X86_64; /* from elf.h */
         }
 
+        if (use_addrx) {
+            extras_with_addrx = dwarf_extras;
+            extras_with_addrx.append(",use_addrx=1");
+            dwarf_extras = extras_with_addrx.c_str();
+        }
+
         if (whichinput == OptReadBin) {
             createIrepFromBinary(infile,Irep);
         } else if (whichinput == OptReadText) {
@@ -860,7 +880,7 @@ main(int argc, char **argv)
             exit(EXIT_FAILURE);
         }
         if (force_empty_dnames) {
-            /*  Fills out a default dnames for testing. */
+            /*  Enables .debug_names, built from the DIE names. */
             res = dwarf_force_dnames(dbg,0,&err);
             if (res != DW_DLV_OK) {
                 cerr << "dwarfgen: "
@@ -79,6 +79,7 @@
 #include "dwarf_dsc.h"
 #include "dwarf_string.h"
 #include "dwarf_str_offsets.h"
+#include "dwarf_expression.h"
 
 /* if DEBUG_ALLOC is defined a lot of stdout is generated here. */
 #undef DEBUG_ALLOC
@@ -136,6 +137,33 @@ int dwarf_set_de_alloc_flag(int v)
     return ov;
 }
 
+/*  The counts for one DW_DLA type, kept by
+    _dwarf_get_alloc() and dwarf_dealloc(). */
+int
+dwarf_get_alloc_stats(Dwarf_Debug dbg,
+    unsigned alloc_type,
+    Dwarf_Unsigned *alloc_count,
+    Dwarf_Unsigned *alloc_bytes,
+    Dwarf_Unsigned *dealloc_count)
+{
+    if (!dbg || dbg->de_magic != DBG_IS_VALID) {
+        return DW_DLV_NO_ENTRY;
+    }
+    if (!alloc_type || alloc_type >= ALLOC_AREA_INDEX_TABLE_MAX) {
+        return DW_DLV_NO_ENTRY;
+    }
+    if (alloc_count) {
+        *alloc_count = dbg->de_alloc_count[alloc_type];
+    }
+    if (alloc_bytes) {
+        *alloc_bytes = dbg->de_alloc_bytes[alloc_type];
+    }
+    if (dealloc_count) {
+        *dealloc_count = dbg->de_dealloc_count[alloc_type];
+    }
+    return DW_DLV_OK;
+}
+
 void
 _dwarf_error_destructor(void *m)
 {
@@ -371,7 +399,8 @@ struct ial_s alloc_instance_basics[ALLOC_AREA_INDEX_TABLE_MAX] = {
     {sizeof(struct Dwarf_Chain_s),MULTIPLY_NO, 0, 0},
 
     /* 0x20 DW_DLA_CU_CONTEXT */
-    {sizeof(struct Dwarf_CU_Context_s),MULTIPLY_NO,  0, 0},
+    {sizeof(struct Dwarf_CU_Context_s),MULTIPLY_NO,  0,
+        _dwarf_cu_context_destructor},
 
     /* 0x21 DW_DLA_FRAME */
     {sizeof(struct Dwarf_Frame_s),MULTIPLY_NO,
@@ -495,6 +524,10 @@ struct ial_s alloc_instance_basics[ALLOC_AREA_INDEX_TABLE_MAX] = {
 
     /* 0x41 65 DW_DLA_DEBUG_ADDR */
     {sizeof(struct Dwarf_Debug_Addr_Table_s),MULTIPLY_NO, 0,0},
+
+    /* 0x42 66 DW_DLA_EXPR_PROGRAM */
+    {sizeof(struct Dwarf_Expr_Program_s),MULTIPLY_NO, 0,
+        _dwarf_expr_program_destructor},
 };
 
 /*  We are simply using the incoming pointer as the key-pointer.
@@ -621,6 +654,8 @@ _dwarf_get_alloc(Dwarf_Debug dbg,
     if (!alloc_mem) {
         return NULL;
     }
+    dbg->de_alloc_count[type]++;
+    dbg->de_alloc_bytes[type] += size;
     {
         char * ret_mem = alloc_mem + DW_RESERVE;
         void *key = ret_mem;
@@ -969,6 +1004,9 @@ dwarf_dealloc(Dwarf_Debug dbg,
             In any case, we simply don't worry about it.
             Not Supposed To Happen. */
     }
+    if (dbg) {
+        dbg->de_dealloc_count[type]++;
+    }
     r->rd_dbg  = (void *)(uintptr_t)0xfeadbeef;
     r->rd_length = 0;
     r->rd_type = 0;
@@ -1113,6 +1151,7 @@ _dwarf_free_all_of_one_debug(Dwarf_Debug dbg)
 
     _dwarf_dealloc_rnglists_context(dbg);
     _dwarf_dealloc_loclists_context(dbg);
+    _dwarf_destroy_die_ranges_cache(dbg);
     if (dbg->de_printf_callback.dp_buffer &&
         !dbg->de_printf_callback.dp_buffer_user_provided ) {
         free(dbg->de_printf_callback.dp_buffer);
@@ -35,10 +35,8 @@ struct Dwarf_Error_s * _dwarf_special_no_dbg_error_malloc(void);
 
 void _dwarf_error_destructor(void *);
 
-/*  ALLOC_AREA_INDEX_TABLE_MAX is the size of the
-    struct ial_s index_into_allocated array in dwarf_alloc.c
-*/
-#define ALLOC_AREA_INDEX_TABLE_MAX 66
+/*  ALLOC_AREA_INDEX_TABLE_MAX is in dwarf_opaque.h
+    as Dwarf_Debug_s keeps counts by alloc type. */
 
 void _dwarf_add_to_static_err_list(Dwarf_Error err);
 void _dwarf_flush_static_error_list(void);
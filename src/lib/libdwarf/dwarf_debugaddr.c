@@ -34,6 +34,7 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stddef.h> /* NULL size_t */
 #include <stdio.h>  /* debug printf */
+#include <stdlib.h> /* free() */
 #include <string.h> /* memset() strlen() */
 
 #if defined(_WIN32) && defined(HAVE_STDAFX_H)
@@ -300,3 +301,57 @@ dwarf_dealloc_debug_addr_table(Dwarf_Debug_Addr_Table dw_dat)
     dw_dat->da_magic = 0;
     dwarf_dealloc(dbg,dw_dat,DW_DLA_DEBUG_ADDR);
 }
+
+/*  Builds context->cc_addr_table, this CU's slice of
+    .debug_addr in host byte order, on the first index
+    lookup. The slice is bounded by the DWARF5 table
+    header preceding DW_AT_addr_base; when there is no
+    such header, or the header disagrees with the CU
+    address size, no table is built and lookups take
+    the per-index path. Never reports an error. */
+void
+_dwarf_build_cu_addr_table(Dwarf_Debug dbg,
+    Dwarf_CU_Context context)
+{
+    struct Dwarf_Section_s *sec = &dbg->de_debug_addr;
+    Dwarf_Unsigned base = context->cc_addr_base;
+    Dwarf_Unsigned table_end = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Half     address_size = context->cc_address_size;
+    int res = 0;
+
+    context->cc_addr_table_tried = TRUE;
+    if (!address_size || address_size > sizeof(Dwarf_Addr)) {
+        return;
+    }
+    res = _dwarf_find_dw5_table_end(dbg,sec,base,&table_end,0);
+    if (res != DW_DLV_OK) {
+        return;
+    }
+    /*  The header's address_size and
+        segment_selector_size bytes. */
+    if (sec->dss_data[base-2] != address_size ||
+        sec->dss_data[base-1] != 0) {
+        return;
+    }
+    count = (table_end - base)/address_size;
+    context->cc_addr_table = (Dwarf_Addr *)
+        _dwarf_make_native_table(dbg,sec->dss_data+base,
+        address_size,count);
+    if (context->cc_addr_table) {
+        context->cc_addr_table_count = count;
+    }
+}
+
+/*  A split CU takes DW_AT_addr_base from its skeleton
+    after an addrx lookup may already have failed to
+    build a table. Whoever sets the base calls this
+    so the next lookup builds the table again. */
+void
+_dwarf_discard_cu_addr_table(Dwarf_CU_Context context)
+{
+    free(context->cc_addr_table);
+    context->cc_addr_table = 0;
+    context->cc_addr_table_count = 0;
+    context->cc_addr_table_tried = FALSE;
+}
@@ -1174,12 +1174,10 @@ _dwarf_initialize_bucket_details(Dwarf_Dnames_Head dn,
             }
         }
         if (j >= dn->dn_bucket_count) {
-            /* Ran off end */
+            /*  Ran off end. The last bucket holds the
+                names from its index through dn_name_count. */
             curbucket->db_collisioncount =
-                dn->dn_name_count - curbucket->db_nameindex;
-            if (!curbucket->db_collisioncount) {
-                curbucket->db_collisioncount = 1;
-            }
+                dn->dn_name_count - curbucket->db_nameindex + 1;
             break;
         }
     }
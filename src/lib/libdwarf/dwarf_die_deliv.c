@@ -30,6 +30,7 @@
 
 #include <config.h>
 
+#include <stdlib.h> /* free() */
 #include <string.h> /* memcmp() memcpy() memset() strcmp() strlen() */
 
 #if defined(_WIN32) && defined(HAVE_STDAFX_H)
@@ -600,6 +601,22 @@ finish_cu_context_via_cudie_inner(
     return resdwo;
 }
 
+/*  Frees the resolved .debug_addr and .debug_str_offsets
+    views (see _dwarf_build_cu_addr_table()), which are
+    plain malloc space owned by the context. */
+void
+_dwarf_cu_context_destructor(void *m)
+{
+    Dwarf_CU_Context context = (Dwarf_CU_Context)m;
+
+    free(context->cc_addr_table);
+    context->cc_addr_table = 0;
+    context->cc_addr_table_count = 0;
+    free(context->cc_str_offsets_table);
+    context->cc_str_offsets_table = 0;
+    context->cc_str_offsets_table_count = 0;
+}
+
 static void
 local_dealloc_cu_context(Dwarf_Debug dbg,
     Dwarf_CU_Context context)
@@ -1179,6 +1196,7 @@ find_cu_die_base_fields(Dwarf_Debug dbg,
                     error);
                 if (udres == DW_DLV_OK) {
                     cucon->cc_str_offsets_base_present = TRUE;
+                    _dwarf_discard_cu_str_offsets_table(cucon);
                 } else {
                     local_attrlist_dealloc(dbg,atcount,alist);
                     /* Something is badly wrong. */
@@ -1215,6 +1233,7 @@ find_cu_die_base_fields(Dwarf_Debug dbg,
                     error);
                 if (udres == DW_DLV_OK) {
                     cucon->cc_addr_base_present = TRUE;
+                    _dwarf_discard_cu_addr_table(cucon);
                 } else {
                     local_attrlist_dealloc(dbg,atcount,alist);
                     /* Something is badly wrong. */
@@ -1400,7 +1400,8 @@ this_rel_is_a_section_dwarf_related(
         return DW_DLV_ERROR;
     }
     gstarg = ep->f_shdr+oksecnum;
-    if (!gstarg->gh_is_dwarf) {
+    if (!gstarg->gh_is_dwarf ||
+        _dwarf_section_filtered_out(gstarg->gh_namestring)) {
         *oksecnum_out = 0; /* no reloc needed. */
         return DW_DLV_OK;
     }
@@ -622,6 +622,7 @@ _dwarf_elf_object_access_internals_init(
     Dwarf_Unsigned i  = 0;
     struct Dwarf_Obj_Access_Interface_a_s *localdoas;
     int res = 0;
+    int found_relocations = FALSE;
 
     /*  Must malloc as _dwarf_destruct_elf_access()
         forces that due to other uses. */
@@ -679,23 +680,6 @@ _dwarf_elf_object_access_internals_init(
         localdoas = 0;
         return res;
     }
-    /* We are not looking at symbol strings for now. */
-    res = _dwarf_load_elf_symstr(intfc,errcode);
-    if (res == DW_DLV_ERROR) {
-        localdoas->ai_object = intfc;
-        localdoas->ai_methods = 0;
-        _dwarf_destruct_elf_nlaccess(localdoas);
-        localdoas = 0;
-        return res;
-    }
-    res  = _dwarf_load_elf_symtab_symbols(intfc,errcode);
-    if (res == DW_DLV_ERROR) {
-        localdoas->ai_object = intfc;
-        localdoas->ai_methods = 0;
-        _dwarf_destruct_elf_nlaccess(localdoas);
-        localdoas = 0;
-        return res;
-    }
     for ( i = 1; i < intfc->f_loc_shdr.g_count; ++i) {
         struct generic_shdr *shp = 0;
         Dwarf_Unsigned section_type = 0;
@@ -730,6 +714,33 @@ _dwarf_elf_object_access_internals_init(
             localdoas = 0;
             return res;
         }
+        if (shp->gh_rels) {
+            found_relocations = TRUE;
+        }
+    }
+    if (!found_relocations) {
+        /*  The symbols are only used in applying
+            relocations to DWARF sections. */
+        free(localdoas);
+        localdoas = 0;
+        return DW_DLV_OK;
+    }
+    /* We are not looking at symbol strings for now. */
+    res = _dwarf_load_elf_symstr(intfc,errcode);
+    if (res == DW_DLV_ERROR) {
+        localdoas->ai_object = intfc;
+        localdoas->ai_methods = 0;
+        _dwarf_destruct_elf_nlaccess(localdoas);
+        localdoas = 0;
+        return res;
+    }
+    res  = _dwarf_load_elf_symtab_symbols(intfc,errcode);
+    if (res == DW_DLV_ERROR) {
+        localdoas->ai_object = intfc;
+        localdoas->ai_methods = 0;
+        _dwarf_destruct_elf_nlaccess(localdoas);
+        localdoas = 0;
+        return res;
     }
     free(localdoas);
     localdoas = 0;
@@ -663,6 +663,14 @@ static const char _dwarf_errmsgs[DW_DLE_LAST+1][DW_MAX_MSG_LEN] = {
     "Symbols section size bad"},
 {"DW_DLE_PE_SECTION_SIZE_ERROR(491) Corrupt PE object. "
     "Section size too large."},
-{"DW_DLE_DEBUG_ADDR_ERROR(492) Problem reading .debug_addr"}
+{"DW_DLE_DEBUG_ADDR_ERROR(492) Problem reading .debug_addr"},
+{"DW_DLE_EXPRESSION_ERROR(493) A DWARF expression could not "
+    "be compiled or evaluated"},
+{"DW_DLE_PRO_STREAM_ERROR(494) A per-CU streaming producer "
+    "call is not possible in this state or the sink failed"},
+{"DW_DLE_PRO_COMPRESS_ERROR(495) Compressing a producer "
+    "output section failed"},
+{"DW_DLE_PRO_COMPRESS_UNSUPPORTED(496) This libdwarfp "
+    "cannot do the compress_debug_sections type asked for"}
 };
 #endif /* DWARF_ERRMSG_LIST_H */
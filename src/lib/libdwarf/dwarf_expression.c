@@ -0,0 +1,1021 @@
+/*
+Copyright (C) 2026 agent. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  Compiles a DWARF expression once into a short array
+    of fixed-size instructions and evaluates that
+    array against caller-supplied register and memory
+    access.
+
+    Compilation folds constant sub-expressions
+    (so DW_OP_lit4 DW_OP_lit8 DW_OP_mul becomes a
+    single constant, DW_OP_breg7 8 DW_OP_plus_uconst 16
+    becomes DW_OP_breg7 24) and resolves DW_OP_addrx
+    and DW_OP_constx through .debug_addr
+    so the evaluator never touches section data.
+    No folding is done across a branch target. */
+
+#include <config.h>
+
+#include <stddef.h> /* NULL size_t */
+#include <stdlib.h> /* calloc() free() malloc() */
+#include <string.h> /* memset() */
+
+#if defined(_WIN32) && defined(HAVE_STDAFX_H)
+#include "stdafx.h"
+#endif /* HAVE_STDAFX_H */
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h> /* uintptr_t */
+#endif /* HAVE_STDINT_H */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h"
+#include "dwarf_base_types.h"
+#include "dwarf_opaque.h"
+#include "dwarf_alloc.h"
+#include "dwarf_error.h"
+#include "dwarf_util.h"
+#include "dwarf_loc.h"
+#include "dwarf_expression.h"
+#include "dwarf_string.h"
+
+void
+_dwarf_expr_program_destructor(void *m)
+{
+    Dwarf_Expr_Program prog = (Dwarf_Expr_Program)m;
+
+    free(prog->ep_insns);
+    prog->ep_insns = 0;
+    prog->ep_insn_count = 0;
+    prog->ep_magic = 0;
+}
+
+static void
+expr_error(Dwarf_Debug dbg, Dwarf_Error *error,
+    const char *msg)
+{
+    dwarfstring m;
+
+    dwarfstring_constructor(&m);
+    dwarfstring_append(&m,"DW_DLE_EXPRESSION_ERROR: ");
+    dwarfstring_append(&m,(char *)msg);
+    _dwarf_error_string(dbg,error,DW_DLE_EXPRESSION_ERROR,
+        dwarfstring_string(&m));
+    dwarfstring_destructor(&m);
+}
+
+/*  Arithmetic is on the DWARF generic type: an
+    unsigned integer the size of an address. */
+static Dwarf_Unsigned
+addr_mask(Dwarf_Unsigned v, Dwarf_Small address_size)
+{
+    if (address_size >= sizeof(Dwarf_Unsigned)) {
+        return v;
+    }
+    return v & ((((Dwarf_Unsigned)1) << (address_size*8)) -1);
+}
+
+static Dwarf_Signed
+addr_signed(Dwarf_Unsigned v, Dwarf_Small address_size)
+{
+    if (address_size < sizeof(Dwarf_Unsigned)) {
+        Dwarf_Unsigned signbit =
+            ((Dwarf_Unsigned)1) << (address_size*8 -1);
+        v = addr_mask(v,address_size);
+        if (v & signbit) {
+            v |= ~((signbit << 1) -1);
+        }
+    }
+    return (Dwarf_Signed)v;
+}
+
+static int
+is_binary_code(Dwarf_Small code)
+{
+    return code >= DW_EXPR_I_AND && code <= DW_EXPR_I_NE;
+}
+
+/*  Applies a binary operator. The caller has
+    verified the divisor of DIV and MOD is non-zero. */
+static Dwarf_Unsigned
+apply_binary(Dwarf_Small code, Dwarf_Unsigned l,
+    Dwarf_Unsigned r, Dwarf_Small asize)
+{
+    Dwarf_Signed sl = addr_signed(l,asize);
+    Dwarf_Signed sr = addr_signed(r,asize);
+    Dwarf_Unsigned v = 0;
+    unsigned bits = asize*8;
+
+    switch (code) {
+    case DW_EXPR_I_AND:   v = l & r; break;
+    case DW_EXPR_I_DIV:
+        if (sr == -1) {
+            /* Avoids the trap on minimum-value / -1 */
+            v = (Dwarf_Unsigned)0 - l;
+        } else {
+            v = (Dwarf_Unsigned)(sl / sr);
+        }
+        break;
+    case DW_EXPR_I_MINUS: v = l - r; break;
+    case DW_EXPR_I_MOD:   v = addr_mask(l,asize) %
+        addr_mask(r,asize); break;
+    case DW_EXPR_I_MUL:   v = l * r; break;
+    case DW_EXPR_I_OR:    v = l | r; break;
+    case DW_EXPR_I_PLUS:  v = l + r; break;
+    case DW_EXPR_I_SHL:
+        v = (r >= bits)? 0: l << r;
+        break;
+    case DW_EXPR_I_SHR:
+        v = (r >= bits)? 0: addr_mask(l,asize) >> r;
+        break;
+    case DW_EXPR_I_SHRA:
+        if (r >= bits) {
+            v = (sl < 0)? (Dwarf_Unsigned)-1:0;
+        } else if (sl < 0) {
+            v = ~((~(Dwarf_Unsigned)sl) >> r);
+        } else {
+            v = (Dwarf_Unsigned)sl >> r;
+        }
+        break;
+    case DW_EXPR_I_XOR:   v = l ^ r; break;
+    case DW_EXPR_I_EQ:    v = (sl == sr); break;
+    case DW_EXPR_I_GE:    v = (sl >= sr); break;
+    case DW_EXPR_I_GT:    v = (sl >  sr); break;
+    case DW_EXPR_I_LE:    v = (sl <= sr); break;
+    case DW_EXPR_I_LT:    v = (sl <  sr); break;
+    case DW_EXPR_I_NE:    v = (sl != sr); break;
+    default: break;
+    }
+    return addr_mask(v,asize);
+}
+
+static Dwarf_Unsigned
+apply_unary(Dwarf_Small code, Dwarf_Unsigned v,
+    Dwarf_Small asize)
+{
+    Dwarf_Signed sv = addr_signed(v,asize);
+
+    switch (code) {
+    case DW_EXPR_I_ABS:
+        if (sv < 0) {
+            v = (Dwarf_Unsigned)0 - v;
+        }
+        break;
+    case DW_EXPR_I_NEG: v = (Dwarf_Unsigned)0 - v; break;
+    case DW_EXPR_I_NOT: v = ~v; break;
+    default: break;
+    }
+    return addr_mask(v,asize);
+}
+
+static Dwarf_Small
+binary_code_for_op(Dwarf_Small atom)
+{
+    switch (atom) {
+    case DW_OP_and:   return DW_EXPR_I_AND;
+    case DW_OP_div:   return DW_EXPR_I_DIV;
+    case DW_OP_minus: return DW_EXPR_I_MINUS;
+    case DW_OP_mod:   return DW_EXPR_I_MOD;
+    case DW_OP_mul:   return DW_EXPR_I_MUL;
+    case DW_OP_or:    return DW_EXPR_I_OR;
+    case DW_OP_plus:  return DW_EXPR_I_PLUS;
+    case DW_OP_shl:   return DW_EXPR_I_SHL;
+    case DW_OP_shr:   return DW_EXPR_I_SHR;
+    case DW_OP_shra:  return DW_EXPR_I_SHRA;
+    case DW_OP_xor:   return DW_EXPR_I_XOR;
+    case DW_OP_eq:    return DW_EXPR_I_EQ;
+    case DW_OP_ge:    return DW_EXPR_I_GE;
+    case DW_OP_gt:    return DW_EXPR_I_GT;
+    case DW_OP_le:    return DW_EXPR_I_LE;
+    case DW_OP_lt:    return DW_EXPR_I_LT;
+    case DW_OP_ne:    return DW_EXPR_I_NE;
+    default: break;
+    }
+    return 0;
+}
+
+/*  State while compiling one expression.
+    ec_barrier is the first instruction index that
+    may be folded: instructions before it may be
+    reached by a branch so must stay as they are. */
+struct expr_compile_s {
+    Dwarf_Debug      ec_dbg;
+    Dwarf_CU_Context ec_context;
+    Dwarf_Small      ec_address_size;
+    struct Dwarf_Expr_Insn_s *ec_insns;
+    Dwarf_Unsigned   ec_count;
+    Dwarf_Unsigned   ec_barrier;
+};
+
+static int
+last_is(struct expr_compile_s *c, Dwarf_Unsigned back,
+    Dwarf_Small code)
+{
+    if (c->ec_count < back ||
+        (c->ec_count - back) < c->ec_barrier) {
+        return FALSE;
+    }
+    return c->ec_insns[c->ec_count - back].ei_code == code;
+}
+
+static void
+emit(struct expr_compile_s *c, Dwarf_Small code,
+    Dwarf_Unsigned op1, Dwarf_Unsigned op2)
+{
+    struct Dwarf_Expr_Insn_s *i = c->ec_insns + c->ec_count;
+
+    i->ei_code = code;
+    i->ei_size = 0;
+    i->ei_operand1 = op1;
+    i->ei_operand2 = op2;
+    c->ec_count++;
+}
+
+static void
+emit_const(struct expr_compile_s *c, Dwarf_Unsigned v)
+{
+    emit(c,DW_EXPR_I_CONST,addr_mask(v,c->ec_address_size),0);
+}
+
+static void
+emit_plus_const(struct expr_compile_s *c, Dwarf_Unsigned v)
+{
+    struct Dwarf_Expr_Insn_s *last = 0;
+
+    if (c->ec_count > c->ec_barrier) {
+        last = c->ec_insns + c->ec_count -1;
+        switch (last->ei_code) {
+        case DW_EXPR_I_CONST:
+            last->ei_operand1 = addr_mask(last->ei_operand1 + v,
+                c->ec_address_size);
+            return;
+        case DW_EXPR_I_BREG:
+            last->ei_operand2 += v;
+            return;
+        case DW_EXPR_I_FBREG:
+        case DW_EXPR_I_PLUS_CONST:
+            last->ei_operand1 += v;
+            return;
+        default: break;
+        }
+    }
+    emit(c,DW_EXPR_I_PLUS_CONST,v,0);
+}
+
+static void
+emit_binary(struct expr_compile_s *c, Dwarf_Small code)
+{
+    if (last_is(c,1,DW_EXPR_I_CONST)) {
+        Dwarf_Unsigned r = c->ec_insns[c->ec_count-1].ei_operand1;
+
+        if (last_is(c,2,DW_EXPR_I_CONST) &&
+            !((code == DW_EXPR_I_DIV || code == DW_EXPR_I_MOD) &&
+            !r)) {
+            struct Dwarf_Expr_Insn_s *l =
+                c->ec_insns + c->ec_count -2;
+
+            l->ei_operand1 = apply_binary(code,l->ei_operand1,
+                r,c->ec_address_size);
+            c->ec_count--;
+            return;
+        }
+        if (code == DW_EXPR_I_PLUS || code == DW_EXPR_I_MINUS) {
+            c->ec_count--;
+            emit_plus_const(c,(code == DW_EXPR_I_PLUS)?
+                r: (Dwarf_Unsigned)0 - r);
+            return;
+        }
+    }
+    emit(c,code,0,0);
+}
+
+static void
+emit_unary(struct expr_compile_s *c, Dwarf_Small code)
+{
+    if (last_is(c,1,DW_EXPR_I_CONST)) {
+        struct Dwarf_Expr_Insn_s *l = c->ec_insns + c->ec_count -1;
+
+        l->ei_operand1 = apply_unary(code,l->ei_operand1,
+            c->ec_address_size);
+        return;
+    }
+    emit(c,code,0,0);
+}
+
+/*  Branch targets are byte offsets in the expression.
+    Returns the index of the operator at target,
+    or opcount for the end of the expression. */
+static int
+find_branch_target(Dwarf_Debug dbg,
+    Dwarf_Loc_Expr_Op ops, Dwarf_Unsigned opcount,
+    Dwarf_Unsigned exprlen, Dwarf_Unsigned target,
+    Dwarf_Unsigned *index_out, Dwarf_Error *error)
+{
+    Dwarf_Unsigned lo = 0;
+    Dwarf_Unsigned hi = opcount;
+
+    while (lo < hi) {
+        Dwarf_Unsigned mid = lo + (hi-lo)/2;
+
+        if (ops[mid].lr_offset == target) {
+            *index_out = mid;
+            return DW_DLV_OK;
+        }
+        if (ops[mid].lr_offset < target) {
+            lo = mid +1;
+        } else {
+            hi = mid;
+        }
+    }
+    /*  exprlen zero means the length is not known
+        and anything past the last operator is
+        taken as the end. */
+    if ((exprlen && target == exprlen) ||
+        (!exprlen && opcount && lo == opcount &&
+        target > ops[opcount-1].lr_offset)) {
+        *index_out = opcount;
+        return DW_DLV_OK;
+    }
+    expr_error(dbg,error,"DW_OP_skip or DW_OP_bra target "
+        "is not the start of an operator");
+    return DW_DLV_ERROR;
+}
+
+/*  Returns DW_DLV_NO_ENTRY for operators the evaluator
+    does not handle. */
+static int
+compile_ops(Dwarf_Debug dbg,
+    Dwarf_CU_Context context,
+    Dwarf_Small address_size,
+    Dwarf_Loc_Expr_Op ops,
+    Dwarf_Unsigned opcount,
+    Dwarf_Unsigned exprlen,
+    Dwarf_Expr_Program *prog_out,
+    Dwarf_Error *error)
+{
+    struct expr_compile_s c;
+    Dwarf_Unsigned *op_to_insn = 0;
+    Dwarf_Unsigned *branch_to = 0;
+    Dwarf_Small    *is_target = 0;
+    Dwarf_Expr_Program prog = 0;
+    Dwarf_Unsigned i = 0;
+    int res = DW_DLV_OK;
+
+    if (!address_size || address_size > sizeof(Dwarf_Unsigned)) {
+        expr_error(dbg,error,"the address size of the "
+            "expression is not usable");
+        return DW_DLV_ERROR;
+    }
+    memset(&c,0,sizeof(c));
+    c.ec_dbg = dbg;
+    c.ec_context = context;
+    c.ec_address_size = address_size;
+    /*  Every operator emits at most one instruction. */
+    c.ec_insns = (struct Dwarf_Expr_Insn_s *)calloc(opcount+1,
+        sizeof(struct Dwarf_Expr_Insn_s));
+    op_to_insn = (Dwarf_Unsigned *)calloc(opcount+1,
+        sizeof(Dwarf_Unsigned));
+    branch_to = (Dwarf_Unsigned *)calloc(opcount+1,
+        sizeof(Dwarf_Unsigned));
+    is_target = (Dwarf_Small *)calloc(opcount+1,1);
+    if (!c.ec_insns || !op_to_insn || !branch_to || !is_target) {
+        _dwarf_error_string(dbg,error,DW_DLE_ALLOC_FAIL,
+            "DW_DLE_ALLOC_FAIL: compiling a DWARF expression");
+        res = DW_DLV_ERROR;
+        goto done;
+    }
+    for (i = 0; i < opcount; ++i) {
+        Dwarf_Loc_Expr_Op op = ops+i;
+        Dwarf_Unsigned endoff = 0;
+
+        if (op->lr_atom != DW_OP_skip && op->lr_atom != DW_OP_bra) {
+            continue;
+        }
+        /*  An operator ends where the next starts.
+            skip and bra are 3 bytes long. */
+        endoff = (i+1 < opcount)? ops[i+1].lr_offset:
+            op->lr_offset + 3;
+        res = find_branch_target(dbg,ops,opcount,exprlen,
+            endoff + op->lr_number,&branch_to[i],error);
+        if (res != DW_DLV_OK) {
+            goto done;
+        }
+        is_target[branch_to[i]] = TRUE;
+    }
+    for (i = 0; i < opcount; ++i) {
+        Dwarf_Loc_Expr_Op op = ops+i;
+        Dwarf_Small atom = op->lr_atom;
+        Dwarf_Bool must_be_last = FALSE;
+
+        if (is_target[i]) {
+            c.ec_barrier = c.ec_count;
+        }
+        op_to_insn[i] = c.ec_count;
+        if (atom >= DW_OP_lit0 && atom <= DW_OP_lit31) {
+            emit_const(&c,atom - DW_OP_lit0);
+            continue;
+        }
+        if (atom >= DW_OP_breg0 && atom <= DW_OP_breg31) {
+            emit(&c,DW_EXPR_I_BREG,atom - DW_OP_breg0,
+                op->lr_number);
+            continue;
+        }
+        if (atom >= DW_OP_reg0 && atom <= DW_OP_reg31) {
+            emit(&c,DW_EXPR_I_REG,atom - DW_OP_reg0,0);
+            if (i+1 != opcount) {
+                res = DW_DLV_NO_ENTRY;
+                goto done;
+            }
+            continue;
+        }
+        switch (atom) {
+        case DW_OP_addr:
+        case DW_OP_const1u:
+        case DW_OP_const1s:
+        case DW_OP_const2u:
+        case DW_OP_const2s:
+        case DW_OP_const4u:
+        case DW_OP_const4s:
+        case DW_OP_const8u:
+        case DW_OP_const8s:
+        case DW_OP_constu:
+        case DW_OP_consts:
+        case DW_OP_GNU_encoded_addr:
+            emit_const(&c,op->lr_number);
+            break;
+        case DW_OP_addrx:
+        case DW_OP_GNU_addr_index:
+        case DW_OP_constx:
+        case DW_OP_GNU_const_index: {
+            Dwarf_Addr a = 0;
+
+            if (!context) {
+                expr_error(dbg,error,"DW_OP_addrx or DW_OP_constx "
+                    "needs a CU context to find .debug_addr");
+                res = DW_DLV_ERROR;
+                goto done;
+            }
+            res = _dwarf_look_in_local_and_tied_by_index(dbg,
+                context,op->lr_number,&a,error);
+            if (res != DW_DLV_OK) {
+                goto done;
+            }
+            emit_const(&c,a);
+            }
+            break;
+        case DW_OP_regx:
+            emit(&c,DW_EXPR_I_REG,op->lr_number,0);
+            must_be_last = TRUE;
+            break;
+        case DW_OP_bregx:
+            emit(&c,DW_EXPR_I_BREG,op->lr_number,op->lr_number2);
+            break;
+        case DW_OP_fbreg:
+            emit(&c,DW_EXPR_I_FBREG,op->lr_number,0);
+            break;
+        case DW_OP_dup:
+            emit(&c,DW_EXPR_I_DUP,0,0);
+            break;
+        case DW_OP_drop:
+            if (last_is(&c,1,DW_EXPR_I_CONST)) {
+                c.ec_count--;
+            } else {
+                emit(&c,DW_EXPR_I_DROP,0,0);
+            }
+            break;
+        case DW_OP_over:
+            emit(&c,DW_EXPR_I_OVER,0,0);
+            break;
+        case DW_OP_pick:
+            emit(&c,DW_EXPR_I_PICK,op->lr_number,0);
+            break;
+        case DW_OP_swap:
+            emit(&c,DW_EXPR_I_SWAP,0,0);
+            break;
+        case DW_OP_rot:
+            emit(&c,DW_EXPR_I_ROT,0,0);
+            break;
+        case DW_OP_deref:
+            emit(&c,DW_EXPR_I_DEREF,0,0);
+            c.ec_insns[c.ec_count-1].ei_size = address_size;
+            break;
+        case DW_OP_deref_size:
+            if (!op->lr_number || op->lr_number > address_size) {
+                expr_error(dbg,error,"DW_OP_deref_size size "
+                    "is zero or larger than an address");
+                res = DW_DLV_ERROR;
+                goto done;
+            }
+            emit(&c,DW_EXPR_I_DEREF,0,0);
+            c.ec_insns[c.ec_count-1].ei_size =
+                (Dwarf_Small)op->lr_number;
+            break;
+        case DW_OP_abs:
+            emit_unary(&c,DW_EXPR_I_ABS);
+            break;
+        case DW_OP_neg:
+            emit_unary(&c,DW_EXPR_I_NEG);
+            break;
+        case DW_OP_not:
+            emit_unary(&c,DW_EXPR_I_NOT);
+            break;
+        case DW_OP_and:
+        case DW_OP_div:
+        case DW_OP_minus:
+        case DW_OP_mod:
+        case DW_OP_mul:
+        case DW_OP_or:
+        case DW_OP_plus:
+        case DW_OP_shl:
+        case DW_OP_shr:
+        case DW_OP_shra:
+        case DW_OP_xor:
+        case DW_OP_eq:
+        case DW_OP_ge:
+        case DW_OP_gt:
+        case DW_OP_le:
+        case DW_OP_lt:
+        case DW_OP_ne:
+            emit_binary(&c,binary_code_for_op(atom));
+            break;
+        case DW_OP_plus_uconst:
+            emit_plus_const(&c,op->lr_number);
+            break;
+        case DW_OP_skip:
+            emit(&c,DW_EXPR_I_SKIP,branch_to[i],0);
+            break;
+        case DW_OP_bra:
+            if (last_is(&c,1,DW_EXPR_I_CONST)) {
+                /*  The condition is known: either an
+                    unconditional skip or nothing at all. */
+                struct Dwarf_Expr_Insn_s *l =
+                    c.ec_insns + c.ec_count -1;
+
+                if (l->ei_operand1) {
+                    l->ei_code = DW_EXPR_I_SKIP;
+                    l->ei_operand1 = branch_to[i];
+                } else {
+                    c.ec_count--;
+                }
+            } else {
+                emit(&c,DW_EXPR_I_BRA,branch_to[i],0);
+            }
+            break;
+        case DW_OP_nop:
+            break;
+        case DW_OP_call_frame_cfa:
+            emit(&c,DW_EXPR_I_CFA,0,0);
+            break;
+        case DW_OP_form_tls_address:
+        case DW_OP_GNU_push_tls_address:
+            emit(&c,DW_EXPR_I_TLS,0,0);
+            break;
+        case DW_OP_push_object_address:
+            emit(&c,DW_EXPR_I_OBJECT_ADDR,0,0);
+            break;
+        case DW_OP_stack_value:
+            emit(&c,DW_EXPR_I_STACK_VALUE,0,0);
+            must_be_last = TRUE;
+            break;
+        case DW_OP_implicit_value:
+            emit(&c,DW_EXPR_I_IMPLICIT,op->lr_number,
+                op->lr_number2);
+            must_be_last = TRUE;
+            break;
+        default:
+            /*  Pieces, typed stack, calls, entry values
+                and vendor operators. */
+            res = DW_DLV_NO_ENTRY;
+            goto done;
+        }
+        if (must_be_last && i+1 != opcount) {
+            res = DW_DLV_NO_ENTRY;
+            goto done;
+        }
+    }
+    op_to_insn[opcount] = c.ec_count;
+    for (i = 0; i < c.ec_count; ++i) {
+        struct Dwarf_Expr_Insn_s *in = c.ec_insns+i;
+
+        if (in->ei_code == DW_EXPR_I_SKIP ||
+            in->ei_code == DW_EXPR_I_BRA) {
+            in->ei_operand1 = op_to_insn[in->ei_operand1];
+        }
+    }
+    prog = (Dwarf_Expr_Program)_dwarf_get_alloc(dbg,
+        DW_DLA_EXPR_PROGRAM,1);
+    if (!prog) {
+        _dwarf_error_string(dbg,error,DW_DLE_ALLOC_FAIL,
+            "DW_DLE_ALLOC_FAIL: allocating a Dwarf_Expr_Program");
+        res = DW_DLV_ERROR;
+        goto done;
+    }
+    prog->ep_magic = DW_EXPR_PROGRAM_MAGIC;
+    prog->ep_dbg = dbg;
+    prog->ep_address_size = address_size;
+    prog->ep_source_op_count = opcount;
+    prog->ep_insn_count = c.ec_count;
+    prog->ep_insns = c.ec_insns;
+    c.ec_insns = 0;
+    *prog_out = prog;
+    res = DW_DLV_OK;
+done:
+    free(c.ec_insns);
+    free(op_to_insn);
+    free(branch_to);
+    free(is_target);
+    return res;
+}
+
+int
+dwarf_expr_compile(Dwarf_Die die,
+    Dwarf_Ptr            expr_bytes,
+    Dwarf_Unsigned       expr_len,
+    Dwarf_Expr_Program * program_out,
+    Dwarf_Error        * error)
+{
+    Dwarf_CU_Context context = 0;
+    Dwarf_Debug dbg = 0;
+    Dwarf_Block_c block;
+    Dwarf_Loc_Expr_Op ops = 0;
+    Dwarf_Unsigned opcount = 0;
+    Dwarf_Unsigned offset = 0;
+    Dwarf_Small *end = 0;
+    int res = 0;
+
+    CHECK_DIE(die, DW_DLV_ERROR);
+    context = die->di_cu_context;
+    dbg = context->cc_dbg;
+    if (!program_out || (!expr_bytes && expr_len)) {
+        expr_error(dbg,error,"null argument to "
+            "dwarf_expr_compile()");
+        return DW_DLV_ERROR;
+    }
+    memset(&block,0,sizeof(block));
+    block.bl_data = (Dwarf_Byte_Ptr)expr_bytes;
+    block.bl_len = expr_len;
+    end = (Dwarf_Small *)expr_bytes + expr_len;
+    /*  Every operator is at least one byte. */
+    ops = (Dwarf_Loc_Expr_Op)calloc(expr_len+1,
+        sizeof(struct Dwarf_Loc_Expr_Op_s));
+    if (!ops) {
+        _dwarf_error_string(dbg,error,DW_DLE_ALLOC_FAIL,
+            "DW_DLE_ALLOC_FAIL: compiling a DWARF expression");
+        return DW_DLV_ERROR;
+    }
+    for (;;) {
+        Dwarf_Unsigned nextoffset = 0;
+
+        res = _dwarf_read_loc_expr_op(dbg,&block,opcount,
+            context->cc_version_stamp,
+            context->cc_length_size,
+            context->cc_address_size,
+            offset,end,&nextoffset,ops+opcount,error);
+        if (res == DW_DLV_ERROR) {
+            free(ops);
+            return res;
+        }
+        if (res == DW_DLV_NO_ENTRY) {
+            break;
+        }
+        opcount++;
+        offset = nextoffset;
+    }
+    res = compile_ops(dbg,context,context->cc_address_size,
+        ops,opcount,expr_len,program_out,error);
+    free(ops);
+    return res;
+}
+
+int
+dwarf_expr_compile_locdesc(Dwarf_Locdesc_c locdesc,
+    Dwarf_Expr_Program * program_out,
+    Dwarf_Error        * error)
+{
+    Dwarf_Loc_Head_c head = 0;
+
+    if (!locdesc || !locdesc->ld_loclist_head ||
+        !program_out) {
+        expr_error(NULL,error,"null argument to "
+            "dwarf_expr_compile_locdesc()");
+        return DW_DLV_ERROR;
+    }
+    head = locdesc->ld_loclist_head;
+    return compile_ops(head->ll_dbg,head->ll_context,
+        (Dwarf_Small)head->ll_address_size,
+        locdesc->ld_s,locdesc->ld_cents,
+        locdesc->ld_opsblock.bl_len,program_out,error);
+}
+
+/*  Callbacks return DW_DLV_OK, DW_DLV_NO_ENTRY
+    (value unavailable) or DW_DLV_ERROR. */
+static int
+callback_result(Dwarf_Debug dbg, int cres,
+    const char *what, Dwarf_Error *error)
+{
+    if (cres == DW_DLV_OK || cres == DW_DLV_NO_ENTRY) {
+        return cres;
+    }
+    expr_error(dbg,error,what);
+    return DW_DLV_ERROR;
+}
+
+#define POP_CHECK(n)                                      \
+    do {                                                  \
+        if (sp < (n)) {                                   \
+            expr_error(dbg,error,"stack underflow");      \
+            return DW_DLV_ERROR;                          \
+        }                                                 \
+    } while (0)
+#define PUSH_CHECK                                        \
+    do {                                                  \
+        if (sp >= DW_EXPR_STACK_MAX) {                    \
+            expr_error(dbg,error,"stack overflow");       \
+            return DW_DLV_ERROR;                          \
+        }                                                 \
+    } while (0)
+#define NEED_CALLBACK(f,name)                             \
+    do {                                                  \
+        if (!callbacks || !callbacks->f) {                \
+            expr_error(dbg,error,"no " name               \
+                " callback was provided");                \
+            return DW_DLV_ERROR;                          \
+        }                                                 \
+    } while (0)
+
+int
+dwarf_expr_evaluate(Dwarf_Expr_Program prog,
+    Dwarf_Expr_Callbacks * callbacks,
+    Dwarf_Bool             push_initial,
+    Dwarf_Unsigned         initial_value,
+    Dwarf_Expr_Result    * result,
+    Dwarf_Error          * error)
+{
+    Dwarf_Unsigned stack[DW_EXPR_STACK_MAX];
+    int sp = 0;
+    Dwarf_Unsigned pc = 0;
+    Dwarf_Unsigned steps = 0;
+    Dwarf_Unsigned count = 0;
+    struct Dwarf_Expr_Insn_s *insns = 0;
+    Dwarf_Debug dbg = 0;
+    Dwarf_Small asize = 0;
+    void *ud = 0;
+    int cres = 0;
+
+    if (!prog || prog->ep_magic != DW_EXPR_PROGRAM_MAGIC ||
+        !result) {
+        expr_error(NULL,error,"invalid Dwarf_Expr_Program or "
+            "null result pointer passed to "
+            "dwarf_expr_evaluate()");
+        return DW_DLV_ERROR;
+    }
+    dbg = prog->ep_dbg;
+    asize = prog->ep_address_size;
+    insns = prog->ep_insns;
+    count = prog->ep_insn_count;
+    ud = callbacks? callbacks->ec_user_data: 0;
+    if (push_initial) {
+        stack[sp++] = addr_mask(initial_value,asize);
+    }
+    while (pc < count) {
+        struct Dwarf_Expr_Insn_s *in = insns + pc;
+        Dwarf_Unsigned v = 0;
+
+        if (++steps > DW_EXPR_STEP_LIMIT) {
+            expr_error(dbg,error,"step limit exceeded, "
+                "the expression loops");
+            return DW_DLV_ERROR;
+        }
+        pc++;
+        if (is_binary_code(in->ei_code)) {
+            POP_CHECK(2);
+            if ((in->ei_code == DW_EXPR_I_DIV ||
+                in->ei_code == DW_EXPR_I_MOD) &&
+                !addr_mask(stack[sp-1],asize)) {
+                expr_error(dbg,error,"division by zero");
+                return DW_DLV_ERROR;
+            }
+            stack[sp-2] = apply_binary(in->ei_code,stack[sp-2],
+                stack[sp-1],asize);
+            sp--;
+            continue;
+        }
+        switch (in->ei_code) {
+        case DW_EXPR_I_CONST:
+            PUSH_CHECK;
+            stack[sp++] = in->ei_operand1;
+            break;
+        case DW_EXPR_I_BREG:
+            NEED_CALLBACK(ec_read_register,"register read");
+            PUSH_CHECK;
+            cres = callback_result(dbg,
+                callbacks->ec_read_register(ud,in->ei_operand1,&v),
+                "register read callback failed",error);
+            if (cres != DW_DLV_OK) {
+                return cres;
+            }
+            stack[sp++] = addr_mask(v + in->ei_operand2,asize);
+            break;
+        case DW_EXPR_I_FBREG:
+            NEED_CALLBACK(ec_frame_base,"frame base");
+            PUSH_CHECK;
+            cres = callback_result(dbg,
+                callbacks->ec_frame_base(ud,&v),
+                "frame base callback failed",error);
+            if (cres != DW_DLV_OK) {
+                return cres;
+            }
+            stack[sp++] = addr_mask(v + in->ei_operand1,asize);
+            break;
+        case DW_EXPR_I_REG:
+            result->er_kind = DW_EXPR_RESULT_register;
+            result->er_value = in->ei_operand1;
+            result->er_block = 0;
+            return DW_DLV_OK;
+        case DW_EXPR_I_DUP:
+            POP_CHECK(1);
+            PUSH_CHECK;
+            stack[sp] = stack[sp-1];
+            sp++;
+            break;
+        case DW_EXPR_I_DROP:
+            POP_CHECK(1);
+            sp--;
+            break;
+        case DW_EXPR_I_OVER:
+            POP_CHECK(2);
+            PUSH_CHECK;
+            stack[sp] = stack[sp-2];
+            sp++;
+            break;
+        case DW_EXPR_I_PICK:
+            if (in->ei_operand1 >= (Dwarf_Unsigned)sp) {
+                expr_error(dbg,error,"DW_OP_pick index "
+                    "exceeds the stack depth");
+                return DW_DLV_ERROR;
+            }
+            PUSH_CHECK;
+            stack[sp] = stack[sp-1-(int)in->ei_operand1];
+            sp++;
+            break;
+        case DW_EXPR_I_SWAP:
+            POP_CHECK(2);
+            v = stack[sp-1];
+            stack[sp-1] = stack[sp-2];
+            stack[sp-2] = v;
+            break;
+        case DW_EXPR_I_ROT:
+            POP_CHECK(3);
+            v = stack[sp-1];
+            stack[sp-1] = stack[sp-2];
+            stack[sp-2] = stack[sp-3];
+            stack[sp-3] = v;
+            break;
+        case DW_EXPR_I_DEREF:
+            NEED_CALLBACK(ec_read_memory,"memory read");
+            POP_CHECK(1);
+            cres = callback_result(dbg,
+                callbacks->ec_read_memory(ud,stack[sp-1],
+                in->ei_size,&v),
+                "memory read callback failed",error);
+            if (cres != DW_DLV_OK) {
+                return cres;
+            }
+            stack[sp-1] = addr_mask(v,asize);
+            break;
+        case DW_EXPR_I_ABS:
+        case DW_EXPR_I_NEG:
+        case DW_EXPR_I_NOT:
+            POP_CHECK(1);
+            stack[sp-1] = apply_unary(in->ei_code,stack[sp-1],
+                asize);
+            break;
+        case DW_EXPR_I_PLUS_CONST:
+            POP_CHECK(1);
+            stack[sp-1] = addr_mask(stack[sp-1] + in->ei_operand1,
+                asize);
+            break;
+        case DW_EXPR_I_SKIP:
+            pc = in->ei_operand1;
+            break;
+        case DW_EXPR_I_BRA:
+            POP_CHECK(1);
+            sp--;
+            if (stack[sp]) {
+                pc = in->ei_operand1;
+            }
+            break;
+        case DW_EXPR_I_CFA:
+            NEED_CALLBACK(ec_call_frame_cfa,"call frame CFA");
+            PUSH_CHECK;
+            cres = callback_result(dbg,
+                callbacks->ec_call_frame_cfa(ud,&v),
+                "call frame CFA callback failed",error);
+            if (cres != DW_DLV_OK) {
+                return cres;
+            }
+            stack[sp++] = addr_mask(v,asize);
+            break;
+        case DW_EXPR_I_TLS:
+            NEED_CALLBACK(ec_tls_address,"TLS address");
+            POP_CHECK(1);
+            cres = callback_result(dbg,
+                callbacks->ec_tls_address(ud,stack[sp-1],&v),
+                "TLS address callback failed",error);
+            if (cres != DW_DLV_OK) {
+                return cres;
+            }
+            stack[sp-1] = addr_mask(v,asize);
+            break;
+        case DW_EXPR_I_OBJECT_ADDR:
+            NEED_CALLBACK(ec_object_address,"object address");
+            PUSH_CHECK;
+            cres = callback_result(dbg,
+                callbacks->ec_object_address(ud,&v),
+                "object address callback failed",error);
+            if (cres != DW_DLV_OK) {
+                return cres;
+            }
+            stack[sp++] = addr_mask(v,asize);
+            break;
+        case DW_EXPR_I_STACK_VALUE:
+            POP_CHECK(1);
+            result->er_kind = DW_EXPR_RESULT_value;
+            result->er_value = stack[sp-1];
+            result->er_block = 0;
+            return DW_DLV_OK;
+        case DW_EXPR_I_IMPLICIT:
+            result->er_kind = DW_EXPR_RESULT_implicit;
+            result->er_value = in->ei_operand1;
+            result->er_block = (Dwarf_Ptr)(uintptr_t)in->ei_operand2;
+            return DW_DLV_OK;
+        default:
+            expr_error(dbg,error,"corrupt compiled "
+                "expression instruction");
+            return DW_DLV_ERROR;
+        }
+    }
+    if (!sp) {
+        /*  An empty expression: optimized out. */
+        return DW_DLV_NO_ENTRY;
+    }
+    result->er_kind = DW_EXPR_RESULT_memory;
+    result->er_value = stack[sp-1];
+    result->er_block = 0;
+    return DW_DLV_OK;
+}
+
+int
+dwarf_expr_program_sizes(Dwarf_Expr_Program prog,
+    Dwarf_Unsigned * source_op_count,
+    Dwarf_Unsigned * instruction_count)
+{
+    if (!prog || prog->ep_magic != DW_EXPR_PROGRAM_MAGIC) {
+        return DW_DLV_NO_ENTRY;
+    }
+    if (source_op_count) {
+        *source_op_count = prog->ep_source_op_count;
+    }
+    if (instruction_count) {
+        *instruction_count = prog->ep_insn_count;
+    }
+    return DW_DLV_OK;
+}
+
+void
+dwarf_dealloc_expr_program(Dwarf_Expr_Program prog)
+{
+    if (!prog || prog->ep_magic != DW_EXPR_PROGRAM_MAGIC) {
+        return;
+    }
+    dwarf_dealloc(prog->ep_dbg,prog,DW_DLA_EXPR_PROGRAM);
+}
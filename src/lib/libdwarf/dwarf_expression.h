@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2026 agent. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef DWARF_EXPRESSION_H
+#define DWARF_EXPRESSION_H
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define DW_EXPR_PROGRAM_MAGIC 0xe7a1
+
+/*  Evaluation stack depth. The stack is a local
+    array in dwarf_expr_evaluate(), never allocated. */
+#define DW_EXPR_STACK_MAX  64
+
+/*  Bounds the number of instructions executed so
+    a backward DW_OP_skip or DW_OP_bra in corrupt
+    DWARF cannot loop forever. */
+#define DW_EXPR_STEP_LIMIT 100000
+
+/*  The internal instruction set. Far fewer than the
+    DW_OP set as the many forms of a constant
+    (DW_OP_lit*, DW_OP_const*, DW_OP_addr,
+    DW_OP_addrx, DW_OP_constx...) all become
+    DW_EXPR_I_CONST and DW_OP_breg0-31 and DW_OP_bregx
+    become DW_EXPR_I_BREG. */
+#define DW_EXPR_I_CONST        1  /* push ei_operand1 */
+#define DW_EXPR_I_BREG         2  /* push reg(op1) + op2 */
+#define DW_EXPR_I_FBREG        3  /* push frame base + op1 */
+#define DW_EXPR_I_REG          4  /* result is register op1 */
+#define DW_EXPR_I_DUP          5
+#define DW_EXPR_I_DROP         6
+#define DW_EXPR_I_OVER         7
+#define DW_EXPR_I_PICK         8  /* ei_operand1 is index */
+#define DW_EXPR_I_SWAP         9
+#define DW_EXPR_I_ROT         10
+#define DW_EXPR_I_DEREF       11  /* ei_size bytes */
+#define DW_EXPR_I_ABS         12
+#define DW_EXPR_I_NEG         13
+#define DW_EXPR_I_NOT         14
+#define DW_EXPR_I_AND         15
+#define DW_EXPR_I_DIV         16
+#define DW_EXPR_I_MINUS       17
+#define DW_EXPR_I_MOD         18
+#define DW_EXPR_I_MUL         19
+#define DW_EXPR_I_OR          20
+#define DW_EXPR_I_PLUS        21
+#define DW_EXPR_I_SHL         22
+#define DW_EXPR_I_SHR         23
+#define DW_EXPR_I_SHRA        24
+#define DW_EXPR_I_XOR         25
+#define DW_EXPR_I_EQ          26
+#define DW_EXPR_I_GE          27
+#define DW_EXPR_I_GT          28
+#define DW_EXPR_I_LE          29
+#define DW_EXPR_I_LT          30
+#define DW_EXPR_I_NE          31
+#define DW_EXPR_I_PLUS_CONST  32  /* top += op1 */
+#define DW_EXPR_I_SKIP        33  /* goto instruction op1 */
+#define DW_EXPR_I_BRA         34  /* pop, goto op1 if non-zero */
+#define DW_EXPR_I_CFA         35
+#define DW_EXPR_I_TLS         36
+#define DW_EXPR_I_OBJECT_ADDR 37
+#define DW_EXPR_I_STACK_VALUE 38  /* result is top of stack */
+#define DW_EXPR_I_IMPLICIT    39  /* op1 length, op2 pointer */
+
+struct Dwarf_Expr_Insn_s {
+    Dwarf_Small    ei_code;
+    Dwarf_Small    ei_size;
+    Dwarf_Unsigned ei_operand1;
+    Dwarf_Unsigned ei_operand2;
+};
+
+struct Dwarf_Expr_Program_s {
+    Dwarf_Unsigned ep_magic;
+    Dwarf_Debug    ep_dbg;
+    Dwarf_Small    ep_address_size;
+    /*  Count of DW_OP operators compiled. */
+    Dwarf_Unsigned ep_source_op_count;
+    /*  ep_insns is malloc space, freed by the
+        destructor. */
+    Dwarf_Unsigned ep_insn_count;
+    struct Dwarf_Expr_Insn_s *ep_insns;
+};
+
+void _dwarf_expr_program_destructor(void *m);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* DWARF_EXPRESSION_H */
@@ -166,6 +166,7 @@ load_xu_str_offsets_into_cucontext(Dwarf_Debug dbg,
             header_length;
         cu_context->cc_str_offsets_header_length = header_length;
         cu_context->cc_str_offsets_offset_size = offset_size;
+        _dwarf_discard_cu_str_offsets_table(cu_context);
         return DW_DLV_OK;
     }
     return DW_DLV_NO_ENTRY;
@@ -1652,6 +1652,12 @@ _dwarf_extract_string_offset_via_str_offsets(Dwarf_Debug dbg,
     if ( idxres != DW_DLV_OK) {
         return idxres;
     }
+    if (index_to_offset_entry <
+        cu_context->cc_str_offsets_table_count) {
+        *str_sect_offset_out =
+            cu_context->cc_str_offsets_table[index_to_offset_entry];
+        return DW_DLV_OK;
+    }
 
     if (cu_context->cc_str_offsets_base_present) {
         baseoffset = cu_context->cc_str_offsets_base;
@@ -1696,6 +1702,16 @@ _dwarf_extract_string_offset_via_str_offsets(Dwarf_Debug dbg,
             }
         }
     }
+    if (!cu_context->cc_str_offsets_table_tried) {
+        _dwarf_build_cu_str_offsets_table(dbg,cu_context,
+            baseoffset);
+        if (index_to_offset_entry <
+            cu_context->cc_str_offsets_table_count) {
+            *str_sect_offset_out = cu_context->
+                cc_str_offsets_table[index_to_offset_entry];
+            return DW_DLV_OK;
+        }
+    }
     offsetintable = baseoffset +indexoffset;
     end_offsetintable = offsetintable +
         cu_context->cc_str_offsets_offset_size;
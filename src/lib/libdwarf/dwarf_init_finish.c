@@ -117,6 +117,52 @@ dwarf_set_stringcheck(int newval)
     return oldval;
 }
 
+/*  Zero means no filter, all sections are used.
+    Otherwise a null-terminated array of standard
+    section names, owned by the caller. */
+static const char **_dwarf_section_filter;
+
+void
+dwarf_set_section_filter(const char **names)
+{
+    _dwarf_section_filter = names;
+}
+
+/*  Returns TRUE if the filter set by
+    dwarf_set_section_filter() leaves this DWARF
+    section out. A .zdebug_ name is treated as its
+    .debug_ equivalent. Sections that are not DWARF
+    sections are never left out. */
+int
+_dwarf_section_filtered_out(const char *scn_name)
+{
+    const char **cur = 0;
+    const char *suffix = 0;
+
+    if (!_dwarf_section_filter || !scn_name) {
+        return FALSE;
+    }
+    if (!strncmp(scn_name,".debug_",7)) {
+        suffix = scn_name+7;
+    } else if (!strncmp(scn_name,".zdebug_",8)) {
+        suffix = scn_name+8;
+    } else if (strcmp(scn_name,".eh_frame") &&
+        strcmp(scn_name,".gdb_index")) {
+        return FALSE;
+    }
+    for (cur = _dwarf_section_filter; *cur; ++cur) {
+        if (suffix) {
+            if (!strncmp(*cur,".debug_",7) &&
+                !strcmp(*cur+7,suffix)) {
+                return FALSE;
+            }
+        } else if (!strcmp(*cur,scn_name)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
 static int
 startswith(const char * input, char* ckfor)
 {
@@ -149,6 +195,11 @@ get_basic_section_data(Dwarf_Debug dbg,
     if (secdata->dss_index != 0) {
         DWARF_DBG_ERROR(dbg, duperr, DW_DLV_ERROR);
     }
+    if (_dwarf_section_filtered_out(secdata->dss_standard_name)) {
+        /*  Left out by dwarf_set_section_filter().
+            It reads as an empty section. */
+        return DW_DLV_OK;
+    }
     if (doas->as_size == 0) {
         /*  As of 2018 it seems impossible to detect
             (via dwarfdump) whether emptyerr has any
@@ -2003,6 +2054,7 @@ _dwarf_load_section(Dwarf_Debug dbg,
             zero-size. */
         return res;
     }
+    section->dss_stats_bytes_read = section->dss_size;
     if (section->dss_ignore_reloc_group_sec) {
         /* Neither zdebug nor reloc apply to .group sections. */
         return res;
@@ -2031,6 +2083,7 @@ _dwarf_load_section(Dwarf_Debug dbg,
         return DW_DLV_ERROR;
 #endif
         section->dss_did_decompress = TRUE;
+        section->dss_stats_bytes_decompressed = section->dss_size;
     }
     if (_dwarf_apply_relocs == 0) {
         return res;
@@ -2047,6 +2100,9 @@ _dwarf_load_section(Dwarf_Debug dbg,
     if (res == DW_DLV_ERROR) {
         DWARF_DBG_ERROR(dbg, err, res);
     }
+    if (res == DW_DLV_OK) {
+        section->dss_stats_reloc_bytes = section->dss_reloc_size;
+    }
     return res;
 }
 
@@ -2144,6 +2200,41 @@ dwarf_get_section_max_offsets_d(Dwarf_Debug dbg,
     return DW_DLV_OK;
 }
 
+/*  Reports what loading each DWARF section
+    (see _dwarf_load_section()) has done so far. */
+int
+dwarf_get_section_load_stats(Dwarf_Debug dbg,
+    unsigned section_index,
+    const char ** section_name,
+    Dwarf_Unsigned * bytes_read,
+    Dwarf_Unsigned * bytes_decompressed,
+    Dwarf_Unsigned * reloc_bytes)
+{
+    struct Dwarf_Section_s *secdata = 0;
+
+    if (!dbg || dbg->de_magic != DBG_IS_VALID) {
+        return DW_DLV_NO_ENTRY;
+    }
+    if (section_index >= dbg->de_debug_sections_total_entries) {
+        return DW_DLV_NO_ENTRY;
+    }
+    secdata = dbg->de_debug_sections[section_index].ds_secdata;
+    if (section_name) {
+        *section_name =
+            dbg->de_debug_sections[section_index].ds_name;
+    }
+    if (bytes_read) {
+        *bytes_read = secdata->dss_stats_bytes_read;
+    }
+    if (bytes_decompressed) {
+        *bytes_decompressed = secdata->dss_stats_bytes_decompressed;
+    }
+    if (reloc_bytes) {
+        *reloc_bytes = secdata->dss_stats_reloc_bytes;
+    }
+    return DW_DLV_OK;
+}
+
 const struct Dwarf_Obj_Access_Section_a_s zerodoas;
 /*  Given a section name, get its size and address */
 int
@@ -823,9 +823,12 @@ _dwarf_read_loc_section_dwo(Dwarf_Debug dbg,
         break;
     case DW_LLEX_base_address_selection_entry: {
         Dwarf_Unsigned addr_index = 0;
+        Dwarf_Unsigned leb128_length = 0;
 
-        DECODE_LEB128_UWORD_CK(locptr,addr_index,
+        DECODE_LEB128_UWORD_LEN_CK(locptr,addr_index,
+            leb128_length,
             dbg,error,section_end);
+        expr_offset += leb128_length;
         return_block->bl_section_offset = expr_offset;
         /* So this behaves much like non-dwo loclist */
         *lowpc=MAX_ADDR;
@@ -1927,3 +1930,500 @@ dwarf_get_location_op_value_c(Dwarf_Locdesc_c locdesc,
     return DW_DLV_OK;
 }
 /* ============== End of the October 2015 interfaces. */
+
+/*  The loclist cursor: walks a location list
+    straight from section memory, one entry per call,
+    with no allocation and no operator decoding. */
+
+static int
+cursor_error(Dwarf_Debug dbg,Dwarf_Error *error,
+    const char *msg)
+{
+    _dwarf_error_string(dbg,error,DW_DLE_LOCATION_ERROR,
+        (char *)msg);
+    return DW_DLV_ERROR;
+}
+
+/*  Returns TRUE if the .debug_addr entry could be
+    read. Failure is not an error here, the entry
+    is just reported as unavailable, much as
+    the cook_*() functions above do. */
+static Dwarf_Bool
+cursor_index_to_address(Dwarf_Loclist_Cursor *cursor,
+    Dwarf_Unsigned index,
+    Dwarf_Addr *addr_out)
+{
+    Dwarf_Error lerr = 0;
+    int res = 0;
+
+    res = _dwarf_look_in_local_and_tied_by_index(
+        cursor->lcu_dbg,cursor->lcu_context,index,
+        addr_out,&lerr);
+    if (res == DW_DLV_OK) {
+        return TRUE;
+    }
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(cursor->lcu_dbg,lerr);
+    }
+    return FALSE;
+}
+
+/* DWARF2,3,4 .debug_loc */
+static int
+cursor_next_loc(Dwarf_Loclist_Cursor *cursor,
+    Dwarf_Small    *lle_value_out,
+    Dwarf_Addr     *lowpc_out,
+    Dwarf_Addr     *highpc_out,
+    Dwarf_Bool     *unavailable_out,
+    Dwarf_Ptr      *bytes_out,
+    Dwarf_Unsigned *len_out,
+    Dwarf_Error    *error)
+{
+    Dwarf_Debug dbg = cursor->lcu_dbg;
+
+    for (;;) {
+        Dwarf_Block_c b;
+        Dwarf_Addr lowpc = 0;
+        Dwarf_Addr highpc = 0;
+        Dwarf_Half lle_val = DW_LLE_VALUE_BOGUS;
+        int res = 0;
+
+        memset(&b,0,sizeof(b));
+        res = _dwarf_read_loc_section(dbg,&b,&lowpc,&highpc,
+            &lle_val,
+            (Dwarf_Off)(cursor->lcu_next -
+            cursor->lcu_section_start),
+            cursor->lcu_address_size,error);
+        if (res != DW_DLV_OK) {
+            cursor->lcu_done = TRUE;
+            return res;
+        }
+        cursor->lcu_next = (Dwarf_Small *)b.bl_data + b.bl_len;
+        if (lle_val == DW_LLE_end_of_list) {
+            cursor->lcu_done = TRUE;
+            return DW_DLV_NO_ENTRY;
+        }
+        if (lle_val == DW_LLE_base_address) {
+            cursor->lcu_base_address = highpc;
+            continue;
+        }
+        *lle_value_out = DW_LLE_offset_pair;
+        *lowpc_out = lowpc + cursor->lcu_base_address;
+        *highpc_out = highpc + cursor->lcu_base_address;
+        *unavailable_out = FALSE;
+        *bytes_out = b.bl_data;
+        *len_out = b.bl_len;
+        return DW_DLV_OK;
+    }
+}
+
+/* Non-standard GNU DWARF4 .dwo loclist */
+static int
+cursor_next_gnu(Dwarf_Loclist_Cursor *cursor,
+    Dwarf_Small    *lle_value_out,
+    Dwarf_Addr     *lowpc_out,
+    Dwarf_Addr     *highpc_out,
+    Dwarf_Bool     *unavailable_out,
+    Dwarf_Ptr      *bytes_out,
+    Dwarf_Unsigned *len_out,
+    Dwarf_Error    *error)
+{
+    Dwarf_Debug dbg = cursor->lcu_dbg;
+
+    for (;;) {
+        Dwarf_Block_c b;
+        Dwarf_Bool at_end = FALSE;
+        Dwarf_Addr rawlow = 0;
+        Dwarf_Addr rawhigh = 0;
+        Dwarf_Addr lowpc = 0;
+        Dwarf_Addr highpc = 0;
+        Dwarf_Half lle_op = 0;
+        Dwarf_Bool ok = TRUE;
+        int res = 0;
+
+        res = _dwarf_read_loc_section_dwo(dbg,&b,
+            &rawlow,&rawhigh,&at_end,&lle_op,
+            (Dwarf_Off)(cursor->lcu_next -
+            cursor->lcu_section_start),
+            cursor->lcu_address_size,
+            cursor->lcu_kind,error);
+        if (res != DW_DLV_OK) {
+            cursor->lcu_done = TRUE;
+            return res;
+        }
+        if (at_end) {
+            cursor->lcu_done = TRUE;
+            return DW_DLV_NO_ENTRY;
+        }
+        cursor->lcu_next = cursor->lcu_section_start +
+            b.bl_section_offset + b.bl_len;
+        switch(lle_op) {
+        case DW_LLEX_base_address_selection_entry:
+            cursor->lcu_base_address_valid =
+                cursor_index_to_address(cursor,rawhigh,
+                &cursor->lcu_base_address);
+            continue;
+        case DW_LLEX_start_end_entry:
+            ok = cursor_index_to_address(cursor,rawlow,&lowpc);
+            if (ok) {
+                ok = cursor_index_to_address(cursor,rawhigh,
+                    &highpc);
+            }
+            break;
+        case DW_LLEX_start_length_entry:
+            ok = cursor_index_to_address(cursor,rawlow,&lowpc);
+            highpc = lowpc + rawhigh;
+            break;
+        case DW_LLEX_offset_pair_entry:
+            ok = cursor->lcu_base_address_valid;
+            lowpc = rawlow + cursor->lcu_base_address;
+            highpc = rawhigh + cursor->lcu_base_address;
+            break;
+        default:
+            /*  _dwarf_read_loc_section_dwo() already
+                rejected anything else. */
+            break;
+        }
+        *lle_value_out = (Dwarf_Small)lle_op;
+        *lowpc_out = ok?lowpc:0;
+        *highpc_out = ok?highpc:0;
+        *unavailable_out = !ok;
+        *bytes_out = b.bl_data;
+        *len_out = b.bl_len;
+        return DW_DLV_OK;
+    }
+}
+
+/* DWARF5 .debug_loclists */
+static int
+cursor_next_loclists(Dwarf_Loclist_Cursor *cursor,
+    Dwarf_Small    *lle_value_out,
+    Dwarf_Addr     *lowpc_out,
+    Dwarf_Addr     *highpc_out,
+    Dwarf_Bool     *unavailable_out,
+    Dwarf_Ptr      *bytes_out,
+    Dwarf_Unsigned *len_out,
+    Dwarf_Error    *error)
+{
+    Dwarf_Debug dbg = cursor->lcu_dbg;
+
+    for (;;) {
+        unsigned entrylen = 0;
+        unsigned code = 0;
+        Dwarf_Unsigned val1 = 0;
+        Dwarf_Unsigned val2 = 0;
+        Dwarf_Unsigned opsblocksize = 0;
+        Dwarf_Unsigned opsoffset = 0;
+        Dwarf_Small *ops = 0;
+        Dwarf_Addr lowpc = 0;
+        Dwarf_Addr highpc = 0;
+        Dwarf_Bool ok = TRUE;
+        int res = 0;
+
+        if (cursor->lcu_next >= cursor->lcu_end) {
+            cursor->lcu_done = TRUE;
+            return cursor_error(dbg,error,
+                "DW_DLE_LOCATION_ERROR: a .debug_loclists "
+                "location list runs off the end of its "
+                "table without a DW_LLE_end_of_list. "
+                "Corrupt DWARF.");
+        }
+        res = _dwarf_read_single_lle_entry(dbg,
+            cursor->lcu_next,
+            (Dwarf_Unsigned)(cursor->lcu_next -
+            cursor->lcu_section_start),
+            cursor->lcu_end,
+            cursor->lcu_address_size,
+            &entrylen,&code,&val1,&val2,
+            &opsblocksize,&opsoffset,&ops,error);
+        if (res != DW_DLV_OK) {
+            cursor->lcu_done = TRUE;
+            return res;
+        }
+        if (ops && opsblocksize >
+            (Dwarf_Unsigned)(cursor->lcu_end - ops)) {
+            cursor->lcu_done = TRUE;
+            return cursor_error(dbg,error,
+                "DW_DLE_LOCATION_ERROR: a .debug_loclists "
+                "counted location description runs off the "
+                "end of its table. Corrupt DWARF.");
+        }
+        cursor->lcu_next += entrylen;
+        switch(code) {
+        case DW_LLE_end_of_list:
+            cursor->lcu_done = TRUE;
+            return DW_DLV_NO_ENTRY;
+        case DW_LLE_base_addressx:
+            cursor->lcu_base_address_valid =
+                cursor_index_to_address(cursor,val1,
+                &cursor->lcu_base_address);
+            continue;
+        case DW_LLE_base_address:
+            cursor->lcu_base_address = val1;
+            cursor->lcu_base_address_valid = TRUE;
+            continue;
+        case DW_LLE_startx_endx:
+            ok = cursor_index_to_address(cursor,val1,&lowpc);
+            if (ok) {
+                ok = cursor_index_to_address(cursor,val2,&highpc);
+            }
+            break;
+        case DW_LLE_startx_length:
+            ok = cursor_index_to_address(cursor,val1,&lowpc);
+            highpc = lowpc + val2;
+            break;
+        case DW_LLE_offset_pair:
+            ok = cursor->lcu_base_address_valid;
+            lowpc = val1 + cursor->lcu_base_address;
+            highpc = val2 + cursor->lcu_base_address;
+            break;
+        case DW_LLE_start_end:
+            lowpc = val1;
+            highpc = val2;
+            break;
+        case DW_LLE_start_length:
+            lowpc = val1;
+            highpc = val1 + val2;
+            break;
+        case DW_LLE_default_location:
+        default:
+            /*  Applies wherever no bounded entry does,
+                so it has no address range of its own. */
+            break;
+        }
+        *lle_value_out = (Dwarf_Small)code;
+        *lowpc_out = ok?lowpc:0;
+        *highpc_out = ok?highpc:0;
+        *unavailable_out = !ok;
+        *bytes_out = ops;
+        *len_out = opsblocksize;
+        return DW_DLV_OK;
+    }
+}
+
+int
+dwarf_loclist_cursor_init(Dwarf_Attribute attr,
+    Dwarf_Loclist_Cursor *cursor,
+    Dwarf_Error *error)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_CU_Context cucontext = 0;
+    Dwarf_Half form = 0;
+    int lkind = 0;
+    int res = 0;
+
+    if (!cursor) {
+        return cursor_error(NULL,error,
+            "DW_DLE_LOCATION_ERROR: NULL Dwarf_Loclist_Cursor "
+            "pointer passed to dwarf_loclist_cursor_init()");
+    }
+    res = _dwarf_setup_loc(attr,&dbg,&cucontext,&form,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    memset(cursor,0,sizeof(*cursor));
+    lkind = determine_location_lkind(cucontext->cc_version_stamp,
+        form,cucontext->cc_is_dwo);
+    cursor->lcu_dbg = dbg;
+    cursor->lcu_context = cucontext;
+    cursor->lcu_kind = lkind;
+    cursor->lcu_address_size = cucontext->cc_address_size;
+    cursor->lcu_base_address = cucontext->cc_low_pc;
+    /*  As in cook_original_loclist_contents() DWARF2-4
+        lists use the CU base address even if it is absent
+        (in which case it is zero). */
+    cursor->lcu_base_address_valid = (lkind == DW_LKIND_loclists)?
+        cucontext->cc_low_pc_present:TRUE;
+    switch(lkind) {
+    case DW_LKIND_expression: {
+        Dwarf_Block_c bc;
+
+        memset(&bc,0,sizeof(bc));
+        if (form == DW_FORM_exprloc) {
+            res = dwarf_formexprloc(attr,&bc.bl_len,
+                (Dwarf_Ptr)&bc.bl_data,error);
+        } else {
+            Dwarf_Block b;
+
+            memset(&b,0,sizeof(b));
+            res = _dwarf_formblock_internal(dbg,attr,
+                cucontext,&b,error);
+            bc.bl_len = b.bl_len;
+            bc.bl_data = b.bl_data;
+        }
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        cursor->lcu_next = (Dwarf_Small *)bc.bl_data;
+        cursor->lcu_expr_len = bc.bl_len;
+        }
+        break;
+    case DW_LKIND_loclist:
+    case DW_LKIND_GNU_exp_list: {
+        Dwarf_Unsigned offset = 0;
+
+        res = _dwarf_get_loclist_header_start(dbg,attr,
+            &offset,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        cursor->lcu_section_start = dbg->de_debug_loc.dss_data;
+        cursor->lcu_next = cursor->lcu_section_start + offset;
+        cursor->lcu_end = cursor->lcu_section_start +
+            dbg->de_debug_loc.dss_size;
+        }
+        break;
+    case DW_LKIND_loclists: {
+        Dwarf_Unsigned contextnum = 0;
+        Dwarf_Unsigned offset = 0;
+        Dwarf_Loclists_Context rctx = 0;
+
+        res = _dwarf_loclists_find_lle_start(dbg,attr,form,
+            &contextnum,&offset,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        rctx = dbg->de_loclists_context[contextnum];
+        cursor->lcu_address_size = rctx->lc_address_size;
+        cursor->lcu_section_start = dbg->de_debug_loclists.dss_data;
+        cursor->lcu_next = cursor->lcu_section_start + offset;
+        cursor->lcu_end = rctx->lc_endaddr;
+        }
+        break;
+    default: {
+        dwarfstring m;
+
+        dwarfstring_constructor(&m);
+        dwarfstring_append_printf_u(&m,
+            "DW_DLE_LOC_EXPR_BAD: For Compilation Unit "
+            "version %u",cucontext->cc_version_stamp);
+        dwarfstring_append_printf_u(&m,
+            " form 0x%x is not a location form"
+            " dwarf_loclist_cursor_init() understands",form);
+        _dwarf_error_string(dbg,error,DW_DLE_LOC_EXPR_BAD,
+            dwarfstring_string(&m));
+        dwarfstring_destructor(&m);
+        return DW_DLV_ERROR;
+        }
+    }
+    cursor->lcu_magic = LOCLIST_CURSOR_MAGIC;
+    return DW_DLV_OK;
+}
+
+int
+dwarf_loclist_cursor_next(Dwarf_Loclist_Cursor *cursor,
+    Dwarf_Small    *lle_value_out,
+    Dwarf_Addr     *lowpc_out,
+    Dwarf_Addr     *highpc_out,
+    Dwarf_Bool     *unavailable_out,
+    Dwarf_Ptr      *bytes_out,
+    Dwarf_Unsigned *len_out,
+    Dwarf_Error    *error)
+{
+    if (!cursor || cursor->lcu_magic != LOCLIST_CURSOR_MAGIC) {
+        return cursor_error(NULL,error,
+            "DW_DLE_LOCATION_ERROR: Dwarf_Loclist_Cursor "
+            "passed to dwarf_loclist_cursor_next() is NULL "
+            "or was not set up by dwarf_loclist_cursor_init()");
+    }
+    if (cursor->lcu_done) {
+        return DW_DLV_NO_ENTRY;
+    }
+    switch(cursor->lcu_kind) {
+    case DW_LKIND_expression: {
+        Dwarf_Half address_size = cursor->lcu_address_size;
+
+        cursor->lcu_done = TRUE;
+        *lle_value_out = DW_LLE_start_end;
+        *lowpc_out = 0;
+        *highpc_out = MAX_ADDR;
+        *unavailable_out = FALSE;
+        *bytes_out = cursor->lcu_next;
+        *len_out = cursor->lcu_expr_len;
+        return DW_DLV_OK;
+        }
+    case DW_LKIND_loclist:
+        return cursor_next_loc(cursor,lle_value_out,
+            lowpc_out,highpc_out,unavailable_out,
+            bytes_out,len_out,error);
+    case DW_LKIND_GNU_exp_list:
+        return cursor_next_gnu(cursor,lle_value_out,
+            lowpc_out,highpc_out,unavailable_out,
+            bytes_out,len_out,error);
+    case DW_LKIND_loclists:
+        return cursor_next_loclists(cursor,lle_value_out,
+            lowpc_out,highpc_out,unavailable_out,
+            bytes_out,len_out,error);
+    default:
+        break;
+    }
+    return cursor_error(cursor->lcu_dbg,error,
+        "DW_DLE_LOCATION_ERROR: Dwarf_Loclist_Cursor "
+        "has an impossible location kind");
+}
+
+int
+dwarf_loclist_at_pc(Dwarf_Attribute attr,
+    Dwarf_Addr       pc,
+    Dwarf_Addr     * lowpc_out,
+    Dwarf_Addr     * highpc_out,
+    Dwarf_Ptr      * bytes_out,
+    Dwarf_Unsigned * len_out,
+    Dwarf_Error    * error)
+{
+    Dwarf_Loclist_Cursor cursor;
+    Dwarf_Bool     have_default = FALSE;
+    Dwarf_Ptr      default_bytes = 0;
+    Dwarf_Unsigned default_len = 0;
+    int res = 0;
+
+    res = dwarf_loclist_cursor_init(attr,&cursor,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    for (;;) {
+        Dwarf_Small    lle = 0;
+        Dwarf_Addr     lowpc = 0;
+        Dwarf_Addr     highpc = 0;
+        Dwarf_Bool     unavailable = FALSE;
+        Dwarf_Ptr      bytes = 0;
+        Dwarf_Unsigned len = 0;
+
+        res = dwarf_loclist_cursor_next(&cursor,&lle,
+            &lowpc,&highpc,&unavailable,&bytes,&len,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        if (res == DW_DLV_NO_ENTRY) {
+            break;
+        }
+        if (cursor.lcu_kind == DW_LKIND_loclists &&
+            lle == DW_LLE_default_location) {
+            if (!have_default) {
+                have_default = TRUE;
+                default_bytes = bytes;
+                default_len = len;
+            }
+            continue;
+        }
+        if (unavailable) {
+            continue;
+        }
+        if (cursor.lcu_kind == DW_LKIND_expression ||
+            (lowpc <= pc && pc < highpc)) {
+            *lowpc_out = lowpc;
+            *highpc_out = highpc;
+            *bytes_out = bytes;
+            *len_out = len;
+            return DW_DLV_OK;
+        }
+    }
+    if (have_default) {
+        *lowpc_out = 0;
+        *highpc_out = 0;
+        *bytes_out = default_bytes;
+        *len_out = default_len;
+        return DW_DLV_OK;
+    }
+    return DW_DLV_NO_ENTRY;
+}
@@ -32,6 +32,7 @@ extern "C" {
 #endif /* __cplusplus */
 
 #define LOCLISTS_MAGIC  0xadab4
+#define LOCLIST_CURSOR_MAGIC  0xadab5
 
 typedef struct Dwarf_Loc_Chain_s *Dwarf_Loc_Chain;
 struct Dwarf_Loc_Chain_s {
@@ -308,6 +309,27 @@ int _dwarf_loclists_fill_in_lle_head(Dwarf_Debug dbg,
     Dwarf_Loc_Head_c llhead,
     Dwarf_Error *error);
 
+int _dwarf_loclists_find_lle_start(Dwarf_Debug dbg,
+    Dwarf_Attribute attr,
+    int             theform,
+    Dwarf_Unsigned *contextnum_out,
+    Dwarf_Unsigned *lle_offset_out,
+    Dwarf_Error    *error);
+
+int _dwarf_read_single_lle_entry(Dwarf_Debug dbg,
+    Dwarf_Small    *data,
+    Dwarf_Unsigned  dataoffset,
+    Dwarf_Small    *enddata,
+    unsigned        address_size,
+    unsigned       *bytes_count_out,
+    unsigned       *entry_kind,
+    Dwarf_Unsigned *entry_operand1,
+    Dwarf_Unsigned *entry_operand2,
+    Dwarf_Unsigned *opsblocksize,
+    Dwarf_Unsigned *opsoffset,
+    Dwarf_Small   **ops,
+    Dwarf_Error    *err);
+
 int _dwarf_loclists_expression_build(Dwarf_Debug dbg,
     Dwarf_Attribute attr,
     Dwarf_Loc_Head_c* llhead,
@@ -115,8 +115,8 @@ counted_loc_descr(Dwarf_Debug dbg,
     return DW_DLV_OK;
 }
 
-static int
-read_single_lle_entry(Dwarf_Debug dbg,
+int
+_dwarf_read_single_lle_entry(Dwarf_Debug dbg,
     Dwarf_Small    *data,
     Dwarf_Unsigned  dataoffset,
     Dwarf_Small    *enddata,
@@ -837,7 +837,7 @@ int dwarf_get_loclist_lle(Dwarf_Debug dbg,
         return DW_DLV_ERROR;
     }
     address_size = con->lc_address_size;
-    res = read_single_lle_entry(dbg,
+    res = _dwarf_read_single_lle_entry(dbg,
         data,entry_offset,enddata,
         address_size, entrylen,
         entry_kind, entry_operand1, entry_operand2,
@@ -1023,7 +1023,7 @@ build_array_of_lle(Dwarf_Debug dbg,
         Dwarf_Block_c eops;
 
         memset(&eops,0,sizeof(eops));
-        res = read_single_lle_entry(dbg,
+        res = _dwarf_read_single_lle_entry(dbg,
             data,dataoffset, enddata,
             address_size,&entrylen,
             &code,&val1, &val2,
@@ -1103,15 +1103,17 @@ build_array_of_lle(Dwarf_Debug dbg,
     return DW_DLV_OK;
 }
 
-/*  Build a head with all the relevent Entries
-    attached, all the locdescs and for each such,
-    all its expression operators.
-*/
+/*  Given a DWARF5 location attribute find the
+    Dwarf_Loclists_Context (by index) the list
+    lives in and the section offset of its first
+    entry.  Does no allocation. */
 int
-_dwarf_loclists_fill_in_lle_head(Dwarf_Debug dbg,
+_dwarf_loclists_find_lle_start(Dwarf_Debug dbg,
     Dwarf_Attribute attr,
-    Dwarf_Loc_Head_c llhead,
-    Dwarf_Error         *error)
+    int             theform,
+    Dwarf_Unsigned *contextnum_out,
+    Dwarf_Unsigned *lle_offset_out,
+    Dwarf_Error    *error)
 {
     int res = 0;
     Dwarf_Unsigned loclists_contextnum = 0;
@@ -1126,7 +1128,6 @@ _dwarf_loclists_fill_in_lle_head(Dwarf_Debug dbg,
     Dwarf_CU_Context ctx = 0;
     Dwarf_Unsigned offset_in_loclists = 0;
     Dwarf_Bool is_loclistx = FALSE;
-    int theform = llhead->ll_attrform;
     Dwarf_Unsigned attr_val = 0;
 
     ctx = attr->ar_cu_context;
@@ -1205,14 +1206,6 @@ _dwarf_loclists_fill_in_lle_head(Dwarf_Debug dbg,
         dwarfstring_destructor(&m);
         return DW_DLV_ERROR;
     }
-    llhead->ll_localcontext = rctx;
-    llhead->ll_index = loclists_contextnum;
-    llhead->ll_cuversion = rctx->lc_version;
-    llhead->ll_offset_size = offsetsize;
-    llhead->ll_address_size  = rctx->lc_address_size;
-    llhead->ll_segment_selector_size =
-        rctx->lc_segment_selector_size;
-
     if (is_loclistx) {
         Dwarf_Unsigned table_entryval = 0;
 
@@ -1226,7 +1219,56 @@ _dwarf_loclists_fill_in_lle_head(Dwarf_Debug dbg,
     } else {
         lle_global_offset = attr_val;
     }
-    llhead->ll_end_data_area = enddata;
+    if (lle_global_offset >= dbg->de_debug_loclists.dss_size) {
+        dwarfstring m;
+
+        dwarfstring_constructor(&m);
+        dwarfstring_append_printf_u(&m,
+            "DW_DLE_LOCLISTS_ERROR: loclist offset of"
+            " 0x%" DW_PR_XZEROS DW_PR_DUx ,lle_global_offset);
+        dwarfstring_append(&m,
+            " is outside .debug_loclists. Corrupted data?");
+        _dwarf_error_string(dbg,error,
+            DW_DLE_LOCLISTS_ERROR,
+            dwarfstring_string(&m));
+        dwarfstring_destructor(&m);
+        return DW_DLV_ERROR;
+    }
+    *contextnum_out = loclists_contextnum;
+    *lle_offset_out = lle_global_offset;
+    return DW_DLV_OK;
+}
+
+/*  Build a head with all the relevent Entries
+    attached, all the locdescs and for each such,
+    all its expression operators.
+*/
+int
+_dwarf_loclists_fill_in_lle_head(Dwarf_Debug dbg,
+    Dwarf_Attribute attr,
+    Dwarf_Loc_Head_c llhead,
+    Dwarf_Error         *error)
+{
+    int res = 0;
+    Dwarf_Unsigned loclists_contextnum = 0;
+    Dwarf_Loclists_Context rctx = 0;
+    Dwarf_Unsigned lle_global_offset = 0;
+
+    res = _dwarf_loclists_find_lle_start(dbg,attr,
+        llhead->ll_attrform,
+        &loclists_contextnum,&lle_global_offset,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    rctx = dbg->de_loclists_context[loclists_contextnum];
+    llhead->ll_localcontext = rctx;
+    llhead->ll_index = loclists_contextnum;
+    llhead->ll_cuversion = rctx->lc_version;
+    llhead->ll_offset_size = rctx->lc_offset_size;
+    llhead->ll_address_size  = rctx->lc_address_size;
+    llhead->ll_segment_selector_size =
+        rctx->lc_segment_selector_size;
+    llhead->ll_end_data_area = rctx->lc_endaddr;
 
     llhead->ll_llearea_offset = lle_global_offset;
     llhead->ll_llepointer = lle_global_offset +
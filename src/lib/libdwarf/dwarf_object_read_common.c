@@ -45,7 +45,7 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif /* HAVE_STDAFX_H */
 #include <io.h> /* off_t */
 #elif defined HAVE_UNISTD_H
-#include <unistd.h> /* off_t */
+#include <unistd.h> /* off_t pread() */
 #endif /* _WIN32*/
 
 #include "dwarf.h"
@@ -81,12 +81,21 @@ _dwarf_object_read_random(int fd, char *buf, off_t loc,
         *errc = DW_DLE_READ_OFF_END;
         return DW_DLV_ERROR;
     }
+#if !defined(_WIN32) && defined(HAVE_UNISTD_H)
+    /*  pread() leaves the file offset alone, so
+        processes sharing the fd (a client that
+        forks after dwarf_init) do not disturb
+        one another's reads. */
+    (void)scode;
+    rcode = pread(fd,buf,size,loc);
+#else /* _WIN32 or no unistd.h */
     scode = lseek(fd,loc,SEEK_SET);
     if (scode == (off_t)-1) {
         *errc = DW_DLE_SEEK_ERROR;
         return DW_DLV_ERROR;
     }
     rcode = read(fd,buf,size);
+#endif /* !_WIN32 && HAVE_UNISTD_H */
     if (rcode == -1 ||
         (size_t)rcode != size) {
         *errc = DW_DLE_READ_ERROR;
@@ -279,6 +279,21 @@ struct Dwarf_CU_Context_s {
     Dwarf_Unsigned cc_str_offsets_header_length;
     Dwarf_Unsigned cc_str_offsets_offset_size;
 
+    /*  This CU's slice of .debug_addr and of
+        .debug_str_offsets converted to host byte order,
+        built on the first index lookup so that each
+        later DW_FORM_addrx/strx or DW_OP_addrx is a single
+        bounds-checked load. The _tried flags record that
+        a build was attempted: a slice without a DWARF5
+        table header cannot be bounded and continues to
+        use the per-lookup path.  Freed with the context. */
+    Dwarf_Addr    *cc_addr_table;
+    Dwarf_Unsigned cc_addr_table_count;
+    Dwarf_Bool     cc_addr_table_tried;
+    Dwarf_Unsigned *cc_str_offsets_table;
+    Dwarf_Unsigned cc_str_offsets_table_count;
+    Dwarf_Bool     cc_str_offsets_table_tried;
+
     /*  DW_SECT_MACRO */
     Dwarf_Unsigned cc_macro_base;    /*DW5 */
     Dwarf_Unsigned cc_macro_base_contr_size;    /*DW5 */
@@ -426,6 +441,15 @@ struct Dwarf_Section_s {
         space for libdwarf.  */
     Dwarf_Small     dss_ignore_reloc_group_sec;
     char dss_is_rela;
+
+    /*  What _dwarf_load_section() did, for
+        dwarf_get_section_load_stats(): bytes read
+        from the object, the size after decompression
+        (zero if not compressed) and the bytes of
+        relocation records applied. */
+    Dwarf_Unsigned dss_stats_bytes_read;
+    Dwarf_Unsigned dss_stats_bytes_decompressed;
+    Dwarf_Unsigned dss_stats_reloc_bytes;
 };
 
 /*  Overview: if next_to_use== first, no error slots are used.
@@ -559,6 +583,11 @@ struct Dwarf_Group_Data_s {
     void *gd_map;
 };
 
+/*  ALLOC_AREA_INDEX_TABLE_MAX is the size of the
+    struct ial_s index_into_allocated array in dwarf_alloc.c
+*/
+#define ALLOC_AREA_INDEX_TABLE_MAX 67
+
 struct Dwarf_Debug_s {
     Dwarf_Unsigned de_magic;
     /*  All file access methods and support data
@@ -688,6 +717,16 @@ struct Dwarf_Debug_s {
         rnglists context instances */
     Dwarf_Rnglists_Context *  de_rnglists_context;
 
+    /*  Sorted, merged code ranges built by
+        dwarf_die_ranges(). A dwarf_tsearch hash
+        of struct Dwarf_Die_Ranges_Entry_s, see
+        dwarf_ranges.c. */
+    void * de_die_ranges_cache;
+    /*  Entries that could not be put in the hash
+        (out of memory) are kept on this list
+        until dwarf_finish(). */
+    struct Dwarf_Die_Ranges_Entry_s * de_die_ranges_uncached;
+
     /*  For the .debug_loclists[.dwo] section */
     Dwarf_Unsigned de_loclists_context_count;
     /*  pointer to array of pointers to
@@ -760,6 +799,13 @@ struct Dwarf_Debug_s {
 
     struct Dwarf_Harmless_s de_harmless_errors;
 
+    /*  What _dwarf_get_alloc() and dwarf_dealloc()
+        did for each DW_DLA type, for
+        dwarf_get_alloc_stats(). */
+    Dwarf_Unsigned de_alloc_count[ALLOC_AREA_INDEX_TABLE_MAX];
+    Dwarf_Unsigned de_alloc_bytes[ALLOC_AREA_INDEX_TABLE_MAX];
+    Dwarf_Unsigned de_dealloc_count[ALLOC_AREA_INDEX_TABLE_MAX];
+
     struct Dwarf_Printf_Callback_Info_s  de_printf_callback;
     void *   de_printf_callback_null_device_handle;
 
@@ -808,6 +854,7 @@ struct Dwarf_Chain_o {
     { 0xff,0xff,0xff,0xff }
 
 int _dwarf_ignorethissection(const char *scn_name);
+int _dwarf_section_filtered_out(const char *scn_name);
 
 /*  We don't load the sections until they are needed.
     This function is used to load the section.  */
@@ -816,6 +863,15 @@ int _dwarf_load_section(Dwarf_Debug,
     Dwarf_Error *);
 
 void _dwarf_dealloc_rnglists_context(Dwarf_Debug dbg);
+void _dwarf_destroy_die_ranges_cache(Dwarf_Debug dbg);
+void _dwarf_cu_context_destructor(void *m);
+void _dwarf_build_cu_addr_table(Dwarf_Debug dbg,
+    Dwarf_CU_Context context);
+void _dwarf_discard_cu_addr_table(Dwarf_CU_Context context);
+void _dwarf_build_cu_str_offsets_table(Dwarf_Debug dbg,
+    Dwarf_CU_Context context,
+    Dwarf_Unsigned str_offsets_base);
+void _dwarf_discard_cu_str_offsets_table(Dwarf_CU_Context context);
 void _dwarf_dealloc_loclists_context(Dwarf_Debug dbg);
 
 int _dwarf_get_string_base_attr_value(Dwarf_Debug dbg,
@@ -32,6 +32,7 @@
 #include <config.h>
 
 #include <stddef.h> /* NULL size_t */
+#include <string.h> /* memset() */
 
 #if defined(_WIN32) && defined(HAVE_STDAFX_H)
 #include "stdafx.h"
@@ -592,6 +593,345 @@ dwarf_attrlist(Dwarf_Die die,
     return DW_DLV_OK;
 }
 
+/*  For BLOCK and EXPRLOC class values point
+    av_data at the block contents, past the length. */
+static int
+decode_block_value(Dwarf_Debug dbg,
+    Dwarf_Attr_Value *av,
+    Dwarf_Byte_Ptr die_info_end,
+    Dwarf_Error *error)
+{
+    Dwarf_Byte_Ptr data = av->av_data;
+    Dwarf_Unsigned length = 0;
+    int lensize = 0;
+    int res = 0;
+
+    switch (av->av_form) {
+    case DW_FORM_block1:
+        lensize = 1;
+        break;
+    case DW_FORM_block2:
+        lensize = DWARF_HALF_SIZE;
+        break;
+    case DW_FORM_block4:
+        lensize = DWARF_32BIT_SIZE;
+        break;
+    case DW_FORM_block:
+    case DW_FORM_exprloc:
+        res = _dwarf_leb128_uword_wrapper(dbg,
+            &data,die_info_end,&length,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        break;
+    default:
+        /*  Not a block form, leave the raw value. */
+        return DW_DLV_OK;
+    }
+    if (lensize) {
+        res = _dwarf_read_unaligned_ck_wrapper(dbg,
+            &length,data,lensize,die_info_end,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        data += lensize;
+    }
+    if (length > (Dwarf_Unsigned)(die_info_end - data)) {
+        dwarfstring m;
+
+        dwarfstring_constructor(&m);
+        dwarfstring_append_printf_u(&m,
+            "DW_DLE_FORM_BLOCK_LENGTH_ERROR: "
+            "A block of length 0x%x ",length);
+        dwarfstring_append(&m,
+            "runs off the end of the DIE section. "
+            "Corrupt DWARF.");
+        _dwarf_error_string(dbg, error,
+            DW_DLE_FORM_BLOCK_LENGTH_ERROR,
+            dwarfstring_string(&m));
+        dwarfstring_destructor(&m);
+        return DW_DLV_ERROR;
+    }
+    av->av_data = data;
+    av->av_data_len = length;
+    return DW_DLV_OK;
+}
+
+/*  Decodes the value of one attribute per its form
+    class. The Dwarf_Attribute is a stack record
+    filled in by dwarf_die_decode_attrs(), never
+    allocated and never returned to the caller. */
+static int
+decode_attr_value(Dwarf_Attribute attr,
+    Dwarf_Attr_Value *av,
+    Dwarf_Byte_Ptr die_info_end,
+    Dwarf_Error *error)
+{
+    Dwarf_Debug dbg = attr->ar_dbg;
+    Dwarf_CU_Context context = attr->ar_cu_context;
+    Dwarf_Off offset = 0;
+    int res = DW_DLV_OK;
+
+    switch (av->av_formclass) {
+    case DW_FORM_CLASS_ADDRESS:
+        if (!dwarf_addr_form_is_indexed(av->av_form)) {
+            return dwarf_formaddr(attr,&av->av_unsigned,error);
+        }
+        res = _dwarf_get_addr_index_itself(av->av_form,
+            attr->ar_debug_ptr,dbg,context,
+            &av->av_unsigned,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        if (!dbg->de_debug_addr.dss_size &&
+            !dbg->de_tied_data.td_tied_object) {
+            /*  Report the index rather than
+                build an error for every value. */
+            av->av_is_index = TRUE;
+            return DW_DLV_OK;
+        }
+        return _dwarf_look_in_local_and_tied_by_index(dbg,
+            context,av->av_unsigned,&av->av_unsigned,error);
+    case DW_FORM_CLASS_CONSTANT:
+        if (av->av_form == DW_FORM_data16) {
+            return DW_DLV_OK;
+        }
+        if (av->av_form == DW_FORM_sdata ||
+            av->av_form == DW_FORM_implicit_const) {
+            res = dwarf_formsdata(attr,&av->av_signed,error);
+            av->av_unsigned = (Dwarf_Unsigned)av->av_signed;
+            return res;
+        }
+        res = dwarf_formudata(attr,&av->av_unsigned,error);
+        av->av_signed = (Dwarf_Signed)av->av_unsigned;
+        return res;
+    case DW_FORM_CLASS_FLAG: {
+        Dwarf_Bool flag = 0;
+
+        res = dwarf_formflag(attr,&flag,error);
+        av->av_unsigned = flag;
+        return res;
+        }
+    case DW_FORM_CLASS_REFERENCE:
+        if (av->av_form == DW_FORM_ref_sig8) {
+            return DW_DLV_OK;
+        }
+        res = dwarf_global_formref_b(attr,&offset,
+            &av->av_is_info,error);
+        av->av_unsigned = offset;
+        return res;
+    case DW_FORM_CLASS_STRING: {
+        char *str = 0;
+
+        res = dwarf_formstring(attr,&str,error);
+        av->av_string = str;
+        return res;
+        }
+    case DW_FORM_CLASS_BLOCK:
+    case DW_FORM_CLASS_EXPRLOC:
+        return decode_block_value(dbg,av,die_info_end,error);
+    case DW_FORM_CLASS_LINEPTR:
+    case DW_FORM_CLASS_LOCLISTPTR:
+    case DW_FORM_CLASS_MACPTR:
+    case DW_FORM_CLASS_RANGELISTPTR:
+    case DW_FORM_CLASS_FRAMEPTR:
+    case DW_FORM_CLASS_MACROPTR:
+    case DW_FORM_CLASS_ADDRPTR:
+    case DW_FORM_CLASS_LOCLIST:
+    case DW_FORM_CLASS_LOCLISTSPTR:
+    case DW_FORM_CLASS_RNGLIST:
+    case DW_FORM_CLASS_RNGLISTSPTR:
+    case DW_FORM_CLASS_STROFFSETSPTR:
+        if (av->av_form == DW_FORM_sec_offset) {
+            res = dwarf_global_formref_b(attr,&offset,
+                &av->av_is_info,error);
+            av->av_unsigned = offset;
+            return res;
+        }
+        if (av->av_form == DW_FORM_loclistx ||
+            av->av_form == DW_FORM_rnglistx) {
+            av->av_is_index = TRUE;
+        }
+        /*  DWARF2,3 data4/data8 offsets or the index. */
+        return dwarf_formudata(attr,&av->av_unsigned,error);
+    default:
+        break;
+    }
+    /*  DW_FORM_CLASS_UNKNOWN, such as a vendor attribute.
+        A DW_FORM_sec_offset is still an offset. */
+    if (av->av_form == DW_FORM_sec_offset) {
+        res = dwarf_global_formref_b(attr,&offset,
+            &av->av_is_info,error);
+        av->av_unsigned = offset;
+    }
+    return res;
+}
+
+int
+dwarf_die_decode_attrs(Dwarf_Die die,
+    Dwarf_Attr_Value * values,
+    Dwarf_Unsigned values_len,
+    Dwarf_Unsigned * attrcount,
+    Dwarf_Error * error)
+{
+    Dwarf_Unsigned attr_count = 0;
+    Dwarf_Unsigned attr = 0;
+    Dwarf_Unsigned attr_form = 0;
+    Dwarf_Byte_Ptr abbrev_ptr = 0;
+    Dwarf_Byte_Ptr abbrev_end = 0;
+    Dwarf_Debug dbg = 0;
+    Dwarf_Byte_Ptr info_ptr = 0;
+    Dwarf_Byte_Ptr die_info_end = 0;
+    Dwarf_CU_Context context = 0;
+    Dwarf_Half version = 0;
+    Dwarf_Half offset_size = 0;
+    int res = 0;
+
+    CHECK_DIE(die, DW_DLV_ERROR);
+    if (!values && values_len) {
+        _dwarf_error_string(die->di_cu_context->cc_dbg,error,
+            DW_DLE_DIE_BAD,
+            "DW_DLE_DIE_BAD: dwarf_die_decode_attrs() "
+            "passed a NULL values array");
+        return DW_DLV_ERROR;
+    }
+    context = die->di_cu_context;
+    dbg = context->cc_dbg;
+    version = context->cc_version_stamp;
+    offset_size = context->cc_length_size;
+    die_info_end =
+        _dwarf_calculate_info_section_end_ptr(context);
+    /*  The DIE already holds its abbreviation,
+        no lookup by code is needed. */
+    abbrev_ptr = die->di_abbrev_list->abl_abbrev_ptr;
+    abbrev_end = _dwarf_calculate_abbrev_section_end_ptr(context);
+
+    info_ptr = die->di_debug_ptr;
+    {
+        /* SKIP_LEB128 */
+        Dwarf_Unsigned ignore_this = 0;
+        Dwarf_Unsigned len = 0;
+
+        res = dwarf_decode_leb128((char *)info_ptr,
+            &len,&ignore_this,(char *)die_info_end);
+        if (res == DW_DLV_ERROR) {
+            _dwarf_error_string(dbg, error, DW_DLE_DIE_BAD,
+                "DW_DLE_DIE_BAD: In decoding attributes "
+                "we run off the end of the DIE while skipping "
+                " the DIE tag");
+            return DW_DLV_ERROR;
+        }
+        info_ptr += len;
+    }
+    for (;;) {
+        Dwarf_Signed implicit_const = 0;
+        Dwarf_Unsigned sov = 0;
+        Dwarf_Attr_Value *av = 0;
+        Dwarf_Byte_Ptr attr_start = 0;
+        struct Dwarf_Attribute_s localattr;
+
+        res = _dwarf_leb128_uword_wrapper(dbg,
+            &abbrev_ptr,abbrev_end,&attr,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        if (attr > DW_AT_hi_user) {
+            _dwarf_error(dbg, error,DW_DLE_ATTR_CORRUPT);
+            return DW_DLV_ERROR;
+        }
+        res = _dwarf_leb128_uword_wrapper(dbg,
+            &abbrev_ptr,abbrev_end,&attr_form,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+        if (!attr && !attr_form) {
+            break;
+        }
+        if (!_dwarf_valid_form_we_know(attr_form,attr)) {
+            _dwarf_error(dbg, error, DW_DLE_UNKNOWN_FORM);
+            return DW_DLV_ERROR;
+        }
+        if (attr_form == DW_FORM_implicit_const) {
+            res = _dwarf_leb128_sword_wrapper(dbg,&abbrev_ptr,
+                abbrev_end, &implicit_const, error);
+            if (res == DW_DLV_ERROR) {
+                return res;
+            }
+        }
+        if (!attr) {
+            continue;
+        }
+        memset(&localattr,0,sizeof(localattr));
+        localattr.ar_attribute = (Dwarf_Half)attr;
+        localattr.ar_attribute_form_direct = (Dwarf_Half)attr_form;
+        attr_start = info_ptr;
+        if (attr_form == DW_FORM_indirect) {
+            res = _dwarf_leb128_uword_wrapper(dbg,
+                &info_ptr,die_info_end,&attr_form,error);
+            if (res == DW_DLV_ERROR) {
+                return res;
+            }
+            if (!_dwarf_valid_form_we_know(attr_form,attr)) {
+                _dwarf_error(dbg, error, DW_DLE_UNKNOWN_FORM);
+                return DW_DLV_ERROR;
+            }
+        }
+        localattr.ar_attribute_form = (Dwarf_Half)attr_form;
+        if (attr_form != DW_FORM_implicit_const &&
+            _dwarf_reference_outside_section(die,
+            (Dwarf_Small*) info_ptr,
+            ((Dwarf_Small*) info_ptr )+1)) {
+            _dwarf_error_string(dbg, error,
+                DW_DLE_ATTR_OUTSIDE_SECTION,
+                "DW_DLE_ATTR_OUTSIDE_SECTION: "
+                " Decoding attributes: "
+                "We have run off the end of the section. "
+                "Corrupt Dwarf");
+            return DW_DLV_ERROR;
+        }
+        localattr.ar_cu_context = context;
+        localattr.ar_debug_ptr = info_ptr;
+        localattr.ar_die = die;
+        localattr.ar_dbg = dbg;
+        localattr.ar_implicit_const = implicit_const;
+        if (attr_form != DW_FORM_implicit_const) {
+            res = _dwarf_get_size_of_val(dbg,
+                attr_form, version,
+                context->cc_address_size,
+                info_ptr, offset_size,
+                &sov, die_info_end, error);
+            if (res != DW_DLV_OK) {
+                return res;
+            }
+        }
+        if (attr_count < values_len) {
+            av = values + attr_count;
+            memset(av,0,sizeof(*av));
+            av->av_attrnum = (Dwarf_Half)attr;
+            av->av_form = (Dwarf_Half)attr_form;
+            av->av_formclass = dwarf_get_form_class(version,
+                (Dwarf_Half)attr,offset_size,(Dwarf_Half)attr_form);
+            if (attr_form != DW_FORM_implicit_const) {
+                av->av_data = info_ptr;
+                av->av_data_len = sov;
+            }
+            av->av_size = (info_ptr - attr_start) + sov;
+            res = decode_attr_value(&localattr,av,
+                die_info_end,error);
+            if (res != DW_DLV_OK) {
+                return res;
+            }
+        }
+        info_ptr += sov;
+        attr_count++;
+    }
+    *attrcount = attr_count;
+    if (!attr_count) {
+        return DW_DLV_NO_ENTRY;
+    }
+    return DW_DLV_OK;
+}
+
 /*
     This function takes a die, and an attr, and returns
     a pointer to the start of the value of that attr in
@@ -900,6 +1240,10 @@ _dwarf_extract_address_from_debug_addr(Dwarf_Debug dbg,
     Dwarf_Byte_Ptr  sectionend = 0;
     Dwarf_Unsigned  sectionsize  = 0;
 
+    if (addrindex < context->cc_addr_table_count) {
+        *addr_out = context->cc_addr_table[addrindex];
+        return DW_DLV_OK;
+    }
     address_base = context->cc_addr_base;
     res = _dwarf_load_section(dbg, &dbg->de_debug_addr,error);
     if (res != DW_DLV_OK) {
@@ -917,6 +1261,13 @@ _dwarf_extract_address_from_debug_addr(Dwarf_Debug dbg,
         rely on DW_AT_addr_base too. */
     /*  DW_FORM_GNU_addr_index  relies on DW_AT_GNU_addr_base
         which is in the CU die. */
+    if (!context->cc_addr_table_tried) {
+        _dwarf_build_cu_addr_table(dbg,context);
+        if (addrindex < context->cc_addr_table_count) {
+            *addr_out = context->cc_addr_table[addrindex];
+            return DW_DLV_OK;
+        }
+    }
 
     sectionstart = dbg->de_debug_addr.dss_data;
     addr_offset = address_base +
@@ -1161,6 +1512,7 @@ _dwarf_merge_all_base_attrs_of_cu_die(Dwarf_Debug dbg,
             tiedcontext->cc_addr_base_present;
         context->        cc_addr_base=
             tiedcontext->cc_addr_base;
+        _dwarf_discard_cu_addr_table(context);
     }
     if (!context->cc_rnglists_base_present) {
         context->        cc_rnglists_base_present =
@@ -1179,6 +1531,7 @@ _dwarf_merge_all_base_attrs_of_cu_die(Dwarf_Debug dbg,
             tiedcontext->cc_str_offsets_base_present;
         context->        cc_str_offsets_base=
             tiedcontext->cc_str_offsets_base;
+        _dwarf_discard_cu_str_offsets_table(context);
     }
 
     /* GNU DW4 extension. */
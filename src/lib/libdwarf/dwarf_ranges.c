@@ -29,12 +29,17 @@
 
 #include <config.h>
 
-#include <stdlib.h> /* calloc() free() */
+#include <stdlib.h> /* calloc() free() malloc() qsort() */
+#include <string.h> /* memset() */
 
 #if defined(_WIN32) && defined(HAVE_STDAFX_H)
 #include "stdafx.h"
 #endif /* HAVE_STDAFX_H */
 
+#ifdef HAVE_STDINT_H
+#include <stdint.h> /* uintptr_t */
+#endif /* HAVE_STDINT_H */
+
 #include "dwarf.h"
 #include "libdwarf.h"
 #include "libdwarf_private.h"
@@ -43,6 +48,7 @@
 #include "dwarf_alloc.h"
 #include "dwarf_error.h"
 #include "dwarf_util.h"
+#include "dwarf_tsearch.h"
 #include "dwarf_string.h"
 
 struct ranges_entry {
@@ -352,3 +358,426 @@ dwarf_dealloc_ranges(Dwarf_Debug dbg, Dwarf_Ranges * rangesbuf,
 {
     dwarf_dealloc(dbg,rangesbuf, DW_DLA_RANGES);
 }
+
+/*  The cache behind dwarf_die_ranges().
+    For DW_AT_ranges the key is the CU context plus
+    the attribute form and value, so every DIE
+    sharing a range list shares one entry.
+    For DW_AT_low_pc/DW_AT_high_pc the key is the CU
+    context plus the DIE offset. */
+struct Dwarf_Die_Ranges_Entry_s {
+    Dwarf_CU_Context dr_context;
+    Dwarf_Half       dr_attr;
+    Dwarf_Half       dr_form;
+    Dwarf_Unsigned   dr_value;
+    Dwarf_Unsigned   dr_count;
+    Dwarf_Pc_Range  *dr_ranges;
+    struct Dwarf_Die_Ranges_Entry_s *dr_next;
+};
+
+/*  Just a guess at how many distinct range sets
+    a typical object has. The hash grows as needed. */
+#define DIE_RANGES_HASH_ESTIMATE 1000
+
+static DW_TSHASHTYPE
+die_ranges_hashfunc(const void *keyp)
+{
+    const struct Dwarf_Die_Ranges_Entry_s *e = keyp;
+    DW_TSHASHTYPE h = (DW_TSHASHTYPE)(uintptr_t)e->dr_context;
+
+    h ^= (DW_TSHASHTYPE)(e->dr_value * 31);
+    h ^= (DW_TSHASHTYPE)e->dr_attr << 3;
+    return h;
+}
+
+static int
+die_ranges_compare(const void *l, const void *r)
+{
+    const struct Dwarf_Die_Ranges_Entry_s *lp = l;
+    const struct Dwarf_Die_Ranges_Entry_s *rp = r;
+    uintptr_t lc = (uintptr_t)lp->dr_context;
+    uintptr_t rc = (uintptr_t)rp->dr_context;
+
+    if (lc != rc) {
+        return (lc < rc)?-1:1;
+    }
+    if (lp->dr_value != rp->dr_value) {
+        return (lp->dr_value < rp->dr_value)?-1:1;
+    }
+    if (lp->dr_attr != rp->dr_attr) {
+        return (lp->dr_attr < rp->dr_attr)?-1:1;
+    }
+    if (lp->dr_form != rp->dr_form) {
+        return (lp->dr_form < rp->dr_form)?-1:1;
+    }
+    return 0;
+}
+
+static void
+die_ranges_free_node(void *nodep)
+{
+    struct Dwarf_Die_Ranges_Entry_s *e = nodep;
+
+    free(e->dr_ranges);
+    free(e);
+}
+
+void
+_dwarf_destroy_die_ranges_cache(Dwarf_Debug dbg)
+{
+    while (dbg->de_die_ranges_uncached) {
+        struct Dwarf_Die_Ranges_Entry_s *e =
+            dbg->de_die_ranges_uncached;
+
+        dbg->de_die_ranges_uncached = e->dr_next;
+        die_ranges_free_node(e);
+    }
+    if (!dbg->de_die_ranges_cache) {
+        return;
+    }
+    dwarf_tdestroy(dbg->de_die_ranges_cache,die_ranges_free_node);
+    dbg->de_die_ranges_cache = 0;
+}
+
+struct range_builder {
+    Dwarf_Pc_Range *rb_ranges;
+    Dwarf_Unsigned  rb_count;
+    Dwarf_Unsigned  rb_size;
+};
+
+static int
+add_range(Dwarf_Debug dbg,struct range_builder *rb,
+    Dwarf_Addr lowpc, Dwarf_Addr highpc,
+    Dwarf_Error *error)
+{
+    if (lowpc >= highpc) {
+        /* Empty, covers no addresses. */
+        return DW_DLV_OK;
+    }
+    if (rb->rb_count >= rb->rb_size) {
+        Dwarf_Unsigned newsize = rb->rb_size?rb->rb_size*2:8;
+        Dwarf_Pc_Range *n = 0;
+
+        n = realloc(rb->rb_ranges,newsize*sizeof(Dwarf_Pc_Range));
+        if (!n) {
+            _dwarf_error_string(dbg,error,DW_DLE_ALLOC_FAIL,
+                "DW_DLE_ALLOC_FAIL: growing the range array "
+                "in dwarf_die_ranges()");
+            return DW_DLV_ERROR;
+        }
+        rb->rb_ranges = n;
+        rb->rb_size = newsize;
+    }
+    rb->rb_ranges[rb->rb_count].pr_lowpc = lowpc;
+    rb->rb_ranges[rb->rb_count].pr_highpc = highpc;
+    rb->rb_count++;
+    return DW_DLV_OK;
+}
+
+/* DWARF2,3,4 .debug_ranges */
+static int
+collect_debug_ranges(Dwarf_Debug dbg,Dwarf_Die die,
+    Dwarf_Unsigned offset,
+    struct range_builder *rb,
+    Dwarf_Error *error)
+{
+    Dwarf_Ranges *rangeset = 0;
+    Dwarf_Signed rangecount = 0;
+    Dwarf_Signed i = 0;
+    Dwarf_Addr base = die->di_cu_context->cc_low_pc;
+    int res = 0;
+
+    res = dwarf_get_ranges_b(dbg,offset,die,0,
+        &rangeset,&rangecount,0,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    for (i = 0; i < rangecount; ++i) {
+        Dwarf_Ranges *r = rangeset+i;
+
+        if (r->dwr_type == DW_RANGES_END) {
+            break;
+        }
+        if (r->dwr_type == DW_RANGES_ADDRESS_SELECTION) {
+            base = r->dwr_addr2;
+            continue;
+        }
+        res = add_range(dbg,rb,r->dwr_addr1 + base,
+            r->dwr_addr2 + base,error);
+        if (res != DW_DLV_OK) {
+            dwarf_dealloc_ranges(dbg,rangeset,rangecount);
+            return res;
+        }
+    }
+    dwarf_dealloc_ranges(dbg,rangeset,rangecount);
+    return DW_DLV_OK;
+}
+
+/* DWARF5 .debug_rnglists */
+static int
+collect_rnglists(Dwarf_Debug dbg,Dwarf_Attribute attr,
+    Dwarf_Half form,
+    Dwarf_Unsigned value,
+    struct range_builder *rb,
+    Dwarf_Error *error)
+{
+    Dwarf_Rnglists_Head head = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned i = 0;
+    int res = 0;
+
+    res = dwarf_rnglists_get_rle_head(attr,form,value,
+        &head,&count,0,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    for (i = 0; i < count; ++i) {
+        unsigned entrylen = 0;
+        unsigned code = 0;
+        Dwarf_Unsigned raw1 = 0;
+        Dwarf_Unsigned raw2 = 0;
+        Dwarf_Bool unavailable = FALSE;
+        Dwarf_Unsigned lowpc = 0;
+        Dwarf_Unsigned highpc = 0;
+
+        res = dwarf_get_rnglists_entry_fields_a(head,i,
+            &entrylen,&code,&raw1,&raw2,&unavailable,
+            &lowpc,&highpc,error);
+        if (res != DW_DLV_OK) {
+            dwarf_dealloc_rnglists_head(head);
+            return res;
+        }
+        if (code == DW_RLE_end_of_list) {
+            break;
+        }
+        if (code == DW_RLE_base_addressx ||
+            code == DW_RLE_base_address ||
+            unavailable) {
+            continue;
+        }
+        res = add_range(dbg,rb,lowpc,highpc,error);
+        if (res != DW_DLV_OK) {
+            dwarf_dealloc_rnglists_head(head);
+            return res;
+        }
+    }
+    dwarf_dealloc_rnglists_head(head);
+    return DW_DLV_OK;
+}
+
+static int
+collect_low_high(Dwarf_Die die,
+    struct range_builder *rb,
+    Dwarf_Error *error)
+{
+    Dwarf_Debug dbg = die->di_cu_context->cc_dbg;
+    Dwarf_Addr lowpc = 0;
+    Dwarf_Addr highpc = 0;
+    Dwarf_Half form = 0;
+    enum Dwarf_Form_Class formclass = DW_FORM_CLASS_UNKNOWN;
+    int res = 0;
+
+    res = dwarf_lowpc(die,&lowpc,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    res = dwarf_highpc_b(die,&highpc,&form,&formclass,error);
+    if (res == DW_DLV_NO_ENTRY) {
+        /*  A lone DW_AT_low_pc names an address,
+            not a range of code. */
+        return DW_DLV_OK;
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    if (formclass == DW_FORM_CLASS_CONSTANT) {
+        highpc += lowpc;
+    }
+    return add_range(dbg,rb,lowpc,highpc,error);
+}
+
+static int
+compare_pc_range(const void *l, const void *r)
+{
+    const Dwarf_Pc_Range *lp = l;
+    const Dwarf_Pc_Range *rp = r;
+
+    if (lp->pr_lowpc != rp->pr_lowpc) {
+        return (lp->pr_lowpc < rp->pr_lowpc)?-1:1;
+    }
+    if (lp->pr_highpc != rp->pr_highpc) {
+        return (lp->pr_highpc < rp->pr_highpc)?-1:1;
+    }
+    return 0;
+}
+
+/*  Sort, then merge overlapping and adjacent ranges
+    in place. */
+static void
+normalize_ranges(struct range_builder *rb)
+{
+    Dwarf_Unsigned i = 0;
+    Dwarf_Unsigned out = 0;
+
+    if (rb->rb_count < 2) {
+        return;
+    }
+    qsort(rb->rb_ranges,(size_t)rb->rb_count,
+        sizeof(Dwarf_Pc_Range),compare_pc_range);
+    for (i = 1; i < rb->rb_count; ++i) {
+        Dwarf_Pc_Range *cur = rb->rb_ranges + out;
+        Dwarf_Pc_Range *next = rb->rb_ranges + i;
+
+        if (next->pr_lowpc <= cur->pr_highpc) {
+            if (next->pr_highpc > cur->pr_highpc) {
+                cur->pr_highpc = next->pr_highpc;
+            }
+            continue;
+        }
+        ++out;
+        rb->rb_ranges[out] = *next;
+    }
+    rb->rb_count = out+1;
+}
+
+int
+dwarf_die_ranges(Dwarf_Die die,
+    Dwarf_Pc_Range **ranges_out,
+    Dwarf_Unsigned  *count_out,
+    Dwarf_Error     *error)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_CU_Context context = 0;
+    Dwarf_Attribute attr = 0;
+    struct Dwarf_Die_Ranges_Entry_s key;
+    struct Dwarf_Die_Ranges_Entry_s *entry = 0;
+    struct range_builder rb;
+    void *found = 0;
+    int res = 0;
+
+    CHECK_DIE(die, DW_DLV_ERROR);
+    context = die->di_cu_context;
+    dbg = context->cc_dbg;
+    memset(&key,0,sizeof(key));
+    memset(&rb,0,sizeof(rb));
+    key.dr_context = context;
+    res = dwarf_attr(die,DW_AT_ranges,&attr,error);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_whatform(attr,&key.dr_form,error);
+        if (res == DW_DLV_OK) {
+            if (key.dr_form == DW_FORM_rnglistx) {
+                res = dwarf_formudata(attr,&key.dr_value,error);
+            } else {
+                res = dwarf_global_formref(attr,&key.dr_value,
+                    error);
+            }
+        }
+        if (res != DW_DLV_OK) {
+            dwarf_dealloc_attribute(attr);
+            return res;
+        }
+        key.dr_attr = DW_AT_ranges;
+    } else {
+        key.dr_attr = DW_AT_low_pc;
+        key.dr_value = die->di_debug_ptr - (die->di_is_info?
+            dbg->de_debug_info.dss_data:
+            dbg->de_debug_types.dss_data);
+    }
+    if (dbg->de_die_ranges_cache) {
+        found = dwarf_tfind(&key,&dbg->de_die_ranges_cache,
+            die_ranges_compare);
+        if (found) {
+            if (attr) {
+                dwarf_dealloc_attribute(attr);
+            }
+            entry = *(struct Dwarf_Die_Ranges_Entry_s **)found;
+            *ranges_out = entry->dr_ranges;
+            *count_out = entry->dr_count;
+            return DW_DLV_OK;
+        }
+    }
+    if (attr) {
+        if (key.dr_form == DW_FORM_rnglistx ||
+            context->cc_version_stamp >= DW_CU_VERSION5) {
+            res = collect_rnglists(dbg,attr,key.dr_form,
+                key.dr_value,&rb,error);
+        } else {
+            res = collect_debug_ranges(dbg,die,key.dr_value,
+                &rb,error);
+        }
+        dwarf_dealloc_attribute(attr);
+    } else {
+        res = collect_low_high(die,&rb,error);
+    }
+    if (res != DW_DLV_OK) {
+        free(rb.rb_ranges);
+        return res;
+    }
+    normalize_ranges(&rb);
+    entry = malloc(sizeof(*entry));
+    if (!entry) {
+        free(rb.rb_ranges);
+        _dwarf_error_string(dbg,error,DW_DLE_ALLOC_FAIL,
+            "DW_DLE_ALLOC_FAIL: allocating a range "
+            "cache entry in dwarf_die_ranges()");
+        return DW_DLV_ERROR;
+    }
+    *entry = key;
+    entry->dr_ranges = rb.rb_ranges;
+    entry->dr_count = rb.rb_count;
+    entry->dr_next = 0;
+    found = 0;
+    if (dbg->de_die_ranges_cache ||
+        dwarf_initialize_search_hash(&dbg->de_die_ranges_cache,
+        die_ranges_hashfunc,DIE_RANGES_HASH_ESTIMATE)) {
+        found = dwarf_tsearch(entry,&dbg->de_die_ranges_cache,
+            die_ranges_compare);
+    }
+    if (!found) {
+        /*  No memory for the hash. The caller still
+            gets the ranges, kept here till dwarf_finish(),
+            but the next call for this DIE builds them
+            again. */
+        entry->dr_next = dbg->de_die_ranges_uncached;
+        dbg->de_die_ranges_uncached = entry;
+    }
+    *ranges_out = entry->dr_ranges;
+    *count_out = entry->dr_count;
+    return DW_DLV_OK;
+}
+
+int
+dwarf_die_pc_in_ranges(Dwarf_Die die,
+    Dwarf_Addr   pc,
+    Dwarf_Bool  *contains_out,
+    Dwarf_Error *error)
+{
+    Dwarf_Pc_Range *ranges = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned lo = 0;
+    Dwarf_Unsigned hi = 0;
+    int res = 0;
+
+    res = dwarf_die_ranges(die,&ranges,&count,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    hi = count;
+    while (lo < hi) {
+        Dwarf_Unsigned mid = lo + (hi - lo)/2;
+
+        if (pc < ranges[mid].pr_lowpc) {
+            hi = mid;
+        } else if (pc >= ranges[mid].pr_highpc) {
+            lo = mid+1;
+        } else {
+            *contains_out = TRUE;
+            return DW_DLV_OK;
+        }
+    }
+    *contains_out = FALSE;
+    return DW_DLV_OK;
+}
@@ -28,6 +28,7 @@
 #include <config.h>
 
 #include <stddef.h> /* NULL size_t */
+#include <stdlib.h> /* free() */
 
 #if defined(_WIN32) && defined(HAVE_STDAFX_H)
 #include "stdafx.h"
@@ -607,3 +608,50 @@ dwarf_str_offsets_statistics(Dwarf_Str_Offsets_Table table_data,
     }
     return DW_DLV_OK;
 }
+
+/*  Builds context->cc_str_offsets_table, the CU's
+    slice of .debug_str_offsets in host byte order,
+    given the offset of entry zero. The slice is bounded
+    by the DWARF5 table header preceding that offset,
+    and the entries are the size that header gives;
+    without one (the DWARF4 GNU extension) no table is
+    built and lookups take the per-index path.
+    Never reports an error. */
+void
+_dwarf_build_cu_str_offsets_table(Dwarf_Debug dbg,
+    Dwarf_CU_Context context,
+    Dwarf_Unsigned str_offsets_base)
+{
+    struct Dwarf_Section_s *sec = &dbg->de_debug_str_offsets;
+    Dwarf_Unsigned table_end = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned entry_size = 0;
+    int res = 0;
+
+    context->cc_str_offsets_table_tried = TRUE;
+    res = _dwarf_find_dw5_table_end(dbg,sec,
+        str_offsets_base,&table_end,&entry_size);
+    if (res != DW_DLV_OK) {
+        return;
+    }
+    count = (table_end - str_offsets_base)/entry_size;
+    context->cc_str_offsets_table =
+        _dwarf_make_native_table(dbg,
+        sec->dss_data+str_offsets_base,entry_size,count);
+    if (context->cc_str_offsets_table) {
+        context->cc_str_offsets_table_count = count;
+    }
+}
+
+/*  A strx attribute can come before DW_AT_str_offsets_base
+    in the CU DIE, so a table may have been built from the
+    fallback base. Whoever sets the base calls this
+    so the next lookup builds the table again. */
+void
+_dwarf_discard_cu_str_offsets_table(Dwarf_CU_Context context)
+{
+    free(context->cc_str_offsets_table);
+    context->cc_str_offsets_table = 0;
+    context->cc_str_offsets_table_count = 0;
+    context->cc_str_offsets_table_tried = FALSE;
+}
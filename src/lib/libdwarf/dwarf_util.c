@@ -32,7 +32,7 @@
 #include <config.h>
 
 #include <stddef.h> /* NULL size_t */
-#include <stdlib.h> /* free() */
+#include <stdlib.h> /* free() malloc() */
 #include <string.h> /* memset() strlen() */
 
 #if defined(_WIN32) && defined(HAVE_STDAFX_H)
@@ -1414,6 +1414,117 @@ _dwarf_read_unaligned_ck_wrapper(Dwarf_Debug dbg,
     return DW_DLV_OK;
 }
 
+/*  Reads one value with no Dwarf_Error: the caller
+    has already checked that [readfrom,readfrom+len)
+    lies inside the section. */
+static Dwarf_Unsigned
+read_checked_value(Dwarf_Debug dbg,Dwarf_Small *readfrom,
+    int len)
+{
+    Dwarf_Unsigned val = 0;
+    Dwarf_Error    lerr = 0;
+    int            res = 0;
+
+    res = _dwarf_read_unaligned_ck_wrapper(dbg,&val,
+        readfrom,len,readfrom+len,&lerr);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,lerr);
+        return 0;
+    }
+    return val;
+}
+
+/*  .debug_addr and .debug_str_offsets DWARF5 tables
+    share a header shape: an initial length, a
+    2 byte version (5) and two more bytes, followed
+    by the array that DW_AT_addr_base or
+    DW_AT_str_offsets_base points at.
+    Given such a base, find the header that
+    must precede it and return the section offset
+    one past the end of that table and the offset
+    size (4 or 8) the header was written with.
+    Returns DW_DLV_NO_ENTRY if no valid header
+    precedes base (DWARF4 GNU extension arrays
+    have none). Never returns DW_DLV_ERROR. */
+int
+_dwarf_find_dw5_table_end(Dwarf_Debug dbg,
+    struct Dwarf_Section_s *sec,
+    Dwarf_Unsigned base,
+    Dwarf_Unsigned *table_end_out,
+    Dwarf_Unsigned *offset_size_out)
+{
+    Dwarf_Small   *data = sec->dss_data;
+    Dwarf_Unsigned size = sec->dss_size;
+    Dwarf_Unsigned length = 0;
+    Dwarf_Unsigned end = 0;
+
+    if (!data || base < 8 || base > size) {
+        return DW_DLV_NO_ENTRY;
+    }
+    if (read_checked_value(dbg,data+base-4,
+        DWARF_HALF_SIZE) != DW_CU_VERSION5) {
+        return DW_DLV_NO_ENTRY;
+    }
+    /*  Try the 64bit offset header first. Its length
+        spans base-12 to base-4, and the four bytes at
+        base-8 alone are half of it: in a big-endian
+        object the low half, which can pass for a
+        32bit length. */
+    if (base >= 16 && read_checked_value(dbg,data+base-16,
+        DWARF_32BIT_SIZE) == DISTINGUISHED_VALUE) {
+        length = read_checked_value(dbg,data+base-12,
+            DWARF_64BIT_SIZE);
+        end = base - 4 + length;
+        if (length >= 4 && end >= length && end <= size) {
+            *table_end_out = end;
+            if (offset_size_out) {
+                *offset_size_out = DWARF_64BIT_SIZE;
+            }
+            return DW_DLV_OK;
+        }
+    }
+    length = read_checked_value(dbg,data+base-8,
+        DWARF_32BIT_SIZE);
+    end = base - 4 + length;
+    if (length < 4 || length >= 0xfffffff0 || end > size) {
+        return DW_DLV_NO_ENTRY;
+    }
+    *table_end_out = end;
+    if (offset_size_out) {
+        *offset_size_out = DWARF_32BIT_SIZE;
+    }
+    return DW_DLV_OK;
+}
+
+/*  Converts count entries of entrysize bytes at
+    data to host byte order. Returns a malloc
+    array the caller frees, or NULL on allocation
+    failure. The caller guarantees the entries lie
+    within the section. */
+Dwarf_Unsigned *
+_dwarf_make_native_table(Dwarf_Debug dbg,
+    Dwarf_Small *data,
+    Dwarf_Unsigned entrysize,
+    Dwarf_Unsigned count)
+{
+    Dwarf_Unsigned *table = 0;
+    Dwarf_Unsigned  i = 0;
+
+    if (!count || count > (Dwarf_Unsigned)(size_t)-1/
+        sizeof(Dwarf_Unsigned)) {
+        return NULL;
+    }
+    table = (Dwarf_Unsigned *)malloc((size_t)count*
+        sizeof(Dwarf_Unsigned));
+    if (!table) {
+        return NULL;
+    }
+    for (i = 0; i < count; ++i,data += entrysize) {
+        table[i] = read_checked_value(dbg,data,(int)entrysize);
+    }
+    return table;
+}
+
 int
 _dwarf_read_area_length_ck_wrapper(Dwarf_Debug dbg,
     Dwarf_Unsigned *out_value,
@@ -477,6 +477,17 @@ _dwarf_read_unaligned_ck_wrapper(Dwarf_Debug dbg,
     Dwarf_Small *end_arange,
     Dwarf_Error *err);
 int
+_dwarf_find_dw5_table_end(Dwarf_Debug dbg,
+    struct Dwarf_Section_s *sec,
+    Dwarf_Unsigned base,
+    Dwarf_Unsigned *table_end_out,
+    Dwarf_Unsigned *offset_size_out);
+Dwarf_Unsigned *
+_dwarf_make_native_table(Dwarf_Debug dbg,
+    Dwarf_Small *data,
+    Dwarf_Unsigned entrysize,
+    Dwarf_Unsigned count);
+int
 _dwarf_read_area_length_ck_wrapper(Dwarf_Debug dbg,
     Dwarf_Unsigned *out_value,
     Dwarf_Small **readfrom,
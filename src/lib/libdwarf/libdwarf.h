@@ -758,6 +758,150 @@ struct Dwarf_Debug_Fission_Per_CU_s  {
 */
 typedef struct Dwarf_Rnglists_Head_s * Dwarf_Rnglists_Head;
 
+/*! @typedef Dwarf_Expr_Program
+    A DWARF expression compiled once into a compact
+    internal form so it can be evaluated any number of
+    times without further allocation.
+    @see dwarf_expr_compile
+*/
+typedef struct Dwarf_Expr_Program_s * Dwarf_Expr_Program;
+
+/*! @typedef Dwarf_Expr_Callbacks
+    Caller-supplied access to the machine state
+    an expression needs when evaluated.
+    Each function returns DW_DLV_OK when the value
+    was returned, DW_DLV_NO_ENTRY when the value is
+    not available (evaluation then returns
+    DW_DLV_NO_ENTRY) or DW_DLV_ERROR.
+    Any pointer may be left null if the expressions
+    evaluated never need it.
+    ec_read_memory reads dw_size bytes (1 through 8)
+    at dw_addr and returns them as an unsigned value.
+*/
+typedef struct Dwarf_Expr_Callbacks_s {
+    void * ec_user_data;
+    int (*ec_read_register)(void * /*dw_user_data*/,
+        Dwarf_Unsigned   /*dw_regnum*/,
+        Dwarf_Unsigned * /*dw_value_out*/);
+    int (*ec_read_memory)(void * /*dw_user_data*/,
+        Dwarf_Addr       /*dw_addr*/,
+        Dwarf_Small      /*dw_size*/,
+        Dwarf_Unsigned * /*dw_value_out*/);
+    int (*ec_frame_base)(void * /*dw_user_data*/,
+        Dwarf_Addr * /*dw_frame_base_out*/);
+    int (*ec_call_frame_cfa)(void * /*dw_user_data*/,
+        Dwarf_Addr * /*dw_cfa_out*/);
+    int (*ec_tls_address)(void * /*dw_user_data*/,
+        Dwarf_Unsigned /*dw_tls_offset*/,
+        Dwarf_Addr *   /*dw_addr_out*/);
+    int (*ec_object_address)(void * /*dw_user_data*/,
+        Dwarf_Addr * /*dw_addr_out*/);
+} Dwarf_Expr_Callbacks;
+
+/*! @typedef Dwarf_Expr_Result
+    The outcome of evaluating a Dwarf_Expr_Program.
+    er_kind is one of the DW_EXPR_RESULT_* values.
+    For DW_EXPR_RESULT_memory er_value is the address
+    of the object.
+    For DW_EXPR_RESULT_register er_value is the
+    DWARF register number holding the object.
+    For DW_EXPR_RESULT_value er_value is the value
+    of the object itself (DW_OP_stack_value).
+    For DW_EXPR_RESULT_implicit er_block points to
+    er_value bytes (DW_OP_implicit_value)
+    in section memory.
+*/
+#define DW_EXPR_RESULT_memory   1
+#define DW_EXPR_RESULT_register 2
+#define DW_EXPR_RESULT_value    3
+#define DW_EXPR_RESULT_implicit 4
+typedef struct Dwarf_Expr_Result_s {
+    Dwarf_Small    er_kind;
+    Dwarf_Unsigned er_value;
+    Dwarf_Ptr      er_block;
+} Dwarf_Expr_Result;
+
+/*! @typedef Dwarf_Loclist_Cursor
+    Caller-owned state for walking a location list
+    one entry at a time straight from section memory.
+    Initialize with dwarf_loclist_cursor_init().
+    The fields are private to libdwarf and
+    nothing in the cursor needs to be freed.
+*/
+typedef struct Dwarf_Loclist_Cursor_s {
+    Dwarf_Unsigned    lcu_magic;
+    Dwarf_Debug       lcu_dbg;
+    struct Dwarf_CU_Context_s *lcu_context;
+    Dwarf_Small     * lcu_next;
+    Dwarf_Small     * lcu_section_start;
+    Dwarf_Small     * lcu_end;
+    Dwarf_Addr        lcu_base_address;
+    Dwarf_Unsigned    lcu_expr_len;
+    Dwarf_Half        lcu_kind;
+    Dwarf_Half        lcu_address_size;
+    Dwarf_Bool        lcu_base_address_valid;
+    Dwarf_Bool        lcu_done;
+} Dwarf_Loclist_Cursor;
+
+/*! @typedef Dwarf_Pc_Range
+    One half-open code address range,
+    pr_lowpc <= pc < pr_highpc.
+    @see dwarf_die_ranges
+*/
+typedef struct Dwarf_Pc_Range_s {
+    Dwarf_Addr pr_lowpc;
+    Dwarf_Addr pr_highpc;
+} Dwarf_Pc_Range;
+
+/*! @typedef Dwarf_Attr_Value
+    One attribute of a DIE as decoded by
+    dwarf_die_decode_attrs().
+    av_form is the final form (after any
+    DW_FORM_indirect) and av_formclass is
+    as from dwarf_get_form_class().
+
+    The decoded value, by form class:
+    ADDRESS: av_unsigned is the address.
+    CONSTANT: av_unsigned and av_signed both hold the
+    value, read per the form as dwarf_formudata() or
+    dwarf_formsdata() would (DW_FORM_data16: see av_data).
+    FLAG: av_unsigned is 0 or 1.
+    REFERENCE: av_unsigned is the global section offset
+    of the target DIE and av_is_info says whether
+    it is in .debug_info (DW_FORM_ref_sig8 is not
+    looked up: the 8 signature bytes are at av_data).
+    STRING: av_string points to the string.
+    BLOCK and EXPRLOC: av_data and av_data_len
+    are the block contents (without length prefix).
+    Section offset classes: av_unsigned is the offset.
+
+    If av_is_index is TRUE av_unsigned is an index,
+    not a resolved value: always so for
+    DW_FORM_loclistx and DW_FORM_rnglistx, and for
+    indexed addresses when .debug_addr is not
+    available (a .dwo without its tied executable).
+    Except for DW_FORM_implicit_const av_data points at
+    the value bytes in the section, which remain
+    valid until dwarf_finish().
+    av_size is the number of bytes the attribute takes
+    in the DIE, counting a DW_FORM_indirect form code
+    (zero for DW_FORM_implicit_const and
+    DW_FORM_flag_present).
+*/
+typedef struct Dwarf_Attr_Value_s {
+    Dwarf_Half     av_attrnum;
+    Dwarf_Half     av_form;
+    enum Dwarf_Form_Class av_formclass;
+    Dwarf_Bool     av_is_index;
+    Dwarf_Bool     av_is_info;
+    Dwarf_Unsigned av_unsigned;
+    Dwarf_Signed   av_signed;
+    const char    *av_string;
+    Dwarf_Small   *av_data;
+    Dwarf_Unsigned av_data_len;
+    Dwarf_Unsigned av_size;
+} Dwarf_Attr_Value;
+
 /*! @} endgroup allstructs */
 
 /*! @defgroup framedefines Default stack frame #defines
@@ -862,6 +1006,8 @@ typedef struct Dwarf_Rnglists_Head_s * Dwarf_Rnglists_Head;
 #define DW_DLA_STR_OFFSETS     0x40
 /* struct Dwarf_Debug_Addr_Table_s */
 #define DW_DLA_DEBUG_ADDR      0x41
+/* struct Dwarf_Expr_Program_s */
+#define DW_DLA_EXPR_PROGRAM    0x42
 /*! @} */
 
 /*! @defgroup dwdle DW_DLE Dwarf_Error numbers
@@ -1370,9 +1516,13 @@ typedef struct Dwarf_Rnglists_Head_s * Dwarf_Rnglists_Head;
 #define DW_DLE_SYMBOL_SECTION_SIZE_ERROR       490
 #define DW_DLE_PE_SECTION_SIZE_ERROR           491
 #define DW_DLE_DEBUG_ADDR_ERROR                492
+#define DW_DLE_EXPRESSION_ERROR                493
+#define DW_DLE_PRO_STREAM_ERROR                494
+#define DW_DLE_PRO_COMPRESS_ERROR              495
+#define DW_DLE_PRO_COMPRESS_UNSUPPORTED        496
 
 /*! @note DW_DLE_LAST MUST EQUAL LAST ERROR NUMBER */
-#define DW_DLE_LAST        492
+#define DW_DLE_LAST        496
 #define DW_DLE_LO_USER     0x10000
 /*! @} */
 
@@ -2528,6 +2678,42 @@ DW_API int dwarf_attrlist(Dwarf_Die dw_die,
     Dwarf_Signed * dw_attrcount,
     Dwarf_Error*   dw_error);
 
+/*! @brief Decodes all the attributes of a DIE at once
+
+    A single walk of the DIE's abbreviation decodes
+    every attribute value into a caller-provided array.
+    Nothing is allocated (barring errors), so
+    a reader visiting every attribute of every
+    DIE can avoid the Dwarf_Attribute list of
+    dwarf_attrlist() and the per-value form calls.
+
+    @param dw_die
+    The DIE from which to decode attributes.
+    @param dw_values
+    An array of dw_values_len Dwarf_Attr_Value
+    records, filled in abbreviation order.
+    @param dw_values_len
+    The number of records in dw_values.
+    @param dw_attrcount
+    On success set to the number of attributes
+    the DIE has. If that exceeds dw_values_len
+    only the first dw_values_len were decoded;
+    call again with a larger array to see the rest.
+    @param dw_error
+    A place to return error details.
+    @return
+    DW_DLV_OK. DW_DLV_NO_ENTRY if the DIE has no
+    attributes. DW_DLV_ERROR if the DIE or any value
+    decoded is corrupt.
+    @see Dwarf_Attr_Value
+    @see exampledecodeattrs
+*/
+DW_API int dwarf_die_decode_attrs(Dwarf_Die dw_die,
+    Dwarf_Attr_Value * dw_values,
+    Dwarf_Unsigned     dw_values_len,
+    Dwarf_Unsigned   * dw_attrcount,
+    Dwarf_Error      * dw_error);
+
 /*! @brief Sets TRUE of a Dwarf_Attribute has the indicated FORM
     @param dw_attr
     The Dwarf_Attribute of interest.
@@ -3878,6 +4064,66 @@ DW_API int dwarf_get_ranges_b(Dwarf_Debug dw_dbg,
 DW_API void dwarf_dealloc_ranges(Dwarf_Debug dw_dbg,
     Dwarf_Ranges * dw_rangesbuf,
     Dwarf_Signed   dw_rangecount);
+
+/*! @brief The code addresses of a DIE as sorted ranges
+
+    Works for any DIE with DW_AT_low_pc/DW_AT_high_pc
+    or DW_AT_ranges, in any DWARF version.
+    Base address entries, DW_RLE_base_addressx,
+    DW_AT_rnglists_base and DW_AT_addr_base are
+    all applied, then the ranges are sorted and
+    overlapping or adjacent ranges are merged.
+    Empty ranges and entries whose address could not
+    be computed (missing .debug_addr for example)
+    are dropped. A DIE with DW_AT_low_pc but no
+    DW_AT_high_pc has no ranges.
+
+    The result is cached in the Dwarf_Debug
+    (DIEs sharing a range list share the array),
+    so calling this repeatedly is cheap.
+    The array belongs to libdwarf: do not free it.
+    It remains valid until dwarf_finish().
+
+    @param dw_die
+    The DIE of interest.
+    @param dw_ranges_out
+    On success returns a pointer to the array.
+    @param dw_range_count_out
+    On success returns the number of entries in
+    the array, which may be zero.
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK, DW_DLV_NO_ENTRY if the DIE has
+    neither DW_AT_low_pc nor DW_AT_ranges,
+    or DW_DLV_ERROR.
+*/
+DW_API int dwarf_die_ranges(Dwarf_Die dw_die,
+    Dwarf_Pc_Range ** dw_ranges_out,
+    Dwarf_Unsigned  * dw_range_count_out,
+    Dwarf_Error     * dw_error);
+
+/*! @brief Test if a DIE's code addresses include a pc
+
+    Uses dwarf_die_ranges() and a binary search.
+
+    @param dw_die
+    The DIE of interest.
+    @param dw_pc
+    The address to test.
+    @param dw_contains_out
+    On success set TRUE if dw_pc is within the
+    ranges of the DIE, else FALSE.
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK, DW_DLV_NO_ENTRY if the DIE has
+    no code addresses, or DW_DLV_ERROR.
+*/
+DW_API int dwarf_die_pc_in_ranges(Dwarf_Die dw_die,
+    Dwarf_Addr   dw_pc,
+    Dwarf_Bool * dw_contains_out,
+    Dwarf_Error* dw_error);
 /*! @} */
 
 /*! @defgroup rnglists Rnglists: code addresses in DWARF5
@@ -4496,6 +4742,243 @@ DW_API int dwarf_get_loclist_lle( Dwarf_Debug dw_dbg,
     Dwarf_Unsigned * dw_expr_ops_offset,
     Dwarf_Small   ** dw_expr_opsdata,
     Dwarf_Error    * dw_error);
+
+/*! @brief Compile a DWARF expression for repeated evaluation
+
+    The expression is decoded once. Constant
+    sub-expressions are folded and DW_OP_addrx,
+    DW_OP_constx (and their GNU equivalents)
+    are resolved against .debug_addr
+    so that dwarf_expr_evaluate() does no
+    decoding and no allocation.
+
+    Expressions that describe composite locations
+    (DW_OP_piece, DW_OP_bit_piece) or that use
+    typed-stack, call, entry-value or implicit-pointer
+    operators are not compiled: for those
+    DW_DLV_NO_ENTRY is returned and the caller
+    should fall back to dwarf_get_location_op_value_c().
+
+    @see example_exprprogram
+
+    @param dw_die
+    Any DIE in the CU the expression belongs to.
+    Provides address size, offset size, version
+    and DW_AT_addr_base.
+    @param dw_expr_bytes
+    Pointer to the expression bytes, for example
+    as returned by dwarf_formexprloc().
+    @param dw_expr_len
+    Length in bytes of the expression.
+    @param dw_program_out
+    On success returns the compiled program.
+    Free with dwarf_dealloc_expr_program().
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK, DW_DLV_NO_ENTRY if the expression
+    uses operators the evaluator does not support,
+    or DW_DLV_ERROR.
+*/
+DW_API int dwarf_expr_compile(Dwarf_Die dw_die,
+    Dwarf_Ptr            dw_expr_bytes,
+    Dwarf_Unsigned       dw_expr_len,
+    Dwarf_Expr_Program * dw_program_out,
+    Dwarf_Error        * dw_error);
+
+/*! @brief Compile the expression of a location description
+
+    Identical to dwarf_expr_compile() but takes the
+    already-decoded operators of one entry
+    of a Dwarf_Loc_Head_c.
+
+    @param dw_locdesc
+    A location description as returned by
+    dwarf_get_locdesc_entry_d().
+    @param dw_program_out
+    On success returns the compiled program.
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK, DW_DLV_NO_ENTRY or DW_DLV_ERROR
+    as for dwarf_expr_compile().
+*/
+DW_API int dwarf_expr_compile_locdesc(Dwarf_Locdesc_c dw_locdesc,
+    Dwarf_Expr_Program * dw_program_out,
+    Dwarf_Error        * dw_error);
+
+/*! @brief Evaluate a compiled expression
+
+    Runs the program against the caller's machine
+    state. Nothing is allocated unless an error
+    is returned.
+
+    @param dw_program
+    The compiled program.
+    @param dw_callbacks
+    Register, memory and frame access. May be null
+    if the program needs none of them.
+    @param dw_push_initial
+    If non-zero dw_initial_value is pushed on the
+    stack before evaluation starts (as required for
+    DW_AT_data_member_location and similar).
+    @param dw_initial_value
+    The value pushed if dw_push_initial is non-zero.
+    @param dw_result
+    On success the result is returned through the pointer.
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK.
+    Returns DW_DLV_NO_ENTRY if a callback reported
+    a value unavailable or the expression is empty
+    (the object is optimized out).
+    Returns DW_DLV_ERROR on a malformed expression
+    (stack underflow, division by zero and so on).
+*/
+DW_API int dwarf_expr_evaluate(Dwarf_Expr_Program dw_program,
+    Dwarf_Expr_Callbacks * dw_callbacks,
+    Dwarf_Bool             dw_push_initial,
+    Dwarf_Unsigned         dw_initial_value,
+    Dwarf_Expr_Result    * dw_result,
+    Dwarf_Error          * dw_error);
+
+/*! @brief Return size details of a compiled expression
+
+    @param dw_program
+    The compiled program.
+    @param dw_source_op_count
+    On success returns the number of DW_OP operators
+    in the original expression.
+    @param dw_instruction_count
+    On success returns the number of internal
+    instructions after constant folding.
+    @return
+    Returns DW_DLV_OK or DW_DLV_NO_ENTRY if dw_program
+    is not a valid program.
+*/
+DW_API int dwarf_expr_program_sizes(Dwarf_Expr_Program dw_program,
+    Dwarf_Unsigned * dw_source_op_count,
+    Dwarf_Unsigned * dw_instruction_count);
+
+/*! @brief Dealloc a compiled expression
+
+    @param dw_program
+    The program to free. Stale on return.
+*/
+DW_API void dwarf_dealloc_expr_program(
+    Dwarf_Expr_Program dw_program);
+
+/*! @brief Start an allocation-free walk of a location list
+
+    Works for every location form: DWARF2-4 .debug_loc,
+    the GNU DWARF4 .dwo lists, DWARF5 .debug_loclists
+    and a single location expression (which is
+    returned as one entry covering all addresses).
+    Unlike dwarf_get_loclist_c() nothing is allocated
+    and no operators are decoded.
+
+    @see example_loclistcursor
+
+    @param dw_attr
+    A location attribute such as DW_AT_location
+    or DW_AT_frame_base.
+    @param dw_cursor
+    Pass in a pointer to caller storage, which
+    is initialized here.
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK, DW_DLV_NO_ENTRY if the section
+    the list refers to is absent, or DW_DLV_ERROR.
+*/
+DW_API int dwarf_loclist_cursor_init(Dwarf_Attribute dw_attr,
+    Dwarf_Loclist_Cursor * dw_cursor,
+    Dwarf_Error          * dw_error);
+
+/*! @brief Return the next location entry of a cursor
+
+    Base address entries are applied to the cursor
+    and not returned, so every entry returned has
+    a location expression.
+    The address range returned is
+    dw_lowpc <= pc < dw_highpc.
+
+    @param dw_cursor
+    A cursor set up by dwarf_loclist_cursor_init().
+    @param dw_lle_value_out
+    On success returns the DW_LLE (or for GNU
+    .dwo lists the DW_LLEX) code of the entry,
+    synthesized for DWARF2-4 as
+    dwarf_get_locdesc_entry_d() does.
+    @param dw_lowpc_out
+    On success returns the first address covered,
+    with any base address applied.
+    @param dw_highpc_out
+    On success returns one past the last address
+    covered.
+    @param dw_debug_addr_unavailable
+    On success set TRUE if the addresses could not
+    be computed (missing .debug_addr or base address)
+    in which case dw_lowpc_out and dw_highpc_out are zero.
+    @param dw_expr_bytes_out
+    On success points to the expression bytes in
+    section memory. Suitable for dwarf_expr_compile().
+    @param dw_expr_len_out
+    On success returns the length of the expression.
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK, DW_DLV_NO_ENTRY at the end of
+    the list, or DW_DLV_ERROR.
+*/
+DW_API int dwarf_loclist_cursor_next(
+    Dwarf_Loclist_Cursor * dw_cursor,
+    Dwarf_Small          * dw_lle_value_out,
+    Dwarf_Addr           * dw_lowpc_out,
+    Dwarf_Addr           * dw_highpc_out,
+    Dwarf_Bool           * dw_debug_addr_unavailable,
+    Dwarf_Ptr            * dw_expr_bytes_out,
+    Dwarf_Unsigned       * dw_expr_len_out,
+    Dwarf_Error          * dw_error);
+
+/*! @brief Find the location expression in effect at a pc
+
+    Walks the location list with a Dwarf_Loclist_Cursor
+    and stops at the first entry covering dw_pc.
+    If no bounded entry covers dw_pc a DWARF5
+    DW_LLE_default_location entry, if any, is returned
+    (with dw_lowpc_out and dw_highpc_out set to zero).
+    Nothing is allocated.
+
+    @param dw_attr
+    A location attribute.
+    @param dw_pc
+    The address of interest.
+    @param dw_lowpc_out
+    On success returns the first address
+    of the matching entry.
+    @param dw_highpc_out
+    On success returns one past the last address
+    of the matching entry.
+    @param dw_expr_bytes_out
+    On success points to the expression bytes.
+    @param dw_expr_len_out
+    On success returns the length of the expression.
+    @param dw_error
+    The usual error detail return pointer.
+    @return
+    Returns DW_DLV_OK, DW_DLV_NO_ENTRY if no entry covers
+    dw_pc (the object has no location there),
+    or DW_DLV_ERROR.
+*/
+DW_API int dwarf_loclist_at_pc(Dwarf_Attribute dw_attr,
+    Dwarf_Addr       dw_pc,
+    Dwarf_Addr     * dw_lowpc_out,
+    Dwarf_Addr     * dw_highpc_out,
+    Dwarf_Ptr      * dw_expr_bytes_out,
+    Dwarf_Unsigned * dw_expr_len_out,
+    Dwarf_Error    * dw_error);
 /*! @} */
 
 /*! @defgroup debugaddr .debug_addr access:  DWARF5
@@ -8473,6 +8956,45 @@ DW_API int dwarf_get_section_max_offsets_d(Dwarf_Debug dw_dbg,
     Dwarf_Unsigned * dw_debug_names_size,
     Dwarf_Unsigned * dw_debug_loclists_size,
     Dwarf_Unsigned * dw_debug_rnglists_size);
+
+/*! @brief Get what loading a DWARF section cost so far
+
+    libdwarf reads each DWARF section the first time
+    it is needed. This reports, for one of the DWARF
+    sections libdwarf knows in the object, what
+    that load did, so a tool can tell where the
+    input work went.
+
+    @param dw_dbg
+    Pass in the Dwarf_Debug of interest.
+    @param dw_section_index
+    Pass in 0 and then 1, 2, ... until DW_DLV_NO_ENTRY
+    is returned. This is not an object file section
+    number.
+    @param dw_section_name
+    On success returns the section name as it
+    appears in the object file.
+    @param dw_bytes_read
+    On success returns the bytes read from the object,
+    zero if the section was never loaded.
+    @param dw_bytes_decompressed
+    On success returns the section size after
+    decompression, zero if it was not compressed
+    (or not loaded).
+    @param dw_reloc_bytes
+    On success returns the size of the relocation
+    records applied to the section, zero if none were.
+    @return
+    Returns DW_DLV_OK, or DW_DLV_NO_ENTRY if
+    dw_section_index is past the last section
+    or dw_dbg is not valid.
+*/
+DW_API int dwarf_get_section_load_stats(Dwarf_Debug dw_dbg,
+    unsigned          dw_section_index,
+    const char **     dw_section_name,
+    Dwarf_Unsigned *  dw_bytes_read,
+    Dwarf_Unsigned *  dw_bytes_decompressed,
+    Dwarf_Unsigned *  dw_reloc_bytes);
 /*! @} */
 
 /*! @defgroup secgroups Section Groups Objectfile Data
@@ -8642,6 +9164,34 @@ DW_API int dwarf_set_stringcheck(int dw_stringcheck);
 */
 DW_API int dwarf_set_reloc_application(int dw_apply);
 
+/*! @brief Restrict the DWARF sections libdwarf reads
+
+    By default every DWARF section in an object
+    is available. A client that knows it needs only
+    a few (for example just .eh_frame) can pin
+    that set before opening the object so the other
+    DWARF sections are neither read, decompressed
+    nor relocated, and their relocations are not
+    loaded either.
+    It applies to all Dwarf_Debug opened later
+    in this library instance.
+
+    A DWARF section left out reads as if
+    it were present but empty: its size is zero
+    and its contents are never returned.
+    A .zdebug_ section is matched by its .debug_ name.
+    Sections that are not DWARF sections,
+    such as .gnu_debuglink, are not affected.
+
+    @param dw_section_names
+    A null-terminated array of standard section
+    names, for example ".debug_frame" or
+    ".debug_info.dwo". The array is not copied
+    and must remain valid while objects are opened.
+    Pass in NULL to make every section available again.
+*/
+DW_API void dwarf_set_section_filter(const char **dw_section_names);
+
 /*  dwarf_get_endian_copy_function new. December 2019. */
 DW_API void (*dwarf_get_endian_copy_function(Dwarf_Debug /*dbg*/))
     (void *, const void * /*src*/, unsigned long /*srclen*/);
@@ -8686,6 +9236,39 @@ DW_API void dwarf_record_cmdline_options(
 */
 DW_API int dwarf_set_de_alloc_flag(int dw_v);
 
+/*! @brief Get the allocation counts of one DW_DLA type
+
+    Every Dwarf_Debug counts the objects libdwarf
+    allocates for it by DW_DLA type
+    (DW_DLA_DIE, DW_DLA_ATTR, ...) and how many of
+    those were deallocated, whether by the caller
+    or by libdwarf itself.
+
+    @param dw_dbg
+    Pass in the Dwarf_Debug of interest.
+    @param dw_alloc_type
+    Pass in a DW_DLA value. Any value from 1 up to
+    the first returning DW_DLV_NO_ENTRY is valid;
+    unused values have zero counts.
+    @param dw_alloc_count
+    On success returns the number of allocations.
+    @param dw_alloc_bytes
+    On success returns the bytes those allocations
+    requested from malloc, including libdwarf's
+    bookkeeping.
+    @param dw_dealloc_count
+    On success returns the number of those freed.
+    @return
+    Returns DW_DLV_OK, or DW_DLV_NO_ENTRY if
+    dw_alloc_type is out of range or dw_dbg
+    is not valid.
+*/
+DW_API int dwarf_get_alloc_stats(Dwarf_Debug dw_dbg,
+    unsigned          dw_alloc_type,
+    Dwarf_Unsigned *  dw_alloc_count,
+    Dwarf_Unsigned *  dw_alloc_bytes,
+    Dwarf_Unsigned *  dw_dealloc_count);
+
 /*! @brief Set the address size on a Dwarf_Debug
 
     DWARF information CUs and other
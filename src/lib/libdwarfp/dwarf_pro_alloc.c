@@ -42,39 +42,68 @@
 #include "dwarf_pro_incl.h"
 #include "dwarf_pro_opaque.h"
 #include "dwarf_pro_alloc.h"
-#include "dwarf_tsearch.h"
-
-/*  When each block is allocated, there is a two-word structure
-    allocated at the beginning so the block can go on a list.
-    The address returned is the address *after* the two pointers
-    at the start.  But this allows us to be given a pointer to
-    a generic block, and go backwards to find the list-node.  Then
-    we can remove this block from it's list without the need to search
-    through a linked list in order to remove the node.  It also allows
-    us to 'delete' a memory block without needing the dbg structure.
-    We still need the dbg structure on allocation so
-    that we know which
-    linked list to add the block to.
-
-    Only the allocation of the dbg structure itself cannot use
-    _dwarf_p_get_alloc.
-    That structure should be set up by hand, and the two list
-    pointers should be initialized to point at the node itself.
-    That initializes
-    the doubly linked list.  */
+#include "dwarf_pro_section.h"
 
+/*  Small objects (up to PRO_ARENA_MAX_OBJECT bytes) are carved
+    from large arena blocks, each preceded only by a one-word
+    header holding its rounded size.  When such an object is
+    passed to _dwarf_p_dealloc() it goes on a free list for
+    its size class in the dbg and is handed out again by a
+    later _dwarf_p_get_alloc() of the same class, so code that
+    frees as it goes (the per-CU streaming transform, for
+    example) does not grow the arena without bound.
+
+    Larger objects, and the arena blocks themselves, are
+    malloc()ed individually with a two-pointer list node in
+    front of the header (whose size word is then zero) and put
+    on a doubly linked list headed by the dbg allocation.
+    _dwarf_p_dealloc() of a large object unlinks and frees it
+    at once.  _dwarf_p_dealloc_all() frees the list, which
+    costs time proportional to the number of blocks and large
+    objects rather than to the number of objects allocated.
+
+    Only the allocation of the dbg structure itself (dbg NULL)
+    starts a new list: the list pointers are initialized to
+    point at the node itself. */
+
+typedef struct Dwarf_P_Arena_Header_s {
+    Dwarf_Unsigned ah_size;  /* 0 for individually malloc()ed */
+} arena_header_t;
+
+struct Dwarf_P_Arena_Free_s {
+    struct Dwarf_P_Arena_Free_s *af_next;
+};
+
+#define HEADER_SIZE  sizeof(arena_header_t)
 #define LIST_TO_BLOCK(lst) \
-    ((void*) (((char *)lst) + sizeof(memory_list_t)))
+    ((void*) (((char *)lst) + sizeof(memory_list_t) + HEADER_SIZE))
 #define BLOCK_TO_LIST(blk) \
-    ((memory_list_t*) (((char*)blk) - sizeof(memory_list_t)))
+    ((memory_list_t*) (((char*)blk) - HEADER_SIZE - \
+    sizeof(memory_list_t)))
+#define BLOCK_TO_HEADER(blk) \
+    ((arena_header_t*) (((char*)blk) - HEADER_SIZE))
 
-/*
-  dbg should be NULL only when allocating dbg itself.  In that
-  case we initialize it to an empty circular doubly-linked list.
-*/
+/*  Only while a worker thread of a parallel transform
+    runs can two threads allocate from one dbg. */
+#ifdef HAVE_PTHREAD_H
+#define LOCK_ALLOC(dbg) \
+    { if ((dbg)->de_par_active) { \
+        pthread_mutex_lock(&(dbg)->de_alloc_lock); } }
+#define UNLOCK_ALLOC(dbg) \
+    { if ((dbg)->de_par_active) { \
+        pthread_mutex_unlock(&(dbg)->de_alloc_lock); } }
+#else /* !HAVE_PTHREAD_H */
+#define LOCK_ALLOC(dbg)
+#define UNLOCK_ALLOC(dbg)
+#endif /* HAVE_PTHREAD_H */
 
-Dwarf_Ptr
-_dwarf_p_get_alloc(Dwarf_P_Debug dbg, Dwarf_Unsigned size)
+/*  Allocate size bytes (plus list node and header) with
+    malloc and link them on the dbg list.
+    dbg should be NULL only when allocating dbg itself.  In that
+    case we initialize it to an empty circular doubly-linked list.
+*/
+static void *
+get_alloc_large(Dwarf_P_Debug dbg, Dwarf_Unsigned size)
 {
     void *sp;
     memory_list_t *lp = NULL;
@@ -83,13 +112,15 @@ _dwarf_p_get_alloc(Dwarf_P_Debug dbg, Dwarf_Unsigned size)
 
     /*  Alloc control struct and data block together
         for performance reasons */
-    lp = (memory_list_t *) malloc(size + sizeof(memory_list_t));
+    lp = (memory_list_t *) malloc(size + sizeof(memory_list_t) +
+        HEADER_SIZE);
     if (lp == NULL) {
         /* should throw an error */
         return NULL;
     }
-    /* point to 'size' bytes just beyond lp struct */
+    /* point to 'size' bytes just beyond lp struct and header */
     sp = LIST_TO_BLOCK(lp);
+    BLOCK_TO_HEADER(sp)->ah_size = 0;
     memset(sp, 0, size);
     if (dbg == NULL) {
         lp->next = lp->prev = lp;
@@ -108,14 +139,80 @@ _dwarf_p_get_alloc(Dwarf_P_Debug dbg, Dwarf_Unsigned size)
     return sp;
 }
 
-/*
-  The dbg structure is not needed here anymore.
-*/
-void
-_dwarf_p_dealloc(Dwarf_Small * ptr) /* ARGSUSED */
+static void *
+get_alloc_small(Dwarf_P_Debug dbg, Dwarf_Unsigned size)
+{
+    Dwarf_Unsigned rounded = 0;
+    unsigned sizeclass = 0;
+    struct Dwarf_P_Arena_Free_s *reuse = 0;
+    char *sp = 0;
+
+    rounded = (size + PRO_ARENA_ALIGN - 1) &
+        ~(Dwarf_Unsigned)(PRO_ARENA_ALIGN - 1);
+    if (!rounded) {
+        rounded = PRO_ARENA_ALIGN;
+    }
+    sizeclass = (unsigned)(rounded / PRO_ARENA_ALIGN);
+    reuse = dbg->de_arena_free[sizeclass];
+    if (reuse) {
+        dbg->de_arena_free[sizeclass] = reuse->af_next;
+        memset(reuse, 0, rounded);
+        return (void *)reuse;
+    }
+    if ((Dwarf_Unsigned)(dbg->de_arena_end - dbg->de_arena_next) <
+        rounded + HEADER_SIZE) {
+        /*  The unused tail of the old block is abandoned,
+            it is at most PRO_ARENA_MAX_OBJECT bytes. */
+        char *blk = (char *)get_alloc_large(dbg,
+            PRO_ARENA_BLOCK_SIZE);
+
+        if (!blk) {
+            return NULL;
+        }
+        dbg->de_arena_next = blk;
+        dbg->de_arena_end = blk + PRO_ARENA_BLOCK_SIZE;
+    }
+    /*  Blocks come zeroed from get_alloc_large(). */
+    sp = dbg->de_arena_next + HEADER_SIZE;
+    BLOCK_TO_HEADER(sp)->ah_size = rounded;
+    dbg->de_arena_next = sp + rounded;
+    return (void *)sp;
+}
+
+Dwarf_Ptr
+_dwarf_p_get_alloc(Dwarf_P_Debug dbg, Dwarf_Unsigned size)
+{
+    void *sp = 0;
+
+    if (dbg == NULL) {
+        return get_alloc_large(dbg,size);
+    }
+    LOCK_ALLOC(dbg);
+    if (size > PRO_ARENA_MAX_OBJECT) {
+        sp = get_alloc_large(dbg,size);
+    } else {
+        sp = get_alloc_small(dbg,size);
+    }
+    UNLOCK_ALLOC(dbg);
+    return (Dwarf_Ptr)sp;
+}
+
+static void
+dealloc_one(Dwarf_P_Debug dbg, Dwarf_Small * ptr)
 {
     memory_list_t *lp;
+    Dwarf_Unsigned size = 0;
+
+    size = BLOCK_TO_HEADER(ptr)->ah_size;
+    if (size) {
+        struct Dwarf_P_Arena_Free_s *fo =
+            (struct Dwarf_P_Arena_Free_s *)ptr;
+        unsigned sizeclass = (unsigned)(size / PRO_ARENA_ALIGN);
 
+        fo->af_next = dbg->de_arena_free[sizeclass];
+        dbg->de_arena_free[sizeclass] = fo;
+        return;
+    }
     lp = BLOCK_TO_LIST(ptr);
     /*  Remove from a doubly linked, circular list.
         Read carefully, use a white board if necessary.
@@ -144,10 +241,15 @@ _dwarf_p_dealloc(Dwarf_Small * ptr) /* ARGSUSED */
     free((void*)lp);
 }
 
-static void
-_dwarf_str_hashtab_freenode(void * nodep)
+void
+_dwarf_p_dealloc(Dwarf_P_Debug dbg, Dwarf_Small * ptr)
 {
-    free(nodep);
+    if (!ptr) {
+        return;
+    }
+    LOCK_ALLOC(dbg);
+    dealloc_one(dbg,ptr);
+    UNLOCK_ALLOC(dbg);
 }
 
 /*
@@ -166,18 +268,25 @@ _dwarf_p_dealloc_all(Dwarf_P_Debug dbg)
         return;
     }
 
+    /*  The string section data is malloc()ed. */
+    if (dbg->de_debug_str) {
+        free(dbg->de_debug_str->ds_data);
+    }
+    if (dbg->de_debug_line_str) {
+        free(dbg->de_debug_line_str->ds_data);
+    }
     base_dbglp = BLOCK_TO_LIST(dbg);
     dbglp = base_dbglp->next;
 
+    /*  Arena blocks and large objects.  Arena objects
+        go with their blocks. */
     while (dbglp != base_dbglp) {
         memory_list_t*next = dbglp->next;
 
-        _dwarf_p_dealloc( LIST_TO_BLOCK(dbglp));
+        free((void *)dbglp);
         dbglp = next;
     }
-    dwarf_tdestroy(dbg->de_debug_str_hashtab,
-        _dwarf_str_hashtab_freenode);
-    dwarf_tdestroy(dbg->de_debug_line_str_hashtab,
-        _dwarf_str_hashtab_freenode);
+    _dwarf_pro_free_str_intern(&dbg->de_debug_str_intern);
+    _dwarf_pro_free_str_intern(&dbg->de_debug_line_str_intern);
     free((void *)base_dbglp);
 }
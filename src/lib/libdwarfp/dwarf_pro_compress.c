@@ -0,0 +1,611 @@
+/*
+  Copyright (C) 2026 agent. All Rights Reserved.
+
+  This program is free software; you can redistribute it
+  and/or modify it under the terms of version 2.1 of the
+  GNU Lesser General Public License as published by the Free
+  Software Foundation.
+
+  This program is distributed in the hope that it would be
+  useful, but WITHOUT ANY WARRANTY; without even the implied
+  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+  Further, this software is distributed without any warranty
+  that it is free of the rightful claim of any third person
+  regarding infringement or the like.  Any license provided
+  herein, whether implied or otherwise, applies only to this
+  software file.  Patent licenses, if any, provided herein
+  do not apply to combinations of this program with other
+  software, or any other product whatsoever.
+
+  You should have received a copy of the GNU Lesser General
+  Public License along with this program; if not, write the
+  Free Software Foundation, Inc., 51 Franklin Street - Fifth
+  Floor, Boston MA 02110-1301, USA.
+
+*/
+
+/*  SHF_COMPRESSED output.  With the "compress_debug_sections"
+    producer_init extra every section created by
+    dwarf_transform_to_disk_form_a() is handed to the caller
+    as a single buffer: an Elf32_Chdr or Elf64_Chdr followed
+    by the zlib (ELFCOMPRESS_ZLIB) or zstd (ELFCOMPRESS_ZSTD)
+    compressed section bytes.
+
+    Relocation offsets, symbolic or stream, are not changed:
+    as with GNU as --compress-debug-sections they refer to the
+    uncompressed section contents, which is what linkers
+    apply them to.  The relocation sections themselves are
+    not compressed. */
+
+#include <config.h>
+
+#include <stddef.h> /* NULL size_t */
+#include <stdlib.h> /* free() malloc() qsort() */
+#include <string.h> /* memcpy() memset() */
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> /* sysconf() */
+#endif /* HAVE_UNISTD_H */
+#ifdef HAVE_ZLIB_H
+#include "zlib.h"
+#endif /* HAVE_ZLIB_H */
+#ifdef HAVE_ZSTD_H
+#include "zstd.h"
+#endif /* HAVE_ZSTD_H */
+
+#include "dwarf.h"
+#include "libdwarfp.h"
+#include "dwarf_pro_incl.h"
+#include "dwarf_pro_opaque.h"
+#include "dwarf_pro_error.h"
+#include "dwarf_pro_alloc.h"
+#include "dwarf_pro_section.h"
+
+#define ELF32_CHDR_SIZE 12
+#define ELF64_CHDR_SIZE 24
+
+/*  Fed to the compressor, and offered for its output,
+    at most this many bytes at a time, so sizes need not
+    fit in a uInt. */
+#define COMPRESS_MAX_FEED 0x40000000UL
+
+/*  One output section to compress. */
+struct compress_job_s {
+    Dwarf_P_Debug        cj_dbg;
+    int                  cj_elf_sect_no;
+    /*  First chunk of the section, 0 if it has none. */
+    Dwarf_P_Section_Data cj_first;
+    Dwarf_Unsigned       cj_size;
+    /*  malloc()ed: header then compressed bytes. */
+    unsigned char       *cj_out;
+    Dwarf_Unsigned       cj_outlen;
+    Dwarf_Bool           cj_failed;
+    /*  Compressing did not make the section smaller,
+        so its chunks are kept as they are. */
+    Dwarf_Bool           cj_raw;
+};
+
+static void
+write_chdr(Dwarf_P_Debug dbg, unsigned char *out,
+    unsigned hdrlen, Dwarf_Unsigned size)
+{
+    Dwarf_Unsigned type = dbg->de_compress_sections;
+    Dwarf_Unsigned align = 1;
+
+    memset(out,0,hdrlen);
+    if (hdrlen == ELF64_CHDR_SIZE) {
+        /* ch_type, ch_reserved, ch_size, ch_addralign */
+        WRITE_UNALIGNED(dbg,out,(const void *)&type,
+            sizeof(type),4);
+        WRITE_UNALIGNED(dbg,out+8,(const void *)&size,
+            sizeof(size),8);
+        WRITE_UNALIGNED(dbg,out+16,(const void *)&align,
+            sizeof(align),8);
+    } else {
+        /* ch_type, ch_size, ch_addralign */
+        WRITE_UNALIGNED(dbg,out,(const void *)&type,
+            sizeof(type),4);
+        WRITE_UNALIGNED(dbg,out+4,(const void *)&size,
+            sizeof(size),4);
+        WRITE_UNALIGNED(dbg,out+8,(const void *)&align,
+            sizeof(align),4);
+    }
+}
+
+#ifdef HAVE_ZLIB
+/*  Runs deflate() with flush until it has consumed all
+    input (Z_NO_FLUSH) or ended the stream (Z_FINISH),
+    offering the output buffer out[0,outcap) at most
+    COMPRESS_MAX_FEED bytes at a time, as avail_out
+    is only a uInt. *outlen is the output so far. */
+static Dwarf_Bool
+run_deflate(z_stream *zs, int flush, unsigned char *out,
+    Dwarf_Unsigned outcap, Dwarf_Unsigned *outlen)
+{
+    for (;;) {
+        Dwarf_Unsigned room = outcap - *outlen;
+        int zres = 0;
+
+        if (room > COMPRESS_MAX_FEED) {
+            room = COMPRESS_MAX_FEED;
+        }
+        zs->next_out = out + *outlen;
+        zs->avail_out = (uInt)room;
+        zres = deflate(zs,flush);
+        *outlen += room - zs->avail_out;
+        if (flush == Z_FINISH) {
+            if (zres == Z_STREAM_END) {
+                return TRUE;
+            }
+        } else if (!zs->avail_in) {
+            return TRUE;
+        }
+        if ((zres != Z_OK && zres != Z_BUF_ERROR) ||
+            *outlen == outcap) {
+            /*  deflateBound() room cannot run out. */
+            return FALSE;
+        }
+    }
+}
+
+static Dwarf_Bool
+compress_zlib(struct compress_job_s *cj, unsigned hdrlen)
+{
+    z_stream zs;
+    Dwarf_P_Section_Data cur = 0;
+    Dwarf_Unsigned bound = 0;
+    Dwarf_Unsigned outlen = 0;
+
+    if ((Dwarf_Unsigned)(uLong)cj->cj_size != cj->cj_size) {
+        return FALSE;
+    }
+    memset(&zs,0,sizeof(zs));
+    if (deflateInit(&zs,Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return FALSE;
+    }
+    bound = deflateBound(&zs,(uLong)cj->cj_size);
+    if ((Dwarf_Unsigned)(size_t)(hdrlen + bound) != hdrlen + bound) {
+        deflateEnd(&zs);
+        return FALSE;
+    }
+    cj->cj_out = (unsigned char *)malloc((size_t)(hdrlen + bound));
+    if (!cj->cj_out) {
+        deflateEnd(&zs);
+        return FALSE;
+    }
+    for (cur = cj->cj_first; cur; cur = cur->ds_next) {
+        unsigned long done = 0;
+
+        if (cur->ds_elf_sect_no != cj->cj_elf_sect_no) {
+            continue;
+        }
+        while (done < cur->ds_nbytes) {
+            unsigned long feed = cur->ds_nbytes - done;
+
+            if (feed > COMPRESS_MAX_FEED) {
+                feed = COMPRESS_MAX_FEED;
+            }
+            zs.next_in = (Bytef *)cur->ds_data + done;
+            zs.avail_in = (uInt)feed;
+            if (!run_deflate(&zs,Z_NO_FLUSH,cj->cj_out + hdrlen,
+                bound,&outlen)) {
+                deflateEnd(&zs);
+                return FALSE;
+            }
+            done += feed;
+        }
+    }
+    if (!run_deflate(&zs,Z_FINISH,cj->cj_out + hdrlen,bound,
+        &outlen)) {
+        deflateEnd(&zs);
+        return FALSE;
+    }
+    cj->cj_outlen = hdrlen + outlen;
+    deflateEnd(&zs);
+    return TRUE;
+}
+#endif /* HAVE_ZLIB */
+
+#ifdef HAVE_ZSTD
+static Dwarf_Bool
+compress_zstd(struct compress_job_s *cj, unsigned hdrlen)
+{
+    ZSTD_CCtx *cctx = 0;
+    ZSTD_inBuffer in;
+    ZSTD_outBuffer out;
+    Dwarf_P_Section_Data cur = 0;
+    size_t bound = 0;
+    size_t zres = 0;
+
+    if ((Dwarf_Unsigned)(size_t)cj->cj_size != cj->cj_size) {
+        return FALSE;
+    }
+    bound = ZSTD_compressBound((size_t)cj->cj_size);
+    cj->cj_out = (unsigned char *)malloc(hdrlen + bound);
+    if (!cj->cj_out) {
+        return FALSE;
+    }
+    cctx = ZSTD_createCCtx();
+    if (!cctx) {
+        return FALSE;
+    }
+    ZSTD_CCtx_setPledgedSrcSize(cctx,cj->cj_size);
+    out.dst = cj->cj_out + hdrlen;
+    out.size = bound;
+    out.pos = 0;
+    for (cur = cj->cj_first; cur; cur = cur->ds_next) {
+        if (cur->ds_elf_sect_no != cj->cj_elf_sect_no) {
+            continue;
+        }
+        in.src = cur->ds_data;
+        in.size = cur->ds_nbytes;
+        in.pos = 0;
+        while (in.pos < in.size) {
+            zres = ZSTD_compressStream2(cctx,&out,&in,
+                ZSTD_e_continue);
+            if (ZSTD_isError(zres) || out.pos == out.size) {
+                ZSTD_freeCCtx(cctx);
+                return FALSE;
+            }
+        }
+    }
+    in.src = 0;
+    in.size = 0;
+    in.pos = 0;
+    do {
+        zres = ZSTD_compressStream2(cctx,&out,&in,ZSTD_e_end);
+        if (ZSTD_isError(zres) ||
+            (zres && out.pos == out.size)) {
+            ZSTD_freeCCtx(cctx);
+            return FALSE;
+        }
+    } while (zres);
+    cj->cj_outlen = hdrlen + out.pos;
+    ZSTD_freeCCtx(cctx);
+    return TRUE;
+}
+#endif /* HAVE_ZSTD */
+
+/*  Touches nothing shared but the (read-only) chunk
+    list, so jobs may run on several threads. */
+static void
+compress_one(struct compress_job_s *cj)
+{
+    Dwarf_P_Debug dbg = cj->cj_dbg;
+    unsigned hdrlen = (dbg->de_pointer_size == 8)?
+        ELF64_CHDR_SIZE:ELF32_CHDR_SIZE;
+    Dwarf_Bool ok = FALSE;
+
+    switch (dbg->de_compress_sections) {
+#ifdef HAVE_ZLIB
+    case ELFCOMPRESS_ZLIB:
+        ok = compress_zlib(cj,hdrlen);
+        break;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+    case ELFCOMPRESS_ZSTD:
+        ok = compress_zstd(cj,hdrlen);
+        break;
+#endif /* HAVE_ZSTD */
+    default:
+        break;
+    }
+    if (!ok) {
+        free(cj->cj_out);
+        cj->cj_out = 0;
+        cj->cj_failed = TRUE;
+        return;
+    }
+    if (cj->cj_outlen >= cj->cj_size) {
+        /*  As GNU as does, leave it uncompressed. */
+        free(cj->cj_out);
+        cj->cj_out = 0;
+        cj->cj_raw = TRUE;
+        return;
+    }
+    write_chdr(dbg,cj->cj_out,hdrlen,cj->cj_size);
+}
+
+#ifdef HAVE_PTHREAD_H
+struct compress_pool_s {
+    pthread_mutex_t        cp_lock;
+    struct compress_job_s *cp_jobs;
+    unsigned               cp_njobs;
+    unsigned               cp_next;
+};
+
+static void *
+compress_worker(void *arg)
+{
+    struct compress_pool_s *cp = (struct compress_pool_s *)arg;
+
+    for (;;) {
+        unsigned j = 0;
+
+        pthread_mutex_lock(&cp->cp_lock);
+        j = cp->cp_next++;
+        pthread_mutex_unlock(&cp->cp_lock);
+        if (j >= cp->cp_njobs) {
+            break;
+        }
+        compress_one(&cp->cp_jobs[j]);
+    }
+    return 0;
+}
+
+static int
+job_size_compare(const void *l_in, const void *r_in)
+{
+    const struct compress_job_s *l =
+        (const struct compress_job_s *)l_in;
+    const struct compress_job_s *r =
+        (const struct compress_job_s *)r_in;
+
+    /* Largest first, for a better spread over threads. */
+    if (l->cj_size > r->cj_size) {
+        return -1;
+    }
+    if (l->cj_size < r->cj_size) {
+        return 1;
+    }
+    return l->cj_elf_sect_no - r->cj_elf_sect_no;
+}
+
+/*  Returns FALSE if no thread could be started and
+    the caller should compress serially. */
+static Dwarf_Bool
+compress_in_parallel(struct compress_job_s *jobs,
+    unsigned njobs)
+{
+    struct compress_pool_s cp;
+    pthread_t threads[NUM_DEBUG_SECTIONS];
+    unsigned nthreads = 0;
+    unsigned started = 0;
+    unsigned t = 0;
+
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+    {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (ncpu > 1) {
+            nthreads = (unsigned)ncpu;
+        }
+    }
+#endif /* HAVE_UNISTD_H && _SC_NPROCESSORS_ONLN */
+    if (nthreads > njobs) {
+        nthreads = njobs;
+    }
+    if (nthreads < 2) {
+        return FALSE;
+    }
+    qsort(jobs,njobs,sizeof(struct compress_job_s),
+        job_size_compare);
+    if (pthread_mutex_init(&cp.cp_lock,0)) {
+        return FALSE;
+    }
+    cp.cp_jobs = jobs;
+    cp.cp_njobs = njobs;
+    cp.cp_next = 0;
+    for (t = 0; t < nthreads; ++t) {
+        if (pthread_create(&threads[started],0,
+            compress_worker,&cp)) {
+            break;
+        }
+        ++started;
+    }
+    /*  This thread takes jobs too, so it is fine
+        if fewer threads (even none) started. */
+    compress_worker(&cp);
+    for (t = 0; t < started; ++t) {
+        pthread_join(threads[t],0);
+    }
+    pthread_mutex_destroy(&cp.cp_lock);
+    return TRUE;
+}
+#endif /* HAVE_PTHREAD_H */
+
+/*  Called by dwarf_transform_to_disk_form_a() once all
+    DWARF sections are generated and before the stream
+    relocation sections are.  Replaces the chunks of each
+    section by a single SHF_COMPRESSED chunk, unless that
+    would be no smaller than the section, and records
+    which sections were compressed in
+    de_sect_compressed[]. */
+int
+_dwarf_pro_compress_sections(Dwarf_P_Debug dbg,
+    Dwarf_Signed *nbufs,
+    Dwarf_Error *error)
+{
+    struct compress_job_s jobs[NUM_DEBUG_SECTIONS];
+    unsigned njobs = 0;
+    unsigned j = 0;
+    int sect = 0;
+    Dwarf_P_Section_Data cur = 0;
+    Dwarf_P_Section_Data next = 0;
+    Dwarf_P_Section_Data first = 0;
+    Dwarf_P_Section_Data last = 0;
+    Dwarf_Signed count = 0;
+    Dwarf_Bool failed = FALSE;
+
+    if (!dbg->de_compress_sections) {
+        return DW_DLV_NO_ENTRY;
+    }
+    memset(jobs,0,sizeof(jobs));
+    for (sect = 0; sect < NUM_DEBUG_SECTIONS; ++sect) {
+        int elfsectno = dbg->de_elf_sects[sect];
+
+        if (!dbg->de_sect_created[sect]) {
+            continue;
+        }
+        for (j = 0; j < njobs; ++j) {
+            if (jobs[j].cj_elf_sect_no == elfsectno) {
+                break;
+            }
+        }
+        if (j < njobs) {
+            continue;
+        }
+        jobs[njobs].cj_dbg = dbg;
+        jobs[njobs].cj_elf_sect_no = elfsectno;
+        ++njobs;
+    }
+    if (!njobs) {
+        return DW_DLV_NO_ENTRY;
+    }
+    if (dbg->de_debug_sects->ds_elf_sect_no != MAGIC_SECT_NO) {
+        for (cur = dbg->de_first_debug_sect; cur;
+            cur = cur->ds_next) {
+            for (j = 0; j < njobs; ++j) {
+                if (jobs[j].cj_elf_sect_no ==
+                    cur->ds_elf_sect_no) {
+                    if (!jobs[j].cj_first) {
+                        jobs[j].cj_first = cur;
+                    }
+                    jobs[j].cj_size += cur->ds_nbytes;
+                    break;
+                }
+            }
+        }
+    }
+
+#ifdef HAVE_PTHREAD_H
+    if (!compress_in_parallel(jobs,njobs))
+#endif /* HAVE_PTHREAD_H */
+    {
+        for (j = 0; j < njobs; ++j) {
+            compress_one(&jobs[j]);
+        }
+    }
+    for (j = 0; j < njobs; ++j) {
+        if (jobs[j].cj_failed) {
+            failed = TRUE;
+        }
+    }
+    if (failed) {
+        for (j = 0; j < njobs; ++j) {
+            free(jobs[j].cj_out);
+        }
+        DWARF_P_DBG_ERROR(dbg,DW_DLE_PRO_COMPRESS_ERROR,
+            DW_DLV_ERROR);
+    }
+
+    /*  Rebuild the chunk list in the same section
+        order, each compressed section where its
+        first chunk was.  Sections with no chunks
+        still need their header: they go last. */
+    cur = (dbg->de_debug_sects->ds_elf_sect_no == MAGIC_SECT_NO)?
+        0:dbg->de_first_debug_sect;
+    for ( ; ; cur = next) {
+        struct compress_job_s *cj = 0;
+        Dwarf_P_Section_Data keep = 0;
+
+        if (cur) {
+            next = cur->ds_next;
+            for (j = 0; j < njobs; ++j) {
+                if (jobs[j].cj_elf_sect_no ==
+                    cur->ds_elf_sect_no) {
+                    cj = &jobs[j];
+                    break;
+                }
+            }
+            if (!cj || cj->cj_raw) {
+                keep = cur;
+                cj = 0;
+            } else if (cj->cj_first != cur) {
+                _dwarf_p_dealloc(dbg,(Dwarf_Small *)cur);
+                continue;
+            }
+        } else {
+            for (j = 0; j < njobs; ++j) {
+                if (!jobs[j].cj_first && jobs[j].cj_out) {
+                    cj = &jobs[j];
+                    break;
+                }
+            }
+            if (!cj) {
+                break;
+            }
+        }
+        if (cj) {
+            keep = (Dwarf_P_Section_Data)
+                _dwarf_p_get_alloc(dbg,
+                sizeof(struct Dwarf_P_Section_Data_s) +
+                cj->cj_outlen);
+            if (!keep) {
+                failed = TRUE;
+            } else {
+                keep->ds_data = (char *)keep +
+                    sizeof(struct Dwarf_P_Section_Data_s);
+                keep->ds_elf_sect_no = cj->cj_elf_sect_no;
+                keep->ds_nbytes = cj->cj_outlen;
+                keep->ds_orig_alloc = cj->cj_outlen;
+                memcpy(keep->ds_data,cj->cj_out,cj->cj_outlen);
+            }
+            free(cj->cj_out);
+            cj->cj_out = 0;
+            if (cur) {
+                _dwarf_p_dealloc(dbg,(Dwarf_Small *)cur);
+            }
+        }
+        if (keep) {
+            keep->ds_next = 0;
+            if (last) {
+                last->ds_next = keep;
+            } else {
+                first = keep;
+            }
+            last = keep;
+            ++count;
+        }
+    }
+    for (sect = 0; sect < NUM_DEBUG_SECTIONS; ++sect) {
+        if (!dbg->de_sect_created[sect]) {
+            continue;
+        }
+        for (j = 0; j < njobs; ++j) {
+            if (jobs[j].cj_elf_sect_no == dbg->de_elf_sects[sect]) {
+                dbg->de_sect_compressed[sect] = !jobs[j].cj_raw;
+                break;
+            }
+        }
+    }
+    if (first) {
+        dbg->de_first_debug_sect = first;
+        dbg->de_debug_sects = first;
+        dbg->de_current_active_section = last;
+    }
+    dbg->de_n_debug_sect = count;
+    *nbufs = count;
+    if (failed) {
+        DWARF_P_DBG_ERROR(dbg,DW_DLE_ALLOC_FAIL,DW_DLV_ERROR);
+    }
+    return DW_DLV_OK;
+}
+
+int
+dwarf_pro_get_section_compressed(Dwarf_P_Debug dbg,
+    Dwarf_Signed elf_section_index,
+    Dwarf_Bool *compressed,
+    Dwarf_Error *error)
+{
+    int sect = 0;
+
+    if (!dbg) {
+        _dwarf_p_error(NULL, error, DW_DLE_DBG_NULL);
+        return DW_DLV_ERROR;
+    }
+    if (dbg->de_version_magic_number != PRO_VERSION_MAGIC ||
+        !compressed) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_IA, DW_DLV_ERROR);
+    }
+    for (sect = 0; sect < NUM_DEBUG_SECTIONS; ++sect) {
+        if (dbg->de_sect_created[sect] &&
+            dbg->de_elf_sects[sect] == elf_section_index) {
+            *compressed = dbg->de_sect_compressed[sect];
+            return DW_DLV_OK;
+        }
+    }
+    return DW_DLV_NO_ENTRY;
+}
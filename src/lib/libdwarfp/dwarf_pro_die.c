@@ -48,7 +48,7 @@
 #include "dwarf_pro_alloc.h"
 #include "dwarf_pro_die.h"
 #include "dwarf_pro_section.h"
-#include "dwarf_tsearch.h"
+#include "dwarf_pro_dnames.h"
 
 #ifndef R_MIPS_NONE
 #define R_MIPS_NONE 0
@@ -87,7 +87,7 @@ dwarf_new_die_a(Dwarf_P_Debug dbg,
     res = dwarf_die_link_a(ret_die, parent, child, left, right,
         error);
     if (res != DW_DLV_OK) {
-        _dwarf_p_dealloc((Dwarf_Small *)ret_die);
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)ret_die);
         ret_die = 0;
     } else {
         *die_out = ret_die;
@@ -237,9 +237,53 @@ dwarf_add_die_to_debug_a(Dwarf_P_Debug dbg,
     return DW_DLV_OK;
 }
 
+/*  Free a DIE tree written by per-CU streaming, along
+    with the attributes and abbrev bytes of each DIE.
+    Iterative so deep trees cannot exhaust the stack. */
+void
+_dwarf_pro_free_die_tree(Dwarf_P_Die root)
+{
+    Dwarf_P_Die cur = root;
+    Dwarf_P_Debug dbg = 0;
+
+    if (!root) {
+        return;
+    }
+    dbg = root->di_dbg;
+    while (cur) {
+        Dwarf_P_Die next = 0;
+        Dwarf_P_Attribute attr = 0;
+
+        if (cur->di_child) {
+            next = cur->di_child;
+            cur->di_child = 0;
+            cur = next;
+            continue;
+        }
+        next = cur->di_right? cur->di_right:cur->di_parent;
+        attr = cur->di_attrs;
+        while (attr) {
+            Dwarf_P_Attribute nextattr = attr->ar_next;
+
+            if (attr->ar_data) {
+                _dwarf_p_dealloc(dbg,(Dwarf_Small *)attr->ar_data);
+            }
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)attr);
+            attr = nextattr;
+        }
+        if (cur->di_abbrev) {
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)cur->di_abbrev);
+        }
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)cur);
+        cur = next;
+    }
+}
+
 int
 _dwarf_pro_add_AT_stmt_list(Dwarf_P_Debug dbg,
-    Dwarf_P_Die first_die, Dwarf_Error * error)
+    Dwarf_P_Die first_die,
+    Dwarf_Unsigned line_offset,
+    Dwarf_Error * error)
 {
     Dwarf_P_Attribute new_attr;
     int uwordb_size = dbg->de_dwarf_offset_size;
@@ -268,7 +312,7 @@ _dwarf_pro_add_AT_stmt_list(Dwarf_P_Debug dbg,
             DW_DLV_ERROR);
     }
     {
-        Dwarf_Unsigned du = 0;
+        Dwarf_Unsigned du = line_offset;
 
         WRITE_UNALIGNED(dbg, (void *) new_attr->ar_data,
             (const void *) &du, sizeof(du), uwordb_size);
@@ -278,84 +322,80 @@ _dwarf_pro_add_AT_stmt_list(Dwarf_P_Debug dbg,
     return DW_DLV_OK;
 }
 
-static int
-_dwarf_debug_str_compare_func(const void *l,const void *r)
-{
-    const struct Dwarf_P_debug_str_entry_s*el = l;
-    const struct Dwarf_P_debug_str_entry_s*er = r;
-    char *lname =  0;
-    char *rname =  0;
-    int ir = 0;
-
-    if (el->dse_has_table_offset) {
-        /*  When set the name is in the debug_str table. */
-        /*  ASSERT: dse_dbg->de_debug_str->ds_data
-            is non-zero.
-            ASSERT: dse_name NULL. */
-        lname = el->dse_dbg->de_debug_str->ds_data +
-            el->dse_table_offset;
-    } else {
-        /*  ASSERT: dse_name non-null */
-        lname = el->dse_name;
-    }
-    if (er->dse_has_table_offset) {
-        /*  When set the name is in the debug_str table. */
-        /*  ASSERT: dse_dbg->de_debug_str->ds_data
-            is non-zero.
-            ASSERT: dse_name NULL. */
-        rname = er->dse_dbg->de_debug_str->ds_data +
-            er->dse_table_offset;
-    } else {
-        /*  ASSERT: dse_name non-null */
-        rname = er->dse_name;
-    }
-    ir = strcmp(lname,rname);
-    return ir;
-}
+/*  The .debug_str and .debug_line_str intern tables use
+    open addressing with linear probing.  Each slot caches
+    the string's hash and length, so a probe only touches
+    the string bytes in the section data when both match.
+    A slot with sie_slen zero is empty. */
+#define STR_INTERN_INITIAL_SIZE 1024
 
-static  void
-debug_str_entry_free_func(void *m)
+static Dwarf_Unsigned
+str_intern_hash(const char *str, unsigned slen)
 {
-    free(m);
+    /* FNV-1a, 64 bit. slen includes the NUL. */
+    Dwarf_Unsigned h = 0xcbf29ce484222325ULL;
+    unsigned i = 0;
+
+    for ( ; i + 1 < slen; ++i) {
+        h ^= (unsigned char)str[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
 }
 
+/*  Make room for one more string, keeping the load
+    at most 3/4.  Rehashing uses the cached hashes. */
 static int
-make_debug_str_entry(Dwarf_P_Debug dbg,
-    struct Dwarf_P_debug_str_entry_s **mt_out,
-    char *name,
-    unsigned slen,
-    unsigned char has_offset,
-    Dwarf_Unsigned offset_in_table,
+str_intern_reserve(Dwarf_P_Debug dbg,
+    struct Dwarf_P_Str_Intern_s *si,
     Dwarf_Error *error)
 {
-    struct Dwarf_P_debug_str_entry_s *mt =
-        (struct  Dwarf_P_debug_str_entry_s *)calloc(
-        sizeof(struct Dwarf_P_debug_str_entry_s),1);
-    if (!mt) {
+    struct Dwarf_P_Str_Intern_Entry_s *newslots = 0;
+    Dwarf_Unsigned newsize = 0;
+    Dwarf_Unsigned i = 0;
+
+    if ((si->si_count + 1) * 4 <= si->si_size * 3) {
+        return DW_DLV_OK;
+    }
+    newsize = si->si_size? si->si_size * 2:STR_INTERN_INITIAL_SIZE;
+    if (newsize < si->si_size) {
+        _dwarf_p_error(dbg, error, DW_DLE_SIZE_WRAPAROUND);
+        return DW_DLV_ERROR;
+    }
+    newslots = (struct Dwarf_P_Str_Intern_Entry_s *)calloc(
+        newsize, sizeof(struct Dwarf_P_Str_Intern_Entry_s));
+    if (!newslots) {
         _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
         return DW_DLV_ERROR;
     }
+    for (i = 0; i < si->si_size; ++i) {
+        struct Dwarf_P_Str_Intern_Entry_s *e = si->si_slots + i;
+        Dwarf_Unsigned slot = 0;
 
-    mt->dse_slen = slen;
-    mt->dse_table_offset = 0;
-    mt->dse_dbg = dbg;
-    if (has_offset) {
-        mt->dse_has_table_offset = TRUE;
-        mt->dse_table_offset = offset_in_table;
-        mt->dse_name = 0;
-    } else {
-        /* ASSERT: name != NULL */
-        mt->dse_has_table_offset = FALSE;
-        /* We just set dse_table_offset so it has
-            a known value, though nothing should refer
-            to dse_table_offset because
-            dse_has_table_offset is FALSE.*/
-        mt->dse_table_offset = 0;
-        mt->dse_name = name;
-    }
-    *mt_out = mt;
+        if (!e->sie_slen) {
+            continue;
+        }
+        slot = e->sie_hash & (newsize - 1);
+        while (newslots[slot].sie_slen) {
+            slot = (slot + 1) & (newsize - 1);
+        }
+        newslots[slot] = *e;
+    }
+    free(si->si_slots);
+    si->si_slots = newslots;
+    si->si_size = newsize;
     return DW_DLV_OK;
 }
+
+void
+_dwarf_pro_free_str_intern(struct Dwarf_P_Str_Intern_s *si)
+{
+    free(si->si_slots);
+    si->si_slots = 0;
+    si->si_size = 0;
+    si->si_count = 0;
+}
+
 #define STRTAB_BASE_ALLOC_SIZE 2048
 static int
 insert_debug_str_data_string(Dwarf_P_Debug dbg,
@@ -425,7 +465,7 @@ insert_debug_str_data_string(Dwarf_P_Debug dbg,
     return DW_DLV_OK;
 }
 
-/*  Find the string offset using the hash table,
+/*  Find the string offset using the intern table,
     and if not known, insert the new string. */
 int
 _dwarf_insert_or_find_in_debug_str(Dwarf_P_Debug dbg,
@@ -435,24 +475,23 @@ _dwarf_insert_or_find_in_debug_str(Dwarf_P_Debug dbg,
     Dwarf_Unsigned *offset_in_debug_str,
     Dwarf_Error *error)
 {
-    struct Dwarf_P_debug_str_entry_s *mt = 0;
-    struct Dwarf_P_debug_str_entry_s *mt2 = 0;
-    struct Dwarf_P_debug_str_entry_s *retval = 0;
-    struct Dwarf_P_debug_str_entry_s *re = 0;
+    struct Dwarf_P_Str_Intern_s *si = 0;
+    struct Dwarf_P_Str_Intern_Entry_s *e = 0;
     int res = 0;
     Dwarf_Unsigned adding_at_offset = 0;
-    void **hashtab = 0;
+    Dwarf_Unsigned hash = 0;
+    Dwarf_Unsigned slot = 0;
     Dwarf_P_Section_Data sd = 0;
     struct Dwarf_P_Str_stats_s * stats =  0;
 
     switch (whash) {
     case _dwarf_hash_debug_str:
-        hashtab =  &dbg->de_debug_str_hashtab;
+        si =  &dbg->de_debug_str_intern;
         sd =  dbg->de_debug_str;
         stats = &dbg->de_stats.ps_strp;
         break;
     case _dwarf_hash_debug_line_str:
-        hashtab =  &dbg->de_debug_line_str_hashtab;
+        si =  &dbg->de_debug_line_str_intern;
         sd =  dbg->de_debug_line_str;
         stats = &dbg->de_stats.ps_line_strp;
         break;
@@ -463,68 +502,278 @@ _dwarf_insert_or_find_in_debug_str(Dwarf_P_Debug dbg,
             DW_DLE_STRING_HASHTAB_IDENTITY_ERROR);
         return DW_DLV_ERROR;
     }
-    res = make_debug_str_entry(dbg,&mt,name,
-        slen,FALSE, 0, error);
+    res = str_intern_reserve(dbg,si,error);
     if (res != DW_DLV_OK) {
         return res;
     }
-    /*  We do a find as we do not want the string pointer passed in
-        to be in the hash table, we want a pointer into the
-        debug_str table in the hash table. */
-    retval = dwarf_tfind(mt,(void *const*)hashtab,
-        _dwarf_debug_str_compare_func);
-    if (retval) {
-
-        stats->ps_strp_reused_count++;
-        stats->ps_strp_reused_len += slen;
-
-        re = *(struct Dwarf_P_debug_str_entry_s **)retval;
-        *offset_in_debug_str = re->dse_table_offset;
-        debug_str_entry_free_func(mt);
-        return DW_DLV_OK;
+    hash = str_intern_hash(name,slen);
+    slot = hash & (si->si_size - 1);
+    for (;;) {
+        e = si->si_slots + slot;
+        if (!e->sie_slen) {
+            break;
+        }
+        if (e->sie_hash == hash && e->sie_slen == slen &&
+            !memcmp(sd->ds_data + e->sie_offset,name,slen)) {
+            stats->ps_strp_reused_count++;
+            stats->ps_strp_reused_len += slen;
+            *offset_in_debug_str = e->sie_offset;
+            return DW_DLV_OK;
+        }
+        slot = (slot + 1) & (si->si_size - 1);
     }
 
     /*  We know the string is not in .debug_str data yet.
         Insert it into the big string table and get that
         offset. */
-
-    debug_str_entry_free_func(mt);
-    mt = 0;
     res = insert_debug_str_data_string(dbg,name,slen,sd,
         &adding_at_offset, error);
     if (res != DW_DLV_OK) {
         return res;
     }
+    e->sie_hash = hash;
+    e->sie_offset = adding_at_offset;
+    e->sie_slen = slen;
+    si->si_count++;
+    stats->ps_strp_count_debug_str++;
+    stats->ps_strp_len_debug_str += slen;
+    *offset_in_debug_str = adding_at_offset;
+    return DW_DLV_OK;
+}
 
-    /*  The name is in the string table itself, so use that pointer
-        and offset for the string. */
-    res = make_debug_str_entry(dbg,&mt2, 0,
-        slen,TRUE,adding_at_offset,error);
-    if (res != DW_DLV_OK) {
-        return res;
+/*  One .debug_str string during tail merging. */
+struct tail_merge_str_s {
+    char          *tms_str;
+    Dwarf_Unsigned tms_len;     /* without the NUL */
+    Dwarf_Unsigned tms_old_offset;
+    Dwarf_Unsigned tms_new_offset;
+    /*  Index of the string this one is a suffix of,
+        and where in it, or -1 if kept. */
+    Dwarf_Signed   tms_parent;
+    Dwarf_Unsigned tms_offset_in_parent;
+};
+
+/*  Orders strings by their reversed contents, so a string
+    sorts directly before the strings it is a suffix of. */
+static int
+tail_merge_compare(const void *l_in, const void *r_in)
+{
+    const struct tail_merge_str_s *l =
+        *(const struct tail_merge_str_s *const *)l_in;
+    const struct tail_merge_str_s *r =
+        *(const struct tail_merge_str_s *const *)r_in;
+    Dwarf_Unsigned i = 0;
+
+    for ( ; i < l->tms_len && i < r->tms_len; ++i) {
+        unsigned char lc =
+            (unsigned char)l->tms_str[l->tms_len - 1 - i];
+        unsigned char rc =
+            (unsigned char)r->tms_str[r->tms_len - 1 - i];
+
+        if (lc != rc) {
+            return lc < rc? -1:1;
+        }
+    }
+    if (l->tms_len != r->tms_len) {
+        return l->tms_len < r->tms_len? -1:1;
     }
-    retval = dwarf_tsearch(mt2,
-        (void *)hashtab,
-        _dwarf_debug_str_compare_func);
-    if (!retval) {
-        debug_str_entry_free_func(mt2);
+    return 0;
+}
+
+static Dwarf_Unsigned
+read_str_offset(Dwarf_P_Debug dbg, const char *src, unsigned len)
+{
+    Dwarf_Unsigned du = 0;
+
+#ifdef WORDS_BIGENDIAN
+    dbg->de_copy_word(((char *)&du) + sizeof(du) - len, src, len);
+#else /* LITTLE ENDIAN */
+    dbg->de_copy_word(&du, src, len);
+#endif /* BIG- LITTLE-ENDIAN */
+    return du;
+}
+
+/*  tms is in .debug_str order, so binary search it. */
+static int
+remap_str_offset(struct tail_merge_str_s *tms, Dwarf_Unsigned count,
+    Dwarf_Unsigned *offset)
+{
+    Dwarf_Unsigned lo = 0;
+    Dwarf_Unsigned hi = count;
+
+    while (lo < hi) {
+        Dwarf_Unsigned mid = lo + (hi - lo)/2;
+
+        if (tms[mid].tms_old_offset == *offset) {
+            *offset = tms[mid].tms_new_offset;
+            return DW_DLV_OK;
+        }
+        if (tms[mid].tms_old_offset < *offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return DW_DLV_NO_ENTRY;
+}
+
+/*  With the "str_tail_merge" option, rewrite .debug_str so
+    that a string which is a suffix of another one is not
+    stored again but referenced inside the longer one
+    (what linkers do for SHF_MERGE|SHF_STRINGS sections),
+    and update every DW_FORM_strp offset already recorded:
+    in the DIE tree, .debug_names and the intern table.
+    Not done once a CU has been streamed, as its offsets
+    are out of reach. */
+int
+_dwarf_pro_tail_merge_debug_str(Dwarf_P_Debug dbg,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Section_Data sd = dbg->de_debug_str;
+    struct Dwarf_P_Str_stats_s *stats = &dbg->de_stats.ps_strp;
+    struct tail_merge_str_s *tms = 0;
+    struct tail_merge_str_s **sorted = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned off = 0;
+    Dwarf_Unsigned i = 0;
+    Dwarf_Unsigned newlen = 0;
+    char *newdata = 0;
+    Dwarf_P_Die curdie = 0;
+    unsigned offset_size = dbg->de_dwarf_offset_size;
+
+    if (!dbg->de_str_tail_merge || !sd->ds_data ||
+        dbg->de_stream_sect_offset[DEBUG_INFO]) {
+        return DW_DLV_NO_ENTRY;
+    }
+    for (off = 0; off < sd->ds_nbytes; ++count) {
+        off += strlen(sd->ds_data + off) + 1;
+    }
+    if (count < 2) {
+        return DW_DLV_NO_ENTRY;
+    }
+    tms = (struct tail_merge_str_s *)calloc(count,
+        sizeof(struct tail_merge_str_s));
+    sorted = (struct tail_merge_str_s **)calloc(count,
+        sizeof(struct tail_merge_str_s *));
+    if (!tms || !sorted) {
+        free(tms);
+        free(sorted);
         _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
         return DW_DLV_ERROR;
     }
+    for (i = 0, off = 0; i < count; ++i) {
+        tms[i].tms_str = sd->ds_data + off;
+        tms[i].tms_len = strlen(tms[i].tms_str);
+        tms[i].tms_old_offset = off;
+        tms[i].tms_parent = -1;
+        sorted[i] = tms + i;
+        off += tms[i].tms_len + 1;
+    }
+    qsort(sorted,count,sizeof(struct tail_merge_str_s *),
+        tail_merge_compare);
+    /*  Strings ending in s sort right after s, so the next
+        one is the longest-chain candidate.  Work from the
+        end so the candidate already knows where it lives. */
+    for (i = count - 1; i > 0; --i) {
+        struct tail_merge_str_s *a = sorted[i-1];
+        struct tail_merge_str_s *b = sorted[i];
+
+        if (a->tms_len > b->tms_len ||
+            memcmp(b->tms_str + b->tms_len - a->tms_len,
+            a->tms_str, a->tms_len)) {
+            continue;
+        }
+        if (b->tms_parent >= 0) {
+            a->tms_parent = b->tms_parent;
+            a->tms_offset_in_parent = b->tms_offset_in_parent +
+                b->tms_len - a->tms_len;
+        } else {
+            a->tms_parent = b - tms;
+            a->tms_offset_in_parent = b->tms_len - a->tms_len;
+        }
+    }
+    free(sorted);
 
-    /* This indirection is one of the surprises in using tsearch... */
-    re = *(struct Dwarf_P_debug_str_entry_s **)retval;
-    if (re != mt2) {
-        debug_str_entry_free_func(mt2);
-        /*  Found it in hash tab: illogical as the tsearch_find should
-            have found it. */
-        _dwarf_p_error(dbg, error, DW_DLE_ILLOGICAL_TSEARCH);
+    /*  Kept strings stay in their original order. */
+    newdata = (char *)calloc(1,sd->ds_orig_alloc);
+    if (!newdata) {
+        free(tms);
+        _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
         return DW_DLV_ERROR;
     }
-    stats->ps_strp_count_debug_str++;
-    stats->ps_strp_len_debug_str += slen;
-    /* we added it to hash, do not free mt2 (which == re). */
-    *offset_in_debug_str = re->dse_table_offset;
+    for (i = 0; i < count; ++i) {
+        if (tms[i].tms_parent >= 0) {
+            stats->ps_strp_tail_merged_count++;
+            stats->ps_strp_tail_merged_len += tms[i].tms_len + 1;
+            continue;
+        }
+        memcpy(newdata + newlen,tms[i].tms_str,tms[i].tms_len + 1);
+        tms[i].tms_new_offset = newlen;
+        newlen += tms[i].tms_len + 1;
+    }
+    for (i = 0; i < count; ++i) {
+        if (tms[i].tms_parent >= 0) {
+            tms[i].tms_new_offset =
+                tms[tms[i].tms_parent].tms_new_offset +
+                tms[i].tms_offset_in_parent;
+        }
+    }
+
+    /*  Now every recorded offset. */
+    for (curdie = dbg->de_dies; curdie; ) {
+        Dwarf_P_Attribute attr = curdie->di_attrs;
+
+        for ( ; attr; attr = attr->ar_next) {
+            Dwarf_Unsigned stroff = 0;
+
+            if (attr->ar_attribute_form != DW_FORM_strp &&
+                attr->ar_attribute_form != DW_FORM_strx) {
+                continue;
+            }
+            stroff = read_str_offset(dbg,attr->ar_data,offset_size);
+            if (remap_str_offset(tms,count,&stroff) != DW_DLV_OK) {
+                free(tms);
+                free(newdata);
+                _dwarf_p_error(dbg, error,
+                    DW_DLE_STRING_HASHTAB_IDENTITY_ERROR);
+                return DW_DLV_ERROR;
+            }
+            WRITE_UNALIGNED(dbg, (void *) attr->ar_data,
+                (const void *) &stroff, sizeof(stroff), offset_size);
+        }
+        if (curdie->di_child) {
+            curdie = curdie->di_child;
+            continue;
+        }
+        while (curdie && !curdie->di_right) {
+            curdie = curdie->di_parent;
+        }
+        if (curdie) {
+            curdie = curdie->di_right;
+        }
+    }
+    if (dbg->de_dnames) {
+        struct Dwarf_P_Dnames_s *dn = dbg->de_dnames;
+
+        for (i = 0; i < dn->dn_names_count; ++i) {
+            /*  Always found: the offsets came from the
+                intern table. */
+            remap_str_offset(tms,count,
+                &dn->dn_names[i].dnn_str_offset);
+        }
+    }
+    for (i = 0; i < dbg->de_debug_str_intern.si_size; ++i) {
+        struct Dwarf_P_Str_Intern_Entry_s *e =
+            dbg->de_debug_str_intern.si_slots + i;
+
+        if (e->sie_slen) {
+            remap_str_offset(tms,count,&e->sie_offset);
+        }
+    }
+    free(tms);
+    free(sd->ds_data);
+    sd->ds_data = newdata;
+    sd->ds_nbytes = newlen;
     return DW_DLV_OK;
 }
 
@@ -557,7 +806,7 @@ int _dwarf_pro_set_string_attr(Dwarf_P_Attribute new_attr,
         new_attr->ar_reloc_len = 0; /* unused for R_MIPS_NONE */
         return DW_DLV_OK;
     }
-    if (form == DW_FORM_strp) {
+    if (form == DW_FORM_strp || form == DW_FORM_strx) {
         int uwordb_size = dbg->de_dwarf_offset_size;
         Dwarf_Unsigned offset_in_debug_str = 0;
         int res = 0;
@@ -573,6 +822,13 @@ int _dwarf_pro_set_string_attr(Dwarf_P_Attribute new_attr,
         new_attr->ar_nbytes = uwordb_size;
         new_attr->ar_next = NULL;
         new_attr->ar_reloc_len = uwordb_size;
+        if (form == DW_FORM_strx) {
+            /*  Holds the .debug_str offset until the CU
+                is generated, see dwarf_pro_index_forms.c */
+            new_attr->ar_rel_type = R_MIPS_NONE;
+            new_attr->ar_reloc_len = 0;
+            dbg->de_need_str_offsets = TRUE;
+        }
         /*  During transform to disk
             a symbol index will be applied. */
         new_attr->ar_data = (char *)
@@ -625,6 +881,10 @@ dwarf_add_AT_name_a(Dwarf_P_Die die, char *name,
     if (res != DW_DLV_OK) {
         return DW_DLV_ERROR;
     }
+    res = _dwarf_pro_dnames_add_name(die->di_dbg,die,name,error);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
 
     /* add attribute to the die */
     _dwarf_pro_add_at_to_die(die, new_attr);
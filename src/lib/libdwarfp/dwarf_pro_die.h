@@ -45,6 +45,10 @@ struct Dwarf_P_Abbrev_s {
     Dwarf_Signed *abb_implicits;
     int abb_n_attr;           /* num of attrs = # of forms */
     Dwarf_P_Abbrev abb_next;
+
+    /*  For the abbrev hash table in the Dwarf_P_Debug. */
+    Dwarf_Unsigned abb_hash;
+    Dwarf_P_Abbrev abb_hash_next;
 };
 
 /* used in pro_section.c */
@@ -54,8 +58,14 @@ int _dwarf_pro_add_AT_fde(Dwarf_P_Debug dbg, Dwarf_P_Die die,
 
 int _dwarf_pro_add_AT_stmt_list(Dwarf_P_Debug dbg,
     Dwarf_P_Die first_die,
+    Dwarf_Unsigned line_offset,
     Dwarf_Error * error);
 
+void _dwarf_pro_free_die_tree(Dwarf_P_Die root);
+
+int _dwarf_pro_tail_merge_debug_str(Dwarf_P_Debug dbg,
+    Dwarf_Error *error);
+
 int _dwarf_pro_add_AT_macro_info(Dwarf_P_Debug dbg,
     Dwarf_P_Die first_die,
     Dwarf_Unsigned offset,
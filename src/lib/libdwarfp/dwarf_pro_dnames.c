@@ -26,15 +26,18 @@
 
 */
 
+/*  Builds a DWARF5 .debug_names index for the CU (or the
+    streamed CUs) the producer emits.  Names are recorded as
+    DW_AT_name is added to DIEs (see
+    _dwarf_pro_dnames_add_name()); the section itself is
+    built after .debug_info has been generated, so DIE
+    offsets are known. */
+
 #include <config.h>
 
 #include <stddef.h> /* NULL */
-#include <stdio.h>  /* printf() */
-#include <string.h> /* memcpy() */
-
-#ifdef HAVE_STDINT_H
-#include <stdint.h> /* uintptr_t */
-#endif
+#include <stdlib.h> /* qsort() */
+#include <string.h> /* memcpy() strlen() */
 
 #include "dwarf.h"
 #include "libdwarfp.h"
@@ -47,54 +50,589 @@
 #include "dwarf_pro_reloc.h"
 #include "dwarf_pro_dnames.h"
 
-static struct Dwarf_P_Dnames_Head_s staticdnames =
-{
-/* fake unit length*/58,
-/* version */5,
-/*offset size*/4,
-/*offset*/0,
-/* cu count */1,
-/* tu ct */0,
-/* foreigntu ct */0,
-/* bucket ct */0,
-/* name ct */1,
-/* abbrev_table_size*/7,
-/* augstringsize*/0,
-/* augstring*/0
+#define DNAMES_INITIAL_NAMES 64
+/*  Header fields after unit_length: version, padding,
+    then seven 4-byte counts. */
+#define DNAMES_HEADER_FIXED (2 + 2 + 7*4)
+
+/*  One index entry during generation. */
+struct dn_entry_s {
+    Dwarf_Unsigned de_hash;
+    Dwarf_Unsigned de_str_offset;
+    Dwarf_Unsigned de_cu_index;
+    Dwarf_Unsigned de_die_offset;
+    Dwarf_Unsigned de_bucket;
+    Dwarf_Half     de_tag;
 };
 
-/* total length encoded: 6 bytes. */
-unsigned char abbrv[7] =
-{/* abbrev code*/ 2,
-/* DW_TAG_subprogram */ 0x2e,
-/* DW_IDX_compile_unit*/1,
-/* DW_FORM_udata */7,
-/* end abbrev */ 0,0,
-/* end abbrev block */0};
+/*  DJB hash with ASCII case folding, as DWARF5
+    section 6.1.1.4.5 requires for .debug_names. */
+static Dwarf_Unsigned
+dnames_hash(const char *name)
+{
+    Dwarf_Unsigned h = 5381;
+    const unsigned char *cp = (const unsigned char *)name;
+
+    for ( ; *cp; ++cp) {
+        unsigned c = *cp;
+
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        h = ((h << 5) + h + c) & 0xffffffff;
+    }
+    return h;
+}
+
+/*  Called for every DW_AT_name added while the index
+    is enabled (dwarf_force_dnames(dbg,0,..)). */
+int
+_dwarf_pro_dnames_add_name(Dwarf_P_Debug dbg,
+    Dwarf_P_Die die,
+    char *name,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Dnames dn = dbg->de_dnames;
+    struct Dwarf_P_Dnames_Name_s *n = 0;
+    Dwarf_Unsigned str_offset = 0;
+    int res = 0;
+
+    if (!dn || !dbg->de_force_dnames ||
+        dbg->de_output_version < 5) {
+        return DW_DLV_NO_ENTRY;
+    }
+    res = _dwarf_insert_or_find_in_debug_str(dbg,name,
+        _dwarf_hash_debug_str,(unsigned)strlen(name)+1,
+        &str_offset,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    if (dn->dn_names_count == dn->dn_names_allocated) {
+        Dwarf_Unsigned newcount = dn->dn_names_allocated?
+            dn->dn_names_allocated*2:DNAMES_INITIAL_NAMES;
+        struct Dwarf_P_Dnames_Name_s *newnames = 0;
+
+        newnames = (struct Dwarf_P_Dnames_Name_s *)
+            _dwarf_p_get_alloc(dbg, newcount*sizeof(*newnames));
+        if (!newnames) {
+            _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
+            return DW_DLV_ERROR;
+        }
+        if (dn->dn_names) {
+            memcpy(newnames,dn->dn_names,
+                dn->dn_names_count*sizeof(*newnames));
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)dn->dn_names);
+        }
+        dn->dn_names = newnames;
+        dn->dn_names_allocated = newcount;
+    }
+    n = dn->dn_names + dn->dn_names_count;
+    n->dnn_die = die;
+    n->dnn_str_offset = str_offset;
+    n->dnn_hash = dnames_hash(name);
+    dn->dn_names_count++;
+    return DW_DLV_OK;
+}
+
+static Dwarf_Bool
+dnames_die_has_attr(Dwarf_P_Die die, Dwarf_Half attrnum)
+{
+    Dwarf_P_Attribute a = die->di_attrs;
+
+    for ( ; a; a = a->ar_next) {
+        if (a->ar_attribute == attrnum) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*  The tags worth indexing, following what compilers
+    put in .debug_names.  Declarations are left out,
+    as are variables with no storage or value. */
+static Dwarf_Bool
+dnames_die_is_indexed(Dwarf_P_Die die)
+{
+    switch (die->di_tag) {
+    case DW_TAG_base_type:
+    case DW_TAG_class_type:
+    case DW_TAG_enumeration_type:
+    case DW_TAG_imported_declaration:
+    case DW_TAG_interface_type:
+    case DW_TAG_label:
+    case DW_TAG_namespace:
+    case DW_TAG_pointer_type:
+    case DW_TAG_ptr_to_member_type:
+    case DW_TAG_string_type:
+    case DW_TAG_structure_type:
+    case DW_TAG_subprogram:
+    case DW_TAG_subrange_type:
+    case DW_TAG_typedef:
+    case DW_TAG_union_type:
+    case DW_TAG_unspecified_type:
+        break;
+    case DW_TAG_variable:
+        if (!dnames_die_has_attr(die,DW_AT_location) &&
+            !dnames_die_has_attr(die,DW_AT_const_value)) {
+            return FALSE;
+        }
+        break;
+    default:
+        return FALSE;
+    }
+    if (dnames_die_has_attr(die,DW_AT_declaration)) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*  Called once the CU at cu_offset in .debug_info has
+    been generated (DIE offsets are known) and before its
+    DIEs can be freed.  Copies what the index needs from
+    each DIE named since the previous CU. */
+int
+_dwarf_pro_dnames_close_cu(Dwarf_P_Debug dbg,
+    Dwarf_Unsigned cu_offset,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Dnames dn = dbg->de_dnames;
+    Dwarf_Unsigned i = 0;
+
+    if (!dn || !dbg->de_force_dnames) {
+        return DW_DLV_NO_ENTRY;
+    }
+    if (dn->dn_cu_count == dn->dn_cu_allocated) {
+        Dwarf_Unsigned newcount = dn->dn_cu_allocated?
+            dn->dn_cu_allocated*2:8;
+        Dwarf_Unsigned *newoffs = 0;
+
+        newoffs = (Dwarf_Unsigned *)_dwarf_p_get_alloc(dbg,
+            newcount*sizeof(Dwarf_Unsigned));
+        if (!newoffs) {
+            _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
+            return DW_DLV_ERROR;
+        }
+        if (dn->dn_cu_offsets) {
+            memcpy(newoffs,dn->dn_cu_offsets,
+                dn->dn_cu_count*sizeof(Dwarf_Unsigned));
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)dn->dn_cu_offsets);
+        }
+        dn->dn_cu_offsets = newoffs;
+        dn->dn_cu_allocated = newcount;
+    }
+    for (i = dn->dn_names_resolved; i < dn->dn_names_count; ++i) {
+        struct Dwarf_P_Dnames_Name_s *n = dn->dn_names +i;
+        Dwarf_P_Die die = n->dnn_die;
+
+        /*  A zero offset means the DIE never made it
+            into the tree written to .debug_info. */
+        n->dnn_indexed = die->di_offset &&
+            dnames_die_is_indexed(die);
+        n->dnn_cu_index = dn->dn_cu_count;
+        n->dnn_die_offset = die->di_offset;
+        n->dnn_tag = die->di_tag;
+        n->dnn_die = 0;
+    }
+    dn->dn_names_resolved = dn->dn_names_count;
+    dn->dn_cu_offsets[dn->dn_cu_count] = cu_offset;
+    dn->dn_cu_count++;
+    return DW_DLV_OK;
+}
+
+static int
+dnames_cmp_name(const void *l, const void *r)
+{
+    const struct dn_entry_s *a = (const struct dn_entry_s *)l;
+    const struct dn_entry_s *b = (const struct dn_entry_s *)r;
+
+    if (a->de_str_offset != b->de_str_offset) {
+        return a->de_str_offset < b->de_str_offset? -1:1;
+    }
+    if (a->de_cu_index != b->de_cu_index) {
+        return a->de_cu_index < b->de_cu_index? -1:1;
+    }
+    if (a->de_die_offset != b->de_die_offset) {
+        return a->de_die_offset < b->de_die_offset? -1:1;
+    }
+    return 0;
+}
+
+/*  Final order: by bucket, then hash, with all entries
+    for one name adjacent. */
+static int
+dnames_cmp_bucket(const void *l, const void *r)
+{
+    const struct dn_entry_s *a = (const struct dn_entry_s *)l;
+    const struct dn_entry_s *b = (const struct dn_entry_s *)r;
+
+    if (a->de_bucket != b->de_bucket) {
+        return a->de_bucket < b->de_bucket? -1:1;
+    }
+    if (a->de_hash != b->de_hash) {
+        return a->de_hash < b->de_hash? -1:1;
+    }
+    return dnames_cmp_name(l,r);
+}
+
+/*  Same sizing rule LLVM uses: a load factor
+    between 2 and 4 for large tables. */
+static Dwarf_Unsigned
+dnames_bucket_count(Dwarf_Unsigned name_count)
+{
+    if (name_count > 1024) {
+        return name_count/4;
+    }
+    if (name_count > 16) {
+        return name_count/2;
+    }
+    return name_count;
+}
+
+static unsigned
+dnames_uleb_len(Dwarf_Unsigned val)
+{
+    unsigned len = 1;
+
+    while (val >= 0x80) {
+        val >>= 7;
+        ++len;
+    }
+    return len;
+}
+
+static Dwarf_Small *
+dnames_write_uleb(Dwarf_Small *data, Dwarf_Unsigned val)
+{
+    int nbytes = 0;
+
+    /*  Cannot fail: callers sized the buffer with
+        dnames_uleb_len(). */
+    dwarf_encode_leb128(val,&nbytes,(char *)data,
+        ENCODE_SPACE_NEEDED);
+    return data + nbytes;
+}
+
+/*  Returns the abbrev code (one per tag) for tag. */
+static Dwarf_Unsigned
+dnames_abbrev_code(Dwarf_Half *tags, Dwarf_Unsigned tagcount,
+    Dwarf_Half tag)
+{
+    Dwarf_Unsigned i = 0;
+
+    for ( ; i < tagcount; ++i) {
+        if (tags[i] == tag) {
+            return i+1;
+        }
+    }
+    return 0;
+}
+
+/*  Layout of the generated section:
+      header, CU offset list, bucket array,
+      hash array, string offsets, entry offsets,
+      abbreviation table, entry pool.
+    Each abbreviation has DW_IDX_die_offset and, only when
+    several CUs were streamed, DW_IDX_compile_unit. */
+int
+_dwarf_pro_generate_debug_names(Dwarf_P_Debug dbg,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Dnames dn = dbg->de_dnames;
+    int elfsectno = dbg->de_elf_sects[DEBUG_NAMES];
+    int offset_size = dbg->de_dwarf_offset_size;
+    int extension_size = dbg->de_64bit_extension ? 4 : 0;
+    struct dn_entry_s *entries = 0;
+    Dwarf_Unsigned entry_count = 0;
+    Dwarf_Unsigned name_count = 0;
+    Dwarf_Unsigned bucket_count = 0;
+    Dwarf_Half *tags = 0;
+    Dwarf_Unsigned tagcount = 0;
+    Dwarf_Unsigned abbrev_size = 0;
+    Dwarf_Unsigned pool_size = 0;
+    Dwarf_Unsigned max_die_offset = 0;
+    Dwarf_Half die_form = DW_FORM_ref4;
+    unsigned die_size = 4;
+    Dwarf_Half cu_form = 0;
+    unsigned cu_size = 0;
+    Dwarf_Unsigned abbrev_attr_size = 0;
+    Dwarf_Unsigned unit_length = 0;
+    Dwarf_Unsigned total = 0;
+    Dwarf_Unsigned i = 0;
+    Dwarf_Unsigned du = 0;
+    Dwarf_Half version = 5;
+    Dwarf_Small *data = 0;
+    Dwarf_Small *startdata = 0;
+    Dwarf_Small *bucketp = 0;
+    Dwarf_Small *hashp = 0;
+    Dwarf_Small *strp = 0;
+    Dwarf_Small *entryp = 0;
+    Dwarf_Small *poolstart = 0;
+    int res = 0;
+
+    if (!dn) {
+        return DW_DLV_NO_ENTRY;
+    }
+    dn->dn_dbg = dbg;
+    dn->dn_create_section = TRUE;
+    if (dbg->de_dies && !dbg->de_stream_active) {
+        /* The one CU, at offset 0. */
+        res = _dwarf_pro_dnames_close_cu(dbg,0,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+    }
+    if (dn->dn_cu_count > 0xffff) {
+        cu_form = DW_FORM_data4;
+        cu_size = 4;
+    } else if (dn->dn_cu_count > 0xff) {
+        cu_form = DW_FORM_data2;
+        cu_size = 2;
+    } else if (dn->dn_cu_count > 1) {
+        cu_form = DW_FORM_data1;
+        cu_size = 1;
+    }
+    if (dn->dn_names_count) {
+        entries = (struct dn_entry_s *)_dwarf_p_get_alloc(dbg,
+            dn->dn_names_count*sizeof(*entries));
+        tags = (Dwarf_Half *)_dwarf_p_get_alloc(dbg,
+            dn->dn_names_count*sizeof(*tags));
+        if (!entries || !tags) {
+            _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
+            return DW_DLV_ERROR;
+        }
+    }
+    for (i = 0; i < dn->dn_names_count; ++i) {
+        struct Dwarf_P_Dnames_Name_s *n = dn->dn_names +i;
+        struct dn_entry_s *e = 0;
+
+        if (!n->dnn_indexed) {
+            continue;
+        }
+        e = entries + entry_count;
+        e->de_hash = n->dnn_hash;
+        e->de_str_offset = n->dnn_str_offset;
+        e->de_cu_index = n->dnn_cu_index;
+        e->de_die_offset = n->dnn_die_offset;
+        e->de_tag = n->dnn_tag;
+        if (e->de_die_offset > max_die_offset) {
+            max_die_offset = e->de_die_offset;
+        }
+        if (!dnames_abbrev_code(tags,tagcount,e->de_tag)) {
+            tags[tagcount++] = e->de_tag;
+        }
+        ++entry_count;
+    }
+    if (max_die_offset > 0xffffffff) {
+        die_form = DW_FORM_ref8;
+        die_size = 8;
+    }
+    if (entry_count) {
+        qsort(entries,entry_count,sizeof(*entries),dnames_cmp_name);
+        name_count = 1;
+        for (i = 1; i < entry_count; ++i) {
+            if (entries[i].de_str_offset !=
+                entries[i-1].de_str_offset) {
+                ++name_count;
+            }
+        }
+        bucket_count = dnames_bucket_count(name_count);
+        for (i = 0; i < entry_count; ++i) {
+            entries[i].de_bucket = entries[i].de_hash % bucket_count;
+        }
+        qsort(entries,entry_count,sizeof(*entries),
+            dnames_cmp_bucket);
+    }
+
+    /*  Each abbrev: code, tag, [DW_IDX_compile_unit, form,]
+        DW_IDX_die_offset, form, 0, 0.
+        Then a 0 ends the table. */
+    abbrev_attr_size = dnames_uleb_len(DW_IDX_die_offset) +
+        dnames_uleb_len(die_form) + 2;
+    if (cu_form) {
+        abbrev_attr_size += dnames_uleb_len(DW_IDX_compile_unit) +
+            dnames_uleb_len(cu_form);
+    }
+    for (i = 0; i < tagcount; ++i) {
+        abbrev_size += dnames_uleb_len(i+1) +
+            dnames_uleb_len(tags[i]) + abbrev_attr_size;
+    }
+    abbrev_size += 1;
+    for (i = 0; i < entry_count; ++i) {
+        pool_size += dnames_uleb_len(dnames_abbrev_code(tags,
+            tagcount,entries[i].de_tag)) + cu_size + die_size;
+        if (i+1 == entry_count || entries[i+1].de_str_offset !=
+            entries[i].de_str_offset) {
+            /* End of the entry list for this name. */
+            pool_size += 1;
+        }
+    }
+
+    unit_length = DNAMES_HEADER_FIXED +
+        dn->dn_cu_count*offset_size +
+        bucket_count*4 +
+        name_count*4 +
+        name_count*offset_size*2 +
+        abbrev_size + pool_size;
+    total = extension_size + offset_size + unit_length;
 
-unsigned char entry[3] =
-{ /* abbrev code */2,
-/* Offset of subprogram */0x32,
-/* terminate this abbrev set */0 };
+    GET_CHUNK_ERR(dbg, elfsectno, data, (unsigned long)total, error);
+    startdata = data;
+    if (extension_size) {
+        DISTINGUISHED_VALUE_ARRAY(v4);
+
+        WRITE_UNALIGNED(dbg, (void *) data,
+            (const void *) &v4[0], SIZEOFT32, extension_size);
+        data += extension_size;
+    }
+    WRITE_UNALIGNED(dbg, (void *)data, (const void *)&unit_length,
+        sizeof(unit_length), offset_size);
+    data += offset_size;
+    WRITE_UNALIGNED(dbg, (void *)data, (const void *)&version,
+        sizeof(version), SIZEOFT16);
+    data += SIZEOFT16;
+    du = 0; /* padding */
+    WRITE_UNALIGNED(dbg, (void *)data, (const void *)&du,
+        sizeof(du), SIZEOFT16);
+    data += SIZEOFT16;
+    {
+        Dwarf_Unsigned counts[7];
+        int k = 0;
 
-Dwarf_Unsigned stroffsets[1] = {0x42}; /* main */
+        counts[0] = dn->dn_cu_count;
+        counts[1] = 0; /* local_type_unit_count */
+        counts[2] = 0; /* foreign_type_unit_count */
+        counts[3] = bucket_count;
+        counts[4] = name_count;
+        counts[5] = abbrev_size;
+        counts[6] = 0; /* augmentation_string_size */
+        for ( ; k < 7; ++k) {
+            WRITE_UNALIGNED(dbg, (void *)data,
+                (const void *)&counts[k],
+                sizeof(counts[k]), SIZEOFT32);
+            data += SIZEOFT32;
+        }
+    }
+    dn->dn_header.dh_unit_length = unit_length;
+    dn->dn_header.dh_version = version;
+    dn->dn_header.dh_offset_size = offset_size;
+    dn->dn_header.dh_comp_unit_count = dn->dn_cu_count;
+    dn->dn_header.dh_bucket_count = bucket_count;
+    dn->dn_header.dh_name_count = name_count;
+    dn->dn_header.dh_abbrev_table_size = abbrev_size;
+
+    for (i = 0; i < dn->dn_cu_count; ++i) {
+        res = dbg->de_relocate_by_name_symbol(dbg, DEBUG_NAMES,
+            data - startdata /* r_offset */,
+            dbg->de_sect_name_idx[DEBUG_INFO],
+            dwarf_drt_data_reloc, offset_size);
+        if (res != DW_DLV_OK) {
+            DWARF_P_DBG_ERROR(dbg, DW_DLE_CHUNK_ALLOC,
+                DW_DLV_ERROR);
+        }
+        WRITE_UNALIGNED(dbg, (void *)data,
+            (const void *)&dn->dn_cu_offsets[i],
+            sizeof(dn->dn_cu_offsets[i]), offset_size);
+        data += offset_size;
+    }
+
+    bucketp = data;
+    memset(bucketp,0,bucket_count*4);
+    hashp = bucketp + bucket_count*4;
+    strp = hashp + name_count*4;
+    entryp = strp + name_count*offset_size;
+    data = entryp + name_count*offset_size;
+
+    for (i = 0; i < tagcount; ++i) {
+        data = dnames_write_uleb(data,i+1);
+        data = dnames_write_uleb(data,tags[i]);
+        if (cu_form) {
+            data = dnames_write_uleb(data,DW_IDX_compile_unit);
+            data = dnames_write_uleb(data,cu_form);
+        }
+        data = dnames_write_uleb(data,DW_IDX_die_offset);
+        data = dnames_write_uleb(data,die_form);
+        *data++ = 0;
+        *data++ = 0;
+    }
+    *data++ = 0;
 
-/* Set to match subprog */
-Dwarf_Unsigned dieoffset[1] = {12};
+    poolstart = data;
+    {
+        Dwarf_Unsigned nameindex = 0;
 
+        for (i = 0; i < entry_count; ++i) {
+            struct dn_entry_s *e = entries +i;
+
+            if (!i || e->de_str_offset != e[-1].de_str_offset) {
+                /*  First entry of a new name.
+                    Buckets hold 1-based name indexes. */
+                ++nameindex;
+                if (!i || e->de_bucket != e[-1].de_bucket) {
+                    WRITE_UNALIGNED(dbg,
+                        (void *)(bucketp + e->de_bucket*4),
+                        (const void *)&nameindex,
+                        sizeof(nameindex), SIZEOFT32);
+                }
+                WRITE_UNALIGNED(dbg, (void *)hashp,
+                    (const void *)&e->de_hash,
+                    sizeof(e->de_hash), SIZEOFT32);
+                hashp += SIZEOFT32;
+                res = dbg->de_relocate_by_name_symbol(dbg,
+                    DEBUG_NAMES, strp - startdata /* r_offset */,
+                    dbg->de_sect_name_idx[DEBUG_STR],
+                    dwarf_drt_data_reloc, offset_size);
+                if (res != DW_DLV_OK) {
+                    DWARF_P_DBG_ERROR(dbg, DW_DLE_CHUNK_ALLOC,
+                        DW_DLV_ERROR);
+                }
+                WRITE_UNALIGNED(dbg, (void *)strp,
+                    (const void *)&e->de_str_offset,
+                    sizeof(e->de_str_offset), offset_size);
+                strp += offset_size;
+                du = data - poolstart;
+                WRITE_UNALIGNED(dbg, (void *)entryp,
+                    (const void *)&du, sizeof(du), offset_size);
+                entryp += offset_size;
+            }
+            data = dnames_write_uleb(data,
+                dnames_abbrev_code(tags,tagcount,e->de_tag));
+            if (cu_size) {
+                WRITE_UNALIGNED(dbg, (void *)data,
+                    (const void *)&e->de_cu_index,
+                    sizeof(e->de_cu_index), cu_size);
+                data += cu_size;
+            }
+            WRITE_UNALIGNED(dbg, (void *)data,
+                (const void *)&e->de_die_offset,
+                sizeof(e->de_die_offset), die_size);
+            data += die_size;
+            if (i+1 == entry_count ||
+                e[1].de_str_offset != e->de_str_offset) {
+                *data++ = 0;
+            }
+        }
+    }
+    if ((Dwarf_Unsigned)(data - startdata) != total) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_DEBUG_NAMES_HEADER_ERROR,
+            DW_DLV_ERROR);
+    }
+    if (entries) {
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)entries);
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)tags);
+    }
+    return DW_DLV_OK;
+}
+
+/*  With elfsectno zero this enables the index; names
+    added to DIEs from then on are recorded.
+    With a non-zero elfsectno it generates the section
+    (done by dwarf_transform_to_disk_form_a()). */
 int
 dwarf_force_dnames(Dwarf_P_Debug dbg,
     int elfsectno,
     Dwarf_Error * error)
 {
     Dwarf_P_Dnames dn;
-    Dwarf_Unsigned datalen = 0;
-    Dwarf_Unsigned withunitlength = 0;
-    unsigned char *data = 0;
-    unsigned char *startdata = 0;
-    unsigned int zero = 0;
-    struct Dwarf_P_Dnames_Head_s *dh = &staticdnames;
-    uintptr_t bytes = 0;
 
     if (dbg == NULL) {
         _dwarf_p_error(NULL, error, DW_DLE_DBG_NULL);
@@ -102,147 +640,21 @@ dwarf_force_dnames(Dwarf_P_Debug dbg,
     }
     if (!elfsectno) {
         dbg->de_force_dnames = TRUE;
+        if (dbg->de_dnames) {
+            return DW_DLV_OK;
+        }
         dn = (Dwarf_P_Dnames)
             _dwarf_p_get_alloc(dbg, sizeof(struct Dwarf_P_Dnames_s));
         if (dn == NULL) {
             _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
             return DW_DLV_ERROR;
         }
+        dn->dn_dbg = dbg;
         dbg->de_dnames = dn;
         return DW_DLV_OK;
     }
-    dn = dbg->de_dnames;
     if (!dbg->de_dnames) {
         return DW_DLV_NO_ENTRY;
     }
-    dn->dn_dbg = dbg;
-    dn->dn_create_section = TRUE;
-    datalen = 8*4 +
-        /* offset CU */
-        dh->dh_offset_size  +
-        /* str offsets, entry offsets */
-        dh->dh_offset_size *2 +
-        sizeof(abbrv) +
-        sizeof(entry);
-    withunitlength = datalen + 4;/* 4 byte length, 32 bit offset */
-
-    GET_CHUNK(dbg, dbg->de_elf_sects[DEBUG_NAMES],
-        data, (unsigned long)withunitlength, error);
-    startdata = data;
-
-    /*WRITE_UNALIGNED(dbg,dest,source, srclength,len_out)*/
-    /* 1 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&datalen,
-        sizeof(datalen) , SIZEOFT32);
-    data += SIZEOFT32;
-    /* 2 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_version,
-        sizeof(dh->dh_version),
-        SIZEOFT16);
-    data += SIZEOFT16;
-
-    /* 3 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&zero,sizeof(zero),
-        SIZEOFT16);
-    data += SIZEOFT16;
-
-    /* 4 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_comp_unit_count,
-        sizeof(dh->dh_comp_unit_count),
-        SIZEOFT32);
-    data += SIZEOFT32;
-    /* 5 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_local_type_unit_count,
-        sizeof(dh->dh_local_type_unit_count),
-        SIZEOFT32);
-    data += SIZEOFT32;
-    /* 6 */
-
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_foreign_type_unit_count,
-        sizeof(dh->dh_foreign_type_unit_count),
-        SIZEOFT32);
-    data += SIZEOFT32;
-    /* 7 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_bucket_count,
-        sizeof(dh->dh_bucket_count),
-        SIZEOFT32);
-    data += SIZEOFT32;
-    /* 8 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_name_count,
-        sizeof(dh->dh_name_count),
-        SIZEOFT32);
-    data += SIZEOFT32;
-
-    /* 9 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_abbrev_table_size,
-        sizeof(dh->dh_abbrev_table_size),
-        SIZEOFT32);
-    data += SIZEOFT32;
-
-    /* 10 */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dh->dh_augmentation_string_size,
-        sizeof(dh->dh_augmentation_string_size),
-        SIZEOFT32);
-    data += SIZEOFT32;
-    if (dh->dh_augmentation_string_size) {
-        /* 11 */
-        memcpy((void *)data,dh->dh_augmentation_string,
-            dh->dh_augmentation_string_size);
-        data += dh->dh_augmentation_string_size;
-        bytes = data - startdata;
-    }
-    bytes = data - startdata;
-
-    /*  The CU offset table. A single entry */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&zero,
-        sizeof(stroffsets[0]),
-        dh->dh_offset_size);
-    data +=  dh->dh_offset_size;
-    bytes = data - startdata;
-
-    /* Now the string offsets table */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&stroffsets[0],
-        sizeof(stroffsets[0]),
-        dh->dh_offset_size);
-    data +=  dh->dh_offset_size;
-    bytes = data - startdata;
-    /* Now the Entry Offsets (DIE offsets)  array */
-    WRITE_UNALIGNED(dbg, (void *)data,
-        (const void *)&dieoffset[0],
-        sizeof(dieoffset[0]),
-        dh->dh_offset_size);
-    data +=  dh->dh_offset_size;
-    bytes = data - startdata;
-
-    memcpy((void *)data,abbrv,sizeof(abbrv));
-    data += sizeof(abbrv);
-    bytes = data - startdata;
-
-    memcpy((void *)data,entry,sizeof(entry));
-    data += sizeof(entry);
-    bytes = data - startdata;
-    if (bytes != withunitlength) {
-        printf("FAIL writing debug_names "
-            "bytes written: %lu "
-            "bytes allocated: %lu\n",
-            (unsigned long)bytes,
-            (unsigned long)withunitlength);
-    }
-#if 0
-    dbg->de_dnames_blob = startdata;
-    dbg->de_dnames_bloblength = withunitlength;
-#endif
-    return DW_DLV_OK;
+    return _dwarf_pro_generate_debug_names(dbg,error);
 }
@@ -49,35 +49,47 @@ struct Dwarf_P_Dnames_Head_s {
     const char *dh_augmentation_string;
 };
 
-struct Dwarf_P_Dnames_uarray_s {
-    dn_type  dne_allocated;
-    dn_type  dne_used;
-    dn_type  *dne_values;
-};
-struct Dwarf_P_Dnames_sarray_s {
-    dn_type     dne_allocated;
-    dn_type     dne_used;
-    Dwarf_Sig8 *dne_values;
+/*  One DW_AT_name recorded as it was added to a DIE.
+    The string is already in .debug_str, so only
+    its offset is kept.  Once the DIE's CU is written
+    the DIE facts needed are copied here and dnn_die
+    is zeroed, as a streamed CU's DIEs are freed. */
+struct Dwarf_P_Dnames_Name_s {
+    Dwarf_P_Die    dnn_die;
+    Dwarf_Unsigned dnn_str_offset;
+    Dwarf_Unsigned dnn_hash;
+    Dwarf_Unsigned dnn_cu_index;
+    Dwarf_Unsigned dnn_die_offset;
+    Dwarf_Half     dnn_tag;
+    Dwarf_Small    dnn_indexed;
 };
 
 struct Dwarf_P_Dnames_s {
     Dwarf_Small dn_create_section;
     struct Dwarf_P_Dnames_Head_s dn_header;
-#if 0
-    struct Dwarf_P_Dnames_uarray_s dn_cunit_offset;
-    struct Dwarf_P_Dnames_uarray_s dn_tunit_offset;
-    struct Dwarf_P_Dnames_sarray_s dn_sunit_sigs;
-    struct Dwarf_P_Dnames_uarray_s dn_buckets;
-#endif
-    Dwarf_P_Debug                 dn_dbg;
+    Dwarf_P_Debug                dn_dbg;
 
-    /*  Hashes count applies to string offsets
-        and entry offsets arrays too. */
-    struct Dwarf_P_Dnames_uarray_s dn_hashes;
-    struct Dwarf_P_Dnames_uarray_s dn_string_offsets;
-    struct Dwarf_P_Dnames_uarray_s dn_entry_pool;
+    /*  Names in the order they were added.
+        Grown by doubling. */
+    struct Dwarf_P_Dnames_Name_s *dn_names;
+    Dwarf_Unsigned               dn_names_count;
+    Dwarf_Unsigned               dn_names_allocated;
+    /*  dn_names[0..dn_names_resolved) belong to
+        CUs already written. */
+    Dwarf_Unsigned               dn_names_resolved;
 
-    Dwarf_Small *dn_index_entry_pool;
-    Dwarf_Small  dn_index_entry_pool_size;
-    Dwarf_Small  dn_index_entry_pool_used;
+    /*  .debug_info offset of each CU written. */
+    Dwarf_Unsigned              *dn_cu_offsets;
+    Dwarf_Unsigned               dn_cu_count;
+    Dwarf_Unsigned               dn_cu_allocated;
 };
+
+int _dwarf_pro_dnames_add_name(Dwarf_P_Debug dbg,
+    Dwarf_P_Die die,
+    char *name,
+    Dwarf_Error *error);
+int _dwarf_pro_dnames_close_cu(Dwarf_P_Debug dbg,
+    Dwarf_Unsigned cu_offset,
+    Dwarf_Error *error);
+int _dwarf_pro_generate_debug_names(Dwarf_P_Debug dbg,
+    Dwarf_Error *error);
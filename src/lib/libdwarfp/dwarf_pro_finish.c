@@ -88,3 +88,30 @@ dwarf_pro_get_string_stats(Dwarf_P_Debug dbg,
     *strp_reused_len      = ps->ps_strp_reused_len;
     return DW_DLV_OK;
 }
+
+int
+dwarf_pro_get_string_stats_a(Dwarf_P_Debug dbg,
+    Dwarf_Unsigned * str_count,
+    Dwarf_Unsigned * str_total_length,
+    Dwarf_Unsigned * strp_count_debug_str,
+    Dwarf_Unsigned * strp_len_debug_str,
+    Dwarf_Unsigned * strp_reused_count,
+    Dwarf_Unsigned * strp_reused_len,
+    Dwarf_Unsigned * strp_tail_merged_count,
+    Dwarf_Unsigned * strp_tail_merged_len,
+    Dwarf_Error    * error)
+{
+    int res = 0;
+
+    res = dwarf_pro_get_string_stats(dbg,str_count,str_total_length,
+        strp_count_debug_str,strp_len_debug_str,
+        strp_reused_count,strp_reused_len,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    *strp_tail_merged_count =
+        dbg->de_stats.ps_strp.ps_strp_tail_merged_count;
+    *strp_tail_merged_len =
+        dbg->de_stats.ps_strp.ps_strp_tail_merged_len;
+    return DW_DLV_OK;
+}
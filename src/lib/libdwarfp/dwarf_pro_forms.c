@@ -45,6 +45,7 @@
 #include "dwarf_pro_alloc.h"
 #include "dwarf_pro_die.h"
 #include "dwarf_pro_expr.h"
+#include "dwarf_pro_dnames.h"
 
 #ifdef WORDS_BIGENDIAN
 #define ASNARD(t,s,l)                   \
@@ -206,6 +207,12 @@ local_add_AT_address_a(Dwarf_P_Debug dbg,
     WRITE_UNALIGNED(dbg, new_attr->ar_data,
         (const void *) &pc_value,
         sizeof(pc_value), upointer_size);
+    if (form == DW_FORM_addr && dbg->de_use_addrx &&
+        dbg->de_output_version >= 5) {
+        /*  Becomes DW_FORM_addrx1-4 when the CU is generated,
+            see dwarf_pro_index_forms.c */
+        dbg->de_need_debug_addr = TRUE;
+    }
 
     /* add attribute to the die */
     _dwarf_pro_add_at_to_die(ownerdie, new_attr);
@@ -403,7 +410,7 @@ dwarf_add_AT_block_a(
         _dwarf_p_get_alloc(dbg, len_size + block_size);
     if (new_attr->ar_data == NULL) {
         /* free the block we got earlier */
-        _dwarf_p_dealloc((unsigned char *) new_attr);
+        _dwarf_p_dealloc(dbg,(unsigned char *) new_attr);
         _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
         return DW_DLV_ERROR;
     }
@@ -1123,6 +1130,12 @@ dwarf_add_AT_string_a(Dwarf_P_Debug dbg,
     if (res != DW_DLV_OK) {
         return res;
     }
+    if (attr == DW_AT_name) {
+        res = _dwarf_pro_dnames_add_name(dbg,ownerdie,string,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+    }
 
     /* add attribute to the die */
     _dwarf_pro_add_at_to_die(ownerdie, new_attr);
@@ -68,6 +68,15 @@
 /* if this is not defined, we probably don't need it: just use 0 */
 #define SHF_MIPS_NOSTRIP 0
 #endif
+#ifndef SHF_COMPRESSED
+#define SHF_COMPRESSED 0x800
+#endif
+#ifndef ELFCOMPRESS_ZLIB
+#define ELFCOMPRESS_ZLIB 1
+#endif
+#ifndef ELFCOMPRESS_ZSTD
+#define ELFCOMPRESS_ZSTD 2
+#endif
 #ifndef R_MIPS_NONE
 #define R_MIPS_NONE 0
 #endif
@@ -0,0 +1,491 @@
+/*
+  Copyright (C) 2026 agent. All Rights Reserved.
+
+  This program is free software; you can redistribute it
+  and/or modify it under the terms of version 2.1 of the
+  GNU Lesser General Public License as published by the Free
+  Software Foundation.
+
+  This program is distributed in the hope that it would be
+  useful, but WITHOUT ANY WARRANTY; without even the implied
+  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+  Further, this software is distributed without any warranty
+  that it is free of the rightful claim of any third person
+  regarding infringement or the like.  Any license provided
+  herein, whether implied or otherwise, applies only to this
+  software file.  Patent licenses, if any, provided herein
+  do not apply to combinations of this program with other
+  software, or any other product whatsoever.
+
+  You should have received a copy of the GNU Lesser General
+  Public License along with this program; if not, write the
+  Free Software Foundation, Inc., 51 Franklin Street - Fifth
+  Floor, Boston MA 02110-1301, USA.
+
+*/
+
+/*  DWARF5 indexed strings and addresses.
+
+    A string added while the default string form is
+    DW_FORM_strx is put in .debug_str as for DW_FORM_strp,
+    but the attribute is left with form DW_FORM_strx
+    and no relocation.  With the "use_addrx" producer_init
+    extra every DW_FORM_addr attribute is likewise turned
+    into an index.
+
+    When a CU is generated each distinct string offset
+    and each distinct (symbol,address) pair gets one slot
+    in the CU's .debug_str_offsets or .debug_addr
+    contribution, and every attribute is rewritten to the
+    smallest of DW_FORM_strx1-4 or DW_FORM_addrx1-4 that
+    holds the CU's largest index.  The CU DIE gets
+    DW_AT_str_offsets_base and DW_AT_addr_base.
+    Only the table slots need relocations, one per
+    distinct value instead of one per attribute. */
+
+#include <config.h>
+
+#include <stddef.h> /* NULL */
+
+#include "dwarf.h"
+#include "libdwarfp.h"
+#include "dwarf_pro_incl.h"
+#include "dwarf_pro_opaque.h"
+#include "dwarf_pro_error.h"
+#include "dwarf_pro_alloc.h"
+#include "dwarf_pro_section.h"
+#include "dwarf_pro_die.h"
+
+static const Dwarf_Half strx_forms[4] = {
+    DW_FORM_strx1, DW_FORM_strx2, DW_FORM_strx3, DW_FORM_strx4};
+static const Dwarf_Half addrx_forms[4] = {
+    DW_FORM_addrx1, DW_FORM_addrx2, DW_FORM_addrx3, DW_FORM_addrx4};
+
+static Dwarf_Bool
+is_index_candidate(Dwarf_P_Debug dbg, Dwarf_P_Attribute attr)
+{
+    if (attr->ar_attribute_form == DW_FORM_strx) {
+        return TRUE;
+    }
+    if (attr->ar_attribute_form == DW_FORM_addr &&
+        dbg->de_need_debug_addr) {
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*  Depth first over the CU, as the generators walk it.
+    With attrs NULL only counts. */
+static Dwarf_Unsigned
+collect_index_attrs(Dwarf_P_Debug dbg, Dwarf_P_Die curdie,
+    Dwarf_P_Attribute *attrs)
+{
+    Dwarf_Unsigned count = 0;
+
+    while (curdie) {
+        Dwarf_P_Attribute attr = curdie->di_attrs;
+
+        for ( ; attr; attr = attr->ar_next) {
+            if (is_index_candidate(dbg,attr)) {
+                if (attrs) {
+                    attrs[count] = attr;
+                }
+                ++count;
+            }
+        }
+        if (curdie->di_child) {
+            curdie = curdie->di_child;
+            continue;
+        }
+        while (curdie && !curdie->di_right) {
+            curdie = curdie->di_parent;
+        }
+        if (curdie) {
+            curdie = curdie->di_right;
+        }
+    }
+    return count;
+}
+
+/*  The offset or address as WRITE_UNALIGNED stored it. */
+static Dwarf_Unsigned
+read_attr_value(Dwarf_P_Debug dbg, const char *src, unsigned len)
+{
+    Dwarf_Unsigned du = 0;
+
+#ifdef WORDS_BIGENDIAN
+    dbg->de_copy_word(((char *)&du) + sizeof(du) - len, src, len);
+#else /* LITTLE ENDIAN */
+    dbg->de_copy_word(&du, src, len);
+#endif /* BIG- LITTLE-ENDIAN */
+    return du;
+}
+
+static Dwarf_Unsigned
+index_hash(Dwarf_Unsigned a, Dwarf_Unsigned b)
+{
+    Dwarf_Unsigned h = (a ^ (b << 17)) * 0x9e3779b97f4a7c15ULL;
+
+    return h ^ (h >> 29);
+}
+
+/*  Bytes needed for indexes 0..count-1. */
+static int
+index_size(Dwarf_Unsigned count)
+{
+    if (count <= 0x100) {
+        return 1;
+    }
+    if (count <= 0x10000) {
+        return 2;
+    }
+    if (count <= 0x1000000) {
+        return 3;
+    }
+    if (count <= 0xffffffffULL) {
+        return 4;
+    }
+    return 0;
+}
+
+static int
+add_base_attr(Dwarf_P_Debug dbg,
+    Dwarf_P_Die cu_die,
+    Dwarf_Half attrnum,
+    int sect,
+    Dwarf_Unsigned base,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Attribute new_attr = 0;
+    int uwordb_size = dbg->de_dwarf_offset_size;
+
+    new_attr = (Dwarf_P_Attribute)
+        _dwarf_p_get_alloc(dbg, sizeof(struct Dwarf_P_Attribute_s));
+    if (new_attr == NULL) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_ATTR_ALLOC, DW_DLV_ERROR);
+    }
+    new_attr->ar_attribute = attrnum;
+    new_attr->ar_attribute_form = dbg->de_ar_data_attribute_form;
+    new_attr->ar_rel_type = dbg->de_offset_reloc;
+    new_attr->ar_rel_symidx = dbg->de_sect_name_idx[sect];
+    new_attr->ar_nbytes = uwordb_size;
+    new_attr->ar_next = NULL;
+    new_attr->ar_reloc_len = uwordb_size;
+    new_attr->ar_data = (char *)
+        _dwarf_p_get_alloc(dbg, uwordb_size);
+    if (new_attr->ar_data == NULL) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_ADDR_ALLOC, DW_DLV_ERROR);
+    }
+    WRITE_UNALIGNED(dbg, (void *) new_attr->ar_data,
+        (const void *) &base, sizeof(base), uwordb_size);
+    _dwarf_pro_add_at_to_die(cu_die, new_attr);
+    return DW_DLV_OK;
+}
+
+/*  Size of the .debug_str_offsets or .debug_addr
+    contribution header. Both are 8 (or 16) bytes. */
+static unsigned
+index_table_header_size(Dwarf_P_Debug dbg)
+{
+    unsigned extension_size = dbg->de_64bit_extension ? 4 : 0;
+
+    return extension_size + dbg->de_dwarf_offset_size +
+        DWARF_HALF_SIZE + 2;
+}
+
+/*  Called by the .debug_info generator before abbreviations
+    are chosen.  Assigns this CU's indexes and rewrites the
+    forms.  Returns DW_DLV_OK or DW_DLV_ERROR. */
+int
+_dwarf_pro_assign_index_forms(Dwarf_P_Debug dbg,
+    Dwarf_P_Die cu_die,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Attribute *attrs = 0;
+    Dwarf_Unsigned *indexes = 0;
+    Dwarf_Unsigned *slots = 0;
+    Dwarf_Unsigned nslots = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned nstr = 0;
+    Dwarf_Unsigned naddr = 0;
+    Dwarf_Unsigned i = 0;
+    int strsize = 0;
+    int addrsize = 0;
+    unsigned offset_size = dbg->de_dwarf_offset_size;
+    unsigned pointer_size = dbg->de_pointer_size;
+    int res = 0;
+
+    dbg->de_strx_count = 0;
+    dbg->de_addrx_count = 0;
+    if (!dbg->de_need_str_offsets && !dbg->de_need_debug_addr) {
+        return DW_DLV_OK;
+    }
+    count = collect_index_attrs(dbg,cu_die,0);
+    if (!count) {
+        return DW_DLV_OK;
+    }
+    nslots = 16;
+    while (nslots < 2*count) {
+        nslots <<= 1;
+    }
+    attrs = (Dwarf_P_Attribute *)_dwarf_p_get_alloc(dbg,
+        count * sizeof(Dwarf_P_Attribute));
+    indexes = (Dwarf_Unsigned *)_dwarf_p_get_alloc(dbg,
+        count * sizeof(Dwarf_Unsigned));
+    /*  Entry number + 1 of each slot, 0 if empty.  Strings
+        and addresses share the table; an entry number
+        at or above count is an address. */
+    slots = (Dwarf_Unsigned *)_dwarf_p_get_alloc(dbg,
+        nslots * sizeof(Dwarf_Unsigned));
+    dbg->de_strx_offsets = (Dwarf_Unsigned *)_dwarf_p_get_alloc(dbg,
+        count * sizeof(Dwarf_Unsigned));
+    dbg->de_addrx_entries = (struct Dwarf_P_Addrx_Entry_s *)
+        _dwarf_p_get_alloc(dbg,
+        count * sizeof(struct Dwarf_P_Addrx_Entry_s));
+    if (!attrs || !indexes || !slots || !dbg->de_strx_offsets ||
+        !dbg->de_addrx_entries) {
+        res = DW_DLE_ALLOC_FAIL;
+        goto fail;
+    }
+    collect_index_attrs(dbg,cu_die,attrs);
+
+    for (i = 0; i < count; ++i) {
+        Dwarf_P_Attribute attr = attrs[i];
+        Dwarf_Bool isstr = attr->ar_attribute_form == DW_FORM_strx;
+        Dwarf_Unsigned value = 0;
+        Dwarf_Unsigned symidx = 0;
+        Dwarf_Unsigned h = 0;
+
+        if (isstr) {
+            value = read_attr_value(dbg,attr->ar_data,offset_size);
+            symidx = ~(Dwarf_Unsigned)0;
+        } else {
+            value = read_attr_value(dbg,attr->ar_data,pointer_size);
+            symidx = attr->ar_rel_type != R_MIPS_NONE?
+                attr->ar_rel_symidx: NO_ELF_SYM_INDEX;
+        }
+        h = index_hash(value,symidx) & (nslots - 1);
+        for (;;) {
+            Dwarf_Unsigned e = slots[h];
+
+            if (!e) {
+                if (isstr) {
+                    dbg->de_strx_offsets[nstr] = value;
+                    slots[h] = nstr + 1;
+                    indexes[i] = nstr++;
+                } else {
+                    struct Dwarf_P_Addrx_Entry_s *ae =
+                        dbg->de_addrx_entries + naddr;
+
+                    ae->ae_value = value;
+                    ae->ae_symidx = symidx;
+                    ae->ae_relocate =
+                        attr->ar_rel_type != R_MIPS_NONE;
+                    slots[h] = count + naddr + 1;
+                    indexes[i] = naddr++;
+                }
+                break;
+            }
+            --e;
+            if (isstr && e < count &&
+                dbg->de_strx_offsets[e] == value) {
+                indexes[i] = e;
+                break;
+            }
+            if (!isstr && e >= count &&
+                dbg->de_addrx_entries[e - count].ae_value == value &&
+                dbg->de_addrx_entries[e - count].ae_symidx ==
+                symidx) {
+                indexes[i] = e - count;
+                break;
+            }
+            h = (h + 1) & (nslots - 1);
+        }
+    }
+    strsize = index_size(nstr);
+    addrsize = index_size(naddr);
+    if (!strsize || !addrsize) {
+        res = DW_DLE_OFFSET_UFLW;
+        goto fail;
+    }
+    for (i = 0; i < count; ++i) {
+        Dwarf_P_Attribute attr = attrs[i];
+        Dwarf_Unsigned idx = indexes[i];
+
+        if (attr->ar_attribute_form == DW_FORM_strx) {
+            attr->ar_attribute_form = strx_forms[strsize-1];
+            attr->ar_nbytes = strsize;
+        } else {
+            attr->ar_attribute_form = addrx_forms[addrsize-1];
+            attr->ar_nbytes = addrsize;
+        }
+        attr->ar_rel_type = R_MIPS_NONE;
+        attr->ar_reloc_len = 0;
+        WRITE_UNALIGNED(dbg, (void *) attr->ar_data,
+            (const void *) &idx, sizeof(idx), attr->ar_nbytes);
+    }
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)attrs);
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)indexes);
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)slots);
+    dbg->de_strx_count = nstr;
+    dbg->de_addrx_count = naddr;
+
+    /*  A streamed CU's contribution follows those of the
+        CUs already handed to the sink. */
+    if (nstr) {
+        res = add_base_attr(dbg,cu_die,DW_AT_str_offsets_base,
+            DEBUG_STR_OFFSETS,
+            dbg->de_stream_sect_offset[DEBUG_STR_OFFSETS] +
+            index_table_header_size(dbg),error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+    }
+    if (naddr) {
+        res = add_base_attr(dbg,cu_die,DW_AT_addr_base,
+            DEBUG_ADDR,
+            dbg->de_stream_sect_offset[DEBUG_ADDR] +
+            index_table_header_size(dbg),error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+    }
+    return DW_DLV_OK;
+
+fail:
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)attrs);
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)indexes);
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)slots);
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)dbg->de_strx_offsets);
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)dbg->de_addrx_entries);
+    dbg->de_strx_offsets = 0;
+    dbg->de_addrx_entries = 0;
+    _dwarf_p_error(dbg, error, res);
+    return DW_DLV_ERROR;
+}
+
+/*  Writes the header of one contribution, the second
+    half being the version and padding or sizes. */
+static int
+write_index_table_header(Dwarf_P_Debug dbg,
+    int sect,
+    Dwarf_Unsigned entry_count,
+    unsigned entry_size,
+    Dwarf_Small byte4,
+    Dwarf_Small byte5,
+    Dwarf_Error *error)
+{
+    unsigned offset_size = dbg->de_dwarf_offset_size;
+    unsigned extension_size = dbg->de_64bit_extension ? 4 : 0;
+    unsigned char *data = 0;
+    Dwarf_Unsigned du = 0;
+    Dwarf_Half version = 5;
+
+    GET_CHUNK_ERR(dbg, dbg->de_elf_sects[sect], data,
+        index_table_header_size(dbg), error);
+    if (extension_size) {
+        DISTINGUISHED_VALUE_ARRAY(v4);
+
+        WRITE_UNALIGNED(dbg, (void *) data,
+            (const void *) &v4[0], 4, extension_size);
+        data += extension_size;
+    }
+    /*  The length counts the version and the two bytes
+        after it. */
+    du = entry_count * entry_size + DWARF_HALF_SIZE + 2;
+    WRITE_UNALIGNED(dbg, (void *) data,
+        (const void *) &du, sizeof(du), offset_size);
+    data += offset_size;
+    WRITE_UNALIGNED(dbg, (void *) data,
+        (const void *) &version, sizeof(version), DWARF_HALF_SIZE);
+    data += DWARF_HALF_SIZE;
+    data[0] = byte4;
+    data[1] = byte5;
+    return DW_DLV_OK;
+}
+
+/*  Called by the .debug_info generator once the CU is
+    written: emits the CU's .debug_str_offsets and
+    .debug_addr contributions and their relocations. */
+int
+_dwarf_pro_generate_index_tables(Dwarf_P_Debug dbg,
+    Dwarf_Error *error)
+{
+    unsigned offset_size = dbg->de_dwarf_offset_size;
+    unsigned pointer_size = dbg->de_pointer_size;
+    Dwarf_Unsigned header_size = index_table_header_size(dbg);
+    Dwarf_Unsigned i = 0;
+    int res = 0;
+
+    if (dbg->de_strx_count) {
+        int elfsectno = dbg->de_elf_sects[DEBUG_STR_OFFSETS];
+
+        /*  DWARF5 section 7.26: version 5, two bytes
+            of padding. */
+        res = write_index_table_header(dbg,DEBUG_STR_OFFSETS,
+            dbg->de_strx_count,offset_size,0,0,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        for (i = 0; i < dbg->de_strx_count; ++i) {
+            unsigned char *data = 0;
+
+            GET_CHUNK_ERR(dbg, elfsectno, data, offset_size, error);
+            WRITE_UNALIGNED(dbg, (void *) data,
+                (const void *) &dbg->de_strx_offsets[i],
+                sizeof(Dwarf_Unsigned), offset_size);
+            res = dbg->de_relocate_by_name_symbol(dbg,
+                DEBUG_STR_OFFSETS,
+                header_size + i*offset_size,
+                dbg->de_sect_name_idx[DEBUG_STR],
+                dwarf_drt_data_reloc, offset_size);
+            if (res != DW_DLV_OK) {
+                DWARF_P_DBG_ERROR(dbg, DW_DLE_REL_ALLOC,
+                    DW_DLV_ERROR);
+            }
+        }
+    }
+    if (dbg->de_addrx_count) {
+        int elfsectno = dbg->de_elf_sects[DEBUG_ADDR];
+
+        /*  DWARF5 section 7.27: version 5, address size,
+            segment selector size. */
+        res = write_index_table_header(dbg,DEBUG_ADDR,
+            dbg->de_addrx_count,pointer_size,
+            (Dwarf_Small)pointer_size,0,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        for (i = 0; i < dbg->de_addrx_count; ++i) {
+            struct Dwarf_P_Addrx_Entry_s *ae =
+                dbg->de_addrx_entries + i;
+            unsigned char *data = 0;
+
+            GET_CHUNK_ERR(dbg, elfsectno, data, pointer_size, error);
+            WRITE_UNALIGNED(dbg, (void *) data,
+                (const void *) &ae->ae_value,
+                sizeof(ae->ae_value), pointer_size);
+            if (!ae->ae_relocate) {
+                continue;
+            }
+            res = dbg->de_relocate_by_name_symbol(dbg,
+                DEBUG_ADDR,
+                header_size + i*pointer_size,
+                ae->ae_symidx,
+                dwarf_drt_data_reloc, pointer_size);
+            if (res != DW_DLV_OK) {
+                DWARF_P_DBG_ERROR(dbg, DW_DLE_REL_ALLOC,
+                    DW_DLV_ERROR);
+            }
+        }
+    }
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)dbg->de_strx_offsets);
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)dbg->de_addrx_entries);
+    dbg->de_strx_offsets = 0;
+    dbg->de_addrx_entries = 0;
+    dbg->de_strx_count = 0;
+    dbg->de_addrx_count = 0;
+    return DW_DLV_OK;
+}
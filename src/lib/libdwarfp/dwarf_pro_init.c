@@ -61,7 +61,6 @@
 #include "dwarf_pro_section.h"        /* for MAGIC_SECT_NO */
 #include "dwarf_pro_reloc_symbolic.h"
 #include "dwarf_pro_reloc_stream.h"
-#include "dwarf_tsearch.h"
 #include "dwarf_string.h"
 
 #define IS_64BITPTR(dbg) ((dbg)->de_flags & DW_DLC_POINTER64 ? 1 : 0)
@@ -127,15 +126,25 @@ static int common_init(Dwarf_P_Debug dbg, Dwarf_Unsigned flags,
     /*  We want the following to have an elf section
         number that matches 'nothing' */
 static struct Dwarf_P_Section_Data_s init_sect = {
-    MAGIC_SECT_NO, 0, 0, 0, 0
-};
-static struct Dwarf_P_Section_Data_s init_sect_debug_str = {
-    MAGIC_SECT_NO, 0, 0, 0, 0
-};
-static struct Dwarf_P_Section_Data_s init_sect_debug_line_str = {
-    MAGIC_SECT_NO, 0, 0, 0, 0
+    MAGIC_SECT_NO, 0, 0, 0, 0, 0, 0
 };
 
+/*  The string sections accumulate their data in the
+    Dwarf_P_Section_Data itself, so unlike init_sect
+    each dbg needs its own. */
+static Dwarf_P_Section_Data
+new_string_sect(Dwarf_P_Debug dbg)
+{
+    Dwarf_P_Section_Data sd = (Dwarf_P_Section_Data)
+        _dwarf_p_get_alloc(dbg,
+        sizeof(struct Dwarf_P_Section_Data_s));
+
+    if (sd) {
+        sd->ds_elf_sect_no = MAGIC_SECT_NO;
+    }
+    return sd;
+}
+
 /*  New April 2014.
     Replaces all previous producer init functions.
     It adds a string to select the relevant ABI/ISA and
@@ -201,10 +210,11 @@ dwarf_producer_init(Dwarf_Unsigned flags,
 int
 dwarf_pro_set_default_string_form(Dwarf_P_Debug dbg,
     int form,
-    UNUSEDARG Dwarf_Error * error)
+    Dwarf_Error * error)
 {
     if (form != DW_FORM_string &&
-        form != DW_FORM_strp) {
+        form != DW_FORM_strp &&
+        (form != DW_FORM_strx || dbg->de_output_version < 5)) {
         _dwarf_p_error(dbg, error, DW_DLE_BAD_STRING_FORM);
         return DW_DLV_ERROR;
     }
@@ -246,45 +256,6 @@ set_reloc_numbers(Dwarf_P_Debug dbg,
     /* UNREACHED */
 }
 
-/*  This is the Daniel J Bernstein hash function
-    originally posted to Usenet news.
-    http://en.wikipedia.org/wiki/List_of_hash_functions or
-    http://stackoverflow.com/questions/\
-    10696223/reason-for-5381-number-in-djb-hash-function).
-    See Also DWARF5 Section 7.33
-*/
-static DW_TSHASHTYPE
-_dwarf_string_hashfunc(const char *str)
-{
-    DW_TSHASHTYPE up = 0;
-    DW_TSHASHTYPE hash = 5381;
-    int c  = 0;
-
-    /*  Extra parens suppress warning about assign in test. */
-    while ((c = *str++)) {
-        hash = hash * 33 + c ;
-    }
-    up = hash;
-    return up;
-}
-static DW_TSHASHTYPE
-key_simple_string_hashfunc(const void *keyp)
-{
-    struct Dwarf_P_debug_str_entry_s* mt =
-        (struct Dwarf_P_debug_str_entry_s*) keyp;
-    const char *str = 0;
-
-    if (mt->dse_has_table_offset) {
-        /*  ASSERT: mt->dse_dbg->de_debug_str->ds_data not zero. */
-        str = (const char *)mt->dse_dbg->de_debug_str->ds_data +
-            mt->dse_table_offset;
-    } else {
-        /*  ASSERT: dse_name != 0 */
-        str = (const char *)mt->dse_name;
-    }
-    return _dwarf_string_hashfunc(str);
-}
-
 static int
 common_init(Dwarf_P_Debug dbg,
     Dwarf_Unsigned flags,
@@ -299,8 +270,12 @@ common_init(Dwarf_P_Debug dbg,
     dbg->de_version_magic_number = PRO_VERSION_MAGIC;
     dbg->de_n_debug_sect = 0;
     dbg->de_debug_sects = &init_sect;
-    dbg->de_debug_str = &init_sect_debug_str;
-    dbg->de_debug_line_str = &init_sect_debug_line_str;
+    dbg->de_debug_str = new_string_sect(dbg);
+    dbg->de_debug_line_str = new_string_sect(dbg);
+    if (!dbg->de_debug_str || !dbg->de_debug_line_str) {
+        *err_ret = DW_DLE_ALLOC_FAIL;
+        return DW_DLV_ERROR;
+    }
     dbg->de_current_active_section = &init_sect;
     dbg->de_flags = flags;
 
@@ -391,12 +366,7 @@ common_init(Dwarf_P_Debug dbg,
 #endif /* DWARF_WITH_LIBELF */
     }
 
-    /* For .debug_str creation. */
-    dwarf_initialize_search_hash(&dbg->de_debug_str_hashtab,
-        key_simple_string_hashfunc,0);
     dbg->de_debug_default_str_form = DW_FORM_string;
-    dwarf_initialize_search_hash(&dbg->de_debug_line_str_hashtab,
-        key_simple_string_hashfunc,0);
 
     if (dbg->de_dwarf_offset_size == 8) {
         if (dbg->de_output_version <= 3) {
@@ -189,6 +189,31 @@ update_named_field(Dwarf_P_Debug dbg,
     } else if (!strcmp(name,"address_size")) {
         dbg->de_line_inits.pi_address_size = (unsigned)v;
         dbg->de_pointer_size = (unsigned)v;
+    } else if (!strcmp(name,"parallel_transform")) {
+        dbg->de_parallel_transform = (unsigned)v;
+    } else if (!strcmp(name,"str_tail_merge")) {
+        dbg->de_str_tail_merge = (unsigned)v;
+    } else if (!strcmp(name,"use_addrx")) {
+        dbg->de_use_addrx = (unsigned)v;
+    } else if (!strcmp(name,"optimize_line_program")) {
+        dbg->de_optimize_line_program = (unsigned)v;
+    } else if (!strcmp(name,"compress_debug_sections")) {
+        /*  The ELF ch_type: 1 zlib, 2 zstd. Refused here
+            if this build cannot do it. */
+        switch (v) {
+        case 0:
+#ifdef HAVE_ZLIB
+        case ELFCOMPRESS_ZLIB:
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+        case ELFCOMPRESS_ZSTD:
+#endif /* HAVE_ZSTD */
+            dbg->de_compress_sections = (unsigned)v;
+            break;
+        default:
+            *err = DW_DLE_PRO_COMPRESS_UNSUPPORTED;
+            return DW_DLV_ERROR;
+        }
     } else {
 #ifdef TESTING
         printf("ERROR  due to unknown string \"%s\", line %d %s\n",
@@ -28,6 +28,9 @@
 */
 
 #include "libdwarf_private.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #define TRUE                    1
 #define FALSE                   0
@@ -130,9 +133,11 @@ typedef struct Dwarf_P_Dnames_s *Dwarf_P_Dnames;
 #define         DEBUG_LOCLISTS  19 /* DWARF 5. */
 #define         DEBUG_RNGLISTS  20 /* DWARF 5. */
 #define         DEBUG_SUP       21 /* DWARF 5. */
+#define         DEBUG_STR_OFFSETS 22 /* DWARF 5. */
+#define         DEBUG_ADDR      23 /* DWARF 5. */
 
 /* Maximum number of debug_* sections not including the relocations */
-#define         NUM_DEBUG_SECTIONS      22
+#define         NUM_DEBUG_SECTIONS      24
 
 /*  The FORM codes available are defined in DWARF5
     on page 158, DW_LNCT_path  */
@@ -355,6 +360,14 @@ typedef struct memory_list_s {
     struct memory_list_s *next;
 } memory_list_t;
 
+/*  Objects up to PRO_ARENA_MAX_OBJECT bytes are carved from
+    PRO_ARENA_BLOCK_SIZE blocks, in size classes of
+    PRO_ARENA_ALIGN bytes. */
+#define PRO_ARENA_ALIGN        8
+#define PRO_ARENA_MAX_OBJECT   256
+#define PRO_ARENA_CLASSES      (PRO_ARENA_MAX_OBJECT/PRO_ARENA_ALIGN + 1)
+#define PRO_ARENA_BLOCK_SIZE   65536
+
 struct Dwarf_P_Per_Sect_String_Attrs_s {
     int sect_sa_section_number;
     unsigned sect_sa_n_alloc;
@@ -362,20 +375,34 @@ struct Dwarf_P_Per_Sect_String_Attrs_s {
     Dwarf_P_String_Attr sect_sa_list;
 };
 
-struct Dwarf_P_debug_str_entry_s {
-    Dwarf_P_Debug  dse_dbg;
-    /*  Name used initially with tfind. */
-    char *dse_name;
-
-    Dwarf_Unsigned dse_slen; /* includes space for NUL terminator */
+/*  A slot of a string intern table.  The string is at
+    sie_offset in the string section data. */
+struct Dwarf_P_Str_Intern_Entry_s {
+    Dwarf_Unsigned sie_hash;
+    Dwarf_Unsigned sie_offset;
+    Dwarf_Unsigned sie_slen; /* includes NUL; 0 means empty slot */
+};
 
-    /*  See dse_has_table_offset below. */
-    Dwarf_Unsigned dse_table_offset;
+/*  Bytes of one output section already given to the
+    dwarf_pro_set_section_sink() sink. */
+struct Dwarf_P_Sink_Sect_s {
+    int            ss_elf_sect_no;
+    Dwarf_Unsigned ss_offset;
+};
+/*  The DWARF sections and their relocation sections. */
+#define PRO_SINK_SECTS_MAX (2*NUM_DEBUG_SECTIONS)
+
+/*  One .debug_addr entry of the CU being generated. */
+struct Dwarf_P_Addrx_Entry_s {
+    Dwarf_Unsigned ae_value;
+    Dwarf_Unsigned ae_symidx;
+    Dwarf_Bool     ae_relocate;
+};
 
-    /*  For tsearch a hash table exists and we have a table offset.
-        dse_dbg->de_debug_str->ds_data + dse_table_offset
-        points to the string iff dse_has_table_offset != 0. */
-    unsigned char  dse_has_table_offset;
+struct Dwarf_P_Str_Intern_s {
+    struct Dwarf_P_Str_Intern_Entry_s *si_slots;
+    Dwarf_Unsigned si_size;  /* 0 or a power of two */
+    Dwarf_Unsigned si_count;
 };
 
 struct Dwarf_P_Str_stats_s {
@@ -384,6 +411,10 @@ struct Dwarf_P_Str_stats_s {
     Dwarf_Unsigned ps_strp_len_debug_line_str;
     Dwarf_Unsigned ps_strp_reused_count;
     Dwarf_Unsigned ps_strp_reused_len;
+    /*  Strings placed inside another string by the
+        str_tail_merge pass, and the bytes that saved. */
+    Dwarf_Unsigned ps_strp_tail_merged_count;
+    Dwarf_Unsigned ps_strp_tail_merged_len;
 };
 
 struct Dwarf_P_Stats_s {
@@ -426,11 +457,11 @@ struct Dwarf_P_Debug_s {
 
     /* If form DW_FORM_strp */
     Dwarf_P_Section_Data de_debug_str;
-    void *de_debug_str_hashtab; /* for tsearch */
+    struct Dwarf_P_Str_Intern_s de_debug_str_intern;
 
     /* .debug_line_str section data if form DW_FORM_line_strp */
     Dwarf_P_Section_Data de_debug_line_str;
-    void *de_debug_line_str_hashtab; /* for tsearch */
+    struct Dwarf_P_Str_Intern_s de_debug_line_str_intern;
 
     /*  Pointer to the 'current active' section */
     Dwarf_P_Section_Data de_current_active_section;
@@ -584,6 +615,96 @@ struct Dwarf_P_Debug_s {
     struct Dwarf_P_Line_Inits_s de_line_inits;
 
     struct Dwarf_P_Stats_s de_stats;
+
+    /*  The abbreviation list.  Kept across CUs so that
+        per-CU streaming can share one abbrev table among
+        CUs that add no new abbreviations. */
+    struct Dwarf_P_Abbrev_s *de_abbrev_head;
+    struct Dwarf_P_Abbrev_s *de_abbrev_tail;
+    /*  Every abbrev in the list above, hashed on
+        tag, children and the attribute/form list. */
+    struct Dwarf_P_Abbrev_s **de_abbrev_hashtab;
+    Dwarf_Unsigned de_abbrev_hashtab_size;
+    Dwarf_Unsigned de_abbrev_hashtab_count;
+    /*  For dwarf_pro_get_abbrev_stats(). */
+    Dwarf_Unsigned de_abbrev_lookups;
+    Dwarf_Unsigned de_abbrev_hits;
+    Dwarf_Unsigned de_abbrev_compares;
+    int de_n_abbrevs;
+
+    /*  Per-CU streaming, see
+        dwarf_transform_cu_to_disk_form_a().
+        de_stream_sect_offset[] counts the bytes of each
+        section already handed to the caller's sink.  */
+    Dwarf_Bool     de_stream_active;
+    Dwarf_Small    de_sect_created[NUM_DEBUG_SECTIONS];
+    Dwarf_Unsigned de_stream_sect_offset[NUM_DEBUG_SECTIONS];
+    Dwarf_Unsigned de_stream_abbrev_offset;
+    int            de_stream_abbrev_count;
+    /*  Last FDE verified not to refer to a DIE. */
+    struct Dwarf_P_Fde_s *de_stream_fde_checked;
+
+    /*  Bump arena for small objects from _dwarf_p_get_alloc(),
+        with free lists by size class so individually
+        freed objects are reused.  See dwarf_pro_alloc.c */
+    char *de_arena_next;
+    char *de_arena_end;
+    struct Dwarf_P_Arena_Free_s *de_arena_free[PRO_ARENA_CLASSES];
+
+    /*  Set by the "parallel_transform" producer_init extra. */
+    unsigned de_parallel_transform;
+    /*  Set by the "str_tail_merge" producer_init extra. */
+    unsigned de_str_tail_merge;
+    /*  Set by the "compress_debug_sections" producer_init
+        extra: 0, ELFCOMPRESS_ZLIB or ELFCOMPRESS_ZSTD.
+        See dwarf_pro_compress.c */
+    unsigned de_compress_sections;
+    /*  TRUE for the sections actually compressed, as a
+        section compression would not shrink is left as
+        it is. */
+    Dwarf_Small de_sect_compressed[NUM_DEBUG_SECTIONS];
+    /*  Set by the "use_addrx" producer_init extra. */
+    unsigned de_use_addrx;
+    /*  Set by the "optimize_line_program" producer_init
+        extra: choose line_base and line_range per line
+        program and the smallest opcodes for each row. */
+    unsigned de_optimize_line_program;
+    /*  Set once a DW_FORM_strx string or (with use_addrx)
+        a DW_FORM_addr attribute has been added, so the
+        section is created.  */
+    Dwarf_Bool de_need_str_offsets;
+    Dwarf_Bool de_need_debug_addr;
+    /*  The .debug_str_offsets and .debug_addr entries of
+        the CU being generated, each used once.
+        See dwarf_pro_index_forms.c */
+    Dwarf_Unsigned *de_strx_offsets;
+    Dwarf_Unsigned  de_strx_count;
+    struct Dwarf_P_Addrx_Entry_s *de_addrx_entries;
+    Dwarf_Unsigned  de_addrx_count;
+    /*  Set by dwarf_pro_set_section_sink().  While
+        de_sink_direct, _dwarf_pro_buffer() hands each chunk
+        to de_sink once it is full instead of keeping the
+        chunk list; chunks a generator will still patch
+        wait on de_sink_held. */
+    Dwarf_P_Section_Sink de_sink;
+    void *de_sink_data;
+    Dwarf_Bool de_sink_direct;
+    Dwarf_Bool de_sink_failed;
+    Dwarf_P_Section_Data de_sink_current;
+    Dwarf_P_Section_Data de_sink_held;
+    struct Dwarf_P_Sink_Sect_s de_sink_sects[PRO_SINK_SECTS_MAX];
+    int de_sink_sect_count;
+    /*  While a worker thread generates the section numbered
+        de_par_elf_sect_no its chunks go on this private list
+        (see _dwarf_pro_buffer()) and allocation is locked. */
+    Dwarf_Bool de_par_active;
+    int de_par_elf_sect_no;
+    Dwarf_P_Section_Data de_par_first;
+    Dwarf_P_Section_Data de_par_current;
+    Dwarf_Signed de_par_count;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_t de_alloc_lock;
+#endif /* HAVE_PTHREAD_H */
 };
 
 #define VERSION_STAMP2   2
@@ -609,6 +730,8 @@ _dwarf_insert_or_find_in_debug_str(Dwarf_P_Debug dbg,
     Dwarf_Unsigned *offset_in_debug_str,
     Dwarf_Error *error);
 
+void _dwarf_pro_free_str_intern(struct Dwarf_P_Str_Intern_s *si);
+
 int _dwarf_log_extra_flagstrings(Dwarf_P_Debug dbg,
     const char *extra,
     int *err);
@@ -85,8 +85,6 @@ const char *_dwarf_rel_section_names[] = {
     /* Nothing here refers to anything.*/
     REL_SEC_PREFIX ".debug_str",
 
-    REL_SEC_PREFIX ".debug_rnglists",   /* DWARF5. */
-
     /* DWARF5. Nothing referselsewhere */
     REL_SEC_PREFIX ".debug_line_str",
 
@@ -94,6 +92,8 @@ const char *_dwarf_rel_section_names[] = {
     REL_SEC_PREFIX ".debug_loclists",   /* DWARF5. */
     REL_SEC_PREFIX ".debug_rnglists",   /* DWARF5. */
     REL_SEC_PREFIX ".debug_sup",   /* DWARF5. No relocs on this */
+    REL_SEC_PREFIX ".debug_str_offsets", /* DWARF5. */
+    REL_SEC_PREFIX ".debug_addr",       /* DWARF5. */
 };
 
 /*  names of sections. Ensure that it matches the defines
@@ -123,6 +123,8 @@ const char *_dwarf_sectnames[] = {
     ".debug_loclists",          /* new in DWARF5 */
     ".debug_rnglists",          /* new in DWARF5 */
     ".debug_sup",               /* new in DWARF5 */
+    ".debug_str_offsets",       /* new in DWARF5 */
+    ".debug_addr",              /* new in DWARF5 */
 };
 
 static const Dwarf_Ubyte std_opcode_len[] = { 0, /* DW_LNS_copy */
@@ -172,6 +174,14 @@ static int _dwarf_pro_generate_debuginfo(Dwarf_P_Debug dbg,
     Dwarf_Signed *nbufs, Dwarf_Error * error);
 static int _dwarf_pro_generate_debugsup(Dwarf_P_Debug dbg,
     Dwarf_Signed *nbufs, Dwarf_Error * error);
+static int sink_deliver(Dwarf_P_Debug dbg,
+    Dwarf_P_Section_Data cursect);
+static int sink_retire(Dwarf_P_Debug dbg,
+    Dwarf_P_Section_Data cursect);
+static int sink_deliver_list(Dwarf_P_Debug dbg,
+    Dwarf_P_Section_Data cursect);
+static Dwarf_Unsigned *sink_sect_offset(Dwarf_P_Debug dbg,
+    int elfsectno);
 
 #if 0
 static void
@@ -303,12 +313,196 @@ dwarf_need_debug_names_section(Dwarf_P_Debug dbg)
     return dbg->de_force_dnames;
 }
 
-/*  Convert debug information to  a format such that
-    it can be written on disk.
-    Called exactly once per execution.
-*/
-int
-dwarf_transform_to_disk_form_a(Dwarf_P_Debug dbg, Dwarf_Signed *count,
+/*  Ask the caller (de_callback_func) for the elf section
+    number of section sect.  Done once per section, whether
+    the section is first needed by
+    dwarf_transform_cu_to_disk_form_a() or by
+    dwarf_transform_to_disk_form_a(). */
+static int
+create_debug_section(Dwarf_P_Debug dbg,
+    int sect,
+    long flags,
+    Dwarf_Error *error)
+{
+    int new_base_elf_sect = 0;
+    int err = 0;
+    Dwarf_Unsigned du = 0;
+
+    if (dbg->de_sect_created[sect]) {
+        return DW_DLV_OK;
+    }
+    if (dbg->de_compress_sections) {
+        flags |= SHF_COMPRESSED;
+    }
+    if (dbg->de_callback_func) {
+        new_base_elf_sect =
+            dbg->de_callback_func(_dwarf_sectnames[sect],
+                /* rec size */ 1,
+                SECTION_TYPE,
+                flags, SHN_UNDEF, 0, &du,
+                dbg->de_user_data, &err);
+    }
+    if (new_base_elf_sect == -1) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_ELF_SECT_ERR,
+            DW_DLV_ERROR);
+    }
+    dbg->de_elf_sects[sect] = new_base_elf_sect;
+    dbg->de_sect_name_idx[sect] = du;
+    dbg->de_sect_created[sect] = TRUE;
+    return DW_DLV_OK;
+}
+
+/*  The generators that follow .debug_line in the
+    output.  Changing the order in which the sections
+    are generated may cause problems because of
+    relocations, and changes the output. */
+static int
+generate_frame_macro_info(Dwarf_P_Debug dbg,
+    Dwarf_Signed *nbufs,
+    Dwarf_Error *error)
+{
+    if (dbg->de_frame_cies) {
+        int res = _dwarf_pro_generate_debugframe(dbg,nbufs,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+    }
+    if (dbg->de_first_macinfo) {
+        /* For DWARF 2,3,4 only */
+        /* Need new code for DWARF5 macro info. FIXME*/
+        int res  = _dwarf_pro_transform_macro_info_to_disk(dbg,
+            nbufs,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+    }
+
+    if (dbg->de_dies) {
+        int res= _dwarf_pro_generate_debuginfo(dbg, nbufs, error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+    }
+    return DW_DLV_OK;
+}
+
+#ifdef HAVE_PTHREAD_H
+struct line_worker_s {
+    Dwarf_P_Debug lw_dbg;
+    int           lw_res;
+    Dwarf_Error   lw_error;
+};
+
+static void *
+line_worker(void *arg)
+{
+    struct line_worker_s *lw = (struct line_worker_s *)arg;
+    Dwarf_Signed nbufs = 0;
+
+    lw->lw_res = _dwarf_pro_generate_debugline(lw->lw_dbg,
+        &nbufs,&lw->lw_error);
+    return 0;
+}
+
+/*  .debug_line does not depend on the other sections
+    (DW_AT_stmt_list is a fixed offset), so with the
+    "parallel_transform" option a worker thread builds it
+    while this thread builds .debug_frame, macinfo and
+    .debug_info.  The worker's chunks are kept apart and
+    spliced in where the serial transform would have put
+    them, so the output is byte-identical.
+    Returns DW_DLV_NO_ENTRY if no thread could be started,
+    and the caller then does the serial transform. */
+static int
+generate_line_in_parallel(Dwarf_P_Debug dbg,
+    Dwarf_Signed *nbufs,
+    Dwarf_Error *error)
+{
+    struct line_worker_s lw;
+    pthread_t thread;
+    Dwarf_P_Section_Data tail = 0;
+    int res = 0;
+
+    if (pthread_mutex_init(&dbg->de_alloc_lock,0)) {
+        return DW_DLV_NO_ENTRY;
+    }
+    memset(&lw,0,sizeof(lw));
+    lw.lw_dbg = dbg;
+    if (dbg->de_debug_sects->ds_elf_sect_no != MAGIC_SECT_NO) {
+        tail = dbg->de_current_active_section;
+    }
+    dbg->de_par_elf_sect_no = dbg->de_elf_sects[DEBUG_LINE];
+    dbg->de_par_first = 0;
+    dbg->de_par_current = 0;
+    dbg->de_par_count = 0;
+    dbg->de_par_active = TRUE;
+    if (pthread_create(&thread,0,line_worker,&lw)) {
+        dbg->de_par_active = FALSE;
+        pthread_mutex_destroy(&dbg->de_alloc_lock);
+        return DW_DLV_NO_ENTRY;
+    }
+    res = generate_frame_macro_info(dbg,nbufs,error);
+    pthread_join(thread,0);
+    dbg->de_par_active = FALSE;
+    pthread_mutex_destroy(&dbg->de_alloc_lock);
+
+    if (dbg->de_par_first && dbg->de_sink_direct) {
+        int sres = sink_deliver_list(dbg,dbg->de_par_first);
+
+        dbg->de_par_first = 0;
+        dbg->de_par_current = 0;
+        dbg->de_par_count = 0;
+        if (sres != DW_DLV_OK && res == DW_DLV_OK &&
+            lw.lw_res != DW_DLV_ERROR) {
+            DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+                DW_DLV_ERROR);
+        }
+    } else if (dbg->de_par_first) {
+        Dwarf_P_Section_Data first = dbg->de_par_first;
+        Dwarf_P_Section_Data last = dbg->de_par_current;
+
+        if (tail) {
+            last->ds_next = tail->ds_next;
+            tail->ds_next = first;
+            if (dbg->de_current_active_section == tail) {
+                dbg->de_current_active_section = last;
+            }
+        } else if (dbg->de_debug_sects->ds_elf_sect_no ==
+            MAGIC_SECT_NO) {
+            dbg->de_debug_sects = first;
+            dbg->de_current_active_section = last;
+            dbg->de_first_debug_sect = first;
+        } else {
+            last->ds_next = dbg->de_first_debug_sect;
+            dbg->de_debug_sects = first;
+            dbg->de_first_debug_sect = first;
+        }
+        dbg->de_n_debug_sect += dbg->de_par_count;
+        dbg->de_par_first = 0;
+        dbg->de_par_current = 0;
+        dbg->de_par_count = 0;
+    }
+    *nbufs = dbg->de_n_debug_sect;
+    if (lw.lw_res == DW_DLV_ERROR) {
+        /*  As in the serial transform the .debug_line
+            error is the one reported. */
+        Dwarf_Unsigned errval = (Dwarf_Unsigned)
+            lw.lw_error->er_errval;
+
+        if (res == DW_DLV_ERROR && error && *error) {
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)*error);
+            *error = 0;
+        }
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)lw.lw_error);
+        _dwarf_p_error(dbg,error,errval);
+        return DW_DLV_ERROR;
+    }
+    return res;
+}
+#endif /* HAVE_PTHREAD_H */
+
+static int
+transform_to_disk(Dwarf_P_Debug dbg, Dwarf_Signed *count,
     Dwarf_Error * error)
 {
     /*  Section data in written out in a number of buffers. Each
@@ -319,12 +513,16 @@ dwarf_transform_to_disk_form_a(Dwarf_P_Debug dbg, Dwarf_Signed *count,
         buffers one at a time. */
     Dwarf_Signed nbufs = 0;
     int sect = 0;
-    int err = 0;
-    Dwarf_Unsigned du = 0;
 
     if (dbg->de_version_magic_number != PRO_VERSION_MAGIC) {
         DWARF_P_DBG_ERROR(dbg, DW_DLE_IA, DW_DLV_ERROR);
     }
+    if (dbg->de_stream_active && dbg->de_dies) {
+        /*  Once CUs are streamed every CU must be
+            streamed: the last one was not. */
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+            DW_DLV_ERROR);
+    }
 
     /* Create dwarf section headers */
     for (sect = 0; sect < NUM_DEBUG_SECTIONS; sect++) {
@@ -449,27 +647,28 @@ dwarf_transform_to_disk_form_a(Dwarf_P_Debug dbg, Dwarf_Signed *count,
             }
             /* Not handled yet. */
             continue;
+        case DEBUG_STR_OFFSETS:
+            if (dbg->de_dies == NULL ||
+                !dbg->de_need_str_offsets) {
+                continue;
+            }
+            break;
+        case DEBUG_ADDR:
+            if (dbg->de_dies == NULL ||
+                !dbg->de_need_debug_addr) {
+                continue;
+            }
+            break;
         default:
             /* logic error: missing a case */
             DWARF_P_DBG_ERROR(dbg, DW_DLE_ELF_SECT_ERR, DW_DLV_ERROR);
         }
         {
-            int new_base_elf_sect = 0;
-
-            if (dbg->de_callback_func) {
-                new_base_elf_sect =
-                    dbg->de_callback_func(_dwarf_sectnames[sect],
-                        /* rec size */ 1,
-                        SECTION_TYPE,
-                        flags, SHN_UNDEF, 0, &du,
-                        dbg->de_user_data, &err);
-            }
-            if (new_base_elf_sect == -1) {
-                DWARF_P_DBG_ERROR(dbg, DW_DLE_ELF_SECT_ERR,
-                    DW_DLV_ERROR);
+            int res = create_debug_section(dbg,sect,flags,error);
+
+            if (res != DW_DLV_OK) {
+                return res;
             }
-            dbg->de_elf_sects[sect] = new_base_elf_sect;
-            dbg->de_sect_name_idx[sect] = du;
         }
     }
 
@@ -479,39 +678,44 @@ dwarf_transform_to_disk_form_a(Dwarf_P_Debug dbg, Dwarf_Signed *count,
         are generated may cause
         problems because of relocations. */
 
-    if (dbg->de_debug_sup.ds_version) {
-        int res = _dwarf_pro_generate_debugsup(dbg,
-            &nbufs, error);
+    {
+        /*  Before any .debug_str offset is written out. */
+        int res = _dwarf_pro_tail_merge_debug_str(dbg,error);
         if (res == DW_DLV_ERROR) {
             return res;
         }
     }
-
-    if (dwarf_need_debug_line_section(dbg) == TRUE) {
-        int res = _dwarf_pro_generate_debugline(dbg,&nbufs, error);
+    if (dbg->de_debug_sup.ds_version) {
+        int res = _dwarf_pro_generate_debugsup(dbg,
+            &nbufs, error);
         if (res == DW_DLV_ERROR) {
             return res;
         }
     }
 
-    if (dbg->de_frame_cies) {
-        int res = _dwarf_pro_generate_debugframe(dbg,&nbufs,error);
-        if (res == DW_DLV_ERROR) {
-            return res;
+    {
+        int res = DW_DLV_NO_ENTRY;
+        Dwarf_Bool need_line =
+            dwarf_need_debug_line_section(dbg) == TRUE &&
+            !dbg->de_stream_active;
+
+#ifdef HAVE_PTHREAD_H
+        if (need_line && dbg->de_parallel_transform &&
+            dbg->de_dies) {
+            /*  Generates frame, macro and info too. */
+            res = generate_line_in_parallel(dbg,&nbufs,error);
         }
-    }
-    if (dbg->de_first_macinfo) {
-        /* For DWARF 2,3,4 only */
-        /* Need new code for DWARF5 macro info. FIXME*/
-        int res  = _dwarf_pro_transform_macro_info_to_disk(dbg,
-            &nbufs,error);
-        if (res == DW_DLV_ERROR) {
-            return res;
+#endif /* HAVE_PTHREAD_H */
+        if (res == DW_DLV_NO_ENTRY) {
+            if (need_line) {
+                res = _dwarf_pro_generate_debugline(dbg,&nbufs,
+                    error);
+                if (res == DW_DLV_ERROR) {
+                    return res;
+                }
+            }
+            res = generate_frame_macro_info(dbg,&nbufs,error);
         }
-    }
-
-    if (dbg->de_dies) {
-        int res= _dwarf_pro_generate_debuginfo(dbg, &nbufs, error);
         if (res == DW_DLV_ERROR) {
             return res;
         }
@@ -631,6 +835,12 @@ dwarf_transform_to_disk_form_a(Dwarf_P_Debug dbg, Dwarf_Signed *count,
         }
     }
 #endif
+    if (dbg->de_compress_sections) {
+        int res = _dwarf_pro_compress_sections(dbg,&nbufs,error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+    }
 
     {
         Dwarf_Signed new_chunks = 0;
@@ -647,6 +857,386 @@ dwarf_transform_to_disk_form_a(Dwarf_P_Debug dbg, Dwarf_Signed *count,
     return DW_DLV_OK;
 }
 
+/*  Return the section (DEBUG_INFO etc) a streamed chunk
+    belongs to.  Only the sections a CU writes are
+    candidates. */
+static int
+stream_section_of(Dwarf_P_Debug dbg, int elfsectno)
+{
+    if (elfsectno == dbg->de_elf_sects[DEBUG_INFO]) {
+        return DEBUG_INFO;
+    }
+    if (elfsectno == dbg->de_elf_sects[DEBUG_ABBREV]) {
+        return DEBUG_ABBREV;
+    }
+    if (dbg->de_sect_created[DEBUG_STR_OFFSETS] &&
+        elfsectno == dbg->de_elf_sects[DEBUG_STR_OFFSETS]) {
+        return DEBUG_STR_OFFSETS;
+    }
+    if (dbg->de_sect_created[DEBUG_ADDR] &&
+        elfsectno == dbg->de_elf_sects[DEBUG_ADDR]) {
+        return DEBUG_ADDR;
+    }
+    return DEBUG_LINE;
+}
+
+/*  Hand this round's relocations for sect to the sink,
+    with offsets made relative to the section start. */
+static int
+stream_relocations(Dwarf_P_Debug dbg, int sect,
+    Dwarf_P_Section_Sink sink, void *sink_data)
+{
+    Dwarf_P_Per_Reloc_Sect prel = &dbg->de_reloc_sect[sect];
+    struct Dwarf_P_Relocation_Block_s *blk = prel->pr_first_block;
+    Dwarf_Unsigned base = dbg->de_stream_sect_offset[sect];
+
+    while (blk) {
+        struct Dwarf_P_Relocation_Block_s *next = blk->rb_next;
+        Dwarf_Relocation_Data rd =
+            (Dwarf_Relocation_Data)blk->rb_data;
+        Dwarf_Unsigned n = blk->rb_next_slot_to_use;
+        Dwarf_Unsigned i = 0;
+
+        for ( ; i < n; ++i) {
+            rd[i].drd_offset += base;
+        }
+        if (n) {
+            int res = sink(dbg->de_elf_sects[sect],base,0,0,
+                rd,n,sink_data);
+            if (res != DW_DLV_OK) {
+                return DW_DLV_ERROR;
+            }
+        }
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)blk);
+        blk = next;
+    }
+    prel->pr_first_block = 0;
+    prel->pr_last_block = 0;
+    prel->pr_block_count = 0;
+    prel->pr_reloc_total_count = 0;
+    return DW_DLV_OK;
+}
+
+/*  Deliver what dwarf_transform_to_disk_form_a() left:
+    the last chunk, and with compression the whole
+    chunk list, which is then emptied. */
+static int
+sink_flush(Dwarf_P_Debug dbg, Dwarf_P_Section_Data sentinel)
+{
+    Dwarf_P_Section_Data cursect = dbg->de_sink_current;
+    int res = DW_DLV_OK;
+
+    dbg->de_sink_current = 0;
+    if (cursect) {
+        res = sink_retire(dbg,cursect);
+    }
+    /*  Normally empty: generators release what they hold. */
+    cursect = dbg->de_sink_held;
+    dbg->de_sink_held = 0;
+    while (cursect) {
+        Dwarf_P_Section_Data next = cursect->ds_next;
+
+        if (res == DW_DLV_OK) {
+            res = sink_deliver(dbg,cursect);
+        } else {
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)cursect);
+        }
+        cursect = next;
+    }
+    if (dbg->de_debug_sects->ds_elf_sect_no != MAGIC_SECT_NO) {
+        cursect = dbg->de_first_debug_sect;
+        dbg->de_debug_sects = sentinel;
+        dbg->de_current_active_section = sentinel;
+        dbg->de_first_debug_sect = 0;
+        dbg->de_n_debug_sect = 0;
+        if (res == DW_DLV_OK) {
+            res = sink_deliver_list(dbg,cursect);
+        } else {
+            while (cursect) {
+                Dwarf_P_Section_Data next = cursect->ds_next;
+
+                _dwarf_p_dealloc(dbg,(Dwarf_Small *)cursect);
+                cursect = next;
+            }
+        }
+    }
+    return res;
+}
+
+int
+dwarf_pro_set_section_sink(Dwarf_P_Debug dbg,
+    Dwarf_P_Section_Sink sink,
+    void *sink_data,
+    Dwarf_Error *error)
+{
+    if (dbg == NULL) {
+        _dwarf_p_error(NULL, error, DW_DLE_DBG_NULL);
+        return DW_DLV_ERROR;
+    }
+    if (dbg->de_version_magic_number != PRO_VERSION_MAGIC) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_IA, DW_DLV_ERROR);
+    }
+    dbg->de_sink = sink;
+    dbg->de_sink_data = sink_data;
+    return DW_DLV_OK;
+}
+
+/*  Convert debug information to  a format such that
+    it can be written on disk.
+    Called exactly once per execution, after any
+    dwarf_transform_cu_to_disk_form_a() calls.
+    With a dwarf_pro_set_section_sink() sink the section
+    bytes go to the sink as each chunk fills (after
+    compression if that was asked for) and symbolic
+    relocations follow at the end, so nothing is left
+    for dwarf_get_section_bytes_a(). */
+int
+dwarf_transform_to_disk_form_a(Dwarf_P_Debug dbg, Dwarf_Signed *count,
+    Dwarf_Error * error)
+{
+    Dwarf_P_Section_Data sentinel = 0;
+    int sect = 0;
+    int res = 0;
+
+    if (dbg->de_version_magic_number != PRO_VERSION_MAGIC) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_IA, DW_DLV_ERROR);
+    }
+    if (!dbg->de_sink) {
+        return transform_to_disk(dbg,count,error);
+    }
+    sentinel = dbg->de_debug_sects;
+    if (sentinel->ds_elf_sect_no != MAGIC_SECT_NO) {
+        /*  Already transformed without the sink. */
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+            DW_DLV_ERROR);
+    }
+    dbg->de_sink_failed = FALSE;
+    dbg->de_sink_direct = !dbg->de_compress_sections;
+    res = transform_to_disk(dbg,count,error);
+    if (res == DW_DLV_OK) {
+        if (sink_flush(dbg,sentinel) != DW_DLV_OK) {
+            dbg->de_sink_failed = TRUE;
+            res = DW_DLV_ERROR;
+        }
+    }
+    dbg->de_sink_direct = FALSE;
+    if (res == DW_DLV_OK &&
+        (dbg->de_flags & DW_DLC_SYMBOLIC_RELOCATIONS)) {
+        for (sect = 0; sect < NUM_DEBUG_SECTIONS; ++sect) {
+            if (stream_relocations(dbg,sect,dbg->de_sink,
+                dbg->de_sink_data) != DW_DLV_OK) {
+                dbg->de_sink_failed = TRUE;
+                res = DW_DLV_ERROR;
+                break;
+            }
+        }
+    }
+    if (res == DW_DLV_ERROR && dbg->de_sink_failed) {
+        /*  Report the sink, not what it made fail. */
+        if (error && *error) {
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)*error);
+            *error = 0;
+        }
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+            DW_DLV_ERROR);
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    *count = 0;
+    return DW_DLV_OK;
+}
+
+/*  Write the CU rooted at de_dies now: its .debug_info,
+    .debug_abbrev (only when the CU added abbreviations)
+    and .debug_line bytes, and their relocations, go to
+    sink; then the DIE tree and line rows are freed.
+    Strings, abbreviations, file entries and
+    .debug_names data are kept for later CUs and for
+    dwarf_transform_to_disk_form_a(), which must follow the
+    last streamed CU to produce the remaining sections. */
+int
+dwarf_transform_cu_to_disk_form_a(Dwarf_P_Debug dbg,
+    Dwarf_P_Section_Sink sink,
+    void *sink_data,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Section_Data sentinel = 0;
+    Dwarf_P_Section_Data cursect = 0;
+    Dwarf_P_Fde fde = 0;
+    Dwarf_Signed nbufs = 0;
+    Dwarf_Unsigned written[NUM_DEBUG_SECTIONS];
+    Dwarf_Bool need_line = FALSE;
+    int k = 0;
+    int res = 0;
+
+    if (dbg == NULL) {
+        _dwarf_p_error(NULL, error, DW_DLE_DBG_NULL);
+        return DW_DLV_ERROR;
+    }
+    if (dbg->de_version_magic_number != PRO_VERSION_MAGIC ||
+        !sink) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_IA, DW_DLV_ERROR);
+    }
+    if (!dbg->de_dies) {
+        return DW_DLV_NO_ENTRY;
+    }
+    sentinel = dbg->de_debug_sects;
+    if (!(dbg->de_flags & DW_DLC_SYMBOLIC_RELOCATIONS) ||
+        sentinel->ds_elf_sect_no != MAGIC_SECT_NO ||
+        dbg->de_compress_sections) {
+        /*  Stream relocations are generated as section
+            bytes at the very end, and nothing may be
+            streamed after dwarf_transform_to_disk_form_a().
+            A compressed section is one buffer, so it
+            cannot be streamed either. */
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+            DW_DLV_ERROR);
+    }
+    /*  pubnames-style entries and FDEs may point at DIEs,
+        but these DIEs are about to be freed. */
+    for (k = 0; k < dwarf_snk_entrycount; ++k) {
+        if (dbg->de_simple_name_headers[k].sn_head) {
+            DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+                DW_DLV_ERROR);
+        }
+    }
+    fde = dbg->de_stream_fde_checked?
+        dbg->de_stream_fde_checked->fde_next:dbg->de_frame_fdes;
+    for ( ; fde; fde = fde->fde_next) {
+        if (fde->fde_die) {
+            DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+                DW_DLV_ERROR);
+        }
+        dbg->de_stream_fde_checked = fde;
+    }
+
+    need_line = dwarf_need_debug_line_section(dbg);
+    res = create_debug_section(dbg,DEBUG_INFO,0,error);
+    if (res == DW_DLV_OK && need_line) {
+        res = create_debug_section(dbg,DEBUG_LINE,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = create_debug_section(dbg,DEBUG_ABBREV,0,error);
+    }
+    if (res == DW_DLV_OK && dbg->de_need_str_offsets) {
+        res = create_debug_section(dbg,DEBUG_STR_OFFSETS,0,error);
+    }
+    if (res == DW_DLV_OK && dbg->de_need_debug_addr) {
+        res = create_debug_section(dbg,DEBUG_ADDR,0,error);
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    if (dbg->de_elf_sects[DEBUG_INFO] ==
+        dbg->de_elf_sects[DEBUG_ABBREV] ||
+        (need_line && (dbg->de_elf_sects[DEBUG_LINE] ==
+        dbg->de_elf_sects[DEBUG_INFO] ||
+        dbg->de_elf_sects[DEBUG_LINE] ==
+        dbg->de_elf_sects[DEBUG_ABBREV]))) {
+        /*  The caller's section callback must give each
+            section its own number or we cannot tell
+            the chunks apart. */
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+            DW_DLV_ERROR);
+    }
+    dbg->de_stream_active = TRUE;
+
+    if (need_line) {
+        res = _dwarf_pro_generate_debugline(dbg,&nbufs, error);
+        if (res == DW_DLV_ERROR) {
+            return res;
+        }
+    }
+    res = _dwarf_pro_generate_debuginfo(dbg, &nbufs, error);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
+    res = _dwarf_pro_dnames_close_cu(dbg,
+        dbg->de_stream_sect_offset[DEBUG_INFO],error);
+    if (res == DW_DLV_ERROR) {
+        return res;
+    }
+
+    memset(written,0,sizeof(written));
+    for (cursect = dbg->de_first_debug_sect; cursect;
+        cursect = cursect->ds_next) {
+        int sect = stream_section_of(dbg,cursect->ds_elf_sect_no);
+
+        res = sink(cursect->ds_elf_sect_no,
+            dbg->de_stream_sect_offset[sect] + written[sect],
+            cursect->ds_data, cursect->ds_nbytes,0,0,sink_data);
+        if (res != DW_DLV_OK) {
+            DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+                DW_DLV_ERROR);
+        }
+        written[sect] += cursect->ds_nbytes;
+    }
+    res = stream_relocations(dbg,DEBUG_INFO,sink,sink_data);
+    if (res == DW_DLV_OK) {
+        res = stream_relocations(dbg,DEBUG_LINE,sink,sink_data);
+    }
+    if (res == DW_DLV_OK) {
+        res = stream_relocations(dbg,DEBUG_STR_OFFSETS,sink,
+            sink_data);
+    }
+    if (res == DW_DLV_OK) {
+        res = stream_relocations(dbg,DEBUG_ADDR,sink,sink_data);
+    }
+    if (res != DW_DLV_OK) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+            DW_DLV_ERROR);
+    }
+    dbg->de_stream_sect_offset[DEBUG_INFO] += written[DEBUG_INFO];
+    dbg->de_stream_sect_offset[DEBUG_LINE] += written[DEBUG_LINE];
+    dbg->de_stream_sect_offset[DEBUG_ABBREV] +=
+        written[DEBUG_ABBREV];
+    dbg->de_stream_sect_offset[DEBUG_STR_OFFSETS] +=
+        written[DEBUG_STR_OFFSETS];
+    dbg->de_stream_sect_offset[DEBUG_ADDR] += written[DEBUG_ADDR];
+
+    /*  Release everything specific to this CU. */
+    cursect = dbg->de_first_debug_sect;
+    while (cursect) {
+        Dwarf_P_Section_Data next = cursect->ds_next;
+
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)cursect);
+        cursect = next;
+    }
+    dbg->de_debug_sects = sentinel;
+    dbg->de_current_active_section = sentinel;
+    dbg->de_first_debug_sect = 0;
+    dbg->de_n_debug_sect = 0;
+
+    _dwarf_pro_free_die_tree(dbg->de_dies);
+    dbg->de_dies = 0;
+    while (dbg->de_lines) {
+        Dwarf_P_Line next = dbg->de_lines->dpl_next;
+
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)dbg->de_lines);
+        dbg->de_lines = next;
+    }
+    dbg->de_last_line = 0;
+    if (dbg->de_markers) {
+        _dwarf_p_dealloc(dbg,(Dwarf_Small *)dbg->de_markers);
+        dbg->de_markers = 0;
+    }
+    dbg->de_marker_n_alloc = 0;
+    dbg->de_marker_n_used = 0;
+    {
+        Dwarf_P_Per_Sect_String_Attrs sect_sa =
+            &dbg->de_sect_string_attr[DEBUG_INFO];
+
+        if (sect_sa->sect_sa_list) {
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)sect_sa->sect_sa_list);
+            sect_sa->sect_sa_list = 0;
+        }
+        sect_sa->sect_sa_n_alloc = 0;
+        sect_sa->sect_sa_n_used = 0;
+    }
+    return DW_DLV_OK;
+}
+
 static int
 write_fixed_size(Dwarf_Unsigned val,
     Dwarf_P_Debug dbg,
@@ -752,41 +1342,405 @@ write_uval(Dwarf_Unsigned val,
     unsigned * uval_len_out,
     Dwarf_Error* error)
 {
-    char buff1[ENCODE_SPACE_NEEDED];
-    unsigned char *data = 0;
-    int nbytes = 0;
-    int res =  dwarf_encode_leb128(val,
-        &nbytes, buff1,
-        sizeof(buff1));
-    if (res != DW_DLV_OK) {
-        DWARF_P_DBG_ERROR(dbg, DW_DLE_LEB_OUT_ERROR, DW_DLV_ERROR);
+    char buff1[ENCODE_SPACE_NEEDED];
+    unsigned char *data = 0;
+    int nbytes = 0;
+    int res =  dwarf_encode_leb128(val,
+        &nbytes, buff1,
+        sizeof(buff1));
+    if (res != DW_DLV_OK) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_LEB_OUT_ERROR, DW_DLV_ERROR);
+    }
+    GET_CHUNK_ERR(dbg, elfsectno, data, nbytes, error);
+    memcpy((void *) data, (const void *) buff1, nbytes);
+    *uval_len_out = nbytes;
+    return DW_DLV_OK;
+}
+
+static unsigned
+write_opcode_uval(int opcode,
+    Dwarf_P_Debug dbg,
+    int elfsectno,
+    Dwarf_Unsigned val,
+    unsigned *len_out,
+    Dwarf_Error* error)
+{
+    unsigned ublen = 0;
+    int res = 0;
+    unsigned uvlen = 0;
+    res  = write_ubyte(opcode,dbg,elfsectno,&ublen,error);
+    if (res != DW_DLV_OK) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_LEB_OUT_ERROR, DW_DLV_ERROR);
+    }
+    res = write_uval(val,dbg,elfsectno,&uvlen,error);
+    if (res != DW_DLV_OK) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_LEB_OUT_ERROR, DW_DLV_ERROR);
+    }
+    *len_out = ublen +uvlen;
+    return DW_DLV_OK;
+}
+
+/*  With the "optimize_line_program" producer_init extra
+    each row's address and line advance is written the
+    cheapest of these ways, and before the line table
+    header is written line_base and line_range are chosen
+    to make the rows of the whole line program smallest. */
+enum line_row_enc_e {
+    lre_special,           /* special opcode */
+    lre_const_add_special, /* DW_LNS_const_add_pc, special */
+    lre_advance_special,   /* pc advance, special for the line */
+    lre_standard           /* pc advance, advance_line, copy */
+};
+struct line_row_choice_s {
+    enum line_row_enc_e lrc_enc;
+    Dwarf_Bool          lrc_fixed_advance;
+    int                 lrc_opc;
+};
+
+/*  Line programs with more distinct (address,line) advances
+    than this are tuned on the most frequent ones only. */
+#define LINE_OPT_PAIRS_MAX 4096
+#define LINE_OPT_BASE_MIN  -32
+#define LINE_OPT_BASE_MAX  1
+#define LINE_OPT_RANGE_MAX 64
+
+static unsigned
+uleb_length(Dwarf_Unsigned val)
+{
+    unsigned len = 1;
+
+    while (val >= 0x80) {
+        val >>= 7;
+        ++len;
+    }
+    return len;
+}
+
+static unsigned
+sleb_length(Dwarf_Signed val)
+{
+    unsigned len = 1;
+
+    while (val >= 0x40 || val < -0x40) {
+        val >>= 7;
+        ++len;
+    }
+    return len;
+}
+
+/*  The special opcode for a factored address advance
+    and a line advance, or -1 if there is none. */
+static int
+special_opcode(int line_base, int line_range, unsigned opcode_base,
+    Dwarf_Unsigned factored_adv, int line_adv)
+{
+    Dwarf_Unsigned opc = 0;
+
+    if (line_adv < line_base || line_adv >= line_base + line_range ||
+        factored_adv > 255) {
+        return -1;
+    }
+    opc = (line_adv - line_base) + factored_adv * line_range +
+        opcode_base;
+    if (opc > 255) {
+        return -1;
+    }
+    return (int)opc;
+}
+
+/*  Returns the bytes needed for a row, including the
+    DW_LNS_copy if one is needed, and how to write it. */
+static unsigned
+line_row_cost(struct Dwarf_P_Line_Inits_s *inits,
+    int line_base, int line_range,
+    Dwarf_Unsigned addr_adv, int line_adv,
+    struct line_row_choice_s *choice)
+{
+    unsigned opcode_base = inits->pi_opcode_base;
+    Dwarf_Unsigned factored_adv =
+        addr_adv / inits->pi_minimum_instruction_length;
+    /*  DW_LNS_const_add_pc and DW_LNS_fixed_advance_pc
+        are standard opcodes 8 and 9. */
+    Dwarf_Bool have_std9 = opcode_base > DW_LNS_fixed_advance_pc;
+    unsigned adv_cost = 0;
+    unsigned cost = 0;
+    int opc = 0;
+
+    choice->lrc_fixed_advance = FALSE;
+    opc = special_opcode(line_base,line_range,opcode_base,
+        factored_adv,line_adv);
+    if (opc >= 0) {
+        choice->lrc_enc = lre_special;
+        choice->lrc_opc = opc;
+        return 1;
+    }
+    if (have_std9) {
+        Dwarf_Unsigned const_adv =
+            (255 - opcode_base) / line_range;
+
+        if (const_adv && factored_adv >= const_adv) {
+            opc = special_opcode(line_base,line_range,opcode_base,
+                factored_adv - const_adv,line_adv);
+            if (opc >= 0) {
+                choice->lrc_enc = lre_const_add_special;
+                choice->lrc_opc = opc;
+                return 2;
+            }
+        }
+    }
+    if (factored_adv) {
+        adv_cost = 1 + uleb_length(factored_adv);
+        if (have_std9 && addr_adv <= 0xffff && adv_cost > 3) {
+            adv_cost = 3;
+            choice->lrc_fixed_advance = TRUE;
+        }
+    }
+    opc = special_opcode(line_base,line_range,opcode_base,
+        0,line_adv);
+    if (opc >= 0) {
+        choice->lrc_enc = lre_advance_special;
+        choice->lrc_opc = opc;
+        return adv_cost + 1;
+    }
+    cost = adv_cost + 1;
+    if (line_adv) {
+        cost += 1 + sleb_length(line_adv);
+    }
+    choice->lrc_enc = lre_standard;
+    choice->lrc_opc = 0;
+    return cost;
+}
+
+/*  Writes one row's advances and the row itself. */
+static int
+write_line_row(Dwarf_P_Debug dbg,
+    struct Dwarf_P_Line_Inits_s *inits,
+    int elfsectno,
+    Dwarf_Unsigned addr_adv, int line_adv,
+    unsigned *len_out,
+    Dwarf_Error *error)
+{
+    struct line_row_choice_s choice;
+    unsigned writelen = 0;
+    unsigned len = 0;
+    int res = 0;
+
+    line_row_cost(inits,inits->pi_line_base,inits->pi_line_range,
+        addr_adv,line_adv,&choice);
+    if (choice.lrc_enc == lre_const_add_special) {
+        res = write_ubyte(DW_LNS_const_add_pc,dbg,elfsectno,
+            &writelen,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        len += writelen;
+    } else if (choice.lrc_enc != lre_special && addr_adv) {
+        if (choice.lrc_fixed_advance) {
+            res = write_ubyte(DW_LNS_fixed_advance_pc,dbg,elfsectno,
+                &writelen,error);
+            if (res == DW_DLV_OK) {
+                len += writelen;
+                res = write_fixed_size(addr_adv,dbg,elfsectno,
+                    DWARF_HALF_SIZE,&writelen,error);
+            }
+        } else {
+            res = write_opcode_uval(DW_LNS_advance_pc,dbg,elfsectno,
+                addr_adv/inits->pi_minimum_instruction_length,
+                &writelen,error);
+        }
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        len += writelen;
+    }
+    if (choice.lrc_enc != lre_standard) {
+        res = write_ubyte(choice.lrc_opc,dbg,elfsectno,
+            &writelen,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        *len_out = len + writelen;
+        return DW_DLV_OK;
+    }
+    if (line_adv) {
+        res = write_ubyte(DW_LNS_advance_line,dbg,elfsectno,
+            &writelen,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        len += writelen;
+        res = write_sval(line_adv,dbg,elfsectno,&writelen,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        len += writelen;
+    }
+    res = write_ubyte(DW_LNS_copy,dbg,elfsectno,&writelen,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    *len_out = len + writelen;
+    return DW_DLV_OK;
+}
+
+struct line_adv_pair_s {
+    Dwarf_Unsigned lap_addr_adv;
+    int            lap_line_adv;
+    Dwarf_Unsigned lap_count;
+};
+
+static int
+line_pair_compare(const void *l_in, const void *r_in)
+{
+    const struct line_adv_pair_s *l = l_in;
+    const struct line_adv_pair_s *r = r_in;
+
+    if (l->lap_addr_adv != r->lap_addr_adv) {
+        return l->lap_addr_adv < r->lap_addr_adv? -1: 1;
+    }
+    if (l->lap_line_adv != r->lap_line_adv) {
+        return l->lap_line_adv < r->lap_line_adv? -1: 1;
+    }
+    return 0;
+}
+
+static int
+line_pair_count_compare(const void *l_in, const void *r_in)
+{
+    const struct line_adv_pair_s *l = l_in;
+    const struct line_adv_pair_s *r = r_in;
+
+    if (l->lap_count != r->lap_count) {
+        return l->lap_count > r->lap_count? -1: 1;
     }
-    GET_CHUNK_ERR(dbg, elfsectno, data, nbytes, error);
-    memcpy((void *) data, (const void *) buff1, nbytes);
-    *uval_len_out = nbytes;
-    return DW_DLV_OK;
+    return line_pair_compare(l_in,r_in);
 }
 
-static unsigned
-write_opcode_uval(int opcode,
-    Dwarf_P_Debug dbg,
-    int elfsectno,
-    Dwarf_Unsigned val,
-    unsigned *len_out,
-    Dwarf_Error* error)
+/*  Sets pi_line_base and pi_line_range to the values giving
+    the smallest rows, keeping the current ones unless
+    others are strictly better.  The advances of a row
+    do not depend on how earlier rows were written, so
+    they are computed once, as the writer below will
+    see them, and counted by distinct value. */
+static int
+choose_line_base_range(Dwarf_P_Debug dbg,
+    struct Dwarf_P_Line_Inits_s *inits,
+    Dwarf_Error *error)
 {
-    unsigned ublen = 0;
-    int res = 0;
-    unsigned uvlen = 0;
-    res  = write_ubyte(opcode,dbg,elfsectno,&ublen,error);
-    if (res != DW_DLV_OK) {
-        DWARF_P_DBG_ERROR(dbg, DW_DLE_LEB_OUT_ERROR, DW_DLV_ERROR);
+    struct Dwarf_P_Line_s prev;
+    struct line_adv_pair_s *pairs = 0;
+    Dwarf_P_Line curline = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned npairs = 0;
+    Dwarf_Unsigned i = 0;
+    Dwarf_Unsigned best_cost = 0;
+    int best_base = inits->pi_line_base;
+    int best_range = inits->pi_line_range;
+    int range_max = LINE_OPT_RANGE_MAX;
+    int base = 0;
+    int range = 0;
+
+    for (curline = dbg->de_lines; curline;
+        curline = curline->dpl_next) {
+        if (!curline->dpl_opc) {
+            ++count;
+        }
     }
-    res = write_uval(val,dbg,elfsectno,&uvlen,error);
-    if (res != DW_DLV_OK) {
-        DWARF_P_DBG_ERROR(dbg, DW_DLE_LEB_OUT_ERROR, DW_DLV_ERROR);
+    if (!count || !inits->pi_minimum_instruction_length) {
+        return DW_DLV_OK;
     }
-    *len_out = ublen +uvlen;
+    pairs = (struct line_adv_pair_s *)malloc(
+        count * sizeof(struct line_adv_pair_s));
+    if (!pairs) {
+        _dwarf_p_error(dbg, error, DW_DLE_ALLOC_FAIL);
+        return DW_DLV_ERROR;
+    }
+    _dwarf_pro_reg_init(dbg,&prev);
+    for (curline = dbg->de_lines; curline;
+        curline = curline->dpl_next) {
+        switch (curline->dpl_opc) {
+        case 0:
+            pairs[npairs].lap_addr_adv =
+                curline->dpl_address - prev.dpl_address;
+            pairs[npairs].lap_line_adv =
+                (int)(curline->dpl_line - prev.dpl_line);
+            pairs[npairs].lap_count = 1;
+            ++npairs;
+            prev.dpl_address = curline->dpl_address;
+            prev.dpl_line = curline->dpl_line;
+            break;
+        case DW_LNE_end_sequence:
+            _dwarf_pro_reg_init(dbg,&prev);
+            break;
+        case DW_LNE_set_address:
+            prev.dpl_address = curline->dpl_address;
+            break;
+        default:
+            break;
+        }
+    }
+    qsort(pairs,npairs,sizeof(struct line_adv_pair_s),
+        line_pair_compare);
+    count = npairs;
+    npairs = 0;
+    for (i = 0; i < count; ++i) {
+        if (npairs && !line_pair_compare(&pairs[npairs-1],
+            &pairs[i])) {
+            pairs[npairs-1].lap_count++;
+            continue;
+        }
+        pairs[npairs++] = pairs[i];
+    }
+    if (npairs > LINE_OPT_PAIRS_MAX) {
+        qsort(pairs,npairs,sizeof(struct line_adv_pair_s),
+            line_pair_count_compare);
+        npairs = LINE_OPT_PAIRS_MAX;
+    }
+
+    if (range_max > 256 - (int)inits->pi_opcode_base) {
+        range_max = 256 - (int)inits->pi_opcode_base;
+    }
+    for (range = 0; range <= range_max; ++range) {
+        for (base = LINE_OPT_BASE_MIN; base <= LINE_OPT_BASE_MAX;
+            ++base) {
+            Dwarf_Unsigned cost = 0;
+            int b = base;
+            int r = range;
+
+            if (!range) {
+                /*  First the incumbent. */
+                b = best_base;
+                r = best_range;
+                if (r < 1 || r > 255) {
+                    best_cost = ~(Dwarf_Unsigned)0;
+                    break;
+                }
+            }
+            for (i = 0; i < npairs; ++i) {
+                struct line_row_choice_s choice;
+
+                cost += pairs[i].lap_count *
+                    line_row_cost(inits,b,r,
+                    pairs[i].lap_addr_adv,pairs[i].lap_line_adv,
+                    &choice);
+                if (range && cost >= best_cost) {
+                    break;
+                }
+            }
+            if (!range) {
+                best_cost = cost;
+                break;
+            }
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_base = b;
+                best_range = r;
+            }
+        }
+    }
+    free(pairs);
+    inits->pi_line_base = best_base;
+    inits->pi_line_range = best_range;
     return DW_DLV_OK;
 }
 
@@ -1279,6 +2233,7 @@ _dwarf_pro_generate_debugline(Dwarf_P_Debug dbg,
     Dwarf_P_Line curline = 0;
     Dwarf_P_Line prevline = 0;
     struct Dwarf_P_Line_Inits_s *inits = 0;
+    struct Dwarf_P_Line_Inits_s tuned_inits;
 
     /* all data named cur* are used to loop thru linked lists */
 
@@ -1286,6 +2241,8 @@ _dwarf_pro_generate_debugline(Dwarf_P_Debug dbg,
     unsigned prolog_size = 0;
     unsigned char *data = 0;    /* holds disk form data */
     int elfsectno = 0;
+    /*  The chunk start_line_sec points into. */
+    Dwarf_P_Section_Data held = 0;
     unsigned char *start_line_sec = 0;  /* pointer to the buffer at
         section start */
     /* temps for memcpy */
@@ -1303,6 +2260,16 @@ _dwarf_pro_generate_debugline(Dwarf_P_Debug dbg,
     elfsectno = dbg->de_elf_sects[DEBUG_LINE];
 
     inits = &dbg->de_line_inits;
+    if (dbg->de_optimize_line_program) {
+        /*  A copy, so each line program is tuned from
+            the same starting values. */
+        tuned_inits = *inits;
+        inits = &tuned_inits;
+        res = choose_line_base_range(dbg,inits,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+    }
     if (version < 5) {
         res  = calculate_size_of_line_header4(dbg,inits,&prolog_size,
             error);
@@ -1320,6 +2287,7 @@ _dwarf_pro_generate_debugline(Dwarf_P_Debug dbg,
     GET_CHUNK_ERR(dbg, elfsectno, data, prolog_size, error);
 
     start_line_sec = data;
+    held = _dwarf_pro_buffer_hold(dbg,elfsectno);
 
     /* Copy the prologue data into 'data' */
     /* total_length */
@@ -1799,6 +2767,20 @@ _dwarf_pro_generate_debugline(Dwarf_P_Debug dbg,
                 DWARF_P_DBG_ERROR(dbg, DW_DLE_WRONG_ADDRESS,
                     DW_DLV_ERROR);
             }
+            if (dbg->de_optimize_line_program) {
+                no_lns_copy = 1;
+                res = write_line_row(dbg,inits,elfsectno,
+                    addr_adv,line_adv,&writelen,error);
+                if (res != DW_DLV_OK) {
+                    return res;
+                }
+                sum_bytes += writelen;
+                prevline->dpl_basic_block = FALSE;
+                prevline->dpl_address = curline->dpl_address;
+                prevline->dpl_line = curline->dpl_line;
+                curline = curline->dpl_next;
+                continue;
+            }
             opc = _dwarf_pro_get_opc(inits,addr_adv, line_adv);
             if (opc > 0) {
                 /* Use special opcode. */
@@ -1871,8 +2853,15 @@ _dwarf_pro_generate_debugline(Dwarf_P_Debug dbg,
         WRITE_UNALIGNED(dbg, (void *) start_line_sec,
             (const void *) &du, sizeof(du), offset_size);
     }
+    res = _dwarf_pro_buffer_release(dbg,held,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
 
-    *nbufs = dbg->de_n_debug_sect;
+    if (!dbg->de_par_active) {
+        /*  The parallel caller counts its own buffers. */
+        *nbufs = dbg->de_n_debug_sect;
+    }
     return DW_DLV_OK;
 }
 
@@ -2577,8 +3566,83 @@ abcompare(const void *l_in, const void *r_in)
     return 0;
 }
 
-/*  Handles abbreviations. It takes a die, searches through
-    current list of abbreviations for a matching one. If it
+#define ABBREV_HASHTAB_INITIAL_SIZE 64
+
+/*  Hash of what must match for two DIEs to share an
+    abbreviation: tag, children flag and the (sorted)
+    attribute/form list, with implicit_const values. */
+static Dwarf_Unsigned
+abbrev_hash(Dwarf_P_Die die)
+{
+    /* FNV-1a, 64 bit, one value at a time. */
+    Dwarf_Unsigned h = 0xcbf29ce484222325ULL;
+    Dwarf_P_Attribute curattr = die->di_attrs;
+
+#define ABBREV_HASH_MIX(v) \
+    { h ^= (Dwarf_Unsigned)(v); h *= 0x100000001b3ULL; }
+    ABBREV_HASH_MIX(die->di_tag);
+    ABBREV_HASH_MIX(die->di_child? DW_CHILDREN_yes:DW_CHILDREN_no);
+    ABBREV_HASH_MIX(die->di_n_attr);
+    for ( ; curattr; curattr = curattr->ar_next) {
+        ABBREV_HASH_MIX(curattr->ar_attribute);
+        ABBREV_HASH_MIX(curattr->ar_attribute_form);
+        if (curattr->ar_attribute_form == DW_FORM_implicit_const) {
+            ABBREV_HASH_MIX(curattr->ar_implicit_const);
+        }
+    }
+#undef ABBREV_HASH_MIX
+    return h;
+}
+
+/*  Add ab to the abbrev hash table, doubling the table
+    when it gets as many entries as buckets. */
+static int
+abbrev_hashtab_insert(Dwarf_P_Debug dbg, Dwarf_P_Abbrev ab)
+{
+    Dwarf_Unsigned slot = 0;
+
+    if (dbg->de_abbrev_hashtab_count >=
+        dbg->de_abbrev_hashtab_size) {
+        Dwarf_Unsigned newsize = dbg->de_abbrev_hashtab_size?
+            dbg->de_abbrev_hashtab_size*2:
+            ABBREV_HASHTAB_INITIAL_SIZE;
+        Dwarf_P_Abbrev *newtab = 0;
+        Dwarf_Unsigned i = 0;
+
+        newtab = (Dwarf_P_Abbrev *)_dwarf_p_get_alloc(dbg,
+            sizeof(Dwarf_P_Abbrev)*newsize);
+        if (!newtab) {
+            return DW_DLV_ERROR;
+        }
+        for (i = 0; i < dbg->de_abbrev_hashtab_size; ++i) {
+            Dwarf_P_Abbrev cur = dbg->de_abbrev_hashtab[i];
+
+            while (cur) {
+                Dwarf_P_Abbrev next = cur->abb_hash_next;
+
+                slot = cur->abb_hash & (newsize-1);
+                cur->abb_hash_next = newtab[slot];
+                newtab[slot] = cur;
+                cur = next;
+            }
+        }
+        if (dbg->de_abbrev_hashtab) {
+            _dwarf_p_dealloc(dbg,
+                (Dwarf_Small *)dbg->de_abbrev_hashtab);
+        }
+        dbg->de_abbrev_hashtab = newtab;
+        dbg->de_abbrev_hashtab_size = newsize;
+    }
+    slot = ab->abb_hash & (dbg->de_abbrev_hashtab_size-1);
+    ab->abb_hash_next = dbg->de_abbrev_hashtab[slot];
+    dbg->de_abbrev_hashtab[slot] = ab;
+    dbg->de_abbrev_hashtab_count++;
+    return DW_DLV_OK;
+}
+
+/*  Handles abbreviations. It takes a die, looks up
+    the abbreviations created so far (in any CU of dbg)
+    for a matching one. If it
     finds one, it returns a pointer to the abbrev through
     the ab_out pointer, and if it does not,
     it returns a new abbrev through the ab_out pointer.
@@ -2591,7 +3655,7 @@ abcompare(const void *l_in, const void *r_in)
     abb_idx has 0. */
 static int
 _dwarf_pro_getabbrev(Dwarf_P_Debug dbg,
-    Dwarf_P_Die die, Dwarf_P_Abbrev head,
+    Dwarf_P_Die die,
     Dwarf_P_Abbrev*ab_out,Dwarf_Error *error)
 {
     Dwarf_P_Abbrev curabbrev = 0;
@@ -2601,11 +3665,18 @@ _dwarf_pro_getabbrev(Dwarf_P_Debug dbg,
     Dwarf_Unsigned *attrs = 0;
     Dwarf_Signed *implicits = 0;
     int attrcount = die->di_n_attr;
+    Dwarf_Unsigned hash = abbrev_hash(die);
 
-    curabbrev = head;
-    /*  Loop thru the currently known abbreviations needed
+    dbg->de_abbrev_lookups++;
+    curabbrev = dbg->de_abbrev_hashtab_size?
+        dbg->de_abbrev_hashtab[hash &
+        (dbg->de_abbrev_hashtab_size-1)]:0;
+    /*  Check the abbreviations in this hash bucket
         to see if we can share an existing abbrev.  */
-    while (curabbrev) {
+    for ( ; curabbrev; curabbrev = curabbrev->abb_hash_next) {
+        if (curabbrev->abb_hash != hash) {
+            continue;
+        }
         if ((die->di_tag == curabbrev->abb_tag) &&
             ((die->di_child != NULL &&
             curabbrev->abb_children == DW_CHILDREN_yes) ||
@@ -2616,6 +3687,7 @@ _dwarf_pro_getabbrev(Dwarf_P_Debug dbg,
             /*  There is a chance of a match, basic
                 characterists match. Now Check the attrs and
                 forms. */
+            dbg->de_abbrev_compares++;
             curattr = die->di_attrs;
             match = _dwarf_pro_match_attr(curattr,
                 curabbrev,
@@ -2624,11 +3696,11 @@ _dwarf_pro_getabbrev(Dwarf_P_Debug dbg,
                 /*  This tag/children/abbrev-list matches
                     the incoming die needs exactly. Reuse
                     this abbreviation. */
+                dbg->de_abbrev_hits++;
                 *ab_out = curabbrev;
                 return DW_DLV_OK;
             }
         }
-        curabbrev = curabbrev->abb_next;
     }
     /* no match, create new abbreviation */
     if (attrcount) {
@@ -2710,10 +3782,41 @@ _dwarf_pro_getabbrev(Dwarf_P_Debug dbg,
     curabbrev->abb_n_attr = attrcount;
     curabbrev->abb_idx = 0;
     curabbrev->abb_next = NULL;
+    curabbrev->abb_hash = hash;
+    if (abbrev_hashtab_insert(dbg,curabbrev) != DW_DLV_OK) {
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_ABBREV_ALLOC, DW_DLV_ERROR);
+    }
     *ab_out = curabbrev;
     return DW_DLV_OK;
 }
 
+int
+dwarf_pro_get_abbrev_stats(Dwarf_P_Debug dbg,
+    Dwarf_Unsigned *lookups,
+    Dwarf_Unsigned *hits,
+    Dwarf_Unsigned *abbrev_count,
+    Dwarf_Unsigned *compares,
+    Dwarf_Error *error)
+{
+    if (!dbg || dbg->de_version_magic_number != PRO_VERSION_MAGIC) {
+        _dwarf_p_error(NULL, error, DW_DLE_DBG_NULL);
+        return DW_DLV_ERROR;
+    }
+    if (lookups) {
+        *lookups = dbg->de_abbrev_lookups;
+    }
+    if (hits) {
+        *hits = dbg->de_abbrev_hits;
+    }
+    if (abbrev_count) {
+        *abbrev_count = dbg->de_abbrev_hashtab_count;
+    }
+    if (compares) {
+        *compares = dbg->de_abbrev_compares;
+    }
+    return DW_DLV_OK;
+}
+
 /* Generate debug_info and debug_abbrev sections */
 /*  DWARF 2,3,4  */
 static int
@@ -3075,6 +4178,8 @@ _dwarf_pro_generate_debuginfo(Dwarf_P_Debug dbg,
     unsigned string_attr_count = 0;
     unsigned string_attr_offset = 0;
     Dwarf_Small *abbr_off_ptr = 0;
+    /*  The chunk abbr_off_ptr points into. */
+    Dwarf_P_Section_Data held = 0;
 
     int offset_size = dbg->de_dwarf_offset_size;
     /*  extension_size is oddly names. The standard calls
@@ -3118,6 +4223,7 @@ _dwarf_pro_generate_debuginfo(Dwarf_P_Debug dbg,
         DWARF_P_DBG_ERROR(dbg, DW_DLE_VERSION_STAMP_ERROR,
             DW_DLV_ERROR);
     }
+    held = _dwarf_pro_buffer_hold(dbg,elfsectno_of_debug_info);
 
     curdie = dbg->de_dies;
 
@@ -3137,13 +4243,23 @@ _dwarf_pro_generate_debuginfo(Dwarf_P_Debug dbg,
 #endif
     }
 
-    /* Create AT_stmt_list attribute if necessary */
+    /*  Create AT_stmt_list attribute if necessary.
+        The line offset is non-zero only for
+        streamed CUs after the first. */
     if (dwarf_need_debug_line_section(dbg) == TRUE) {
-        res =_dwarf_pro_add_AT_stmt_list(dbg, curdie, error);
+        res =_dwarf_pro_add_AT_stmt_list(dbg, curdie,
+            dbg->de_stream_sect_offset[DEBUG_LINE],error);
         if (res != DW_DLV_OK) {
             return res;
         }
     }
+    /*  DW_FORM_strx and, with use_addrx, DW_FORM_addr
+        attributes become indexes, before any abbreviation
+        is chosen. */
+    res = _dwarf_pro_assign_index_forms(dbg,curdie,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
     die_off = cu_header_size;
 
     /*  Relocation for abbrev offset in cu header store relocation
@@ -3180,8 +4296,11 @@ _dwarf_pro_generate_debuginfo(Dwarf_P_Debug dbg,
     }
 
     /*  Pass 1: create abbrev info, get die offsets,
-        calc relocations */
-    abbrev_head = abbrev_tail = NULL;
+        calc relocations.  The abbrev list carries over
+        from earlier streamed CUs, if any. */
+    abbrev_head = dbg->de_abbrev_head;
+    abbrev_tail = dbg->de_abbrev_tail;
+    n_abbrevs = dbg->de_n_abbrevs;
     marker_count = 0;
     string_attr_count = 0;
     while (curdie != NULL) {
@@ -3204,7 +4323,7 @@ _dwarf_pro_generate_debuginfo(Dwarf_P_Debug dbg,
         /*  Find or create a final abbrev record for the
             debug_abbrev section we will write (below). */
         cres  = _dwarf_pro_getabbrev(dbg,curdie,
-            abbrev_head,&curabbrev,error);
+            &curabbrev,error);
         if (cres != DW_DLV_OK) {
             return cres;
         }
@@ -3491,9 +4610,43 @@ _dwarf_pro_generate_debuginfo(Dwarf_P_Debug dbg,
         (const void *) &du, sizeof(du), offset_size);
 
     data = 0;                   /* Emphasize not usable now */
+    res = _dwarf_pro_generate_index_tables(dbg,error);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    dbg->de_abbrev_head = abbrev_head;
+    dbg->de_abbrev_tail = abbrev_tail;
+    dbg->de_n_abbrevs = n_abbrevs;
 
-    res = write_out_debug_abbrev(dbg,
-        abbrev_head, error);
+    if (!dbg->de_stream_active) {
+        res = write_out_debug_abbrev(dbg,
+            abbrev_head, error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+    } else {
+        /*  A streamed CU shares the previous abbrev table
+            unless it added abbreviations, in which case the
+            whole (grown) list is written out again.
+            Abbrev codes never change, so older CUs
+            remain valid with either table. */
+        if (!dbg->de_stream_abbrev_count ||
+            dbg->de_stream_abbrev_count != n_abbrevs) {
+            res = write_out_debug_abbrev(dbg,
+                abbrev_head, error);
+            if (res != DW_DLV_OK) {
+                return res;
+            }
+            dbg->de_stream_abbrev_offset =
+                dbg->de_stream_sect_offset[DEBUG_ABBREV];
+            dbg->de_stream_abbrev_count = n_abbrevs;
+        }
+        du = dbg->de_stream_abbrev_offset;
+        WRITE_UNALIGNED(dbg, (void *)(abbr_off_ptr -
+            extension_size + abbrev_offset),
+            (const void *) &du, sizeof(du), offset_size);
+    }
+    res = _dwarf_pro_buffer_release(dbg,held,error);
     if (res != DW_DLV_OK) {
         return res;
     }
@@ -3507,14 +4660,39 @@ _dwarf_pro_generate_dnames(Dwarf_P_Debug dbg,
     Dwarf_Signed *nbufs,
     Dwarf_Error * error)
 {
-    int elfsectno_of_debug_names =  dbg->de_elf_sects[DEBUG_NAMES];
-    if (dbg->de_force_dnames) {
-        dwarf_force_dnames(dbg,elfsectno_of_debug_names,error);
+    int res = 0;
+
+    res = _dwarf_pro_generate_debug_names(dbg,error);
+    if (res == DW_DLV_ERROR) {
+        return res;
     }
     *nbufs = dbg->de_n_debug_sect;
     return DW_DLV_OK;
 }
 
+/*  With a direct sink the string sections, already
+    one buffer, need not be copied into chunks. */
+static int
+sink_bytes(Dwarf_P_Debug dbg, int elfsectno,
+    Dwarf_P_Section_Data sd,
+    Dwarf_Error *error)
+{
+    Dwarf_Unsigned *offp = sink_sect_offset(dbg,elfsectno);
+    int res = DW_DLV_ERROR;
+
+    if (offp) {
+        res = dbg->de_sink(elfsectno,*offp,sd->ds_data,
+            sd->ds_nbytes,0,0,dbg->de_sink_data);
+        *offp += sd->ds_nbytes;
+    }
+    if (res != DW_DLV_OK) {
+        dbg->de_sink_failed = TRUE;
+        DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+            DW_DLV_ERROR);
+    }
+    return DW_DLV_OK;
+}
+
 static int
 _dwarf_pro_generate_debug_str(Dwarf_P_Debug dbg,
     Dwarf_Signed *nbufs,
@@ -3524,6 +4702,10 @@ _dwarf_pro_generate_debug_str(Dwarf_P_Debug dbg,
     unsigned char *data = 0;
 
     elfsectno_of_debug_str = dbg->de_elf_sects[DEBUG_STR];
+    if (dbg->de_sink_direct) {
+        return sink_bytes(dbg,elfsectno_of_debug_str,
+            dbg->de_debug_str,error);
+    }
     GET_CHUNK(dbg, elfsectno_of_debug_str, data,
         dbg->de_debug_str->ds_nbytes,error);
     memcpy(data,dbg->de_debug_str->ds_data,
@@ -3540,6 +4722,10 @@ _dwarf_pro_generate_debug_line_str(Dwarf_P_Debug dbg,
     unsigned char *data = 0;
 
     elfsectno_of_debug_line_str = dbg->de_elf_sects[DEBUG_LINE_STR];
+    if (dbg->de_sink_direct) {
+        return sink_bytes(dbg,elfsectno_of_debug_line_str,
+            dbg->de_debug_line_str,error);
+    }
     GET_CHUNK(dbg, elfsectno_of_debug_line_str, data,
         dbg->de_debug_line_str->ds_nbytes,
         error);
@@ -3602,6 +4788,243 @@ dwarf_reset_section_bytes(Dwarf_P_Debug dbg)
     dbg->de_sect_sa_next_to_return = 0;
 }
 
+/*  A new chunk with room for at least nbytes, nbytes
+    of it reserved. */
+static Dwarf_P_Section_Data
+new_chunk(Dwarf_P_Debug dbg,
+    int elfsectno, unsigned long nbytes)
+{
+    Dwarf_P_Section_Data cursect = 0;
+    unsigned long space = nbytes;
+
+    if (nbytes < CHUNK_SIZE) {
+        space = CHUNK_SIZE;
+    }
+    cursect = (Dwarf_P_Section_Data)
+        _dwarf_p_get_alloc(dbg,
+            sizeof(struct Dwarf_P_Section_Data_s) + space);
+    if (cursect == NULL) {
+        return NULL;
+    }
+    /* _dwarf_p_get_alloc zeroes the space... */
+    cursect->ds_data = (char *) cursect +
+        sizeof(struct Dwarf_P_Section_Data_s);
+    cursect->ds_orig_alloc = space;
+    cursect->ds_elf_sect_no = elfsectno;
+    cursect->ds_nbytes = nbytes;
+    return cursect;
+}
+
+/*  _dwarf_pro_buffer() for the worker thread of a
+    parallel transform: the same chunking, on the
+    private de_par_ list. */
+static Dwarf_Small *
+pro_buffer_par(Dwarf_P_Debug dbg,
+    int elfsectno, unsigned long nbytes)
+{
+    Dwarf_P_Section_Data cursect = dbg->de_par_current;
+
+    if (cursect &&
+        (cursect->ds_nbytes + nbytes) <= cursect->ds_orig_alloc) {
+        Dwarf_Small *space_for_caller = (Dwarf_Small *)
+            (cursect->ds_data + cursect->ds_nbytes);
+
+        cursect->ds_nbytes += nbytes;
+        return space_for_caller;
+    }
+    cursect = new_chunk(dbg,elfsectno,nbytes);
+    if (cursect == NULL) {
+        return (NULL);
+    }
+    if (dbg->de_par_current) {
+        dbg->de_par_current->ds_next = cursect;
+    } else {
+        dbg->de_par_first = cursect;
+    }
+    dbg->de_par_current = cursect;
+    dbg->de_par_count++;
+    return ((Dwarf_Small *) cursect->ds_data);
+}
+
+/*  The offset reached so far in output section
+    elfsectno by dwarf_pro_set_section_sink() output.
+    Returns NULL if there are too many sections. */
+static Dwarf_Unsigned *
+sink_sect_offset(Dwarf_P_Debug dbg, int elfsectno)
+{
+    struct Dwarf_P_Sink_Sect_s *ss = 0;
+    int i = 0;
+
+    for ( ; i < dbg->de_sink_sect_count; ++i) {
+        if (dbg->de_sink_sects[i].ss_elf_sect_no == elfsectno) {
+            return &dbg->de_sink_sects[i].ss_offset;
+        }
+    }
+    if (i >= PRO_SINK_SECTS_MAX) {
+        return NULL;
+    }
+    ss = &dbg->de_sink_sects[i];
+    ss->ss_elf_sect_no = elfsectno;
+    ss->ss_offset = 0;
+    dbg->de_sink_sect_count++;
+    return &ss->ss_offset;
+}
+
+/*  Hand a finished chunk to the sink and free it. */
+static int
+sink_deliver(Dwarf_P_Debug dbg, Dwarf_P_Section_Data cursect)
+{
+    int res = DW_DLV_OK;
+
+    if (cursect->ds_nbytes) {
+        res = dbg->de_sink(cursect->ds_elf_sect_no,
+            cursect->ds_sect_offset,
+            cursect->ds_data,cursect->ds_nbytes,
+            0,0,dbg->de_sink_data);
+    }
+    _dwarf_p_dealloc(dbg,(Dwarf_Small *)cursect);
+    if (res != DW_DLV_OK) {
+        dbg->de_sink_failed = TRUE;
+        return DW_DLV_ERROR;
+    }
+    return DW_DLV_OK;
+}
+
+/*  No more bytes go into cursect: deliver it now
+    unless its generator still holds it. */
+static int
+sink_retire(Dwarf_P_Debug dbg, Dwarf_P_Section_Data cursect)
+{
+    Dwarf_Unsigned *offp = sink_sect_offset(dbg,
+        cursect->ds_elf_sect_no);
+
+    if (!offp) {
+        return DW_DLV_ERROR;
+    }
+    *offp += cursect->ds_nbytes;
+    if (cursect->ds_held) {
+        cursect->ds_next = dbg->de_sink_held;
+        dbg->de_sink_held = cursect;
+        return DW_DLV_OK;
+    }
+    return sink_deliver(dbg,cursect);
+}
+
+/*  Deliver, in order, a list of chunks that were
+    not placed as they were generated. */
+static int
+sink_deliver_list(Dwarf_P_Debug dbg, Dwarf_P_Section_Data cursect)
+{
+    int res = DW_DLV_OK;
+
+    while (cursect) {
+        Dwarf_P_Section_Data next = cursect->ds_next;
+
+        if (res == DW_DLV_OK) {
+            Dwarf_Unsigned *offp = sink_sect_offset(dbg,
+                cursect->ds_elf_sect_no);
+
+            if (!offp) {
+                res = DW_DLV_ERROR;
+            } else {
+                cursect->ds_sect_offset = *offp;
+                *offp += cursect->ds_nbytes;
+                res = sink_deliver(dbg,cursect);
+            }
+        } else {
+            _dwarf_p_dealloc(dbg,(Dwarf_Small *)cursect);
+        }
+        cursect = next;
+    }
+    return res;
+}
+
+/*  _dwarf_pro_buffer() with a direct sink: only the
+    current chunk and held chunks exist. */
+static Dwarf_Small *
+pro_buffer_sink(Dwarf_P_Debug dbg,
+    int elfsectno, unsigned long nbytes)
+{
+    Dwarf_P_Section_Data cursect = dbg->de_sink_current;
+    Dwarf_Unsigned *offp = 0;
+
+    if (cursect && cursect->ds_elf_sect_no == elfsectno &&
+        (cursect->ds_nbytes + nbytes) <= cursect->ds_orig_alloc) {
+        Dwarf_Small *space_for_caller = (Dwarf_Small *)
+            (cursect->ds_data + cursect->ds_nbytes);
+
+        cursect->ds_nbytes += nbytes;
+        return space_for_caller;
+    }
+    if (cursect) {
+        dbg->de_sink_current = 0;
+        if (sink_retire(dbg,cursect) != DW_DLV_OK) {
+            return NULL;
+        }
+    }
+    offp = sink_sect_offset(dbg,elfsectno);
+    if (!offp) {
+        return NULL;
+    }
+    cursect = new_chunk(dbg,elfsectno,nbytes);
+    if (cursect == NULL) {
+        return (NULL);
+    }
+    cursect->ds_sect_offset = *offp;
+    dbg->de_sink_current = cursect;
+    return ((Dwarf_Small *) cursect->ds_data);
+}
+
+/*  A generator is about to keep a pointer into the
+    space it was last given for sectno, to patch a
+    length in later.  With a direct sink that chunk
+    must not be delivered before
+    _dwarf_pro_buffer_release().  Returns 0 if
+    nothing needs holding. */
+Dwarf_P_Section_Data
+_dwarf_pro_buffer_hold(Dwarf_P_Debug dbg, int elfsectno)
+{
+    Dwarf_P_Section_Data cursect = dbg->de_sink_current;
+
+    if (!dbg->de_sink_direct ||
+        (dbg->de_par_active && elfsectno == dbg->de_par_elf_sect_no)) {
+        /*  Worker chunks are delivered after the join. */
+        return 0;
+    }
+    if (!cursect || cursect->ds_elf_sect_no != elfsectno) {
+        return 0;
+    }
+    cursect->ds_held = TRUE;
+    return cursect;
+}
+
+int
+_dwarf_pro_buffer_release(Dwarf_P_Debug dbg,
+    Dwarf_P_Section_Data held,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Section_Data *prev = 0;
+
+    if (!held) {
+        return DW_DLV_OK;
+    }
+    held->ds_held = FALSE;
+    if (held == dbg->de_sink_current) {
+        return DW_DLV_OK;
+    }
+    for (prev = &dbg->de_sink_held; *prev; prev = &(*prev)->ds_next) {
+        if (*prev == held) {
+            *prev = held->ds_next;
+            if (sink_deliver(dbg,held) != DW_DLV_OK) {
+                DWARF_P_DBG_ERROR(dbg, DW_DLE_PRO_STREAM_ERROR,
+                    DW_DLV_ERROR);
+            }
+            break;
+        }
+    }
+    return DW_DLV_OK;
+}
+
 /*  Storage handler. Gets either a new chunk of memory, or
     a pointer in existing memory, from the linked list attached
     to dbg at de_debug_sects, depending on size of nbytes
@@ -3620,6 +5043,12 @@ _dwarf_pro_buffer(Dwarf_P_Debug dbg,
 {
     Dwarf_P_Section_Data cursect = 0;
 
+    if (dbg->de_par_active && elfsectno == dbg->de_par_elf_sect_no) {
+        return pro_buffer_par(dbg,elfsectno,nbytes);
+    }
+    if (dbg->de_sink_direct) {
+        return pro_buffer_sink(dbg,elfsectno,nbytes);
+    }
     cursect = dbg->de_current_active_section;
     /*  By using MAGIC_SECT_NO we allow the
         following MAGIC_SECT_NO must
@@ -3636,26 +5065,10 @@ _dwarf_pro_buffer(Dwarf_P_Debug dbg,
             and have
             space 'on the end' for the buffer itself so we
             just do one malloc (not two).  */
-        unsigned long space = nbytes;
-
-        if (nbytes < CHUNK_SIZE) {
-            space = CHUNK_SIZE;
-        }
-        cursect = (Dwarf_P_Section_Data)
-            _dwarf_p_get_alloc(dbg,
-                sizeof(struct Dwarf_P_Section_Data_s)
-                + space);
+        cursect = new_chunk(dbg,elfsectno,nbytes);
         if (cursect == NULL) {
             return (NULL);
         }
-        /* _dwarf_p_get_alloc zeroes the space... */
-
-        cursect->ds_data = (char *) cursect +
-            sizeof(struct Dwarf_P_Section_Data_s);
-        cursect->ds_orig_alloc = space;
-        cursect->ds_elf_sect_no = elfsectno;
-        cursect->ds_nbytes = nbytes;/* reserve this number of bytes
-            of space for caller to fill in */
         /*  Now link on the end of the list, and mark this one as the
             current one */
 
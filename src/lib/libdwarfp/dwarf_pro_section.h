@@ -45,6 +45,11 @@ struct Dwarf_P_Section_Data_s {
     unsigned long ds_nbytes; /* bytes of data used so far */
     unsigned long ds_orig_alloc; /* bytes allocated originally */
     Dwarf_P_Section_Data ds_next; /* next on the list */
+    /*  For dwarf_pro_set_section_sink() output: where
+        ds_data goes in the section, and whether a
+        generator will still patch it. */
+    Dwarf_Unsigned ds_sect_offset;
+    Dwarf_Bool ds_held;
 };
 
 /* Used to allow a dummy initial struct (which we
@@ -71,6 +76,21 @@ struct Dwarf_P_Section_Data_s {
 Dwarf_Small *_dwarf_pro_buffer(Dwarf_P_Debug dbg, int sectno,
     unsigned long nbytes);
 
+Dwarf_P_Section_Data _dwarf_pro_buffer_hold(Dwarf_P_Debug dbg,
+    int sectno);
+int _dwarf_pro_buffer_release(Dwarf_P_Debug dbg,
+    Dwarf_P_Section_Data held,
+    Dwarf_Error *error);
+
+int _dwarf_pro_compress_sections(Dwarf_P_Debug dbg,
+    Dwarf_Signed *nbufs,
+    Dwarf_Error *error);
+int _dwarf_pro_assign_index_forms(Dwarf_P_Debug dbg,
+    Dwarf_P_Die cu_die,
+    Dwarf_Error *error);
+int _dwarf_pro_generate_index_tables(Dwarf_P_Debug dbg,
+    Dwarf_Error *error);
+
 /* GET_CHUNK_ERROR is new Sept 2016 to use DW_DLV_ERROR. */
 #define GET_CHUNK_ERR(dbg,sectno,ptr,nbytes,error) \
 { \
@@ -193,16 +193,102 @@ DWP_API int dwarf_producer_init(
 
 /*  Returns DW_DLV_OK or DW_DLV_ERROR.
     The desired form must be DW_FORM_string (the default)
-    or DW_FORM_strp.  */
+    or DW_FORM_strp, or for DWARF5 DW_FORM_strx: strings
+    are then referenced through a per-CU .debug_str_offsets
+    table with the smallest DW_FORM_strx1-4 that fits.  */
 DWP_API int dwarf_pro_set_default_string_form(Dwarf_P_Debug /*dbg*/,
     int /*desired_form*/,
     Dwarf_Error*     /*error*/);
 
+/*  Returns DW_DLV_OK or DW_DLV_ERROR.
+    Reports how abbreviations were assigned so far:
+    lookups is the number of DIEs looked up, hits the
+    number that reused an existing abbreviation (so
+    hits/lookups is the hit rate), abbrev_count the
+    abbreviations created and compares the full
+    attribute-list comparisons made (about hits unless
+    hash collisions are frequent).
+    Any pointer argument may be NULL. */
+DWP_API int dwarf_pro_get_abbrev_stats(Dwarf_P_Debug /*dbg*/,
+    Dwarf_Unsigned * /*lookups*/,
+    Dwarf_Unsigned * /*hits*/,
+    Dwarf_Unsigned * /*abbrev_count*/,
+    Dwarf_Unsigned * /*compares*/,
+    Dwarf_Error*     /*error*/);
+
 /*  New September 2016. The preferred interface. */
 DWP_API int dwarf_transform_to_disk_form_a(Dwarf_P_Debug /*dbg*/,
     Dwarf_Signed *   /*nbufs_out*/,
     Dwarf_Error*     /*error*/);
 
+/*  Receives streamed output from
+    dwarf_transform_cu_to_disk_form_a().
+    Called with bytes non-NULL and relocations NULL
+    for section data, which lands at section_offset
+    in the section numbered elf_section_index
+    (as returned by the Dwarf_Callback_Func).
+    Called with bytes NULL for relocations of that
+    section, their drd_offset values already relative
+    to the start of the section.
+    The memory is only valid during the call.
+    Return DW_DLV_OK to continue; anything else
+    makes the transform fail with
+    DW_DLE_PRO_STREAM_ERROR. */
+typedef int (*Dwarf_P_Section_Sink)(
+    Dwarf_Signed          /*elf_section_index*/,
+    Dwarf_Unsigned        /*section_offset*/,
+    Dwarf_Ptr             /*bytes*/,
+    Dwarf_Unsigned        /*length*/,
+    Dwarf_Relocation_Data /*relocations*/,
+    Dwarf_Unsigned        /*relocation_count*/,
+    void *                /*sink_data*/);
+
+/*  Makes dwarf_transform_to_disk_form_a() write every
+    section byte through sink as it is generated
+    instead of keeping it for
+    dwarf_get_section_bytes_a(), which then has nothing
+    to return (and the count returned is zero).
+    Each call gives bytes for
+    [section_offset, section_offset+length) of one
+    section and calls need not come in offset order,
+    so the sink should be pwrite()-like.  With
+    DW_DLC_SYMBOLIC_RELOCATIONS the relocations are
+    passed last, with bytes NULL.  With the
+    "compress_debug_sections" extra each section
+    arrives in one call once compressed.
+    A NULL sink restores the default.  A sink failure
+    makes the transform fail with DW_DLE_PRO_STREAM_ERROR.
+    dwarf_transform_cu_to_disk_form_a() is not affected. */
+DWP_API int dwarf_pro_set_section_sink(Dwarf_P_Debug /*dbg*/,
+    Dwarf_P_Section_Sink /*sink*/,
+    void *               /*sink_data*/,
+    Dwarf_Error *        /*error*/);
+
+/*  Writes the compilation unit built so far (the DIE
+    tree set with dwarf_add_die_to_debug_a() and any
+    line table rows) through sink and frees the DIEs
+    and line rows, so that an object with many CUs
+    need not be held in memory at once.  Call it once
+    per CU, then build the next CU from scratch;
+    DIEs of a streamed CU must not be referenced again.
+    .debug_info, .debug_abbrev (a new, complete table
+    only when the CU needs abbreviations not seen
+    before; otherwise the CU shares the previous
+    table) and .debug_line are
+    streamed; strings, frames, aranges and .debug_names
+    are still returned by dwarf_transform_to_disk_form_a()
+    and dwarf_get_section_bytes_a() after the last CU.
+    Requires DW_DLC_SYMBOLIC_RELOCATIONS and no
+    "compress_debug_sections" extra, and fails
+    with DW_DLE_PRO_STREAM_ERROR when pubnames-style
+    names or an FDE refer to a DIE of the CU.
+    Returns DW_DLV_NO_ENTRY if there is no DIE tree. */
+DWP_API int dwarf_transform_cu_to_disk_form_a(
+    Dwarf_P_Debug         /*dbg*/,
+    Dwarf_P_Section_Sink  /*sink*/,
+    void *                /*sink_data*/,
+    Dwarf_Error*          /*error*/);
+
 /* New September 2016. Preferred. */
 DWP_API int dwarf_get_section_bytes_a(Dwarf_P_Debug /*dbg*/,
     Dwarf_Signed     /*dwarf_section*/,
@@ -211,6 +297,22 @@ DWP_API int dwarf_get_section_bytes_a(Dwarf_P_Debug /*dbg*/,
     Dwarf_Ptr     *  /*section_bytes*/,
     Dwarf_Error*     /*error*/);
 
+/*  With the "compress_debug_sections" extra, and after
+    dwarf_transform_to_disk_form_a(), sets *compressed
+    TRUE if the section numbered elf_section_index (as
+    returned by the Dwarf_Callback_Func) holds a
+    compression header and compressed bytes.
+    A section compression would not make smaller is
+    left uncompressed (*compressed FALSE); the caller
+    should then clear the SHF_COMPRESSED passed to the
+    callback from its sh_flags.
+    Returns DW_DLV_NO_ENTRY if libdwarfp created no
+    DWARF section with that number. */
+DWP_API int dwarf_pro_get_section_compressed(Dwarf_P_Debug /*dbg*/,
+    Dwarf_Signed     /*elf_section_index*/,
+    Dwarf_Bool *     /*compressed*/,
+    Dwarf_Error *    /*error*/);
+
 DWP_API int  dwarf_get_relocation_info_count(
     Dwarf_P_Debug    /*dbg*/,
     Dwarf_Unsigned * /*count_of_relocation_sections*/,
@@ -685,15 +787,24 @@ DWP_API int dwarf_add_weakname_a(
 
 /*  .debug_names producer functions */
 
-/*  dwarf_force_dnames forces creation
-    of .debug_names (if DWARF5 being produced)
-    even if empty. Only for testing libdwarf. */
+/*  dwarf_force_dnames(dbg,0,&error) enables creation
+    of .debug_names (if DWARF5 being produced).
+    Call it before adding DIEs: every DW_AT_name
+    added afterwards (dwarf_add_AT_name_a() or
+    dwarf_add_AT_string_a()) is recorded, and
+    dwarf_transform_to_disk_form_a() emits an index
+    (hash table, buckets, abbreviations and entry pool)
+    of the named functions, variables with a location
+    or value, types and namespaces in the CU.
+    Declarations are not indexed.
+    The section is emitted even if no names qualify.
+    Names are also written to .debug_str, as the
+    index refers to them by offset.
+    A non-zero elfsectno is for libdwarf internal use. */
 DWP_API int dwarf_force_dnames(Dwarf_P_Debug /* dbg */,
     int  /*elfsectno*/,
     Dwarf_Error*     /*error*/);
 
-/*  Other debug_names functions are needed... FIXME */
-
 /*  end .debug_names producer functions */
 
 /*  .debug_macinfo producer functions
@@ -735,6 +846,23 @@ DWP_API int dwarf_pro_get_string_stats(Dwarf_P_Debug /*dbg*/,
     Dwarf_Unsigned * /*reused_len*/,
     Dwarf_Error    * /*error*/);
 
+/*  As dwarf_pro_get_string_stats() plus, once
+    dwarf_transform_to_disk_form_a() has run with the
+    "str_tail_merge=1" producer_init extra, the number of
+    .debug_str strings stored inside a longer string
+    they are a suffix of, and the bytes that saved.
+    len_debug_str is the size before tail merging. */
+DWP_API int dwarf_pro_get_string_stats_a(Dwarf_P_Debug /*dbg*/,
+    Dwarf_Unsigned * /*str_count*/,
+    Dwarf_Unsigned * /*str_total_length*/,
+    Dwarf_Unsigned * /*count_debug_str*/,
+    Dwarf_Unsigned * /*len_debug_str*/,
+    Dwarf_Unsigned * /*reused_count*/,
+    Dwarf_Unsigned * /*reused_len*/,
+    Dwarf_Unsigned * /*tail_merged_count*/,
+    Dwarf_Unsigned * /*tail_merged_len*/,
+    Dwarf_Error    * /*error*/);
+
 #ifdef __cplusplus
 }
 #endif
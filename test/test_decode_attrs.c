@@ -0,0 +1,764 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*  Tests dwarf_die_decode_attrs(). Every attribute of
+    every DIE is compared with what dwarf_attrlist() and
+    the dwarf_form*() calls return for it.
+    Besides the objects named, an in-memory DWARF5 CU
+    is read (via dwarf_object_init_b() as in
+    src/bin/dwarfexample/jitreader.c) whose abbreviations
+    use DW_FORM_indirect and DW_FORM_implicit_const,
+    and a few of its values are checked directly.
+    Usage: test_decode_attrs <object> ...
+    or with env var DWTOPSRCDIR naming the source tree. */
+
+#include <config.h>
+
+#include <stdio.h>  /* printf() */
+#include <stdlib.h> /* getenv() */
+#include <string.h> /* memcmp() memset() strcmp() strlen() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h" /* TRUE FALSE */
+
+static const char *testobjs[] = {
+"/test/testuriLE64ELf.obj",  /* DWARF4 */
+"/test/testdw5LE64Elf.obj",  /* DWARF5, implicit_const */
+0
+};
+
+static int errcount;
+static unsigned long attrcount;
+static unsigned long indirectcount;
+static unsigned long implicitcount;
+
+#define MAXATTRS 100
+
+static void
+fail(const char *msg, Dwarf_Off dieoff, Dwarf_Half attrnum,
+    int line)
+{
+    printf("FAIL %s at DIE 0x%llx attr 0x%x line %d\n",msg,
+        (unsigned long long)dieoff,attrnum,line);
+    ++errcount;
+}
+
+/*  Compares one decoded value with the same attribute
+    read through the Dwarf_Attribute interfaces. */
+static void
+check_value(Dwarf_Debug dbg, Dwarf_Attribute attr,
+    Dwarf_Attr_Value *av, Dwarf_Off dieoff)
+{
+    Dwarf_Error error = 0;
+    Dwarf_Half attrnum = av->av_attrnum;
+    int res = DW_DLV_OK;
+
+    switch (av->av_formclass) {
+    case DW_FORM_CLASS_ADDRESS: {
+        Dwarf_Addr addr = 0;
+
+        if (av->av_is_index) {
+            break;
+        }
+        res = dwarf_formaddr(attr,&addr,&error);
+        if (res == DW_DLV_OK && addr != av->av_unsigned) {
+            fail("address differs",dieoff,attrnum,__LINE__);
+        }
+        break;
+        }
+    case DW_FORM_CLASS_CONSTANT:
+        if (av->av_form == DW_FORM_data16) {
+            Dwarf_Form_Data16 d16;
+
+            res = dwarf_formdata16(attr,&d16,&error);
+            if (res == DW_DLV_OK && (!av->av_data ||
+                memcmp(&d16,av->av_data,sizeof(d16)))) {
+                fail("data16 differs",dieoff,attrnum,__LINE__);
+            }
+        } else if (av->av_form == DW_FORM_sdata ||
+            av->av_form == DW_FORM_implicit_const) {
+            Dwarf_Signed sval = 0;
+
+            res = dwarf_formsdata(attr,&sval,&error);
+            if (res == DW_DLV_OK && sval != av->av_signed) {
+                fail("signed constant differs",dieoff,attrnum,
+                    __LINE__);
+            }
+        } else {
+            Dwarf_Unsigned uval = 0;
+
+            res = dwarf_formudata(attr,&uval,&error);
+            if (res == DW_DLV_OK && uval != av->av_unsigned) {
+                fail("constant differs",dieoff,attrnum,__LINE__);
+            }
+        }
+        break;
+    case DW_FORM_CLASS_FLAG: {
+        Dwarf_Bool flag = 0;
+
+        res = dwarf_formflag(attr,&flag,&error);
+        if (res == DW_DLV_OK &&
+            (Dwarf_Unsigned)flag != av->av_unsigned) {
+            fail("flag differs",dieoff,attrnum,__LINE__);
+        }
+        break;
+        }
+    case DW_FORM_CLASS_REFERENCE:
+        if (av->av_form == DW_FORM_ref_sig8) {
+            Dwarf_Sig8 sig;
+
+            res = dwarf_formsig8(attr,&sig,&error);
+            if (res == DW_DLV_OK && (!av->av_data ||
+                memcmp(&sig,av->av_data,sizeof(sig)))) {
+                fail("signature differs",dieoff,attrnum,__LINE__);
+            }
+        } else {
+            Dwarf_Off off = 0;
+            Dwarf_Bool is_info = FALSE;
+
+            res = dwarf_global_formref_b(attr,&off,&is_info,
+                &error);
+            if (res == DW_DLV_OK && (off != av->av_unsigned ||
+                is_info != av->av_is_info)) {
+                fail("reference differs",dieoff,attrnum,__LINE__);
+            }
+        }
+        break;
+    case DW_FORM_CLASS_STRING: {
+        char *str = 0;
+
+        res = dwarf_formstring(attr,&str,&error);
+        if (res == DW_DLV_OK && (!av->av_string ||
+            strcmp(str,av->av_string))) {
+            fail("string differs",dieoff,attrnum,__LINE__);
+        }
+        break;
+        }
+    case DW_FORM_CLASS_EXPRLOC: {
+        Dwarf_Unsigned len = 0;
+        Dwarf_Ptr ptr = 0;
+
+        res = dwarf_formexprloc(attr,&len,&ptr,&error);
+        if (res == DW_DLV_OK && (len != av->av_data_len ||
+            ptr != (Dwarf_Ptr)av->av_data)) {
+            fail("exprloc differs",dieoff,attrnum,__LINE__);
+        }
+        break;
+        }
+    case DW_FORM_CLASS_BLOCK: {
+        Dwarf_Block *block = 0;
+
+        res = dwarf_formblock(attr,&block,&error);
+        if (res == DW_DLV_OK) {
+            if (block->bl_len != av->av_data_len ||
+                block->bl_data != (Dwarf_Ptr)av->av_data) {
+                fail("block differs",dieoff,attrnum,__LINE__);
+            }
+            dwarf_dealloc(dbg,block,DW_DLA_BLOCK);
+        }
+        break;
+        }
+    case DW_FORM_CLASS_UNKNOWN:
+        break;
+    default: {
+        /*  The section offset classes. */
+        Dwarf_Unsigned val = 0;
+
+        if (av->av_form == DW_FORM_sec_offset) {
+            Dwarf_Off off = 0;
+            Dwarf_Bool is_info = FALSE;
+
+            res = dwarf_global_formref_b(attr,&off,&is_info,
+                &error);
+            val = off;
+        } else {
+            res = dwarf_formudata(attr,&val,&error);
+        }
+        if (res == DW_DLV_OK && val != av->av_unsigned) {
+            fail("offset differs",dieoff,attrnum,__LINE__);
+        }
+        break;
+        }
+    }
+    if (res != DW_DLV_OK) {
+        fail("form call failed where decode succeeded",
+            dieoff,attrnum,__LINE__);
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+    }
+}
+
+static void
+dealloc_attrlist(Dwarf_Debug dbg, Dwarf_Attribute *attrs,
+    Dwarf_Signed count)
+{
+    Dwarf_Signed i = 0;
+
+    for (i = 0; i < count; ++i) {
+        dwarf_dealloc_attribute(attrs[i]);
+    }
+    dwarf_dealloc(dbg,attrs,DW_DLA_LIST);
+}
+
+static void
+check_die(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    Dwarf_Attr_Value values[MAXATTRS];
+    Dwarf_Attr_Value one;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned count1 = 0;
+    Dwarf_Attribute *attrs = 0;
+    Dwarf_Signed attrs_count = 0;
+    Dwarf_Half version = 0;
+    Dwarf_Half offset_size = 0;
+    Dwarf_Off dieoff = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Signed i = 0;
+    int dres = 0;
+    int lres = 0;
+
+    dwarf_dieoffset(die,&dieoff,&error);
+    dwarf_get_version_of_die(die,&version,&offset_size);
+    dres = dwarf_die_decode_attrs(die,values,MAXATTRS,&count,
+        &error);
+    if (dres == DW_DLV_ERROR) {
+        fail("dwarf_die_decode_attrs error",dieoff,0,__LINE__);
+        dwarf_dealloc_error(dbg,error);
+        return;
+    }
+    lres = dwarf_attrlist(die,&attrs,&attrs_count,&error);
+    if (lres == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        error = 0;
+    }
+    if (dres != lres) {
+        fail("return differs from dwarf_attrlist",dieoff,0,
+            __LINE__);
+        if (lres == DW_DLV_OK) {
+            dealloc_attrlist(dbg,attrs,attrs_count);
+        }
+        return;
+    }
+    if (dres == DW_DLV_NO_ENTRY) {
+        return;
+    }
+    if (count != (Dwarf_Unsigned)attrs_count ||
+        count > MAXATTRS) {
+        fail("attribute count differs",dieoff,0,__LINE__);
+        dealloc_attrlist(dbg,attrs,attrs_count);
+        return;
+    }
+    /*  A short array still reports the full count. */
+    dres = dwarf_die_decode_attrs(die,&one,1,&count1,&error);
+    if (dres != DW_DLV_OK || count1 != count ||
+        one.av_attrnum != values[0].av_attrnum) {
+        fail("short array decode differs",dieoff,0,__LINE__);
+        if (dres == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+    }
+    for (i = 0; i < attrs_count; ++i) {
+        Dwarf_Attr_Value *av = values+i;
+        Dwarf_Half attrnum = 0;
+        Dwarf_Half form = 0;
+        Dwarf_Half direct = 0;
+
+        ++attrcount;
+        dwarf_whatattr(attrs[i],&attrnum,&error);
+        dwarf_whatform(attrs[i],&form,&error);
+        dwarf_whatform_direct(attrs[i],&direct,&error);
+        if (av->av_attrnum != attrnum || av->av_form != form) {
+            fail("attribute or form differs",dieoff,attrnum,
+                __LINE__);
+            continue;
+        }
+        if (av->av_formclass != dwarf_get_form_class(version,
+            attrnum,offset_size,form)) {
+            fail("form class differs",dieoff,attrnum,__LINE__);
+        }
+        if (direct == DW_FORM_indirect) {
+            ++indirectcount;
+        }
+        if (form == DW_FORM_implicit_const) {
+            ++implicitcount;
+            if (av->av_size) {
+                fail("implicit_const has a size",dieoff,attrnum,
+                    __LINE__);
+            }
+        }
+        check_value(dbg,attrs[i],av,dieoff);
+    }
+    dealloc_attrlist(dbg,attrs,attrs_count);
+}
+
+/*  Checks die, its children and its later siblings.
+    The caller deallocs die. */
+static void
+walk_dies(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    Dwarf_Die cur = die;
+    Dwarf_Error error = 0;
+
+    for (;;) {
+        Dwarf_Die child = 0;
+        Dwarf_Die sib = 0;
+        int res = 0;
+
+        check_die(dbg,cur);
+        res = dwarf_child(cur,&child,&error);
+        if (res == DW_DLV_OK) {
+            walk_dies(dbg,child);
+            dwarf_dealloc_die(child);
+        } else if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+        res = dwarf_siblingof_b(dbg,cur,TRUE,&sib,&error);
+        if (cur != die) {
+            dwarf_dealloc_die(cur);
+        }
+        if (res != DW_DLV_OK) {
+            if (res == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+            return;
+        }
+        cur = sib;
+    }
+}
+
+/*  Calls check_die() on every DIE of every CU and
+    returns the CU DIE of the first CU (if first_cu_die
+    is non-null) for the caller to dealloc. */
+static void
+walk_cus(Dwarf_Debug dbg, const char *name,
+    Dwarf_Die *first_cu_die)
+{
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    for (;;) {
+        Dwarf_Die cudie = 0;
+
+        res = dwarf_next_cu_header_d(dbg,TRUE,0,0,0,0,0,0,0,0,
+            0,0,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        res = dwarf_siblingof_b(dbg,0,TRUE,&cudie,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        walk_dies(dbg,cudie);
+        if (first_cu_die && !*first_cu_die) {
+            *first_cu_die = cudie;
+        } else {
+            dwarf_dealloc_die(cudie);
+        }
+    }
+    if (res == DW_DLV_ERROR) {
+        printf("FAIL test_decode_attrs: reading %s\n",name);
+        dwarf_dealloc_error(dbg,error);
+        ++errcount;
+    }
+}
+
+static int
+test_object(const char *path)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_init_path(path,0,0,DW_GROUPNUMBER_ANY,0,0,
+        &dbg,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL test_decode_attrs: cannot open %s\n",path);
+        return 1;
+    }
+    walk_cus(dbg,path,0);
+    dwarf_finish(dbg);
+    return 0;
+}
+
+/*  In-memory DWARF5 CU, 32bit offsets, address size 8.
+    Abbrev 1: DW_TAG_compile_unit, children,
+        DW_AT_producer indirect, DW_AT_name strp,
+        DW_AT_language implicit_const 0x1d,
+        DW_AT_low_pc addr, DW_AT_high_pc indirect.
+    Abbrev 2: DW_TAG_variable, no children,
+        DW_AT_name indirect, DW_AT_const_value indirect,
+        DW_AT_decl_line implicit_const 300,
+        DW_AT_external flag_present,
+        DW_AT_location indirect, DW_AT_type indirect.
+    Abbrev 3: DW_TAG_base_type, no children,
+        DW_AT_byte_size implicit_const 4,
+        DW_AT_encoding indirect, DW_AT_name indirect. */
+static Dwarf_Small abbrevbytes[] = {
+0x01, 0x11, 0x01,
+0x25, 0x16, 0x03, 0x0e, 0x13, 0x21, 0x1d,
+0x11, 0x01, 0x12, 0x16, 0x00, 0x00,
+0x02, 0x34, 0x00,
+0x03, 0x16, 0x1c, 0x16, 0x3b, 0x21, 0xac, 0x02,
+0x3f, 0x19, 0x02, 0x16, 0x49, 0x16, 0x00, 0x00,
+0x03, 0x24, 0x00,
+0x0b, 0x21, 0x04, 0x3e, 0x16, 0x03, 0x16, 0x00, 0x00,
+0x00 };
+
+/*  The CU DIE is at 0xc, the variable at 0x21 and
+    the base type at 0x32. Each DW_FORM_indirect value
+    starts with its real form:
+    string "p", data4 0x20, strp 5, sdata -2,
+    exprloc {DW_OP_lit1 DW_OP_stack_value}, ref4 0x32,
+    data1 5 (DW_ATE_signed), string "int". */
+static Dwarf_Small infobytes[] = {
+0x37, 0x00, 0x00, 0x00, 0x05, 0x00, 0x01, 0x08,
+0x00, 0x00, 0x00, 0x00,
+0x01,
+0x08, 'p', 0x00,
+0x00, 0x00, 0x00, 0x00,
+0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x06, 0x20, 0x00, 0x00, 0x00,
+0x02,
+0x0e, 0x05, 0x00, 0x00, 0x00,
+0x0d, 0x7e,
+0x18, 0x02, 0x31, 0x9f,
+0x13, 0x32, 0x00, 0x00, 0x00,
+0x03,
+0x0b, 0x05,
+0x08, 'i', 'n', 't', 0x00,
+0x00 };
+
+static Dwarf_Small strbytes[] = {
+'c','u','.','c',0,
+'v','a','r',0 };
+
+struct sectiondata_s {
+    const char   * sd_secname;
+    Dwarf_Unsigned sd_sectionsize;
+    Dwarf_Small  * sd_content;
+};
+
+#define SECCOUNT 4
+static struct sectiondata_s sectiondata[SECCOUNT] = {
+{"",0,0},
+{".debug_abbrev",sizeof(abbrevbytes),abbrevbytes},
+{".debug_info",sizeof(infobytes),infobytes},
+{".debug_str",sizeof(strbytes),strbytes}
+};
+
+static int
+gsinfo(void *obj, Dwarf_Half section_index,
+    Dwarf_Obj_Access_Section_a *return_section,
+    int *error)
+{
+    struct sectiondata_s *finfo = 0;
+
+    (void)obj;
+    *error = 0;
+    if (section_index >= SECCOUNT) {
+        return DW_DLV_NO_ENTRY;
+    }
+    finfo = sectiondata + section_index;
+    memset(return_section,0,sizeof(*return_section));
+    return_section->as_name = finfo->sd_secname;
+    return_section->as_size = finfo->sd_sectionsize;
+    return_section->as_entrysize = 1;
+    return DW_DLV_OK;
+}
+static Dwarf_Small
+gborder(void *obj)
+{
+    (void)obj;
+    return DW_END_little;
+}
+static Dwarf_Small
+glensize(void *obj)
+{
+    (void)obj;
+    return 4;
+}
+static Dwarf_Small
+gptrsize(void *obj)
+{
+    (void)obj;
+    return 8;
+}
+static Dwarf_Unsigned
+gfilesize(void *obj)
+{
+    (void)obj;
+    return 200;
+}
+static Dwarf_Unsigned
+gseccount(void *obj)
+{
+    (void)obj;
+    return SECCOUNT;
+}
+static int
+gloadsec(void *obj, Dwarf_Half secindex,
+    Dwarf_Small **rdata, int *error)
+{
+    (void)obj;
+    *error = 0;
+    if (secindex >= SECCOUNT) {
+        return DW_DLV_NO_ENTRY;
+    }
+    *rdata = sectiondata[secindex].sd_content;
+    return DW_DLV_OK;
+}
+
+static const Dwarf_Obj_Access_Methods_a methods = {
+    gsinfo,
+    gborder,
+    glensize,
+    gptrsize,
+    gfilesize,
+    gseccount,
+    gloadsec,
+    0 /* no relocations */
+};
+static Dwarf_Obj_Access_Interface_a dw_interface =
+{ 0, &methods };
+
+/*  Finds attrnum in values, checks its form and size. */
+static Dwarf_Attr_Value *
+find_value(Dwarf_Attr_Value *values, Dwarf_Unsigned count,
+    Dwarf_Half attrnum, Dwarf_Half form, Dwarf_Unsigned size)
+{
+    Dwarf_Unsigned i = 0;
+
+    for (i = 0; i < count; ++i) {
+        if (values[i].av_attrnum != attrnum) {
+            continue;
+        }
+        if (values[i].av_form != form ||
+            values[i].av_size != size) {
+            fail("in-memory form or size wrong",0,attrnum,
+                __LINE__);
+            return 0;
+        }
+        return values+i;
+    }
+    fail("in-memory attribute missing",0,attrnum,__LINE__);
+    return 0;
+}
+
+static void
+check_known_values(Dwarf_Debug dbg, Dwarf_Die cudie)
+{
+    Dwarf_Attr_Value values[MAXATTRS];
+    Dwarf_Attr_Value *av = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Die die = 0;
+    Dwarf_Die tdie = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_die_decode_attrs(cudie,values,MAXATTRS,&count,
+        &error);
+    if (res != DW_DLV_OK || count != 5) {
+        fail("in-memory CU DIE decode",0xc,0,__LINE__);
+        return;
+    }
+    av = find_value(values,count,DW_AT_producer,
+        DW_FORM_string,3);
+    if (av && strcmp(av->av_string,"p")) {
+        fail("in-memory producer",0xc,DW_AT_producer,__LINE__);
+    }
+    av = find_value(values,count,DW_AT_language,
+        DW_FORM_implicit_const,0);
+    if (av && av->av_unsigned != DW_LANG_C11) {
+        fail("in-memory language",0xc,DW_AT_language,__LINE__);
+    }
+    av = find_value(values,count,DW_AT_high_pc,DW_FORM_data4,5);
+    if (av && av->av_unsigned != 0x20) {
+        fail("in-memory high_pc",0xc,DW_AT_high_pc,__LINE__);
+    }
+
+    res = dwarf_child(cudie,&die,&error);
+    if (res != DW_DLV_OK) {
+        fail("in-memory variable DIE missing",0xc,0,__LINE__);
+        return;
+    }
+    res = dwarf_die_decode_attrs(die,values,MAXATTRS,&count,
+        &error);
+    if (res != DW_DLV_OK || count != 6) {
+        fail("in-memory variable decode",0x21,0,__LINE__);
+    } else {
+        av = find_value(values,count,DW_AT_name,DW_FORM_strp,5);
+        if (av && strcmp(av->av_string,"var")) {
+            fail("in-memory name",0x21,DW_AT_name,__LINE__);
+        }
+        av = find_value(values,count,DW_AT_const_value,
+            DW_FORM_sdata,2);
+        if (av && av->av_signed != -2) {
+            fail("in-memory const_value",0x21,
+                DW_AT_const_value,__LINE__);
+        }
+        av = find_value(values,count,DW_AT_decl_line,
+            DW_FORM_implicit_const,0);
+        if (av && av->av_signed != 300) {
+            fail("in-memory decl_line",0x21,DW_AT_decl_line,
+                __LINE__);
+        }
+        av = find_value(values,count,DW_AT_external,
+            DW_FORM_flag_present,0);
+        if (av && av->av_unsigned != 1) {
+            fail("in-memory external",0x21,DW_AT_external,
+                __LINE__);
+        }
+        av = find_value(values,count,DW_AT_location,
+            DW_FORM_exprloc,4);
+        if (av && (av->av_data_len != 2 ||
+            av->av_data[0] != DW_OP_lit1 ||
+            av->av_data[1] != DW_OP_stack_value)) {
+            fail("in-memory location",0x21,DW_AT_location,
+                __LINE__);
+        }
+        av = find_value(values,count,DW_AT_type,DW_FORM_ref4,5);
+        if (av && (av->av_unsigned != 0x32 || !av->av_is_info)) {
+            fail("in-memory type",0x21,DW_AT_type,__LINE__);
+        }
+    }
+    res = dwarf_siblingof_b(dbg,die,TRUE,&tdie,&error);
+    dwarf_dealloc_die(die);
+    if (res != DW_DLV_OK) {
+        fail("in-memory base type DIE missing",0x21,0,__LINE__);
+        return;
+    }
+    res = dwarf_die_decode_attrs(tdie,values,MAXATTRS,&count,
+        &error);
+    if (res != DW_DLV_OK || count != 3) {
+        fail("in-memory base type decode",0x32,0,__LINE__);
+    } else {
+        av = find_value(values,count,DW_AT_byte_size,
+            DW_FORM_implicit_const,0);
+        if (av && av->av_unsigned != 4) {
+            fail("in-memory byte_size",0x32,DW_AT_byte_size,
+                __LINE__);
+        }
+        av = find_value(values,count,DW_AT_encoding,
+            DW_FORM_data1,2);
+        if (av && av->av_unsigned != DW_ATE_signed) {
+            fail("in-memory encoding",0x32,DW_AT_encoding,
+                __LINE__);
+        }
+        av = find_value(values,count,DW_AT_name,
+            DW_FORM_string,5);
+        if (av && strcmp(av->av_string,"int")) {
+            fail("in-memory base type name",0x32,DW_AT_name,
+                __LINE__);
+        }
+    }
+    dwarf_dealloc_die(tdie);
+}
+
+static void
+test_in_memory(void)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Die cudie = 0;
+    unsigned long indirect_before = indirectcount;
+    int res = 0;
+
+    res = dwarf_object_init_b(&dw_interface,0,0,
+        DW_GROUPNUMBER_ANY,&dbg,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL test_decode_attrs: dwarf_object_init_b\n");
+        ++errcount;
+        return;
+    }
+    walk_cus(dbg,"in-memory CU",&cudie);
+    if (!cudie) {
+        printf("FAIL test_decode_attrs: no in-memory CU\n");
+        ++errcount;
+    } else {
+        check_known_values(dbg,cudie);
+        dwarf_dealloc_die(cudie);
+    }
+    dwarf_object_finish(dbg);
+    if (indirectcount - indirect_before != 8) {
+        printf("FAIL test_decode_attrs: saw %lu DW_FORM_indirect, "
+            "expected 8\n",indirectcount - indirect_before);
+        ++errcount;
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    char path[2000];
+    const char *top = 0;
+    int i = 0;
+
+    if (argc > 1) {
+        for (i = 1; i < argc; ++i) {
+            errcount += test_object(argv[i]);
+        }
+    } else {
+        top = getenv("DWTOPSRCDIR");
+        if (!top) {
+            printf("FAIL test_decode_attrs: no object path\n");
+            return 1;
+        }
+        for (i = 0; testobjs[i]; ++i) {
+            if (strlen(top) + strlen(testobjs[i]) >= sizeof(path)) {
+                printf("FAIL test_decode_attrs: path too long\n");
+                return 1;
+            }
+            strcpy(path,top);
+            strcat(path,testobjs[i]);
+            errcount += test_object(path);
+        }
+    }
+    test_in_memory();
+    if (!implicitcount) {
+        printf("FAIL test_decode_attrs: no DW_FORM_implicit_const "
+            "seen\n");
+        ++errcount;
+    }
+    if (errcount) {
+        printf("FAIL test_decode_attrs, %d errors\n",errcount);
+        return 1;
+    }
+    printf("PASS test_decode_attrs: %lu attributes, "
+        "%lu DW_FORM_indirect, %lu DW_FORM_implicit_const\n",
+        attrcount,indirectcount,implicitcount);
+    return 0;
+}
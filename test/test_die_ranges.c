@@ -0,0 +1,477 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  Tests dwarf_die_ranges() and dwarf_die_pc_in_ranges().
+    For every DIE with code addresses the result is
+    compared with ranges built here from dwarf_lowpc(),
+    dwarf_highpc_b(), dwarf_get_ranges_b() (DWARF4) and
+    the rnglists interfaces (DWARF5).
+    Usage: test_die_ranges <object> ...
+    or with env var DWTOPSRCDIR naming the source tree. */
+
+#include <config.h>
+
+#include <stdio.h>  /* printf() */
+#include <stdlib.h> /* getenv() qsort() */
+#include <string.h> /* strlen() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h" /* TRUE FALSE */
+
+static const char *testobjs[] = {
+"/test/testuriLE64ELf.obj",  /* DWARF4 .debug_ranges */
+"/test/testdw5LE64Elf.obj",  /* DWARF5 .debug_rnglists */
+0
+};
+
+static int errcount;
+static unsigned long diecount;
+static unsigned long rangesdiecount;
+
+#define MAXRANGES 200
+struct expected_s {
+    Dwarf_Pc_Range ex_ranges[MAXRANGES];
+    Dwarf_Unsigned ex_count;
+};
+
+static void
+fail(const char *msg, Dwarf_Off dieoff, int line)
+{
+    printf("FAIL %s at DIE 0x%llx line %d\n",msg,
+        (unsigned long long)dieoff,line);
+    ++errcount;
+}
+
+static void
+add(struct expected_s *ex, Dwarf_Addr lo, Dwarf_Addr hi)
+{
+    if (lo >= hi || ex->ex_count >= MAXRANGES) {
+        return;
+    }
+    ex->ex_ranges[ex->ex_count].pr_lowpc = lo;
+    ex->ex_ranges[ex->ex_count].pr_highpc = hi;
+    ex->ex_count++;
+}
+
+static int
+cmp_range(const void *l, const void *r)
+{
+    const Dwarf_Pc_Range *lp = l;
+    const Dwarf_Pc_Range *rp = r;
+
+    if (lp->pr_lowpc != rp->pr_lowpc) {
+        return (lp->pr_lowpc < rp->pr_lowpc)?-1:1;
+    }
+    if (lp->pr_highpc != rp->pr_highpc) {
+        return (lp->pr_highpc < rp->pr_highpc)?-1:1;
+    }
+    return 0;
+}
+
+static void
+sort_merge(struct expected_s *ex)
+{
+    Dwarf_Unsigned i = 0;
+    Dwarf_Unsigned out = 0;
+
+    if (ex->ex_count < 2) {
+        return;
+    }
+    qsort(ex->ex_ranges,(size_t)ex->ex_count,
+        sizeof(Dwarf_Pc_Range),cmp_range);
+    for (i = 1; i < ex->ex_count; ++i) {
+        if (ex->ex_ranges[i].pr_lowpc <=
+            ex->ex_ranges[out].pr_highpc) {
+            if (ex->ex_ranges[i].pr_highpc >
+                ex->ex_ranges[out].pr_highpc) {
+                ex->ex_ranges[out].pr_highpc =
+                    ex->ex_ranges[i].pr_highpc;
+            }
+            continue;
+        }
+        ++out;
+        ex->ex_ranges[out] = ex->ex_ranges[i];
+    }
+    ex->ex_count = out+1;
+}
+
+static int
+expected_debug_ranges(Dwarf_Debug dbg, Dwarf_Die die,
+    Dwarf_Attribute attr, Dwarf_Addr cu_base,
+    struct expected_s *ex)
+{
+    Dwarf_Off off = 0;
+    Dwarf_Off realoff = 0;
+    Dwarf_Ranges *buf = 0;
+    Dwarf_Signed count = 0;
+    Dwarf_Unsigned bytes = 0;
+    Dwarf_Addr base = cu_base;
+    Dwarf_Error error = 0;
+    Dwarf_Signed i = 0;
+    int res = 0;
+
+    res = dwarf_global_formref(attr,&off,&error);
+    if (res == DW_DLV_OK) {
+        res = dwarf_get_ranges_b(dbg,off,die,&realoff,&buf,
+            &count,&bytes,&error);
+    }
+    if (res != DW_DLV_OK) {
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        return res;
+    }
+    for (i = 0; i < count; ++i) {
+        Dwarf_Ranges *r = buf+i;
+
+        if (r->dwr_type == DW_RANGES_ADDRESS_SELECTION) {
+            base = r->dwr_addr2;
+        } else if (r->dwr_type == DW_RANGES_ENTRY) {
+            add(ex,base + r->dwr_addr1,base + r->dwr_addr2);
+        }
+    }
+    dwarf_dealloc_ranges(dbg,buf,count);
+    return DW_DLV_OK;
+}
+
+static int
+expected_rnglists(Dwarf_Debug dbg, Dwarf_Attribute attr,
+    struct expected_s *ex)
+{
+    Dwarf_Half form = 0;
+    Dwarf_Unsigned value = 0;
+    Dwarf_Rnglists_Head head = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned global = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned i = 0;
+    int res = 0;
+
+    res = dwarf_whatform(attr,&form,&error);
+    if (res == DW_DLV_OK) {
+        if (form == DW_FORM_rnglistx) {
+            res = dwarf_formudata(attr,&value,&error);
+        } else {
+            res = dwarf_global_formref(attr,&value,&error);
+        }
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_rnglists_get_rle_head(attr,form,value,&head,
+            &count,&global,&error);
+    }
+    if (res != DW_DLV_OK) {
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        return res;
+    }
+    for (i = 0; i < count; ++i) {
+        unsigned int len = 0;
+        unsigned int code = 0;
+        Dwarf_Unsigned raw1 = 0;
+        Dwarf_Unsigned raw2 = 0;
+        Dwarf_Bool unavail = FALSE;
+        Dwarf_Unsigned lo = 0;
+        Dwarf_Unsigned hi = 0;
+
+        res = dwarf_get_rnglists_entry_fields_a(head,i,&len,
+            &code,&raw1,&raw2,&unavail,&lo,&hi,&error);
+        if (res != DW_DLV_OK) {
+            if (res == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+            break;
+        }
+        if (code == DW_RLE_end_of_list ||
+            code == DW_RLE_base_address ||
+            code == DW_RLE_base_addressx || unavail) {
+            continue;
+        }
+        add(ex,lo,hi);
+    }
+    dwarf_dealloc_rnglists_head(head);
+    return res;
+}
+
+/*  Returns DW_DLV_NO_ENTRY if the DIE has no
+    code addresses. */
+static int
+expected_ranges(Dwarf_Debug dbg, Dwarf_Die die,
+    Dwarf_Addr cu_base, struct expected_s *ex)
+{
+    Dwarf_Attribute attr = 0;
+    Dwarf_Half version = 0;
+    Dwarf_Half offset_size = 0;
+    Dwarf_Addr lowpc = 0;
+    Dwarf_Addr highpc = 0;
+    Dwarf_Half form = 0;
+    enum Dwarf_Form_Class cl = DW_FORM_CLASS_UNKNOWN;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    ex->ex_count = 0;
+    res = dwarf_attr(die,DW_AT_ranges,&attr,&error);
+    if (res == DW_DLV_OK) {
+        ++rangesdiecount;
+        dwarf_get_version_of_die(die,&version,&offset_size);
+        if (version >= 5) {
+            res = expected_rnglists(dbg,attr,ex);
+        } else {
+            res = expected_debug_ranges(dbg,die,attr,cu_base,ex);
+        }
+        dwarf_dealloc_attribute(attr);
+        sort_merge(ex);
+        return res;
+    }
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        return res;
+    }
+    res = dwarf_lowpc(die,&lowpc,&error);
+    if (res != DW_DLV_OK) {
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        return res;
+    }
+    res = dwarf_highpc_b(die,&highpc,&form,&cl,&error);
+    if (res == DW_DLV_OK) {
+        if (cl == DW_FORM_CLASS_CONSTANT) {
+            highpc += lowpc;
+        }
+        add(ex,lowpc,highpc);
+    } else if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        return res;
+    }
+    return DW_DLV_OK;
+}
+
+static void
+check_pc(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Addr pc,
+    Dwarf_Bool expect, Dwarf_Off dieoff)
+{
+    Dwarf_Bool contains = !expect;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_die_pc_in_ranges(die,pc,&contains,&error);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+    }
+    if (res != DW_DLV_OK || contains != expect) {
+        fail("dwarf_die_pc_in_ranges wrong",dieoff,__LINE__);
+    }
+}
+
+static void
+check_die(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Addr cu_base)
+{
+    struct expected_s ex;
+    Dwarf_Pc_Range *ranges = 0;
+    Dwarf_Pc_Range *again = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned count2 = 0;
+    Dwarf_Off dieoff = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned i = 0;
+    int eres = 0;
+    int res = 0;
+
+    dwarf_dieoffset(die,&dieoff,&error);
+    eres = expected_ranges(dbg,die,cu_base,&ex);
+    res = dwarf_die_ranges(die,&ranges,&count,&error);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        error = 0;
+    }
+    if (res != eres) {
+        fail("dwarf_die_ranges return differs",dieoff,__LINE__);
+        return;
+    }
+    if (res != DW_DLV_OK) {
+        return;
+    }
+    ++diecount;
+    if (count != ex.ex_count) {
+        fail("range count differs",dieoff,__LINE__);
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        if (ranges[i].pr_lowpc != ex.ex_ranges[i].pr_lowpc ||
+            ranges[i].pr_highpc != ex.ex_ranges[i].pr_highpc) {
+            fail("range differs",dieoff,__LINE__);
+            return;
+        }
+        check_pc(dbg,die,ranges[i].pr_lowpc,TRUE,dieoff);
+        check_pc(dbg,die,ranges[i].pr_highpc-1,TRUE,dieoff);
+        if (i+1 == count ||
+            ranges[i+1].pr_lowpc > ranges[i].pr_highpc) {
+            check_pc(dbg,die,ranges[i].pr_highpc,FALSE,dieoff);
+        }
+    }
+    if (count) {
+        check_pc(dbg,die,ranges[0].pr_lowpc-1,FALSE,dieoff);
+    }
+    /*  The second call is answered from the cache. */
+    res = dwarf_die_ranges(die,&again,&count2,&error);
+    if (res != DW_DLV_OK || again != ranges || count2 != count) {
+        fail("second dwarf_die_ranges call not cached",
+            dieoff,__LINE__);
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+    }
+}
+
+/*  Checks die, its children and its later siblings.
+    The caller deallocs die. */
+static void
+walk_dies(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Addr cu_base)
+{
+    Dwarf_Die cur = die;
+    Dwarf_Error error = 0;
+
+    for (;;) {
+        Dwarf_Die child = 0;
+        Dwarf_Die sib = 0;
+        int res = 0;
+
+        check_die(dbg,cur,cu_base);
+        res = dwarf_child(cur,&child,&error);
+        if (res == DW_DLV_OK) {
+            walk_dies(dbg,child,cu_base);
+            dwarf_dealloc_die(child);
+        } else if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+        res = dwarf_siblingof_b(dbg,cur,TRUE,&sib,&error);
+        if (cur != die) {
+            dwarf_dealloc_die(cur);
+        }
+        if (res != DW_DLV_OK) {
+            if (res == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+            return;
+        }
+        cur = sib;
+    }
+}
+
+static int
+test_object(const char *path)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    unsigned long ranges_before = rangesdiecount;
+    int res = 0;
+
+    res = dwarf_init_path(path,0,0,DW_GROUPNUMBER_ANY,0,0,
+        &dbg,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL test_die_ranges: cannot open %s\n",path);
+        return 1;
+    }
+    for (;;) {
+        Dwarf_Unsigned next = 0;
+        Dwarf_Half cutype = 0;
+        Dwarf_Die cudie = 0;
+        Dwarf_Addr cu_base = 0;
+
+        res = dwarf_next_cu_header_d(dbg,TRUE,0,0,0,0,0,0,0,0,
+            &next,&cutype,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        res = dwarf_siblingof_b(dbg,0,TRUE,&cudie,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        if (dwarf_lowpc(cudie,&cu_base,&error) == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+        walk_dies(dbg,cudie,cu_base);
+        dwarf_dealloc_die(cudie);
+    }
+    if (res == DW_DLV_ERROR) {
+        printf("FAIL test_die_ranges: reading %s\n",path);
+        dwarf_dealloc_error(dbg,error);
+        ++errcount;
+    }
+    dwarf_finish(dbg);
+    if (rangesdiecount == ranges_before) {
+        printf("FAIL test_die_ranges: no DW_AT_ranges in %s\n",
+            path);
+        ++errcount;
+    }
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    char path[2000];
+    const char *top = 0;
+    int i = 0;
+
+    if (argc > 1) {
+        for (i = 1; i < argc; ++i) {
+            errcount += test_object(argv[i]);
+        }
+    } else {
+        top = getenv("DWTOPSRCDIR");
+        if (!top) {
+            printf("FAIL test_die_ranges: no object path\n");
+            return 1;
+        }
+        for (i = 0; testobjs[i]; ++i) {
+            if (strlen(top) + strlen(testobjs[i]) >= sizeof(path)) {
+                printf("FAIL test_die_ranges: path too long\n");
+                return 1;
+            }
+            strcpy(path,top);
+            strcat(path,testobjs[i]);
+            errcount += test_object(path);
+        }
+    }
+    if (errcount) {
+        printf("FAIL test_die_ranges, %d errors\n",errcount);
+        return 1;
+    }
+    printf("PASS test_die_ranges: %lu DIEs with code addresses, "
+        "%lu with DW_AT_ranges\n",diecount,rangesdiecount);
+    return 0;
+}
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026 agent
+# This test script is hereby placed into the public domain
+# for anyone to use for any purpose.
+#
+# Checks dwarfdump output options whose output is not
+# compared against a baseline.
+# Run as:
+# test_dwarfdumpoptions.py buildsys sourcedirbase builddirbase
+# where buildsys is conf, cmake, or meson.
+# With no arguments (as make check runs it) the source
+# base is $DWTOPSRCDIR and the build base is the parent
+# of the working directory.
+
+import json
+import os
+import struct
+import sys
+from subprocess import Popen, PIPE
+
+testobjects = [
+    "testuriLE64ELf.obj",
+    "test-mach-o-32.dSYM",
+    "testobjLE32PE.exe",
+    # Has a .gnu_debuglink section.
+    "dummyexecutable",
+]
+
+errcount = 0
+
+
+def fail(msg):
+    global errcount
+    print("FAIL", msg)
+    errcount += 1
+
+
+# Returns stdout as a list of lines and the exit status.
+def rundwarfdump(dwarfdumppath, opts, objpath):
+    print("Run:", dwarfdumppath, " ".join(opts), objpath)
+    p1 = Popen([dwarfdumppath] + opts + [objpath], stdout=PIPE, stderr=PIPE)
+    bx, ex = p1.communicate()
+    return bx.decode("utf-8").splitlines(), p1.returncode
+
+
+# Every line of --format=json output must be one JSON
+# object with a type, whatever dwarfdump.conf is found
+# and whatever notices dwarfdump has to give.
+def test_json(dwarfdumppath, srcbase):
+    optsets = [
+        ["-a"],
+        ["-i", "-l", "-F"],
+        ["-x", "name=/nonexistent/dwarfdump.conf", "-a"],
+        ["--show-dwarfdump-conf", "-a"],
+    ]
+    for o in testobjects:
+        objpath = os.path.join(srcbase, "test", o)
+        for opts in optsets:
+            lines, r = rundwarfdump(
+                dwarfdumppath, ["--format=json"] + opts, objpath
+            )
+            if r != 0:
+                fail("--format=json exit status %d on %s" % (r, o))
+            if not lines:
+                fail("--format=json wrote nothing on %s" % o)
+            for n, s in enumerate(lines):
+                try:
+                    rec = json.loads(s)
+                except ValueError:
+                    fail("%s line %d is not JSON: %s" % (o, n + 1, s))
+                    break
+                if not isinstance(rec, dict) or "type" not in rec:
+                    fail("%s line %d has no type: %s" % (o, n + 1, s))
+                    break
+
+
+# Section name to contents, from the ELF section headers.
+def elfsections(path):
+    with open(path, "rb") as f:
+        b = f.read()
+    if b[0:4] != b"\x7fELF":
+        return {}
+    e = "<" if b[5] == 1 else ">"
+    if b[4] == 2:
+        shoff, = struct.unpack_from(e + "Q", b, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(e + "HHH", b, 0x3A)
+        hdr = e + "IIQQQQ"
+    else:
+        shoff, = struct.unpack_from(e + "I", b, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(e + "HHH", b, 0x2E)
+        hdr = e + "IIIIII"
+    sects = []
+    for i in range(shnum):
+        name, typ, flags, addr, off, size = struct.unpack_from(
+            hdr, b, shoff + i * shentsize
+        )
+        sects += [(name, off, size)]
+    strtab = sects[shstrndx][1]
+    out = {}
+    for name, off, size in sects:
+        start = strtab + name
+        out[b[start : b.index(b"\0", start)].decode()] = b[off : off + size]
+    return out
+
+
+# --size-report counts every byte of .debug_info,
+# and what --threads workers count is merged into
+# the same report a serial run prints.
+def test_size_report(dwarfdumppath, srcbase):
+    o = "testuriLE64ELf.obj"
+    objpath = os.path.join(srcbase, "test", o)
+    infosize = len(elfsections(objpath).get(".debug_info", b""))
+    if not infosize:
+        fail("no .debug_info size from the headers of %s" % o)
+    lines, r = rundwarfdump(
+        dwarfdumppath, ["--format=json", "--size-report"], objpath
+    )
+    summary = False
+    for s in lines:
+        rec = json.loads(s)
+        if rec["type"] == "size_summary":
+            summary = rec
+    if not summary:
+        fail("--size-report wrote no size_summary on %s" % o)
+    else:
+        if summary["unit_bytes"] != infosize:
+            fail(
+                "--size-report unit bytes %d, .debug_info is %d"
+                % (summary["unit_bytes"], infosize)
+            )
+        parts = (
+            summary["header_bytes"]
+            + summary["die_bytes"]
+            + summary["null_and_padding_bytes"]
+        )
+        if parts != summary["unit_bytes"]:
+            fail(
+                "--size-report parts add to %d, not %d"
+                % (parts, summary["unit_bytes"])
+            )
+    for o in testobjects:
+        objpath = os.path.join(srcbase, "test", o)
+        for fmt in [[], ["--format=json"]]:
+            serial, r = rundwarfdump(
+                dwarfdumppath, fmt + ["--size-report"], objpath
+            )
+            for t in ["--threads=2", "--threads=4"]:
+                threaded, r = rundwarfdump(
+                    dwarfdumppath, fmt + ["--size-report", t], objpath
+                )
+                if threaded != serial:
+                    fail("--size-report %s differs on %s" % (t, o))
+
+
+# --threads prints what a serial run prints: the CU
+# output in order and the -k summaries merged from
+# every worker.
+def test_threads(dwarfdumppath, srcbase):
+    for o in testobjects:
+        objpath = os.path.join(srcbase, "test", o)
+        for opts in [["-ka"], ["-i", "-l"]]:
+            serial, r = rundwarfdump(dwarfdumppath, opts, objpath)
+            for t in ["--threads=2", "--threads=4"]:
+                threaded, r = rundwarfdump(
+                    dwarfdumppath, opts + [t], objpath
+                )
+                if threaded != serial:
+                    fail("%s %s differs on %s" % (" ".join(opts), t, o))
+
+
+# -s reads only the string section, which in a
+# split DWARF object is .debug_str.dwo.  Every string
+# in the section must be printed.
+def test_strings(dwarfdumppath, srcbase):
+    for o, sect in [
+        ("testuriLE64ELf.obj", ".debug_str"),
+        ("testsplitLE64Elf.dwo", ".debug_str.dwo"),
+    ]:
+        objpath = os.path.join(srcbase, "test", o)
+        strs = elfsections(objpath).get(sect, b"").split(b"\0")
+        strs = [x.decode() for x in strs if x]
+        if not strs:
+            fail("no strings in %s of %s" % (sect, o))
+        lines, r = rundwarfdump(dwarfdumppath, ["-s"], objpath)
+        printed = set()
+        for l in lines:
+            f = l.find(" is '")
+            if l.startswith("name at offset") and f != -1:
+                printed.add(l[f + 5 : -1])
+        for x in strs:
+            if x not in printed:
+                fail("-s did not print '%s' from %s" % (x, o))
+                break
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 4:
+        srcbase = sys.argv[2]
+        bldbase = sys.argv[3]
+    elif len(sys.argv) == 1 and "DWTOPSRCDIR" in os.environ:
+        srcbase = os.environ["DWTOPSRCDIR"]
+        bldbase = os.path.dirname(os.getcwd())
+    else:
+        print("FAIL test_dwarfdumpoptions.py arg count wrong")
+        sys.exit(1)
+    dwarfdumppath = os.path.join(bldbase, "src/bin/dwarfdump/dwarfdump")
+    test_json(dwarfdumppath, srcbase)
+    test_size_report(dwarfdumppath, srcbase)
+    test_threads(dwarfdumppath, srcbase)
+    test_strings(dwarfdumppath, srcbase)
+    if errcount:
+        print("FAIL test_dwarfdumpoptions.py,", errcount, "errors")
+        sys.exit(1)
+    print("PASS test_dwarfdumpoptions.py")
+    sys.exit(0)
@@ -190,6 +190,18 @@ int main(void)
         validate_esb(12,&d,0,25,"",__LINE__);
         esb_destructor(&d);
     }
+    {
+        struct esb_s d;
+        static char digits[4] = {'1','2','3','4'};
+
+        esb_constructor(&d);
+        /*  No NUL follows the bytes. */
+        esb_append_bytes(&d,digits,3);
+        validate_esb(22,&d,3,4,"123",__LINE__);
+        esb_append_bytes(&d,"x",0);
+        validate_esb(23,&d,3,4,"123",__LINE__);
+        esb_destructor(&d);
+    }
     {
         struct esb_s d;
 
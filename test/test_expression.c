@@ -0,0 +1,395 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  Tests dwarf_expr_compile() and dwarf_expr_evaluate().
+    Usage: test_expression <object>
+    or with env var DWTOPSRCDIR naming the source tree.
+    The object only provides a CU (address size,
+    version); the expressions are built here. */
+
+#include <config.h>
+
+#include <stdio.h>  /* printf() */
+#include <stdlib.h> /* getenv() */
+#include <string.h> /* strlen() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h" /* TRUE FALSE */
+
+#define TESTOBJ "/test/testuriLE64ELf.obj"
+
+static int errcount;
+
+static void
+check(int cond, const char *msg, int line)
+{
+    if (!cond) {
+        printf("FAIL %s line %d\n",msg,line);
+        ++errcount;
+    }
+}
+
+/*  Machine state seen by the callbacks.
+    Registers are 1000 plus the register number,
+    memory at address a holds a+1. */
+struct machine_s {
+    int m_frame_base_missing;
+    int m_reads;
+};
+
+static int
+read_register(void *ud, Dwarf_Unsigned regnum,
+    Dwarf_Unsigned *value_out)
+{
+    (void)ud;
+    *value_out = 1000 + regnum;
+    return DW_DLV_OK;
+}
+
+static int
+read_memory(void *ud, Dwarf_Addr addr, Dwarf_Small size,
+    Dwarf_Unsigned *value_out)
+{
+    struct machine_s *m = (struct machine_s *)ud;
+
+    m->m_reads++;
+    *value_out = addr + 1;
+    if (size < sizeof(Dwarf_Unsigned)) {
+        *value_out &= (((Dwarf_Unsigned)1) << (size*8)) -1;
+    }
+    return DW_DLV_OK;
+}
+
+static int
+frame_base(void *ud, Dwarf_Addr *fb_out)
+{
+    struct machine_s *m = (struct machine_s *)ud;
+
+    if (m->m_frame_base_missing) {
+        return DW_DLV_NO_ENTRY;
+    }
+    *fb_out = 0x7000;
+    return DW_DLV_OK;
+}
+
+static int
+call_frame_cfa(void *ud, Dwarf_Addr *cfa_out)
+{
+    (void)ud;
+    *cfa_out = 0x8000;
+    return DW_DLV_OK;
+}
+
+/*  Compiles and evaluates one expression.
+    Returns the dwarf_expr_compile() result if that
+    was not DW_DLV_OK, else the evaluation result. */
+static int
+run(Dwarf_Debug dbg, Dwarf_Die die,
+    const unsigned char *bytes, Dwarf_Unsigned len,
+    Dwarf_Expr_Callbacks *cb,
+    Dwarf_Bool push_initial, Dwarf_Unsigned initial,
+    Dwarf_Expr_Result *result,
+    Dwarf_Unsigned *insn_count)
+{
+    Dwarf_Expr_Program prog = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned srcops = 0;
+    int res = 0;
+
+    memset(result,0,sizeof(*result));
+    res = dwarf_expr_compile(die,(Dwarf_Ptr)bytes,len,
+        &prog,&error);
+    if (res != DW_DLV_OK) {
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        return res;
+    }
+    if (insn_count) {
+        dwarf_expr_program_sizes(prog,&srcops,insn_count);
+    }
+    res = dwarf_expr_evaluate(prog,cb,push_initial,initial,
+        result,&error);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+    }
+    dwarf_dealloc_expr_program(prog);
+    return res;
+}
+
+#define RUN(b,pi,iv) run(dbg,die,b,sizeof(b),&cb,pi,iv,&r,&insns)
+
+static void
+test_values(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    struct machine_s m;
+    Dwarf_Expr_Callbacks cb;
+    Dwarf_Expr_Result r;
+    Dwarf_Unsigned insns = 0;
+    int res = 0;
+    /* lit2 lit3 plus : folds to one constant */
+    static const unsigned char e_fold[] = {
+        DW_OP_lit2,DW_OP_lit3,DW_OP_plus};
+    /* breg6 -16 */
+    static const unsigned char e_breg[] = {
+        DW_OP_breg6,0x70};
+    /* fbreg 8 deref */
+    static const unsigned char e_fbreg[] = {
+        DW_OP_fbreg,0x08,DW_OP_deref};
+    /* reg3 */
+    static const unsigned char e_reg[] = {DW_OP_reg3};
+    /* constu 300 stack_value */
+    static const unsigned char e_value[] = {
+        DW_OP_constu,0xac,0x02,DW_OP_stack_value};
+    /* plus_uconst 8 with an initial value */
+    static const unsigned char e_member[] = {
+        DW_OP_plus_uconst,0x08};
+    /*  bra +4; lit7; skip +1; lit5
+        the condition is the initial value. */
+    static const unsigned char e_branch[] = {
+        DW_OP_bra,0x04,0x00,DW_OP_lit7,
+        DW_OP_skip,0x01,0x00,DW_OP_lit5};
+    /* lit1 lit2 swap minus : 2-1 */
+    static const unsigned char e_swap[] = {
+        DW_OP_lit1,DW_OP_lit2,DW_OP_swap,DW_OP_minus};
+    /* call_frame_cfa lit8 minus deref_size 2 */
+    static const unsigned char e_cfa[] = {
+        DW_OP_call_frame_cfa,DW_OP_lit8,DW_OP_minus,
+        DW_OP_deref_size,0x02};
+    /* lit0 not : all ones for an 8 byte address */
+    static const unsigned char e_not[] = {
+        DW_OP_lit0,DW_OP_not,DW_OP_stack_value};
+
+    memset(&m,0,sizeof(m));
+    memset(&cb,0,sizeof(cb));
+    cb.ec_user_data = &m;
+    cb.ec_read_register = read_register;
+    cb.ec_read_memory = read_memory;
+    cb.ec_frame_base = frame_base;
+    cb.ec_call_frame_cfa = call_frame_cfa;
+
+    res = RUN(e_fold,FALSE,0);
+    check(res == DW_DLV_OK && r.er_kind == DW_EXPR_RESULT_memory &&
+        r.er_value == 5,"lit2 lit3 plus",__LINE__);
+    check(insns == 1,"lit2 lit3 plus not folded",__LINE__);
+
+    res = RUN(e_breg,FALSE,0);
+    check(res == DW_DLV_OK && r.er_kind == DW_EXPR_RESULT_memory &&
+        r.er_value == 1006 - 16,"breg6 -16",__LINE__);
+
+    res = RUN(e_fbreg,FALSE,0);
+    check(res == DW_DLV_OK && r.er_value == 0x7009 &&
+        m.m_reads == 1,"fbreg 8 deref",__LINE__);
+
+    res = RUN(e_reg,FALSE,0);
+    check(res == DW_DLV_OK &&
+        r.er_kind == DW_EXPR_RESULT_register &&
+        r.er_value == 3,"reg3",__LINE__);
+
+    res = RUN(e_value,FALSE,0);
+    check(res == DW_DLV_OK && r.er_kind == DW_EXPR_RESULT_value &&
+        r.er_value == 300,"constu stack_value",__LINE__);
+
+    res = RUN(e_member,TRUE,100);
+    check(res == DW_DLV_OK && r.er_value == 108,
+        "plus_uconst on initial value",__LINE__);
+
+    res = RUN(e_branch,TRUE,0);
+    check(res == DW_DLV_OK && r.er_value == 7,
+        "bra not taken",__LINE__);
+    res = RUN(e_branch,TRUE,1);
+    check(res == DW_DLV_OK && r.er_value == 5,
+        "bra taken",__LINE__);
+
+    res = RUN(e_swap,FALSE,0);
+    check(res == DW_DLV_OK && r.er_value == 1,
+        "swap minus",__LINE__);
+
+    res = RUN(e_cfa,FALSE,0);
+    check(res == DW_DLV_OK && r.er_value == ((0x8000-8+1)&0xffff),
+        "call_frame_cfa deref_size",__LINE__);
+
+    res = RUN(e_not,FALSE,0);
+    check(res == DW_DLV_OK && r.er_value == ~(Dwarf_Unsigned)0,
+        "lit0 not",__LINE__);
+
+    /*  A callback reporting the value unavailable
+        makes the whole evaluation NO_ENTRY. */
+    m.m_frame_base_missing = TRUE;
+    res = RUN(e_fbreg,FALSE,0);
+    check(res == DW_DLV_NO_ENTRY,"frame base unavailable",
+        __LINE__);
+    m.m_frame_base_missing = FALSE;
+}
+
+static void
+test_errors(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    struct machine_s m;
+    Dwarf_Expr_Callbacks cb;
+    Dwarf_Expr_Result r;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned insns = 0;
+    int res = 0;
+    static const unsigned char e_plus[] = {DW_OP_plus};
+    static const unsigned char e_drop[] = {
+        DW_OP_lit1,DW_OP_drop,DW_OP_drop};
+    static const unsigned char e_rot[] = {
+        DW_OP_lit1,DW_OP_lit2,DW_OP_rot};
+    static const unsigned char e_pick[] = {
+        DW_OP_lit1,DW_OP_pick,0x01};
+    static const unsigned char e_stack_value[] = {
+        DW_OP_stack_value};
+    static const unsigned char e_div0[] = {
+        DW_OP_lit1,DW_OP_lit0,DW_OP_div};
+    /* const4u with only two operand bytes */
+    static const unsigned char e_truncated[] = {
+        DW_OP_const4u,0x01,0x02};
+    /* skip into the middle of const2u */
+    static const unsigned char e_badtarget[] = {
+        DW_OP_skip,0x01,0x00,DW_OP_const2u,0x01,0x02};
+    static const unsigned char e_deref_size[] = {
+        DW_OP_lit1,DW_OP_deref_size,0x09};
+    static const unsigned char e_loop[] = {
+        DW_OP_skip,0xfd,0xff};
+    /* Not supported: fall back to the operator list. */
+    static const unsigned char e_piece[] = {
+        DW_OP_reg0,DW_OP_piece,0x04};
+    static const unsigned char e_reg_not_last[] = {
+        DW_OP_reg0,DW_OP_lit1};
+    static const unsigned char e_fbreg[] = {DW_OP_fbreg,0x00};
+
+    memset(&m,0,sizeof(m));
+    memset(&cb,0,sizeof(cb));
+    cb.ec_user_data = &m;
+    cb.ec_read_memory = read_memory;
+
+    check(RUN(e_plus,FALSE,0) == DW_DLV_ERROR,
+        "plus on an empty stack",__LINE__);
+    check(RUN(e_plus,TRUE,1) == DW_DLV_ERROR,
+        "plus with one entry",__LINE__);
+    check(RUN(e_drop,FALSE,0) == DW_DLV_ERROR,
+        "drop on an empty stack",__LINE__);
+    check(RUN(e_rot,FALSE,0) == DW_DLV_ERROR,
+        "rot with two entries",__LINE__);
+    check(RUN(e_pick,FALSE,0) == DW_DLV_ERROR,
+        "pick past the stack",__LINE__);
+    check(RUN(e_stack_value,FALSE,0) == DW_DLV_ERROR,
+        "stack_value on an empty stack",__LINE__);
+    check(RUN(e_div0,FALSE,0) == DW_DLV_ERROR,
+        "division by zero",__LINE__);
+    check(RUN(e_truncated,FALSE,0) == DW_DLV_ERROR,
+        "truncated operand",__LINE__);
+    check(RUN(e_badtarget,FALSE,0) == DW_DLV_ERROR,
+        "branch into an operand",__LINE__);
+    check(RUN(e_deref_size,FALSE,0) == DW_DLV_ERROR,
+        "deref_size larger than an address",__LINE__);
+    check(RUN(e_loop,FALSE,0) == DW_DLV_ERROR,
+        "endless loop",__LINE__);
+    check(RUN(e_fbreg,FALSE,0) == DW_DLV_ERROR,
+        "fbreg without a frame base callback",__LINE__);
+    check(RUN(e_piece,FALSE,0) == DW_DLV_NO_ENTRY,
+        "piece is not compiled",__LINE__);
+    check(RUN(e_reg_not_last,FALSE,0) == DW_DLV_NO_ENTRY,
+        "reg not last is not compiled",__LINE__);
+    /* An empty expression means optimized out. */
+    res = run(dbg,die,e_plus,0,&cb,FALSE,0,&r,&insns);
+    check(res == DW_DLV_NO_ENTRY,"empty expression",__LINE__);
+
+    res = dwarf_expr_evaluate(0,&cb,FALSE,0,&r,&error);
+    check(res == DW_DLV_ERROR,"null program",__LINE__);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        error = 0;
+    }
+    res = dwarf_expr_compile(die,0,4,0,&error);
+    check(res == DW_DLV_ERROR,"null arguments",__LINE__);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        error = 0;
+    }
+    check(dwarf_expr_program_sizes(0,0,0) == DW_DLV_NO_ENTRY,
+        "sizes of a null program",__LINE__);
+}
+
+int
+main(int argc, char **argv)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Die die = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned next = 0;
+    Dwarf_Half cutype = 0;
+    char path[2000];
+    const char *top = 0;
+    int res = 0;
+
+    if (argc > 1) {
+        top = argv[1];
+    } else {
+        top = getenv("DWTOPSRCDIR");
+        if (!top || strlen(top) + sizeof(TESTOBJ) > sizeof(path)) {
+            printf("FAIL test_expression: no object path\n");
+            return 1;
+        }
+        strcpy(path,top);
+        strcat(path,TESTOBJ);
+        top = path;
+    }
+    res = dwarf_init_path(top,0,0,DW_GROUPNUMBER_ANY,0,0,
+        &dbg,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL test_expression: cannot open %s\n",top);
+        return 1;
+    }
+    res = dwarf_next_cu_header_d(dbg,TRUE,0,0,0,0,0,0,0,0,
+        &next,&cutype,&error);
+    if (res == DW_DLV_OK) {
+        res = dwarf_siblingof_b(dbg,0,TRUE,&die,&error);
+    }
+    if (res != DW_DLV_OK) {
+        printf("FAIL test_expression: no CU die in %s\n",top);
+        dwarf_finish(dbg);
+        return 1;
+    }
+    test_values(dbg,die);
+    test_errors(dbg,die);
+    dwarf_dealloc_die(die);
+    dwarf_finish(dbg);
+    if (errcount) {
+        printf("FAIL test_expression, %d errors\n",errcount);
+        return 1;
+    }
+    printf("PASS test_expression\n");
+    return 0;
+}
@@ -148,6 +148,56 @@ test1(Dwarf_P_Debug dbg)
         dbg->de_line_inits.pi_line_base,0,
         __LINE__);
 
+    resetdbg(dbg);
+    err = 0;
+    res = _dwarf_log_extra_flagstrings(dbg,"parallel_transform=1",
+        &err);
+    check_expected(DW_DLV_OK,res,0,err,1,
+        dbg->de_parallel_transform,
+        __LINE__);
+
+    resetdbg(dbg);
+    err = 0;
+    res = _dwarf_log_extra_flagstrings(dbg,"str_tail_merge=1",
+        &err);
+    check_expected(DW_DLV_OK,res,0,err,1,
+        dbg->de_str_tail_merge,
+        __LINE__);
+
+    resetdbg(dbg);
+    err = 0;
+    res = _dwarf_log_extra_flagstrings(dbg,"use_addrx=1",
+        &err);
+    check_expected(DW_DLV_OK,res,0,err,1,
+        dbg->de_use_addrx,
+        __LINE__);
+
+    resetdbg(dbg);
+    err = 0;
+    res = _dwarf_log_extra_flagstrings(dbg,
+        "optimize_line_program=1",&err);
+    check_expected(DW_DLV_OK,res,0,err,1,
+        dbg->de_optimize_line_program,
+        __LINE__);
+
+#ifdef HAVE_ZLIB
+    resetdbg(dbg);
+    err = 0;
+    res = _dwarf_log_extra_flagstrings(dbg,
+        "compress_debug_sections=1",&err);
+    check_expected(DW_DLV_OK,res,0,err,1,
+        dbg->de_compress_sections,
+        __LINE__);
+#endif /* HAVE_ZLIB */
+
+    resetdbg(dbg);
+    err = 0;
+    res = _dwarf_log_extra_flagstrings(dbg,
+        "compress_debug_sections=7",&err);
+    check_expected(DW_DLV_ERROR,res,err,
+        DW_DLE_PRO_COMPRESS_UNSUPPORTED,
+        dbg->de_compress_sections,0,
+        __LINE__);
 }
 static void
 test2(Dwarf_P_Debug dbg)
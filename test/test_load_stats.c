@@ -0,0 +1,353 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  Tests dwarf_get_section_load_stats() and
+    dwarf_get_alloc_stats() after reading every DIE,
+    attribute and line table of an object.
+    Each loaded section must count its whole size as
+    read and its whole relocation section as applied.
+    The DIE and attribute counts must be non-zero and,
+    as all of them are deallocated here, balanced.
+    Usage: test_load_stats <object> ...
+    or with env var DWTOPSRCDIR naming the source tree. */
+
+#include <config.h>
+
+#include <stdio.h>  /* printf() snprintf() */
+#include <stdlib.h> /* getenv() */
+#include <string.h> /* strcat() strcmp() strcpy() strlen() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h" /* TRUE FALSE */
+
+static const char *testobjs[] = {
+"/test/testuriLE64ELf.obj",   /* relocatable, .rela sections */
+"/test/testdw5LE64Elf.obj",   /* DWARF5 */
+"/test/testsplitLE64Elf.dwo", /* .dwo sections */
+0
+};
+
+/*  Reading every DIE must load these (or their .dwo
+    forms) when the object has them. */
+static const char *must_load[] = {
+".debug_info",
+".debug_abbrev",
+".debug_str",
+".debug_line",
+".debug_info.dwo",
+".debug_abbrev.dwo",
+".debug_str.dwo",
+0
+};
+
+static int errcount;
+
+static void
+read_attrs(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    Dwarf_Attribute *attrs = 0;
+    Dwarf_Signed count = 0;
+    Dwarf_Signed i = 0;
+    Dwarf_Error error = 0;
+    char *name = 0;
+    int res = 0;
+
+    res = dwarf_diename(die,&name,&error);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        error = 0;
+    }
+    res = dwarf_attrlist(die,&attrs,&count,&error);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        return;
+    }
+    if (res == DW_DLV_NO_ENTRY) {
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        dwarf_dealloc_attribute(attrs[i]);
+    }
+    dwarf_dealloc(dbg,attrs,DW_DLA_LIST);
+}
+
+static void
+walk_dies(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Bool is_info)
+{
+    Dwarf_Die cur = die;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    for (;;) {
+        Dwarf_Die child = 0;
+        Dwarf_Die sib = 0;
+
+        read_attrs(dbg,cur);
+        res = dwarf_child(cur,&child,&error);
+        if (res == DW_DLV_OK) {
+            walk_dies(dbg,child,is_info);
+            dwarf_dealloc_die(child);
+        } else if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+        res = dwarf_siblingof_b(dbg,cur,is_info,&sib,&error);
+        if (cur != die) {
+            dwarf_dealloc_die(cur);
+        }
+        if (res != DW_DLV_OK) {
+            if (res == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+            return;
+        }
+        cur = sib;
+    }
+}
+
+static void
+read_lines(Dwarf_Debug dbg, Dwarf_Die cudie)
+{
+    Dwarf_Unsigned version = 0;
+    Dwarf_Small table_count = 0;
+    Dwarf_Line_Context context = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_srclines_b(cudie,&version,&table_count,
+        &context,&error);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        return;
+    }
+    if (res == DW_DLV_OK) {
+        dwarf_srclines_dealloc_b(context);
+    }
+}
+
+static Dwarf_Unsigned
+section_size(Dwarf_Debug dbg, const char *name)
+{
+    Dwarf_Addr addr = 0;
+    Dwarf_Unsigned size = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_get_section_info_by_name(dbg,name,&addr,&size,
+        &error);
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+        return 0;
+    }
+    if (res == DW_DLV_NO_ENTRY) {
+        return 0;
+    }
+    return size;
+}
+
+static void
+check_load_stats(Dwarf_Debug dbg, const char *path)
+{
+    unsigned i = 0;
+    unsigned loaded = 0;
+
+    for (i = 0; ; ++i) {
+        const char *name = 0;
+        Dwarf_Unsigned bytes_read = 0;
+        Dwarf_Unsigned bytes_decompressed = 0;
+        Dwarf_Unsigned reloc_bytes = 0;
+        Dwarf_Unsigned size = 0;
+        char relname[100];
+        int k = 0;
+        int res = 0;
+
+        res = dwarf_get_section_load_stats(dbg,i,&name,
+            &bytes_read,&bytes_decompressed,&reloc_bytes);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        size = section_size(dbg,name);
+        if (bytes_read) {
+            ++loaded;
+            if (bytes_read != size) {
+                printf("FAIL %s %s read %" DW_PR_DUu
+                    " bytes, its size is %" DW_PR_DUu "\n",
+                    path,name,bytes_read,size);
+                ++errcount;
+            }
+        } else {
+            for (k = 0; must_load[k]; ++k) {
+                if (!strcmp(name,must_load[k]) && size) {
+                    printf("FAIL %s %s was not loaded\n",path,name);
+                    ++errcount;
+                }
+            }
+        }
+        if (bytes_decompressed) {
+            printf("FAIL %s %s is not compressed but "
+                "decompressed %" DW_PR_DUu " bytes\n",
+                path,name,bytes_decompressed);
+            ++errcount;
+        }
+        snprintf(relname,sizeof(relname),".rela%s",name);
+        size = bytes_read? section_size(dbg,relname) : 0;
+        if (reloc_bytes != size) {
+            printf("FAIL %s %s relocation bytes %" DW_PR_DUu
+                ", %s is %" DW_PR_DUu "\n",
+                path,name,reloc_bytes,relname,size);
+            ++errcount;
+        }
+    }
+    if (!loaded) {
+        printf("FAIL %s no section counted as loaded\n",path);
+        ++errcount;
+    }
+}
+
+static void
+check_alloc_stats(Dwarf_Debug dbg, const char *path)
+{
+    unsigned t = 0;
+
+    for (t = 1; ; ++t) {
+        Dwarf_Unsigned count = 0;
+        Dwarf_Unsigned bytes = 0;
+        Dwarf_Unsigned deallocs = 0;
+        int res = 0;
+
+        res = dwarf_get_alloc_stats(dbg,t,&count,&bytes,&deallocs);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        if (deallocs > count) {
+            printf("FAIL %s DW_DLA 0x%x %" DW_PR_DUu
+                " deallocations of %" DW_PR_DUu "\n",
+                path,t,deallocs,count);
+            ++errcount;
+        }
+        if (!count != !bytes) {
+            printf("FAIL %s DW_DLA 0x%x %" DW_PR_DUu
+                " allocations of %" DW_PR_DUu " bytes\n",
+                path,t,count,bytes);
+            ++errcount;
+        }
+        if (t == DW_DLA_DIE || t == DW_DLA_ATTR) {
+            /*  Every one read here was deallocated. */
+            if (!count || deallocs != count) {
+                printf("FAIL %s DW_DLA 0x%x %" DW_PR_DUu
+                    " allocations, %" DW_PR_DUu " deallocations\n",
+                    path,t,count,deallocs);
+                ++errcount;
+            }
+        }
+    }
+    if (t <= DW_DLA_ATTR) {
+        printf("FAIL %s DW_DLA 0x%x has no counts\n",path,t);
+        ++errcount;
+    }
+}
+
+static int
+test_object(const char *path)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_init_path(path,0,0,DW_GROUPNUMBER_ANY,0,0,
+        &dbg,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL test_load_stats: cannot open %s\n",path);
+        return 1;
+    }
+    for (;;) {
+        Dwarf_Die cudie = 0;
+
+        res = dwarf_next_cu_header_d(dbg,TRUE,0,0,0,0,0,0,0,0,
+            0,0,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        res = dwarf_siblingof_b(dbg,0,TRUE,&cudie,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        read_lines(dbg,cudie);
+        walk_dies(dbg,cudie,TRUE);
+        dwarf_dealloc_die(cudie);
+    }
+    if (res == DW_DLV_ERROR) {
+        printf("FAIL test_load_stats: reading %s\n",path);
+        dwarf_dealloc_error(dbg,error);
+        ++errcount;
+    }
+    check_load_stats(dbg,path);
+    check_alloc_stats(dbg,path);
+    dwarf_finish(dbg);
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    char path[2000];
+    const char *top = 0;
+    int i = 0;
+
+    if (argc > 1) {
+        for (i = 1; i < argc; ++i) {
+            errcount += test_object(argv[i]);
+        }
+    } else {
+        top = getenv("DWTOPSRCDIR");
+        if (!top) {
+            printf("FAIL test_load_stats: no object path\n");
+            return 1;
+        }
+        for (i = 0; testobjs[i]; ++i) {
+            if (strlen(top) + strlen(testobjs[i]) >= sizeof(path)) {
+                printf("FAIL test_load_stats: path too long\n");
+                return 1;
+            }
+            strcpy(path,top);
+            strcat(path,testobjs[i]);
+            errcount += test_object(path);
+        }
+    }
+    if (errcount) {
+        printf("FAIL test_load_stats, %d errors\n",errcount);
+        return 1;
+    }
+    printf("PASS test_load_stats\n");
+    return 0;
+}
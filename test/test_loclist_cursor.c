@@ -0,0 +1,429 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  Tests dwarf_loclist_cursor_init()/_next() by walking
+    every location attribute of the objects named
+    and comparing each entry with what dwarf_get_loclist_c()
+    and dwarf_get_locdesc_entry_d() report.
+    Usage: test_loclist_cursor <object> ...
+    or with env var DWTOPSRCDIR naming the source tree. */
+
+#include <config.h>
+
+#include <stdio.h>  /* printf() */
+#include <stdlib.h> /* getenv() */
+#include <string.h> /* strlen() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h" /* TRUE FALSE */
+
+static const char *testobjs[] = {
+"/test/testuriLE64ELf.obj",  /* DWARF4 .debug_loc */
+"/test/testdw5LE64Elf.obj",  /* DWARF5 .debug_loclists */
+0
+};
+
+static int errcount;
+static unsigned long listcount;
+static unsigned long entrycount;
+
+static void
+fail(const char *msg, Dwarf_Off dieoff, int line)
+{
+    printf("FAIL %s at DIE 0x%llx line %d\n",msg,
+        (unsigned long long)dieoff,line);
+    ++errcount;
+}
+
+/*  Base address and end entries are applied by the
+    cursor, not returned. */
+static int
+is_returned_entry(Dwarf_Small lle)
+{
+    switch (lle) {
+    case DW_LLE_end_of_list:
+    case DW_LLE_base_address:
+    case DW_LLE_base_addressx:
+        return FALSE;
+    default: break;
+    }
+    return TRUE;
+}
+
+/*  Compare the operators of an entry as libdwarf decoded
+    them with the decoding of the cursor's bytes. */
+static void
+compare_ops(Dwarf_Debug dbg, Dwarf_Locdesc_c desc,
+    Dwarf_Unsigned opcount,
+    Dwarf_Ptr bytes, Dwarf_Unsigned len,
+    Dwarf_Half version, Dwarf_Half offset_size,
+    Dwarf_Half address_size, Dwarf_Off dieoff)
+{
+    Dwarf_Loc_Head_c head = 0;
+    Dwarf_Locdesc_c cdesc = 0;
+    Dwarf_Unsigned listlen = 0;
+    Dwarf_Unsigned copcount = 0;
+    Dwarf_Small lle = 0;
+    Dwarf_Unsigned u = 0;
+    Dwarf_Bool unavail = 0;
+    Dwarf_Addr a = 0;
+    Dwarf_Small src = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned i = 0;
+    int res = 0;
+
+    if (!len) {
+        if (opcount) {
+            fail("cursor expression empty",dieoff,__LINE__);
+        }
+        return;
+    }
+    res = dwarf_loclist_from_expr_c(dbg,bytes,len,address_size,
+        offset_size,(Dwarf_Small)version,&head,&listlen,&error);
+    if (res != DW_DLV_OK) {
+        fail("cursor expression does not decode",dieoff,__LINE__);
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        return;
+    }
+    res = dwarf_get_locdesc_entry_d(head,0,&lle,&u,&u,&unavail,
+        &a,&a,&copcount,&cdesc,&src,&u,&u,&error);
+    if (res != DW_DLV_OK || copcount != opcount) {
+        fail("operator count differs",dieoff,__LINE__);
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        dwarf_dealloc_loc_head_c(head);
+        return;
+    }
+    for (i = 0; i < opcount; ++i) {
+        Dwarf_Small op1 = 0;
+        Dwarf_Small op2 = 0;
+        Dwarf_Unsigned a1 = 0,a2 = 0,a3 = 0,b1 = 0;
+        Dwarf_Unsigned c1 = 0,c2 = 0,c3 = 0,d1 = 0;
+        int r1 = 0;
+        int r2 = 0;
+
+        r1 = dwarf_get_location_op_value_c(desc,i,&op1,
+            &a1,&a2,&a3,&b1,&error);
+        if (r1 == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+        r2 = dwarf_get_location_op_value_c(cdesc,i,&op2,
+            &c1,&c2,&c3,&d1,&error);
+        if (r2 == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+        if (r1 != r2 || op1 != op2 || a1 != c1 || a2 != c2 ||
+            a3 != c3 || b1 != d1) {
+            fail("operator differs",dieoff,__LINE__);
+            break;
+        }
+    }
+    dwarf_dealloc_loc_head_c(head);
+}
+
+static void
+compare_attr(Dwarf_Debug dbg, Dwarf_Attribute attr,
+    Dwarf_Half version, Dwarf_Half offset_size,
+    Dwarf_Half address_size, Dwarf_Off dieoff)
+{
+    Dwarf_Loc_Head_c head = 0;
+    Dwarf_Unsigned count = 0;
+    Dwarf_Loclist_Cursor cursor;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned i = 0;
+    int res = 0;
+    int cres = 0;
+
+    res = dwarf_get_loclist_c(attr,&head,&count,&error);
+    cres = dwarf_loclist_cursor_init(attr,&cursor,&error);
+    if (res != cres) {
+        fail("cursor init and dwarf_get_loclist_c disagree",
+            dieoff,__LINE__);
+    }
+    if (res != DW_DLV_OK || cres != DW_DLV_OK) {
+        if (res == DW_DLV_ERROR || cres == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        if (res == DW_DLV_OK) {
+            dwarf_dealloc_loc_head_c(head);
+        }
+        return;
+    }
+    ++listcount;
+    for (i = 0; i < count; ++i) {
+        Dwarf_Small lle = 0;
+        Dwarf_Unsigned rawlo = 0;
+        Dwarf_Unsigned rawhi = 0;
+        Dwarf_Bool unavail = 0;
+        Dwarf_Addr lowpc = 0;
+        Dwarf_Addr hipc = 0;
+        Dwarf_Unsigned opcount = 0;
+        Dwarf_Locdesc_c desc = 0;
+        Dwarf_Small source = 0;
+        Dwarf_Unsigned exproff = 0;
+        Dwarf_Unsigned descoff = 0;
+        Dwarf_Small c_lle = 0;
+        Dwarf_Addr c_lowpc = 0;
+        Dwarf_Addr c_hipc = 0;
+        Dwarf_Bool c_unavail = 0;
+        Dwarf_Ptr c_bytes = 0;
+        Dwarf_Unsigned c_len = 0;
+
+        res = dwarf_get_locdesc_entry_d(head,i,&lle,&rawlo,
+            &rawhi,&unavail,&lowpc,&hipc,&opcount,&desc,
+            &source,&exproff,&descoff,&error);
+        if (res != DW_DLV_OK) {
+            fail("dwarf_get_locdesc_entry_d failed",dieoff,
+                __LINE__);
+            if (res == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+            break;
+        }
+        if (!is_returned_entry(lle)) {
+            continue;
+        }
+        cres = dwarf_loclist_cursor_next(&cursor,&c_lle,
+            &c_lowpc,&c_hipc,&c_unavail,&c_bytes,&c_len,&error);
+        if (cres != DW_DLV_OK) {
+            fail("cursor ended early",dieoff,__LINE__);
+            if (cres == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+            break;
+        }
+        ++entrycount;
+        if (c_lle != lle) {
+            fail("DW_LLE code differs",dieoff,__LINE__);
+        }
+        if (c_unavail != unavail) {
+            fail("address availability differs",dieoff,__LINE__);
+        }
+        /*  A single expression covers all addresses,
+            dwarf_get_loclist_c() reports no range for it. */
+        if (source != DW_LKIND_expression &&
+            (c_lowpc != lowpc || c_hipc != hipc)) {
+            fail("address range differs",dieoff,__LINE__);
+        }
+        compare_ops(dbg,desc,opcount,c_bytes,c_len,version,
+            offset_size,address_size,dieoff);
+    }
+    if (i == count) {
+        Dwarf_Small c_lle = 0;
+        Dwarf_Addr c_lowpc = 0;
+        Dwarf_Addr c_hipc = 0;
+        Dwarf_Bool c_unavail = 0;
+        Dwarf_Ptr c_bytes = 0;
+        Dwarf_Unsigned c_len = 0;
+
+        cres = dwarf_loclist_cursor_next(&cursor,&c_lle,
+            &c_lowpc,&c_hipc,&c_unavail,&c_bytes,&c_len,&error);
+        if (cres != DW_DLV_NO_ENTRY) {
+            fail("cursor returns extra entries",dieoff,__LINE__);
+            if (cres == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+        }
+    }
+    dwarf_dealloc_loc_head_c(head);
+}
+
+static int
+is_location_class(enum Dwarf_Form_Class cl)
+{
+    return cl == DW_FORM_CLASS_LOCLIST ||
+        cl == DW_FORM_CLASS_LOCLISTPTR ||
+        cl == DW_FORM_CLASS_LOCLISTSPTR ||
+        cl == DW_FORM_CLASS_EXPRLOC;
+}
+
+static void
+check_die(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    Dwarf_Attribute *attrs = 0;
+    Dwarf_Signed attrcount = 0;
+    Dwarf_Half version = 0;
+    Dwarf_Half offset_size = 0;
+    Dwarf_Half address_size = 0;
+    Dwarf_Off dieoff = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Signed i = 0;
+    int res = 0;
+
+    res = dwarf_attrlist(die,&attrs,&attrcount,&error);
+    if (res != DW_DLV_OK) {
+        if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+        }
+        return;
+    }
+    dwarf_get_version_of_die(die,&version,&offset_size);
+    dwarf_get_die_address_size(die,&address_size,&error);
+    dwarf_dieoffset(die,&dieoff,&error);
+    for (i = 0; i < attrcount; ++i) {
+        Dwarf_Half attrnum = 0;
+        Dwarf_Half form = 0;
+
+        if (dwarf_whatattr(attrs[i],&attrnum,&error) == DW_DLV_OK &&
+            dwarf_whatform(attrs[i],&form,&error) == DW_DLV_OK &&
+            is_location_class(dwarf_get_form_class(version,
+                attrnum,offset_size,form))) {
+            compare_attr(dbg,attrs[i],version,offset_size,
+                address_size,dieoff);
+        }
+        dwarf_dealloc_attribute(attrs[i]);
+    }
+    dwarf_dealloc(dbg,attrs,DW_DLA_LIST);
+}
+
+/*  Checks die, its children and its later siblings.
+    The caller deallocs die. */
+static void
+walk_dies(Dwarf_Debug dbg, Dwarf_Die die)
+{
+    Dwarf_Die cur = die;
+    Dwarf_Error error = 0;
+
+    for (;;) {
+        Dwarf_Die child = 0;
+        Dwarf_Die sib = 0;
+        int res = 0;
+
+        check_die(dbg,cur);
+        res = dwarf_child(cur,&child,&error);
+        if (res == DW_DLV_OK) {
+            walk_dies(dbg,child);
+            dwarf_dealloc_die(child);
+        } else if (res == DW_DLV_ERROR) {
+            dwarf_dealloc_error(dbg,error);
+            error = 0;
+        }
+        res = dwarf_siblingof_b(dbg,cur,TRUE,&sib,&error);
+        if (cur != die) {
+            dwarf_dealloc_die(cur);
+        }
+        if (res != DW_DLV_OK) {
+            if (res == DW_DLV_ERROR) {
+                dwarf_dealloc_error(dbg,error);
+            }
+            return;
+        }
+        cur = sib;
+    }
+}
+
+static int
+test_object(const char *path)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    unsigned long lists_before = listcount;
+    int res = 0;
+
+    res = dwarf_init_path(path,0,0,DW_GROUPNUMBER_ANY,0,0,
+        &dbg,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL test_loclist_cursor: cannot open %s\n",path);
+        return 1;
+    }
+    for (;;) {
+        Dwarf_Unsigned next = 0;
+        Dwarf_Half cutype = 0;
+        Dwarf_Die cudie = 0;
+
+        res = dwarf_next_cu_header_d(dbg,TRUE,0,0,0,0,0,0,0,0,
+            &next,&cutype,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        res = dwarf_siblingof_b(dbg,0,TRUE,&cudie,&error);
+        if (res != DW_DLV_OK) {
+            break;
+        }
+        walk_dies(dbg,cudie);
+        dwarf_dealloc_die(cudie);
+    }
+    if (res == DW_DLV_ERROR) {
+        printf("FAIL test_loclist_cursor: reading %s\n",path);
+        dwarf_dealloc_error(dbg,error);
+        ++errcount;
+    }
+    dwarf_finish(dbg);
+    if (listcount == lists_before) {
+        printf("FAIL test_loclist_cursor: no location lists "
+            "in %s\n",path);
+        ++errcount;
+    }
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    char path[2000];
+    const char *top = 0;
+    int i = 0;
+
+    if (argc > 1) {
+        for (i = 1; i < argc; ++i) {
+            errcount += test_object(argv[i]);
+        }
+    } else {
+        top = getenv("DWTOPSRCDIR");
+        if (!top) {
+            printf("FAIL test_loclist_cursor: no object path\n");
+            return 1;
+        }
+        for (i = 0; testobjs[i]; ++i) {
+            if (strlen(top) + strlen(testobjs[i]) >= sizeof(path)) {
+                printf("FAIL test_loclist_cursor: path too long\n");
+                return 1;
+            }
+            strcpy(path,top);
+            strcat(path,testobjs[i]);
+            errcount += test_object(path);
+        }
+    }
+    if (errcount) {
+        printf("FAIL test_loclist_cursor, %d errors\n",errcount);
+        return 1;
+    }
+    printf("PASS test_loclist_cursor: %lu location attributes, "
+        "%lu entries\n",listcount,entrycount);
+    return 0;
+}
@@ -0,0 +1,1839 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*  Round-trip tests of libdwarfp: DWARF5 is generated
+    in memory, the section bytes are collected, and
+    libdwarf reads them back through
+    dwarf_object_init_b() (as in
+    src/bin/dwarfexample/jitreader.c).
+    Relocations are not applied: every section
+    is at address zero, so the in-place values
+    are already right.
+    Takes no arguments. */
+
+#include <config.h>
+
+#include <ctype.h>  /* tolower() */
+#include <stdio.h>  /* printf() snprintf() */
+#include <stdlib.h> /* free() realloc() */
+#include <string.h> /* memcpy() memset() strcmp() strncmp() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarfp.h"
+#include "libdwarf_private.h" /* TRUE FALSE */
+#include "dwarf_pro_incl.h"
+#include "dwarf_pro_opaque.h" /* de_arena_end */
+
+static int errcount;
+
+#define MAXSECT 40
+struct section_s {
+    const char    *s_name;
+    Dwarf_Small   *s_bytes;
+    Dwarf_Unsigned s_size;
+    Dwarf_Unsigned s_flags;
+};
+
+struct reloc_s {
+    Dwarf_Signed   r_sect;
+    Dwarf_Unsigned r_offset;
+    Dwarf_Unsigned r_symidx;
+    unsigned       r_type;
+    unsigned       r_length;
+};
+
+/*  The sections of one generated object, indexed by
+    the number the section callback handed out.
+    Entry zero stays empty. */
+struct object_s {
+    int              o_count;
+    struct section_s o_sects[MAXSECT];
+    /*  Symbolic relocations, by the section they apply to. */
+    struct reloc_s  *o_relocs;
+    Dwarf_Unsigned   o_reloc_count;
+    Dwarf_Unsigned   o_reloc_alloc;
+    /*  Sections left SHF_COMPRESSED, and those
+        compression would not have made smaller. */
+    int              o_compressed;
+    int              o_uncompressed;
+    /*  From dwarf_pro_get_abbrev_stats() once generated. */
+    Dwarf_Unsigned   o_abbrev_lookups;
+    Dwarf_Unsigned   o_abbrev_hits;
+    Dwarf_Unsigned   o_abbrev_count;
+    Dwarf_Unsigned   o_abbrev_compares;
+    /*  From dwarf_pro_get_string_stats_a(). */
+    Dwarf_Unsigned   o_tail_merged_count;
+    Dwarf_Unsigned   o_tail_merged_len;
+};
+
+static void
+fail(const char *msg, const char *detail, int line)
+{
+    printf("FAIL %s %s line %d\n",msg,detail?detail:"",line);
+    ++errcount;
+}
+
+/*  The size of the named section of obj, zero if
+    there is none. */
+static Dwarf_Unsigned
+section_size(struct object_s *obj, const char *name)
+{
+    int i = 0;
+
+    for (i = 1; i < obj->o_count; ++i) {
+        if (!strcmp(obj->o_sects[i].s_name,name)) {
+            return obj->o_sects[i].s_size;
+        }
+    }
+    return 0;
+}
+
+static void
+free_object(struct object_s *obj)
+{
+    int i = 0;
+
+    for (i = 0; i < obj->o_count; ++i) {
+        free(obj->o_sects[i].s_bytes);
+    }
+    free(obj->o_relocs);
+    memset(obj,0,sizeof(*obj));
+}
+
+/*  Places len bytes at offset in section secidx,
+    growing the section as needed. */
+static int
+put_bytes(struct object_s *obj, Dwarf_Signed secidx,
+    Dwarf_Unsigned offset, const void *bytes, Dwarf_Unsigned len)
+{
+    struct section_s *sec = 0;
+
+    if (secidx <= 0 || secidx >= obj->o_count) {
+        return DW_DLV_ERROR;
+    }
+    sec = obj->o_sects + secidx;
+    if (offset + len > sec->s_size) {
+        Dwarf_Small *newb = (Dwarf_Small *)realloc(sec->s_bytes,
+            (size_t)(offset + len));
+
+        if (!newb) {
+            return DW_DLV_ERROR;
+        }
+        memset(newb+sec->s_size,0,
+            (size_t)(offset + len - sec->s_size));
+        sec->s_bytes = newb;
+        sec->s_size = offset + len;
+    }
+    memcpy(sec->s_bytes+offset,bytes,(size_t)len);
+    return DW_DLV_OK;
+}
+
+/*  The producer section callback. Relocation
+    sections get no section, as in dwarfgen. */
+static int
+section_callback(const char *name, int size,
+    Dwarf_Unsigned type, Dwarf_Unsigned flags,
+    Dwarf_Unsigned link, Dwarf_Unsigned info,
+    Dwarf_Unsigned *sect_name_index, void *user_data,
+    int *error)
+{
+    struct object_s *obj = (struct object_s *)user_data;
+
+    (void)size;
+    (void)type;
+    (void)link;
+    (void)info;
+    *error = 0;
+    if (!strncmp(name,".rel",4)) {
+        return 0;
+    }
+    if (!obj->o_count) {
+        obj->o_count = 1;
+    }
+    if (obj->o_count >= MAXSECT) {
+        return -1;
+    }
+    obj->o_sects[obj->o_count].s_name = name;
+    obj->o_sects[obj->o_count].s_flags = flags;
+    *sect_name_index = obj->o_count;
+    return obj->o_count++;
+}
+
+static int
+add_relocs(struct object_s *obj, Dwarf_Signed secidx,
+    Dwarf_Relocation_Data relocs, Dwarf_Unsigned relcount)
+{
+    Dwarf_Unsigned i = 0;
+
+    if (obj->o_reloc_count + relcount > obj->o_reloc_alloc) {
+        Dwarf_Unsigned n = 2*(obj->o_reloc_count + relcount);
+        struct reloc_s *newr = (struct reloc_s *)realloc(
+            obj->o_relocs,(size_t)n*sizeof(struct reloc_s));
+
+        if (!newr) {
+            return DW_DLV_ERROR;
+        }
+        obj->o_relocs = newr;
+        obj->o_reloc_alloc = n;
+    }
+    for (i = 0; i < relcount; ++i) {
+        struct reloc_s *r = obj->o_relocs + obj->o_reloc_count++;
+
+        r->r_sect = secidx;
+        r->r_offset = relocs[i].drd_offset;
+        r->r_symidx = relocs[i].drd_symbol_index;
+        r->r_type = relocs[i].drd_type;
+        r->r_length = relocs[i].drd_length;
+    }
+    return DW_DLV_OK;
+}
+
+/*  A Dwarf_P_Section_Sink writing into the struct object_s
+    at sink_data.  Relocations must fall inside bytes
+    already written, unless the section is compressed:
+    relocation offsets are into the uncompressed contents. */
+static int
+object_sink(Dwarf_Signed secidx, Dwarf_Unsigned offset,
+    Dwarf_Ptr bytes, Dwarf_Unsigned len,
+    Dwarf_Relocation_Data relocs, Dwarf_Unsigned relcount,
+    void *sink_data)
+{
+    struct object_s *obj = (struct object_s *)sink_data;
+    Dwarf_Unsigned i = 0;
+
+    if (bytes) {
+        return put_bytes(obj,secidx,offset,bytes,len);
+    }
+    if (secidx <= 0 || secidx >= obj->o_count) {
+        return DW_DLV_ERROR;
+    }
+    for (i = 0; i < relcount; ++i) {
+        if (!(obj->o_sects[secidx].s_flags & SHF_COMPRESSED) &&
+            relocs[i].drd_offset + relocs[i].drd_length >
+            obj->o_sects[secidx].s_size) {
+            fail("relocation outside its section",
+                obj->o_sects[secidx].s_name,__LINE__);
+            return DW_DLV_ERROR;
+        }
+    }
+    return add_relocs(obj,secidx,relocs,relcount);
+}
+
+/*  Copies what dwarf_get_section_bytes_a() returns
+    onto the end of each section. */
+static int
+collect_sections(Dwarf_P_Debug dbg, Dwarf_Signed nbufs,
+    struct object_s *obj)
+{
+    Dwarf_Signed i = 0;
+    Dwarf_Error error = 0;
+
+    for (i = 0; i < nbufs; ++i) {
+        Dwarf_Signed secidx = 0;
+        Dwarf_Unsigned len = 0;
+        Dwarf_Ptr bytes = 0;
+        int res = 0;
+
+        res = dwarf_get_section_bytes_a(dbg,i,&secidx,&len,
+            &bytes,&error);
+        if (res != DW_DLV_OK) {
+            fail("dwarf_get_section_bytes_a",0,__LINE__);
+            return DW_DLV_ERROR;
+        }
+        if (secidx <= 0 || secidx >= obj->o_count) {
+            fail("section bytes for unknown section",0,__LINE__);
+            return DW_DLV_ERROR;
+        }
+        res = put_bytes(obj,secidx,obj->o_sects[secidx].s_size,
+            bytes,len);
+        if (res != DW_DLV_OK) {
+            fail("out of memory",0,__LINE__);
+            return res;
+        }
+    }
+    return DW_DLV_OK;
+}
+
+/*  Adds what dwarf_get_relocation_info() returns. */
+static int
+collect_relocations(Dwarf_P_Debug dbg, struct object_s *obj)
+{
+    Dwarf_Unsigned count = 0;
+    Dwarf_Unsigned i = 0;
+    int version = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_get_relocation_info_count(dbg,&count,&version,
+        &error);
+    for (i = 0; res == DW_DLV_OK && i < count; ++i) {
+        Dwarf_Signed relsect = 0;
+        Dwarf_Signed secidx = 0;
+        Dwarf_Unsigned relcount = 0;
+        Dwarf_Relocation_Data relocs = 0;
+
+        res = dwarf_get_relocation_info(dbg,&relsect,&secidx,
+            &relcount,&relocs,&error);
+        if (res == DW_DLV_OK) {
+            res = add_relocs(obj,secidx,relocs,relcount);
+        }
+    }
+    if (res != DW_DLV_OK) {
+        fail("collecting relocations",0,__LINE__);
+        return DW_DLV_ERROR;
+    }
+    return DW_DLV_OK;
+}
+
+/*  Clears SHF_COMPRESSED, passed to section_callback()
+    with the "compress_debug_sections" extra, from the
+    sections libdwarfp did not compress after all. */
+static int
+fix_compressed_flags(Dwarf_P_Debug dbg, struct object_s *obj)
+{
+    int i = 0;
+
+    for (i = 1; i < obj->o_count; ++i) {
+        Dwarf_Bool compressed = FALSE;
+        Dwarf_Error error = 0;
+        int res = 0;
+
+        if (!(obj->o_sects[i].s_flags & SHF_COMPRESSED)) {
+            continue;
+        }
+        res = dwarf_pro_get_section_compressed(dbg,i,&compressed,
+            &error);
+        if (res != DW_DLV_OK) {
+            fail("dwarf_pro_get_section_compressed",
+                obj->o_sects[i].s_name,__LINE__);
+            return DW_DLV_ERROR;
+        }
+        if (compressed) {
+            ++obj->o_compressed;
+        } else {
+            obj->o_sects[i].s_flags &= ~(Dwarf_Unsigned)SHF_COMPRESSED;
+            ++obj->o_uncompressed;
+        }
+    }
+    return DW_DLV_OK;
+}
+
+/*  Reader side object access to a struct object_s. */
+static int
+obj_section_info(void *o, Dwarf_Half section_index,
+    Dwarf_Obj_Access_Section_a *return_section, int *error)
+{
+    struct object_s *obj = (struct object_s *)o;
+    struct section_s *sec = 0;
+
+    *error = 0;
+    if (section_index >= obj->o_count) {
+        return DW_DLV_NO_ENTRY;
+    }
+    sec = obj->o_sects + section_index;
+    memset(return_section,0,sizeof(*return_section));
+    return_section->as_name = sec->s_name?sec->s_name:"";
+    return_section->as_size = sec->s_size;
+    return_section->as_flags = sec->s_flags;
+    return_section->as_entrysize = 1;
+    return DW_DLV_OK;
+}
+static Dwarf_Small
+obj_byte_order(void *o)
+{
+    (void)o;
+    return DW_END_little;
+}
+static Dwarf_Small
+obj_length_size(void *o)
+{
+    (void)o;
+    return 4;
+}
+static Dwarf_Small
+obj_pointer_size(void *o)
+{
+    (void)o;
+    return 8;
+}
+static Dwarf_Unsigned
+obj_filesize(void *o)
+{
+    struct object_s *obj = (struct object_s *)o;
+    Dwarf_Unsigned total = 0;
+    int i = 0;
+
+    for (i = 0; i < obj->o_count; ++i) {
+        total += obj->o_sects[i].s_size;
+    }
+    return total;
+}
+static Dwarf_Unsigned
+obj_section_count(void *o)
+{
+    struct object_s *obj = (struct object_s *)o;
+
+    return obj->o_count;
+}
+static int
+obj_load_section(void *o, Dwarf_Half secindex,
+    Dwarf_Small **rdata, int *error)
+{
+    struct object_s *obj = (struct object_s *)o;
+
+    *error = 0;
+    if (secindex >= obj->o_count ||
+        !obj->o_sects[secindex].s_bytes) {
+        return DW_DLV_NO_ENTRY;
+    }
+    *rdata = obj->o_sects[secindex].s_bytes;
+    return DW_DLV_OK;
+}
+
+static const Dwarf_Obj_Access_Methods_a obj_methods = {
+    obj_section_info,
+    obj_byte_order,
+    obj_length_size,
+    obj_pointer_size,
+    obj_filesize,
+    obj_section_count,
+    obj_load_section,
+    0 /* no relocations */
+};
+
+/*  The CUs built here. CU k has DIEs named
+    type<k> (base type), func<k> (subprogram with code),
+    gvar<k> (variable with a location),
+    noloc<k> (variable without one), decl<k> (declaration)
+    and v<k>_<i> (variables with DW_AT_const_value i),
+    for i below nvars.  With tails each v<k>_<i> has
+    DW_AT_linkage_name gv<k>_<i>, which its name is a
+    suffix of.  With lines, func<k> has
+    the rows of lines_of_cu() in file test.c. */
+#define INDEXED_PER_CU 3
+#define LINES_PER_CU 3
+#define VARIED_LINES_PER_CU 60
+
+/*  What an object generated here should hold. */
+struct expect_s {
+    /*  "V4" or "V5".  libdwarfp writes .debug_line only
+        for DWARF4 and .debug_names only for DWARF5. */
+    const char *e_version;
+    unsigned  e_ncus;
+    unsigned  e_nvars;
+    int       e_lines;
+    /*  The rows are varied_row()'s, not plain ones. */
+    int       e_varied_lines;
+    int       e_tails;
+    /*  The default string form, DW_FORM_strp if zero. */
+    Dwarf_Half e_string_form;
+    /*  Every CU uses the abbreviations at offset zero. */
+    int       e_shared_abbrev;
+};
+
+static Dwarf_Addr
+func_addr(unsigned k)
+{
+    return 0x1000*(k+1);
+}
+
+static int
+add_name(Dwarf_P_Die die, const char *fmt, unsigned a,
+    unsigned b, Dwarf_Error *error)
+{
+    char name[40];
+    Dwarf_P_Attribute attr = 0;
+
+    snprintf(name,sizeof(name),fmt,a,b);
+    return dwarf_add_AT_name_a(die,name,&attr,error);
+}
+
+static int
+add_linkage_name(Dwarf_P_Debug dbg, Dwarf_P_Die die,
+    unsigned a, unsigned b, Dwarf_Error *error)
+{
+    char name[40];
+    Dwarf_P_Attribute attr = 0;
+
+    snprintf(name,sizeof(name),"gv%u_%u",a,b);
+    return dwarf_add_AT_string_a(dbg,die,DW_AT_linkage_name,name,
+        &attr,error);
+}
+
+static int
+new_child(Dwarf_P_Debug dbg, Dwarf_Tag tag, Dwarf_P_Die parent,
+    Dwarf_P_Die *die_out, Dwarf_Error *error)
+{
+    return dwarf_new_die_a(dbg,tag,parent,0,0,0,die_out,error);
+}
+
+/*  Address and line advances of the varied rows: small
+    and large advances, advances past 0xffff, lines
+    going back, and rows at the same address. */
+static const Dwarf_Unsigned varied_addr_adv[] = {
+0, 4, 8, 4, 12, 64, 4, 256, 1024, 8, 0xfffc, 4,
+0x10000, 16, 0x12344, 4, 128, 4, 40 };
+static const int varied_line_adv[] = {
+1, 2, -3, 0, 5, -20, 100, -1, 3, -64, 1, -30, 7 };
+#define VARIED_ADDR_COUNT \
+    (sizeof(varied_addr_adv)/sizeof(varied_addr_adv[0]))
+#define VARIED_LINE_COUNT \
+    (sizeof(varied_line_adv)/sizeof(varied_line_adv[0]))
+
+static unsigned
+rows_of_cu(struct expect_s *ex)
+{
+    return ex->e_varied_lines? VARIED_LINES_PER_CU:
+        LINES_PER_CU;
+}
+
+/*  The address and line of row i of func<k>: lines
+    k+1 .. k+LINES_PER_CU four bytes apart, or the
+    varied rows from line 1000+k. */
+static void
+line_row(struct expect_s *ex, unsigned k, unsigned i,
+    Dwarf_Addr *addr_out, Dwarf_Unsigned *line_out)
+{
+    Dwarf_Addr addr = func_addr(k);
+    Dwarf_Signed line = 1000 + k;
+    unsigned j = 0;
+
+    if (!ex->e_varied_lines) {
+        *addr_out = addr + 4*i;
+        *line_out = k+1+i;
+        return;
+    }
+    for (j = 1; j <= i; ++j) {
+        addr += varied_addr_adv[j%VARIED_ADDR_COUNT];
+        line += varied_line_adv[j%VARIED_LINE_COUNT];
+    }
+    *addr_out = addr;
+    *line_out = (Dwarf_Unsigned)line;
+}
+
+/*  The end of the sequence is 8 bytes past the last row. */
+static Dwarf_Addr
+end_of_rows(struct expect_s *ex, unsigned k)
+{
+    Dwarf_Addr addr = 0;
+    Dwarf_Unsigned line = 0;
+
+    line_row(ex,k,rows_of_cu(ex)-1,&addr,&line);
+    return addr + 8;
+}
+
+/*  Line rows for func<k>, then the end of the sequence. */
+static int
+lines_of_cu(Dwarf_P_Debug dbg, unsigned k, struct expect_s *ex,
+    Dwarf_Error *error)
+{
+    Dwarf_Unsigned count = 0;
+    unsigned i = 0;
+    int res = DW_DLV_OK;
+
+    if (!k) {
+        /*  The file table is shared by all CUs. */
+        res = dwarf_add_file_decl_a(dbg,(char *)"test.c",0,0,0,
+            &count,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_lne_set_address_a(dbg,func_addr(k),0,error);
+    }
+    for (i = 0; res == DW_DLV_OK && i < rows_of_cu(ex); ++i) {
+        Dwarf_Addr addr = 0;
+        Dwarf_Unsigned line = 0;
+
+        line_row(ex,k,i,&addr,&line);
+        res = dwarf_add_line_entry_c(dbg,1,addr,
+            line,0,TRUE,FALSE,FALSE,FALSE,0,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_lne_end_sequence_a(dbg,end_of_rows(ex,k),
+            error);
+    }
+    return res;
+}
+
+static int
+build_cu(Dwarf_P_Debug dbg, unsigned k, struct expect_s *ex,
+    Dwarf_Error *error)
+{
+    Dwarf_P_Die cu = 0;
+    Dwarf_P_Die type = 0;
+    Dwarf_P_Die die = 0;
+    Dwarf_P_Attribute attr = 0;
+    Dwarf_P_Expr expr = 0;
+    Dwarf_Unsigned next = 0;
+    unsigned i = 0;
+    int res = 0;
+
+    res = new_child(dbg,DW_TAG_compile_unit,0,&cu,error);
+    if (res == DW_DLV_OK) {
+        res = add_name(cu,"cu%u.c",k,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_producer_a(cu,(char *)"test_producer",
+            &attr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_unsigned_const_a(dbg,cu,DW_AT_language,
+            DW_LANG_C11,&attr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = new_child(dbg,DW_TAG_base_type,cu,&type,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = add_name(type,"type%u",k,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_unsigned_const_a(dbg,type,
+            DW_AT_byte_size,4,&attr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = new_child(dbg,DW_TAG_subprogram,cu,&die,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = add_name(die,"func%u",k,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_targ_address_c(dbg,die,DW_AT_low_pc,
+            func_addr(k),0,&attr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_unsigned_const_a(dbg,die,
+            DW_AT_high_pc,0x10,&attr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = new_child(dbg,DW_TAG_variable,cu,&die,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = add_name(die,"gvar%u",k,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_new_expr_a(dbg,&expr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_expr_addr_c(expr,0x8000+8*k,0,&next,
+            error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_location_expr_a(dbg,die,DW_AT_location,
+            expr,&attr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = new_child(dbg,DW_TAG_variable,cu,&die,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = add_name(die,"noloc%u",k,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_reference_c(dbg,die,DW_AT_type,type,
+            &attr,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = new_child(dbg,DW_TAG_subprogram,cu,&die,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = add_name(die,"decl%u",k,0,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_AT_flag_a(dbg,die,DW_AT_declaration,1,
+            &attr,error);
+    }
+    for (i = 0; res == DW_DLV_OK && i < ex->e_nvars; ++i) {
+        res = new_child(dbg,DW_TAG_variable,cu,&die,error);
+        if (res == DW_DLV_OK) {
+            res = add_name(die,"v%u_%u",k,i,error);
+        }
+        if (res == DW_DLV_OK && ex->e_tails) {
+            res = add_linkage_name(dbg,die,k,i,error);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_add_AT_unsigned_const_a(dbg,die,
+                DW_AT_const_value,i,&attr,error);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_add_AT_reference_c(dbg,die,DW_AT_type,
+                type,&attr,error);
+        }
+        /*  A few different attribute lists, so there
+            are several abbreviations. */
+        if (res == DW_DLV_OK && i%3 == 1) {
+            res = dwarf_add_AT_unsigned_const_a(dbg,die,
+                DW_AT_decl_line,i,&attr,error);
+        }
+        if (res == DW_DLV_OK && i%3 == 2) {
+            res = dwarf_add_AT_flag_a(dbg,die,DW_AT_external,1,
+                &attr,error);
+        }
+    }
+    if (res == DW_DLV_OK && ex->e_lines) {
+        res = lines_of_cu(dbg,k,ex,error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_add_die_to_debug_a(dbg,cu,error);
+    }
+    return res;
+}
+
+static int
+producer_init(const char *extras, struct expect_s *ex,
+    struct object_s *obj, Dwarf_P_Debug *dbg_out)
+{
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_producer_init(DW_DLC_TARGET_LITTLEENDIAN|
+        DW_DLC_POINTER64|DW_DLC_OFFSET32|
+        DW_DLC_SYMBOLIC_RELOCATIONS,
+        section_callback,0,0,obj,"x86_64",ex->e_version,extras,
+        dbg_out,&error);
+    if (res != DW_DLV_OK) {
+        fail("dwarf_producer_init",
+            res == DW_DLV_ERROR?dwarf_errmsg(error):0,__LINE__);
+        return DW_DLV_ERROR;
+    }
+    res = dwarf_pro_set_default_string_form(*dbg_out,
+        ex->e_string_form?ex->e_string_form:DW_FORM_strp,&error);
+    if (res == DW_DLV_OK && !strcmp(ex->e_version,"V5")) {
+        res = dwarf_force_dnames(*dbg_out,0,&error);
+    }
+    if (res != DW_DLV_OK) {
+        fail("producer setup",dwarf_errmsg(error),__LINE__);
+        dwarf_producer_finish_a(*dbg_out,0);
+        *dbg_out = 0;
+        return DW_DLV_ERROR;
+    }
+    return DW_DLV_OK;
+}
+
+static int
+get_abbrev_stats(Dwarf_P_Debug dbg, struct object_s *obj)
+{
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_pro_get_abbrev_stats(dbg,&obj->o_abbrev_lookups,
+        &obj->o_abbrev_hits,&obj->o_abbrev_count,
+        &obj->o_abbrev_compares,&error);
+    if (res != DW_DLV_OK) {
+        fail("dwarf_pro_get_abbrev_stats",0,__LINE__);
+    }
+    return res;
+}
+
+static int
+get_string_stats(Dwarf_P_Debug dbg, struct object_s *obj)
+{
+    Dwarf_Unsigned str_count = 0;
+    Dwarf_Unsigned str_len = 0;
+    Dwarf_Unsigned debug_str_count = 0;
+    Dwarf_Unsigned debug_str_len = 0;
+    Dwarf_Unsigned reused_count = 0;
+    Dwarf_Unsigned reused_len = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_pro_get_string_stats_a(dbg,&str_count,&str_len,
+        &debug_str_count,&debug_str_len,&reused_count,&reused_len,
+        &obj->o_tail_merged_count,&obj->o_tail_merged_len,&error);
+    if (res != DW_DLV_OK) {
+        fail("dwarf_pro_get_string_stats_a",0,__LINE__);
+    }
+    return res;
+}
+
+/*  Builds one CU, held in memory until a single
+    dwarf_transform_to_disk_form_a(), which writes
+    through object_sink() if sink is set. */
+static int
+generate_whole(const char *extras, struct expect_s *ex,
+    int sink, struct object_s *obj)
+{
+    Dwarf_P_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Signed nbufs = 0;
+    int res = 0;
+
+    memset(obj,0,sizeof(*obj));
+    res = producer_init(extras,ex,obj,&dbg);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    res = build_cu(dbg,0,ex,&error);
+    if (res == DW_DLV_OK && ex->e_ncus > 1) {
+        fail("generate_whole makes one CU",0,__LINE__);
+        res = DW_DLV_ERROR;
+    }
+    if (res == DW_DLV_OK && sink) {
+        res = dwarf_pro_set_section_sink(dbg,object_sink,obj,
+            &error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_transform_to_disk_form_a(dbg,&nbufs,&error);
+    }
+    if (res != DW_DLV_OK) {
+        fail("generating DWARF",
+            res == DW_DLV_ERROR?dwarf_errmsg(error):0,__LINE__);
+    } else if (sink && nbufs) {
+        fail("section bytes left with a sink set",0,__LINE__);
+        res = DW_DLV_ERROR;
+    } else if (!sink) {
+        res = collect_sections(dbg,nbufs,obj);
+        if (res == DW_DLV_OK) {
+            res = collect_relocations(dbg,obj);
+        }
+    }
+    if (res == DW_DLV_OK) {
+        res = fix_compressed_flags(dbg,obj);
+    }
+    if (res == DW_DLV_OK) {
+        res = get_abbrev_stats(dbg,obj);
+    }
+    if (res == DW_DLV_OK) {
+        res = get_string_stats(dbg,obj);
+    }
+    dwarf_producer_finish_a(dbg,0);
+    return res;
+}
+
+/*  Builds the CUs one at a time, each written through
+    object_sink() by dwarf_transform_cu_to_disk_form_a()
+    before the next is built.  The rest comes from the
+    final dwarf_transform_to_disk_form_a(), through
+    object_sink() too when final_sink is set. */
+static int
+generate_streamed(const char *extras, struct expect_s *ex,
+    int final_sink, struct object_s *obj)
+{
+    Dwarf_P_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Signed nbufs = 0;
+    unsigned k = 0;
+    int res = 0;
+
+    memset(obj,0,sizeof(*obj));
+    res = producer_init(extras,ex,obj,&dbg);
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    for (k = 0; res == DW_DLV_OK && k < ex->e_ncus; ++k) {
+        res = build_cu(dbg,k,ex,&error);
+        if (res == DW_DLV_OK) {
+            res = dwarf_transform_cu_to_disk_form_a(dbg,
+                object_sink,obj,&error);
+        }
+    }
+    if (res == DW_DLV_OK && final_sink) {
+        res = dwarf_pro_set_section_sink(dbg,object_sink,obj,
+            &error);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_transform_to_disk_form_a(dbg,&nbufs,&error);
+    }
+    if (res != DW_DLV_OK) {
+        fail("streaming DWARF",
+            res == DW_DLV_ERROR?dwarf_errmsg(error):0,__LINE__);
+    } else if (final_sink && nbufs) {
+        fail("section bytes left with a sink set",0,__LINE__);
+        res = DW_DLV_ERROR;
+    } else {
+        res = collect_sections(dbg,nbufs,obj);
+    }
+    if (res == DW_DLV_OK && !obj->o_reloc_count) {
+        fail("no relocations streamed",0,__LINE__);
+        res = DW_DLV_ERROR;
+    }
+    if (res == DW_DLV_OK) {
+        res = get_abbrev_stats(dbg,obj);
+    }
+    if (res == DW_DLV_OK) {
+        res = get_string_stats(dbg,obj);
+    }
+    dwarf_producer_finish_a(dbg,0);
+    return res;
+}
+
+/*  The .debug_names hash: DJB over the
+    case-folded name. */
+static Dwarf_Unsigned
+dnames_hash(const char *s)
+{
+    Dwarf_Unsigned h = 5381;
+
+    for ( ; *s; ++s) {
+        h = (h*33 + (unsigned char)tolower((unsigned char)*s)) &
+            0xffffffff;
+    }
+    return h;
+}
+
+static int
+indexed_name(const char *name)
+{
+    return !strncmp(name,"type",4) || !strncmp(name,"func",4) ||
+        !strncmp(name,"gvar",4) || name[0] == 'v';
+}
+
+/*  Checks that the .debug_names index holds exactly
+    the indexable names of the CUs, each with the
+    right hash and pointing at a DIE of that name
+    and tag. */
+static void
+check_names(Dwarf_Debug dbg, struct expect_s *ex)
+{
+    Dwarf_Dnames_Head dn = 0;
+    Dwarf_Off next = 0;
+    Dwarf_Unsigned cu_count = 0;
+    Dwarf_Unsigned bucket_count = 0;
+    Dwarf_Unsigned name_count = 0;
+    Dwarf_Unsigned first = 0;
+    Dwarf_Unsigned collisions = 0;
+    Dwarf_Unsigned i = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_dnames_header(dbg,0,&dn,&next,&error);
+    if (res != DW_DLV_OK) {
+        fail("no .debug_names",
+            res == DW_DLV_ERROR?dwarf_errmsg(error):0,__LINE__);
+        return;
+    }
+    res = dwarf_dnames_sizes(dn,&cu_count,0,0,&bucket_count,
+        &name_count,0,0,0,0,0,0,0,&error);
+    if (res == DW_DLV_OK) {
+        /*  Also sets up the bucket details that
+            dwarf_dnames_name() reports. */
+        res = dwarf_dnames_bucket(dn,0,&first,&collisions,&error);
+    }
+    if (res != DW_DLV_OK || cu_count != ex->e_ncus ||
+        !bucket_count ||
+        name_count != ex->e_ncus*(INDEXED_PER_CU+ex->e_nvars)) {
+        fail(".debug_names counts wrong",0,__LINE__);
+        dwarf_dealloc_dnames(dn);
+        return;
+    }
+    for (i = 1; i <= name_count; ++i) {
+        Dwarf_Unsigned bucket = 0;
+        Dwarf_Unsigned hash = 0;
+        char *name = 0;
+        Dwarf_Unsigned pool = 0;
+        Dwarf_Unsigned code = 0;
+        Dwarf_Half tag = 0;
+        Dwarf_Unsigned nvals = 0;
+        Dwarf_Unsigned abindex = 0;
+        Dwarf_Unsigned valoff = 0;
+        Dwarf_Half idx[4];
+        Dwarf_Half form[4];
+        Dwarf_Unsigned vals[4];
+        Dwarf_Sig8 sigs[4];
+        Dwarf_Bool single_cu = FALSE;
+        Dwarf_Unsigned cu_offset = 0;
+        Dwarf_Unsigned cu_index = 0;
+        Dwarf_Unsigned die_offset = 0;
+        Dwarf_Unsigned nextpool = 0;
+        Dwarf_Unsigned j = 0;
+        Dwarf_Die die = 0;
+        char *diename = 0;
+        Dwarf_Half dietag = 0;
+
+        res = dwarf_dnames_name(dn,i,&bucket,&hash,0,&name,&pool,
+            &code,&tag,0,0,0,0,&error);
+        if (res == DW_DLV_OK) {
+            res = dwarf_dnames_entrypool(dn,pool,&code,&tag,
+                &nvals,&abindex,&valoff,&error);
+        }
+        if (res == DW_DLV_OK && nvals > 4) {
+            res = DW_DLV_NO_ENTRY;
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_dnames_entrypool_values(dn,abindex,
+                valoff,nvals,idx,form,vals,sigs,&single_cu,
+                &cu_offset,&nextpool,&error);
+        }
+        if (res != DW_DLV_OK) {
+            fail("reading a .debug_names entry",0,__LINE__);
+            break;
+        }
+        if (!indexed_name(name)) {
+            fail("name should not be indexed",name,__LINE__);
+        }
+        if (hash != dnames_hash(name) ||
+            bucket != hash%bucket_count) {
+            fail("name hash or bucket wrong",name,__LINE__);
+        }
+        for (j = 0; j < nvals; ++j) {
+            if (idx[j] == DW_IDX_die_offset) {
+                die_offset = vals[j];
+            } else if (idx[j] == DW_IDX_compile_unit) {
+                cu_index = vals[j];
+                single_cu = FALSE;
+            }
+        }
+        if (!single_cu) {
+            res = dwarf_dnames_cu_table(dn,"cu",cu_index,
+                &cu_offset,0,&error);
+            if (res != DW_DLV_OK) {
+                fail("bad DW_IDX_compile_unit",name,__LINE__);
+                continue;
+            }
+        }
+        res = dwarf_offdie_b(dbg,cu_offset+die_offset,TRUE,
+            &die,&error);
+        if (res == DW_DLV_OK) {
+            res = dwarf_diename(die,&diename,&error);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_tag(die,&dietag,&error);
+        }
+        if (res != DW_DLV_OK || strcmp(diename,name) ||
+            dietag != tag) {
+            fail("index entry does not match its DIE",name,
+                __LINE__);
+        }
+        dwarf_dealloc_die(die);
+    }
+    dwarf_dealloc_dnames(dn);
+}
+
+/*  Checks the line table of CU k as made
+    by lines_of_cu(). */
+static void
+check_lines(Dwarf_Debug dbg, Dwarf_Die cudie, unsigned k,
+    struct expect_s *ex)
+{
+    Dwarf_Unsigned version = 0;
+    Dwarf_Small table_count = 0;
+    Dwarf_Line_Context ctx = 0;
+    Dwarf_Line *lines = 0;
+    Dwarf_Signed count = 0;
+    Dwarf_Signed i = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_srclines_b(cudie,&version,&table_count,&ctx,
+        &error);
+    if (res == DW_DLV_OK) {
+        res = dwarf_srclines_from_linecontext(ctx,&lines,&count,
+            &error);
+    }
+    if (res != DW_DLV_OK || count != rows_of_cu(ex)+1) {
+        fail("line table missing or wrong size",0,__LINE__);
+        dwarf_srclines_dealloc_b(ctx);
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        Dwarf_Addr addr = 0;
+        Dwarf_Unsigned lineno = 0;
+        Dwarf_Addr expaddr = 0;
+        Dwarf_Unsigned expline = 0;
+        Dwarf_Bool endseq = FALSE;
+        char *file = 0;
+
+        res = dwarf_lineaddr(lines[i],&addr,&error);
+        if (res == DW_DLV_OK) {
+            res = dwarf_lineno(lines[i],&lineno,&error);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_lineendsequence(lines[i],&endseq,&error);
+        }
+        if (res == DW_DLV_OK) {
+            res = dwarf_linesrc(lines[i],&file,&error);
+        }
+        if (res != DW_DLV_OK || strcmp(file,"test.c")) {
+            fail("line row unreadable",0,__LINE__);
+            break;
+        }
+        dwarf_dealloc(dbg,file,DW_DLA_STRING);
+        if (i < count-1) {
+            line_row(ex,k,(unsigned)i,&expaddr,&expline);
+            if (endseq || addr != expaddr || lineno != expline) {
+                fail("line row wrong",0,__LINE__);
+            }
+        } else if (!endseq || addr != end_of_rows(ex,k)) {
+            fail("end of sequence wrong",0,__LINE__);
+        }
+    }
+    dwarf_srclines_dealloc_b(ctx);
+}
+
+/*  Checks that DIE has DW_AT_linkage_name gv<k>_<i>. */
+static void
+check_linkage_name(Dwarf_Die die, unsigned k, unsigned i)
+{
+    Dwarf_Attribute attr = 0;
+    Dwarf_Error error = 0;
+    char expected[40];
+    char *name = 0;
+    int res = 0;
+
+    snprintf(expected,sizeof(expected),"gv%u_%u",k,i);
+    res = dwarf_attr(die,DW_AT_linkage_name,&attr,&error);
+    if (res == DW_DLV_OK) {
+        res = dwarf_formstring(attr,&name,&error);
+        if (res != DW_DLV_OK || strcmp(name,expected)) {
+            res = DW_DLV_NO_ENTRY;
+        }
+        dwarf_dealloc_attribute(attr);
+    }
+    if (res != DW_DLV_OK) {
+        fail("linkage name wrong",expected,__LINE__);
+    }
+}
+
+/*  Checks that a DW_FORM_strx CU name is read through
+    the CU's DW_AT_str_offsets_base. */
+static void
+check_strx_cu(Dwarf_Die cudie, const char *expected)
+{
+    Dwarf_Attribute attr = 0;
+    Dwarf_Half form = 0;
+    Dwarf_Bool has_base = FALSE;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_attr(cudie,DW_AT_name,&attr,&error);
+    if (res == DW_DLV_OK) {
+        res = dwarf_whatform(attr,&form,&error);
+        dwarf_dealloc_attribute(attr);
+    }
+    if (res == DW_DLV_OK) {
+        res = dwarf_hasattr(cudie,DW_AT_str_offsets_base,&has_base,
+            &error);
+    }
+    if (res != DW_DLV_OK || !has_base ||
+        (form != DW_FORM_strx && form != DW_FORM_strx1 &&
+        form != DW_FORM_strx2 && form != DW_FORM_strx3 &&
+        form != DW_FORM_strx4)) {
+        fail("CU name is not DW_FORM_strx with a base",expected,
+            __LINE__);
+    }
+}
+
+/*  Checks the DIE trees of the CUs as built
+    by build_cu(). */
+static void
+check_dies(Dwarf_Debug dbg, struct expect_s *ex)
+{
+    unsigned k = 0;
+    Dwarf_Error error = 0;
+    int res = DW_DLV_OK;
+
+    for (k = 0; k < ex->e_ncus; ++k) {
+        Dwarf_Die cudie = 0;
+        Dwarf_Die die = 0;
+        Dwarf_Off abbrev_offset = 0;
+        char expected[40];
+        char *name = 0;
+        unsigned children = 0;
+
+        res = dwarf_next_cu_header_d(dbg,TRUE,0,0,&abbrev_offset,
+            0,0,0,0,0,0,0,&error);
+        if (res == DW_DLV_OK) {
+            res = dwarf_siblingof_b(dbg,0,TRUE,&cudie,&error);
+        }
+        if (res != DW_DLV_OK) {
+            fail("CU missing",0,__LINE__);
+            break;
+        }
+        snprintf(expected,sizeof(expected),"cu%u.c",k);
+        res = dwarf_diename(cudie,&name,&error);
+        if (res != DW_DLV_OK || strcmp(name,expected)) {
+            fail("CU name wrong",expected,__LINE__);
+        }
+        if (ex->e_string_form == DW_FORM_strx) {
+            check_strx_cu(cudie,expected);
+        }
+        if (ex->e_shared_abbrev && abbrev_offset) {
+            fail("CU does not share the abbreviations",expected,
+                __LINE__);
+        }
+        if (ex->e_lines) {
+            check_lines(dbg,cudie,k,ex);
+        }
+        res = dwarf_child(cudie,&die,&error);
+        while (res == DW_DLV_OK) {
+            Dwarf_Die sib = 0;
+            Dwarf_Unsigned value = 0;
+            unsigned kk = 0;
+            unsigned ii = 0;
+
+            ++children;
+            res = dwarf_diename(die,&name,&error);
+            if (res != DW_DLV_OK) {
+                fail("DIE without a name",expected,__LINE__);
+            } else if (sscanf(name,"v%u_%u",&kk,&ii) == 2) {
+                Dwarf_Attribute attr = 0;
+                Dwarf_Off typeoff = 0;
+                Dwarf_Die tdie = 0;
+                char *tname = 0;
+                char texpected[40];
+
+                res = dwarf_attr(die,DW_AT_const_value,&attr,
+                    &error);
+                if (res == DW_DLV_OK) {
+                    res = dwarf_formudata(attr,&value,&error);
+                    dwarf_dealloc_attribute(attr);
+                }
+                if (res != DW_DLV_OK || kk != k || value != ii) {
+                    fail("variable value wrong",name,__LINE__);
+                }
+                if (ex->e_tails) {
+                    check_linkage_name(die,kk,ii);
+                }
+                res = dwarf_dietype_offset(die,&typeoff,&error);
+                if (res == DW_DLV_OK) {
+                    res = dwarf_offdie_b(dbg,typeoff,TRUE,&tdie,
+                        &error);
+                }
+                if (res == DW_DLV_OK) {
+                    res = dwarf_diename(tdie,&tname,&error);
+                }
+                snprintf(texpected,sizeof(texpected),"type%u",k);
+                if (res != DW_DLV_OK || strcmp(tname,texpected)) {
+                    fail("variable type wrong",name,__LINE__);
+                }
+                dwarf_dealloc_die(tdie);
+            }
+            res = dwarf_siblingof_b(dbg,die,TRUE,&sib,&error);
+            dwarf_dealloc_die(die);
+            die = sib;
+        }
+        if (children != 5 + ex->e_nvars) {
+            fail("wrong number of DIEs in CU",expected,__LINE__);
+        }
+        dwarf_dealloc_die(cudie);
+    }
+    if (res == DW_DLV_ERROR) {
+        dwarf_dealloc_error(dbg,error);
+    }
+}
+
+/*  Reads obj back and checks it holds what ex
+    describes. */
+static void
+read_back(const char *what, struct object_s *obj,
+    struct expect_s *ex)
+{
+    Dwarf_Obj_Access_Interface_a dw_interface;
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    int before = errcount;
+    int res = 0;
+
+    dw_interface.ai_object = obj;
+    dw_interface.ai_methods = &obj_methods;
+    res = dwarf_object_init_b(&dw_interface,0,0,
+        DW_GROUPNUMBER_ANY,&dbg,&error);
+    if (res != DW_DLV_OK) {
+        fail("cannot read generated DWARF",what,__LINE__);
+        return;
+    }
+    check_dies(dbg,ex);
+    if (!strcmp(ex->e_version,"V5")) {
+        check_names(dbg,ex);
+    }
+    dwarf_object_finish(dbg);
+    if (errcount != before) {
+        printf("FAIL test_producer: %s\n",what);
+    }
+}
+
+static void
+test_debug_names(void)
+{
+    struct object_s obj;
+    struct expect_s ex;
+
+    memset(&ex,0,sizeof(ex));
+    ex.e_version = "V5";
+    ex.e_ncus = 1;
+    if (generate_whole("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        read_back(".debug_names, one CU",&obj,&ex);
+    }
+    free_object(&obj);
+    ex.e_nvars = 200;
+    if (generate_whole("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        read_back(".debug_names, 203 names",&obj,&ex);
+    }
+    free_object(&obj);
+}
+
+/*  Identical CUs streamed one by one share one
+    abbreviation table, and their line tables,
+    .debug_names entries and DIE references
+    all use the running section offsets. */
+static void
+test_streaming(void)
+{
+    struct object_s obj;
+    struct expect_s ex;
+
+    memset(&ex,0,sizeof(ex));
+    ex.e_version = "V5";
+    ex.e_ncus = 4;
+    ex.e_nvars = 10;
+    ex.e_shared_abbrev = TRUE;
+    if (generate_streamed("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        read_back("streamed CUs",&obj,&ex);
+    }
+    free_object(&obj);
+    if (generate_streamed("",&ex,TRUE,&obj) == DW_DLV_OK) {
+        read_back("streamed CUs, final sink",&obj,&ex);
+    }
+    free_object(&obj);
+    ex.e_string_form = DW_FORM_strx;
+    if (generate_streamed("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        read_back("streamed DW_FORM_strx CUs",&obj,&ex);
+    }
+    free_object(&obj);
+    if (generate_streamed("",&ex,TRUE,&obj) == DW_DLV_OK) {
+        read_back("streamed DW_FORM_strx CUs, final sink",&obj,&ex);
+    }
+    free_object(&obj);
+    ex.e_string_form = 0;
+    ex.e_version = "V4";
+    ex.e_lines = TRUE;
+    if (generate_streamed("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        read_back("streamed DWARF4 CUs with lines",&obj,&ex);
+    }
+    free_object(&obj);
+    if (generate_streamed("",&ex,TRUE,&obj) == DW_DLV_OK) {
+        read_back("streamed DWARF4 CUs with lines, final sink",
+            &obj,&ex);
+    }
+    free_object(&obj);
+}
+
+#define MAXABBREV 64
+
+/*  Describes abbreviation ab as a string, so that
+    equal abbreviations compare equal. */
+static int
+abbrev_key(Dwarf_Abbrev ab, Dwarf_Unsigned attr_count,
+    char *key, size_t keylen, Dwarf_Error *error)
+{
+    Dwarf_Half tag = 0;
+    Dwarf_Signed children = 0;
+    Dwarf_Unsigned i = 0;
+    size_t used = 0;
+    int res = 0;
+
+    res = dwarf_get_abbrev_tag(ab,&tag,error);
+    if (res == DW_DLV_OK) {
+        res = dwarf_get_abbrev_children_flag(ab,&children,error);
+    }
+    if (res != DW_DLV_OK) {
+        return res;
+    }
+    used = (size_t)snprintf(key,keylen,"%u %d",(unsigned)tag,
+        (int)children);
+    for (i = 0; i < attr_count && used < keylen; ++i) {
+        Dwarf_Unsigned attr = 0;
+        Dwarf_Unsigned form = 0;
+        Dwarf_Signed implicit_const = 0;
+        Dwarf_Off off = 0;
+
+        res = dwarf_get_abbrev_entry_b(ab,i,TRUE,&attr,&form,
+            &implicit_const,&off,error);
+        if (res != DW_DLV_OK) {
+            return res;
+        }
+        used += (size_t)snprintf(key+used,keylen-used," %u/%u",
+            (unsigned)attr,(unsigned)form);
+    }
+    return DW_DLV_OK;
+}
+
+/*  Checks that no table in .debug_abbrev holds the
+    same abbreviation twice, that the tables hold
+    as many distinct abbreviations as libdwarfp
+    says it created, that every DIE was looked up
+    once, and that the hit count adds up. */
+static void
+check_abbrevs(const char *what, struct object_s *obj,
+    Dwarf_Unsigned ndies)
+{
+    Dwarf_Obj_Access_Interface_a dw_interface;
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Unsigned offset = 0;
+    Dwarf_Unsigned secsize = 0;
+    char keys[MAXABBREV][200];
+    unsigned distinct = 0;
+    unsigned table_start = 0;
+    int before = errcount;
+    int res = 0;
+
+    secsize = section_size(obj,".debug_abbrev");
+    dw_interface.ai_object = obj;
+    dw_interface.ai_methods = &obj_methods;
+    res = dwarf_object_init_b(&dw_interface,0,0,
+        DW_GROUPNUMBER_ANY,&dbg,&error);
+    if (res != DW_DLV_OK || !secsize) {
+        fail("cannot read generated DWARF",what,__LINE__);
+        return;
+    }
+    while (offset < secsize) {
+        Dwarf_Abbrev ab = 0;
+        Dwarf_Unsigned length = 0;
+        Dwarf_Unsigned attr_count = 0;
+        Dwarf_Unsigned code = 0;
+        char key[200];
+        unsigned j = 0;
+
+        res = dwarf_get_abbrev(dbg,offset,&ab,&length,&attr_count,
+            &error);
+        if (res == DW_DLV_OK) {
+            res = dwarf_get_abbrev_code(ab,&code,&error);
+        }
+        if (res == DW_DLV_OK && code) {
+            res = abbrev_key(ab,attr_count,key,sizeof(key),&error);
+        }
+        if (res != DW_DLV_OK) {
+            fail("reading .debug_abbrev",what,__LINE__);
+            break;
+        }
+        dwarf_dealloc(dbg,ab,DW_DLA_ABBREV);
+        offset += length;
+        if (!code) {
+            /*  End of a table.  Later tables repeat
+                the abbreviations of earlier ones. */
+            table_start = distinct;
+            continue;
+        }
+        for (j = 0; j < distinct; ++j) {
+            if (!strcmp(keys[j],key)) {
+                break;
+            }
+        }
+        if (j < distinct) {
+            if (j >= table_start) {
+                fail("duplicate abbreviation",key,__LINE__);
+            }
+            continue;
+        }
+        if (distinct >= MAXABBREV) {
+            fail("too many abbreviations",what,__LINE__);
+            break;
+        }
+        strcpy(keys[distinct],key);
+        ++distinct;
+    }
+    dwarf_object_finish(dbg);
+    if (distinct != obj->o_abbrev_count ||
+        obj->o_abbrev_lookups != ndies ||
+        obj->o_abbrev_hits + obj->o_abbrev_count != ndies ||
+        obj->o_abbrev_compares < obj->o_abbrev_hits) {
+        printf("FAIL abbreviation counts: %u distinct, "
+            "libdwarfp lookups %llu hits %llu count %llu "
+            "compares %llu, %llu DIEs\n",distinct,
+            (unsigned long long)obj->o_abbrev_lookups,
+            (unsigned long long)obj->o_abbrev_hits,
+            (unsigned long long)obj->o_abbrev_count,
+            (unsigned long long)obj->o_abbrev_compares,
+            (unsigned long long)ndies);
+        ++errcount;
+    }
+    if (errcount != before) {
+        printf("FAIL test_producer: %s\n",what);
+    }
+}
+
+/*  Each DIE is looked up once, and DIEs with equal
+    attribute lists share one abbreviation, in one CU
+    and across streamed CUs. */
+static void
+test_abbrevs(void)
+{
+    struct object_s obj;
+    struct expect_s ex;
+
+    memset(&ex,0,sizeof(ex));
+    ex.e_version = "V5";
+    ex.e_ncus = 1;
+    ex.e_nvars = 300;
+    if (generate_whole("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        check_abbrevs("abbreviations, one CU",&obj,
+            1 + 5 + ex.e_nvars);
+    }
+    free_object(&obj);
+    ex.e_ncus = 4;
+    ex.e_nvars = 10;
+    if (generate_streamed("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        check_abbrevs("abbreviations, streamed CUs",&obj,
+            ex.e_ncus*(1 + 5 + ex.e_nvars));
+    }
+    free_object(&obj);
+}
+
+/*  With "compress_debug_sections", the sections that
+    shrink are compressed and read back, and the
+    others are left as they were. */
+static void
+test_compression(void)
+{
+#ifdef HAVE_ZLIB
+    struct object_s obj;
+    struct expect_s ex;
+
+    memset(&ex,0,sizeof(ex));
+    ex.e_version = "V5";
+    ex.e_ncus = 1;
+    ex.e_nvars = 2000;
+    if (generate_whole("compress_debug_sections=1",&ex,FALSE,
+        &obj) ==
+        DW_DLV_OK) {
+        if (obj.o_compressed < 3) {
+            printf("FAIL only %d sections compressed\n",
+                obj.o_compressed);
+            ++errcount;
+        }
+        read_back("compressed sections",&obj,&ex);
+    }
+    free_object(&obj);
+    /*  Some of these sections are too small to shrink. */
+    ex.e_nvars = 0;
+    if (generate_whole("compress_debug_sections=1",&ex,FALSE,
+        &obj) ==
+        DW_DLV_OK) {
+        if (!obj.o_uncompressed) {
+            printf("FAIL all %d small sections compressed\n",
+                obj.o_compressed);
+            ++errcount;
+        }
+        read_back("small sections left uncompressed",&obj,&ex);
+    }
+    free_object(&obj);
+#endif /* HAVE_ZLIB */
+}
+
+/*  With "str_tail_merge", each v<k>_<i> name is stored
+    inside gv<k>_<i>, .debug_str shrinks by what the
+    statistics say was merged, and every DW_FORM_strp
+    and .debug_names offset still finds its string. */
+static void
+test_str_tail_merge(void)
+{
+    struct object_s plain;
+    struct object_s merged;
+    struct expect_s ex;
+
+    memset(&ex,0,sizeof(ex));
+    ex.e_version = "V5";
+    ex.e_ncus = 1;
+    ex.e_nvars = 300;
+    ex.e_tails = TRUE;
+    memset(&merged,0,sizeof(merged));
+    if (generate_whole("",&ex,FALSE,&plain) == DW_DLV_OK &&
+        generate_whole("str_tail_merge=1",&ex,FALSE,&merged) ==
+        DW_DLV_OK) {
+        Dwarf_Unsigned plainsize =
+            section_size(&plain,".debug_str");
+        Dwarf_Unsigned mergedsize =
+            section_size(&merged,".debug_str");
+
+        if (plain.o_tail_merged_count ||
+            merged.o_tail_merged_count < ex.e_nvars ||
+            mergedsize + merged.o_tail_merged_len != plainsize) {
+            printf("FAIL str_tail_merge: .debug_str %llu bytes, "
+                "%llu merged, %llu strings merged in %llu bytes\n",
+                (unsigned long long)plainsize,
+                (unsigned long long)mergedsize,
+                (unsigned long long)merged.o_tail_merged_count,
+                (unsigned long long)merged.o_tail_merged_len);
+            ++errcount;
+        }
+        read_back("str_tail_merge",&merged,&ex);
+    }
+    free_object(&plain);
+    free_object(&merged);
+}
+
+/*  With "optimize_line_program" rows with every kind of
+    advance read back as written, and .debug_line is
+    smaller than without it. */
+static void
+test_line_program(void)
+{
+    struct object_s plain;
+    struct object_s optimized;
+    struct expect_s ex;
+
+    memset(&ex,0,sizeof(ex));
+    ex.e_version = "V4";
+    ex.e_ncus = 1;
+    ex.e_lines = TRUE;
+    ex.e_varied_lines = TRUE;
+    memset(&optimized,0,sizeof(optimized));
+    if (generate_whole("",&ex,FALSE,&plain) == DW_DLV_OK &&
+        generate_whole("optimize_line_program=1",&ex,FALSE,
+        &optimized) == DW_DLV_OK) {
+        Dwarf_Unsigned plainsize =
+            section_size(&plain,".debug_line");
+        Dwarf_Unsigned optsize =
+            section_size(&optimized,".debug_line");
+
+        if (!optsize || optsize >= plainsize) {
+            printf("FAIL optimize_line_program: .debug_line "
+                "%llu bytes, %llu optimized\n",
+                (unsigned long long)plainsize,
+                (unsigned long long)optsize);
+            ++errcount;
+        }
+        read_back("varied line rows",&plain,&ex);
+        read_back("optimized varied line rows",&optimized,&ex);
+    }
+    free_object(&plain);
+    free_object(&optimized);
+    ex.e_ncus = 3;
+    if (generate_streamed("optimize_line_program=1",&ex,FALSE,
+        &optimized) == DW_DLV_OK) {
+        read_back("streamed optimized line rows",&optimized,&ex);
+    }
+    free_object(&optimized);
+}
+
+static int
+reloc_compare(const void *l_in, const void *r_in)
+{
+    const struct reloc_s *l = (const struct reloc_s *)l_in;
+    const struct reloc_s *r = (const struct reloc_s *)r_in;
+
+    if (l->r_sect != r->r_sect) {
+        return l->r_sect < r->r_sect?-1:1;
+    }
+    if (l->r_offset != r->r_offset) {
+        return l->r_offset < r->r_offset?-1:1;
+    }
+    return 0;
+}
+
+/*  Checks that a and b hold the same sections, byte
+    for byte, and the same relocations. */
+static void
+compare_objects(const char *what, struct object_s *a,
+    struct object_s *b)
+{
+    int i = 0;
+    Dwarf_Unsigned r = 0;
+
+    if (a->o_count != b->o_count) {
+        fail("section counts differ",what,__LINE__);
+        return;
+    }
+    for (i = 1; i < a->o_count; ++i) {
+        struct section_s *sa = a->o_sects + i;
+        struct section_s *sb = b->o_sects + i;
+
+        if (strcmp(sa->s_name,sb->s_name) ||
+            sa->s_size != sb->s_size ||
+            sa->s_flags != sb->s_flags ||
+            (sa->s_size && memcmp(sa->s_bytes,sb->s_bytes,
+            (size_t)sa->s_size))) {
+            printf("FAIL %s: section %s differs\n",what,
+                sa->s_name);
+            ++errcount;
+        }
+    }
+    if (a->o_reloc_count != b->o_reloc_count) {
+        fail("relocation counts differ",what,__LINE__);
+        return;
+    }
+    qsort(a->o_relocs,(size_t)a->o_reloc_count,
+        sizeof(struct reloc_s),reloc_compare);
+    qsort(b->o_relocs,(size_t)b->o_reloc_count,
+        sizeof(struct reloc_s),reloc_compare);
+    for (r = 0; r < a->o_reloc_count; ++r) {
+        struct reloc_s *ra = a->o_relocs + r;
+        struct reloc_s *rb = b->o_relocs + r;
+
+        if (ra->r_sect != rb->r_sect ||
+            ra->r_offset != rb->r_offset ||
+            ra->r_symidx != rb->r_symidx ||
+            ra->r_type != rb->r_type ||
+            ra->r_length != rb->r_length) {
+            fail("relocations differ",what,__LINE__);
+            break;
+        }
+    }
+}
+
+/*  dwarf_pro_set_section_sink() output is the same as
+    what dwarf_get_section_bytes_a() and
+    dwarf_get_relocation_info() return, with the
+    options that change how sections are built. */
+static void
+test_sink(void)
+{
+    static const struct sink_case_s {
+        const char *sc_extras;
+        const char *sc_version;
+        int         sc_lines;
+        Dwarf_Half  sc_string_form;
+    } cases[] = {
+    {"",                           "V5", FALSE, 0},
+    {"",                           "V4", TRUE,  0},
+    {"parallel_transform=1",       "V4", TRUE,  0},
+    {"use_addrx=1",                "V5", FALSE, 0},
+    {"",                           "V5", FALSE, DW_FORM_strx},
+    {"str_tail_merge=1",           "V5", FALSE, 0},
+    {"str_tail_merge=1",           "V5", FALSE, DW_FORM_strx},
+#ifdef HAVE_ZLIB
+    {"compress_debug_sections=1",  "V5", FALSE, 0},
+#endif /* HAVE_ZLIB */
+    {0,0,0,0}
+    };
+    const struct sink_case_s *sc = 0;
+
+    for (sc = cases; sc->sc_version; ++sc) {
+        struct object_s buffered;
+        struct object_s sunk;
+        struct expect_s ex;
+        char what[80];
+
+        memset(&ex,0,sizeof(ex));
+        ex.e_version = sc->sc_version;
+        ex.e_ncus = 1;
+        ex.e_nvars = 3000;
+        ex.e_lines = sc->sc_lines;
+        ex.e_string_form = sc->sc_string_form;
+        /*  So str_tail_merge has strings to merge. */
+        ex.e_tails = TRUE;
+        snprintf(what,sizeof(what),"sink, %s%s \"%s\"",
+            sc->sc_version,sc->sc_string_form?" strx":"",
+            sc->sc_extras);
+        memset(&sunk,0,sizeof(sunk));
+        if (generate_whole(sc->sc_extras,&ex,FALSE,&buffered) ==
+            DW_DLV_OK &&
+            generate_whole(sc->sc_extras,&ex,TRUE,&sunk) ==
+            DW_DLV_OK) {
+            if (!buffered.o_reloc_count) {
+                fail("no relocations",what,__LINE__);
+            }
+            compare_objects(what,&buffered,&sunk);
+            read_back(what,&sunk,&ex);
+        }
+        free_object(&buffered);
+        free_object(&sunk);
+    }
+}
+
+/*  Counts the arena blocks started since the last call:
+    a new block moves de_arena_end.  Several blocks
+    taken in one step count once, which is enough
+    to see steady growth. */
+static void
+count_arena_block(Dwarf_P_Debug dbg, char **arena_end,
+    unsigned *blocks)
+{
+    if (dbg->de_arena_end != *arena_end) {
+        *arena_end = dbg->de_arena_end;
+        ++*blocks;
+    }
+}
+
+/*  A CU spread over many arena blocks generates correctly,
+    and streaming reuses the objects each streamed CU
+    frees instead of taking new blocks for every CU. */
+static void
+test_arena(void)
+{
+    struct object_s obj;
+    struct expect_s ex;
+    Dwarf_P_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    char *arena_end = 0;
+    unsigned first_blocks = 0;
+    unsigned blocks = 0;
+    unsigned k = 0;
+    int res = 0;
+
+    memset(&ex,0,sizeof(ex));
+    ex.e_version = "V5";
+    ex.e_ncus = 1;
+    ex.e_nvars = 20000;
+    if (generate_whole("",&ex,FALSE,&obj) == DW_DLV_OK) {
+        read_back("20003 DIEs in one CU",&obj,&ex);
+    }
+    free_object(&obj);
+
+    ex.e_nvars = 1000;
+    memset(&obj,0,sizeof(obj));
+    res = producer_init("",&ex,&obj,&dbg);
+    if (res != DW_DLV_OK) {
+        return;
+    }
+    for (k = 0; res == DW_DLV_OK && k < 20; ++k) {
+        res = build_cu(dbg,k,&ex,&error);
+        count_arena_block(dbg,&arena_end,&blocks);
+        if (res == DW_DLV_OK) {
+            res = dwarf_transform_cu_to_disk_form_a(dbg,
+                object_sink,&obj,&error);
+        }
+        count_arena_block(dbg,&arena_end,&blocks);
+        if (!k) {
+            first_blocks = blocks;
+        }
+    }
+    if (res != DW_DLV_OK) {
+        fail("streaming DWARF",
+            res == DW_DLV_ERROR?dwarf_errmsg(error):0,__LINE__);
+    } else if (blocks > first_blocks + 2) {
+        printf("FAIL streaming took %u arena blocks, "
+            "%u for the first CU\n",blocks,first_blocks);
+        ++errcount;
+    }
+    dwarf_producer_finish_a(dbg,0);
+    free_object(&obj);
+}
+
+int
+main(void)
+{
+    test_debug_names();
+    test_streaming();
+    test_arena();
+    test_abbrevs();
+    test_compression();
+    test_str_tail_merge();
+    test_line_program();
+    test_sink();
+    if (errcount) {
+        printf("FAIL test_producer, %d errors\n",errcount);
+        return 1;
+    }
+    printf("PASS test_producer\n");
+    return 0;
+}
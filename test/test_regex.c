@@ -139,6 +139,39 @@ main(void)
     testx("a[fx]+b[cd]",DW_DLV_OK,"afffbdddy",DW_DLV_OK,__LINE__);
     testx("a[fx]+b[cd]",DW_DLV_OK,"afffdddy",
         DW_DLV_NO_ENTRY,__LINE__);
+    /*  A trailing backslash matches itself. */
+    testx("ab\\",DW_DLV_OK,"xab\\y",DW_DLV_OK,__LINE__);
+    testx("ab\\",DW_DLV_OK,"xaby",DW_DLV_NO_ENTRY,__LINE__);
+    testx("$x",DW_DLV_OK,"a$xb",DW_DLV_OK,__LINE__);
+    testx("leb128$",DW_DLV_OK,"decode_leb128",DW_DLV_OK,__LINE__);
+    testx("leb128$",DW_DLV_OK,"leb128_len",DW_DLV_NO_ENTRY,__LINE__);
+    /*  More than 63 elements, beyond the bit-parallel
+        matcher, so the backtracking matcher is used. */
+    testx("a.........b.........c.........d.........e........."
+        "f.........g.........",DW_DLV_OK,
+        "xa123456789b123456789c123456789d123456789e123456789"
+        "f123456789g123456789",DW_DLV_OK,__LINE__);
+    testx("a.........b.........c.........d.........e........."
+        "f.........g.........",DW_DLV_OK,
+        "xa123456789b123456789c123456789d123456789e123456789"
+        "f123456789g12345678",DW_DLV_NO_ENTRY,__LINE__);
+    /*  A character class, even a negated one, never
+        matches the NUL ending the string.  In both
+        matchers. */
+    testx("[^y]",DW_DLV_OK,"",DW_DLV_NO_ENTRY,__LINE__);
+    testx("a[^y]",DW_DLV_OK,"a",DW_DLV_NO_ENTRY,__LINE__);
+    testx("a[^y]",DW_DLV_OK,"ab",DW_DLV_OK,__LINE__);
+    testx("a[^y]*",DW_DLV_OK,"a",DW_DLV_OK,__LINE__);
+    testx("[^y]a.........b.........c.........d.........e........."
+        "f.........g.........",DW_DLV_OK,"",DW_DLV_NO_ENTRY,__LINE__);
+    testx("a.........b.........c.........d.........e........."
+        "f.........g.........[^y]",DW_DLV_OK,
+        "xa123456789b123456789c123456789d123456789e123456789"
+        "f123456789g123456789",DW_DLV_NO_ENTRY,__LINE__);
+    testx("a.........b.........c.........d.........e........."
+        "f.........g.........[^y]",DW_DLV_OK,
+        "xa123456789b123456789c123456789d123456789e123456789"
+        "f123456789g123456789z",DW_DLV_OK,__LINE__);
     if (errcount > 0) {
         printf("\n\nFAIL test_regex errcount %d\n",errcount);
         return 1;
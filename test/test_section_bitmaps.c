@@ -26,7 +26,7 @@
 */
 #include <config.h>
 
-#include <stdio.h>  /* printf() */
+#include <stdio.h>  /* printf() sprintf() */
 #include <stdlib.h> /* exit() */
 
 #include "libdwarf.h"
@@ -67,6 +67,35 @@ int main(void)
             exit(EXIT_FAILURE);
         }
     }
+    /*  The load map keeps every name given, once,
+        however many there are. */
+    {
+        static char names[100][8];
+        const char **map = 0;
+        unsigned n = 0;
+
+        for (i = 0; i < 100; ++i) {
+            sprintf(names[i],".n%u",i);
+            enable_load_map_section(names[i]);
+            enable_load_map_section(names[i/2]);
+        }
+        map = load_map_section_names();
+        for (n = 0; map && map[n]; ++n) {
+            if (map[n] != names[n]) {
+                printf("FAIL load map entry %u is %s\n",n,map[n]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (n != 100) {
+            printf("FAIL load map has %u names, not 100\n",n);
+            exit(EXIT_FAILURE);
+        }
+        load_map_destructor();
+        if (load_map_section_names()) {
+            printf("FAIL load map left after its destructor\n");
+            exit(EXIT_FAILURE);
+        }
+    }
     printf("PASS section maps\n");
     return 0;
 }
@@ -0,0 +1,310 @@
+/*
+Copyright (c) 2026, agent
+All rights reserved.
+
+Redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the
+following conditions are met:
+
+    Redistributions of source code must retain the above
+    copyright notice, this list of conditions and the following
+    disclaimer.
+
+    Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*  Tests DW_FORM_strx lookups in a DWARF5 CU whose
+    DIE has a strx attribute ahead of DW_AT_str_offsets_base.
+    The .debug_str_offsets section has two tables and the
+    CU uses the second, so any string read through the
+    first table (the fallback base) is wrong.
+    The DWARF is in memory, read via dwarf_object_init_b()
+    as in src/bin/dwarfexample/jitreader.c.
+    A second, big-endian, object has a DWARF64 CU and
+    .debug_str_offsets table, whose 8 byte entries must
+    not be read as 4 byte ones.
+    Takes no arguments. */
+
+#include <config.h>
+
+#include <stdio.h>  /* printf() */
+#include <stdlib.h> /* exit() */
+#include <string.h> /* strcmp() */
+
+#include "dwarf.h"
+#include "libdwarf.h"
+#include "libdwarf_private.h" /* TRUE FALSE */
+
+/*  Abbrev 1: DW_TAG_compile_unit, no children,
+    DW_AT_dwo_name strx1, DW_AT_str_offsets_base sec_offset,
+    DW_AT_name strx1, DW_AT_producer strx1 */
+static Dwarf_Small abbrevbytes[] = {
+0x01, 0x11, 0x00,
+0x76, 0x25,
+0x72, 0x17,
+0x03, 0x25,
+0x25, 0x25,
+0x00, 0x00,
+0x00 };
+
+/*  32bit DWARF5 DW_UT_compile, address size 8.
+    dwo_name index 0, str_offsets_base 24,
+    name index 1, producer index 0. */
+static Dwarf_Small infobytes[] = {
+0x10, 0x00, 0x00, 0x00, 0x05, 0x00, 0x01, 0x08,
+0x00, 0x00, 0x00, 0x00,
+0x01, 0x00, 0x18, 0x00, 0x00, 0x00, 0x01, 0x00 };
+
+static Dwarf_Small strbytes[] = {
+'b','a','d','0',0,
+'b','a','d','1',0,
+'g','o','o','d','0',0,
+'g','o','o','d','1',0 };
+
+/*  Two tables. The first (base 8) points at the bad
+    strings, the second (base 24) at the good ones. */
+static Dwarf_Small stroffbytes[] = {
+0x0c, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+0x0c, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+0x0a, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00 };
+
+/*  Abbrev 1: DW_TAG_compile_unit, no children,
+    DW_AT_str_offsets_base sec_offset, DW_AT_name strx1 */
+static Dwarf_Small abbrev64bytes[] = {
+0x01, 0x11, 0x00,
+0x72, 0x17,
+0x03, 0x25,
+0x00, 0x00,
+0x00 };
+
+/*  Big-endian 64bit DWARF5 DW_UT_compile, address size 8.
+    str_offsets_base 16, name index 1. */
+static Dwarf_Small info64bytes[] = {
+0xff, 0xff, 0xff, 0xff,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16,
+0x00, 0x05, 0x01, 0x08,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x01,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,
+0x01 };
+
+static Dwarf_Small str64bytes[] = {
+'b','a','d','0',0,
+'g','o','o','d','1',0 };
+
+/*  One 64bit table, base 16. Read as 4 byte entries
+    index 1 would be the low half of entry 0. */
+static Dwarf_Small stroff64bytes[] = {
+0xff, 0xff, 0xff, 0xff,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14,
+0x00, 0x05, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05 };
+
+struct sectiondata_s {
+    const char   * sd_secname;
+    Dwarf_Unsigned sd_sectionsize;
+    Dwarf_Small  * sd_content;
+};
+
+#define SECCOUNT 5
+static struct sectiondata_s sectiondata[SECCOUNT] = {
+{"",0,0},
+{".debug_abbrev",sizeof(abbrevbytes),abbrevbytes},
+{".debug_info",sizeof(infobytes),infobytes},
+{".debug_str",sizeof(strbytes),strbytes},
+{".debug_str_offsets",sizeof(stroffbytes),stroffbytes}
+};
+static struct sectiondata_s sectiondata64[SECCOUNT] = {
+{"",0,0},
+{".debug_abbrev",sizeof(abbrev64bytes),abbrev64bytes},
+{".debug_info",sizeof(info64bytes),info64bytes},
+{".debug_str",sizeof(str64bytes),str64bytes},
+{".debug_str_offsets",sizeof(stroff64bytes),stroff64bytes}
+};
+
+struct testobj_s {
+    struct sectiondata_s *to_sections;
+    Dwarf_Small           to_endian;
+};
+static struct testobj_s obj32le = {sectiondata,DW_END_little};
+static struct testobj_s obj64be = {sectiondata64,DW_END_big};
+
+static int
+gsinfo(void *obj, Dwarf_Half section_index,
+    Dwarf_Obj_Access_Section_a *return_section,
+    int *error)
+{
+    struct testobj_s *to = (struct testobj_s *)obj;
+    struct sectiondata_s *finfo = 0;
+
+    *error = 0;
+    if (section_index >= SECCOUNT) {
+        return DW_DLV_NO_ENTRY;
+    }
+    finfo = to->to_sections + section_index;
+    memset(return_section,0,sizeof(*return_section));
+    return_section->as_name = finfo->sd_secname;
+    return_section->as_size = finfo->sd_sectionsize;
+    return_section->as_entrysize = 1;
+    return DW_DLV_OK;
+}
+static Dwarf_Small
+gborder(void *obj)
+{
+    return ((struct testobj_s *)obj)->to_endian;
+}
+static Dwarf_Small
+glensize(void *obj)
+{
+    (void)obj;
+    return 4;
+}
+static Dwarf_Small
+gptrsize(void *obj)
+{
+    (void)obj;
+    return 8;
+}
+static Dwarf_Unsigned
+gfilesize(void *obj)
+{
+    (void)obj;
+    return 200;
+}
+static Dwarf_Unsigned
+gseccount(void *obj)
+{
+    (void)obj;
+    return SECCOUNT;
+}
+static int
+gloadsec(void *obj, Dwarf_Half secindex,
+    Dwarf_Small **rdata, int *error)
+{
+    struct testobj_s *to = (struct testobj_s *)obj;
+
+    *error = 0;
+    if (secindex >= SECCOUNT) {
+        return DW_DLV_NO_ENTRY;
+    }
+    *rdata = to->to_sections[secindex].sd_content;
+    return DW_DLV_OK;
+}
+
+static const Dwarf_Obj_Access_Methods_a methods = {
+    gsinfo,
+    gborder,
+    glensize,
+    gptrsize,
+    gfilesize,
+    gseccount,
+    gloadsec,
+    0 /* no relocations */
+};
+static Dwarf_Obj_Access_Interface_a dw_interface32le =
+{ &obj32le, &methods };
+static Dwarf_Obj_Access_Interface_a dw_interface64be =
+{ &obj64be, &methods };
+
+static int errcount;
+
+static void
+check_text(Dwarf_Die die, Dwarf_Half attrnum,
+    const char *attrname, const char *expected)
+{
+    char *text = 0;
+    Dwarf_Error error = 0;
+    int res = 0;
+
+    res = dwarf_die_text(die,attrnum,&text,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL %s not readable: %s\n",attrname,
+            res == DW_DLV_ERROR?dwarf_errmsg(error):"no entry");
+        dwarf_dealloc_error(0,error);
+        ++errcount;
+        return;
+    }
+    if (strcmp(text,expected)) {
+        printf("FAIL %s is \"%s\", expected \"%s\"\n",
+            attrname,text,expected);
+        ++errcount;
+    }
+}
+
+static Dwarf_Die
+open_cu_die(Dwarf_Obj_Access_Interface_a *dw_interface,
+    Dwarf_Debug *dbg_out)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Error error = 0;
+    Dwarf_Die cudie = 0;
+    Dwarf_Bool is_info = TRUE;
+    int res = 0;
+
+    res = dwarf_object_init_b(dw_interface,0,0,
+        DW_GROUPNUMBER_ANY,&dbg,&error);
+    if (res != DW_DLV_OK) {
+        printf("FAIL dwarf_object_init_b: %s\n",
+            res == DW_DLV_ERROR?dwarf_errmsg(error):"no entry");
+        exit(EXIT_FAILURE);
+    }
+    res = dwarf_next_cu_header_d(dbg,is_info,
+        0,0,0,0,0,0,0,0,0,0,&error);
+    if (res == DW_DLV_OK) {
+        res = dwarf_siblingof_b(dbg,0,is_info,&cudie,&error);
+    }
+    if (res != DW_DLV_OK) {
+        printf("FAIL reading the CU DIE: %s\n",
+            res == DW_DLV_ERROR?dwarf_errmsg(error):"no entry");
+        dwarf_object_finish(dbg);
+        exit(EXIT_FAILURE);
+    }
+    *dbg_out = dbg;
+    return cudie;
+}
+
+int
+main(void)
+{
+    Dwarf_Debug dbg = 0;
+    Dwarf_Die cudie = 0;
+
+    cudie = open_cu_die(&dw_interface32le,&dbg);
+    /*  Reading the CU header already resolved DW_AT_dwo_name,
+        before DW_AT_str_offsets_base was seen. */
+    check_text(cudie,DW_AT_name,"DW_AT_name","good1");
+    check_text(cudie,DW_AT_producer,"DW_AT_producer","good0");
+    check_text(cudie,DW_AT_dwo_name,"DW_AT_dwo_name","good0");
+    dwarf_dealloc_die(cudie);
+    dwarf_object_finish(dbg);
+
+    cudie = open_cu_die(&dw_interface64be,&dbg);
+    check_text(cudie,DW_AT_name,"DWARF64 DW_AT_name","good1");
+    dwarf_dealloc_die(cudie);
+    dwarf_object_finish(dbg);
+    if (errcount) {
+        printf("FAIL test_strx_base_order, %d errors\n",errcount);
+        exit(EXIT_FAILURE);
+    }
+    printf("PASS test_strx_base_order\n");
+    return 0;
+}
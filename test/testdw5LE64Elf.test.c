@@ -0,0 +1,53 @@
+/*  Source of testdw5LE64Elf.obj, built with
+    gcc -O2 -gdwarf-5 -c testdw5LE64Elf.test.c
+    -o testdw5LE64Elf.obj
+    It exists to give .debug_loclists, .debug_rnglists,
+    .debug_addr and DW_FORM_implicit_const to the tests. */
+
+struct pair { int a; int b; };
+
+extern int ext(int);
+static int counter;
+
+static int __attribute__((noinline))
+sum(const int *v, int n)
+{
+    int i;
+    int t = 0;
+
+    for (i = 0; i < n; ++i) {
+        t += v[i] * (i + 1);
+    }
+    return t;
+}
+
+int
+walk(struct pair *p, int n)
+{
+    int i;
+    int acc = 0;
+
+    for (i = 0; i < n; ++i) {
+        int x = p[i].a;
+        int y = ext(x);
+
+        if (y > 10) {
+            acc += y - p[i].b;
+        } else {
+            acc ^= x;
+        }
+    }
+    counter += acc;
+    return acc + sum(&p->a, n);
+}
+
+int __attribute__((cold))
+rarely(int k)
+{
+    int z = ext(k);
+
+    if (z) {
+        return ext(z + k) * 3;
+    }
+    return k;
+}
@@ -0,0 +1,15 @@
+/*  Source of testsplitLE64Elf.dwo, built with
+    gcc -O0 -gdwarf-5 -gsplit-dwarf -c testsplitLE64Elf.test.c
+    -o testsplitLE64Elf.o
+    and keeping only the .dwo.  It gives the tests a split
+    DWARF object, with .debug_str.dwo and the other
+    .dwo sections in place of the usual ones. */
+struct point { int x; int y; };
+static const char *greeting = "hello from a split DWARF unit";
+int
+scale(struct point *p, int k)
+{
+    p->x *= k;
+    p->y *= k;
+    return greeting[0] + p->x;
+}